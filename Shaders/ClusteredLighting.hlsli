@@ -0,0 +1,115 @@
+﻿// 分簇光照的公共定义：LightClustering.hlsl (光源分簇) 与 Triangle.hlsl 的 PSClustered (前向着色) 共用
+// 描述符布局与 FVulkanClusteredLighting 一致，网格常量与计算与 C++ 侧 FLightClusterGrid 一致
+// 着色器所在管线布局中该描述符集的序号由 LIGHT_SET 指定 (GPU 驱动路径的 set 0 被剔除占用)
+
+#ifndef LIGHT_SET
+#define LIGHT_SET 0
+#endif
+
+#define CLUSTER_TILE_COUNT_X 16
+#define CLUSTER_TILE_COUNT_Y 9
+#define CLUSTER_SLICE_COUNT 24
+#define CLUSTER_TILES_PER_SLICE (CLUSTER_TILE_COUNT_X * CLUSTER_TILE_COUNT_Y)
+#define CLUSTER_COUNT (CLUSTER_TILES_PER_SLICE * CLUSTER_SLICE_COUNT)
+#define MAX_LIGHTS_PER_CLUSTER 256
+
+// 计数器下标
+#define COUNTER_LIGHT_INDICES 0
+#define COUNTER_OVERFLOW_CLUSTERS 1
+
+// 观察空间点光源 (与 C++ 侧 FPointLight 一致，32 字节)
+struct FGpuLight
+{
+    float3 Position;
+    float Radius;
+    float3 Color;
+    float Intensity;
+};
+
+// 每帧一份的分簇参数 (Uniform Buffer)
+struct FClusterData
+{
+    float2 ViewportSize;
+    float2 ProjectionScale; // 观察空间 xy / 深度 -> NDC (y 带翻转)
+    float NearZ;
+    float FarZ;
+    float SliceScale;       // 切片 = log(深度) * SliceScale + SliceBias
+    float SliceBias;
+    uint LightCount;
+    uint IndexCapacity;     // 压缩索引表容量
+    uint2 Padding;
+};
+
+[[vk::binding(0, LIGHT_SET)]] StructuredBuffer<FGpuLight> Lights;
+[[vk::binding(4, LIGHT_SET)]] ConstantBuffer<FClusterData> ClusterData;
+// 片元阶段只读 (不要求 fragmentStoresAndAtomics)，分簇的计算着色器以可写方式声明
+#ifdef LIGHT_CLUSTER_BUILD
+[[vk::binding(1, LIGHT_SET)]] RWStructuredBuffer<uint2> ClusterLights;  // 每簇 (Offset, Count)
+[[vk::binding(2, LIGHT_SET)]] RWStructuredBuffer<uint> LightIndices;    // 所有簇的光源序号首尾相接
+[[vk::binding(3, LIGHT_SET)]] RWStructuredBuffer<uint> Counters;
+#else
+[[vk::binding(1, LIGHT_SET)]] StructuredBuffer<uint2> ClusterLights;
+[[vk::binding(2, LIGHT_SET)]] StructuredBuffer<uint> LightIndices;
+#endif
+
+float GetSliceDepth(uint Slice)
+{
+    return ClusterData.NearZ * pow(ClusterData.FarZ / ClusterData.NearZ, (float)Slice / CLUSTER_SLICE_COUNT);
+}
+
+// 簇在观察空间 (相机看向 -z) 中的包围盒：图块的 NDC 范围在切片近端与远端两个深度处取并
+void GetClusterBounds(uint Cluster, out float3 BoundsMin, out float3 BoundsMax)
+{
+    uint Slice = Cluster / CLUSTER_TILES_PER_SLICE;
+    uint2 Tile = uint2(Cluster % CLUSTER_TILE_COUNT_X, Cluster % CLUSTER_TILES_PER_SLICE / CLUSTER_TILE_COUNT_X);
+
+    float2 NdcMin = float2(Tile) / float2(CLUSTER_TILE_COUNT_X, CLUSTER_TILE_COUNT_Y) * 2.0 - 1.0;
+    float2 NdcMax = float2(Tile + 1) / float2(CLUSTER_TILE_COUNT_X, CLUSTER_TILE_COUNT_Y) * 2.0 - 1.0;
+    float NearDepth = GetSliceDepth(Slice);
+    float FarDepth = GetSliceDepth(Slice + 1);
+
+    float2 ScaleMin = float2(NdcMin.x, -NdcMax.y) / ClusterData.ProjectionScale;
+    float2 ScaleMax = float2(NdcMax.x, -NdcMin.y) / ClusterData.ProjectionScale;
+    BoundsMin = float3(min(ScaleMin * NearDepth, ScaleMin * FarDepth), -FarDepth);
+    BoundsMax = float3(max(ScaleMax * NearDepth, ScaleMax * FarDepth), -NearDepth);
+}
+
+bool SphereIntersectsAabb(float4 Sphere, float3 BoundsMin, float3 BoundsMax)
+{
+    float3 Delta = max(max(BoundsMin - Sphere.xyz, 0.0), Sphere.xyz - BoundsMax);
+    return dot(Delta, Delta) <= Sphere.w * Sphere.w;
+}
+
+// 深度缓冲值 (近 0 远 1) -> 观察空间线性深度
+float LinearizeDepth(float Depth)
+{
+    return ClusterData.NearZ * ClusterData.FarZ / (ClusterData.FarZ + Depth * (ClusterData.NearZ - ClusterData.FarZ));
+}
+
+// SV_Position.xy (帧缓冲像素) 与线性深度 -> 观察空间位置
+float3 GetViewPosition(float2 Pixel, float ViewDepth)
+{
+    float2 Ndc = Pixel / ClusterData.ViewportSize * 2.0 - 1.0;
+    return float3(float2(Ndc.x, -Ndc.y) / ClusterData.ProjectionScale * ViewDepth, -ViewDepth);
+}
+
+uint GetClusterIndex(float2 Pixel, float ViewDepth)
+{
+    uint2 Tile = min(uint2(max(Pixel / ClusterData.ViewportSize * float2(CLUSTER_TILE_COUNT_X, CLUSTER_TILE_COUNT_Y), 0.0)),
+        uint2(CLUSTER_TILE_COUNT_X - 1, CLUSTER_TILE_COUNT_Y - 1));
+    float SliceValue = log(max(ViewDepth, ClusterData.NearZ)) * ClusterData.SliceScale + ClusterData.SliceBias;
+    uint Slice = min((uint)max(SliceValue, 0.0), CLUSTER_SLICE_COUNT - 1);
+    return Slice * CLUSTER_TILES_PER_SLICE + Tile.y * CLUSTER_TILE_COUNT_X + Tile.x;
+}
+
+// Lambert 漫反射；距离衰减为平方反比乘窗口函数，在影响半径处平滑降到 0
+float3 EvaluatePointLight(FGpuLight Light, float3 ViewPos, float3 Normal)
+{
+    float3 ToLight = Light.Position - ViewPos;
+    float DistanceSq = dot(ToLight, ToLight);
+    float Ratio = DistanceSq / (Light.Radius * Light.Radius);
+    float Window = saturate(1.0 - Ratio * Ratio);
+    float Attenuation = Window * Window / (DistanceSq + 1.0);
+    float NdotL = saturate(dot(Normal, ToLight * rsqrt(max(DistanceSq, 1e-8))));
+    return Light.Color * (Light.Intensity * Attenuation * NdotL);
+}
@@ -0,0 +1,185 @@
+﻿// GPU 剔除：每个线程处理一个实例，可见的绘制记录压缩写入间接参数缓冲
+// 由 FVulkanGpuCulling 调度，结果交给 vkCmdDrawIndexedIndirectCount
+// 两阶段遮挡剔除：
+// - 早阶段：上一帧可见 (且在视锥内) 的实例直接绘制，它们的深度构成本帧 Hi-Z 的遮挡体
+// - 晚阶段：所有实例做视锥 + Hi-Z 测试，更新可见性；早阶段没画过的可见实例在这里补画
+
+// 与 C++ 侧 FInstanceState 布局一致 (矩阵列主序)
+struct FGpuInstance
+{
+    float4x4 World;
+    float4 Bounds; // xyz: 世界空间球心, w: 半径
+    float4 Color;
+};
+
+struct FDrawRecord
+{
+    uint IndexCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint InstanceIndex;
+};
+
+// 与 VkDrawIndexedIndirectCommand 布局一致 (20 字节)
+struct FDrawIndexedIndirectCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint FirstInstance;
+};
+
+// 每帧一份的剔除参数 (Uniform Buffer)
+struct FCullData
+{
+    float4x4 ViewProjection;
+    float4 FrustumPlanes[6]; // dot(xyz, P) + w >= 0 为内侧
+    uint InstanceCount;
+    uint HiZMipCount;
+    uint2 HiZSize;
+};
+
+struct FCullConstants
+{
+    uint Phase;          // PHASE_EARLY / PHASE_LATE
+    uint bOcclusion;     // 关闭时只有晚阶段，且不做 Hi-Z 测试
+    uint CommandOffset;  // 本阶段在间接参数缓冲中的起始位置
+    uint Padding;
+};
+
+// 计数器下标，与 FVulkanGpuCulling 一致
+#define COUNTER_EARLY_DRAWS 0
+#define COUNTER_LATE_DRAWS 1
+#define COUNTER_FRUSTUM_CULLED 2
+#define COUNTER_OCCLUSION_CULLED 3
+
+#define PHASE_EARLY 0
+#define PHASE_LATE 1
+
+[[vk::push_constant]] FCullConstants CullConstants;
+
+[[vk::binding(0, 0)]] StructuredBuffer<FGpuInstance> Instances;
+[[vk::binding(1, 0)]] StructuredBuffer<FDrawRecord> DrawRecords;
+[[vk::binding(2, 0)]] RWStructuredBuffer<FDrawIndexedIndirectCommand> IndirectCommands;
+[[vk::binding(3, 0)]] RWStructuredBuffer<uint> Counters;
+[[vk::binding(4, 0)]] RWStructuredBuffer<uint> Visibility; // 按实例序号，跨帧保留
+[[vk::binding(5, 0)]] Texture2D<float> HiZ;
+[[vk::binding(6, 0)]] ConstantBuffer<FCullData> CullData;
+
+bool IsSphereVisible(float4 Sphere)
+{
+    [unroll]
+    for (uint i = 0; i < 6; i++)
+    {
+        float4 Plane = CullData.FrustumPlanes[i];
+        if (dot(Plane.xyz, Sphere.xyz) + Plane.w < -Sphere.w)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 包围球的外接立方体投影到屏幕：矩形内 Hi-Z 的最远深度比包围体最近深度还近即被完全遮挡
+bool IsOccluded(float4 Sphere)
+{
+    float2 MinUV = 1.0;
+    float2 MaxUV = 0.0;
+    float MinDepth = 1.0;
+
+    [unroll]
+    for (uint i = 0; i < 8; i++)
+    {
+        float3 Corner = Sphere.xyz + Sphere.w * float3((i & 1) ? 1.0 : -1.0, (i & 2) ? 1.0 : -1.0, (i & 4) ? 1.0 : -1.0);
+        float4 Clip = mul(CullData.ViewProjection, float4(Corner, 1.0));
+        // 跨过近平面时投影不可靠，保守地视为可见
+        if (Clip.w <= 0.0 || Clip.z < 0.0)
+        {
+            return false;
+        }
+
+        float3 Ndc = Clip.xyz / Clip.w;
+        float2 UV = Ndc.xy * 0.5 + 0.5; // 投影矩阵已翻转 Y，UV 与帧缓冲行序一致
+        MinUV = min(MinUV, UV);
+        MaxUV = max(MaxUV, UV);
+        MinDepth = min(MinDepth, Ndc.z);
+    }
+
+    MinUV = saturate(MinUV);
+    MaxUV = saturate(MaxUV);
+
+    // 选择使矩形不超过 1 个纹素的层级，矩形至多跨 2x2 个纹素
+    float2 SizeTexels = (MaxUV - MinUV) * float2(CullData.HiZSize);
+    uint Level = (uint)ceil(log2(max(max(SizeTexels.x, SizeTexels.y), 1.0)));
+    Level = min(Level, CullData.HiZMipCount - 1);
+
+    uint2 MipSize = max(CullData.HiZSize >> Level, 1);
+    uint2 Lo = min(uint2(MinUV * float2(MipSize)), MipSize - 1);
+    uint2 Hi = min(uint2(MaxUV * float2(MipSize)), MipSize - 1);
+
+    float MaxDepth = max(
+        max(HiZ.Load(int3(Lo.x, Lo.y, Level)), HiZ.Load(int3(Hi.x, Lo.y, Level))),
+        max(HiZ.Load(int3(Lo.x, Hi.y, Level)), HiZ.Load(int3(Hi.x, Hi.y, Level))));
+    return MinDepth > MaxDepth;
+}
+
+void EmitDraw(uint CounterIndex, FDrawRecord Record)
+{
+    // 压缩：可见绘制连续排列，数量即 vkCmdDrawIndexedIndirectCount 的 countBuffer
+    uint Slot;
+    InterlockedAdd(Counters[CounterIndex], 1, Slot);
+
+    FDrawIndexedIndirectCommand Command;
+    Command.IndexCount = Record.IndexCount;
+    Command.InstanceCount = 1;
+    Command.FirstIndex = Record.FirstIndex;
+    Command.VertexOffset = Record.VertexOffset;
+    Command.FirstInstance = Record.InstanceIndex; // 顶点着色器经 SV_InstanceID 取回实例
+    IndirectCommands[CullConstants.CommandOffset + Slot] = Command;
+}
+
+// 线程组大小与 FVulkanGpuCulling::CULL_GROUP_SIZE 一致
+[numthreads(64, 1, 1)]
+void CSMain(uint3 DispatchID : SV_DispatchThreadID)
+{
+    uint DrawIndex = DispatchID.x;
+    if (DrawIndex >= CullData.InstanceCount)
+    {
+        return;
+    }
+
+    FDrawRecord Record = DrawRecords[DrawIndex];
+    float4 Bounds = Instances[Record.InstanceIndex].Bounds;
+    bool bWasVisible = Visibility[Record.InstanceIndex] != 0;
+
+    if (CullConstants.Phase == PHASE_EARLY)
+    {
+        if (bWasVisible && IsSphereVisible(Bounds))
+        {
+            EmitDraw(COUNTER_EARLY_DRAWS, Record);
+        }
+        return;
+    }
+
+    if (!IsSphereVisible(Bounds))
+    {
+        Visibility[Record.InstanceIndex] = 0;
+        InterlockedAdd(Counters[COUNTER_FRUSTUM_CULLED], 1);
+        return;
+    }
+
+    if (CullConstants.bOcclusion != 0 && IsOccluded(Bounds))
+    {
+        Visibility[Record.InstanceIndex] = 0;
+        InterlockedAdd(Counters[COUNTER_OCCLUSION_CULLED], 1);
+        return;
+    }
+
+    Visibility[Record.InstanceIndex] = 1;
+    // 早阶段已经画过的不重复绘制
+    if (CullConstants.bOcclusion == 0 || !bWasVisible)
+    {
+        EmitDraw(COUNTER_LATE_DRAWS, Record);
+    }
+}
@@ -0,0 +1,152 @@
+﻿// Hi-Z 金字塔单 Pass 构建：每个纹素取其覆盖区域的最远深度 (深度比较 LESS，近 0 远 1)
+// 由 FVulkanHiZBuffer 调度：每个线程组归约 32x32 的 mip0 块得到 mip0-5，
+// 最后完成的线程组接着把 mip5 归约为 mip6-11，整个金字塔只需一次 Dispatch
+
+#define GROUP_SIZE 16
+#define MAX_MIP_COUNT 12
+
+struct FReduceConstants
+{
+    uint2 DepthSize;
+    uint2 HiZSize;   // mip0 尺寸 (2 的幂)
+    uint MipCount;
+    uint GroupCount;
+};
+
+[[vk::push_constant]] FReduceConstants ReduceConstants;
+
+[[vk::binding(0, 0)]] Texture2D<float> DepthTexture;
+// mip5 由其它线程组写入、最后一组读取，需要跨线程组一致
+[[vk::binding(1, 0)]] globallycoherent RWTexture2D<float> HiZMips[MAX_MIP_COUNT];
+[[vk::binding(2, 0)]] globallycoherent RWStructuredBuffer<uint> GroupCounter;
+
+groupshared float SharedDepth[GROUP_SIZE][GROUP_SIZE];
+groupshared uint SharedIsLastGroup;
+
+uint2 GetMipSize(uint Mip)
+{
+    return max(ReduceConstants.HiZSize >> Mip, 1);
+}
+
+// 越界纹素不写；越界的输入按 0 参与归约，取最大值时不影响结果
+void StoreMip(uint Mip, uint2 Texel, float Value)
+{
+    if (Mip < ReduceConstants.MipCount && all(Texel < GetMipSize(Mip)))
+    {
+        HiZMips[Mip][Texel] = Value;
+    }
+}
+
+float LoadMip(uint Mip, uint2 Texel)
+{
+    return all(Texel < GetMipSize(Mip)) ? HiZMips[Mip][Texel] : 0.0;
+}
+
+// mip0 纹素覆盖深度缓冲中 [Texel * Depth / HiZ, (Texel + 1) * Depth / HiZ) 的全部像素 (向外取整，保守)
+float ReduceDepthFootprint(uint2 Texel)
+{
+    uint2 Begin = Texel * ReduceConstants.DepthSize / ReduceConstants.HiZSize;
+    uint2 End = min(((Texel + 1) * ReduceConstants.DepthSize + ReduceConstants.HiZSize - 1) / ReduceConstants.HiZSize,
+        ReduceConstants.DepthSize);
+
+    float Result = 0.0;
+    for (uint Y = Begin.y; Y < End.y; Y++)
+    {
+        for (uint X = Begin.x; X < End.x; X++)
+        {
+            Result = max(Result, DepthTexture.Load(int3(X, Y, 0)));
+        }
+    }
+    return Result;
+}
+
+// 共享内存中 16x16 的 BaseMip 逐级归约，写出 BaseMip+1 .. BaseMip+4
+void ReduceShared(uint BaseMip, uint2 GroupTile, uint2 LocalID)
+{
+    [unroll]
+    for (uint Level = 1; Level <= 4; Level++)
+    {
+        uint Size = GROUP_SIZE >> Level;
+        bool bActive = all(LocalID < Size);
+
+        GroupMemoryBarrierWithGroupSync();
+        float Value = 0.0;
+        if (bActive)
+        {
+            uint2 Src = LocalID * 2;
+            Value = max(max(SharedDepth[Src.y][Src.x], SharedDepth[Src.y][Src.x + 1]),
+                max(SharedDepth[Src.y + 1][Src.x], SharedDepth[Src.y + 1][Src.x + 1]));
+        }
+
+        GroupMemoryBarrierWithGroupSync();
+        if (bActive)
+        {
+            SharedDepth[LocalID.y][LocalID.x] = Value;
+            StoreMip(BaseMip + Level, GroupTile * Size + LocalID, Value);
+        }
+    }
+}
+
+// 线程组大小与 FVulkanHiZBuffer::REDUCE_GROUP_SIZE 一致
+[numthreads(GROUP_SIZE, GROUP_SIZE, 1)]
+void CSMain(uint3 GroupID : SV_GroupID, uint3 LocalThreadID : SV_GroupThreadID, uint GroupIndex : SV_GroupIndex)
+{
+    uint2 LocalID = LocalThreadID.xy;
+
+    // 1. 每线程 2x2 个 mip0 纹素 -> 1 个 mip1 纹素，再在共享内存中得到 mip2-5
+    uint2 Mip1Texel = GroupID.xy * GROUP_SIZE + LocalID;
+    float Mip1Value = 0.0;
+    [unroll]
+    for (uint i = 0; i < 4; i++)
+    {
+        uint2 Texel = Mip1Texel * 2 + uint2(i & 1, i >> 1);
+        float Value = ReduceDepthFootprint(Texel);
+        StoreMip(0, Texel, Value);
+        Mip1Value = max(Mip1Value, Value);
+    }
+    StoreMip(1, Mip1Texel, Mip1Value);
+    SharedDepth[LocalID.y][LocalID.x] = Mip1Value;
+    ReduceShared(1, GroupID.xy, LocalID);
+
+    if (ReduceConstants.MipCount <= 6)
+    {
+        return;
+    }
+
+    // 2. 所有线程的 mip5 写入对其它线程组可见之后再计数，最后完成的一组继续
+    DeviceMemoryBarrierWithGroupSync();
+    if (GroupIndex == 0)
+    {
+        uint Previous;
+        InterlockedAdd(GroupCounter[0], 1, Previous);
+        SharedIsLastGroup = Previous == ReduceConstants.GroupCount - 1 ? 1 : 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (SharedIsLastGroup == 0)
+    {
+        return;
+    }
+    if (GroupIndex == 0)
+    {
+        GroupCounter[0] = 0; // 为下一帧复位
+    }
+
+    // 3. mip5 至多 64x64：每线程 4x4 个 mip5 纹素 -> 2x2 个 mip6 -> 1 个 mip7，再在共享内存中得到 mip8-11
+    float Mip7Value = 0.0;
+    [unroll]
+    for (uint j = 0; j < 4; j++)
+    {
+        uint2 Mip6Texel = LocalID * 2 + uint2(j & 1, j >> 1);
+        float Value = 0.0;
+        [unroll]
+        for (uint k = 0; k < 4; k++)
+        {
+            Value = max(Value, LoadMip(5, Mip6Texel * 2 + uint2(k & 1, k >> 1)));
+        }
+        StoreMip(6, Mip6Texel, Value);
+        Mip7Value = max(Mip7Value, Value);
+    }
+    StoreMip(7, LocalID, Mip7Value);
+    SharedDepth[LocalID.y][LocalID.x] = Mip7Value;
+    ReduceShared(7, uint2(0, 0), LocalID);
+}
@@ -0,0 +1,85 @@
+﻿// 光源分簇：每个线程负责一个簇，测试所有光源的包围球与簇包围盒，把相交的光源序号压缩写入索引表
+// 由 FVulkanClusteredLighting 调度，结果供 Triangle.hlsl 的 PSClustered 按簇读取
+// - 光源按 64 个一批读入共享内存，组内线程共用
+// - 先计数，再原子地在索引表中预留该簇的区间，最后第二遍写入：不需要每线程的暂存数组
+// - 索引表写满时簇只保留装得下的部分，计入溢出统计
+
+#define LIGHT_CLUSTER_BUILD
+#include "ClusteredLighting.hlsli"
+
+// 线程组大小与 FVulkanClusteredLighting::BUILD_GROUP_SIZE 一致
+#define GROUP_SIZE 64
+
+groupshared float4 SharedSpheres[GROUP_SIZE];
+
+// 整组同步后读入一批光源，调用方随后可以读取 SharedSpheres[0, BatchCount)
+void LoadLightBatch(uint BatchBegin, uint GroupIndex)
+{
+    GroupMemoryBarrierWithGroupSync();
+    uint LightIndex = BatchBegin + GroupIndex;
+    if (LightIndex < ClusterData.LightCount)
+    {
+        FGpuLight Light = Lights[LightIndex];
+        SharedSpheres[GroupIndex] = float4(Light.Position, Light.Radius);
+    }
+    GroupMemoryBarrierWithGroupSync();
+}
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void CSMain(uint3 DispatchID : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+    // 越界线程仍参与共享内存的装载与同步
+    uint Cluster = DispatchID.x;
+    bool bActive = Cluster < CLUSTER_COUNT;
+    float3 BoundsMin;
+    float3 BoundsMax;
+    GetClusterBounds(min(Cluster, CLUSTER_COUNT - 1), BoundsMin, BoundsMax);
+
+    // 1. 计数
+    uint Count = 0;
+    uint Begin;
+    for (Begin = 0; Begin < ClusterData.LightCount; Begin += GROUP_SIZE)
+    {
+        LoadLightBatch(Begin, GroupIndex);
+        uint BatchCount = min(GROUP_SIZE, ClusterData.LightCount - Begin);
+        for (uint i = 0; i < BatchCount; i++)
+        {
+            Count += SphereIntersectsAabb(SharedSpheres[i], BoundsMin, BoundsMax) ? 1 : 0;
+        }
+    }
+    Count = bActive ? min(Count, MAX_LIGHTS_PER_CLUSTER) : 0;
+
+    // 2. 预留区间；计数器记录的是需求总量，可能超过容量
+    uint Offset = 0;
+    uint Stored = 0;
+    if (Count > 0)
+    {
+        InterlockedAdd(Counters[COUNTER_LIGHT_INDICES], Count, Offset);
+        Stored = Offset < ClusterData.IndexCapacity ? min(Count, ClusterData.IndexCapacity - Offset) : 0;
+        if (Stored < Count)
+        {
+            InterlockedAdd(Counters[COUNTER_OVERFLOW_CLUSTERS], 1);
+        }
+    }
+
+    // 3. 第二遍写入前 Stored 个相交光源，与计数时顺序相同
+    uint Written = 0;
+    for (Begin = 0; Begin < ClusterData.LightCount; Begin += GROUP_SIZE)
+    {
+        LoadLightBatch(Begin, GroupIndex);
+        uint BatchCount = min(GROUP_SIZE, ClusterData.LightCount - Begin);
+        for (uint i = 0; i < BatchCount && Written < Stored; i++)
+        {
+            if (SphereIntersectsAabb(SharedSpheres[i], BoundsMin, BoundsMax))
+            {
+                LightIndices[Offset + Written] = Begin + i;
+                Written++;
+            }
+        }
+    }
+
+    if (bActive)
+    {
+        ClusterLights[Cluster] = uint2(Stored > 0 ? Offset : 0, Stored);
+    }
+}
@@ -0,0 +1,71 @@
+﻿// 网格簇渲染 (VK_EXT_mesh_shader)：任务着色器逐簇剔除，网格着色器直接输出可见簇的三角形
+// 由 FVulkanMeshletRenderer 调度：vkCmdDrawMeshTasksEXT(ceil(最多簇的一级 LOD 的簇数 / 32), 实例数, 1)
+// 线程组总数超出 maxTaskWorkGroupTotalCount 时按实例区间拆成多次，DrawConstants.InstanceOffset 为区间起点
+// 每个实例只测试自己那一级 LOD 的簇，超出该级簇数的线程空闲
+
+#include "MeshletCommon.hlsli"
+
+struct FTaskPayload
+{
+    uint InstanceIndex;
+    uint MeshletIndices[MESHLET_CULL_GROUP_SIZE];
+};
+
+groupshared FTaskPayload Payload;
+groupshared uint SharedVisibleCount;
+
+[numthreads(MESHLET_CULL_GROUP_SIZE, 1, 1)]
+void ASMain(uint3 GroupID : SV_GroupID, uint LocalIndex : SV_GroupIndex)
+{
+    uint InstanceIndex = DrawConstants.InstanceOffset + GroupID.y;
+    uint LocalMeshlet = GroupID.x * MESHLET_CULL_GROUP_SIZE + LocalIndex;
+    FMeshLod Lod = GetInstanceLod(InstanceIndex);
+
+    if (LocalIndex == 0)
+    {
+        SharedVisibleCount = 0;
+        Payload.InstanceIndex = InstanceIndex;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    FGpuInstance Instance = Instances[InstanceIndex];
+    // 整个实例在视锥外时不必逐簇测试 (统计上记为视锥剔除)
+    bool bInstanceVisible = IsSphereInFrustum(Instance.Bounds.xyz, Instance.Bounds.w);
+    if (LocalMeshlet < Lod.MeshletCount)
+    {
+        uint MeshletIndex = Lod.MeshletOffset + LocalMeshlet;
+        FMeshlet Meshlet = Meshlets[MeshletIndex];
+        uint Result = bInstanceVisible ? CullMeshlet(Instance, Meshlet) : 1;
+        CountCullResult(Result, Meshlet);
+        if (Result == 0)
+        {
+            uint Slot;
+            InterlockedAdd(SharedVisibleCount, 1, Slot);
+            Payload.MeshletIndices[Slot] = MeshletIndex;
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(SharedVisibleCount, 1, 1, Payload);
+}
+
+// 一个线程组输出一个簇：前 VertexCount 个线程写顶点，前 TriangleCount 个线程写三角形
+[outputtopology("triangle")]
+[numthreads(128, 1, 1)]
+void MSMain(uint GroupThreadID : SV_GroupThreadID, uint3 GroupID : SV_GroupID, in payload FTaskPayload InPayload,
+    out vertices VSOutput OutVertices[MESHLET_MAX_VERTICES], out indices uint3 OutTriangles[MESHLET_MAX_TRIANGLES])
+{
+    FGpuInstance Instance = Instances[InPayload.InstanceIndex];
+    FMeshlet Meshlet = Meshlets[InPayload.MeshletIndices[GroupID.x]];
+
+    SetMeshOutputCounts(Meshlet.VertexCount, Meshlet.TriangleCount);
+
+    if (GroupThreadID < Meshlet.VertexCount)
+    {
+        OutVertices[GroupThreadID] = TransformMeshletVertex(InPayload.InstanceIndex, Instance, Meshlet, GroupThreadID);
+    }
+    if (GroupThreadID < Meshlet.TriangleCount)
+    {
+        OutTriangles[GroupThreadID] = UnpackTriangle(MeshletTriangles[Meshlet.TriangleOffset + GroupThreadID]);
+    }
+}
@@ -0,0 +1,220 @@
+﻿// 网格簇渲染的公共定义：Meshlet.hlsl (任务/网格着色器) 与 MeshletCulling.hlsl + MeshletIndirect.hlsl (计算剔除回退路径) 共用
+// 描述符布局与 FVulkanMeshletRenderer 一致
+
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+// 每个线程组 (任务着色器 / 剔除计算着色器) 处理一个实例的 32 个簇，与 FVulkanMeshletRenderer::CULL_GROUP_SIZE 一致
+#define MESHLET_CULL_GROUP_SIZE 32
+// 回退路径 DrawArgs 中第一条间接命令的位置 (uint 下标)，与 C++ 侧 DRAW_COMMAND_OFFSET (字节) 一致
+#define MESHLET_DRAW_COMMAND_OFFSET 4
+
+// 计数器下标
+#define COUNTER_VISIBLE 0
+#define COUNTER_FRUSTUM_CULLED 1
+#define COUNTER_CONE_CULLED 2
+#define COUNTER_TRIANGLES 3
+#define COUNTER_OVERFLOW_CLUSTERS 4
+
+// 与 C++ 侧 FPackedMeshVertex 一致 (16 字节)
+struct FPackedMeshVertex
+{
+    uint PositionXY; // 16 位定点 x | y << 16
+    uint PositionZ;  // 16 位定点 z，高 16 位未用
+    uint Normal;     // 八面体映射的 snorm16 x | y << 16
+    uint UV;         // half u | v << 16
+};
+
+struct FMeshVertex
+{
+    float3 Position;
+    float3 Normal;
+    float2 UV;
+};
+
+// 与 C++ 侧 FMeshlet 一致
+struct FMeshlet
+{
+    float4 BoundingSphere;
+    float4 ConeApex;
+    float4 Cone;
+    uint VertexOffset;
+    uint TriangleOffset;
+    uint VertexCount;
+    uint TriangleCount;
+};
+
+// 与 C++ 侧 FMeshLod 一致：一级 LOD 的簇在 Meshlets 中连续存放
+struct FMeshLod
+{
+    uint MeshletOffset;
+    uint MeshletCount;
+    uint TriangleCount;
+    float Error;
+};
+
+// 与 GpuCulling.hlsl 中 FGpuInstance 一致
+struct FGpuInstance
+{
+    float4x4 World;
+    float4 Bounds;
+    float4 Color;
+};
+
+struct FMeshletCullData
+{
+    float4x4 ViewProjection;
+    float4 FrustumPlanes[6];
+    float4 CameraPosition; // 世界空间
+    float4 PositionOffset; // 顶点位置解码：网格空间位置 = PositionOffset + q * PositionScale
+    float4 PositionScale;
+    uint InstanceCount;
+    uint LodCount;
+    uint TextureCount;   // 0 表示没有纹理流送
+    uint VisibleClusterCapacity; // 回退路径可见簇列表的容量
+};
+
+struct FMeshletDrawConstants
+{
+    uint bCountStats; // 深度预渲染与颜色 Pass 各剔除一次，只统计其中一次
+    uint InstanceOffset; // 任务着色器路径按实例区间拆分绘制时，本次绘制的第一个实例
+};
+
+[[vk::push_constant]] FMeshletDrawConstants DrawConstants;
+
+[[vk::binding(0, 0)]] StructuredBuffer<FMeshlet> Meshlets;
+[[vk::binding(1, 0)]] StructuredBuffer<uint> MeshletVertices;
+[[vk::binding(2, 0)]] StructuredBuffer<uint> MeshletTriangles;
+[[vk::binding(3, 0)]] StructuredBuffer<FPackedMeshVertex> Vertices;
+[[vk::binding(4, 0)]] StructuredBuffer<FGpuInstance> Instances;
+[[vk::binding(5, 0)]] RWStructuredBuffer<uint2> VisibleClusters; // 回退路径：x 实例, y 簇
+[[vk::binding(6, 0)]] RWStructuredBuffer<uint> DrawArgs;         // 回退路径：命令数 + VkDrawIndexedIndirectCommand[]
+[[vk::binding(7, 0)]] RWStructuredBuffer<uint> Counters;
+[[vk::binding(8, 0)]] ConstantBuffer<FMeshletCullData> CullData;
+[[vk::binding(9, 0)]] StructuredBuffer<FMeshLod> Lods;
+[[vk::binding(10, 0)]] StructuredBuffer<uint> InstanceLods;   // 与 Instances 一一对应：LOD 级别 | 场景实例序号 << 8
+
+// 实例选中的那一级 LOD：线程组内第 LocalMeshlet 个簇对应 Meshlets[MeshletOffset + LocalMeshlet]
+FMeshLod GetInstanceLod(uint InstanceIndex)
+{
+    return Lods[min(InstanceLods[InstanceIndex] & 0xFF, CullData.LodCount - 1)];
+}
+
+// CPU 剔除时只上传可见实例，纹理等按场景实例区分的数据用它索引
+uint GetSceneInstance(uint InstanceIndex)
+{
+    return InstanceLods[InstanceIndex] >> 8;
+}
+
+float2 DecodeSnorm16x2(uint Packed)
+{
+    int2 Signed = int2(int(Packed << 16) >> 16, int(Packed) >> 16);
+    return max(float2(Signed) / 32767.0, -1.0);
+}
+
+// 八面体映射的逆变换：下半球从正方形的四个角折回
+float3 DecodeOctahedral(float2 Encoded)
+{
+    float3 Normal = float3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    float T = saturate(-Normal.z);
+    Normal.x += Normal.x >= 0.0 ? -T : T;
+    Normal.y += Normal.y >= 0.0 ? -T : T;
+    return normalize(Normal);
+}
+
+// 与 MeshUtils::Dequantize 一致
+FMeshVertex DecodeMeshVertex(FPackedMeshVertex Packed)
+{
+    float3 Quantized = float3(Packed.PositionXY & 0xFFFF, Packed.PositionXY >> 16, Packed.PositionZ & 0xFFFF);
+    // 与 TransformMeshletVertex 一样禁止重排：深度预渲染与颜色 Pass 的位置逐位一致
+    precise float3 Position = CullData.PositionOffset.xyz + Quantized * CullData.PositionScale.xyz;
+
+    FMeshVertex Vertex;
+    Vertex.Position = Position;
+    Vertex.Normal = DecodeOctahedral(DecodeSnorm16x2(Packed.Normal));
+    Vertex.UV = float2(f16tof32(Packed.UV & 0xFFFF), f16tof32(Packed.UV >> 16));
+    return Vertex;
+}
+
+bool IsSphereInFrustum(float3 Center, float Radius)
+{
+    [unroll]
+    for (uint i = 0; i < 6; i++)
+    {
+        float4 Plane = CullData.FrustumPlanes[i];
+        if (dot(Plane.xyz, Center) + Plane.w < -Radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 实例变换只含旋转 + 均匀缩放 (见 FMatrix4::TranslationRotationZScale)
+float GetUniformScale(float4x4 World)
+{
+    return length(float3(World._m00, World._m10, World._m20));
+}
+
+// 0: 可见, 1: 视锥外, 2: 整簇背向相机
+uint CullMeshlet(FGpuInstance Instance, FMeshlet Meshlet)
+{
+    float Scale = GetUniformScale(Instance.World);
+    float3 Center = mul(Instance.World, float4(Meshlet.BoundingSphere.xyz, 1.0)).xyz;
+    if (!IsSphereInFrustum(Center, Meshlet.BoundingSphere.w * Scale))
+    {
+        return 1;
+    }
+
+    float3 Apex = mul(Instance.World, float4(Meshlet.ConeApex.xyz, 1.0)).xyz;
+    float3 Axis = normalize(mul((float3x3)Instance.World, Meshlet.Cone.xyz));
+    if (dot(normalize(Apex - CullData.CameraPosition.xyz), Axis) >= Meshlet.Cone.w)
+    {
+        return 2;
+    }
+    return 0;
+}
+
+void CountCullResult(uint Result, FMeshlet Meshlet)
+{
+    if (DrawConstants.bCountStats != 0)
+    {
+        InterlockedAdd(Counters[Result == 0 ? COUNTER_VISIBLE : Result == 1 ? COUNTER_FRUSTUM_CULLED : COUNTER_CONE_CULLED], 1);
+        if (Result == 0)
+        {
+            InterlockedAdd(Counters[COUNTER_TRIANGLES], Meshlet.TriangleCount);
+        }
+    }
+}
+
+// 前两项与 Triangle.hlsl 的 VSOutput 一致，无纹理时片元阶段复用 PSMain；纹理流送时由 MeshletTextured.hlsl 采样
+struct VSOutput
+{
+    float4 Pos : SV_POSITION;
+    float3 Color : COLOR0;
+    float2 UV : TEXCOORD0;
+    nointerpolation uint TextureIndex : TEXCOORD1;
+};
+
+// 簇内局部顶点 -> 裁剪空间位置 + 简单的半球光照
+VSOutput TransformMeshletVertex(uint InstanceIndex, FGpuInstance Instance, FMeshlet Meshlet, uint LocalVertex)
+{
+    FMeshVertex Vertex = DecodeMeshVertex(Vertices[MeshletVertices[Meshlet.VertexOffset + LocalVertex]]);
+
+    VSOutput Output;
+    precise float4 WorldPos = mul(Instance.World, float4(Vertex.Position, 1.0));
+    precise float4 Position = mul(CullData.ViewProjection, WorldPos);
+    Output.Pos = Position;
+
+    float3 Normal = normalize(mul((float3x3)Instance.World, Vertex.Normal));
+    float Lighting = 0.35 + 0.65 * saturate(dot(Normal, normalize(CullData.CameraPosition.xyz - WorldPos.xyz)));
+    Output.Color = Instance.Color.rgb * Lighting;
+    Output.UV = Vertex.UV;
+    // 与 FVulkanTextureStreamer 的需求估计一致
+    Output.TextureIndex = CullData.TextureCount > 0 ? GetSceneInstance(InstanceIndex) % CullData.TextureCount : 0;
+    return Output;
+}
+
+uint3 UnpackTriangle(uint Packed)
+{
+    return uint3(Packed & 0xFF, (Packed >> 8) & 0xFF, (Packed >> 16) & 0xFF);
+}
@@ -0,0 +1,45 @@
+﻿// 网格簇剔除 (没有 VK_EXT_mesh_shader 时的回退路径)
+// 每个线程测试一个 (实例, 簇)，可见簇压缩写入 VisibleClusters，并为它写一条按实际三角形数取索引的间接命令
+// 由 FVulkanMeshletRenderer 调度：Dispatch(ceil(最多簇的一级 LOD 的簇数 / 32), 实例数, 1)，每个实例只测试自己那一级的簇
+
+#include "MeshletCommon.hlsli"
+
+[numthreads(MESHLET_CULL_GROUP_SIZE, 1, 1)]
+void CSMain(uint3 GroupID : SV_GroupID, uint LocalIndex : SV_GroupIndex)
+{
+    uint InstanceIndex = GroupID.y;
+    uint LocalMeshlet = GroupID.x * MESHLET_CULL_GROUP_SIZE + LocalIndex;
+    FMeshLod Lod = GetInstanceLod(InstanceIndex);
+    if (LocalMeshlet >= Lod.MeshletCount)
+    {
+        return;
+    }
+
+    uint MeshletIndex = Lod.MeshletOffset + LocalMeshlet;
+    FMeshlet Meshlet = Meshlets[MeshletIndex];
+    FGpuInstance Instance = Instances[InstanceIndex];
+    uint Result = IsSphereInFrustum(Instance.Bounds.xyz, Instance.Bounds.w) ? CullMeshlet(Instance, Meshlet) : 1;
+    CountCullResult(Result, Meshlet);
+    if (Result != 0)
+    {
+        return;
+    }
+
+    // DrawArgs[0] 为命令数，MESHLET_DRAW_COMMAND_OFFSET 起每个可见簇一条 VkDrawIndexedIndirectCommand
+    uint Slot;
+    InterlockedAdd(DrawArgs[0], 1, Slot);
+    // 命令数记录的是需求总量，可能超过容量：超出的簇丢弃并计数，绘制时命令数按容量截断
+    if (Slot >= CullData.VisibleClusterCapacity)
+    {
+        InterlockedAdd(Counters[COUNTER_OVERFLOW_CLUSTERS], 1);
+        return;
+    }
+    VisibleClusters[Slot] = uint2(InstanceIndex, MeshletIndex);
+
+    uint Command = MESHLET_DRAW_COMMAND_OFFSET + Slot * 5;
+    DrawArgs[Command + 0] = Meshlet.TriangleCount * 3;   // indexCount
+    DrawArgs[Command + 1] = 1;                           // instanceCount
+    DrawArgs[Command + 2] = Meshlet.TriangleOffset * 3;  // firstIndex：簇内局部索引
+    DrawArgs[Command + 3] = Slot * MESHLET_MAX_VERTICES; // vertexOffset：顶点着色器据此找回可见簇
+    DrawArgs[Command + 4] = 0;                           // firstInstance
+}
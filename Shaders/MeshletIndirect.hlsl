@@ -0,0 +1,18 @@
+﻿// 网格簇回退路径的顶点着色器：一次 vkCmdDrawIndexedIndirectCount 画出全部可见簇，每个簇一条命令、只取它实际的三角形
+// 索引是簇内局部顶点序号，命令的 vertexOffset 为 可见簇序号 x MESHLET_MAX_VERTICES，SV_VertexID 同时编码可见簇与局部顶点
+
+#include "MeshletCommon.hlsli"
+
+VSOutput VSMain(uint VertexID : SV_VertexID)
+{
+    uint2 Cluster = VisibleClusters[VertexID / MESHLET_MAX_VERTICES];
+    FGpuInstance Instance = Instances[Cluster.x];
+    FMeshlet Meshlet = Meshlets[Cluster.y];
+    return TransformMeshletVertex(Cluster.x, Instance, Meshlet, VertexID % MESHLET_MAX_VERTICES);
+}
+
+// 深度预渲染：同一套变换，只输出位置
+float4 VSDepthOnly(uint VertexID : SV_VertexID) : SV_POSITION
+{
+    return VSMain(VertexID).Pos;
+}
@@ -0,0 +1,73 @@
+﻿// 网格簇渲染的片元着色器 (启用纹理流送时)：按实例采样绑定式纹理数组
+// 纹理集 (set 1) 由 FVulkanTextureStreamer 管理：每个元素只含当前驻留的 mip，采样自动落在已驻留的最精细一级
+// PSTexturedFeedback 额外把每个纹理需要的最精细 mip 原子 min 到反馈缓冲，CPU 在该帧完成后回读驱动流送
+
+// 与 FVulkanTextureStreamer::MAX_TEXTURES 一致
+#define MAX_STREAMED_TEXTURES 1024
+// 与 FVulkanTextureStreamer::FEEDBACK_MIP_BIAS 一致：图像只含驻留的 mip，放大时相对级数为负
+#define FEEDBACK_MIP_BIAS 16
+#define FEEDBACK_MAX_VALUE 31
+
+// 与 MeshletCommon.hlsli 中 VSOutput 一致
+struct PSInput
+{
+    float4 Pos : SV_POSITION;
+    float3 Color : COLOR0;
+    float2 UV : TEXCOORD0;
+    nointerpolation uint TextureIndex : TEXCOORD1;
+};
+
+[[vk::binding(0, 1)]] Texture2D StreamedTextures[MAX_STREAMED_TEXTURES];
+[[vk::binding(1, 1)]] SamplerState TextureSampler;
+[[vk::binding(2, 1)]] RWStructuredBuffer<uint> MipFeedback; // 按纹理序号，每帧清为 0xFFFFFFFF
+
+float4 PSTextured(PSInput Input) : SV_TARGET
+{
+    // 同一次绘制中相邻像素可能属于不同实例：索引不是动态一致的
+    float4 Albedo = StreamedTextures[NonUniformResourceIndex(Input.TextureIndex)].Sample(TextureSampler, Input.UV);
+    return float4(Albedo.rgb * Input.Color, 1.0);
+}
+
+// IsHelperLane 需要 SM 6.6：PSTextured 以 ps_6_0 编译时跳过反馈入口
+#if __SHADER_TARGET_MAJOR > 6 || __SHADER_TARGET_MINOR >= 6
+
+// 波内按纹理序号分组逐组处理，每组只由一个 lane 做一次原子操作：反馈的开销与纹理数而不是像素数相关
+void WriteMipFeedback(uint TextureIndex, uint Requested)
+{
+    [loop]
+    while (true)
+    {
+        uint GroupTexture = WaveReadLaneFirst(TextureIndex);
+        if (GroupTexture == TextureIndex)
+        {
+            uint GroupMin = WaveActiveMin(Requested);
+            if (WaveIsFirstLane())
+            {
+                InterlockedMin(MipFeedback[GroupTexture], GroupMin);
+            }
+            break;
+        }
+    }
+}
+
+// 写存储缓冲的片元着色器默认在着色之后才做深度测试：强制提前测试，被遮挡 (含深度预通道剔除) 的片元不采样也不写反馈
+// 着色器不 discard 也不写 SV_Depth，提前测试与原来的结果一致
+[earlydepthstencil]
+float4 PSTexturedFeedback(PSInput Input) : SV_TARGET
+{
+    Texture2D Texture = StreamedTextures[NonUniformResourceIndex(Input.TextureIndex)];
+    float4 Albedo = Texture.Sample(TextureSampler, Input.UV);
+
+    // 三线性采样用到 floor(LOD) 与下一级：floor(LOD) 就是需要驻留的最精细一级 (相对当前图像的 mip 0)
+    float Lod = Texture.CalculateLevelOfDetailUnclamped(TextureSampler, Input.UV);
+    uint Requested = (uint)clamp(floor(Lod) + FEEDBACK_MIP_BIAS, 0.0, FEEDBACK_MAX_VALUE);
+
+    // 辅助 lane 的写入会被丢弃，不能让它代表整组
+    if (!IsHelperLane())
+    {
+        WriteMipFeedback(Input.TextureIndex, Requested);
+    }
+    return float4(Albedo.rgb * Input.Color, 1.0);
+}
+
+#endif
@@ -1,10 +1,41 @@
-﻿// 定义顶点着色器输出 / 片元着色器输入结构
+﻿#include "ClusteredLighting.hlsli"
+
+// 定义顶点着色器输出 / 片元着色器输入结构
 struct VSOutput
 {
     float4 Pos : SV_POSITION; // SV_POSITION 对应 Vulkan 的 gl_Position
     float3 Color : COLOR0; // 传递颜色给 PS
 };
 
+// 每个绘制的常量 (与 C++ 侧 FDrawConstants 布局一致，矩阵列主序)
+struct FDrawConstants
+{
+    float4x4 WorldViewProjection;
+    float4 Color;
+};
+
+[[vk::push_constant]] FDrawConstants DrawConstants;
+
+// 硬编码三角形坐标 (Vulkan 坐标系: Y向下)
+// 0: 顶部中心 (0.0, -0.5)
+// 1: 右下 (0.5, 0.5)
+// 2: 左下 (-0.5, 0.5)
+static const float2 Positions[3] =
+{
+    float2(0.0, -0.5),
+    float2(0.5, 0.5),
+    float2(-0.5, 0.5)
+};
+
+// 上面的坐标按屏幕 Y 向下给出，物体空间 Y 向上，翻转后交给投影矩阵 (投影内再翻回 Vulkan 裁剪空间)
+// 深度预渲染与颜色 Pass 共用这一计算，precise 保证两边得到逐位相同的深度
+float4 TransformVertex(uint VertexID)
+{
+    float2 LocalPos = Positions[VertexID];
+    precise float4 Position = mul(DrawConstants.WorldViewProjection, float4(LocalPos.x, -LocalPos.y, 0.0, 1.0));
+    return Position;
+}
+
 // -----------------------------------------------------------
 // 顶点着色器 (Vertex Shader)
 // 入口函数名: VSMain
@@ -13,17 +44,6 @@ VSOutput VSMain(uint VertexID : SV_VertexID) // SV_VertexID 对应 gl_VertexInde
 {
     VSOutput output;
 
-    // 硬编码三角形坐标 (Vulkan 坐标系: Y向下)
-    // 0: 顶部中心 (0.0, -0.5)
-    // 1: 右下 (0.5, 0.5)
-    // 2: 左下 (-0.5, 0.5)
-    float2 positions[3] =
-    {
-        float2(0.0, -0.5),
-        float2(0.5, 0.5),
-        float2(-0.5, 0.5)
-    };
-
     // 硬编码颜色
     float3 colors[3] =
     {
@@ -32,13 +52,21 @@ VSOutput VSMain(uint VertexID : SV_VertexID) // SV_VertexID 对应 gl_VertexInde
         float3(0.0, 0.0, 1.0) // 蓝
     };
 
-    // 输出位置 (z=0.0, w=1.0)
-    output.Pos = float4(positions[VertexID], 0.0, 1.0);
-    output.Color = colors[VertexID];
+    output.Pos = TransformVertex(VertexID);
+    output.Color = colors[VertexID] * DrawConstants.Color.rgb;
 
     return output;
 }
 
+// -----------------------------------------------------------
+// 深度预渲染顶点着色器 (无片元阶段)
+// 入口函数名: VSDepthOnly
+// -----------------------------------------------------------
+float4 VSDepthOnly(uint VertexID : SV_VertexID) : SV_POSITION
+{
+    return TransformVertex(VertexID);
+}
+
 // -----------------------------------------------------------
 // 片元着色器 (Pixel Shader)
 // 入口函数名: PSMain
@@ -47,4 +75,32 @@ float4 PSMain(VSOutput input) : SV_TARGET // SV_TARGET 对应 layout(location=0)
 {
     // 直接输出插值后的颜色
     return float4(input.Color, 1.0);
+}
+
+// 未被任何光源照到的表面保留的亮度
+static const float3 AMBIENT_LIGHT = float3(0.15, 0.15, 0.15);
+
+// -----------------------------------------------------------
+// 分簇前向着色 (Pixel Shader)
+// 入口函数名: PSClustered
+// 片元由像素坐标与深度定位到所在的簇，只循环该簇列表中的光源
+// GPU 驱动路径的管线布局中光照描述符集是 set 1，以 -D LIGHT_SET=1 另行编译
+// -----------------------------------------------------------
+float4 PSClustered(VSOutput input) : SV_TARGET
+{
+    // 观察空间位置由 SV_Position 反投影得到，两条绘制路径的顶点着色器都不需要额外输出
+    float ViewDepth = LinearizeDepth(input.Pos.z);
+    float3 ViewPos = GetViewPosition(input.Pos.xy, ViewDepth);
+
+    // 三角形是平面：屏幕空间导数叉乘得到面法线，翻向相机一侧
+    float3 Normal = normalize(cross(ddx(ViewPos), ddy(ViewPos)));
+    Normal = dot(Normal, ViewPos) > 0.0 ? -Normal : Normal;
+
+    uint2 Cluster = ClusterLights[GetClusterIndex(input.Pos.xy, ViewDepth)];
+    float3 Lighting = AMBIENT_LIGHT;
+    for (uint i = 0; i < Cluster.y; i++)
+    {
+        Lighting += EvaluatePointLight(Lights[LightIndices[Cluster.x + i]], ViewPos, Normal);
+    }
+    return float4(input.Color * Lighting, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+﻿// GPU 驱动路径的顶点着色器：实例变换从存储缓冲读取，片元阶段复用 Triangle.hlsl 的 PSMain
+// 输出布局必须与 Triangle.hlsl 的 VSOutput 一致
+
+struct VSOutput
+{
+    float4 Pos : SV_POSITION;
+    float3 Color : COLOR0;
+};
+
+// 与 GpuCulling.hlsl 中 FGpuInstance 一致
+struct FGpuInstance
+{
+    float4x4 World;
+    float4 Bounds;
+    float4 Color;
+};
+
+struct FViewConstants
+{
+    float4x4 ViewProjection;
+};
+
+[[vk::push_constant]] FViewConstants ViewConstants;
+[[vk::binding(0, 0)]] StructuredBuffer<FGpuInstance> Instances;
+
+static const float2 Positions[3] =
+{
+    float2(0.0, -0.5),
+    float2(0.5, 0.5),
+    float2(-0.5, 0.5)
+};
+
+// 深度预渲染与颜色 Pass 共用，precise 保证两边得到逐位相同的深度
+float4 TransformVertex(FGpuInstance Instance, uint VertexID)
+{
+    float2 LocalPos = Positions[VertexID];
+    precise float4 WorldPos = mul(Instance.World, float4(LocalPos.x, -LocalPos.y, 0.0, 1.0));
+    precise float4 Position = mul(ViewConstants.ViewProjection, WorldPos);
+    return Position;
+}
+
+// 未开启 -fvk-support-nonzero-base-instance 时 DXC 把 SV_InstanceID 映射为 gl_InstanceIndex，
+// 即包含间接参数中的 firstInstance，正好是剔除阶段写入的实例序号
+VSOutput VSMain(uint VertexID : SV_VertexID, uint InstanceID : SV_InstanceID)
+{
+    VSOutput output;
+
+    float3 colors[3] =
+    {
+        float3(1.0, 0.0, 0.0),
+        float3(0.0, 1.0, 0.0),
+        float3(0.0, 0.0, 1.0)
+    };
+
+    FGpuInstance Instance = Instances[InstanceID];
+    output.Pos = TransformVertex(Instance, VertexID);
+    output.Color = colors[VertexID] * Instance.Color.rgb;
+
+    return output;
+}
+
+// 深度预渲染：只输出位置，管线不带片元阶段
+float4 VSDepthOnly(uint VertexID : SV_VertexID, uint InstanceID : SV_InstanceID) : SV_POSITION
+{
+    return TransformVertex(Instances[InstanceID], VertexID);
+}
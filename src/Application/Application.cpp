@@ -1,98 +1,155 @@
 ﻿#include "Application.h"
 #include <SDL2/SDL.h>
-#include <thread>
-#include <chrono>
 
-FApplication::FApplication()
+namespace {
+    // P 键循环切换的首选呈现模式
+    constexpr RHIPresentMode PRESENT_MODE_CYCLE[] =
+    {
+        RHIPresentMode::Mailbox, RHIPresentMode::Immediate, RHIPresentMode::FifoRelaxed, RHIPresentMode::Fifo
+    };
+}
+
+FApplication::FApplication(const FLaunchOptions& InOptions) : Options(InOptions)
 {
     // 1. 初始化 SDL SDL_INIT_VIDEO 会自动初始化 Events 子系统
     if (SDL_Init(SDL_INIT_VIDEO) != 0)
     {
         throw std::runtime_error("Failed to initialize SDL: " + std::string(SDL_GetError()));
     }
+
+    JobSystem = std::make_unique<FJobSystem>(Options.NumWorkers, Options.bPinWorkers);
+
+    // 从 --present= 的首选模式开始循环，第一次按 P 切到它的下一个
+    if (!Options.PresentPolicy.PresentModes.empty())
+    {
+        const auto It = std::find(std::begin(PRESENT_MODE_CYCLE), std::end(PRESENT_MODE_CYCLE), Options.PresentPolicy.PresentModes.front());
+        if (It != std::end(PRESENT_MODE_CYCLE))
+        {
+            PresentModeCycleIndex = static_cast<size_t>(It - std::begin(PRESENT_MODE_CYCLE));
+        }
+    }
 }
 
 FApplication::~FApplication()
 {
+    // 渲染线程仍在使用 Device，必须最先停止；流水线线程会回调渲染线程，先于它销毁
+    if (RenderThread)
+    {
+        RenderThread->Stop();
+    }
+    FramePipeline.reset();
+    RenderThread.reset();
+    Scene.reset();
+
     // 确保 Window 和 Context 先被销毁 (智能指针会自动处理，但逻辑上要注意)
     AppWindow.reset();
     Context.reset();
 
     SDL_Quit();
-    std::cout << "SDL Shutdown successfully." << std::endl;
+    CA_LOG_INFO("SDL", "SDL Shutdown successfully.");
 }
 
 void FApplication::Init()
 {
     AppWindow = std::make_unique<FWindow>("Vulkan Renderer", 800, 600);
     Context = std::make_unique<FVulkanDevice>(*AppWindow);
+    Context->SetPresentPolicy(Options.PresentPolicy);
+    Context->SetGpuCullingRequested(Options.bGpuCulling);
+    Context->SetOcclusionCullingRequested(Options.bOcclusionCulling);
+    Context->SetDepthPrepass(Options.bDepthPrepass);
+    Context->SetMeshletRenderingRequested(Options.bMeshlets);
+    Context->SetMeshShaderRequested(Options.bMeshShader);
+    Context->SetMeshAssetPath(Options.MeshAsset);
+    Context->SetClusteredLightingRequested(Options.LightCount > 0);
+    FTextureStreamingConfig TextureConfig;
+    TextureConfig.PoolBytes = static_cast<uint64_t>(Options.TexturePoolMB) * 1024 * 1024;
+    TextureConfig.UploadBytesPerFrame = static_cast<uint64_t>(Options.TextureUploadMB) * 1024 * 1024;
+    TextureConfig.bSamplerFeedback = Options.bTextureFeedback;
+    Context->SetTextureStreaming(Options.TextureDirectory, TextureConfig);
     Context->Init();
+
+    bLowLatency = Options.bLowLatency;
+    Context->GetFramePacer().SetLowLatencyMode(bLowLatency);
+
+    // Update / RenderPrep 阶段在各自线程上运行，RHI 阶段交给渲染线程
+    // 光源只有分簇光照会用到 (网格簇渲染不着色光照)
+    Scene = std::make_unique<FScene>(Options.InstanceCount, Context->IsClusteredLightingEnabled() ? Options.LightCount : 0);
+    FramePipeline = std::make_unique<FFramePipeline>(*Scene, *JobSystem, Context->GetFramePacer(), Context->GetProfiler(), Options.bHugePages);
+    FramePipeline->SetPipelined(!Options.bSerialFrames);
+    // 网格簇渲染默认在 GPU 上逐簇剔除全部实例；--cpu-culling 时由 RenderPrep 先做实例级剔除，只上传可见实例
+    // 软件遮挡体是场景自带的三角形，与网格簇渲染画的网格无关，此时不用它剔除
+    FramePipeline->SetGpuCulling(Context->IsGpuCullingEnabled() || (Context->IsMeshletRenderingEnabled() && Options.bGpuCulling));
+    FramePipeline->SetOcclusionCulling(Options.bOcclusionCulling && !Context->IsMeshletRenderingEnabled());
+    // 离散 LOD 在 RenderPrep 中按屏幕误差为每个实例选择
+    FramePipeline->SetLodErrors(Context->GetMeshletLodErrors(), Options.LodErrorPixels);
+    const VkExtent2D Extent = Context->GetSwapchain().GetVkExtent();
+    FramePipeline->SetViewportExtent(Extent.width, Extent.height);
+
+    RenderThread = std::make_unique<FRenderThread>(*Context, *FramePipeline);
+}
+
+void FApplication::PostResize()
+{
+    FRenderCommand Command;
+    Command.Type = ERenderCommandType::Resize;
+    if ((SDL_GetWindowFlags(AppWindow->GetNativeWindow()) & SDL_WINDOW_MINIMIZED) == 0)
+    {
+        AppWindow->GetDrawableSize(Command.Width, Command.Height);
+    }
+    RenderThread->Enqueue(std::move(Command));
 }
 
 void FApplication::Run()
 {
+    // Init 之后 Device 的帧循环完全交给渲染线程，这里只处理 SDL 事件
+    RenderThread->Start();
+    FramePipeline->Start();
+
     bool bIsRunning = true;
     SDL_Event event;
 
-    while (bIsRunning)
+    // 阻塞等待事件：渲染线程独立提交帧，不受事件处理或窗口拖拽影响
+    while (bIsRunning && SDL_WaitEvent(&event))
     {
-        // 处理 SDL 事件队列 (比如点击关闭按钮)
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                bIsRunning = false;
-            }
-            else if (event.type == SDL_WINDOWEVENT)
-            {
-                // SDL_WINDOWEVENT_RESIZED: 用户拖拽调整大小
-                // SDL_WINDOWEVENT_SIZE_CHANGED: 窗口系统改变大小
-                if (event.window.event == SDL_WINDOWEVENT_RESIZED ||
-                    event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
-                {
-                    bFramebufferResized = true;
-                }
-            }
+        if (event.type == SDL_QUIT) {
+            bIsRunning = false;
         }
-        
-        if (bFramebufferResized)
+        else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_l && event.key.repeat == 0)
         {
-            int width = 0, height = 0;
-            AppWindow->GetSize(width, height);
-
-            // 最小化暂停渲染等待窗口恢复。
-            while (width == 0 || height == 0)
-            {
-                SDL_WaitEvent(&event); // 阻塞等待新事件，降低 CPU 占用
-                if (event.type == SDL_QUIT)
-                {
-                    bIsRunning = false;
-                    break;
-                }
-                AppWindow->GetSize(width, height);
-            }
-            std::cout << "[Test] Triggering Swapchain Recreation..." << std::endl;
-            Context->RecreateSwapchain();
-            bFramebufferResized = false;
-            std::cout << "[Test] Swapchain Recreated." << std::endl;
+            bLowLatency = !bLowLatency;
 
+            FRenderCommand Command;
+            Command.Type = ERenderCommandType::SetLowLatencyMode;
+            Command.bEnable = bLowLatency;
+            RenderThread->Enqueue(std::move(Command));
         }
-
-        if (!bIsRunning) break;
-
-        try
+        else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_p && event.key.repeat == 0)
         {
-            // std::this_thread::sleep_for(std::chrono::milliseconds(16));
-            bool bRenderSuccess = Context->RenderFrame();
+            // 循环切换首选呈现模式，其余模式保持原顺序作为回退
+            PresentModeCycleIndex = (PresentModeCycleIndex + 1) % std::size(PRESENT_MODE_CYCLE);
+            const RHIPresentMode Mode = PRESENT_MODE_CYCLE[PresentModeCycleIndex];
 
-            if (!bRenderSuccess) {
-                std::cout << "[Vulkan] Driver requested swapchain recreation." << std::endl;
-                // 将标志位置为 true，下一次 while 循环开头就会触发重建逻辑
-                bFramebufferResized = true;
-            }
+            FRenderCommand Command;
+            Command.Type = ERenderCommandType::SetPresentPolicy;
+            Command.PresentPolicy = Options.PresentPolicy;
+            std::erase(Command.PresentPolicy.PresentModes, Mode);
+            Command.PresentPolicy.PresentModes.insert(Command.PresentPolicy.PresentModes.begin(), Mode);
+            RenderThread->Enqueue(std::move(Command));
         }
-        catch (const std::exception& e)
+        else if (event.type == SDL_WINDOWEVENT)
         {
-            std::cerr << "Render Error: " << e.what() << std::endl;
+            // SDL_WINDOWEVENT_SIZE_CHANGED: 用户拖拽或窗口系统改变大小 (RESIZED 之后总会跟随)
+            // SDL_WINDOWEVENT_MINIMIZED / RESTORED: 渲染线程据尺寸是否为 0 挂起或恢复
+            if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+                event.window.event == SDL_WINDOWEVENT_MINIMIZED ||
+                event.window.event == SDL_WINDOWEVENT_RESTORED)
+            {
+                PostResize();
+            }
         }
     }
-    vkDeviceWaitIdle(Context->GetLogicalDevice());
-}
\ No newline at end of file
+
+    // 投递 Shutdown，渲染线程处理完已提交的帧并等待 GPU 空闲后退出，随后停止 Update / RenderPrep
+    RenderThread->Stop();
+    FramePipeline->Stop();
+}
@@ -1,11 +1,16 @@
 ﻿#pragma once
 #include "Window.h"
+#include "LaunchOptions.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
+#include "Renderer/Scene.h"
+#include "Renderer/FramePipeline.h"
 #include "RHI/VulkanDevice.h"
 
 class FApplication
 {
 public:
-    FApplication();
+    FApplication(const FLaunchOptions& InOptions);
     ~FApplication();
 
     void Init();
@@ -13,8 +18,20 @@ public:
     void Run();
 
 private:
+    // 把当前可绘制尺寸投递给渲染线程 (最小化时为 0)
+    void PostResize();
+
+    FLaunchOptions Options;
+
+    // 渲染、资源加载与剔除共享的任务调度器，最后销毁
+    std::unique_ptr<FJobSystem> JobSystem;
+
     std::unique_ptr<FWindow> AppWindow;
     std::unique_ptr<FVulkanDevice> Context;
+    std::unique_ptr<FScene> Scene;
+    std::unique_ptr<FFramePipeline> FramePipeline;
+    std::unique_ptr<FRenderThread> RenderThread;
 
-    bool bFramebufferResized = false;
+    bool bLowLatency = false;
+    size_t PresentModeCycleIndex = 0; // 当前首选模式在 P 键循环中的位置，由 --present= 初始化
 };
\ No newline at end of file
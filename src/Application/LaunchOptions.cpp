@@ -0,0 +1,115 @@
+﻿#include "LaunchOptions.h"
+
+FLaunchOptions FLaunchOptions::Parse(int argc, char* argv[])
+{
+    FLaunchOptions Options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view Arg = argv[i];
+
+        if (Arg == "--low-latency")
+        {
+            Options.bLowLatency = true;
+        }
+        else if (Arg.starts_with("--present="))
+        {
+            std::optional<FPresentPolicy> Policy = FPresentPolicy::ParseModes(Arg.substr(std::string_view("--present=").size()));
+            if (!Policy)
+            {
+                throw std::runtime_error("invalid --present list, expected immediate|mailbox|fifo|fifo_relaxed");
+            }
+            Policy->bPreferSRGB = Options.PresentPolicy.bPreferSRGB;
+            Options.PresentPolicy = *Policy;
+        }
+        else if (Arg == "--format=srgb" || Arg == "--format=unorm")
+        {
+            Options.PresentPolicy.bPreferSRGB = Arg == "--format=srgb";
+        }
+        else if (Arg.starts_with("--workers="))
+        {
+            Options.NumWorkers = static_cast<uint32_t>(std::stoul(std::string(Arg.substr(std::string_view("--workers=").size()))));
+        }
+        else if (Arg == "--pin-workers")
+        {
+            Options.bPinWorkers = true;
+        }
+        else if (Arg.starts_with("--bench="))
+        {
+            Options.Benchmark = Arg.substr(std::string_view("--bench=").size());
+        }
+        else if (Arg.starts_with("--instances="))
+        {
+            Options.InstanceCount = static_cast<uint32_t>(std::stoul(std::string(Arg.substr(std::string_view("--instances=").size()))));
+        }
+        else if (Arg.starts_with("--lights="))
+        {
+            Options.LightCount = static_cast<uint32_t>(std::stoul(std::string(Arg.substr(std::string_view("--lights=").size()))));
+        }
+        else if (Arg == "--serial-frames")
+        {
+            Options.bSerialFrames = true;
+        }
+        else if (Arg == "--huge-pages")
+        {
+            Options.bHugePages = true;
+        }
+        else if (Arg == "--cpu-culling")
+        {
+            Options.bGpuCulling = false;
+        }
+        else if (Arg == "--no-occlusion")
+        {
+            Options.bOcclusionCulling = false;
+        }
+        else if (Arg == "--depth-prepass")
+        {
+            Options.bDepthPrepass = true;
+        }
+        else if (Arg == "--meshlets")
+        {
+            Options.bMeshlets = true;
+        }
+        else if (Arg == "--no-mesh-shader")
+        {
+            Options.bMeshShader = false;
+        }
+        else if (Arg.starts_with("--mesh="))
+        {
+            Options.MeshAsset = Arg.substr(std::string_view("--mesh=").size());
+            Options.bMeshlets = true;
+        }
+        else if (Arg.starts_with("--lod-error="))
+        {
+            Options.LodErrorPixels = std::max(std::stof(std::string(Arg.substr(std::string_view("--lod-error=").size()))), 0.0f);
+        }
+        else if (Arg.starts_with("--textures="))
+        {
+            Options.TextureDirectory = Arg.substr(std::string_view("--textures=").size());
+            Options.bMeshlets = true;
+        }
+        else if (Arg.starts_with("--texture-pool="))
+        {
+            Options.TexturePoolMB = static_cast<uint32_t>(std::stoul(std::string(Arg.substr(std::string_view("--texture-pool=").size()))));
+        }
+        else if (Arg.starts_with("--texture-upload="))
+        {
+            // 至少 1 MB：一次上传不能拆分到比一行更小
+            Options.TextureUploadMB = std::max(static_cast<uint32_t>(std::stoul(std::string(Arg.substr(std::string_view("--texture-upload=").size())))), 1u);
+        }
+        else if (Arg == "--no-texture-feedback")
+        {
+            Options.bTextureFeedback = false;
+        }
+        else if (Arg.starts_with("--import="))
+        {
+            Options.ImportSource = Arg.substr(std::string_view("--import=").size());
+        }
+        else
+        {
+            CA_LOG_WARN("LaunchOptions", "Unknown argument: {}", Arg);
+        }
+    }
+
+    return Options;
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+#include "RHI/RHISwapchain.h"
+
+// 命令行启动参数
+// 用法: VulkanRenderer.exe [--low-latency] [--present=immediate,mailbox,fifo] [--format=srgb|unorm]
+//                          [--workers=N] [--pin-workers] [--bench=jobs|arena|math|culling|hierarchy|bvh|occlusion|lod|lights|log|all]
+//                          [--instances=N] [--lights=N] [--serial-frames] [--huge-pages] [--cpu-culling] [--no-occlusion]
+//                          [--depth-prepass] [--meshlets] [--no-mesh-shader] [--mesh=file.cmesh] [--lod-error=PIXELS]
+//                          [--textures=dir] [--texture-pool=MB] [--texture-upload=MB] [--no-texture-feedback]
+//                          [--import=file.gltf|file.glb|file.tga]
+struct FLaunchOptions
+{
+    bool bLowLatency = false;   // 低延迟模式 (运行时可用 L 键切换)
+    FPresentPolicy PresentPolicy; // 呈现模式回退顺序 (运行时可用 P 键切换)
+    uint32_t NumWorkers = 0;      // Job System Worker 数，0 表示硬件线程数 - 1
+    bool bPinWorkers = false;     // Worker 绑定逻辑核
+    std::string Benchmark;        // 非空时只运行对应微基准测试
+    uint32_t InstanceCount = SCENE_DEFAULT_INSTANCE_COUNT; // 演示场景实例数
+    uint32_t LightCount = SCENE_DEFAULT_LIGHT_COUNT; // 演示场景动态点光源数，0 关闭分簇光照
+    bool bSerialFrames = false;   // 关闭帧流水线，Update/RenderPrep/RHI 逐帧串行 (对比测量用)
+    bool bHugePages = false;      // 帧内存池使用大页 (不可用时退回普通页)
+    bool bGpuCulling = true;      // GPU 剔除 + 间接绘制 (设备不支持时退回 CPU 剔除)
+    bool bOcclusionCulling = true; // 遮挡剔除：GPU 剔除时为两阶段 Hi-Z，CPU 剔除时为软件光栅化遮挡体
+    bool bDepthPrepass = false;   // 主 Pass 前先画一遍纯深度，颜色 Pass 每像素只着色一次
+    bool bMeshlets = false;       // 每个实例画一个簇化的高面数网格，逐簇剔除 (代替实例级 GPU 剔除)
+    bool bMeshShader = true;      // 网格簇渲染优先用任务/网格着色器，关闭或不支持时走计算剔除 + 间接绘制
+    std::filesystem::path MeshAsset;    // 网格簇渲染使用的 .cmesh 资源 (隐含 --meshlets)
+    float LodErrorPixels = 1.0f;    // 网格簇 LOD 允许的屏幕误差，0 表示总画最精细的一级
+    std::filesystem::path TextureDirectory; // 按 mip 流送该目录下的 .ctex 纹理 (隐含 --meshlets)
+    uint32_t TexturePoolMB = 256;       // 纹理驻留上限
+    uint32_t TextureUploadMB = 8;       // 每帧纹理上传上限
+    bool bTextureFeedback = true;       // 需要的 mip 来自 GPU 采样反馈 (关闭时在 CPU 上按包围球估计)
+    std::filesystem::path ImportSource; // 非空时只把该 glTF / TGA 导入为同名 .cmesh / .ctex 后退出
+
+    static FLaunchOptions Parse(int argc, char* argv[]);
+};
@@ -0,0 +1,160 @@
+﻿#include "RenderThread.h"
+#include "RHI/VulkanDevice.h"
+#include "Renderer/FramePipeline.h"
+
+FRenderThread::FRenderThread(FVulkanDevice& InDevice, FFramePipeline& InPipeline)
+    : DeviceRef(InDevice), PipelineRef(InPipeline)
+{
+    PipelineRef.SetPacketReadyCallback([this]() { Wake(); });
+}
+
+FRenderThread::~FRenderThread()
+{
+    Stop();
+}
+
+void FRenderThread::Start()
+{
+    check(!Thread.joinable());
+    bRunning = true;
+    Thread = std::thread(&FRenderThread::ThreadMain, this);
+}
+
+void FRenderThread::Stop()
+{
+    if (!Thread.joinable())
+    {
+        return;
+    }
+
+    FRenderCommand Command;
+    Command.Type = ERenderCommandType::Shutdown;
+    Enqueue(std::move(Command));
+
+    Thread.join();
+}
+
+void FRenderThread::Enqueue(FRenderCommand InCommand)
+{
+    // 队列满说明渲染线程卡在 Acquire/Present 上，让出时间片等它消费即可，不会长时间自旋
+    while (!Commands.TryPush(InCommand))
+    {
+        if (!bRunning)
+        {
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    Wake();
+}
+
+void FRenderThread::Wake()
+{
+    WakeEpoch.fetch_add(1, std::memory_order_release);
+    WakeEpoch.notify_one();
+}
+
+bool FRenderThread::ProcessCommands()
+{
+    bool bKeepRunning = true;
+    FRenderCommand Command;
+
+    while (Commands.TryPop(Command))
+    {
+        switch (Command.Type)
+        {
+        case ERenderCommandType::Resize:
+            bMinimized = Command.Width == 0 || Command.Height == 0;
+            bSwapchainDirty = true;
+            break;
+
+        case ERenderCommandType::SetPresentPolicy:
+            DeviceRef.SetPresentPolicy(Command.PresentPolicy);
+            break;
+
+        case ERenderCommandType::SetLowLatencyMode:
+            DeviceRef.GetFramePacer().SetLowLatencyMode(Command.bEnable);
+            break;
+
+        case ERenderCommandType::Shutdown:
+            bKeepRunning = false;
+            break;
+        }
+    }
+
+    return bKeepRunning;
+}
+
+void FRenderThread::ThreadMain()
+{
+    CA_LOG_INFO("RenderThread", "Started.");
+
+    while (true)
+    {
+        // 先读纪元再检查：检查之后到 wait 之间的消息/帧包会改变纪元，不会错过唤醒
+        const uint32_t Epoch = WakeEpoch.load(std::memory_order_acquire);
+
+        if (!ProcessCommands())
+        {
+            break;
+        }
+
+        // 最小化暂停渲染，阻塞到应用线程投递新消息 (恢复尺寸或 Shutdown)
+        if (bMinimized)
+        {
+            WakeEpoch.wait(Epoch, std::memory_order_acquire);
+            continue;
+        }
+
+        if (!PendingPacket)
+        {
+            PendingPacket = PipelineRef.TryAcquirePreparedPacket();
+            if (!PendingPacket)
+            {
+                WakeEpoch.wait(Epoch, std::memory_order_acquire);
+                continue;
+            }
+        }
+
+        try
+        {
+            if (bSwapchainDirty)
+            {
+                DeviceRef.RecreateSwapchain();
+                bSwapchainDirty = false;
+
+                const VkExtent2D Extent = DeviceRef.GetSwapchain().GetVkExtent();
+                PipelineRef.SetViewportExtent(Extent.width, Extent.height);
+            }
+
+            const uint64_t RhiBeginNs = Utils::GetTimeNs();
+            if (DeviceRef.RenderFrame(*PendingPacket))
+            {
+                PipelineRef.ReleasePacket(PendingPacket, Utils::GetTimeNs() - RhiBeginNs);
+                PendingPacket = nullptr;
+            }
+            else
+            {
+                CA_LOG_INFO("Vulkan", "Driver requested swapchain recreation.");
+                bSwapchainDirty = true;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            CA_LOG_ERROR("RenderThread", "Render Error: {}", e.what());
+        }
+    }
+
+    // 归还手里的帧包，Update 线程才能在 FFramePipeline::Stop 之前继续推进
+    if (PendingPacket)
+    {
+        PipelineRef.ReleasePacket(PendingPacket, 0);
+        PendingPacket = nullptr;
+    }
+
+    vkDeviceWaitIdle(DeviceRef.GetLogicalDevice());
+    bRunning = false;
+
+    CA_LOG_INFO("RenderThread", "Stopped.");
+}
@@ -0,0 +1,75 @@
+﻿#pragma once
+#include <thread>
+#include <atomic>
+#include "SpscQueue.h"
+#include "RHI/RHISwapchain.h"
+
+class FVulkanDevice;
+class FFramePipeline;
+struct FFramePacket;
+
+enum class ERenderCommandType : uint8_t
+{
+    Resize,            // Width/Height 为新的可绘制尺寸，0 表示最小化
+    SetPresentPolicy,
+    SetLowLatencyMode,
+    Shutdown,
+};
+
+// 应用线程 -> 渲染线程的消息
+struct FRenderCommand
+{
+    ERenderCommandType Type = ERenderCommandType::Shutdown;
+    int Width = 0;
+    int Height = 0;
+    bool bEnable = false;
+    FPresentPolicy PresentPolicy;
+};
+
+// 渲染线程 (帧流水线的 RHI 阶段)
+// - 独占 FVulkanDevice 的帧循环 (RenderFrame / RecreateSwapchain)，应用线程只负责 SDL 事件
+// - 应用线程通过无锁 SPSC 队列投递消息，入队不加锁，渲染线程每帧开头统一取出
+// - 同一帧内的多次 Resize 合并为一次交换链重建；最小化时挂起，直到收到新消息
+// - 从 FFramePipeline 取出已完成 RenderPrep 的帧包录制提交，没有帧包时挂起
+class FRenderThread
+{
+public:
+    static constexpr size_t COMMAND_QUEUE_CAPACITY = 256;
+
+    FRenderThread(FVulkanDevice& InDevice, FFramePipeline& InPipeline);
+    ~FRenderThread();
+
+    FRenderThread(const FRenderThread&) = delete;
+    FRenderThread& operator=(const FRenderThread&) = delete;
+
+    void Start();
+    // 投递 Shutdown 并等待渲染线程退出 (渲染线程退出前会等待 GPU 空闲)
+    void Stop();
+
+    // 仅应用线程调用
+    void Enqueue(FRenderCommand InCommand);
+
+    bool IsRunning() const { return bRunning; }
+
+private:
+    // 消息入队或新帧包就绪时调用 (任意线程)
+    void Wake();
+    void ThreadMain();
+    // 取出并处理全部待处理消息，收到 Shutdown 时返回 false
+    bool ProcessCommands();
+
+    FVulkanDevice& DeviceRef;
+    FFramePipeline& PipelineRef;
+    std::thread Thread;
+    std::atomic<bool> bRunning = false;
+
+    TSpscQueue<FRenderCommand, COMMAND_QUEUE_CAPACITY> Commands;
+    // 每次投递消息或帧包就绪时递增，挂起时渲染线程在其上 wait
+    std::atomic<uint32_t> WakeEpoch = 0;
+
+    // 仅渲染线程访问
+    bool bSwapchainDirty = false;
+    bool bMinimized = false;
+    // 已取出但因交换链重建尚未提交的帧包，重建后重试
+    FFramePacket* PendingPacket = nullptr;
+};
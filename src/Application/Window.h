@@ -24,6 +24,13 @@ public:
         SDL_GetWindowSize(AppWindow, &OutWidth, &OutHeight);
     }
 
+    // 以像素为单位的可绘制区域 (高 DPI 下可能大于窗口逻辑尺寸)，交换链应使用该尺寸
+    void GetDrawableSize(int& OutWidth, int& OutHeight) const
+    {
+        check(AppWindow);
+        SDL_Vulkan_GetDrawableSize(AppWindow, &OutWidth, &OutHeight);
+    }
+
 private:
     SDL_Window* AppWindow = nullptr;
     int Width;
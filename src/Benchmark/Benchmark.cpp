@@ -0,0 +1,49 @@
+﻿#include "Benchmark.h"
+
+namespace {
+    struct FBenchmarkEntry
+    {
+        const char* Name;
+        void (*Run)();
+    };
+
+    constexpr FBenchmarkEntry Benchmarks[] =
+    {
+        { "jobs", &RunJobSystemBenchmark },
+        { "arena", &RunFrameArenaBenchmark },
+        { "math", &RunMathBenchmark },
+        { "culling", &RunCullingBenchmark },
+        { "hierarchy", &RunHierarchyBenchmark },
+        { "bvh", &RunBvhBenchmark },
+        { "occlusion", &RunOcclusionBenchmark },
+        { "lod", &RunLodBenchmark },
+        { "lights", &RunLightClusteringBenchmark },
+        { "log", &RunLogBenchmark },
+    };
+}
+
+int RunBenchmark(std::string_view Name)
+{
+    bool bFound = false;
+    for (const FBenchmarkEntry& Entry : Benchmarks)
+    {
+        if (Name == "all" || Name == Entry.Name)
+        {
+            std::cout << "========== Benchmark: " << Entry.Name << " ==========" << std::endl;
+            Entry.Run();
+            bFound = true;
+        }
+    }
+
+    if (!bFound)
+    {
+        std::cerr << "Unknown benchmark: " << Name << ", available:";
+        for (const FBenchmarkEntry& Entry : Benchmarks)
+        {
+            std::cerr << " " << Entry.Name;
+        }
+        std::cerr << " all" << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,17 @@
+﻿#pragma once
+
+// 命令行 --bench=<name> 进入的微基准测试，不创建窗口与设备
+// 返回进程退出码
+int RunBenchmark(std::string_view Name);
+
+// 各基准测试入口
+void RunJobSystemBenchmark();
+void RunFrameArenaBenchmark();
+void RunMathBenchmark();
+void RunCullingBenchmark();
+void RunHierarchyBenchmark();
+void RunBvhBenchmark();
+void RunOcclusionBenchmark();
+void RunLodBenchmark();
+void RunLightClusteringBenchmark();
+void RunLogBenchmark();
@@ -0,0 +1,154 @@
+﻿#include "Benchmark.h"
+#include "Bvh.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 5;
+    constexpr uint32_t PRIMITIVE_COUNT = 1'000'000;
+    constexpr uint32_t QUERY_COUNT = 10'000;
+    // 每帧移动的图元比例 (增量 Refit)
+    constexpr uint32_t MOVED_STRIDE = 100;
+    constexpr float WORLD_EXTENT = 1000.0f;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    // 确定性的伪随机数 [0, 1) (MurmurHash3 的混合函数，相邻序号互不相关)
+    float Hash01(uint32_t Index)
+    {
+        uint32_t Bits = Index;
+        Bits ^= Bits >> 16;
+        Bits *= 0x85EBCA6Bu;
+        Bits ^= Bits >> 13;
+        Bits *= 0xC2B2AE35u;
+        Bits ^= Bits >> 16;
+        return static_cast<float>(Bits >> 8) / static_cast<float>(1u << 24);
+    }
+
+    FVector3 HashPoint(uint32_t Index, float Extent)
+    {
+        return { (Hash01(Index * 3) - 0.5f) * Extent, (Hash01(Index * 3 + 1) - 0.5f) * Extent, (Hash01(Index * 3 + 2) - 0.5f) * Extent * 0.1f };
+    }
+
+    // 地面上的一层物体 (高度范围是水平范围的 1/10)，尺寸 0.5 - 4
+    FAabb MakeBounds(uint32_t Index, const FVector3& Offset)
+    {
+        const FVector3 Center = HashPoint(Index, WORLD_EXTENT) + Offset;
+        const float HalfSize = 0.25f + Hash01(Index * 7 + 5) * 1.75f;
+        return { Center - FVector3{ HalfSize, HalfSize, HalfSize }, Center + FVector3{ HalfSize, HalfSize, HalfSize } };
+    }
+}
+
+void RunBvhBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    FJobSystem Jobs;
+    std::vector<FAabb> Bounds(PRIMITIVE_COUNT);
+    for (uint32_t i = 0; i < PRIMITIVE_COUNT; i++)
+    {
+        Bounds[i] = MakeBounds(i, {});
+    }
+
+    FBvh Bvh;
+    const double BuildMs = MeasureBestMs([&]() { Bvh.Build(Bounds, Jobs); });
+    std::cout << "build             | " << std::setw(8) << BuildMs << " ms | " << PRIMITIVE_COUNT << " primitives, "
+        << Bvh.GetNodeCount() << " nodes, depth " << Bvh.GetDepth() << ", " << Jobs.GetWorkerCount() + 1 << " threads" << std::endl;
+
+    // Refit：全部移动 / 每 MOVED_STRIDE 个移动一个
+    float Time = 0.0f;
+    const double FullRefitMs = MeasureBestMs([&]()
+        {
+            Time += 0.1f;
+            for (uint32_t i = 0; i < PRIMITIVE_COUNT; i++)
+            {
+                Bounds[i] = MakeBounds(i, { std::sin(Time + i) * 0.5f, 0.0f, 0.0f });
+            }
+            Bvh.Refit(Bounds);
+        });
+    std::vector<uint32_t> Moved;
+    for (uint32_t i = 0; i < PRIMITIVE_COUNT; i += MOVED_STRIDE)
+    {
+        Moved.push_back(i);
+    }
+    const double IncrementalRefitMs = MeasureBestMs([&]()
+        {
+            Time += 0.1f;
+            for (uint32_t i : Moved)
+            {
+                Bounds[i] = MakeBounds(i, { std::sin(Time + i) * 0.5f, 0.0f, 0.0f });
+            }
+            Bvh.Refit(Bounds, Moved);
+        });
+    std::cout << "refit             | full " << std::setw(8) << FullRefitMs << " ms (incl. moving) | " << Moved.size() << " moved "
+        << std::setw(8) << IncrementalRefitMs << " ms" << std::endl;
+
+    // 视锥查询，与逐个测试对比
+    const FMatrix4 ViewProjection = FMatrix4::Perspective(PI / 3.0f, 16.0f / 9.0f, 0.1f, 300.0f) *
+        FMatrix4::LookAt({ 0.0f, -200.0f, 30.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f });
+    const FFrustum Frustum = FFrustum::FromViewProjection(ViewProjection);
+    std::vector<uint32_t> Results;
+    Results.reserve(PRIMITIVE_COUNT);
+    const double FrustumMs = MeasureBestMs([&]()
+        {
+            Results.clear();
+            Bvh.QueryFrustum(Frustum, Results);
+        });
+    const size_t FrustumCount = Results.size();
+    const double LinearMs = MeasureBestMs([&]()
+        {
+            Results.clear();
+            for (uint32_t i = 0; i < PRIMITIVE_COUNT; i++)
+            {
+                if (Frustum.Intersects(Bounds[i]))
+                {
+                    Results.push_back(i);
+                }
+            }
+        });
+    std::cout << "frustum query     | bvh " << std::setw(8) << FrustumMs << " ms | linear " << std::setw(8) << LinearMs
+        << " ms | " << FrustumCount << " visible" << (FrustumCount == Results.size() ? "" : " (MISMATCH)") << std::endl;
+
+    // 射线 (拾取) 与小范围盒子查询 (光源影响范围)
+    uint32_t HitCount = 0;
+    const double RayMs = MeasureBestMs([&]()
+        {
+            HitCount = 0;
+            for (uint32_t q = 0; q < QUERY_COUNT; q++)
+            {
+                const FVector3 Origin = HashPoint(q + PRIMITIVE_COUNT, WORLD_EXTENT);
+                const FVector3 Direction = (HashPoint(q + 2 * PRIMITIVE_COUNT, WORLD_EXTENT) - Origin).GetNormalized();
+                float Distance = WORLD_EXTENT;
+                HitCount += Bvh.RayCast(Origin, Direction, Distance) != FBvh::INVALID_INDEX ? 1 : 0;
+            }
+        });
+    size_t OverlapCount = 0;
+    const double AabbMs = MeasureBestMs([&]()
+        {
+            Results.clear();
+            for (uint32_t q = 0; q < QUERY_COUNT; q++)
+            {
+                const FVector3 Center = HashPoint(q + 3 * PRIMITIVE_COUNT, WORLD_EXTENT);
+                Bvh.QueryAabb({ Center - FVector3{ 10.0f, 10.0f, 10.0f }, Center + FVector3{ 10.0f, 10.0f, 10.0f } }, Results);
+            }
+            OverlapCount = Results.size();
+        });
+    std::cout << "ray cast          | " << std::setw(8) << RayMs << " ms / " << QUERY_COUNT << " rays ("
+        << RayMs * 1000.0 / QUERY_COUNT << " us each, " << HitCount << " hits)" << std::endl;
+    std::cout << "aabb query        | " << std::setw(8) << AabbMs << " ms / " << QUERY_COUNT << " boxes ("
+        << AabbMs * 1000.0 / QUERY_COUNT << " us each, " << OverlapCount << " overlaps)" << std::endl;
+
+    std::cout << std::defaultfloat;
+}
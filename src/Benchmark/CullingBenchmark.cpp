@@ -0,0 +1,87 @@
+﻿#include "Benchmark.h"
+#include "InstanceCulling.h"
+#include "MathSimd.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 10;
+    // 百万实例的网格阵列，相机只看到其中一部分，与演示场景的剔除比例相近
+    constexpr uint32_t INSTANCE_COUNT = 1'000'000;
+    constexpr float INSTANCE_SPACING = 1.5f;
+    constexpr float INSTANCE_RADIUS = 0.71f;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+}
+
+void RunCullingBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    const uint32_t GridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(INSTANCE_COUNT))));
+    const float GridExtent = GridSize * INSTANCE_SPACING;
+    std::vector<float> X(INSTANCE_COUNT), Y(INSTANCE_COUNT), Z(INSTANCE_COUNT, 0.0f), Radius(INSTANCE_COUNT, INSTANCE_RADIUS);
+    for (uint32_t i = 0; i < INSTANCE_COUNT; i++)
+    {
+        X[i] = (static_cast<float>(i % GridSize) + 0.5f) * INSTANCE_SPACING - GridExtent * 0.5f;
+        Y[i] = (static_cast<float>(i / GridSize) + 0.5f) * INSTANCE_SPACING - GridExtent * 0.5f;
+    }
+
+    const FMatrix4 ViewProjection = FMatrix4::Perspective(PI / 3.0f, 16.0f / 9.0f, 0.1f, 1000.0f) *
+        FMatrix4::LookAt({ GridExtent * 0.2f, 0.0f, GridExtent * 0.6f }, { GridExtent * 0.1f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+    const FFrustum Frustum = FFrustum::FromViewProjection(ViewProjection);
+    const FSphereArrays Spheres = { X.data(), Y.data(), Z.data(), Radius.data(), INSTANCE_COUNT };
+
+    // 1. 单线程：各 SIMD 路径直接压缩出可见列表
+    std::vector<uint32_t> Visible(INSTANCE_COUNT);
+    uint32_t VisibleCount = 0;
+    double ScalarMs = 0.0;
+    std::cout << std::left << std::setw(18) << "single thread" << std::right;
+    for (MathSimd::EPath Path : { MathSimd::EPath::Scalar, MathSimd::EPath::SSE, MathSimd::EPath::AVX2 })
+    {
+        if (!MathSimd::IsPathSupported(Path))
+        {
+            std::cout << " | " << MathSimd::GetPathName(Path) << " unsupported";
+            continue;
+        }
+
+        const double Ms = MeasureBestMs([&]()
+            {
+                VisibleCount = MathSimd::CullSpheres(Frustum, X.data(), Y.data(), Z.data(), Radius.data(), 0, INSTANCE_COUNT, Visible.data(), Path);
+            });
+        ScalarMs = Path == MathSimd::EPath::Scalar ? Ms : ScalarMs;
+        std::cout << " | " << MathSimd::GetPathName(Path) << " " << std::setw(7) << Ms << " ms (x" << ScalarMs / Ms << ")";
+    }
+    std::cout << std::endl;
+
+    // 2. Job 系统分块并行 + 拼接，即 RenderPrep 的实际路径；暂存与输出都来自帧内存池
+    FJobSystem Jobs;
+    FFrameArena Arena;
+    Arena.Initialize(FRAME_ARENA_CAPACITY, false);
+    uint32_t ParallelCount = 0;
+    const double ParallelMs = MeasureBestMs([&]()
+        {
+            TFrameVector<uint32_t> ParallelVisible(Arena.GetResource());
+            ParallelCount = InstanceCulling::CullSpheres(Frustum, Spheres, Jobs, Arena, ParallelVisible);
+            ParallelVisible = TFrameVector<uint32_t>(Arena.GetResource());
+            Arena.Reset();
+        });
+    std::cout << std::left << std::setw(18) << "job system" << std::right << " | " << Jobs.GetWorkerCount() + 1 << " threads "
+        << std::setw(7) << ParallelMs << " ms (x" << ScalarMs / ParallelMs << ")" << std::endl;
+
+    std::cout << "  visible " << VisibleCount << " / " << INSTANCE_COUNT
+        << (ParallelCount == VisibleCount ? "" : " (MISMATCH with job system result)") << std::endl;
+    std::cout << std::defaultfloat;
+}
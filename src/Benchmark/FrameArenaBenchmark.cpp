@@ -0,0 +1,123 @@
+﻿#include "Benchmark.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 5;
+    constexpr uint32_t FRAME_COUNT = 64;
+    // 每帧的临时分配次数与大小范围，近似一帧的绘制列表/屏障数组/排序缓冲
+    constexpr uint32_t ALLOCATIONS_PER_FRAME = 20'000;
+    constexpr uint32_t MAX_ALLOCATION_SIZE = 512;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    uint32_t AllocationSize(uint32_t Index)
+    {
+        return 16 + (Index * 2654435761u >> 7) % MAX_ALLOCATION_SIZE;
+    }
+
+    // 一帧的临时工作：分配 Count 个小缓冲并写入首字节，heap 版本帧末逐个释放
+    uint64_t HeapFrame(uint32_t Begin, uint32_t End)
+    {
+        std::vector<std::unique_ptr<uint8_t[]>> Blocks;
+        Blocks.reserve(End - Begin);
+        uint64_t Sum = 0;
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            Blocks.push_back(std::make_unique_for_overwrite<uint8_t[]>(AllocationSize(i)));
+            Blocks.back()[0] = static_cast<uint8_t>(i);
+            Sum += Blocks.back()[0];
+        }
+        return Sum;
+    }
+
+    uint64_t ArenaFrame(FFrameArena& Arena, uint32_t Begin, uint32_t End)
+    {
+        uint8_t** Blocks = Arena.AllocateArray<uint8_t*>(End - Begin);
+        uint64_t Sum = 0;
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            uint8_t*& Block = Blocks[i - Begin];
+            Block = Arena.AllocateArray<uint8_t>(AllocationSize(i));
+            Block[0] = static_cast<uint8_t>(i);
+            Sum += Block[0];
+        }
+        return Sum;
+    }
+
+    void RunComparison(FJobSystem* Jobs, FFrameArena& Arena)
+    {
+        std::atomic<uint64_t> Sink = 0;
+        auto RunFrame = [&](auto&& FrameFunc)
+            {
+                if (Jobs)
+                {
+                    Jobs->ParallelFor(ALLOCATIONS_PER_FRAME, [&](uint32_t Begin, uint32_t End)
+                        {
+                            Sink.fetch_add(FrameFunc(Begin, End), std::memory_order_relaxed);
+                        }, 1024);
+                }
+                else
+                {
+                    Sink.fetch_add(FrameFunc(0, ALLOCATIONS_PER_FRAME), std::memory_order_relaxed);
+                }
+            };
+
+        const double HeapMs = MeasureBestMs([&]()
+            {
+                for (uint32_t Frame = 0; Frame < FRAME_COUNT; Frame++)
+                {
+                    RunFrame([](uint32_t Begin, uint32_t End) { return HeapFrame(Begin, End); });
+                }
+            });
+
+        size_t PeakBytes = 0;
+        const double ArenaMs = MeasureBestMs([&]()
+            {
+                for (uint32_t Frame = 0; Frame < FRAME_COUNT; Frame++)
+                {
+                    RunFrame([&Arena](uint32_t Begin, uint32_t End) { return ArenaFrame(Arena, Begin, End); });
+                    PeakBytes = std::max(PeakBytes, Arena.GetUsedBytes() + Arena.GetOverflowBytes());
+                    Arena.Reset();
+                }
+            });
+
+        const double AllocationCount = static_cast<double>(FRAME_COUNT) * ALLOCATIONS_PER_FRAME;
+        std::cout << (Jobs ? "parallel_for" : "single thread") << ": "
+            << "heap " << std::setw(8) << HeapMs << " ms (" << HeapMs * 1'000'000.0 / AllocationCount << " ns/alloc) | "
+            << "arena " << std::setw(8) << ArenaMs << " ms (" << ArenaMs * 1'000'000.0 / AllocationCount << " ns/alloc, x"
+            << HeapMs / ArenaMs << ") | peak " << PeakBytes / 1024 << " KB/frame" << std::endl;
+    }
+}
+
+void RunFrameArenaBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (bool bHugePages : { false, true })
+    {
+        FFrameArena Arena;
+        Arena.Initialize(FRAME_ARENA_CAPACITY, bHugePages);
+        std::cout << "-- " << (Arena.IsHugePageBacked() ? "huge pages" : "regular pages")
+            << (bHugePages && !Arena.IsHugePageBacked() ? " (huge pages unavailable)" : "") << std::endl;
+
+        RunComparison(nullptr, Arena);
+        FJobSystem Jobs;
+        RunComparison(&Jobs, Arena);
+    }
+
+    std::cout << std::defaultfloat;
+}
@@ -0,0 +1,105 @@
+﻿#include "Benchmark.h"
+#include "TransformHierarchy.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 10;
+    // 三层层级：1000 个根 x 10 个子节点 x 100 个叶子，约一百万个节点
+    constexpr uint32_t ROOT_COUNT = 1000;
+    constexpr uint32_t CHILDREN_PER_ROOT = 10;
+    constexpr uint32_t LEAVES_PER_CHILD = 100;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    FMatrix4 MakeLocal(uint32_t Index, float Angle)
+    {
+        const float Offset = static_cast<float>(Index % 97) * 0.1f;
+        return FMatrix4::TranslationRotationScale({ Offset, 1.0f, -Offset }, FQuat::FromAxisAngle({ 0.0f, 0.0f, 1.0f }, Angle), { 1.0f, 1.0f, 1.0f });
+    }
+
+    // 每轮先修改一批节点的局部矩阵再 Update，输出耗时与重算的节点数
+    template <typename FuncType>
+    void RunCase(const char* Name, FTransformHierarchy& Hierarchy, FJobSystem& Jobs, FuncType&& Modify)
+    {
+        float Angle = 0.0f;
+        const double Ms = MeasureBestMs([&]()
+            {
+                Angle += 0.01f;
+                Modify(Angle);
+                Hierarchy.Update(Jobs);
+            });
+        std::cout << std::left << std::setw(24) << Name << std::right << " | " << std::setw(8) << Ms << " ms | updated "
+            << std::setw(8) << Hierarchy.GetUpdatedCount() << " / " << Hierarchy.GetNodeCount() << std::endl;
+    }
+}
+
+void RunHierarchyBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    FJobSystem Jobs;
+    FTransformHierarchy Hierarchy;
+    std::vector<uint32_t> Roots, Children, Leaves;
+    for (uint32_t r = 0; r < ROOT_COUNT; r++)
+    {
+        Roots.push_back(Hierarchy.AddNode(FTransformHierarchy::INVALID_NODE, MakeLocal(r, 0.0f)));
+    }
+    // 交错加入，槽位重排前的内存顺序与层级无关
+    for (uint32_t c = 0; c < CHILDREN_PER_ROOT; c++)
+    {
+        for (uint32_t r = 0; r < ROOT_COUNT; r++)
+        {
+            Children.push_back(Hierarchy.AddNode(Roots[r], MakeLocal(c, 0.0f)));
+        }
+    }
+    for (uint32_t l = 0; l < LEAVES_PER_CHILD; l++)
+    {
+        for (uint32_t Child : Children)
+        {
+            Leaves.push_back(Hierarchy.AddNode(Child, MakeLocal(l, 0.0f)));
+        }
+    }
+
+    const uint64_t BuildBeginNs = Utils::GetTimeNs();
+    Hierarchy.Update(Jobs);
+    std::cout << "layout rebuild + full update: " << (Utils::GetTimeNs() - BuildBeginNs) / 1e6 << " ms, "
+        << Hierarchy.GetNodeCount() << " nodes in " << Hierarchy.GetLevelCount() << " levels" << std::endl;
+
+    RunCase("all roots moved", Hierarchy, Jobs, [&](float Angle)
+        {
+            for (uint32_t Root : Roots)
+            {
+                Hierarchy.SetLocal(Root, MakeLocal(Root, Angle));
+            }
+        });
+    RunCase("10 subtrees moved", Hierarchy, Jobs, [&](float Angle)
+        {
+            for (uint32_t i = 0; i < 10; i++)
+            {
+                Hierarchy.SetLocal(Children[i * 997], MakeLocal(i, Angle));
+            }
+        });
+    RunCase("1000 leaves moved", Hierarchy, Jobs, [&](float Angle)
+        {
+            for (uint32_t i = 0; i < 1000; i++)
+            {
+                Hierarchy.SetLocal(Leaves[i * 1009 % Leaves.size()], MakeLocal(i, Angle));
+            }
+        });
+    RunCase("nothing moved", Hierarchy, Jobs, [](float) {});
+
+    std::cout << std::defaultfloat;
+}
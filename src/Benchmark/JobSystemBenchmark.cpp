@@ -0,0 +1,168 @@
+﻿#include "Benchmark.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 5;
+
+    // 模拟一个计算密集的小任务，结果写入 Sink 防止被优化掉
+    uint64_t SpinWork(uint32_t Seed, uint32_t Iterations)
+    {
+        uint64_t Value = Seed + 1;
+        for (uint32_t i = 0; i < Iterations; i++)
+        {
+            Value = Value * 6364136223846793005ull + 1442695040888963407ull;
+            Value ^= Value >> 29;
+        }
+        return Value;
+    }
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    void RunTaskComparison(FJobSystem& Jobs, uint32_t TaskCount, uint32_t Iterations)
+    {
+        std::vector<uint64_t> Sink(TaskCount);
+
+        const double SerialMs = MeasureBestMs([&]()
+            {
+                for (uint32_t i = 0; i < TaskCount; i++)
+                {
+                    Sink[i] = SpinWork(i, Iterations);
+                }
+            });
+
+        // 基线：每个任务一个 std::thread
+        const double ThreadPerTaskMs = MeasureBestMs([&]()
+            {
+                std::vector<std::thread> Threads;
+                Threads.reserve(TaskCount);
+                for (uint32_t i = 0; i < TaskCount; i++)
+                {
+                    Threads.emplace_back([&Sink, i, Iterations]() { Sink[i] = SpinWork(i, Iterations); });
+                }
+                for (std::thread& Thread : Threads)
+                {
+                    Thread.join();
+                }
+            });
+
+        const double ScheduleMs = MeasureBestMs([&]()
+            {
+                FJobCounter Counter;
+                for (uint32_t i = 0; i < TaskCount; i++)
+                {
+                    Jobs.Schedule([&Sink, i, Iterations]() { Sink[i] = SpinWork(i, Iterations); }, &Counter);
+                }
+                Jobs.Wait(Counter);
+            });
+
+        const double ParallelForMs = MeasureBestMs([&]()
+            {
+                Jobs.ParallelFor(TaskCount, [&Sink, Iterations](uint32_t Begin, uint32_t End)
+                    {
+                        for (uint32_t i = Begin; i < End; i++)
+                        {
+                            Sink[i] = SpinWork(i, Iterations);
+                        }
+                    });
+            });
+
+        std::cout << std::setw(7) << TaskCount << " tasks x " << std::setw(7) << Iterations << " iters | "
+            << "serial " << std::setw(9) << SerialMs << " ms | "
+            << "thread/task " << std::setw(9) << ThreadPerTaskMs << " ms | "
+            << "schedule " << std::setw(9) << ScheduleMs << " ms (x" << ThreadPerTaskMs / ScheduleMs << ") | "
+            << "parallel_for " << std::setw(9) << ParallelForMs << " ms (x" << ThreadPerTaskMs / ParallelForMs << ")"
+            << std::endl;
+    }
+
+    void RunDependencyChain(FJobSystem& Jobs, uint32_t ChainLength)
+    {
+        // 依赖链：每个 Job 等前一个完成，衡量后续 Job 的提交开销
+        const double ChainMs = MeasureBestMs([&]()
+            {
+                std::vector<std::unique_ptr<FJobCounter>> Counters;
+                Counters.reserve(ChainLength);
+                Counters.push_back(std::make_unique<FJobCounter>());
+                Jobs.Schedule([]() {}, Counters.back().get());
+
+                for (uint32_t i = 1; i < ChainLength; i++)
+                {
+                    FJobCounter& Previous = *Counters.back();
+                    Counters.push_back(std::make_unique<FJobCounter>());
+                    Jobs.ScheduleAfter(Previous, []() {}, Counters.back().get());
+                }
+
+                for (std::unique_ptr<FJobCounter>& Counter : Counters)
+                {
+                    Jobs.Wait(*Counter);
+                }
+            });
+
+        std::cout << "dependency chain of " << ChainLength << " jobs: " << ChainMs << " ms ("
+            << ChainMs * 1'000'000.0 / ChainLength << " ns/job)" << std::endl;
+    }
+
+    void RunScaling(uint32_t ItemCount, uint32_t Iterations)
+    {
+        // ParallelFor 随 Worker 数的扩展性 (调用线程也参与执行，总线程数 = Worker + 1)
+        const uint32_t MaxWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        std::vector<uint64_t> Sink(ItemCount);
+        double BaselineMs = 0.0;
+
+        for (uint32_t NumWorkers = 1; ; NumWorkers = std::min(NumWorkers * 2, MaxWorkers))
+        {
+            FJobSystem Jobs(NumWorkers);
+            const double Ms = MeasureBestMs([&]()
+                {
+                    Jobs.ParallelFor(ItemCount, [&Sink, Iterations](uint32_t Begin, uint32_t End)
+                        {
+                            for (uint32_t i = Begin; i < End; i++)
+                            {
+                                Sink[i] = SpinWork(i, Iterations);
+                            }
+                        });
+                });
+
+            if (NumWorkers == 1)
+            {
+                BaselineMs = Ms;
+            }
+            std::cout << "scaling: " << std::setw(3) << NumWorkers + 1 << " threads " << std::setw(9) << Ms
+                << " ms, x" << BaselineMs / Ms << " vs 2 threads" << std::endl;
+
+            if (NumWorkers == MaxWorkers)
+            {
+                break;
+            }
+        }
+    }
+}
+
+void RunJobSystemBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    {
+        FJobSystem Jobs;
+        RunTaskComparison(Jobs, 256, 200'000);
+        RunTaskComparison(Jobs, 4096, 20'000);
+        RunTaskComparison(Jobs, 4096, 500);
+        RunDependencyChain(Jobs, 1024);
+    }
+
+    RunScaling(1 << 16, 2'000);
+
+    std::cout << std::defaultfloat;
+}
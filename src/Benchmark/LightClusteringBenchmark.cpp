@@ -0,0 +1,172 @@
+﻿#include "Benchmark.h"
+#include "Scene.h"
+#include "FramePacket.h"
+#include "LightClustering.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 10;
+    // 96x96 的阵列，相机用场景自己的 (斜看阵列中心)，投影同 RenderPrep
+    constexpr uint32_t INSTANCE_COUNT = 64 * 64;
+    constexpr uint32_t LIGHT_COUNTS[] = { 256, 512, 1024 };
+    constexpr uint32_t VIEWPORT_WIDTH = 1920;
+    constexpr uint32_t VIEWPORT_HEIGHT = 1080;
+    // 着色开销按每 8x8 像素取一个样本估计
+    constexpr uint32_t PIXEL_SAMPLE_STEP = 8;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    void TransformLights(const FMatrix4& View, std::span<const FPointLight> Lights, std::vector<FPointLight>& OutViewLights)
+    {
+        OutViewLights.assign(Lights.begin(), Lights.end());
+        for (FPointLight& Light : OutViewLights)
+        {
+            Light.Position = View.TransformPoint(Light.Position);
+        }
+    }
+
+    struct FShadingEstimate
+    {
+        double ListedPerPixel = 0.0;  // 片元所在簇的列表长度
+        double InRangePerPixel = 0.0; // 其中真正照到该点的光源
+        uint32_t PixelCount = 0;
+    };
+
+    // 场景几何都在 Z = 0 平面附近：每个采样像素的视线与该平面求交，按交点查簇并统计要循环的光源数
+    FShadingEstimate EstimateShading(const FLightClusterGrid& Grid, const FMatrix4& View, std::span<const FPointLight> ViewLights,
+        const FLightClusterBuilder& Builder)
+    {
+        // 观察矩阵的旋转部分正交：世界方向 = 各行按观察空间分量加权
+        const FVector3 Row0 = View.GetRow(0).XYZ();
+        const FVector3 Row1 = View.GetRow(1).XYZ();
+        const FVector3 Row2 = View.GetRow(2).XYZ();
+        const FVector3 T = View.Columns[3].XYZ();
+        const FVector3 Eye = -(Row0 * T.X + Row1 * T.Y + Row2 * T.Z);
+
+        FShadingEstimate Result;
+        uint64_t Listed = 0;
+        uint64_t InRange = 0;
+        for (uint32_t Y = PIXEL_SAMPLE_STEP / 2; Y < VIEWPORT_HEIGHT; Y += PIXEL_SAMPLE_STEP)
+        {
+            for (uint32_t X = PIXEL_SAMPLE_STEP / 2; X < VIEWPORT_WIDTH; X += PIXEL_SAMPLE_STEP)
+            {
+                const float NdcX = (X + 0.5f) / VIEWPORT_WIDTH * 2.0f - 1.0f;
+                const float NdcY = (Y + 0.5f) / VIEWPORT_HEIGHT * 2.0f - 1.0f;
+                const FVector3 ViewDir = { NdcX / Grid.ProjectionScaleX, -NdcY / Grid.ProjectionScaleY, -1.0f };
+                const FVector3 WorldDir = Row0 * ViewDir.X + Row1 * ViewDir.Y + Row2 * ViewDir.Z;
+                if (WorldDir.Z >= 0.0f)
+                {
+                    continue;
+                }
+
+                // ViewDir 的 -Z 分量为 1，沿它前进的参数就是观察空间深度
+                const float Depth = -Eye.Z / WorldDir.Z;
+                if (Depth < Grid.NearZ || Depth > Grid.FarZ)
+                {
+                    continue;
+                }
+                const FVector3 ViewPos = ViewDir * Depth;
+                const FLightCluster& Cluster = Builder.GetClusters()[Grid.GetClusterIndex(static_cast<float>(X), static_cast<float>(Y), Depth)];
+                for (uint32_t i = 0; i < Cluster.Count; i++)
+                {
+                    const FPointLight& Light = ViewLights[Builder.GetLightIndices()[Cluster.Offset + i]];
+                    const FVector3 Delta = Light.Position - ViewPos;
+                    InRange += FVector3::Dot(Delta, Delta) <= Light.Radius * Light.Radius ? 1 : 0;
+                }
+                Listed += Cluster.Count;
+                Result.PixelCount++;
+            }
+        }
+        Result.ListedPerPixel = static_cast<double>(Listed) / std::max(Result.PixelCount, 1u);
+        Result.InRangePerPixel = static_cast<double>(InRange) / std::max(Result.PixelCount, 1u);
+        return Result;
+    }
+}
+
+void RunLightClusteringBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    FJobSystem Jobs;
+    const FMatrix4 Projection = FMatrix4::Perspective(PI / 3.0f, static_cast<float>(VIEWPORT_WIDTH) / VIEWPORT_HEIGHT, 0.1f, 1000.0f);
+    const FLightClusterGrid Grid = FLightClusterGrid::FromProjection(Projection, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    std::cout << FLightClusterGrid::TILE_COUNT_X << "x" << FLightClusterGrid::TILE_COUNT_Y << "x" << FLightClusterGrid::SLICE_COUNT
+        << " clusters, " << VIEWPORT_WIDTH << "x" << VIEWPORT_HEIGHT << ", " << Jobs.GetWorkerCount() + 1 << " threads" << std::endl;
+
+    for (uint32_t LightCount : LIGHT_COUNTS)
+    {
+        FScene Scene(INSTANCE_COUNT, LightCount);
+        FFramePacket Packet;
+        Packet.Arena.Initialize(FRAME_ARENA_CAPACITY, false);
+        Scene.Update(1.0f, Jobs);
+        Scene.Snapshot(Packet, Jobs);
+        const std::span<const FPointLight> Lights(Packet.Lights.data(), Packet.Lights.size());
+
+        // 对照：每个簇测试全部光源，只计数
+        std::vector<FPointLight> ViewLights;
+        std::vector<uint32_t> BruteCounts(FLightClusterGrid::CLUSTER_COUNT);
+        const double BruteMs = MeasureBestMs([&]()
+            {
+                TransformLights(Packet.View, Lights, ViewLights);
+                Jobs.ParallelFor(FLightClusterGrid::CLUSTER_COUNT, [&](uint32_t Begin, uint32_t End)
+                    {
+                        for (uint32_t Cluster = Begin; Cluster < End; Cluster++)
+                        {
+                            const FAabb Bounds = Grid.GetClusterBounds(Cluster);
+                            uint32_t Count = 0;
+                            for (const FPointLight& Light : ViewLights)
+                            {
+                                const float DX = std::max({ Bounds.Min.X - Light.Position.X, 0.0f, Light.Position.X - Bounds.Max.X });
+                                const float DY = std::max({ Bounds.Min.Y - Light.Position.Y, 0.0f, Light.Position.Y - Bounds.Max.Y });
+                                const float DZ = std::max({ Bounds.Min.Z - Light.Position.Z, 0.0f, Light.Position.Z - Bounds.Max.Z });
+                                Count += DX * DX + DY * DY + DZ * DZ <= Light.Radius * Light.Radius ? 1 : 0;
+                            }
+                            BruteCounts[Cluster] = std::min(Count, FLightClusterGrid::MAX_LIGHTS_PER_CLUSTER);
+                        }
+                    }, 64);
+            });
+
+        FLightClusterBuilder Builder;
+        const double BuildMs = MeasureBestMs([&]()
+            {
+                TransformLights(Packet.View, Lights, ViewLights);
+                Builder.Build(Grid, ViewLights, Jobs);
+            });
+
+        uint32_t Mismatches = 0;
+        uint32_t OccupiedCount = 0;
+        uint32_t MaxCount = 0;
+        for (uint32_t Cluster = 0; Cluster < FLightClusterGrid::CLUSTER_COUNT; Cluster++)
+        {
+            const uint32_t Count = Builder.GetClusters()[Cluster].Count;
+            Mismatches += Count != BruteCounts[Cluster] ? 1 : 0;
+            OccupiedCount += Count > 0 ? 1 : 0;
+            MaxCount = std::max(MaxCount, Count);
+        }
+        const FShadingEstimate Shading = EstimateShading(Grid, Packet.View, ViewLights, Builder);
+
+        std::cout << LightCount << " lights:" << std::endl;
+        std::cout << "  " << std::left << std::setw(16) << "brute force" << std::right << " | " << std::setw(8) << BruteMs << " ms" << std::endl;
+        std::cout << "  " << std::left << std::setw(16) << "slice binning" << std::right << " | " << std::setw(8) << BuildMs << " ms | "
+            << Builder.GetLightIndices().size() << " indices, " << Builder.GetAverageLightsPerCluster() << " lights/cluster ("
+            << static_cast<double>(Builder.GetLightIndices().size()) / std::max(OccupiedCount, 1u) << " over " << OccupiedCount
+            << " occupied, max " << MaxCount << "), " << Mismatches << " mismatches" << std::endl;
+        std::cout << "  " << std::left << std::setw(16) << "shading" << std::right << " | " << Shading.ListedPerPixel
+            << " lights looped per pixel (" << Shading.InRangePerPixel << " in range) vs " << LightCount << " naive, "
+            << Shading.PixelCount << " sampled pixels" << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
@@ -0,0 +1,145 @@
+﻿#include "Benchmark.h"
+#include "Scene.h"
+#include "FramePacket.h"
+#include "InstanceCulling.h"
+#include "LodSelector.h"
+#include "MeshOptimizer.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 10;
+    // 比网格簇渲染默认的圆环更密，LOD 链更长
+    constexpr uint32_t TORUS_MAJOR_SEGMENTS = 256;
+    constexpr uint32_t TORUS_MINOR_SEGMENTS = 128;
+    constexpr uint32_t INSTANCE_COUNT = 512 * 512;
+    // 相机低空斜看阵列，可见实例的距离从几米到几百米
+    constexpr float CAMERA_HEIGHT = 10.0f;
+    constexpr uint32_t VIEWPORT_WIDTH = 1920;
+    constexpr uint32_t VIEWPORT_HEIGHT = 1080;
+    constexpr float FOV_Y = PI / 3.0f;
+    constexpr float NEAR_Z = 0.1f;
+    // 滞回测试：相机沿视线来回移动的幅度与帧数
+    constexpr float OSCILLATION_AMPLITUDE = 0.05f;
+    constexpr uint32_t OSCILLATION_FRAMES = 64;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    FMatrix4 MakeView(float Forward)
+    {
+        const FVector3 Eye = { 0.0f, Forward, CAMERA_HEIGHT };
+        return FMatrix4::LookAt(Eye, Eye + FVector3(0.0f, 1.0f, -0.15f), { 0.0f, 0.0f, 1.0f });
+    }
+}
+
+void RunLodBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    // 1. 离线：简化出 LOD 链并逐级构建簇 (与导入流程相同)
+    FMeshData Mesh = MeshUtils::CreateTorus(1.0f, 0.35f, TORUS_MAJOR_SEGMENTS, TORUS_MINOR_SEGMENTS);
+    MeshOptimizer::Optimize(Mesh);
+    const uint64_t BuildBeginNs = Utils::GetTimeNs();
+    const FMeshletData Meshlets = MeshletBuilder::BuildLods(Mesh);
+    const double BuildMs = (Utils::GetTimeNs() - BuildBeginNs) / 1e6;
+
+    std::cout << "LOD chain of a " << Mesh.GetTriangleCount() << "-triangle torus built in " << BuildMs << " ms" << std::endl;
+    std::vector<float> RelativeErrors;
+    for (size_t i = 0; i < Meshlets.Lods.size(); i++)
+    {
+        const FMeshLod& Lod = Meshlets.Lods[i];
+        RelativeErrors.push_back(Lod.Error / Mesh.Bounds.Radius);
+        std::cout << "  LOD " << i << " | " << std::setw(6) << Lod.TriangleCount << " triangles | " << std::setw(4) << Lod.MeshletCount
+            << " meshlets | error " << 100.0f * RelativeErrors.back() << "% of radius" << std::endl;
+    }
+
+    // 2. 运行时：演示场景放大，按 RenderPrep 的方式为视锥内的实例选择 LOD
+    FJobSystem Jobs;
+    FScene Scene(INSTANCE_COUNT);
+    FFramePacket Packet;
+    Packet.Arena.Initialize(FRAME_ARENA_CAPACITY, false);
+    Scene.Update(1.0f, Jobs);
+    Scene.Snapshot(Packet, Jobs);
+
+    const FMatrix4 Projection = FMatrix4::Perspective(FOV_Y, static_cast<float>(VIEWPORT_WIDTH) / VIEWPORT_HEIGHT, NEAR_Z, 1000.0f);
+    const FMatrix4 View = MakeView(0.0f);
+    const FFrustum Frustum = FFrustum::FromViewProjection(Projection * View);
+    const FSphereArrays Spheres = { Packet.BoundsX.data(), Packet.BoundsY.data(), Packet.BoundsZ.data(), Packet.BoundsRadius.data(), INSTANCE_COUNT };
+    InstanceCulling::CullSpheres(Frustum, Spheres, Jobs, Packet.Arena, Packet.VisibleInstances);
+    const uint32_t VisibleCount = static_cast<uint32_t>(Packet.VisibleInstances.size());
+
+    FLodSelector Selector;
+    Selector.SetLodErrors(RelativeErrors);
+    std::vector<uint8_t> Lods(INSTANCE_COUNT, 0);
+    auto CountTriangles = [&]()
+        {
+            uint64_t Triangles = 0;
+            for (uint32_t Index : Packet.VisibleInstances)
+            {
+                Triangles += Meshlets.Lods[Lods[Index]].TriangleCount;
+            }
+            return Triangles;
+        };
+
+    const double SelectVisibleMs = MeasureBestMs([&]()
+        {
+            Selector.BeginFrame(View, FOV_Y, VIEWPORT_HEIGHT, NEAR_Z);
+            Selector.Select(Spheres, Packet.VisibleInstances.data(), VisibleCount, Jobs, Lods.data());
+        });
+    const uint64_t LodTriangles = CountTriangles();
+    const double SelectAllMs = MeasureBestMs([&]()
+        {
+            Selector.Select(Spheres, nullptr, INSTANCE_COUNT, Jobs, Lods.data());
+        });
+    const uint64_t FullTriangles = static_cast<uint64_t>(VisibleCount) * Meshlets.Lods[0].TriangleCount;
+
+    std::cout << std::left << std::setw(20) << "select (visible)" << std::right << " | " << std::setw(8) << SelectVisibleMs << " ms | "
+        << VisibleCount << " instances, " << Jobs.GetWorkerCount() + 1 << " threads" << std::endl;
+    std::cout << std::left << std::setw(20) << "select (all)" << std::right << " | " << std::setw(8) << SelectAllMs << " ms | "
+        << INSTANCE_COUNT << " instances" << std::endl;
+    std::cout << std::left << std::setw(20) << "triangles" << std::right << " | " << FullTriangles << " at LOD 0 -> " << LodTriangles
+        << " with " << FLodSelector::DEFAULT_ERROR_PIXELS << " px error (" << static_cast<double>(FullTriangles) / std::max<uint64_t>(LodTriangles, 1)
+        << "x fewer)" << std::endl;
+
+    // 3. 滞回：相机在原地小幅前后移动，统计每帧改变 LOD 的实例数 (无状态选择 vs 带滞回的持久选择)
+    uint64_t StatelessSwitches = 0;
+    uint64_t PersistentSwitches = 0;
+    std::vector<uint8_t> StatelessLods(INSTANCE_COUNT, 0);
+    std::vector<uint8_t> PreviousStateless(INSTANCE_COUNT, 0);
+    std::vector<uint8_t> PreviousPersistent = Lods;
+    for (uint32_t Frame = 0; Frame < OSCILLATION_FRAMES; Frame++)
+    {
+        const FMatrix4 FrameView = MakeView((Frame % 2 == 0 ? 1.0f : -1.0f) * OSCILLATION_AMPLITUDE);
+
+        FLodSelector Stateless;
+        Stateless.SetLodErrors(RelativeErrors);
+        Stateless.BeginFrame(FrameView, FOV_Y, VIEWPORT_HEIGHT, NEAR_Z);
+        Stateless.Select(Spheres, Packet.VisibleInstances.data(), VisibleCount, Jobs, StatelessLods.data());
+        Selector.BeginFrame(FrameView, FOV_Y, VIEWPORT_HEIGHT, NEAR_Z);
+        Selector.Select(Spheres, Packet.VisibleInstances.data(), VisibleCount, Jobs, Lods.data());
+
+        for (uint32_t Index : Packet.VisibleInstances)
+        {
+            StatelessSwitches += Frame > 0 && StatelessLods[Index] != PreviousStateless[Index] ? 1 : 0;
+            PersistentSwitches += Frame > 0 && Lods[Index] != PreviousPersistent[Index] ? 1 : 0;
+            PreviousStateless[Index] = StatelessLods[Index];
+            PreviousPersistent[Index] = Lods[Index];
+        }
+    }
+    std::cout << std::left << std::setw(20) << "LOD switches/frame" << std::right << " | " << static_cast<double>(StatelessSwitches) / (OSCILLATION_FRAMES - 1)
+        << " stateless -> " << static_cast<double>(PersistentSwitches) / (OSCILLATION_FRAMES - 1) << " with hysteresis (camera moving +-"
+        << OSCILLATION_AMPLITUDE << " m)" << std::endl;
+    std::cout << std::defaultfloat;
+}
@@ -0,0 +1,175 @@
+﻿#include "Benchmark.h"
+#include <charconv>
+#include <iomanip>
+
+namespace {
+    // 一批记录约 14 KB，远小于每线程 64 KB 的环，批间 Flush 保证不会触发丢弃
+    constexpr uint32_t BURST_SIZE = 256;
+    constexpr uint32_t BURST_COUNT = 100;
+    // 连续写入的条数，远超环容量，用于观察写满之后的丢弃与阻塞
+    constexpr uint32_t STREAM_COUNT = 200'000;
+
+    // 只计数不输出的 Sink，避免基准测试刷屏，同时统计实际送达与丢弃的条数
+    class FCountingLogSink : public FLogSink
+    {
+    public:
+        void Write(ELogLevel, std::string_view Line) override
+        {
+            constexpr std::string_view DROPPED_SUFFIX = " messages dropped (buffer full)";
+            if (!Line.ends_with(DROPPED_SUFFIX))
+            {
+                Delivered.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            const size_t Begin = Line.rfind("] ") + 2;
+            uint64_t Count = 0;
+            std::from_chars(Line.data() + Begin, Line.data() + Line.size(), Count);
+            Dropped.fetch_add(Count, std::memory_order_relaxed);
+        }
+
+        void Reset()
+        {
+            Delivered = 0;
+            Dropped = 0;
+        }
+
+        std::atomic<uint64_t> Delivered = 0;
+        std::atomic<uint64_t> Dropped = 0;
+    };
+
+    // 一条典型的帧内诊断：整数、浮点与短字符串参数
+    inline void LogSample(uint32_t Frame, uint32_t Index)
+    {
+        CA_LOG_INFO("Bench", "Frame {} draw {} took {} ms ({})", Frame, Index, 0.25f * Index, "opaque");
+    }
+
+    inline void LogSampleError(uint32_t Frame, uint32_t Index)
+    {
+        CA_LOG_ERROR("Bench", "Frame {} draw {} took {} ms ({})", Frame, Index, 0.25f * Index, "opaque");
+    }
+
+    // 基线：调用线程同步格式化 (不含 IO)，即不用异步日志时至少要付出的代价
+    double MeasureSnprintfNs()
+    {
+        char Buffer[128];
+        uint64_t Sink = 0;
+        const uint64_t BeginNs = Utils::GetTimeNs();
+        for (uint32_t i = 0; i < BURST_SIZE * BURST_COUNT; i++)
+        {
+            Sink += std::snprintf(Buffer, sizeof(Buffer), "Frame %u draw %u took %g ms (%s)", i / BURST_SIZE, i, 0.25f * i, "opaque");
+        }
+        const uint64_t EndNs = Utils::GetTimeNs();
+        return Sink ? static_cast<double>(EndNs - BeginNs) / (BURST_SIZE * BURST_COUNT) : 0.0;
+    }
+
+    // 每个线程写 BURST_COUNT 批，只统计写入本身的耗时；返回各线程平均的 ns/条
+    double MeasureBurstNs(uint32_t ThreadCount)
+    {
+        std::vector<uint64_t> ThreadNs(ThreadCount);
+        auto ThreadMain = [&ThreadNs](uint32_t ThreadIndex)
+            {
+                uint64_t TotalNs = 0;
+                for (uint32_t Burst = 0; Burst < BURST_COUNT; Burst++)
+                {
+                    const uint64_t BeginNs = Utils::GetTimeNs();
+                    for (uint32_t i = 0; i < BURST_SIZE; i++)
+                    {
+                        LogSample(Burst, i);
+                    }
+                    TotalNs += Utils::GetTimeNs() - BeginNs;
+                    FLogger::Get().Flush();
+                }
+                ThreadNs[ThreadIndex] = TotalNs;
+            };
+
+        std::vector<std::thread> Threads;
+        for (uint32_t i = 0; i < ThreadCount; i++)
+        {
+            Threads.emplace_back(ThreadMain, i);
+        }
+        for (std::thread& Thread : Threads)
+        {
+            Thread.join();
+        }
+
+        uint64_t TotalNs = 0;
+        for (uint64_t Ns : ThreadNs)
+        {
+            TotalNs += Ns;
+        }
+        return static_cast<double>(TotalNs) / (static_cast<double>(ThreadCount) * BURST_SIZE * BURST_COUNT);
+    }
+
+    // 不停顿地连续写入，记录每次调用的耗时分布
+    template <typename FuncType>
+    void RunStream(const char* Label, FCountingLogSink& Counter, FuncType&& LogFunc)
+    {
+        std::vector<uint64_t> Timestamps(STREAM_COUNT + 1);
+        for (uint32_t i = 0; i < STREAM_COUNT; i++)
+        {
+            Timestamps[i] = Utils::GetTimeNs();
+            LogFunc(i / BURST_SIZE, i);
+        }
+        Timestamps[STREAM_COUNT] = Utils::GetTimeNs();
+
+        FLogger::Get().Flush();
+
+        std::vector<uint64_t> CallNs(STREAM_COUNT);
+        for (uint32_t i = 0; i < STREAM_COUNT; i++)
+        {
+            CallNs[i] = Timestamps[i + 1] - Timestamps[i];
+        }
+        const double MeanNs = static_cast<double>(Timestamps[STREAM_COUNT] - Timestamps[0]) / STREAM_COUNT;
+        std::nth_element(CallNs.begin(), CallNs.begin() + STREAM_COUNT * 99 / 100, CallNs.end());
+        const uint64_t P99Ns = CallNs[STREAM_COUNT * 99 / 100];
+        const uint64_t MaxNs = *std::max_element(CallNs.begin() + STREAM_COUNT * 99 / 100, CallNs.end());
+
+        std::cout << "stream " << std::setw(7) << Label << ": " << std::setw(8) << MeanNs << " ns/msg | p99 "
+            << std::setw(6) << P99Ns << " ns | max " << std::setw(9) << MaxNs / 1000.0 << " us | delivered "
+            << Counter.Delivered.load() << ", dropped " << Counter.Dropped.load() << " of " << STREAM_COUNT << std::endl;
+        Counter.Reset();
+    }
+}
+
+void RunLogBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(1);
+
+    FLogger& Logger = FLogger::Get();
+    Logger.Flush();
+    std::vector<std::unique_ptr<FLogSink>> SavedSinks = Logger.TakeSinks();
+    auto CounterSink = std::make_unique<FCountingLogSink>();
+    FCountingLogSink& Counter = *CounterSink;
+    Logger.AddSink(std::move(CounterSink));
+
+    std::cout << "snprintf baseline (sync format, no IO): " << MeasureSnprintfNs() << " ns/msg" << std::endl;
+
+    // 各线程写各自的环，调用线程之间没有共享写入，ns/条应基本不随线程数变化
+    const uint32_t MaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t ThreadCount = 1; ; ThreadCount = std::min(ThreadCount * 2, MaxThreads))
+    {
+        const double Ns = MeasureBurstNs(ThreadCount);
+        std::cout << "burst x" << BURST_SIZE << ", " << std::setw(3) << ThreadCount << " threads: " << std::setw(6) << Ns
+            << " ns/msg | delivered " << Counter.Delivered.load() << ", dropped " << Counter.Dropped.load() << std::endl;
+        Counter.Reset();
+
+        if (ThreadCount == MaxThreads)
+        {
+            break;
+        }
+    }
+
+    // 环写满后：Info 丢弃并计数 (调用仍是常数时间)，Error 自旋等待后台线程腾出空间
+    RunStream("info", Counter, [](uint32_t Frame, uint32_t Index) { LogSample(Frame, Index); });
+    RunStream("error", Counter, [](uint32_t Frame, uint32_t Index) { LogSampleError(Frame, Index); });
+
+    Logger.Flush();
+    Logger.TakeSinks();
+    for (std::unique_ptr<FLogSink>& Sink : SavedSinks)
+    {
+        Logger.AddSink(std::move(Sink));
+    }
+
+    std::cout << std::defaultfloat;
+}
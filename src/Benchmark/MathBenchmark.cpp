@@ -0,0 +1,105 @@
+﻿#include "Benchmark.h"
+#include "MathSimd.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 5;
+    // 每轮的元素数：SoA 数组合计约 16 MB，超出 L2，接近剔除一个大场景时的内存访问模式
+    constexpr uint32_t ELEMENT_COUNT = 1'000'000;
+    constexpr uint32_t MATRIX_COUNT = 250'000;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+
+    // 确定性的伪随机数 [-Range, Range)，各次运行输入一致
+    float Hash(uint32_t Index, float Range)
+    {
+        const uint32_t Bits = Index * 2654435761u;
+        return (static_cast<float>(Bits >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f) * Range;
+    }
+
+    // 逐路径测量，输出耗时、每元素纳秒数与相对标量的加速比
+    template <typename FuncType>
+    void RunComparison(const char* Name, uint32_t Count, FuncType&& Func)
+    {
+        std::cout << std::left << std::setw(18) << Name << std::right;
+        double ScalarMs = 0.0;
+        for (MathSimd::EPath Path : { MathSimd::EPath::Scalar, MathSimd::EPath::SSE, MathSimd::EPath::AVX2 })
+        {
+            if (!MathSimd::IsPathSupported(Path))
+            {
+                std::cout << " | " << MathSimd::GetPathName(Path) << " unsupported";
+                continue;
+            }
+
+            const double Ms = MeasureBestMs([&]() { Func(Path); });
+            ScalarMs = Path == MathSimd::EPath::Scalar ? Ms : ScalarMs;
+            std::cout << " | " << MathSimd::GetPathName(Path) << " " << std::setw(7) << Ms << " ms ("
+                << Ms * 1'000'000.0 / Count << " ns, x" << ScalarMs / Ms << ")";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void RunMathBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "best path: " << MathSimd::GetPathName(MathSimd::GetBestPath()) << std::endl;
+
+    std::vector<float> X(ELEMENT_COUNT), Y(ELEMENT_COUNT), Z(ELEMENT_COUNT), Radius(ELEMENT_COUNT);
+    for (uint32_t i = 0; i < ELEMENT_COUNT; i++)
+    {
+        X[i] = Hash(i * 4 + 0, 100.0f);
+        Y[i] = Hash(i * 4 + 1, 100.0f);
+        Z[i] = Hash(i * 4 + 2, 100.0f);
+        Radius[i] = std::abs(Hash(i * 4 + 3, 2.0f));
+    }
+    std::vector<float> OutX(ELEMENT_COUNT), OutY(ELEMENT_COUNT), OutZ(ELEMENT_COUNT), OutRadius(ELEMENT_COUNT);
+    std::vector<uint8_t> Visible(ELEMENT_COUNT);
+
+    const FMatrix4 Transform = FMatrix4::TranslationRotationScale({ 1.0f, 2.0f, 3.0f },
+        FQuat::FromAxisAngle(FVector3(1.0f, 1.0f, 0.0f).GetNormalized(), 0.7f), { 2.0f, 1.0f, 0.5f });
+    const FMatrix4 ViewProjection = FMatrix4::Perspective(PI / 3.0f, 16.0f / 9.0f, 0.1f, 1000.0f) *
+        FMatrix4::LookAt({ 0.0f, 0.0f, 150.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+    const FFrustum Frustum = FFrustum::FromViewProjection(ViewProjection);
+
+    uint32_t VisibleCount = 0;
+    RunComparison("transform points", ELEMENT_COUNT, [&](MathSimd::EPath Path)
+        {
+            MathSimd::TransformPoints(Transform, X.data(), Y.data(), Z.data(), OutX.data(), OutY.data(), OutZ.data(), ELEMENT_COUNT, Path);
+        });
+    RunComparison("transform spheres", ELEMENT_COUNT, [&](MathSimd::EPath Path)
+        {
+            MathSimd::TransformSpheres(Transform, X.data(), Y.data(), Z.data(), Radius.data(),
+                OutX.data(), OutY.data(), OutZ.data(), OutRadius.data(), ELEMENT_COUNT, Path);
+        });
+    RunComparison("frustum spheres", ELEMENT_COUNT, [&](MathSimd::EPath Path)
+        {
+            VisibleCount = MathSimd::TestSpheres(Frustum, X.data(), Y.data(), Z.data(), Radius.data(), Visible.data(), ELEMENT_COUNT, Path);
+        });
+    std::cout << "  visible " << VisibleCount << " / " << ELEMENT_COUNT << std::endl;
+
+    std::vector<FMatrix4> Locals(MATRIX_COUNT), Worlds(MATRIX_COUNT);
+    for (uint32_t i = 0; i < MATRIX_COUNT; i++)
+    {
+        Locals[i] = FMatrix4::TranslationRotationScale({ Hash(i * 3, 50.0f), Hash(i * 3 + 1, 50.0f), Hash(i * 3 + 2, 50.0f) },
+            FQuat::FromAxisAngle({ 0.0f, 0.0f, 1.0f }, Hash(i, PI)), { 1.0f, 1.0f, 1.0f });
+    }
+    RunComparison("multiply matrices", MATRIX_COUNT, [&](MathSimd::EPath Path)
+        {
+            MathSimd::MultiplyMatrices(Transform, Locals.data(), Worlds.data(), MATRIX_COUNT, Path);
+        });
+
+    std::cout << std::defaultfloat;
+}
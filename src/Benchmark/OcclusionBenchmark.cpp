@@ -0,0 +1,89 @@
+﻿#include "Benchmark.h"
+#include "Scene.h"
+#include "FramePacket.h"
+#include "InstanceCulling.h"
+#include "OcclusionRasterizer.h"
+#include "JobSystem.h"
+#include <iomanip>
+
+namespace {
+    constexpr uint32_t REPEAT_COUNT = 10;
+    // 演示场景放大到 512x512 的阵列 (4096 个遮挡体)，投影同 RenderPrep
+    constexpr uint32_t INSTANCE_COUNT = 512 * 512;
+    // 相机俯视阵列中心：场景自己的相机距离随阵列变大，遮挡体在屏幕上会小于一个子块
+    constexpr float CAMERA_HEIGHT = 80.0f;
+    constexpr uint32_t VIEWPORT_WIDTH = 1920;
+    constexpr uint32_t VIEWPORT_HEIGHT = 1080;
+
+    template <typename FuncType>
+    double MeasureBestMs(FuncType&& Func)
+    {
+        double BestMs = 1e30;
+        for (uint32_t i = 0; i < REPEAT_COUNT; i++)
+        {
+            const uint64_t BeginNs = Utils::GetTimeNs();
+            Func();
+            const uint64_t EndNs = Utils::GetTimeNs();
+            BestMs = std::min(BestMs, static_cast<double>(EndNs - BeginNs) / 1'000'000.0);
+        }
+        return BestMs;
+    }
+}
+
+void RunOcclusionBenchmark()
+{
+    std::cout << std::fixed << std::setprecision(3);
+
+    FJobSystem Jobs;
+    FScene Scene(INSTANCE_COUNT);
+    FFramePacket Packet;
+    Packet.Arena.Initialize(FRAME_ARENA_CAPACITY, false);
+    Scene.Update(1.0f, Jobs);
+    Scene.Snapshot(Packet, Jobs);
+
+    Packet.View = FMatrix4::LookAt({ 0.0f, 0.0f, CAMERA_HEIGHT }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+    Packet.ViewProjection = FMatrix4::Perspective(PI / 3.0f, static_cast<float>(VIEWPORT_WIDTH) / VIEWPORT_HEIGHT, 0.1f, 1000.0f) * Packet.View;
+    const FFrustum Frustum = FFrustum::FromViewProjection(Packet.ViewProjection);
+    const FSphereArrays Spheres = { Packet.BoundsX.data(), Packet.BoundsY.data(), Packet.BoundsZ.data(), Packet.BoundsRadius.data(), INSTANCE_COUNT };
+    const uint32_t TriangleCount = static_cast<uint32_t>(Packet.OccluderVertices.size() / 3);
+
+    // 暂存来自另一个池，每次测量后归零，不影响帧包里的快照
+    FFrameArena Scratch;
+    Scratch.Initialize(FRAME_ARENA_CAPACITY, false);
+    FOcclusionRasterizer Rasterizer;
+
+    uint32_t FrustumVisible = 0;
+    const double FrustumMs = MeasureBestMs([&]()
+        {
+            TFrameVector<uint32_t> Visible(Scratch.GetResource());
+            FrustumVisible = InstanceCulling::CullSpheres(Frustum, Spheres, Jobs, Scratch, Visible);
+            Visible = TFrameVector<uint32_t>(Scratch.GetResource());
+            Scratch.Reset();
+        });
+
+    const double RasterMs = MeasureBestMs([&]()
+        {
+            Rasterizer.BeginFrame(Packet.ViewProjection, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+            Rasterizer.RenderTriangles(Packet.OccluderVertices.data(), TriangleCount, Jobs, Scratch);
+            Scratch.Reset();
+        });
+
+    uint32_t OccludedCount = 0;
+    const double TestMs = MeasureBestMs([&]()
+        {
+            TFrameVector<uint32_t> Visible(Scratch.GetResource());
+            InstanceCulling::CullSpheres(Frustum, Spheres, Jobs, Scratch, Visible);
+            OccludedCount = Rasterizer.RemoveOccluded(Spheres, Jobs, Scratch, Visible);
+            Visible = TFrameVector<uint32_t>(Scratch.GetResource());
+            Scratch.Reset();
+        }) - FrustumMs;
+
+    std::cout << std::left << std::setw(18) << "frustum culling" << std::right << " | " << std::setw(8) << FrustumMs << " ms | "
+        << FrustumVisible << " / " << INSTANCE_COUNT << " visible" << std::endl;
+    std::cout << std::left << std::setw(18) << "rasterize" << std::right << " | " << std::setw(8) << RasterMs << " ms | "
+        << TriangleCount << " occluder triangles into " << Rasterizer.GetWidth() << "x" << Rasterizer.GetHeight() << std::endl;
+    std::cout << std::left << std::setw(18) << "occlusion test" << std::right << " | " << std::setw(8) << TestMs << " ms | "
+        << OccludedCount << " of " << FrustumVisible << " occluded (" << 100.0 * OccludedCount / std::max(FrustumVisible, 1u) << "%), "
+        << Jobs.GetWorkerCount() + 1 << " threads" << std::endl;
+    std::cout << std::defaultfloat;
+}
@@ -2,6 +2,7 @@
 
 // 1. 标准库 (这些东西几乎每个文件都要用，且编译极慢，放这里加速)
 #include <vector>
+#include <array>
 #include <string>
 #include <memory>
 #include <set>
@@ -20,4 +21,5 @@
 #include "Config.h"
 #include "Macro.h" 
 #include "VulkanHandle.h"
-#include "Utils.h"
\ No newline at end of file
+#include "Utils.h"
+#include "Log.h"
\ No newline at end of file
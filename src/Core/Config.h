@@ -18,9 +18,28 @@ constexpr uint32_t APP_VERSION = VK_MAKE_VERSION(2, 5, 0);
 constexpr const char* ENGINE_NAME = "Cinder Engine";
 constexpr uint32_t ENGINE_VERSION = VK_MAKE_VERSION(16, 0, 0);
 
+// Core Config
+// 多线程共享数据按缓存行对齐，避免伪共享
+constexpr size_t CACHE_LINE_SIZE = 64;
+// 每个帧包的帧内存池容量，超出部分退回堆分配 (见 [FramePipeline] 统计中的 overflow)
+constexpr size_t FRAME_ARENA_CAPACITY = 16 * 1024 * 1024;
+// 日志除 stderr 外同时写入该文件 (空串表示不写文件)
+constexpr const char* LOG_FILE_PATH = "Cinder.log";
+
 // RHI Config
 const int MAX_FRAMES_IN_FLIGHT = 2;
 
+// Renderer Config
+// 演示场景默认实例数 (可用 --instances=N 覆盖)
+constexpr uint32_t SCENE_DEFAULT_INSTANCE_COUNT = 1024;
+// 演示场景默认动态点光源数 (可用 --lights=N 覆盖，0 关闭分簇光照)
+constexpr uint32_t SCENE_DEFAULT_LIGHT_COUNT = 256;
+
+// Profiler Config
+// CPU/GPU 统一时间线 (Timestamp Query + Calibrated Timestamps)，退出时导出 Chrome Trace
+constexpr bool bEnableTimelineProfiler = true;
+constexpr const char* TIMELINE_EXPORT_PATH = "CinderTimeline.json";
+
 const int WINDOW_DEFAULT_WIDTH = 800;
 const int WINDOW_DEFAULT_HEIGHT = 600;
 
@@ -35,6 +54,13 @@ enum class RHIFormat {
     B8G8R8A8_UNORM,
 };
 
+enum class RHIPresentMode {
+    Immediate,   // 不等垂直同步，可能撕裂，用于基准测试 (吞吐上限)
+    Mailbox,     // 三缓冲，低延迟无撕裂
+    Fifo,        // 垂直同步，规范保证一定支持
+    FifoRelaxed, // 垂直同步，但掉帧时立即呈现 (展台/Kiosk)
+};
+
 struct RHIExtent2D {
     uint32_t width;
     uint32_t height;
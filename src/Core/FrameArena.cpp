@@ -0,0 +1,248 @@
+﻿#include "FrameArena.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+    // 池内偏移保持缓存行对齐：线程块之间不会伪共享
+    constexpr size_t ARENA_ALIGNMENT = CACHE_LINE_SIZE;
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    // 每个线程同时缓存块的池数量 (帧流水线中相邻几帧的帧包会同时活跃)
+    constexpr uint32_t THREAD_CACHE_SLOTS = 4;
+
+    struct FThreadChunk
+    {
+        uint64_t Generation = 0;
+        uint8_t* Cursor = nullptr;
+        uint8_t* End = nullptr;
+    };
+
+    thread_local FThreadChunk tChunks[THREAD_CACHE_SLOTS];
+    thread_local uint32_t tNextChunkSlot = 0;
+
+    std::atomic<uint64_t> GNextGeneration = 1;
+
+    constexpr size_t AlignUp(size_t Value, size_t Alignment)
+    {
+        return (Value + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    uint8_t* AlignPointer(uint8_t* Ptr, size_t Alignment)
+    {
+        return reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<uintptr_t>(Ptr), Alignment));
+    }
+
+    // 返回 nullptr 表示大页不可用，由调用方退回普通页
+    void* ReserveHugePages(size_t& InOutSize)
+    {
+#if defined(_WIN32)
+        // 需要 SeLockMemoryPrivilege ("锁定内存页" 用户权限)，否则分配失败
+        const size_t LargePageSize = GetLargePageMinimum();
+        if (LargePageSize == 0)
+        {
+            return nullptr;
+        }
+        const size_t Size = AlignUp(InOutSize, LargePageSize);
+        void* Memory = VirtualAlloc(nullptr, Size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (Memory)
+        {
+            InOutSize = Size;
+        }
+        return Memory;
+#elif defined(__linux__)
+        // 需要预先配置 vm.nr_hugepages
+        const size_t Size = AlignUp(InOutSize, HUGE_PAGE_SIZE);
+        void* Memory = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (Memory == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        InOutSize = Size;
+        return Memory;
+#else
+        (void)InOutSize;
+        return nullptr;
+#endif
+    }
+
+    void* ReservePages(size_t& InOutSize, bool bAdviseHugePages)
+    {
+#if defined(_WIN32)
+        (void)bAdviseHugePages;
+        return VirtualAlloc(nullptr, InOutSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+        InOutSize = AlignUp(InOutSize, HUGE_PAGE_SIZE);
+        void* Memory = mmap(nullptr, InOutSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (Memory == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        if (bAdviseHugePages)
+        {
+            // 透明大页：不保证生效，但不需要系统预留
+            madvise(Memory, InOutSize, MADV_HUGEPAGE);
+        }
+        return Memory;
+#else
+        (void)bAdviseHugePages;
+        return ::operator new(InOutSize, std::align_val_t(ARENA_ALIGNMENT), std::nothrow);
+#endif
+    }
+
+    void FreePages(void* Memory, size_t Size)
+    {
+#if defined(_WIN32)
+        (void)Size;
+        VirtualFree(Memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        munmap(Memory, Size);
+#else
+        (void)Size;
+        ::operator delete(Memory, std::align_val_t(ARENA_ALIGNMENT));
+#endif
+    }
+}
+
+FFrameArena::FFrameArena() : Resource(*this)
+{
+    Generation = GNextGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+FFrameArena::~FFrameArena()
+{
+    Reset();
+    ReleaseMemory();
+}
+
+void FFrameArena::Initialize(size_t InCapacity, bool bUseHugePages)
+{
+    Reset();
+    ReleaseMemory();
+
+    size_t Size = AlignUp(InCapacity, ARENA_ALIGNMENT);
+    void* Memory = bUseHugePages ? ReserveHugePages(Size) : nullptr;
+    bHugePageBacked = Memory != nullptr;
+    if (!Memory)
+    {
+        Size = AlignUp(InCapacity, ARENA_ALIGNMENT);
+        Memory = ReservePages(Size, bUseHugePages);
+    }
+
+    if (!Memory)
+    {
+        throw std::runtime_error("failed to reserve frame arena memory!");
+    }
+
+    Base = static_cast<uint8_t*>(Memory);
+    ReservedSize = Size;
+    Capacity = Size;
+}
+
+void FFrameArena::ReleaseMemory()
+{
+    if (Base)
+    {
+        FreePages(Base, ReservedSize);
+        Base = nullptr;
+    }
+    Capacity = 0;
+    ReservedSize = 0;
+    bHugePageBacked = false;
+}
+
+uint8_t* FFrameArena::Carve(size_t Size)
+{
+    // 先读再加：池已耗尽时不再推高 Offset，GetUsedBytes 依然准确
+    if (Offset.load(std::memory_order_relaxed) + Size > Capacity)
+    {
+        return nullptr;
+    }
+
+    const size_t Begin = Offset.fetch_add(Size, std::memory_order_relaxed);
+    if (Begin + Size > Capacity)
+    {
+        return nullptr;
+    }
+    return Base + Begin;
+}
+
+void* FFrameArena::Allocate(size_t Size, size_t Alignment)
+{
+    Size = std::max<size_t>(Size, 1);
+
+    // 1. 大块直接从池中切，对齐要求超过缓存行时多切一段再对齐
+    if (Size >= LARGE_ALLOCATION_SIZE || Alignment > ARENA_ALIGNMENT)
+    {
+        const size_t Padding = Alignment > ARENA_ALIGNMENT ? Alignment - ARENA_ALIGNMENT : 0;
+        if (uint8_t* Block = Carve(AlignUp(Size + Padding, ARENA_ALIGNMENT)))
+        {
+            return AlignPointer(Block, Alignment);
+        }
+        return AllocateOverflow(Size, Alignment);
+    }
+
+    // 2. 当前线程在该池上的块 (按代号匹配，Reset 之后旧块自然失效)
+    const uint64_t CurrentGeneration = Generation.load(std::memory_order_relaxed);
+    FThreadChunk* Chunk = nullptr;
+    for (FThreadChunk& Candidate : tChunks)
+    {
+        if (Candidate.Generation == CurrentGeneration)
+        {
+            Chunk = &Candidate;
+            break;
+        }
+    }
+
+    if (Chunk)
+    {
+        uint8_t* Ptr = AlignPointer(Chunk->Cursor, Alignment);
+        if (Ptr + Size <= Chunk->End)
+        {
+            Chunk->Cursor = Ptr + Size;
+            return Ptr;
+        }
+    }
+    else
+    {
+        Chunk = &tChunks[tNextChunkSlot++ % THREAD_CACHE_SLOTS];
+    }
+
+    // 3. 领取新块，旧块剩余部分丢弃
+    uint8_t* Block = Carve(CHUNK_SIZE);
+    if (!Block)
+    {
+        Chunk->Generation = 0;
+        return AllocateOverflow(Size, Alignment);
+    }
+
+    Chunk->Generation = CurrentGeneration;
+    Chunk->Cursor = Block + Size;
+    Chunk->End = Block + CHUNK_SIZE;
+    return Block;
+}
+
+void* FFrameArena::AllocateOverflow(size_t Size, size_t Alignment)
+{
+    Alignment = std::max(Alignment, alignof(std::max_align_t));
+    void* Memory = ::operator new(Size, std::align_val_t(Alignment));
+
+    std::lock_guard<std::mutex> Lock(OverflowMutex);
+    OverflowBlocks.emplace_back(Memory, Alignment);
+    OverflowBytes.fetch_add(Size, std::memory_order_relaxed);
+    return Memory;
+}
+
+void FFrameArena::Reset()
+{
+    Generation.store(GNextGeneration.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+    Offset.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> Lock(OverflowMutex);
+    for (const auto& [Memory, Alignment] : OverflowBlocks)
+    {
+        ::operator delete(Memory, std::align_val_t(Alignment));
+    }
+    OverflowBlocks.clear();
+    OverflowBytes.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+#include <atomic>
+#include <mutex>
+#include <memory_resource>
+
+// 帧内存池：一帧之内的临时数据 (实例快照、绘制列表、屏障数组...) 只做指针递增，帧槽回收时整体归零
+// - 每个线程从池中领取 CHUNK_SIZE 大小的块，在块内无锁递增；领取块只需一次 fetch_add
+// - 大块分配 (超过块的 1/4) 直接从池中切出，避免浪费线程块的尾部
+// - 底层内存一次性预留，可选大页 (Linux MAP_HUGETLB / Windows MEM_LARGE_PAGES)，不可用时退回普通页
+// - 池耗尽后退回堆分配并计入溢出量，Reset 时统一释放
+// Reset 要求此刻没有线程在该池上分配 (由帧流水线的帧包交接保证)
+class FFrameArena
+{
+public:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t LARGE_ALLOCATION_SIZE = CHUNK_SIZE / 4;
+
+    FFrameArena();
+    ~FFrameArena();
+
+    FFrameArena(const FFrameArena&) = delete;
+    FFrameArena& operator=(const FFrameArena&) = delete;
+
+    // 预留底层内存；未初始化的池所有分配都走溢出路径
+    void Initialize(size_t InCapacity, bool bUseHugePages);
+
+    // 任意线程可调用
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocateArray(size_t Count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+    }
+
+    // 帧槽回收时调用，之前分配的内存全部失效
+    void Reset();
+
+    // 本帧已领取的字节数 (按线程块粒度统计)，以及池外溢出的字节数
+    size_t GetUsedBytes() const { return std::min(Offset.load(std::memory_order_relaxed), Capacity); }
+    size_t GetOverflowBytes() const { return OverflowBytes.load(std::memory_order_relaxed); }
+    size_t GetCapacity() const { return Capacity; }
+    bool IsHugePageBacked() const { return bHugePageBacked; }
+
+    // 供 std::pmr 容器使用，deallocate 为空操作
+    std::pmr::memory_resource* GetResource() { return &Resource; }
+
+private:
+    class FResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit FResource(FFrameArena& InArena) : Arena(InArena) {}
+
+    private:
+        void* do_allocate(size_t Bytes, size_t Alignment) override { return Arena.Allocate(Bytes, Alignment); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& Other) const noexcept override { return this == &Other; }
+
+        FFrameArena& Arena;
+    };
+
+    // 从池中切出 Size 字节 (已按 ARENA_ALIGNMENT 取整)，池耗尽返回 nullptr
+    uint8_t* Carve(size_t Size);
+    void* AllocateOverflow(size_t Size, size_t Alignment);
+    void ReleaseMemory();
+
+    uint8_t* Base = nullptr;
+    size_t Capacity = 0;
+    size_t ReservedSize = 0;
+    bool bHugePageBacked = false;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> Offset = 0;
+    // 全局唯一，每次 Reset 换新值，使各线程缓存的块失效
+    std::atomic<uint64_t> Generation = 0;
+
+    std::mutex OverflowMutex;
+    std::vector<std::pair<void*, size_t>> OverflowBlocks;
+    std::atomic<size_t> OverflowBytes = 0;
+
+    FResource Resource;
+};
+
+// 分配自帧内存池的容器：随帧包一起复用，帧槽回收时整体丢弃
+template<typename T>
+using TFrameVector = std::pmr::vector<T>;
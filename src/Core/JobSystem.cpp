@@ -0,0 +1,369 @@
+﻿#include "JobSystem.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace {
+    // 每个提交线程独占一个 Job 池，环形复用；槽位仍在执行中时分配失败，由调用方就地执行
+    // 提交线程退出前必须等待自己提交的全部 Job 完成
+    struct FThreadJobPool
+    {
+        std::unique_ptr<FJob[]> Jobs = std::make_unique<FJob[]>(FJobSystem::MAX_JOBS_PER_THREAD);
+        uint32_t Next = 0;
+    };
+
+    thread_local std::unique_ptr<FThreadJobPool> tJobPool;
+    thread_local const FJobSystem* tOwner = nullptr;
+    thread_local uint32_t tWorkerIndex = FJobSystem::ANY_WORKER;
+    thread_local uint32_t tRandomState = 0;
+
+    uint32_t NextRandom()
+    {
+        // xorshift32：只用于挑选窃取对象，分散竞争即可
+        if (tRandomState == 0)
+        {
+            tRandomState = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+        }
+        tRandomState ^= tRandomState << 13;
+        tRandomState ^= tRandomState >> 17;
+        tRandomState ^= tRandomState << 5;
+        return tRandomState;
+    }
+
+    void PinCurrentThread(uint32_t LogicalCore)
+    {
+#if defined(_WIN32)
+        // 超过 64 个逻辑核时需要处理器组，这里只绑定第一组
+        if (LogicalCore < 64)
+        {
+            SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << LogicalCore);
+        }
+#elif defined(__linux__)
+        cpu_set_t CpuSet;
+        CPU_ZERO(&CpuSet);
+        CPU_SET(LogicalCore, &CpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(CpuSet), &CpuSet);
+#else
+        (void)LogicalCore;
+#endif
+    }
+}
+
+void FJobSystem::FLockedJobQueue::Push(FJob* InJob)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Jobs.push_back(InJob);
+    Size.fetch_add(1, std::memory_order_release);
+}
+
+bool FJobSystem::FLockedJobQueue::TryPop(FJob*& OutJob)
+{
+    if (IsEmpty())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (Jobs.empty())
+    {
+        return false;
+    }
+
+    OutJob = Jobs.front();
+    Jobs.pop_front();
+    Size.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+FJobSystem::FJobSystem(uint32_t NumWorkers, bool bPinThreads)
+{
+    const uint32_t HardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (NumWorkers == 0)
+    {
+        NumWorkers = std::max(HardwareThreads - 1, 1u);
+    }
+
+    // 先全部创建再启动线程，Worker 启动后就可能去窃取其它 Worker 的队列
+    Workers.reserve(NumWorkers);
+    for (uint32_t i = 0; i < NumWorkers; i++)
+    {
+        Workers.push_back(std::make_unique<FWorker>());
+    }
+
+    for (uint32_t i = 0; i < NumWorkers; i++)
+    {
+        Workers[i]->Thread = std::thread(&FJobSystem::WorkerMain, this, i, bPinThreads);
+    }
+
+    CA_LOG_INFO("JobSystem", "Started {} workers ({} hardware threads{}).", NumWorkers, HardwareThreads, bPinThreads ? ", pinned" : "");
+}
+
+FJobSystem::~FJobSystem()
+{
+    bStopRequested.store(true, std::memory_order_seq_cst);
+    WakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    WakeEpoch.notify_all();
+
+    for (std::unique_ptr<FWorker>& Worker : Workers)
+    {
+        if (Worker->Thread.joinable())
+        {
+            Worker->Thread.join();
+        }
+    }
+}
+
+uint32_t FJobSystem::GetCurrentWorkerIndex() const
+{
+    return tOwner == this ? tWorkerIndex : ANY_WORKER;
+}
+
+int64_t FJobSystem::GetLocalQueueDepth() const
+{
+    const uint32_t Index = GetCurrentWorkerIndex();
+    // 非 Worker 线程没有本地队列，不做惰性拆分，交给初始切分和 Worker 处理
+    return Index == ANY_WORKER ? SPLIT_QUEUE_DEPTH : Workers[Index]->Queue.Size();
+}
+
+FJob* FJobSystem::AllocateJob()
+{
+    if (!tJobPool)
+    {
+        tJobPool = std::make_unique<FThreadJobPool>();
+    }
+
+    FJob& Job = tJobPool->Jobs[tJobPool->Next & (MAX_JOBS_PER_THREAD - 1)];
+    if (Job.bInUse.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    tJobPool->Next++;
+    Job.bInUse.store(true, std::memory_order_relaxed);
+    return &Job;
+}
+
+void FJobSystem::Submit(FJob* InJob, uint32_t AffinityHint)
+{
+    if (AffinityHint != ANY_WORKER && AffinityHint < Workers.size())
+    {
+        // 只唤醒一个可能叫不醒目标 Worker，全部唤醒让它尽快取走
+        Workers[AffinityHint]->Mailbox.Push(InJob);
+        WakeWorkers(true);
+        return;
+    }
+
+    const uint32_t Index = GetCurrentWorkerIndex();
+    if (Index == ANY_WORKER)
+    {
+        GlobalQueue.Push(InJob);
+    }
+    else if (!Workers[Index]->Queue.Push(InJob))
+    {
+        // 本地队列已满，说明并行度早已饱和，就地执行
+        Execute(InJob);
+        return;
+    }
+
+    WakeWorkers();
+}
+
+void FJobSystem::Execute(FJob* InJob)
+{
+    InJob->Entry(InJob->Payload);
+
+    FJobCounter* Counter = InJob->Counter;
+    InJob->bInUse.store(false, std::memory_order_release);
+
+    if (Counter)
+    {
+        // 先登记收尾，再减计数：Wait 看到计数归零后还要等收尾结束才返回
+        Counter->FinishingCount.fetch_add(1, std::memory_order_seq_cst);
+        if (Counter->Count.fetch_sub(1, std::memory_order_seq_cst) == 1)
+        {
+            ReleaseContinuations(*Counter);
+        }
+        Counter->FinishingCount.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void FJobSystem::AddContinuation(FJobCounter& Dependency, FJob* InJob)
+{
+    FJob* Head = Dependency.Continuations.load(std::memory_order_relaxed);
+    do
+    {
+        InJob->NextContinuation = Head;
+    } while (!Dependency.Continuations.compare_exchange_weak(Head, InJob, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+    // 挂入期间依赖可能已经归零，而归零的线程没有看到这个 Job：由自己提交
+    if (Dependency.Count.load(std::memory_order_seq_cst) == 0)
+    {
+        ReleaseContinuations(Dependency);
+    }
+}
+
+void FJobSystem::ReleaseContinuations(FJobCounter& Counter)
+{
+    // exchange 保证每个后续 Job 只被一个线程取走
+    FJob* Job = Counter.Continuations.exchange(nullptr, std::memory_order_acq_rel);
+    while (Job)
+    {
+        FJob* Next = Job->NextContinuation;
+        Submit(Job, ANY_WORKER);
+        Job = Next;
+    }
+}
+
+void FJobSystem::Wait(const FJobCounter& Counter)
+{
+    uint32_t IdleCount = 0;
+    while (Counter.Count.load(std::memory_order_acquire) != 0 ||
+        Counter.FinishingCount.load(std::memory_order_acquire) != 0)
+    {
+        if (TryRunOneJob())
+        {
+            IdleCount = 0;
+        }
+        else if (++IdleCount > IDLE_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool FJobSystem::TryRunOneJob()
+{
+    FJob* Job = nullptr;
+    if (!FindJob(Job, true))
+    {
+        return false;
+    }
+
+    Execute(Job);
+    return true;
+}
+
+bool FJobSystem::FindJob(FJob*& OutJob, bool bIncludeMailboxes)
+{
+    const uint32_t Self = GetCurrentWorkerIndex();
+    if (Self != ANY_WORKER)
+    {
+        if (Workers[Self]->Queue.Pop(OutJob) || Workers[Self]->Mailbox.TryPop(OutJob))
+        {
+            return true;
+        }
+    }
+
+    if (GlobalQueue.TryPop(OutJob))
+    {
+        return true;
+    }
+
+    // 随机起点轮询受害者，几十个核同时窃取时避免都挤在同一个队列上
+    const uint32_t NumWorkers = GetWorkerCount();
+    const uint32_t Start = NextRandom() % NumWorkers;
+    for (uint32_t i = 0; i < NumWorkers; i++)
+    {
+        const uint32_t Victim = (Start + i) % NumWorkers;
+        if (Victim != Self && Workers[Victim]->Queue.Steal(OutJob))
+        {
+            return true;
+        }
+    }
+
+    if (bIncludeMailboxes)
+    {
+        for (uint32_t i = 0; i < NumWorkers; i++)
+        {
+            const uint32_t Victim = (Start + i) % NumWorkers;
+            if (Victim != Self && Workers[Victim]->Mailbox.TryPop(OutJob))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool FJobSystem::HasPendingWork() const
+{
+    if (!GlobalQueue.IsEmpty())
+    {
+        return true;
+    }
+
+    for (const std::unique_ptr<FWorker>& Worker : Workers)
+    {
+        if (Worker->Queue.Size() > 0 || !Worker->Mailbox.IsEmpty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FJobSystem::WakeWorkers(bool bWakeAll)
+{
+    // 与 WorkerMain 中 "登记睡眠 -> 复查队列" 配对，保证入队与睡眠不会互相错过
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (SleepingCount.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    WakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (bWakeAll)
+    {
+        WakeEpoch.notify_all();
+    }
+    else
+    {
+        WakeEpoch.notify_one();
+    }
+}
+
+void FJobSystem::WorkerMain(uint32_t WorkerIndex, bool bPinThread)
+{
+    tOwner = this;
+    tWorkerIndex = WorkerIndex;
+    tRandomState = (WorkerIndex + 1) * 0x9E3779B9u;
+
+    if (bPinThread)
+    {
+        // 逻辑核 0 留给应用线程
+        PinCurrentThread((WorkerIndex + 1) % std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    uint32_t IdleCount = 0;
+    while (!bStopRequested.load(std::memory_order_relaxed))
+    {
+        // 自旋阶段只在最后一轮才去拿其它 Worker 邮箱里的 Job
+        FJob* Job = nullptr;
+        if (FindJob(Job, IdleCount >= IDLE_SPIN_COUNT))
+        {
+            Execute(Job);
+            IdleCount = 0;
+            continue;
+        }
+
+        if (++IdleCount <= IDLE_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const uint32_t Epoch = WakeEpoch.load(std::memory_order_seq_cst);
+        SleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        if (!HasPendingWork() && !bStopRequested.load(std::memory_order_seq_cst))
+        {
+            WakeEpoch.wait(Epoch, std::memory_order_seq_cst);
+        }
+        SleepingCount.fetch_sub(1, std::memory_order_seq_cst);
+        IdleCount = 0;
+    }
+
+    tOwner = nullptr;
+    tWorkerIndex = ANY_WORKER;
+}
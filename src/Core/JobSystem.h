@@ -0,0 +1,238 @@
+﻿#pragma once
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include "WorkStealingDeque.h"
+
+class FJobSystem;
+
+// 单个 Job：函数对象直接构造在内联 Payload 中，调度路径上没有堆分配
+struct FJob
+{
+    static constexpr size_t PAYLOAD_SIZE = 64;
+    using FEntry = void(*)(void* Payload);
+
+    FEntry Entry = nullptr;
+    class FJobCounter* Counter = nullptr;
+    FJob* NextContinuation = nullptr;
+    std::atomic<bool> bInUse = false;
+    alignas(16) std::byte Payload[PAYLOAD_SIZE];
+};
+
+// Job 计数器：每调度一个关联 Job 加一，Job 完成时减一，归零即表示这一组 Job 全部完成
+// 同时作为依赖：ScheduleAfter 的 Job 挂在计数器上，归零时由最后完成的线程统一提交
+// 计数器在 Wait 返回之前不得销毁或复用
+class FJobCounter
+{
+public:
+    FJobCounter() = default;
+
+    FJobCounter(const FJobCounter&) = delete;
+    FJobCounter& operator=(const FJobCounter&) = delete;
+
+    bool IsDone() const { return Count.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class FJobSystem;
+
+    std::atomic<uint32_t> Count = 0;
+    // 正在执行收尾 (减计数、提交后续 Job) 的线程数，Wait 需要等它归零才能让调用方销毁计数器
+    std::atomic<uint32_t> FinishingCount = 0;
+    std::atomic<FJob*> Continuations = nullptr;
+};
+
+// 工作窃取任务调度器
+// - 每个 Worker 一个 Chase-Lev 队列：本地 LIFO 执行，空闲时随机选择受害者从另一端窃取
+// - 非 Worker 线程 (应用/渲染线程) 提交到全局注入队列，Wait 时同样参与执行
+// - 亲和性提示：指定 Worker 的 Job 进入其邮箱，仅当所有队列都空时才会被其它线程取走
+// - ParallelFor 使用惰性二分拆分 (Lazy Binary Splitting)：只有本地队列快空时才继续拆分，
+//   粒度随负载自适应，负载均衡时退化为顺序执行
+class FJobSystem
+{
+public:
+    // 每线程 Job 池与本地队列容量，超出时就地执行
+    static constexpr uint32_t MAX_JOBS_PER_THREAD = 4096;
+    // 本地队列长度低于此值时 ParallelFor 才继续拆分
+    static constexpr int64_t SPLIT_QUEUE_DEPTH = 2;
+    // 进入睡眠前的自旋轮数
+    static constexpr uint32_t IDLE_SPIN_COUNT = 64;
+    static constexpr uint32_t ANY_WORKER = ~0u;
+
+    // NumWorkers 为 0 时使用 (硬件线程数 - 1)，调用线程也会在 Wait 中参与执行
+    // bPinThreads 将 Worker i 绑定到逻辑核 i + 1
+    explicit FJobSystem(uint32_t NumWorkers = 0, bool bPinThreads = false);
+    ~FJobSystem();
+
+    FJobSystem(const FJobSystem&) = delete;
+    FJobSystem& operator=(const FJobSystem&) = delete;
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(Workers.size()); }
+    // 当前线程在本调度器中的 Worker 序号，非 Worker 线程返回 ANY_WORKER
+    uint32_t GetCurrentWorkerIndex() const;
+
+    template <typename FuncType>
+    void Schedule(FuncType&& Func, FJobCounter* Counter = nullptr, uint32_t AffinityHint = ANY_WORKER)
+    {
+        FJob* Job = CreateJob(std::forward<FuncType>(Func), Counter);
+        if (!Job)
+        {
+            return;
+        }
+        Submit(Job, AffinityHint);
+    }
+
+    // Dependency 归零后才开始执行
+    template <typename FuncType>
+    void ScheduleAfter(FJobCounter& Dependency, FuncType&& Func, FJobCounter* Counter = nullptr)
+    {
+        if (Dependency.IsDone())
+        {
+            Schedule(std::forward<FuncType>(Func), Counter);
+            return;
+        }
+
+        FJob* Job = CreateJob(std::forward<FuncType>(Func), Counter, &Dependency);
+        if (!Job)
+        {
+            return;
+        }
+        AddContinuation(Dependency, Job);
+    }
+
+    // 等待计数器归零，期间执行其它 Job 而不是阻塞
+    void Wait(const FJobCounter& Counter);
+
+    // Func(uint32_t Begin, uint32_t End) 处理 [Begin, End)，返回时全部完成
+    template <typename FuncType>
+    void ParallelFor(uint32_t Count, FuncType&& Func, uint32_t MinGrainSize = 1)
+    {
+        if (Count == 0)
+        {
+            return;
+        }
+
+        const uint32_t Grain = std::max(MinGrainSize, 1u);
+        FJobCounter Counter;
+
+        // 初始切成 (Worker 数 + 1) 份让所有线程立即有活干，之后由各 Worker 惰性拆分
+        const uint32_t MaxPieces = (Count + Grain - 1) / Grain;
+        const uint32_t Pieces = std::min(GetWorkerCount() + 1, MaxPieces);
+        const uint32_t PieceSize = Count / Pieces;
+
+        uint32_t Begin = PieceSize + Count % Pieces;
+        for (uint32_t i = 1; i < Pieces; i++)
+        {
+            const uint32_t End = Begin + PieceSize;
+            Schedule([this, &Func, Begin, End, Grain, &Counter]()
+                {
+                    ParallelForRange(Func, Begin, End, Grain, Counter);
+                }, &Counter);
+            Begin = End;
+        }
+
+        ParallelForRange(Func, 0, PieceSize + Count % Pieces, Grain, Counter);
+        Wait(Counter);
+    }
+
+private:
+    struct FLockedJobQueue
+    {
+        std::mutex Mutex;
+        std::deque<FJob*> Jobs;
+
+        // 无锁快速判空，避免空闲线程争抢互斥量
+        std::atomic<uint32_t> Size = 0;
+
+        void Push(FJob* InJob);
+        bool TryPop(FJob*& OutJob);
+        bool IsEmpty() const { return Size.load(std::memory_order_acquire) == 0; }
+    };
+
+    struct FWorker
+    {
+        TWorkStealingDeque<FJob*, MAX_JOBS_PER_THREAD> Queue;
+        FLockedJobQueue Mailbox;
+        std::thread Thread;
+    };
+
+    template <typename FuncType>
+    FJob* CreateJob(FuncType&& Func, FJobCounter* Counter, FJobCounter* Dependency = nullptr)
+    {
+        using FDecayed = std::decay_t<FuncType>;
+        static_assert(sizeof(FDecayed) <= FJob::PAYLOAD_SIZE, "Job capture too large, capture by pointer instead");
+        static_assert(alignof(FDecayed) <= 16, "Job capture over-aligned");
+
+        FJob* Job = AllocateJob();
+        if (!Job)
+        {
+            // 池耗尽：就地执行，保证语义正确只损失并行度
+            if (Dependency)
+            {
+                Wait(*Dependency);
+            }
+            Func();
+            return nullptr;
+        }
+
+        new (Job->Payload) FDecayed(std::forward<FuncType>(Func));
+        Job->Entry = [](void* Payload)
+            {
+                FDecayed* Callable = static_cast<FDecayed*>(Payload);
+                (*Callable)();
+                Callable->~FDecayed();
+            };
+        Job->Counter = Counter;
+        Job->NextContinuation = nullptr;
+
+        if (Counter)
+        {
+            Counter->Count.fetch_add(1, std::memory_order_relaxed);
+        }
+        return Job;
+    }
+
+    template <typename FuncType>
+    void ParallelForRange(FuncType& Func, uint32_t Begin, uint32_t End, uint32_t Grain, FJobCounter& Counter)
+    {
+        while (Begin < End)
+        {
+            // 本地队列快空了 (任务被偷走或本来就少)：把剩余区间的后半段让出去
+            while (End - Begin > Grain && GetLocalQueueDepth() < SPLIT_QUEUE_DEPTH)
+            {
+                const uint32_t Mid = Begin + (End - Begin) / 2;
+                Schedule([this, &Func, Mid, End, Grain, &Counter]()
+                    {
+                        ParallelForRange(Func, Mid, End, Grain, Counter);
+                    }, &Counter);
+                End = Mid;
+            }
+
+            const uint32_t ChunkEnd = std::min(Begin + Grain, End);
+            Func(Begin, ChunkEnd);
+            Begin = ChunkEnd;
+        }
+    }
+
+    FJob* AllocateJob();
+    void Submit(FJob* InJob, uint32_t AffinityHint);
+    void AddContinuation(FJobCounter& Dependency, FJob* InJob);
+    void ReleaseContinuations(FJobCounter& Counter);
+    void Execute(FJob* InJob);
+
+    bool TryRunOneJob();
+    // bIncludeMailboxes 为 false 时不取其它 Worker 邮箱中的 Job，以尊重亲和性提示
+    bool FindJob(FJob*& OutJob, bool bIncludeMailboxes);
+    bool HasPendingWork() const;
+    void WakeWorkers(bool bWakeAll = false);
+    int64_t GetLocalQueueDepth() const;
+
+    void WorkerMain(uint32_t WorkerIndex, bool bPinThread);
+
+    std::vector<std::unique_ptr<FWorker>> Workers;
+    FLockedJobQueue GlobalQueue;
+
+    std::atomic<bool> bStopRequested = false;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> SleepingCount = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> WakeEpoch = 0;
+};
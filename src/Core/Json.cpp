@@ -0,0 +1,282 @@
+﻿#include "Json.h"
+#include <charconv>
+
+namespace {
+    // 防止恶意输入的深层嵌套耗尽栈
+    constexpr uint32_t MAX_NESTING_DEPTH = 256;
+
+    void AppendUtf8(std::string& Out, uint32_t CodePoint)
+    {
+        if (CodePoint < 0x80)
+        {
+            Out.push_back(static_cast<char>(CodePoint));
+        }
+        else if (CodePoint < 0x800)
+        {
+            Out.push_back(static_cast<char>(0xC0 | (CodePoint >> 6)));
+            Out.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+        }
+        else if (CodePoint < 0x10000)
+        {
+            Out.push_back(static_cast<char>(0xE0 | (CodePoint >> 12)));
+            Out.push_back(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)));
+            Out.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+        }
+        else
+        {
+            Out.push_back(static_cast<char>(0xF0 | (CodePoint >> 18)));
+            Out.push_back(static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F)));
+            Out.push_back(static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)));
+            Out.push_back(static_cast<char>(0x80 | (CodePoint & 0x3F)));
+        }
+    }
+}
+
+class FJsonValue::FParser
+{
+public:
+    explicit FParser(std::string_view InText) : Text(InText) {}
+
+    FJsonValue ParseDocument()
+    {
+        FJsonValue Result = ParseValue(0);
+        SkipWhitespace();
+        if (Position != Text.size())
+        {
+            Fail("unexpected trailing characters");
+        }
+        return Result;
+    }
+
+private:
+    [[noreturn]] void Fail(const char* Message) const
+    {
+        throw std::runtime_error("failed to parse JSON at byte " + std::to_string(Position) + ": " + Message);
+    }
+
+    void SkipWhitespace()
+    {
+        while (Position < Text.size() && (Text[Position] == ' ' || Text[Position] == '\t' || Text[Position] == '\n' || Text[Position] == '\r'))
+        {
+            Position++;
+        }
+    }
+
+    bool Consume(char Expected)
+    {
+        SkipWhitespace();
+        if (Position < Text.size() && Text[Position] == Expected)
+        {
+            Position++;
+            return true;
+        }
+        return false;
+    }
+
+    void Expect(char Expected)
+    {
+        if (!Consume(Expected))
+        {
+            Fail("unexpected character");
+        }
+    }
+
+    bool ConsumeLiteral(std::string_view Literal)
+    {
+        if (Text.substr(Position, Literal.size()) == Literal)
+        {
+            Position += Literal.size();
+            return true;
+        }
+        return false;
+    }
+
+    FJsonValue ParseValue(uint32_t Depth)
+    {
+        if (Depth > MAX_NESTING_DEPTH)
+        {
+            Fail("nesting too deep");
+        }
+
+        SkipWhitespace();
+        if (Position >= Text.size())
+        {
+            Fail("unexpected end of input");
+        }
+
+        FJsonValue Value;
+        const char C = Text[Position];
+        if (C == '{')
+        {
+            Position++;
+            Value.Type = EType::Object;
+            if (Consume('}'))
+            {
+                return Value;
+            }
+            do
+            {
+                SkipWhitespace();
+                if (Position >= Text.size() || Text[Position] != '"')
+                {
+                    Fail("expected object key");
+                }
+                Value.Keys.push_back(ParseString());
+                Expect(':');
+                Value.Values.push_back(ParseValue(Depth + 1));
+            } while (Consume(','));
+            Expect('}');
+        }
+        else if (C == '[')
+        {
+            Position++;
+            Value.Type = EType::Array;
+            if (Consume(']'))
+            {
+                return Value;
+            }
+            do
+            {
+                Value.Values.push_back(ParseValue(Depth + 1));
+            } while (Consume(','));
+            Expect(']');
+        }
+        else if (C == '"')
+        {
+            Value.Type = EType::String;
+            Value.String = ParseString();
+        }
+        else if (ConsumeLiteral("true") || ConsumeLiteral("false"))
+        {
+            Value.Type = EType::Bool;
+            Value.bBool = C == 't';
+        }
+        else if (ConsumeLiteral("null"))
+        {
+            Value.Type = EType::Null;
+        }
+        else
+        {
+            Value.Type = EType::Number;
+            Value.Number = ParseNumber();
+        }
+        return Value;
+    }
+
+    double ParseNumber()
+    {
+        // from_chars 不接受前导 '+'，与 JSON 语法一致
+        double Result = 0.0;
+        const char* Begin = Text.data() + Position;
+        const auto [End, Error] = std::from_chars(Begin, Text.data() + Text.size(), Result);
+        if (Error != std::errc() || End == Begin)
+        {
+            Fail("invalid number");
+        }
+        Position += static_cast<size_t>(End - Begin);
+        return Result;
+    }
+
+    uint32_t ParseHex4()
+    {
+        if (Position + 4 > Text.size())
+        {
+            Fail("truncated unicode escape");
+        }
+        uint32_t Result = 0;
+        const auto [End, Error] = std::from_chars(Text.data() + Position, Text.data() + Position + 4, Result, 16);
+        if (Error != std::errc() || End != Text.data() + Position + 4)
+        {
+            Fail("invalid unicode escape");
+        }
+        Position += 4;
+        return Result;
+    }
+
+    std::string ParseString()
+    {
+        Position++; // 起始引号
+        std::string Result;
+        while (true)
+        {
+            if (Position >= Text.size())
+            {
+                Fail("unterminated string");
+            }
+
+            const char C = Text[Position++];
+            if (C == '"')
+            {
+                return Result;
+            }
+            if (static_cast<unsigned char>(C) < 0x20)
+            {
+                Fail("control character in string");
+            }
+            if (C != '\\')
+            {
+                Result.push_back(C);
+                continue;
+            }
+
+            if (Position >= Text.size())
+            {
+                Fail("unterminated escape");
+            }
+            const char Escape = Text[Position++];
+            switch (Escape)
+            {
+            case '"': Result.push_back('"'); break;
+            case '\\': Result.push_back('\\'); break;
+            case '/': Result.push_back('/'); break;
+            case 'b': Result.push_back('\b'); break;
+            case 'f': Result.push_back('\f'); break;
+            case 'n': Result.push_back('\n'); break;
+            case 'r': Result.push_back('\r'); break;
+            case 't': Result.push_back('\t'); break;
+            case 'u':
+            {
+                uint32_t CodePoint = ParseHex4();
+                // UTF-16 代理对
+                if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && ConsumeLiteral("\\u"))
+                {
+                    const uint32_t Low = ParseHex4();
+                    if (Low < 0xDC00 || Low > 0xDFFF)
+                    {
+                        Fail("invalid surrogate pair");
+                    }
+                    CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+                }
+                AppendUtf8(Result, CodePoint);
+                break;
+            }
+            default:
+                Fail("invalid escape");
+            }
+        }
+    }
+
+    std::string_view Text;
+    size_t Position = 0;
+};
+
+FJsonValue FJsonValue::Parse(std::string_view Text)
+{
+    return FParser(Text).ParseDocument();
+}
+
+const FJsonValue* FJsonValue::Find(std::string_view Key) const
+{
+    if (Type != EType::Object)
+    {
+        return nullptr;
+    }
+    for (size_t i = 0; i < Keys.size(); i++)
+    {
+        if (Keys[i] == Key)
+        {
+            return &Values[i];
+        }
+    }
+    return nullptr;
+}
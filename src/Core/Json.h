@@ -0,0 +1,51 @@
+﻿#pragma once
+
+// 最小 JSON DOM (资源导入用)：按 RFC 8259 解析，数值统一存为 double
+// 对象保持键的原始顺序，查找为线性扫描 (导入格式的对象都很小)
+class FJsonValue
+{
+public:
+    enum class EType : uint8_t
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    // 语法错误时抛出 std::runtime_error (带字节偏移)
+    static FJsonValue Parse(std::string_view Text);
+
+    EType GetType() const { return Type; }
+    bool IsNull() const { return Type == EType::Null; }
+    bool IsNumber() const { return Type == EType::Number; }
+    bool IsString() const { return Type == EType::String; }
+    bool IsArray() const { return Type == EType::Array; }
+    bool IsObject() const { return Type == EType::Object; }
+
+    // 类型不符时返回默认值
+    bool AsBool(bool Default = false) const { return Type == EType::Bool ? bBool : Default; }
+    double AsNumber(double Default = 0.0) const { return Type == EType::Number ? Number : Default; }
+    uint32_t AsUInt(uint32_t Default = 0) const { return Type == EType::Number && Number >= 0.0 ? static_cast<uint32_t>(Number) : Default; }
+    const std::string& AsString() const { return String; }
+
+    // 数组元素或对象值的个数
+    size_t Size() const { return Values.size(); }
+    const FJsonValue& operator[](size_t Index) const { return Values[Index]; }
+    const std::vector<FJsonValue>& GetElements() const { return Values; }
+
+    // 不是对象或键不存在时返回 nullptr
+    const FJsonValue* Find(std::string_view Key) const;
+
+private:
+    class FParser;
+
+    EType Type = EType::Null;
+    bool bBool = false;
+    double Number = 0.0;
+    std::string String;
+    std::vector<FJsonValue> Values;   // 数组元素 / 对象的值
+    std::vector<std::string> Keys;    // 对象的键，与 Values 一一对应
+};
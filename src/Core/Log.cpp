@@ -0,0 +1,468 @@
+﻿#include "Log.h"
+#include <charconv>
+#include <cstdio>
+
+namespace {
+    constexpr size_t RECORD_ALIGNMENT = 8;
+    constexpr size_t HEADER_SIZE = sizeof(LogDetail::FRecordHeader);
+
+    constexpr size_t AlignUp(size_t Value, size_t Alignment)
+    {
+        return (Value + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    const char* LevelName(ELogLevel Level)
+    {
+        switch (Level)
+        {
+        case ELogLevel::Verbose: return "Verbose";
+        case ELogLevel::Info: return "Info";
+        case ELogLevel::Warning: return "Warning";
+        case ELogLevel::Error: return "Error";
+        }
+        return "Unknown";
+    }
+
+    template<typename T>
+    void AppendNumber(std::string& Out, T Value, int Base = 10)
+    {
+        char Buffer[32];
+        const auto Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value, Base);
+        Out.append(Buffer, Result.ptr);
+    }
+
+    void AppendValue(std::string& Out, const FLogValue& Value)
+    {
+        switch (Value.Kind)
+        {
+        case FLogValue::EKind::Signed:
+            AppendNumber(Out, Value.Signed);
+            break;
+        case FLogValue::EKind::Unsigned:
+            AppendNumber(Out, Value.Unsigned);
+            break;
+        case FLogValue::EKind::Float:
+        {
+            char Buffer[64];
+            const auto Result = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value.Float, std::chars_format::general, 6);
+            Out.append(Buffer, Result.ptr);
+            break;
+        }
+        case FLogValue::EKind::Bool:
+            Out += Value.Bool ? "true" : "false";
+            break;
+        case FLogValue::EKind::Char:
+            Out += Value.Char;
+            break;
+        case FLogValue::EKind::Pointer:
+            Out += "0x";
+            AppendNumber(Out, reinterpret_cast<uintptr_t>(Value.Pointer), 16);
+            break;
+        case FLogValue::EKind::String:
+            Out += Value.String;
+            break;
+        }
+    }
+
+    // 后台线程一次排空中取出的一条记录
+    struct FPendingRecord
+    {
+        uint64_t TimestampNs;
+        uint32_t ThreadIndex;
+        const uint8_t* Data;
+    };
+}
+
+// 单生产者 (所属线程) / 单消费者 (后台线程) 的字节环
+// 读写下标单调递增，取模得到偏移；记录连续存放，尾部放不下时写填充记录后回绕
+struct FLogger::FThreadBuffer
+{
+    static constexpr size_t MASK = THREAD_BUFFER_SIZE - 1;
+    static_assert((THREAD_BUFFER_SIZE & MASK) == 0, "THREAD_BUFFER_SIZE must be a power of two");
+
+    // 生产者独占
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> WriteIndex = 0;
+    size_t CachedReadIndex = 0;
+    size_t PendingIndex = 0;
+
+    // 消费者独占
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> ReadIndex = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> DroppedCount = 0;
+    std::atomic<bool> bThreadExited = false;
+    uint32_t ThreadIndex = 0;
+
+    std::unique_ptr<uint8_t[]> Data = std::make_unique<uint8_t[]>(THREAD_BUFFER_SIZE);
+};
+
+FLogger& FLogger::Get()
+{
+    static FLogger Instance;
+    return Instance;
+}
+
+FLogger::FLogger() : StartNs(Utils::GetTimeNs())
+{
+    Sinks.push_back(std::make_unique<FStderrLogSink>());
+    Thread = std::thread(&FLogger::ThreadMain, this);
+}
+
+FLogger::~FLogger()
+{
+    Shutdown();
+}
+
+void FLogger::AddSink(std::unique_ptr<FLogSink> InSink)
+{
+    std::lock_guard<std::mutex> Lock(SinkMutex);
+    Sinks.push_back(std::move(InSink));
+}
+
+std::vector<std::unique_ptr<FLogSink>> FLogger::TakeSinks()
+{
+    std::lock_guard<std::mutex> Lock(SinkMutex);
+    std::vector<std::unique_ptr<FLogSink>> Taken;
+    Taken.swap(Sinks);
+    return Taken;
+}
+
+void FLogger::Flush()
+{
+    if (bShutdown.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    // 正在进行的那一轮可能在调用之前就取过快照，所以要等两轮
+    std::unique_lock<std::mutex> Lock(WakeMutex);
+    const uint64_t Target = DrainedPasses.load(std::memory_order_acquire) + 2;
+    WakeCV.notify_one();
+    FlushedCV.wait(Lock, [&]()
+        {
+            return DrainedPasses.load(std::memory_order_acquire) >= Target || bStopRequested.load(std::memory_order_acquire);
+        });
+}
+
+void FLogger::Shutdown()
+{
+    if (bShutdown.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(WakeMutex);
+        bStopRequested = true;
+    }
+    WakeCV.notify_one();
+    Thread.join();
+
+    std::lock_guard<std::mutex> Lock(SinkMutex);
+    for (const auto& Sink : Sinks)
+    {
+        Sink->Flush();
+    }
+}
+
+FLogger::FThreadBuffer& FLogger::GetThreadBuffer()
+{
+    // 线程退出时只做标记，缓冲由后台线程排空后移除
+    struct FHandle
+    {
+        std::shared_ptr<FThreadBuffer> Buffer;
+        ~FHandle()
+        {
+            if (Buffer)
+            {
+                Buffer->bThreadExited.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local FHandle Handle;
+
+    if (!Handle.Buffer)
+    {
+        auto Buffer = std::make_shared<FThreadBuffer>();
+        std::lock_guard<std::mutex> Lock(RegistryMutex);
+        Buffer->ThreadIndex = NextThreadIndex++;
+        Buffers.push_back(Buffer);
+        Handle.Buffer = std::move(Buffer);
+    }
+    return *Handle.Buffer;
+}
+
+uint8_t* FLogger::BeginRecord(size_t Size, ELogLevel Level)
+{
+    if (bShutdown.load(std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    FThreadBuffer& Buffer = GetThreadBuffer();
+    Size = AlignUp(Size, RECORD_ALIGNMENT);
+    // 单条记录不能超过半个环，否则回绕填充之后可能永远放不下
+    if (Size > THREAD_BUFFER_SIZE / 2)
+    {
+        Buffer.DroppedCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    const size_t Write = Buffer.WriteIndex.load(std::memory_order_relaxed);
+    const size_t Offset = Write & FThreadBuffer::MASK;
+    const size_t TailSpace = THREAD_BUFFER_SIZE - Offset;
+    const size_t Padding = TailSpace < Size ? TailSpace : 0;
+    const size_t Required = Write + Padding + Size;
+
+    if (Required - Buffer.CachedReadIndex > THREAD_BUFFER_SIZE)
+    {
+        Buffer.CachedReadIndex = Buffer.ReadIndex.load(std::memory_order_acquire);
+        while (Required - Buffer.CachedReadIndex > THREAD_BUFFER_SIZE)
+        {
+            // Error 不能丢，唤醒后台线程并等它腾出空间
+            if (Level < ELogLevel::Error || bShutdown.load(std::memory_order_relaxed))
+            {
+                Buffer.DroppedCount.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            WakeCV.notify_one();
+            std::this_thread::yield();
+            Buffer.CachedReadIndex = Buffer.ReadIndex.load(std::memory_order_acquire);
+        }
+    }
+
+    // 尾部剩余不足一个记录头时消费者自行跳过，否则写一条填充记录
+    if (Padding >= HEADER_SIZE)
+    {
+        LogDetail::FRecordHeader PaddingHeader{};
+        PaddingHeader.Size = static_cast<uint32_t>(Padding);
+        PaddingHeader.Site = nullptr;
+        std::memcpy(Buffer.Data.get() + Offset, &PaddingHeader, sizeof(PaddingHeader));
+    }
+
+    Buffer.PendingIndex = Write + Padding;
+    return Buffer.Data.get() + (Buffer.PendingIndex & FThreadBuffer::MASK);
+}
+
+void FLogger::CommitRecord(size_t Size, ELogLevel Level)
+{
+    FThreadBuffer& Buffer = GetThreadBuffer();
+    Buffer.WriteIndex.store(Buffer.PendingIndex + AlignUp(Size, RECORD_ALIGNMENT), std::memory_order_release);
+
+    if (Level >= ELogLevel::Error)
+    {
+        WakeCV.notify_one();
+    }
+}
+
+void FLogger::ThreadMain()
+{
+    while (true)
+    {
+        const size_t Count = DrainOnce();
+
+        {
+            std::lock_guard<std::mutex> Lock(WakeMutex);
+            DrainedPasses.fetch_add(1, std::memory_order_release);
+        }
+        FlushedCV.notify_all();
+
+        std::unique_lock<std::mutex> Lock(WakeMutex);
+        if (bStopRequested)
+        {
+            break;
+        }
+        if (Count == 0)
+        {
+            WakeCV.wait_for(Lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+        }
+    }
+
+    // 停止请求之前写入的记录全部输出
+    DrainOnce();
+    FlushedCV.notify_all();
+}
+
+size_t FLogger::DrainOnce()
+{
+    std::vector<std::shared_ptr<FThreadBuffer>> Snapshot;
+    {
+        std::lock_guard<std::mutex> Lock(RegistryMutex);
+        Snapshot = Buffers;
+    }
+
+    // 1. 收集各线程当前可见的记录 (只读，下标稍后统一推进)
+    std::vector<FPendingRecord> Records;
+    std::vector<size_t> EndIndices(Snapshot.size());
+    for (size_t i = 0; i < Snapshot.size(); i++)
+    {
+        FThreadBuffer& Buffer = *Snapshot[i];
+        size_t Read = Buffer.ReadIndex.load(std::memory_order_relaxed);
+        const size_t Write = Buffer.WriteIndex.load(std::memory_order_acquire);
+
+        while (Read != Write)
+        {
+            const size_t Offset = Read & FThreadBuffer::MASK;
+            const size_t TailSpace = THREAD_BUFFER_SIZE - Offset;
+            if (TailSpace < HEADER_SIZE)
+            {
+                Read += TailSpace;
+                continue;
+            }
+
+            LogDetail::FRecordHeader Header;
+            std::memcpy(&Header, Buffer.Data.get() + Offset, sizeof(Header));
+            if (Header.Site)
+            {
+                Records.push_back({ Header.TimestampNs, Buffer.ThreadIndex, Buffer.Data.get() + Offset });
+            }
+            Read += AlignUp(Header.Size, RECORD_ALIGNMENT);
+        }
+        EndIndices[i] = Write;
+    }
+
+    // 2. 多线程合并为单一时间线
+    std::stable_sort(Records.begin(), Records.end(), [](const FPendingRecord& A, const FPendingRecord& B)
+        {
+            return A.TimestampNs < B.TimestampNs;
+        });
+
+    std::string Line;
+    std::string Message;
+    FLogValue Values[LogDetail::MAX_LOG_ARGS];
+    auto Emit = [&](ELogLevel Level, uint64_t TimestampNs, uint32_t ThreadIndex, const char* Tag)
+        {
+            char Prefix[64];
+            const double Seconds = static_cast<double>(TimestampNs - StartNs) / 1'000'000'000.0;
+            std::snprintf(Prefix, sizeof(Prefix), "[%10.4f][T%u][%s][", Seconds, ThreadIndex, LevelName(Level));
+
+            Line.assign(Prefix);
+            Line += Tag;
+            Line += "] ";
+            Line += Message;
+
+            for (const auto& Sink : Sinks)
+            {
+                Sink->Write(Level, Line);
+            }
+        };
+
+    // 3. 格式化并写出
+    {
+        std::lock_guard<std::mutex> Lock(SinkMutex);
+        for (const FPendingRecord& Record : Records)
+        {
+            LogDetail::FRecordHeader Header;
+            std::memcpy(&Header, Record.Data, sizeof(Header));
+
+            const size_t ValueCount = Header.Decode(Record.Data + sizeof(Header), Values);
+            Message.clear();
+            FormatMessage(Message, Header.Site->Format, std::span<const FLogValue>(Values, ValueCount));
+            Emit(Header.Site->Level, Record.TimestampNs, Record.ThreadIndex, Header.Site->Tag);
+        }
+
+        for (const auto& Buffer : Snapshot)
+        {
+            if (const uint64_t Dropped = Buffer->DroppedCount.exchange(0, std::memory_order_relaxed))
+            {
+                Message.clear();
+                AppendNumber(Message, Dropped);
+                Message += " messages dropped (buffer full)";
+                Emit(ELogLevel::Warning, Utils::GetTimeNs(), Buffer->ThreadIndex, "Log");
+            }
+        }
+
+        if (!Records.empty())
+        {
+            for (const auto& Sink : Sinks)
+            {
+                Sink->Flush();
+            }
+        }
+    }
+
+    // 4. 归还空间；已退出线程的缓冲排空后移除
+    bool bHasExitedBuffer = false;
+    for (size_t i = 0; i < Snapshot.size(); i++)
+    {
+        Snapshot[i]->ReadIndex.store(EndIndices[i], std::memory_order_release);
+        bHasExitedBuffer |= Snapshot[i]->bThreadExited.load(std::memory_order_acquire);
+    }
+
+    if (bHasExitedBuffer)
+    {
+        std::lock_guard<std::mutex> Lock(RegistryMutex);
+        std::erase_if(Buffers, [](const std::shared_ptr<FThreadBuffer>& Buffer)
+            {
+                return Buffer->bThreadExited.load(std::memory_order_acquire)
+                    && Buffer->ReadIndex.load(std::memory_order_relaxed) == Buffer->WriteIndex.load(std::memory_order_acquire);
+            });
+    }
+
+    return Records.size();
+}
+
+void FLogger::FormatMessage(std::string& Out, std::string_view Format, std::span<const FLogValue> Values)
+{
+    size_t ValueIndex = 0;
+    for (size_t i = 0; i < Format.size(); i++)
+    {
+        const char C = Format[i];
+        const char Next = i + 1 < Format.size() ? Format[i + 1] : '\0';
+
+        if (C == '{' && Next == '{')
+        {
+            Out += '{';
+            i++;
+        }
+        else if (C == '}' && Next == '}')
+        {
+            Out += '}';
+            i++;
+        }
+        else if (C == '{' && Next == '}' && ValueIndex < Values.size())
+        {
+            AppendValue(Out, Values[ValueIndex++]);
+            i++;
+        }
+        else
+        {
+            Out += C;
+        }
+    }
+}
+
+void FStderrLogSink::Write(ELogLevel, std::string_view Line)
+{
+    std::fwrite(Line.data(), 1, Line.size(), stderr);
+    std::fputc('\n', stderr);
+}
+
+FFileLogSink::FFileLogSink(const std::string& Path)
+{
+    File = std::fopen(Path.c_str(), "w");
+}
+
+FFileLogSink::~FFileLogSink()
+{
+    if (File)
+    {
+        std::fclose(File);
+    }
+}
+
+void FFileLogSink::Write(ELogLevel, std::string_view Line)
+{
+    if (File)
+    {
+        std::fwrite(Line.data(), 1, Line.size(), File);
+        std::fputc('\n', File);
+    }
+}
+
+void FFileLogSink::Flush()
+{
+    if (File)
+    {
+        std::fflush(File);
+    }
+}
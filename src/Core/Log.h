@@ -0,0 +1,297 @@
+﻿#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <string_view>
+#include <cstring>
+
+// 异步日志
+// - 调用线程只做：取时间戳、把参数按值拷进本线程的无锁环形缓冲 (SPSC)，不格式化、不加锁、不做 IO
+// - 后台线程按时间戳合并各线程的记录，统一格式化后写入各个 Sink (stderr / 文件)
+// - 严重级别在编译期过滤：低于 CA_LOG_COMPILE_LEVEL 的调用连参数求值都不会发生
+// - 缓冲满时 Verbose/Info/Warning 丢弃并计数，Error 阻塞等待空间
+// 格式串只支持 "{}" 占位符 ("{{" / "}}" 转义)，必须是字符串字面量
+
+enum class ELogLevel : uint8_t
+{
+    Verbose,
+    Info,
+    Warning,
+    Error,
+};
+
+#if !defined(CA_LOG_COMPILE_LEVEL)
+#if CA_ENABLE_ASSERTS
+#define CA_LOG_COMPILE_LEVEL ELogLevel::Verbose
+#else
+#define CA_LOG_COMPILE_LEVEL ELogLevel::Info
+#endif
+#endif
+
+// 每个调用点一个静态实例，记录里只存它的地址
+struct FLogSite
+{
+    ELogLevel Level;
+    const char* Tag;
+    const char* Format;
+    const char* File;
+    int Line;
+};
+
+// 后台线程解码出的参数
+struct FLogValue
+{
+    enum class EKind : uint8_t { Signed, Unsigned, Float, Bool, Char, Pointer, String };
+
+    EKind Kind = EKind::Signed;
+    union
+    {
+        int64_t Signed = 0;
+        uint64_t Unsigned;
+        double Float;
+        bool Bool;
+        char Char;
+        const void* Pointer;
+    };
+    std::string_view String;
+};
+
+class FLogSink
+{
+public:
+    virtual ~FLogSink() = default;
+    // 仅后台线程调用，Line 不含换行
+    virtual void Write(ELogLevel Level, std::string_view Line) = 0;
+    virtual void Flush() {}
+};
+
+class FStderrLogSink : public FLogSink
+{
+public:
+    void Write(ELogLevel Level, std::string_view Line) override;
+};
+
+class FFileLogSink : public FLogSink
+{
+public:
+    explicit FFileLogSink(const std::string& Path);
+    ~FFileLogSink() override;
+
+    bool IsOpen() const { return File != nullptr; }
+
+    void Write(ELogLevel Level, std::string_view Line) override;
+    void Flush() override;
+
+private:
+    FILE* File = nullptr;
+};
+
+namespace LogDetail
+{
+    // 参数编码：标量按值拷贝，字符串拷贝内容 (4 字节长度 + 字节)
+    template<typename T>
+    struct TArgCodec
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+            "Log arguments must be arithmetic, enum, pointer or string types");
+
+        static size_t Size(const T&) { return sizeof(T); }
+        static uint8_t* Encode(uint8_t* Dst, const T& Value) { std::memcpy(Dst, &Value, sizeof(T)); return Dst + sizeof(T); }
+
+        static const uint8_t* Decode(const uint8_t* Src, FLogValue& Out)
+        {
+            T Value;
+            std::memcpy(&Value, Src, sizeof(T));
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                Out.Kind = FLogValue::EKind::Bool;
+                Out.Bool = Value;
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                Out.Kind = FLogValue::EKind::Char;
+                Out.Char = Value;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                Out.Kind = FLogValue::EKind::Float;
+                Out.Float = static_cast<double>(Value);
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                Out.Kind = FLogValue::EKind::Pointer;
+                Out.Pointer = Value;
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                Out.Kind = FLogValue::EKind::Signed;
+                Out.Signed = static_cast<int64_t>(Value);
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                Out.Kind = FLogValue::EKind::Signed;
+                Out.Signed = static_cast<int64_t>(Value);
+            }
+            else
+            {
+                Out.Kind = FLogValue::EKind::Unsigned;
+                Out.Unsigned = static_cast<uint64_t>(Value);
+            }
+            return Src + sizeof(T);
+        }
+    };
+
+    struct FStringCodec
+    {
+        static size_t Size(std::string_view Value) { return sizeof(uint32_t) + Value.size(); }
+
+        static uint8_t* Encode(uint8_t* Dst, std::string_view Value)
+        {
+            const uint32_t Length = static_cast<uint32_t>(Value.size());
+            std::memcpy(Dst, &Length, sizeof(Length));
+            std::memcpy(Dst + sizeof(Length), Value.data(), Length);
+            return Dst + sizeof(Length) + Length;
+        }
+
+        static const uint8_t* Decode(const uint8_t* Src, FLogValue& Out)
+        {
+            uint32_t Length = 0;
+            std::memcpy(&Length, Src, sizeof(Length));
+            Out.Kind = FLogValue::EKind::String;
+            Out.String = std::string_view(reinterpret_cast<const char*>(Src + sizeof(Length)), Length);
+            return Src + sizeof(Length) + Length;
+        }
+    };
+
+    template<> struct TArgCodec<const char*> : FStringCodec
+    {
+        static size_t Size(const char* Value) { return FStringCodec::Size(Value ? Value : "(null)"); }
+        static uint8_t* Encode(uint8_t* Dst, const char* Value) { return FStringCodec::Encode(Dst, Value ? Value : "(null)"); }
+    };
+    template<> struct TArgCodec<char*> : TArgCodec<const char*> {};
+    template<> struct TArgCodec<std::string> : FStringCodec {};
+    template<> struct TArgCodec<std::string_view> : FStringCodec {};
+
+    // 字符数组 (字面量) 退化为 const char*
+    template<typename T>
+    using TStoredArg = std::conditional_t<std::is_array_v<std::remove_cvref_t<T>>, const char*, std::decay_t<T>>;
+
+    using FDecodeFn = size_t (*)(const uint8_t* Args, FLogValue* OutValues);
+
+    template<typename... ArgTypes>
+    size_t DecodeArgs(const uint8_t* Args, FLogValue* OutValues)
+    {
+        size_t Index = 0;
+        ((Args = TArgCodec<ArgTypes>::Decode(Args, OutValues[Index++])), ...);
+        return Index;
+    }
+
+    // 记录头，后面紧跟编码后的参数；Site 为空表示环尾填充
+    struct FRecordHeader
+    {
+        uint32_t Size;
+        const FLogSite* Site;
+        FDecodeFn Decode;
+        uint64_t TimestampNs;
+    };
+
+    constexpr size_t MAX_LOG_ARGS = 16;
+}
+
+class FLogger
+{
+public:
+    // 每个线程的环形缓冲大小 (2 的幂)
+    static constexpr size_t THREAD_BUFFER_SIZE = 64 * 1024;
+    // 后台线程空闲时的轮询间隔；Error 级别会立即唤醒
+    static constexpr uint32_t FLUSH_INTERVAL_MS = 5;
+
+    static FLogger& Get();
+
+    ~FLogger();
+
+    FLogger(const FLogger&) = delete;
+    FLogger& operator=(const FLogger&) = delete;
+
+    void AddSink(std::unique_ptr<FLogSink> InSink);
+    // 摘下当前所有 Sink (基准测试临时替换输出用)，之后可用 AddSink 装回
+    std::vector<std::unique_ptr<FLogSink>> TakeSinks();
+    // 阻塞到调用之前写入的所有记录都已输出 (退出、崩溃前调用)
+    void Flush();
+    // 排空缓冲并停止后台线程，之后的日志直接丢弃
+    void Shutdown();
+
+    template<typename... ArgTypes>
+    static void Write(const FLogSite& Site, ArgTypes&&... Args)
+    {
+        static_assert(sizeof...(ArgTypes) <= LogDetail::MAX_LOG_ARGS, "Too many log arguments");
+
+        FLogger& Logger = Get();
+        const size_t Size = sizeof(LogDetail::FRecordHeader) + (size_t(0) + ... + LogDetail::TArgCodec<LogDetail::TStoredArg<ArgTypes>>::Size(Args));
+        uint8_t* Record = Logger.BeginRecord(Size, Site.Level);
+        if (!Record)
+        {
+            return;
+        }
+
+        LogDetail::FRecordHeader Header;
+        Header.Size = static_cast<uint32_t>(Size);
+        Header.Site = &Site;
+        Header.Decode = &LogDetail::DecodeArgs<LogDetail::TStoredArg<ArgTypes>...>;
+        Header.TimestampNs = Utils::GetTimeNs();
+        std::memcpy(Record, &Header, sizeof(Header));
+
+        uint8_t* Cursor = Record + sizeof(Header);
+        ((Cursor = LogDetail::TArgCodec<LogDetail::TStoredArg<ArgTypes>>::Encode(Cursor, Args)), ...);
+
+        Logger.CommitRecord(Size, Site.Level);
+    }
+
+    // 把 {} 占位符替换为参数 (后台线程与测试使用)
+    static void FormatMessage(std::string& Out, std::string_view Format, std::span<const FLogValue> Values);
+
+private:
+    struct FThreadBuffer;
+
+    FLogger();
+
+    uint8_t* BeginRecord(size_t Size, ELogLevel Level);
+    void CommitRecord(size_t Size, ELogLevel Level);
+    FThreadBuffer& GetThreadBuffer();
+
+    void ThreadMain();
+    // 取出所有线程当前可见的记录，按时间排序后输出；返回处理的记录数
+    size_t DrainOnce();
+
+    const uint64_t StartNs;
+
+    std::mutex RegistryMutex;
+    std::vector<std::shared_ptr<FThreadBuffer>> Buffers;
+    uint32_t NextThreadIndex = 0;
+
+    std::mutex SinkMutex;
+    std::vector<std::unique_ptr<FLogSink>> Sinks;
+
+    std::mutex WakeMutex;
+    std::condition_variable WakeCV;
+    std::condition_variable FlushedCV;
+    std::atomic<uint64_t> DrainedPasses = 0;
+    std::atomic<bool> bStopRequested = false;
+    std::atomic<bool> bShutdown = false;
+    std::thread Thread;
+};
+
+#define CA_LOG(Level, Tag, Format, ...) \
+    do { \
+        if constexpr (static_cast<int>(Level) >= static_cast<int>(CA_LOG_COMPILE_LEVEL)) \
+        { \
+            static constexpr FLogSite CA_LogSite{ Level, Tag, Format, __FILE__, __LINE__ }; \
+            FLogger::Write(CA_LogSite, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define CA_LOG_VERBOSE(Tag, Format, ...) CA_LOG(ELogLevel::Verbose, Tag, Format, ##__VA_ARGS__)
+#define CA_LOG_INFO(Tag, Format, ...)    CA_LOG(ELogLevel::Info, Tag, Format, ##__VA_ARGS__)
+#define CA_LOG_WARN(Tag, Format, ...)    CA_LOG(ELogLevel::Warning, Tag, Format, ##__VA_ARGS__)
+#define CA_LOG_ERROR(Tag, Format, ...)   CA_LOG(ELogLevel::Error, Tag, Format, ##__VA_ARGS__)
@@ -0,0 +1,156 @@
+﻿#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FMappedFile::~FMappedFile()
+{
+    Close();
+}
+
+FMappedFile::FMappedFile(FMappedFile&& Other) noexcept
+{
+    *this = std::move(Other);
+}
+
+FMappedFile& FMappedFile::operator=(FMappedFile&& Other) noexcept
+{
+    if (this != &Other)
+    {
+        Close();
+        std::swap(Data, Other.Data);
+        std::swap(Size, Other.Size);
+#if defined(_WIN32)
+        std::swap(FileHandle, Other.FileHandle);
+        std::swap(MappingHandle, Other.MappingHandle);
+#endif
+    }
+    return *this;
+}
+
+bool FMappedFile::Open(const std::filesystem::path& Path)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE File = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (File == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER FileSize{};
+    if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+    {
+        CloseHandle(File);
+        return false;
+    }
+
+    HANDLE Mapping = CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (Mapping == nullptr)
+    {
+        CloseHandle(File);
+        return false;
+    }
+
+    void* View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (View == nullptr)
+    {
+        CloseHandle(Mapping);
+        CloseHandle(File);
+        return false;
+    }
+
+    FileHandle = File;
+    MappingHandle = Mapping;
+    Data = static_cast<const std::byte*>(View);
+    Size = static_cast<size_t>(FileSize.QuadPart);
+#else
+    const int File = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (File < 0)
+    {
+        return false;
+    }
+
+    struct stat FileStat{};
+    if (fstat(File, &FileStat) != 0 || FileStat.st_size <= 0)
+    {
+        close(File);
+        return false;
+    }
+
+    // 映射建立后文件描述符即可关闭，映射本身保持对文件的引用
+    void* View = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, File, 0);
+    close(File);
+    if (View == MAP_FAILED)
+    {
+        return false;
+    }
+
+    Data = static_cast<const std::byte*>(View);
+    Size = static_cast<size_t>(FileStat.st_size);
+#endif
+    return true;
+}
+
+void FMappedFile::Close()
+{
+    if (Data == nullptr)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(Data);
+    CloseHandle(static_cast<HANDLE>(MappingHandle));
+    CloseHandle(static_cast<HANDLE>(FileHandle));
+    MappingHandle = nullptr;
+    FileHandle = nullptr;
+#else
+    munmap(const_cast<std::byte*>(Data), Size);
+#endif
+    Data = nullptr;
+    Size = 0;
+}
+
+void FMappedFile::PrefetchAll() const
+{
+    if (Data == nullptr)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    WIN32_MEMORY_RANGE_ENTRY Range{ const_cast<std::byte*>(Data), Size };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+#else
+    void* Address = const_cast<std::byte*>(Data);
+    madvise(Address, Size, MADV_SEQUENTIAL);
+    madvise(Address, Size, MADV_WILLNEED);
+#endif
+}
+
+void FMappedFile::Prefetch(size_t Offset, size_t Length) const
+{
+    if (Data == nullptr || Offset >= Size)
+    {
+        return;
+    }
+    Length = std::min(Length, Size - Offset);
+
+#if defined(_WIN32)
+    WIN32_MEMORY_RANGE_ENTRY Range{ const_cast<std::byte*>(Data + Offset), Length };
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &Range, 0);
+#else
+    // madvise 要求起始地址按页对齐
+    const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t AlignedOffset = Offset & ~(PageSize - 1);
+    madvise(const_cast<std::byte*>(Data + AlignedOffset), Length + (Offset - AlignedOffset), MADV_WILLNEED);
+#endif
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+
+// 只读文件映射：文件内容直接映射进地址空间，读取时按页从磁盘 (或页缓存) 换入，不经过额外的缓冲与拷贝
+class FMappedFile
+{
+public:
+    FMappedFile() = default;
+    ~FMappedFile();
+
+    FMappedFile(FMappedFile&& Other) noexcept;
+    FMappedFile& operator=(FMappedFile&& Other) noexcept;
+    FMappedFile(const FMappedFile&) = delete;
+    FMappedFile& operator=(const FMappedFile&) = delete;
+
+    // 失败时返回 false (文件不存在、为空或映射失败)
+    bool Open(const std::filesystem::path& Path);
+    void Close();
+
+    // 提示内核按顺序预读整个映射 (Linux: MADV_SEQUENTIAL | MADV_WILLNEED, Windows: PrefetchVirtualMemory)
+    // 随后的顺序读取主要受磁盘带宽限制，而非逐页缺页
+    void PrefetchAll() const;
+    // 只预读 [Offset, Offset + Length)：立即返回，换页在后台进行，稍后的访问不再阻塞于磁盘
+    void Prefetch(size_t Offset, size_t Length) const;
+
+    bool IsOpen() const { return Data != nullptr; }
+    const std::byte* GetData() const { return Data; }
+    size_t GetSize() const { return Size; }
+
+private:
+    const std::byte* Data = nullptr;
+    size_t Size = 0;
+#if defined(_WIN32)
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,542 @@
+﻿#include "MathSimd.h"
+#include <cstring>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CA_MATH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define CA_MATH_X86 0
+#endif
+
+// GCC / Clang 需要函数级 target 才能在未开 -mavx2 的编译单元里使用 AVX2 内建函数；MSVC 不需要
+#if CA_MATH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define CA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define CA_TARGET_AVX2
+#endif
+
+namespace {
+    using MathSimd::EPath;
+
+    bool DetectAvx2()
+    {
+#if !CA_MATH_X86
+        return false;
+#elif defined(_MSC_VER)
+        int Info[4];
+        __cpuid(Info, 0);
+        if (Info[0] < 7)
+        {
+            return false;
+        }
+
+        // FMA (ECX bit 12)、OSXSAVE (bit 27)、AVX (bit 28)，且操作系统保存 YMM 状态 (XCR0 bit 1-2)
+        __cpuid(Info, 1);
+        constexpr int REQUIRED_ECX = (1 << 12) | (1 << 27) | (1 << 28);
+        if ((Info[2] & REQUIRED_ECX) != REQUIRED_ECX || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+
+        __cpuidex(Info, 7, 0);
+        return (Info[1] & (1 << 5)) != 0; // AVX2 (EBX bit 5)
+#else
+        // libgcc / compiler-rt 的检测同样检查了操作系统对 YMM 状态的支持
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+
+    // 8 位可见掩码 -> 8 个 0/1 字节 (小端：第 k 位对应第 k 个字节)
+    constexpr std::array<uint64_t, 256> MakeMaskExpandTable()
+    {
+        std::array<uint64_t, 256> Table{};
+        for (uint32_t Mask = 0; Mask < 256; Mask++)
+        {
+            for (uint32_t Bit = 0; Bit < 8; Bit++)
+            {
+                Table[Mask] |= static_cast<uint64_t>((Mask >> Bit) & 1) << (Bit * 8);
+            }
+        }
+        return Table;
+    }
+    constexpr std::array<uint64_t, 256> MASK_EXPAND_TABLE = MakeMaskExpandTable();
+
+    // 8 位可见掩码 -> 置位的下标依次打包成 4 位一组 (第 k 个可见元素的下标在 [4k, 4k + 4) 位)，供 AVX2 压缩排列
+    constexpr std::array<uint32_t, 256> MakeMaskCompactTable()
+    {
+        std::array<uint32_t, 256> Table{};
+        for (uint32_t Mask = 0; Mask < 256; Mask++)
+        {
+            uint32_t Slot = 0;
+            for (uint32_t Bit = 0; Bit < 8; Bit++)
+            {
+                if ((Mask >> Bit) & 1)
+                {
+                    Table[Mask] |= Bit << (Slot++ * 4);
+                }
+            }
+        }
+        return Table;
+    }
+    constexpr std::array<uint32_t, 256> MASK_COMPACT_TABLE = MakeMaskCompactTable();
+
+    // ---------------------------------------------------------------------
+    // 标量路径 (也处理 SIMD 路径的余数)
+    // ---------------------------------------------------------------------
+    void MultiplyMatricesScalar(const FMatrix4& A, const FMatrix4* B, FMatrix4* Out, uint32_t Begin, uint32_t End)
+    {
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            Out[i] = A * B[i];
+        }
+    }
+
+    void TransformPointsScalar(const FMatrix4& M, const float* X, const float* Y, const float* Z,
+        float* OutX, float* OutY, float* OutZ, uint32_t Begin, uint32_t End)
+    {
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            const FVector3 P = M.TransformPoint({ X[i], Y[i], Z[i] });
+            OutX[i] = P.X;
+            OutY[i] = P.Y;
+            OutZ[i] = P.Z;
+        }
+    }
+
+    uint32_t TestSpheresScalar(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint8_t* OutVisible, uint32_t Begin, uint32_t End)
+    {
+        uint32_t VisibleCount = 0;
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            const bool bVisible = Frustum.Intersects(FSphere{ { X[i], Y[i], Z[i] }, Radius[i] });
+            OutVisible[i] = bVisible ? 1 : 0;
+            VisibleCount += bVisible ? 1 : 0;
+        }
+        return VisibleCount;
+    }
+
+    uint32_t CullSpheresScalar(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint32_t Begin, uint32_t End, uint32_t* OutIndices)
+    {
+        uint32_t VisibleCount = 0;
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            // 无条件写入、按结果推进，避免不可预测的分支
+            OutIndices[VisibleCount] = i;
+            VisibleCount += Frustum.Intersects(FSphere{ { X[i], Y[i], Z[i] }, Radius[i] }) ? 1 : 0;
+        }
+        return VisibleCount;
+    }
+
+#if CA_MATH_X86
+    // ---------------------------------------------------------------------
+    // SSE 路径 (x86-64 基线，无需检测)
+    // ---------------------------------------------------------------------
+    template <int Index>
+    __m128 Splat(__m128 V)
+    {
+        return _mm_shuffle_ps(V, V, _MM_SHUFFLE(Index, Index, Index, Index));
+    }
+
+    __m128 TransformColumnSSE(const __m128 (&A)[4], __m128 V)
+    {
+        __m128 Result = _mm_mul_ps(A[0], Splat<0>(V));
+        Result = _mm_add_ps(Result, _mm_mul_ps(A[1], Splat<1>(V)));
+        Result = _mm_add_ps(Result, _mm_mul_ps(A[2], Splat<2>(V)));
+        return _mm_add_ps(Result, _mm_mul_ps(A[3], Splat<3>(V)));
+    }
+
+    void LoadColumnsSSE(const FMatrix4& M, __m128 (&Out)[4])
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            Out[i] = _mm_loadu_ps(&M.Columns[i].X);
+        }
+    }
+
+    void MultiplyMatricesSSE(const FMatrix4& A, const FMatrix4* B, FMatrix4* Out, uint32_t Count)
+    {
+        __m128 Columns[4];
+        LoadColumnsSSE(A, Columns);
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            const __m128 B0 = _mm_loadu_ps(&B[i].Columns[0].X);
+            const __m128 B1 = _mm_loadu_ps(&B[i].Columns[1].X);
+            const __m128 B2 = _mm_loadu_ps(&B[i].Columns[2].X);
+            const __m128 B3 = _mm_loadu_ps(&B[i].Columns[3].X);
+            _mm_storeu_ps(&Out[i].Columns[0].X, TransformColumnSSE(Columns, B0));
+            _mm_storeu_ps(&Out[i].Columns[1].X, TransformColumnSSE(Columns, B1));
+            _mm_storeu_ps(&Out[i].Columns[2].X, TransformColumnSSE(Columns, B2));
+            _mm_storeu_ps(&Out[i].Columns[3].X, TransformColumnSSE(Columns, B3));
+        }
+    }
+
+    uint32_t TransformPointsSSE(const FMatrix4& M, const float* X, const float* Y, const float* Z,
+        float* OutX, float* OutY, float* OutZ, uint32_t Count)
+    {
+        const __m128 M00 = _mm_set1_ps(M.Columns[0].X), M10 = _mm_set1_ps(M.Columns[0].Y), M20 = _mm_set1_ps(M.Columns[0].Z);
+        const __m128 M01 = _mm_set1_ps(M.Columns[1].X), M11 = _mm_set1_ps(M.Columns[1].Y), M21 = _mm_set1_ps(M.Columns[1].Z);
+        const __m128 M02 = _mm_set1_ps(M.Columns[2].X), M12 = _mm_set1_ps(M.Columns[2].Y), M22 = _mm_set1_ps(M.Columns[2].Z);
+        const __m128 M03 = _mm_set1_ps(M.Columns[3].X), M13 = _mm_set1_ps(M.Columns[3].Y), M23 = _mm_set1_ps(M.Columns[3].Z);
+
+        uint32_t i = 0;
+        for (; i + 4 <= Count; i += 4)
+        {
+            const __m128 PX = _mm_loadu_ps(X + i);
+            const __m128 PY = _mm_loadu_ps(Y + i);
+            const __m128 PZ = _mm_loadu_ps(Z + i);
+            _mm_storeu_ps(OutX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M00, PX), _mm_mul_ps(M01, PY)), _mm_add_ps(_mm_mul_ps(M02, PZ), M03)));
+            _mm_storeu_ps(OutY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M10, PX), _mm_mul_ps(M11, PY)), _mm_add_ps(_mm_mul_ps(M12, PZ), M13)));
+            _mm_storeu_ps(OutZ + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M20, PX), _mm_mul_ps(M21, PY)), _mm_add_ps(_mm_mul_ps(M22, PZ), M23)));
+        }
+        return i;
+    }
+
+    uint32_t TestSpheresSSE(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint8_t* OutVisible, uint32_t Count, uint32_t& OutVisibleCount)
+    {
+        __m128 PlaneX[FFrustum::Count], PlaneY[FFrustum::Count], PlaneZ[FFrustum::Count], PlaneD[FFrustum::Count];
+        for (int p = 0; p < FFrustum::Count; p++)
+        {
+            PlaneX[p] = _mm_set1_ps(Frustum.Planes[p].Normal.X);
+            PlaneY[p] = _mm_set1_ps(Frustum.Planes[p].Normal.Y);
+            PlaneZ[p] = _mm_set1_ps(Frustum.Planes[p].Normal.Z);
+            PlaneD[p] = _mm_set1_ps(Frustum.Planes[p].D);
+        }
+
+        uint32_t VisibleCount = 0;
+        uint32_t i = 0;
+        for (; i + 4 <= Count; i += 4)
+        {
+            const __m128 CX = _mm_loadu_ps(X + i);
+            const __m128 CY = _mm_loadu_ps(Y + i);
+            const __m128 CZ = _mm_loadu_ps(Z + i);
+            const __m128 NegRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(Radius + i));
+
+            // 六个平面都不在外侧 (距离 >= -半径) 才可见
+            __m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < FFrustum::Count; p++)
+            {
+                const __m128 Distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(PlaneX[p], CX), _mm_mul_ps(PlaneY[p], CY)),
+                    _mm_add_ps(_mm_mul_ps(PlaneZ[p], CZ), PlaneD[p]));
+                Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Distance, NegRadius));
+            }
+
+            const uint32_t Mask = static_cast<uint32_t>(_mm_movemask_ps(Inside));
+            const uint32_t Expanded = static_cast<uint32_t>(MASK_EXPAND_TABLE[Mask]);
+            std::memcpy(OutVisible + i, &Expanded, sizeof(Expanded));
+            VisibleCount += static_cast<uint32_t>(std::popcount(Mask));
+        }
+        OutVisibleCount = VisibleCount;
+        return i;
+    }
+
+    // SSE2 没有跨通道的变量排列，按位取出可见下标
+    uint32_t CullSpheresSSE(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint32_t Begin, uint32_t End, uint32_t* OutIndices, uint32_t& OutVisibleCount)
+    {
+        __m128 PlaneX[FFrustum::Count], PlaneY[FFrustum::Count], PlaneZ[FFrustum::Count], PlaneD[FFrustum::Count];
+        for (int p = 0; p < FFrustum::Count; p++)
+        {
+            PlaneX[p] = _mm_set1_ps(Frustum.Planes[p].Normal.X);
+            PlaneY[p] = _mm_set1_ps(Frustum.Planes[p].Normal.Y);
+            PlaneZ[p] = _mm_set1_ps(Frustum.Planes[p].Normal.Z);
+            PlaneD[p] = _mm_set1_ps(Frustum.Planes[p].D);
+        }
+
+        uint32_t VisibleCount = 0;
+        uint32_t i = Begin;
+        for (; i + 4 <= End; i += 4)
+        {
+            const __m128 CX = _mm_loadu_ps(X + i);
+            const __m128 CY = _mm_loadu_ps(Y + i);
+            const __m128 CZ = _mm_loadu_ps(Z + i);
+            const __m128 NegRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(Radius + i));
+
+            __m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < FFrustum::Count; p++)
+            {
+                const __m128 Distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(PlaneX[p], CX), _mm_mul_ps(PlaneY[p], CY)),
+                    _mm_add_ps(_mm_mul_ps(PlaneZ[p], CZ), PlaneD[p]));
+                Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Distance, NegRadius));
+            }
+
+            for (uint32_t Mask = static_cast<uint32_t>(_mm_movemask_ps(Inside)); Mask != 0; Mask &= Mask - 1)
+            {
+                OutIndices[VisibleCount++] = i + static_cast<uint32_t>(std::countr_zero(Mask));
+            }
+        }
+        OutVisibleCount = VisibleCount;
+        return i;
+    }
+
+    // ---------------------------------------------------------------------
+    // AVX2 + FMA 路径 (运行时检测)
+    // ---------------------------------------------------------------------
+    // 一次处理两列：每个 128 位半边各是 B 的一列，按半边内的下标广播后与 A 的列相乘
+    CA_TARGET_AVX2 inline __m256 TransformColumnPairAVX2(const __m256 (&A)[4], __m256 V)
+    {
+        __m256 Result = _mm256_mul_ps(A[0], _mm256_permute_ps(V, _MM_SHUFFLE(0, 0, 0, 0)));
+        Result = _mm256_fmadd_ps(A[1], _mm256_permute_ps(V, _MM_SHUFFLE(1, 1, 1, 1)), Result);
+        Result = _mm256_fmadd_ps(A[2], _mm256_permute_ps(V, _MM_SHUFFLE(2, 2, 2, 2)), Result);
+        return _mm256_fmadd_ps(A[3], _mm256_permute_ps(V, _MM_SHUFFLE(3, 3, 3, 3)), Result);
+    }
+
+    CA_TARGET_AVX2 void MultiplyMatricesAVX2(const FMatrix4& A, const FMatrix4* B, FMatrix4* Out, uint32_t Count)
+    {
+        __m256 Columns[4];
+        for (int i = 0; i < 4; i++)
+        {
+            Columns[i] = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&A.Columns[i].X));
+        }
+
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            const __m256 B01 = _mm256_loadu_ps(&B[i].Columns[0].X);
+            const __m256 B23 = _mm256_loadu_ps(&B[i].Columns[2].X);
+            _mm256_storeu_ps(&Out[i].Columns[0].X, TransformColumnPairAVX2(Columns, B01));
+            _mm256_storeu_ps(&Out[i].Columns[2].X, TransformColumnPairAVX2(Columns, B23));
+        }
+    }
+
+    CA_TARGET_AVX2 uint32_t TransformPointsAVX2(const FMatrix4& M, const float* X, const float* Y, const float* Z,
+        float* OutX, float* OutY, float* OutZ, uint32_t Count)
+    {
+        const __m256 M00 = _mm256_set1_ps(M.Columns[0].X), M10 = _mm256_set1_ps(M.Columns[0].Y), M20 = _mm256_set1_ps(M.Columns[0].Z);
+        const __m256 M01 = _mm256_set1_ps(M.Columns[1].X), M11 = _mm256_set1_ps(M.Columns[1].Y), M21 = _mm256_set1_ps(M.Columns[1].Z);
+        const __m256 M02 = _mm256_set1_ps(M.Columns[2].X), M12 = _mm256_set1_ps(M.Columns[2].Y), M22 = _mm256_set1_ps(M.Columns[2].Z);
+        const __m256 M03 = _mm256_set1_ps(M.Columns[3].X), M13 = _mm256_set1_ps(M.Columns[3].Y), M23 = _mm256_set1_ps(M.Columns[3].Z);
+
+        uint32_t i = 0;
+        for (; i + 8 <= Count; i += 8)
+        {
+            const __m256 PX = _mm256_loadu_ps(X + i);
+            const __m256 PY = _mm256_loadu_ps(Y + i);
+            const __m256 PZ = _mm256_loadu_ps(Z + i);
+            _mm256_storeu_ps(OutX + i, _mm256_fmadd_ps(M00, PX, _mm256_fmadd_ps(M01, PY, _mm256_fmadd_ps(M02, PZ, M03))));
+            _mm256_storeu_ps(OutY + i, _mm256_fmadd_ps(M10, PX, _mm256_fmadd_ps(M11, PY, _mm256_fmadd_ps(M12, PZ, M13))));
+            _mm256_storeu_ps(OutZ + i, _mm256_fmadd_ps(M20, PX, _mm256_fmadd_ps(M21, PY, _mm256_fmadd_ps(M22, PZ, M23))));
+        }
+        return i;
+    }
+
+    CA_TARGET_AVX2 uint32_t TestSpheresAVX2(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint8_t* OutVisible, uint32_t Count, uint32_t& OutVisibleCount)
+    {
+        __m256 PlaneX[FFrustum::Count], PlaneY[FFrustum::Count], PlaneZ[FFrustum::Count], PlaneD[FFrustum::Count];
+        for (int p = 0; p < FFrustum::Count; p++)
+        {
+            PlaneX[p] = _mm256_set1_ps(Frustum.Planes[p].Normal.X);
+            PlaneY[p] = _mm256_set1_ps(Frustum.Planes[p].Normal.Y);
+            PlaneZ[p] = _mm256_set1_ps(Frustum.Planes[p].Normal.Z);
+            PlaneD[p] = _mm256_set1_ps(Frustum.Planes[p].D);
+        }
+
+        uint32_t VisibleCount = 0;
+        uint32_t i = 0;
+        for (; i + 8 <= Count; i += 8)
+        {
+            const __m256 CX = _mm256_loadu_ps(X + i);
+            const __m256 CY = _mm256_loadu_ps(Y + i);
+            const __m256 CZ = _mm256_loadu_ps(Z + i);
+            const __m256 NegRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(Radius + i));
+
+            __m256 Inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < FFrustum::Count; p++)
+            {
+                const __m256 Distance = _mm256_fmadd_ps(PlaneX[p], CX, _mm256_fmadd_ps(PlaneY[p], CY, _mm256_fmadd_ps(PlaneZ[p], CZ, PlaneD[p])));
+                Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(Distance, NegRadius, _CMP_GE_OQ));
+            }
+
+            const uint32_t Mask = static_cast<uint32_t>(_mm256_movemask_ps(Inside));
+            std::memcpy(OutVisible + i, &MASK_EXPAND_TABLE[Mask], sizeof(uint64_t));
+            VisibleCount += static_cast<uint32_t>(std::popcount(Mask));
+        }
+        OutVisibleCount = VisibleCount;
+        return i;
+    }
+
+    // 每次 8 个球：可见掩码查表得到排列，把可见序号挤到低位后整组写出，按可见数推进输出位置
+    // 已写出的个数不超过已处理的个数，整组写出不会越过 End - Begin
+    CA_TARGET_AVX2 uint32_t CullSpheresAVX2(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint32_t Begin, uint32_t End, uint32_t* OutIndices, uint32_t& OutVisibleCount)
+    {
+        __m256 PlaneX[FFrustum::Count], PlaneY[FFrustum::Count], PlaneZ[FFrustum::Count], PlaneD[FFrustum::Count];
+        for (int p = 0; p < FFrustum::Count; p++)
+        {
+            PlaneX[p] = _mm256_set1_ps(Frustum.Planes[p].Normal.X);
+            PlaneY[p] = _mm256_set1_ps(Frustum.Planes[p].Normal.Y);
+            PlaneZ[p] = _mm256_set1_ps(Frustum.Planes[p].Normal.Z);
+            PlaneD[p] = _mm256_set1_ps(Frustum.Planes[p].D);
+        }
+
+        const __m256i LaneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i NibbleShifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i NibbleMask = _mm256_set1_epi32(0xF);
+
+        uint32_t VisibleCount = 0;
+        uint32_t i = Begin;
+        for (; i + 8 <= End; i += 8)
+        {
+            const __m256 CX = _mm256_loadu_ps(X + i);
+            const __m256 CY = _mm256_loadu_ps(Y + i);
+            const __m256 CZ = _mm256_loadu_ps(Z + i);
+            const __m256 NegRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(Radius + i));
+
+            __m256 Inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < FFrustum::Count; p++)
+            {
+                const __m256 Distance = _mm256_fmadd_ps(PlaneX[p], CX, _mm256_fmadd_ps(PlaneY[p], CY, _mm256_fmadd_ps(PlaneZ[p], CZ, PlaneD[p])));
+                Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(Distance, NegRadius, _CMP_GE_OQ));
+            }
+
+            const uint32_t Mask = static_cast<uint32_t>(_mm256_movemask_ps(Inside));
+            const __m256i Permutation = _mm256_and_si256(
+                _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(MASK_COMPACT_TABLE[Mask])), NibbleShifts), NibbleMask);
+            const __m256i Indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), LaneOffsets);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(OutIndices + VisibleCount), _mm256_permutevar8x32_epi32(Indices, Permutation));
+            VisibleCount += static_cast<uint32_t>(std::popcount(Mask));
+        }
+        OutVisibleCount = VisibleCount;
+        return i;
+    }
+#endif
+}
+
+namespace MathSimd
+{
+    EPath GetBestPath()
+    {
+        static const EPath BestPath = DetectAvx2() ? EPath::AVX2 : CA_MATH_X86 ? EPath::SSE : EPath::Scalar;
+        return BestPath;
+    }
+
+    bool IsPathSupported(EPath Path)
+    {
+        return static_cast<uint8_t>(Path) <= static_cast<uint8_t>(GetBestPath());
+    }
+
+    const char* GetPathName(EPath Path)
+    {
+        switch (Path)
+        {
+        case EPath::Scalar: return "scalar";
+        case EPath::SSE: return "SSE";
+        case EPath::AVX2: return "AVX2";
+        }
+        return "unknown";
+    }
+
+    FMatrix4 Multiply(const FMatrix4& A, const FMatrix4& B)
+    {
+        FMatrix4 Result;
+        MultiplyMatrices(A, &B, &Result, 1, CA_MATH_X86 ? EPath::SSE : EPath::Scalar);
+        return Result;
+    }
+
+    FVector4 Transform(const FMatrix4& M, const FVector4& V)
+    {
+#if CA_MATH_X86
+        __m128 Columns[4];
+        LoadColumnsSSE(M, Columns);
+        FVector4 Result;
+        _mm_storeu_ps(&Result.X, TransformColumnSSE(Columns, _mm_loadu_ps(&V.X)));
+        return Result;
+#else
+        return M * V;
+#endif
+    }
+
+    void MultiplyMatrices(const FMatrix4& A, const FMatrix4* B, FMatrix4* Out, uint32_t Count, EPath Path)
+    {
+        check(IsPathSupported(Path));
+#if CA_MATH_X86
+        if (Path == EPath::AVX2)
+        {
+            MultiplyMatricesAVX2(A, B, Out, Count);
+            return;
+        }
+        if (Path == EPath::SSE)
+        {
+            MultiplyMatricesSSE(A, B, Out, Count);
+            return;
+        }
+#endif
+        MultiplyMatricesScalar(A, B, Out, 0, Count);
+    }
+
+    void TransformPoints(const FMatrix4& M, const float* X, const float* Y, const float* Z,
+        float* OutX, float* OutY, float* OutZ, uint32_t Count, EPath Path)
+    {
+        check(IsPathSupported(Path));
+        uint32_t Done = 0;
+#if CA_MATH_X86
+        if (Path == EPath::AVX2)
+        {
+            Done = TransformPointsAVX2(M, X, Y, Z, OutX, OutY, OutZ, Count);
+        }
+        else if (Path == EPath::SSE)
+        {
+            Done = TransformPointsSSE(M, X, Y, Z, OutX, OutY, OutZ, Count);
+        }
+#endif
+        TransformPointsScalar(M, X, Y, Z, OutX, OutY, OutZ, Done, Count);
+    }
+
+    void TransformSpheres(const FMatrix4& M, const float* X, const float* Y, const float* Z, const float* Radius,
+        float* OutX, float* OutY, float* OutZ, float* OutRadius, uint32_t Count, EPath Path)
+    {
+        TransformPoints(M, X, Y, Z, OutX, OutY, OutZ, Count, Path);
+
+        // 半径只是乘一个常数，编译器对这个循环的自动向量化已经足够
+        const float Scale = M.GetMaxScale();
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            OutRadius[i] = Radius[i] * Scale;
+        }
+    }
+
+    uint32_t TestSpheres(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint8_t* OutVisible, uint32_t Count, EPath Path)
+    {
+        check(IsPathSupported(Path));
+        uint32_t Done = 0;
+        uint32_t VisibleCount = 0;
+#if CA_MATH_X86
+        if (Path == EPath::AVX2)
+        {
+            Done = TestSpheresAVX2(Frustum, X, Y, Z, Radius, OutVisible, Count, VisibleCount);
+        }
+        else if (Path == EPath::SSE)
+        {
+            Done = TestSpheresSSE(Frustum, X, Y, Z, Radius, OutVisible, Count, VisibleCount);
+        }
+#endif
+        return VisibleCount + TestSpheresScalar(Frustum, X, Y, Z, Radius, OutVisible, Done, Count);
+    }
+
+    uint32_t CullSpheres(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint32_t Begin, uint32_t End, uint32_t* OutIndices, EPath Path)
+    {
+        check(IsPathSupported(Path));
+        uint32_t Done = Begin;
+        uint32_t VisibleCount = 0;
+#if CA_MATH_X86
+        if (Path == EPath::AVX2)
+        {
+            Done = CullSpheresAVX2(Frustum, X, Y, Z, Radius, Begin, End, OutIndices, VisibleCount);
+        }
+        else if (Path == EPath::SSE)
+        {
+            Done = CullSpheresSSE(Frustum, X, Y, Z, Radius, Begin, End, OutIndices, VisibleCount);
+        }
+#endif
+        return VisibleCount + CullSpheresScalar(Frustum, X, Y, Z, Radius, Done, End, OutIndices + VisibleCount);
+    }
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+#include "MathTypes.h"
+#include <cstdint>
+
+// 批量数学运算的 SIMD 实现 (标量类型见 MathTypes.h)
+// - 批量接口按 SoA 传入 (X / Y / Z / 半径各一个数组)，SSE 每次处理 4 个元素，AVX2 (+ FMA) 每次 8 个，余数走标量
+// - 每个批量函数都有标量、SSE、AVX2 三条路径，默认按 CPUID 选最快的；AVX2 路径以函数级 target 属性编译，不依赖全局编译选项
+// - 非 x86-64 平台只有标量路径
+// - 单个矩阵乘法与向量变换用 SSE：矩阵列主序，每列正好一个 128 位寄存器
+namespace MathSimd
+{
+    enum class EPath : uint8_t
+    {
+        Scalar,
+        SSE,
+        AVX2,
+    };
+
+    // CPU 与操作系统都支持的最快路径 (首次调用时检测并缓存)
+    EPath GetBestPath();
+    bool IsPathSupported(EPath Path);
+    const char* GetPathName(EPath Path);
+
+    FMatrix4 Multiply(const FMatrix4& A, const FMatrix4& B);
+    FVector4 Transform(const FMatrix4& M, const FVector4& V);
+
+    // Out[i] = A * B[i] (如给一批局部矩阵拼上同一个父矩阵)；Out 可以与 B 相同
+    void MultiplyMatrices(const FMatrix4& A, const FMatrix4* B, FMatrix4* Out, uint32_t Count, EPath Path = GetBestPath());
+
+    // Out = (M * (P, 1)).xyz，与 FMatrix4::TransformPoint 一致；输出可以与输入相同
+    void TransformPoints(const FMatrix4& M, const float* X, const float* Y, const float* Z,
+        float* OutX, float* OutY, float* OutZ, uint32_t Count, EPath Path = GetBestPath());
+
+    // 球心按 TransformPoints 变换，半径乘以 M 的最大缩放，与 FSphere::TransformedBy 一致
+    void TransformSpheres(const FMatrix4& M, const float* X, const float* Y, const float* Z, const float* Radius,
+        float* OutX, float* OutY, float* OutZ, float* OutRadius, uint32_t Count, EPath Path = GetBestPath());
+
+    // OutVisible[i] = 1 表示球 i 与视锥相交 (判定与 FFrustum::Intersects 一致)，返回相交的个数
+    uint32_t TestSpheres(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint8_t* OutVisible, uint32_t Count, EPath Path = GetBestPath());
+
+    // 与 TestSpheres 判定相同，但把 [Begin, End) 中可见球的序号按升序压缩写入 OutIndices，返回个数
+    // OutIndices 至少要有 End - Begin 个元素：SIMD 路径整组写出，返回值之后的元素内容未定义
+    uint32_t CullSpheres(const FFrustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+        uint32_t Begin, uint32_t End, uint32_t* OutIndices, EPath Path = GetBestPath());
+}
@@ -0,0 +1,326 @@
+﻿#pragma once
+#include <cmath>
+#include <algorithm>
+
+// 基础数学类型 (标量实现，批量的 SIMD 版本见 MathSimd.h)
+// - 右手坐标系，矩阵列主序存储，与 HLSL 默认 column_major 布局一致，mul(M, v) 即 M * v
+// - 投影矩阵输出 Vulkan 裁剪空间：Y 向下，深度 [0, 1]
+
+struct FVector3
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+
+    constexpr FVector3() = default;
+    constexpr FVector3(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+    constexpr FVector3 operator+(const FVector3& Other) const { return { X + Other.X, Y + Other.Y, Z + Other.Z }; }
+    constexpr FVector3 operator-(const FVector3& Other) const { return { X - Other.X, Y - Other.Y, Z - Other.Z }; }
+    constexpr FVector3 operator*(float Scale) const { return { X * Scale, Y * Scale, Z * Scale }; }
+    constexpr FVector3 operator-() const { return { -X, -Y, -Z }; }
+
+    static constexpr float Dot(const FVector3& A, const FVector3& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+
+    static constexpr FVector3 Cross(const FVector3& A, const FVector3& B)
+    {
+        return { A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X };
+    }
+
+    float Length() const { return std::sqrt(Dot(*this, *this)); }
+
+    FVector3 GetNormalized() const
+    {
+        const float Len = Length();
+        return Len > 0.0f ? *this * (1.0f / Len) : FVector3();
+    }
+};
+
+struct FVector4
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+    float W = 0.0f;
+
+    constexpr FVector4() = default;
+    constexpr FVector4(float InX, float InY, float InZ, float InW) : X(InX), Y(InY), Z(InZ), W(InW) {}
+    constexpr FVector4(const FVector3& InXYZ, float InW) : X(InXYZ.X), Y(InXYZ.Y), Z(InXYZ.Z), W(InW) {}
+
+    constexpr FVector4 operator+(const FVector4& Other) const { return { X + Other.X, Y + Other.Y, Z + Other.Z, W + Other.W }; }
+    constexpr FVector4 operator-(const FVector4& Other) const { return { X - Other.X, Y - Other.Y, Z - Other.Z, W - Other.W }; }
+    constexpr FVector4 operator*(float Scale) const { return { X * Scale, Y * Scale, Z * Scale, W * Scale }; }
+
+    constexpr FVector3 XYZ() const { return { X, Y, Z }; }
+};
+
+// 单位四元数表示旋转 (X, Y, Z 为虚部，W 为实部)
+struct FQuat
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+    float W = 1.0f;
+
+    constexpr FQuat() = default;
+    constexpr FQuat(float InX, float InY, float InZ, float InW) : X(InX), Y(InY), Z(InZ), W(InW) {}
+
+    // Axis 需为单位向量
+    static FQuat FromAxisAngle(const FVector3& Axis, float AngleRadians)
+    {
+        const float S = std::sin(AngleRadians * 0.5f);
+        return { Axis.X * S, Axis.Y * S, Axis.Z * S, std::cos(AngleRadians * 0.5f) };
+    }
+
+    // 先应用 Other 再应用 this
+    constexpr FQuat operator*(const FQuat& Other) const
+    {
+        return {
+            W * Other.X + X * Other.W + Y * Other.Z - Z * Other.Y,
+            W * Other.Y - X * Other.Z + Y * Other.W + Z * Other.X,
+            W * Other.Z + X * Other.Y - Y * Other.X + Z * Other.W,
+            W * Other.W - X * Other.X - Y * Other.Y - Z * Other.Z };
+    }
+
+    constexpr FQuat GetConjugate() const { return { -X, -Y, -Z, W }; }
+
+    // v' = v + 2w (q x v) + 2 q x (q x v)
+    constexpr FVector3 Rotate(const FVector3& V) const
+    {
+        const FVector3 Q{ X, Y, Z };
+        const FVector3 T = FVector3::Cross(Q, V) * 2.0f;
+        return V + T * W + FVector3::Cross(Q, T);
+    }
+
+    FQuat GetNormalized() const
+    {
+        const float LengthSquared = X * X + Y * Y + Z * Z + W * W;
+        const float InvLength = LengthSquared > 0.0f ? 1.0f / std::sqrt(LengthSquared) : 0.0f;
+        return LengthSquared > 0.0f ? FQuat{ X * InvLength, Y * InvLength, Z * InvLength, W * InvLength } : FQuat();
+    }
+
+    // 走较短的弧；夹角很小时退化为归一化的线性插值
+    static FQuat Slerp(const FQuat& A, const FQuat& B, float T)
+    {
+        float CosTheta = A.X * B.X + A.Y * B.Y + A.Z * B.Z + A.W * B.W;
+        const float Sign = CosTheta < 0.0f ? -1.0f : 1.0f;
+        CosTheta *= Sign;
+
+        float WeightA = 1.0f - T;
+        float WeightB = T;
+        if (CosTheta < 0.9995f)
+        {
+            const float Theta = std::acos(CosTheta);
+            const float InvSinTheta = 1.0f / std::sin(Theta);
+            WeightA = std::sin((1.0f - T) * Theta) * InvSinTheta;
+            WeightB = std::sin(T * Theta) * InvSinTheta;
+        }
+        WeightB *= Sign;
+        return FQuat{ A.X * WeightA + B.X * WeightB, A.Y * WeightA + B.Y * WeightB,
+            A.Z * WeightA + B.Z * WeightB, A.W * WeightA + B.W * WeightB }.GetNormalized();
+    }
+};
+
+struct FMatrix4
+{
+    FVector4 Columns[4];
+
+    static constexpr FMatrix4 Identity()
+    {
+        FMatrix4 Result;
+        Result.Columns[0] = { 1.0f, 0.0f, 0.0f, 0.0f };
+        Result.Columns[1] = { 0.0f, 1.0f, 0.0f, 0.0f };
+        Result.Columns[2] = { 0.0f, 0.0f, 1.0f, 0.0f };
+        Result.Columns[3] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        return Result;
+    }
+
+    constexpr FVector4 operator*(const FVector4& V) const
+    {
+        return Columns[0] * V.X + Columns[1] * V.Y + Columns[2] * V.Z + Columns[3] * V.W;
+    }
+
+    constexpr FMatrix4 operator*(const FMatrix4& Other) const
+    {
+        FMatrix4 Result;
+        for (int i = 0; i < 4; i++)
+        {
+            Result.Columns[i] = *this * Other.Columns[i];
+        }
+        return Result;
+    }
+
+    // 第 Index 行 (提取视锥平面用)
+    constexpr FVector4 GetRow(int Index) const
+    {
+        auto Component = [Index](const FVector4& V) { return Index == 0 ? V.X : Index == 1 ? V.Y : Index == 2 ? V.Z : V.W; };
+        return { Component(Columns[0]), Component(Columns[1]), Component(Columns[2]), Component(Columns[3]) };
+    }
+
+    FVector3 TransformPoint(const FVector3& P) const { return (*this * FVector4(P, 1.0f)).XYZ(); }
+    FVector3 TransformVector(const FVector3& V) const { return (*this * FVector4(V, 0.0f)).XYZ(); }
+
+    // 三个基向量中最长的一个：变换包围球半径用 (非均匀缩放时保守)
+    float GetMaxScale() const
+    {
+        return std::sqrt(std::max({ FVector3::Dot(Columns[0].XYZ(), Columns[0].XYZ()),
+            FVector3::Dot(Columns[1].XYZ(), Columns[1].XYZ()), FVector3::Dot(Columns[2].XYZ(), Columns[2].XYZ()) }));
+    }
+
+    // 平移 * 旋转 * 缩放
+    static FMatrix4 TranslationRotationScale(const FVector3& Translation, const FQuat& Rotation, const FVector3& Scale)
+    {
+        const float XX = Rotation.X * Rotation.X, YY = Rotation.Y * Rotation.Y, ZZ = Rotation.Z * Rotation.Z;
+        const float XY = Rotation.X * Rotation.Y, XZ = Rotation.X * Rotation.Z, YZ = Rotation.Y * Rotation.Z;
+        const float WX = Rotation.W * Rotation.X, WY = Rotation.W * Rotation.Y, WZ = Rotation.W * Rotation.Z;
+
+        FMatrix4 Result;
+        Result.Columns[0] = FVector4(1.0f - 2.0f * (YY + ZZ), 2.0f * (XY + WZ), 2.0f * (XZ - WY), 0.0f) * Scale.X;
+        Result.Columns[1] = FVector4(2.0f * (XY - WZ), 1.0f - 2.0f * (XX + ZZ), 2.0f * (YZ + WX), 0.0f) * Scale.Y;
+        Result.Columns[2] = FVector4(2.0f * (XZ + WY), 2.0f * (YZ - WX), 1.0f - 2.0f * (XX + YY), 0.0f) * Scale.Z;
+        Result.Columns[3] = FVector4(Translation, 1.0f);
+        return Result;
+    }
+
+    // 平移 * 绕 Z 轴旋转 * 均匀缩放
+    static FMatrix4 TranslationRotationZScale(const FVector3& Translation, float AngleRadians, float Scale)
+    {
+        const float C = std::cos(AngleRadians) * Scale;
+        const float S = std::sin(AngleRadians) * Scale;
+
+        FMatrix4 Result;
+        Result.Columns[0] = { C, S, 0.0f, 0.0f };
+        Result.Columns[1] = { -S, C, 0.0f, 0.0f };
+        Result.Columns[2] = { 0.0f, 0.0f, Scale, 0.0f };
+        Result.Columns[3] = FVector4(Translation, 1.0f);
+        return Result;
+    }
+
+    static FMatrix4 LookAt(const FVector3& Eye, const FVector3& Target, const FVector3& Up)
+    {
+        const FVector3 F = (Target - Eye).GetNormalized();
+        const FVector3 S = FVector3::Cross(F, Up).GetNormalized();
+        const FVector3 U = FVector3::Cross(S, F);
+
+        FMatrix4 Result;
+        Result.Columns[0] = { S.X, U.X, -F.X, 0.0f };
+        Result.Columns[1] = { S.Y, U.Y, -F.Y, 0.0f };
+        Result.Columns[2] = { S.Z, U.Z, -F.Z, 0.0f };
+        Result.Columns[3] = { -FVector3::Dot(S, Eye), -FVector3::Dot(U, Eye), FVector3::Dot(F, Eye), 1.0f };
+        return Result;
+    }
+
+    // 右手透视投影，深度 [0, 1] (近 0 远 1)，Y 轴翻转以适配 Vulkan 视口
+    static FMatrix4 Perspective(float FovYRadians, float AspectRatio, float NearZ, float FarZ)
+    {
+        const float F = 1.0f / std::tan(FovYRadians * 0.5f);
+
+        FMatrix4 Result;
+        Result.Columns[0] = { F / AspectRatio, 0.0f, 0.0f, 0.0f };
+        Result.Columns[1] = { 0.0f, -F, 0.0f, 0.0f };
+        Result.Columns[2] = { 0.0f, 0.0f, FarZ / (NearZ - FarZ), -1.0f };
+        Result.Columns[3] = { 0.0f, 0.0f, NearZ * FarZ / (NearZ - FarZ), 0.0f };
+        return Result;
+    }
+};
+
+struct FSphere
+{
+    FVector3 Center;
+    float Radius = 0.0f;
+
+    FSphere TransformedBy(const FMatrix4& M) const { return { M.TransformPoint(Center), Radius * M.GetMaxScale() }; }
+};
+
+// 轴对齐包围盒
+struct FAabb
+{
+    FVector3 Min;
+    FVector3 Max;
+
+    constexpr FVector3 GetCenter() const { return (Min + Max) * 0.5f; }
+    constexpr FVector3 GetExtent() const { return (Max - Min) * 0.5f; }
+
+    // Arvo：新的半尺寸 = |M| * 旧的半尺寸，仍包住变换后的盒子 (不再紧致)
+    FAabb TransformedBy(const FMatrix4& M) const
+    {
+        const FVector3 Center = M.TransformPoint(GetCenter());
+        const FVector3 Extent = GetExtent();
+        auto AbsDot = [&Extent, &M](int Row)
+            {
+                const FVector4 R = M.GetRow(Row);
+                return std::abs(R.X) * Extent.X + std::abs(R.Y) * Extent.Y + std::abs(R.Z) * Extent.Z;
+            };
+        const FVector3 NewExtent{ AbsDot(0), AbsDot(1), AbsDot(2) };
+        return { Center - NewExtent, Center + NewExtent };
+    }
+};
+
+// 平面方程 Dot(Normal, P) + D >= 0 为内侧
+struct FPlane
+{
+    FVector3 Normal;
+    float D = 0.0f;
+
+    float GetSignedDistance(const FVector3& P) const { return FVector3::Dot(Normal, P) + D; }
+};
+
+struct FFrustum
+{
+    enum EPlane { Left, Right, Bottom, Top, Near, Far, Count };
+    FPlane Planes[Count];
+
+    // Gribb-Hartmann：从 ViewProjection 的行组合出六个平面 (Vulkan 深度 [0, 1])
+    static FFrustum FromViewProjection(const FMatrix4& ViewProjection)
+    {
+        const FVector4 Row0 = ViewProjection.GetRow(0);
+        const FVector4 Row1 = ViewProjection.GetRow(1);
+        const FVector4 Row2 = ViewProjection.GetRow(2);
+        const FVector4 Row3 = ViewProjection.GetRow(3);
+
+        auto MakePlane = [](const FVector4& V)
+            {
+                const float InvLength = 1.0f / V.XYZ().Length();
+                return FPlane{ V.XYZ() * InvLength, V.W * InvLength };
+            };
+
+        FFrustum Result;
+        Result.Planes[Left] = MakePlane(Row3 + Row0);
+        Result.Planes[Right] = MakePlane(Row3 - Row0);
+        Result.Planes[Bottom] = MakePlane(Row3 + Row1);
+        Result.Planes[Top] = MakePlane(Row3 - Row1);
+        Result.Planes[Near] = MakePlane(Row2);
+        Result.Planes[Far] = MakePlane(Row3 - Row2);
+        return Result;
+    }
+
+    bool Intersects(const FSphere& Sphere) const
+    {
+        for (const FPlane& Plane : Planes)
+        {
+            if (Plane.GetSignedDistance(Sphere.Center) < -Sphere.Radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 盒子在平面法线方向上的投影半径：中心到平面的距离比它还远 (在外侧) 即不相交
+    bool Intersects(const FAabb& Box) const
+    {
+        const FVector3 Center = Box.GetCenter();
+        const FVector3 Extent = Box.GetExtent();
+        for (const FPlane& Plane : Planes)
+        {
+            const float Radius = std::abs(Plane.Normal.X) * Extent.X + std::abs(Plane.Normal.Y) * Extent.Y + std::abs(Plane.Normal.Z) * Extent.Z;
+            if (Plane.GetSignedDistance(Center) < -Radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+constexpr float PI = 3.14159265358979323846f;
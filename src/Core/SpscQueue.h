@@ -0,0 +1,71 @@
+﻿#pragma once
+#include <atomic>
+
+// 单生产者/单消费者无锁环形队列
+// - 生产者只写 Tail，消费者只写 Head，二者各占一条缓存行避免伪共享
+// - 各自缓存对方索引的副本，只有看起来满/空时才去读原子变量
+// - Capacity 必须是 2 的幂，下标用掩码取模
+template <typename T, size_t Capacity>
+class TSpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    TSpscQueue() = default;
+
+    TSpscQueue(const TSpscQueue&) = delete;
+    TSpscQueue& operator=(const TSpscQueue&) = delete;
+
+    // 生产者线程调用，队列满时返回 false
+    bool TryPush(T InValue)
+    {
+        const size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+        if (CurrentTail - CachedHead >= Capacity)
+        {
+            CachedHead = Head.load(std::memory_order_acquire);
+            if (CurrentTail - CachedHead >= Capacity)
+            {
+                return false;
+            }
+        }
+
+        Slots[CurrentTail & (Capacity - 1)] = std::move(InValue);
+        Tail.store(CurrentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程调用，队列空时返回 false
+    bool TryPop(T& OutValue)
+    {
+        const size_t CurrentHead = Head.load(std::memory_order_relaxed);
+        if (CurrentHead == CachedTail)
+        {
+            CachedTail = Tail.load(std::memory_order_acquire);
+            if (CurrentHead == CachedTail)
+            {
+                return false;
+            }
+        }
+
+        OutValue = std::move(Slots[CurrentHead & (Capacity - 1)]);
+        Head.store(CurrentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值，仅用于统计/调试
+    bool IsEmpty() const
+    {
+        return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire);
+    }
+
+private:
+    // 消费者侧
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> Head = 0;
+    size_t CachedTail = 0;
+
+    // 生产者侧
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> Tail = 0;
+    size_t CachedHead = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> Slots{};
+};
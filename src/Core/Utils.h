@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <fstream>
 #include <filesystem>
+#include <chrono>
 
 namespace Utils
 {
@@ -24,6 +25,13 @@ namespace Utils
         return buffer;
     }
 
+    // Host 单调时钟 (纳秒)，CPU 侧所有计时统一使用
+    inline uint64_t GetTimeNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
     template< typename T >
     static inline void ZeroVulkanStruct(T& structObj, VkStructureType type)
     {
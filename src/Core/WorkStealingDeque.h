@@ -0,0 +1,100 @@
+﻿#pragma once
+#include <atomic>
+
+// Chase-Lev 工作窃取双端队列 (固定容量版本)
+// - 所有者线程在 Bottom 端 Push/Pop (LIFO，缓存友好)
+// - 其它线程在 Top 端 Steal (FIFO，偷走最早、通常也是最大的任务)
+// - 内存序参考 Lê et al. "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13)
+// 满时 Push 返回 false，由调用方就地执行，避免扩容带来的缓冲区回收问题
+template <typename T, size_t Capacity>
+class TWorkStealingDeque
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "Elements are read speculatively by thieves");
+
+public:
+    TWorkStealingDeque() = default;
+
+    TWorkStealingDeque(const TWorkStealingDeque&) = delete;
+    TWorkStealingDeque& operator=(const TWorkStealingDeque&) = delete;
+
+    // 仅所有者线程
+    bool Push(T InItem)
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed);
+        const int64_t Tp = Top.load(std::memory_order_acquire);
+        if (B - Tp >= static_cast<int64_t>(Capacity))
+        {
+            return false;
+        }
+
+        Buffer[B & MASK].store(InItem, std::memory_order_relaxed);
+        // release：窃取者 acquire 读到新 Bottom 时，元素及其指向的 Job 内容均已可见
+        Bottom.store(B + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅所有者线程
+    bool Pop(T& OutItem)
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed) - 1;
+        Bottom.store(B, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t Tp = Top.load(std::memory_order_relaxed);
+
+        if (Tp > B)
+        {
+            // 已空
+            Bottom.store(B + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        OutItem = Buffer[B & MASK].load(std::memory_order_relaxed);
+        if (Tp == B)
+        {
+            // 最后一个元素：与窃取者竞争 Top
+            const bool bWon = Top.compare_exchange_strong(Tp, Tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            Bottom.store(B + 1, std::memory_order_relaxed);
+            return bWon;
+        }
+        return true;
+    }
+
+    // 任意线程
+    bool Steal(T& OutItem)
+    {
+        int64_t Tp = Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t B = Bottom.load(std::memory_order_acquire);
+
+        if (Tp >= B)
+        {
+            return false;
+        }
+
+        T Item = Buffer[Tp & MASK].load(std::memory_order_relaxed);
+        if (!Top.compare_exchange_strong(Tp, Tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            // 被所有者或其它窃取者抢先
+            return false;
+        }
+
+        OutItem = Item;
+        return true;
+    }
+
+    // 近似长度，用于自适应拆分与空闲判断
+    int64_t Size() const
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed);
+        const int64_t Tp = Top.load(std::memory_order_relaxed);
+        return B > Tp ? B - Tp : 0;
+    }
+
+private:
+    static constexpr int64_t MASK = static_cast<int64_t>(Capacity) - 1;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> Top = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> Bottom = 0;
+    alignas(CACHE_LINE_SIZE) std::array<std::atomic<T>, Capacity> Buffer{};
+};
@@ -1,5 +1,51 @@
 ﻿#pragma once
 
+// 交换链呈现策略
+// PresentModes 按优先级排列，选用第一个被 Surface 支持的模式；全部不支持时回退 FIFO
+struct FPresentPolicy
+{
+    std::vector<RHIPresentMode> PresentModes = { RHIPresentMode::Mailbox, RHIPresentMode::Fifo };
+    bool bPreferSRGB = true;    // false 时优先 UNORM (着色器自行做 Gamma)
+
+    // 解析 "immediate,mailbox,fifo" 形式的列表，未知名字返回 std::nullopt
+    static std::optional<FPresentPolicy> ParseModes(std::string_view InList)
+    {
+        FPresentPolicy Policy;
+        Policy.PresentModes.clear();
+
+        while (!InList.empty())
+        {
+            size_t Comma = InList.find(',');
+            std::string_view Name = InList.substr(0, Comma);
+            InList = Comma == std::string_view::npos ? std::string_view() : InList.substr(Comma + 1);
+
+            if (Name == "immediate")         Policy.PresentModes.push_back(RHIPresentMode::Immediate);
+            else if (Name == "mailbox")      Policy.PresentModes.push_back(RHIPresentMode::Mailbox);
+            else if (Name == "fifo")         Policy.PresentModes.push_back(RHIPresentMode::Fifo);
+            else if (Name == "fifo_relaxed") Policy.PresentModes.push_back(RHIPresentMode::FifoRelaxed);
+            else return std::nullopt;
+        }
+
+        if (Policy.PresentModes.empty())
+        {
+            return std::nullopt;
+        }
+        return Policy;
+    }
+
+    static const char* ToString(RHIPresentMode Mode)
+    {
+        switch (Mode)
+        {
+        case RHIPresentMode::Immediate:   return "Immediate";
+        case RHIPresentMode::Mailbox:     return "Mailbox";
+        case RHIPresentMode::Fifo:        return "FIFO";
+        case RHIPresentMode::FifoRelaxed: return "FIFO Relaxed";
+        }
+        return "Unknown";
+    }
+};
+
 class FRHISwapchain {
 public:
     virtual ~FRHISwapchain() = default;
@@ -10,6 +56,9 @@ public:
 
     virtual bool Present(uint32_t ImageIndex, void* InWaitSemaphore) = 0;
 
+    // 仅记录策略，下一次 Resize/Create 时生效
+    virtual void SetPresentPolicy(const FPresentPolicy& InPolicy) = 0;
+
     virtual RHIFormat GetFormat() const = 0;
     virtual RHIExtent2D GetExtent() const = 0;
     virtual uint32_t GetImageCount() const = 0;
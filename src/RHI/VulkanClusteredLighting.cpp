@@ -0,0 +1,395 @@
+﻿#include "VulkanClusteredLighting.h"
+#include "VulkanDevice.h"
+#include "Renderer/FramePacket.h"
+
+namespace {
+    enum EBinding : uint32_t
+    {
+        BINDING_LIGHTS = 0,
+        BINDING_CLUSTER_LIGHTS,
+        BINDING_LIGHT_INDICES,
+        BINDING_COUNTERS,
+        BINDING_CLUSTER_DATA,
+        BINDING_COUNT,
+    };
+
+    // 计数器下标，与 ClusteredLighting.hlsli 一致
+    enum ECounter : uint32_t
+    {
+        COUNTER_LIGHT_INDICES = 0,
+        COUNTER_OVERFLOW_CLUSTERS,
+        COUNTER_COUNT,
+    };
+
+    // 布局与 ClusteredLighting.hlsli 中 FClusterData 一致 (std140)，网格参数原样放在最前
+    struct FClusterData
+    {
+        FLightClusterGrid Grid;
+        uint32_t LightCount;
+        uint32_t IndexCapacity;
+        uint32_t Padding[2];
+    };
+    static_assert(sizeof(FLightClusterGrid) == 32, "FLightClusterGrid layout must match FClusterData");
+    static_assert(sizeof(FClusterData) == 48, "FClusterData layout must match ClusteredLighting.hlsli");
+
+    // 光源直接按帧包中的内存布局上传，与着色器中 FGpuLight 一致
+    static_assert(sizeof(FPointLight) == 32 && offsetof(FPointLight, Color) == 16, "FPointLight layout must match FGpuLight");
+
+    uint32_t RoundUpPowerOfTwo(uint32_t Value)
+    {
+        uint32_t Result = 1;
+        while (Result < Value)
+        {
+            Result <<= 1;
+        }
+        return Result;
+    }
+}
+
+FVulkanClusteredLighting::FVulkanClusteredLighting(FVulkanDevice& InDevice)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator())
+{
+    CreateDescriptors();
+    CreateBuildPipeline();
+    CreateTimestampQueries();
+    for (FFrameResources& Frame : Frames)
+    {
+        CreateFrame(Frame);
+    }
+
+    CA_LOG_INFO("ClusteredLighting", "Clustered forward lighting enabled ({}x{}x{} clusters, {} light indices per frame).",
+        FLightClusterGrid::TILE_COUNT_X, FLightClusterGrid::TILE_COUNT_Y, FLightClusterGrid::SLICE_COUNT, INDEX_CAPACITY);
+}
+
+FVulkanClusteredLighting::~FVulkanClusteredLighting()
+{
+    for (FFrameResources& Frame : Frames)
+    {
+        DestroyFrame(Frame);
+    }
+
+    if (TimestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(LogicalDevice, TimestampQueryPool, nullptr);
+    }
+    if (BuildPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(LogicalDevice, BuildPipeline, nullptr);
+    }
+    if (BuildPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, BuildPipelineLayout, nullptr);
+    }
+    if (DescriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(LogicalDevice, DescriptorPool, nullptr);
+    }
+    if (DescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(LogicalDevice, DescriptorSetLayout, nullptr);
+    }
+}
+
+FVulkanClusteredLighting::FBuffer FVulkanClusteredLighting::CreateBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, VmaAllocationCreateFlags Flags) const
+{
+    VkBufferCreateInfo BufferInfo{};
+    Utils::ZeroVulkanStruct(BufferInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    BufferInfo.size = Size;
+    BufferInfo.usage = Usage;
+    BufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    AllocInfo.flags = Flags;
+
+    FBuffer Result;
+    VmaAllocationInfo AllocationInfo{};
+    if (vmaCreateBuffer(Allocator, &BufferInfo, &AllocInfo, &Result.Buffer, &Result.Allocation, &AllocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create clustered lighting buffer!");
+    }
+    Result.Mapped = AllocationInfo.pMappedData;
+    return Result;
+}
+
+void FVulkanClusteredLighting::DestroyBuffer(FBuffer& InBuffer) const
+{
+    if (InBuffer.Buffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator, InBuffer.Buffer, InBuffer.Allocation);
+    }
+    InBuffer = FBuffer();
+}
+
+void FVulkanClusteredLighting::CreateDescriptors()
+{
+    // 计数只有分簇阶段使用，其余绑定前向着色的片元阶段也要读取
+    VkDescriptorSetLayoutBinding Bindings[BINDING_COUNT]{};
+    for (uint32_t i = 0; i < BINDING_COUNT; i++)
+    {
+        Bindings[i].binding = i;
+        Bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        Bindings[i].descriptorCount = 1;
+        Bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+    Bindings[BINDING_CLUSTER_DATA].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    Bindings[BINDING_COUNTERS].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo LayoutInfo{};
+    Utils::ZeroVulkanStruct(LayoutInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
+    LayoutInfo.bindingCount = BINDING_COUNT;
+    LayoutInfo.pBindings = Bindings;
+    if (vkCreateDescriptorSetLayout(LogicalDevice, &LayoutInfo, nullptr, &DescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create clustered lighting descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize PoolSizes[2]{};
+    PoolSizes[0] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (BINDING_COUNT - 1) * MAX_FRAMES_IN_FLIGHT };
+    PoolSizes[1] = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT };
+
+    VkDescriptorPoolCreateInfo PoolInfo{};
+    Utils::ZeroVulkanStruct(PoolInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO);
+    PoolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    PoolInfo.poolSizeCount = static_cast<uint32_t>(std::size(PoolSizes));
+    PoolInfo.pPoolSizes = PoolSizes;
+    if (vkCreateDescriptorPool(LogicalDevice, &PoolInfo, nullptr, &DescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create clustered lighting descriptor pool!");
+    }
+
+    // 描述符集常驻，光源缓冲扩容时只重写对应绑定
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> Layouts;
+    Layouts.fill(DescriptorSetLayout);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> Sets;
+
+    VkDescriptorSetAllocateInfo AllocInfo{};
+    Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO);
+    AllocInfo.descriptorPool = DescriptorPool;
+    AllocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    AllocInfo.pSetLayouts = Layouts.data();
+    if (vkAllocateDescriptorSets(LogicalDevice, &AllocInfo, Sets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate clustered lighting descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        Frames[i].DescriptorSet = Sets[i];
+    }
+}
+
+void FVulkanClusteredLighting::CreateBuildPipeline()
+{
+    VkPipelineLayoutCreateInfo PipelineLayoutInfo{};
+    Utils::ZeroVulkanStruct(PipelineLayoutInfo, VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO);
+    PipelineLayoutInfo.setLayoutCount = 1;
+    PipelineLayoutInfo.pSetLayouts = &DescriptorSetLayout;
+    if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &BuildPipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create clustered lighting pipeline layout!");
+    }
+
+    VkPipelineShaderStageCreateInfo StageInfo{};
+    Utils::ZeroVulkanStruct(StageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
+    StageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    StageInfo.module = DeviceRef.CreateShaderModule(Utils::ReadSPV("LightClustering.comp.spv"));
+    StageInfo.pName = "CSMain";
+
+    VkComputePipelineCreateInfo PipelineInfo{};
+    Utils::ZeroVulkanStruct(PipelineInfo, VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO);
+    PipelineInfo.stage = StageInfo;
+    PipelineInfo.layout = BuildPipelineLayout;
+    PipelineInfo.basePipelineIndex = -1;
+
+    VkResult Result = vkCreateComputePipelines(LogicalDevice, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &BuildPipeline);
+    vkDestroyShaderModule(LogicalDevice, StageInfo.module, nullptr);
+    if (Result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create clustered lighting pipeline!");
+    }
+}
+
+void FVulkanClusteredLighting::WriteBufferDescriptor(const FFrameResources& Frame, uint32_t Binding, const FBuffer& InBuffer) const
+{
+    VkDescriptorBufferInfo BufferInfo{ InBuffer.Buffer, 0, VK_WHOLE_SIZE };
+
+    VkWriteDescriptorSet Write{};
+    Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+    Write.dstSet = Frame.DescriptorSet;
+    Write.dstBinding = Binding;
+    Write.descriptorCount = 1;
+    Write.descriptorType = Binding == BINDING_CLUSTER_DATA ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    Write.pBufferInfo = &BufferInfo;
+    vkUpdateDescriptorSets(LogicalDevice, 1, &Write, 0, nullptr);
+}
+
+void FVulkanClusteredLighting::CreateTimestampQueries()
+{
+    VkPhysicalDeviceProperties Props;
+    vkGetPhysicalDeviceProperties(DeviceRef.GetPhysicalDevice(), &Props);
+    TimestampPeriod = Props.limits.timestampPeriod;
+
+    uint32_t QueueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(DeviceRef.GetPhysicalDevice(), &QueueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(DeviceRef.GetPhysicalDevice(), &QueueFamilyCount, QueueFamilies.data());
+
+    // 构建耗时只用于统计，不支持时不计时
+    const uint32_t ValidBits = QueueFamilies[DeviceRef.GetQueueFamilyIndices().GraphicsFamily.value()].timestampValidBits;
+    if (ValidBits == 0)
+    {
+        CA_LOG_WARN("ClusteredLighting", "Graphics queue does not support timestamps, light build time is not measured.");
+        return;
+    }
+    TimestampMask = ValidBits >= 64 ? ~0ull : ((1ull << ValidBits) - 1);
+
+    VkQueryPoolCreateInfo QueryPoolInfo{};
+    Utils::ZeroVulkanStruct(QueryPoolInfo, VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO);
+    QueryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    QueryPoolInfo.queryCount = 2 * MAX_FRAMES_IN_FLIGHT;
+    if (vkCreateQueryPool(LogicalDevice, &QueryPoolInfo, nullptr, &TimestampQueryPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create clustered lighting timestamp query pool!");
+    }
+}
+
+void FVulkanClusteredLighting::CreateFrame(FFrameResources& Frame)
+{
+    // 每簇区间与索引表只在 GPU 上读写，大小与光源数无关
+    constexpr VmaAllocationCreateFlags UploadFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    Frame.ClusterLights = CreateBuffer(sizeof(FLightCluster) * FLightClusterGrid::CLUSTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0);
+    Frame.LightIndices = CreateBuffer(sizeof(uint32_t) * INDEX_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0);
+    Frame.Counters = CreateBuffer(sizeof(uint32_t) * COUNTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    Frame.ClusterData = CreateBuffer(sizeof(FClusterData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, UploadFlags);
+
+    WriteBufferDescriptor(Frame, BINDING_CLUSTER_LIGHTS, Frame.ClusterLights);
+    WriteBufferDescriptor(Frame, BINDING_LIGHT_INDICES, Frame.LightIndices);
+    WriteBufferDescriptor(Frame, BINDING_COUNTERS, Frame.Counters);
+    WriteBufferDescriptor(Frame, BINDING_CLUSTER_DATA, Frame.ClusterData);
+    ResizeLights(Frame, MIN_LIGHT_CAPACITY);
+}
+
+void FVulkanClusteredLighting::ResizeLights(FFrameResources& Frame, uint32_t Capacity)
+{
+    DestroyBuffer(Frame.Lights);
+    Frame.Lights = CreateBuffer(sizeof(FPointLight) * Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    Frame.LightCapacity = Capacity;
+    WriteBufferDescriptor(Frame, BINDING_LIGHTS, Frame.Lights);
+}
+
+void FVulkanClusteredLighting::DestroyFrame(FFrameResources& Frame)
+{
+    DestroyBuffer(Frame.Lights);
+    DestroyBuffer(Frame.ClusterLights);
+    DestroyBuffer(Frame.LightIndices);
+    DestroyBuffer(Frame.Counters);
+    DestroyBuffer(Frame.ClusterData);
+    Frame.LightCapacity = 0;
+    Frame.bSubmitted = false;
+}
+
+FClusteredLightingStats FVulkanClusteredLighting::BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet)
+{
+    FFrameResources& Frame = Frames[FrameSlot];
+
+    FClusteredLightingStats Stats;
+    if (Frame.bSubmitted)
+    {
+        vmaInvalidateAllocation(Allocator, Frame.Counters.Allocation, 0, VK_WHOLE_SIZE);
+        const uint32_t* Values = static_cast<const uint32_t*>(Frame.Counters.Mapped);
+        Stats.LightIndexCount = std::min(Values[COUNTER_LIGHT_INDICES], INDEX_CAPACITY);
+        Stats.OverflowClusters = Values[COUNTER_OVERFLOW_CLUSTERS];
+        if (Stats.OverflowClusters > 0 && !bOverflowReported)
+        {
+            CA_LOG_WARN("ClusteredLighting", "Light index list overflow: {} indices requested, {} clusters truncated.",
+                Values[COUNTER_LIGHT_INDICES], Stats.OverflowClusters);
+            bOverflowReported = true;
+        }
+
+        // 帧槽的 Timeline 已等待，时间戳已经可用，不需要 WAIT
+        uint64_t Timestamps[2] = {};
+        if (TimestampQueryPool != VK_NULL_HANDLE
+            && vkGetQueryPoolResults(LogicalDevice, TimestampQueryPool, FrameSlot * 2, 2, sizeof(Timestamps), Timestamps,
+                sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            const uint64_t Ticks = ((Timestamps[1] & TimestampMask) - (Timestamps[0] & TimestampMask)) & TimestampMask;
+            Stats.BuildGpuNs = static_cast<uint64_t>(static_cast<double>(Ticks) * TimestampPeriod);
+        }
+    }
+
+    const uint32_t LightCount = static_cast<uint32_t>(Packet.Lights.size());
+    if (LightCount > Frame.LightCapacity)
+    {
+        const uint32_t NewCapacity = RoundUpPowerOfTwo(LightCount);
+        CA_LOG_INFO("ClusteredLighting", "Frame slot {} grows to {} lights.", FrameSlot, NewCapacity);
+        ResizeLights(Frame, NewCapacity);
+    }
+
+    // 光源在这里变换到观察空间：分簇与着色都在观察空间进行，GPU 上不再逐簇重复变换
+    FPointLight* Lights = static_cast<FPointLight*>(Frame.Lights.Mapped);
+    for (uint32_t i = 0; i < LightCount; i++)
+    {
+        Lights[i] = Packet.Lights[i];
+        Lights[i].Position = Packet.View.TransformPoint(Packet.Lights[i].Position);
+    }
+    vmaFlushAllocation(Allocator, Frame.Lights.Allocation, 0, sizeof(FPointLight) * LightCount);
+
+    FClusterData* ClusterData = static_cast<FClusterData*>(Frame.ClusterData.Mapped);
+    ClusterData->Grid = FLightClusterGrid::FromProjection(Packet.Projection, Packet.ViewportWidth, Packet.ViewportHeight);
+    ClusterData->LightCount = LightCount;
+    ClusterData->IndexCapacity = INDEX_CAPACITY;
+    vmaFlushAllocation(Allocator, Frame.ClusterData.Allocation, 0, VK_WHOLE_SIZE);
+
+    Frame.bSubmitted = true;
+    return Stats;
+}
+
+void FVulkanClusteredLighting::RecordBuild(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+
+    if (TimestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdResetQueryPool(InCommandBuffer, TimestampQueryPool, FrameSlot * 2, 2);
+        vkCmdWriteTimestamp2(InCommandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, TimestampQueryPool, FrameSlot * 2);
+    }
+
+    // 1. 清零计数
+    vkCmdFillBuffer(InCommandBuffer, Frame.Counters.Buffer, 0, VK_WHOLE_SIZE, 0);
+
+    VkMemoryBarrier2 ClearBarrier{};
+    Utils::ZeroVulkanStruct(ClearBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    ClearBarrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    ClearBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    ClearBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ClearBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &ClearBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    // 2. 每个线程一个簇；光源为 0 时仍然执行，把所有簇的计数写成 0
+    vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, BuildPipeline);
+    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, BuildPipelineLayout, 0, 1, &Frame.DescriptorSet, 0, nullptr);
+    vkCmdDispatch(InCommandBuffer, (FLightClusterGrid::CLUSTER_COUNT + BUILD_GROUP_SIZE - 1) / BUILD_GROUP_SIZE, 1, 1);
+
+    if (TimestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdWriteTimestamp2(InCommandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, TimestampQueryPool, FrameSlot * 2 + 1);
+    }
+
+    // 3. 每簇区间与索引表对前向着色可见；计数同时供帧槽复用时 Host 回读
+    VkMemoryBarrier2 BuildBarrier{};
+    Utils::ZeroVulkanStruct(BuildBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    BuildBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    BuildBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    BuildBarrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_HOST_BIT;
+    BuildBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_HOST_READ_BIT;
+    DependencyInfo.pMemoryBarriers = &BuildBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
@@ -0,0 +1,96 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+#include "Renderer/LightClustering.h"
+
+class FVulkanDevice;
+struct FFramePacket;
+
+// 分簇统计 (来自该帧槽上一轮的回读)
+struct FClusteredLightingStats
+{
+    uint32_t LightIndexCount = 0;   // 所有簇的光源列表总长 (不超过索引表容量)
+    uint32_t OverflowClusters = 0;  // 索引表写满后被截断的簇
+    uint64_t BuildGpuNs = 0;        // 清零计数 + 分簇 Dispatch 的 GPU 耗时 (队列不支持时间戳时为 0)
+};
+
+// 分簇前向光照：每帧由计算着色器把光源分配到 FLightClusterGrid 的各个簇，前向着色只循环片元所在簇的光源
+// - 每个飞行帧一组缓冲与描述符集：光源 (Host 写入观察空间坐标，按 2 的幂扩容)、每簇的 (Offset, Count)、
+//   压缩索引表、计数与分簇参数
+// - 索引表按每簇平均 AVERAGE_LIGHTS_PER_CLUSTER 个预留，写满后的簇被截断并计入统计
+// - 计数留在 Host 可读的缓冲中，帧槽复用时回读 (比当前帧晚 MAX_FRAMES_IN_FLIGHT 帧)
+// - 每个帧槽一对时间戳包住分簇，与计数一起回读：不依赖 --profiler 也能在统计中给出构建耗时
+// 同一个描述符集既是分簇计算管线的 set 0，也被前向着色的管线布局引用 (CPU 绘制列表为 set 0，GPU 驱动为 set 1)
+class FVulkanClusteredLighting
+{
+public:
+    // 与 LightClustering.hlsl 中 numthreads 一致
+    static constexpr uint32_t BUILD_GROUP_SIZE = 64;
+    static constexpr uint32_t MIN_LIGHT_CAPACITY = 256;
+    static constexpr uint32_t AVERAGE_LIGHTS_PER_CLUSTER = 32;
+    static constexpr uint32_t INDEX_CAPACITY = FLightClusterGrid::CLUSTER_COUNT * AVERAGE_LIGHTS_PER_CLUSTER;
+
+    explicit FVulkanClusteredLighting(FVulkanDevice& InDevice);
+    ~FVulkanClusteredLighting();
+
+    FVulkanClusteredLighting(const FVulkanClusteredLighting&) = delete;
+    FVulkanClusteredLighting& operator=(const FVulkanClusteredLighting&) = delete;
+
+    // 光源 / 每簇区间 / 索引表 / 计数 / 分簇参数，计算与片元阶段可见
+    VkDescriptorSetLayout GetDescriptorSetLayout() const { return DescriptorSetLayout; }
+    VkDescriptorSet GetDescriptorSet(uint32_t FrameSlot) const { return Frames[FrameSlot].DescriptorSet; }
+
+    // 帧槽的 Timeline 值已被等待之后调用：回读该槽上一轮的统计，把本帧光源变换到观察空间上传并写好分簇参数
+    FClusteredLightingStats BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet);
+
+    // 渲染 Pass 之外录制：清零计数 -> 分簇 -> 屏障 (片元着色器读取、Host 回读)
+    void RecordBuild(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot);
+
+private:
+    struct FBuffer
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VmaAllocation Allocation = VK_NULL_HANDLE;
+        void* Mapped = nullptr;
+    };
+
+    struct FFrameResources
+    {
+        FBuffer Lights;         // FPointLight[] (观察空间)，Host 每帧写入
+        FBuffer ClusterLights;  // 每簇 (Offset, Count)，计算着色器写入
+        FBuffer LightIndices;   // INDEX_CAPACITY 个光源序号
+        FBuffer Counters;       // 索引总数与溢出的簇数，计算着色器原子累加，Host 回读
+        FBuffer ClusterData;    // 本帧分簇参数 (Uniform)
+        VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+        uint32_t LightCapacity = 0;
+        bool bSubmitted = false;
+    };
+
+    FBuffer CreateBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, VmaAllocationCreateFlags Flags) const;
+    void DestroyBuffer(FBuffer& InBuffer) const;
+
+    void CreateDescriptors();
+    void CreateBuildPipeline();
+    void CreateTimestampQueries();
+    void CreateFrame(FFrameResources& Frame);
+    // 销毁并按新容量重建该帧槽的光源缓冲，重写描述符
+    void ResizeLights(FFrameResources& Frame, uint32_t Capacity);
+    void DestroyFrame(FFrameResources& Frame);
+    void WriteBufferDescriptor(const FFrameResources& Frame, uint32_t Binding, const FBuffer& InBuffer) const;
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout BuildPipelineLayout = VK_NULL_HANDLE;
+    VkPipeline BuildPipeline = VK_NULL_HANDLE;
+
+    // 每个帧槽 2 个 (开始 / 结束)；图形队列不支持时间戳时为空
+    VkQueryPool TimestampQueryPool = VK_NULL_HANDLE;
+    float TimestampPeriod = 1.0f;  // 每个 GPU Tick 对应的纳秒数
+    uint64_t TimestampMask = ~0ull;
+
+    std::array<FFrameResources, MAX_FRAMES_IN_FLIGHT> Frames;
+    bool bOverflowReported = false;
+};
@@ -0,0 +1,116 @@
+﻿#include "VulkanDepthTarget.h"
+#include "VulkanDevice.h"
+
+namespace {
+    VkImageAspectFlags GetDepthAspectMask(VkFormat InFormat)
+    {
+        switch (InFormat)
+        {
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+    }
+}
+
+FVulkanDepthTarget::FVulkanDepthTarget(FVulkanDevice& InDevice, VkFormat InFormat, VkImageUsageFlags InExtraUsage)
+    : LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator()), Format(InFormat),
+    Usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | InExtraUsage), AspectMask(GetDepthAspectMask(InFormat))
+{
+}
+
+FVulkanDepthTarget::~FVulkanDepthTarget()
+{
+    // 调用方已等待设备空闲
+    Retire(0);
+    CollectRetired(UINT64_MAX);
+}
+
+bool FVulkanDepthTarget::Resize(VkExtent2D InExtent, uint64_t RetireValue)
+{
+    if (Image != VK_NULL_HANDLE && InExtent.width == Extent.width && InExtent.height == Extent.height)
+    {
+        return false;
+    }
+
+    Retire(RetireValue);
+    Extent = InExtent;
+
+    VkImageCreateInfo ImageInfo{};
+    Utils::ZeroVulkanStruct(ImageInfo, VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO);
+    ImageInfo.imageType = VK_IMAGE_TYPE_2D;
+    ImageInfo.format = Format;
+    ImageInfo.extent = { Extent.width, Extent.height, 1 };
+    ImageInfo.mipLevels = 1;
+    ImageInfo.arrayLayers = 1;
+    ImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    ImageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    ImageInfo.usage = Usage;
+    ImageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    ImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    // 渲染目标随窗口尺寸反复重建，单独一块内存，避免在大块内存中留下碎片
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    AllocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+    VmaAllocationInfo AllocationInfo{};
+    if (vmaCreateImage(Allocator, &ImageInfo, &AllocInfo, &Image, &Allocation, &AllocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create depth image!");
+    }
+
+    VkImageViewCreateInfo ViewInfo{};
+    Utils::ZeroVulkanStruct(ViewInfo, VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO);
+    ViewInfo.image = Image;
+    ViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    ViewInfo.format = Format;
+    // 作为 Sampled Image 时只能读取深度分量
+    ViewInfo.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+    if (vkCreateImageView(LogicalDevice, &ViewInfo, nullptr, &View) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create depth image view!");
+    }
+
+    CA_LOG_INFO("DepthTarget", "Depth target {}x{} ({} KB).", Extent.width, Extent.height, AllocationInfo.size / 1024);
+    return true;
+}
+
+void FVulkanDepthTarget::Retire(uint64_t RetireValue)
+{
+    if (Image == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    RetiredImages.push_back({ Image, Allocation, View, RetireValue });
+    Image = VK_NULL_HANDLE;
+    Allocation = VK_NULL_HANDLE;
+    View = VK_NULL_HANDLE;
+}
+
+void FVulkanDepthTarget::CollectRetired(uint64_t CompletedValue)
+{
+    std::erase_if(RetiredImages, [&](FRetiredImage& Retired)
+        {
+            if (CompletedValue < Retired.RetireValue)
+            {
+                return false;
+            }
+            DestroyRetired(Retired);
+            return true;
+        });
+}
+
+void FVulkanDepthTarget::DestroyRetired(FRetiredImage& Retired)
+{
+    if (Retired.View != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(LogicalDevice, Retired.View, nullptr);
+    }
+    vmaDestroyImage(Allocator, Retired.Image, Retired.Allocation);
+    Retired = FRetiredImage();
+}
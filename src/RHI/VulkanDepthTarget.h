@@ -0,0 +1,56 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+
+class FVulkanDevice;
+
+// 深度渲染目标：通过 VMA 独立分配 (Dedicated)，尺寸跟随交换链
+// 只有一份，由所有飞行帧共用：每帧开始时以 UNDEFINED 布局转换并清空
+// 重建不等待飞行帧：旧图像带上最后使用它的 Timeline 值退休，由 CollectRetired 在该值完成后回收
+class FVulkanDepthTarget
+{
+public:
+    // InExtraUsage: 除深度附件外的用途 (如 Hi-Z 构建需要 SAMPLED)
+    FVulkanDepthTarget(FVulkanDevice& InDevice, VkFormat InFormat, VkImageUsageFlags InExtraUsage);
+    ~FVulkanDepthTarget();
+
+    FVulkanDepthTarget(const FVulkanDepthTarget&) = delete;
+    FVulkanDepthTarget& operator=(const FVulkanDepthTarget&) = delete;
+
+    // 尺寸相同时什么也不做；返回是否重建了图像
+    // RetireValue: 已提交帧中最后一帧的 Timeline 值，旧图像在它完成之前保留
+    bool Resize(VkExtent2D InExtent, uint64_t RetireValue);
+    void CollectRetired(uint64_t CompletedValue);
+    size_t GetRetiredCount() const { return RetiredImages.size(); }
+
+    VkImage GetImage() const { check(Image != VK_NULL_HANDLE); return Image; }
+    VkImageView GetView() const { check(View != VK_NULL_HANDLE); return View; }
+    VkExtent2D GetExtent() const { return Extent; }
+    VkFormat GetFormat() const { return Format; }
+    VkImageAspectFlags GetAspectMask() const { return AspectMask; }
+
+private:
+    struct FRetiredImage
+    {
+        VkImage Image = VK_NULL_HANDLE;
+        VmaAllocation Allocation = VK_NULL_HANDLE;
+        VkImageView View = VK_NULL_HANDLE;
+        uint64_t RetireValue = 0;
+    };
+
+    void Retire(uint64_t RetireValue);
+    void DestroyRetired(FRetiredImage& Retired);
+
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+
+    const VkFormat Format;
+    const VkImageUsageFlags Usage;
+    const VkImageAspectFlags AspectMask;
+
+    VkImage Image = VK_NULL_HANDLE;
+    VmaAllocation Allocation = VK_NULL_HANDLE;
+    VkImageView View = VK_NULL_HANDLE;
+    VkExtent2D Extent{};
+
+    std::vector<FRetiredImage> RetiredImages;
+};
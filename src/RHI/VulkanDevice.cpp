@@ -2,6 +2,9 @@
 #include "vk_mem_alloc.h"
 #include "VulkanSwapchain.h"
 #include "VulkanDevice.h"
+#include "Renderer/FramePacket.h"
+#include "Renderer/MeshAsset.h"
+#include "Renderer/MeshOptimizer.h"
 
 namespace { // 匿名命名空间，相当于 C 语言的 static 全局变量，只在当前文件可见
     const std::vector<const char*> ValidationLayers =
@@ -14,6 +17,31 @@ namespace { // 匿名命名空间，相当于 C 语言的 static 全局变量，
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
     };
 
+    // 可选扩展：不支持时对应功能自动降级
+    const std::vector<const char*> OptionalDeviceExtensions =
+    {
+        VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME,
+        VK_KHR_PRESENT_ID_EXTENSION_NAME,
+        VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+        VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME,
+        VK_EXT_MESH_SHADER_EXTENSION_NAME,
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+    };
+
+    // 主 Pass 深度格式，管线与深度缓冲共用
+    constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+
+    // 网格簇渲染的演示网格：外径 0.65，与场景实例的包围球 (FScene::INSTANCE_BOUNDING_RADIUS) 相当
+    constexpr float MESHLET_TORUS_MAJOR_RADIUS = 0.45f;
+    constexpr float MESHLET_TORUS_MINOR_RADIUS = 0.2f;
+
+    // 可选 Instance 扩展：swapchain_maintenance1 依赖 surface_maintenance1
+    const std::vector<const char*> OptionalInstanceExtensions =
+    {
+        VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME,
+        VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME,
+    };
+
     // 1. 代理函数 (Proxy Functions)
     VkResult CreateDebugUtilsMessengerEXT(VkInstance Ininstance, const VkDebugUtilsMessengerCreateInfoEXT* InCreateInfo, const VkAllocationCallbacks* InAllocator, VkDebugUtilsMessengerEXT* InDebugMessenger)
     {
@@ -44,10 +72,18 @@ namespace { // 匿名命名空间，相当于 C 语言的 static 全局变量，
         const VkDebugUtilsMessengerCallbackDataEXT* InCallbackData,
         void* pUserData)
     {
-
-        if (InMessageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+        // 回调可能发生在任意线程、任意 Vulkan 调用内部，只做入队
+        if (InMessageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT)
+        {
+            CA_LOG_ERROR("Validation", "{}", InCallbackData->pMessage);
+        }
+        else if (InMessageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
         {
-            std::cerr << "validation layer: " << InCallbackData->pMessage << std::endl;
+            CA_LOG_WARN("Validation", "{}", InCallbackData->pMessage);
+        }
+        else
+        {
+            CA_LOG_VERBOSE("Validation", "{}", InCallbackData->pMessage);
         }
         return VK_FALSE;
     }
@@ -77,21 +113,140 @@ void FVulkanDevice::Init()
     CreateLogicalDevice();
 
     CreateAllocator();
+    StagingUploader = std::make_unique<FVulkanStagingUploader>(*this);
 
-    Swapchain = std::make_unique<FVulkanSwapchain>(WINDOW_DEFAULT_WIDTH, WINDOW_DEFAULT_HEIGHT, *this, WindowRef);
+    int Width = 0, Height = 0;
+    WindowRef.GetDrawableSize(Width, Height);
+    Swapchain = std::make_unique<FVulkanSwapchain>(static_cast<uint32_t>(Width), static_cast<uint32_t>(Height), *this, WindowRef, PresentPolicy);
+
+    // 纹理流送的描述符集是网格簇管线布局的第二个集合，要先于网格簇渲染创建
+    if (bMeshletRenderingRequested && !TextureDirectory.empty() && bTextureStreamingSupported)
+    {
+        TextureStreamer = std::make_unique<FVulkanTextureStreamer>(*this, TextureDirectory, TextureStreamingConfig);
+    }
+    const VkDescriptorSetLayout TextureSetLayout = TextureStreamer ? TextureStreamer->GetDescriptorSetLayout() : VK_NULL_HANDLE;
+    const uint32_t TextureCount = TextureStreamer ? TextureStreamer->GetTextureCount() : 0;
+
+    if (bMeshletRenderingRequested && !MeshAssetPath.empty())
+    {
+        // 离线导入的资源：映射文件，各段直接交给暂存上传器，CPU 只做头部校验与一次 memcpy
+        const uint64_t BeginNs = Utils::GetTimeNs();
+        const FMeshAsset Asset(MeshAssetPath);
+        MeshletRenderer = std::make_unique<FVulkanMeshletRenderer>(*this, Asset.GetMeshletGeometry(), bMeshShaderSupported,
+            TextureSetLayout, TextureCount);
+
+        const double Seconds = (Utils::GetTimeNs() - BeginNs) / 1e9;
+        const double Megabytes = Asset.GetFileSize() / (1024.0 * 1024.0);
+        CA_LOG_INFO("MeshAsset", "Loaded {}: {} MB in {} ms ({} MB/s).", MeshAssetPath.string(), Megabytes, Seconds * 1e3,
+            Seconds > 0.0 ? Megabytes / Seconds : 0.0);
+    }
+    else if (bMeshletRenderingRequested)
+    {
+        // 未指定资源：用细分的圆环代替高面数网格，启动时走一遍与导入相同的处理 (含 LOD 链)
+        FMeshData Mesh = MeshUtils::CreateTorus(MESHLET_TORUS_MAJOR_RADIUS, MESHLET_TORUS_MINOR_RADIUS, 96, 48);
+        MeshOptimizer::Optimize(Mesh);
+        const FMeshletData Meshlets = MeshletBuilder::BuildLods(Mesh);
+        const FPackedMeshData PackedVertices = MeshUtils::Quantize(Mesh.Vertices);
+        MeshletRenderer = std::make_unique<FVulkanMeshletRenderer>(*this, MeshletBuilder::MakeGeometry(Mesh, PackedVertices, Meshlets), bMeshShaderSupported,
+            TextureSetLayout, TextureCount);
+    }
+    else if (bGpuCullingRequested && bGpuCullingSupported)
+    {
+        GpuCulling = std::make_unique<FVulkanGpuCulling>(*this, bOcclusionCullingRequested);
+    }
+    // 光照描述符集是三角形管线布局的一部分，要先于管线布局创建
+    if (bClusteredLightingRequested && !MeshletRenderer)
+    {
+        ClusteredLighting = std::make_unique<FVulkanClusteredLighting>(*this);
+    }
+    // Hi-Z 构建以 Sampled Image 读取深度
+    DepthTarget = std::make_unique<FVulkanDepthTarget>(*this, DEPTH_FORMAT, VK_IMAGE_USAGE_SAMPLED_BIT);
+    ResizeDepthTarget();
 
     CreatePipelineLayout();
-    CreateGraphicsPipeline();
+    CreateGraphicsPipelines();
     CreateCommandPool();
     CreateCommandBuffers();
 
     CreateSyncObjects();
+
+    // 时间线只用于分析：图形队列不支持时间戳时不创建，其余逻辑都允许 Profiler 为空
+    if (bEnableTimelineProfiler)
+    {
+        if (FVulkanProfiler::IsSupported(*this))
+        {
+            Profiler = std::make_unique<FVulkanProfiler>(*this);
+        }
+        else
+        {
+            CA_LOG_WARN("Profiler", "Graphics queue does not support timestamps, timeline profiler disabled.");
+        }
+    }
+
+    FramePacer = std::make_unique<FVulkanFramePacer>(*this, GraphicsTimelineSemaphore);
 }
 
 void FVulkanDevice::RecreateSwapchain()
 {
-    vkDeviceWaitIdle(LogicalDevice);
-    Swapchain->Create(WINDOW_DEFAULT_WIDTH, WINDOW_DEFAULT_HEIGHT);
+    // 不再 vkDeviceWaitIdle：旧交换链经 oldSwapchain 退休，飞行中的帧继续完成，
+    // 其 ImageView 与 Present 信号量在最后一次 Present 完成后由 CollectRetired 回收
+    int Width = 0, Height = 0;
+    WindowRef.GetDrawableSize(Width, Height);
+
+    VkFormat OldFormat = Swapchain->GetVkFormat();
+    Swapchain->Create(static_cast<uint32_t>(Width), static_cast<uint32_t>(Height));
+
+    const VkExtent2D NewExtent = Swapchain->GetVkExtent();
+    const bool bFormatChanged = Swapchain->GetVkFormat() != OldFormat;
+    const VkExtent2D DepthExtent = DepthTarget->GetExtent();
+    const bool bExtentChanged = NewExtent.width != DepthExtent.width || NewExtent.height != DepthExtent.height;
+    if (!bFormatChanged && !bExtentChanged)
+    {
+        return;
+    }
+
+    // 呈现策略可能改变了颜色格式，管线的 Color Attachment 格式需要同步
+    // 管线由所有飞行帧共用：只等待已提交的帧用完旧管线，而非整个设备空闲 (只在切换呈现策略时发生)
+    if (bFormatChanged)
+    {
+        WaitForSubmittedFrames();
+        DestroyGraphicsPipelines();
+        CreateGraphicsPipelines();
+    }
+
+    // 尺寸变化 (每次窗口缩放) 不等待：旧深度缓冲与 Hi-Z 退休，飞行中的帧继续用完它们
+    if (bExtentChanged)
+    {
+        ResizeDepthTarget();
+    }
+}
+
+void FVulkanDevice::WaitForSubmittedFrames()
+{
+    VkSemaphoreWaitInfo WaitInfo{};
+    Utils::ZeroVulkanStruct(WaitInfo, VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO);
+    WaitInfo.semaphoreCount = 1;
+    WaitInfo.pSemaphores = &GraphicsTimelineSemaphore;
+    WaitInfo.pValues = &CurrentCpuFrame;
+    vkWaitSemaphores(LogicalDevice, &WaitInfo, UINT64_MAX);
+}
+
+void FVulkanDevice::SetPresentPolicy(const FPresentPolicy& InPolicy)
+{
+    PresentPolicy = InPolicy;
+
+    // Init 之前只记录策略；之后仅重建交换链，无需重启设备
+    if (Swapchain)
+    {
+        // maintenance1 且模式兼容时，下一次 Present 直接切换，连交换链都不用重建
+        if (Swapchain->TrySwitchPresentMode(PresentPolicy))
+        {
+            return;
+        }
+
+        Swapchain->SetPresentPolicy(PresentPolicy);
+        RecreateSwapchain();
+    }
 }
 
 FVulkanDevice::~FVulkanDevice()
@@ -101,14 +256,19 @@ FVulkanDevice::~FVulkanDevice()
         vkDeviceWaitIdle(LogicalDevice);
     }
 
-    if (GraphicsTimelineSemaphore != VK_NULL_HANDLE)
+    // 后台线程仍在等待 Timeline / Present，必须先于信号量和交换链销毁
+    FramePacer.reset();
+
+    if (Profiler)
     {
-        vkDestroySemaphore(LogicalDevice, GraphicsTimelineSemaphore, nullptr);
+        Profiler->ResolveAll();
+        Profiler->ExportChromeTrace(TIMELINE_EXPORT_PATH);
+        Profiler.reset();
     }
 
-    for (VkSemaphore Semaphore : PresentSemaphores)
+    if (GraphicsTimelineSemaphore != VK_NULL_HANDLE)
     {
-        vkDestroySemaphore(LogicalDevice, Semaphore, nullptr);
+        vkDestroySemaphore(LogicalDevice, GraphicsTimelineSemaphore, nullptr);
     }
 
     for (VkSemaphore Semaphore : ImageAvailableSemaphores)
@@ -121,16 +281,26 @@ FVulkanDevice::~FVulkanDevice()
         vkDestroyCommandPool(LogicalDevice, CommandPool, nullptr);
     }
 
-    if (GraphicsPipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(LogicalDevice, GraphicsPipeline, nullptr);
-    }
+    DestroyGraphicsPipelines();
 
     if (PipelineLayout != VK_NULL_HANDLE)
     {
         vkDestroyPipelineLayout(LogicalDevice, PipelineLayout, nullptr);
     }
 
+    if (IndirectPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, IndirectPipelineLayout, nullptr);
+    }
+
+    // 缓冲与图像由 VMA 分配，必须先于 Allocator 销毁
+    DepthTarget.reset();
+    GpuCulling.reset();
+    ClusteredLighting.reset();
+    TextureStreamer.reset();
+    MeshletRenderer.reset();
+    StagingUploader.reset();
+
     if (Swapchain)
     {
         Swapchain.reset();
@@ -177,6 +347,32 @@ void FVulkanDevice::CreateInstance()
     auto Extensions = WindowRef.GetVulkanExtensions();
     Extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 
+    {
+        uint32_t ExtensionCount = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &ExtensionCount, nullptr);
+        std::vector<VkExtensionProperties> AvailableExtensions(ExtensionCount);
+        vkEnumerateInstanceExtensionProperties(nullptr, &ExtensionCount, AvailableExtensions.data());
+
+        size_t Supported = 0;
+        for (const char* Optional : OptionalInstanceExtensions)
+        {
+            for (const auto& Extension : AvailableExtensions)
+            {
+                if (std::string_view(Extension.extensionName) == Optional)
+                {
+                    Supported++;
+                    break;
+                }
+            }
+        }
+
+        bSurfaceMaintenance1Enabled = Supported == OptionalInstanceExtensions.size();
+        if (bSurfaceMaintenance1Enabled)
+        {
+            Extensions.insert(Extensions.end(), OptionalInstanceExtensions.begin(), OptionalInstanceExtensions.end());
+        }
+    }
+
     VkDebugUtilsMessengerCreateInfoEXT DebugCreateInfo{};
     if (bEnableValidationLayers)
     {
@@ -196,12 +392,12 @@ void FVulkanDevice::CreateInstance()
     CreateInfo.enabledExtensionCount = static_cast<uint32_t>(Extensions.size());
     CreateInfo.ppEnabledExtensionNames = Extensions.data();
 
-    std::cout << "Creating Vulkan Instance..." << std::endl;
+    CA_LOG_INFO("Vulkan", "Creating Vulkan Instance...");
     if (vkCreateInstance(&CreateInfo, nullptr, &Instance) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create instance!");
     }
-    std::cout << "Vulkan Instance created successfully!" << std::endl;
+    CA_LOG_INFO("Vulkan", "Vulkan Instance created successfully!");
 }
 
 void FVulkanDevice::SetupDebugMessenger()
@@ -235,19 +431,19 @@ void FVulkanDevice::PickPhysicalDevice()
 
     VkPhysicalDeviceProperties Props;
     vkGetPhysicalDeviceProperties(PhysicalDevice, &Props);
-    std::cout << "Selected GPU: " << Props.deviceName << std::endl;
+    CA_LOG_INFO("Vulkan", "Selected GPU: {}", Props.deviceName);
 
-    std::cout << "Graphics Family Index: " << QueueIndices.GraphicsFamily.value() << std::endl;
-    std::cout << "Present Family Index: " << QueueIndices.PresentFamily.value() << std::endl;
-    std::cout << "Compute Family Index:  " << QueueIndices.ComputeFamily.value() << std::endl;
+    CA_LOG_INFO("Vulkan", "Graphics Family Index: {}", QueueIndices.GraphicsFamily.value());
+    CA_LOG_INFO("Vulkan", "Present Family Index: {}", QueueIndices.PresentFamily.value());
+    CA_LOG_INFO("Vulkan", "Compute Family Index: {}", QueueIndices.ComputeFamily.value());
 
     if (QueueIndices.GraphicsFamily.value() != QueueIndices.ComputeFamily.value())
     {
-        std::cout << ">> Dedicated Async Compute Queue Found! (True Async)" << std::endl;
+        CA_LOG_INFO("Vulkan", ">> Dedicated Async Compute Queue Found! (True Async)");
     }
     else
     {
-        std::cout << ">> Shared Graphics/Compute Queue. (Fallback)" << std::endl;
+        CA_LOG_INFO("Vulkan", ">> Shared Graphics/Compute Queue. (Fallback)");
     }
 }
 
@@ -277,8 +473,30 @@ void FVulkanDevice::CreateLogicalDevice()
     Utils::ZeroVulkanStruct(CreateInfo, VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO);
     CreateInfo.queueCreateInfoCount = static_cast<uint32_t>(QueueCreateInfos.size());
     CreateInfo.pQueueCreateInfos = QueueCreateInfos.data();
-    CreateInfo.enabledExtensionCount = static_cast<uint32_t>(DeviceExtensions.size());
-    CreateInfo.ppEnabledExtensionNames = DeviceExtensions.data();
+
+    std::vector<const char*> EnabledExtensions = DeviceExtensions;
+    {
+        uint32_t ExtensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &ExtensionCount, nullptr);
+        std::vector<VkExtensionProperties> AvailableExtensions(ExtensionCount);
+        vkEnumerateDeviceExtensionProperties(PhysicalDevice, nullptr, &ExtensionCount, AvailableExtensions.data());
+
+        for (const char* Optional : OptionalDeviceExtensions)
+        {
+            for (const auto& Extension : AvailableExtensions)
+            {
+                if (std::string_view(Extension.extensionName) == Optional)
+                {
+                    EnabledExtensions.push_back(Optional);
+                    break;
+                }
+            }
+        }
+    }
+    EnabledDeviceExtensions = std::set<std::string>(EnabledExtensions.begin(), EnabledExtensions.end());
+
+    CreateInfo.enabledExtensionCount = static_cast<uint32_t>(EnabledExtensions.size());
+    CreateInfo.ppEnabledExtensionNames = EnabledExtensions.data();
 
     VkPhysicalDeviceVulkan12Features vulkan12Features{};
     Utils::ZeroVulkanStruct(vulkan12Features, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
@@ -296,9 +514,161 @@ void FVulkanDevice::CreateLogicalDevice()
     synchronization2Features.synchronization2 = VK_TRUE;
     dynamicRenderingFeature.pNext = &synchronization2Features;
 
+    // Present ID / Present Wait：扩展可用且特性支持时才启用
+    VkPhysicalDevicePresentIdFeaturesKHR PresentIdFeatures{};
+    Utils::ZeroVulkanStruct(PresentIdFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR);
+    VkPhysicalDevicePresentWaitFeaturesKHR PresentWaitFeatures{};
+    Utils::ZeroVulkanStruct(PresentWaitFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR);
+
+    if (EnabledDeviceExtensions.contains(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        EnabledDeviceExtensions.contains(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        PresentIdFeatures.pNext = &PresentWaitFeatures;
+
+        VkPhysicalDeviceFeatures2 SupportedFeatures{};
+        Utils::ZeroVulkanStruct(SupportedFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+        SupportedFeatures.pNext = &PresentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &SupportedFeatures);
+
+        bPresentWaitEnabled = PresentIdFeatures.presentId && PresentWaitFeatures.presentWait;
+        if (bPresentWaitEnabled)
+        {
+            PresentWaitFeatures.pNext = synchronization2Features.pNext;
+            synchronization2Features.pNext = &PresentIdFeatures;
+        }
+    }
+
+    // Swapchain Maintenance1：Present Fence、Release Images、免重建切换呈现模式
+    VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT SwapchainMaintenance1Features{};
+    Utils::ZeroVulkanStruct(SwapchainMaintenance1Features, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT);
+
+    if (bSurfaceMaintenance1Enabled && EnabledDeviceExtensions.contains(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME))
+    {
+        VkPhysicalDeviceFeatures2 SupportedFeatures{};
+        Utils::ZeroVulkanStruct(SupportedFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+        SupportedFeatures.pNext = &SwapchainMaintenance1Features;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &SupportedFeatures);
+
+        bSwapchainMaintenance1Enabled = SwapchainMaintenance1Features.swapchainMaintenance1;
+        if (bSwapchainMaintenance1Enabled)
+        {
+            SwapchainMaintenance1Features.pNext = synchronization2Features.pNext;
+            synchronization2Features.pNext = &SwapchainMaintenance1Features;
+        }
+    }
+
+    // Mesh Shader：只在请求网格簇渲染时启用，任务与网格阶段都要支持
+    VkPhysicalDeviceMeshShaderFeaturesEXT MeshShaderFeatures{};
+    Utils::ZeroVulkanStruct(MeshShaderFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT);
+
+    if (bMeshletRenderingRequested && bMeshShaderRequested && EnabledDeviceExtensions.contains(VK_EXT_MESH_SHADER_EXTENSION_NAME))
+    {
+        VkPhysicalDeviceFeatures2 SupportedFeatures{};
+        Utils::ZeroVulkanStruct(SupportedFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+        SupportedFeatures.pNext = &MeshShaderFeatures;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &SupportedFeatures);
+
+        bMeshShaderSupported = MeshShaderFeatures.taskShader && MeshShaderFeatures.meshShader;
+        if (bMeshShaderSupported)
+        {
+            // 只开启用到的两项，其余 (multiview、primitive fragment shading rate 等) 保持关闭
+            MeshShaderFeatures.multiviewMeshShader = VK_FALSE;
+            MeshShaderFeatures.primitiveFragmentShadingRateMeshShader = VK_FALSE;
+            MeshShaderFeatures.meshShaderQueries = VK_FALSE;
+            MeshShaderFeatures.pNext = synchronization2Features.pNext;
+            synchronization2Features.pNext = &MeshShaderFeatures;
+        }
+    }
+
     VkPhysicalDeviceFeatures DeviceFeatures{};
     DeviceFeatures.samplerAnisotropy = VK_TRUE;
     DeviceFeatures.geometryShader = VK_TRUE;
+
+    // GPU 驱动渲染：绘制数量由计算着色器写入 (drawIndirectCount)，每条间接命令带各自的 firstInstance
+    {
+        VkPhysicalDeviceVulkan12Features SupportedVulkan12Features{};
+        Utils::ZeroVulkanStruct(SupportedVulkan12Features, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
+        VkPhysicalDeviceFeatures2 SupportedFeatures{};
+        Utils::ZeroVulkanStruct(SupportedFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+        SupportedFeatures.pNext = &SupportedVulkan12Features;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &SupportedFeatures);
+
+        bGpuCullingSupported = SupportedVulkan12Features.drawIndirectCount &&
+            SupportedFeatures.features.multiDrawIndirect &&
+            SupportedFeatures.features.drawIndirectFirstInstance;
+        if (bGpuCullingSupported)
+        {
+            vulkan12Features.drawIndirectCount = VK_TRUE;
+            DeviceFeatures.multiDrawIndirect = VK_TRUE;
+            DeviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+        }
+
+        // 网格簇回退路径：每个可见簇一条索引间接命令，命令数由剔除着色器写入
+        if (bMeshletRenderingRequested && !bMeshShaderSupported)
+        {
+            if (SupportedVulkan12Features.drawIndirectCount && SupportedFeatures.features.multiDrawIndirect)
+            {
+                vulkan12Features.drawIndirectCount = VK_TRUE;
+                DeviceFeatures.multiDrawIndirect = VK_TRUE;
+            }
+            else
+            {
+                CA_LOG_WARN("Meshlet", "drawIndirectCount / multiDrawIndirect not supported without mesh shaders, meshlet rendering disabled.");
+                bMeshletRenderingRequested = false;
+            }
+        }
+
+        // 纹理流送：每个实例的纹理序号在片元着色器中非一致
+        if (bMeshletRenderingRequested && !TextureDirectory.empty())
+        {
+            bTextureStreamingSupported = SupportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing;
+            if (bTextureStreamingSupported)
+            {
+                vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            }
+            else
+            {
+                CA_LOG_WARN("TextureStreaming", "shaderSampledImageArrayNonUniformIndexing not supported, texture streaming disabled.");
+            }
+        }
+    }
+
+    // 采样反馈：片元着色器原子写入存储缓冲，写入前在波内按纹理归约 (片元阶段的子组运算)，并排除辅助 lane
+    VkPhysicalDeviceShaderDemoteToHelperInvocationFeatures DemoteToHelperFeatures{};
+    Utils::ZeroVulkanStruct(DemoteToHelperFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DEMOTE_TO_HELPER_INVOCATION_FEATURES);
+
+    if (bTextureStreamingSupported && TextureStreamingConfig.bSamplerFeedback)
+    {
+        VkPhysicalDeviceFeatures2 SupportedFeatures{};
+        Utils::ZeroVulkanStruct(SupportedFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+        SupportedFeatures.pNext = &DemoteToHelperFeatures;
+        vkGetPhysicalDeviceFeatures2(PhysicalDevice, &SupportedFeatures);
+
+        VkPhysicalDeviceVulkan11Properties Vulkan11Properties{};
+        Utils::ZeroVulkanStruct(Vulkan11Properties, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_PROPERTIES);
+        VkPhysicalDeviceProperties2 Properties{};
+        Utils::ZeroVulkanStruct(Properties, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2);
+        Properties.pNext = &Vulkan11Properties;
+        vkGetPhysicalDeviceProperties2(PhysicalDevice, &Properties);
+
+        constexpr VkSubgroupFeatureFlags RequiredSubgroupOperations =
+            VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_BALLOT_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+        const bool bFeedbackSupported = SupportedFeatures.features.fragmentStoresAndAtomics &&
+            DemoteToHelperFeatures.shaderDemoteToHelperInvocation &&
+            (Vulkan11Properties.subgroupSupportedStages & VK_SHADER_STAGE_FRAGMENT_BIT) != 0 &&
+            (Vulkan11Properties.subgroupSupportedOperations & RequiredSubgroupOperations) == RequiredSubgroupOperations;
+        if (bFeedbackSupported)
+        {
+            DeviceFeatures.fragmentStoresAndAtomics = VK_TRUE;
+            DemoteToHelperFeatures.pNext = synchronization2Features.pNext;
+            synchronization2Features.pNext = &DemoteToHelperFeatures;
+        }
+        else
+        {
+            CA_LOG_WARN("TextureStreaming", "Fragment stores / subgroup operations not supported, falling back to CPU mip estimates.");
+            TextureStreamingConfig.bSamplerFeedback = false;
+        }
+    }
     
     VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
     Utils::ZeroVulkanStruct(physicalDeviceFeatures2, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
@@ -327,13 +697,18 @@ void FVulkanDevice::CreateAllocator()
 
     AllocatorInfo.vulkanApiVersion = VK_API_VERSION;
     AllocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT; // Buffer Device Address (BDA)
+    // 显存预算：纹理流送按驱动报告的剩余预算收缩常驻池
+    if (EnabledDeviceExtensions.contains(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+    {
+        AllocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
 
     if (vmaCreateAllocator(&AllocatorInfo, &Allocator) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create VMA allocator!");
     }
 
-    std::cout << "VMA Initialized Successfully." << std::endl;
+    CA_LOG_INFO("VMA", "VMA Initialized Successfully.");
 }
 
 void FVulkanDevice::TestVMA()
@@ -357,7 +732,7 @@ void FVulkanDevice::TestVMA()
 
     if (result == VK_SUCCESS)
     {
-        std::cout << "[VMA Test] Buffer created successfully via VMA!" << std::endl;
+        CA_LOG_INFO("VMA Test", "Buffer created successfully via VMA!");
         vmaDestroyBuffer(Allocator, testBuffer, testAlloc);
     }
     else
@@ -381,35 +756,151 @@ VkShaderModule FVulkanDevice::CreateShaderModule(const std::vector<char>& InCode
     return ShaderModule;
 }
 
+void FVulkanDevice::ResizeDepthTarget()
+{
+    // 已提交的帧最后一帧的 Timeline 值为 CurrentCpuFrame，旧资源在它完成后回收
+    const VkExtent2D Extent = Swapchain->GetVkExtent();
+    if (!DepthTarget->Resize(Extent, CurrentCpuFrame))
+    {
+        return;
+    }
+
+    if (GpuCulling)
+    {
+        GpuCulling->SetDepthSource(DepthTarget->GetView(), Extent.width, Extent.height, CurrentCpuFrame);
+    }
+}
+
 void FVulkanDevice::CreatePipelineLayout()
 {
+    // 分簇光照的描述符集：CPU 绘制列表路径为 set 0，GPU 驱动路径接在实例缓冲之后为 set 1
+    const VkDescriptorSetLayout LightingSetLayout = ClusteredLighting ? ClusteredLighting->GetDescriptorSetLayout() : VK_NULL_HANDLE;
+
     VkPipelineLayoutCreateInfo PipelineLayoutInfo{};
     Utils::ZeroVulkanStruct(PipelineLayoutInfo, VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO);
-    PipelineLayoutInfo.setLayoutCount = 0;
-    PipelineLayoutInfo.pSetLayouts = nullptr;
-    PipelineLayoutInfo.pushConstantRangeCount = 0;
-    PipelineLayoutInfo.pPushConstantRanges = nullptr;
+    PipelineLayoutInfo.setLayoutCount = ClusteredLighting ? 1 : 0;
+    PipelineLayoutInfo.pSetLayouts = ClusteredLighting ? &LightingSetLayout : nullptr;
+
+    // 每个绘制的 WorldViewProjection + Color
+    VkPushConstantRange PushConstantRange{};
+    PushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    PushConstantRange.offset = 0;
+    PushConstantRange.size = sizeof(FDrawConstants);
+    PipelineLayoutInfo.pushConstantRangeCount = 1;
+    PipelineLayoutInfo.pPushConstantRanges = &PushConstantRange;
 
     if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &PipelineLayout) != VK_SUCCESS) {
         throw std::runtime_error("failed to create pipeline layout!");
     }
+
+    if (GpuCulling)
+    {
+        // GPU 驱动路径：实例缓冲 (set 0) + 每帧一次的 ViewProjection
+        const VkDescriptorSetLayout SetLayouts[] = { GpuCulling->GetDescriptorSetLayout(), LightingSetLayout };
+        PipelineLayoutInfo.setLayoutCount = ClusteredLighting ? 2 : 1;
+        PipelineLayoutInfo.pSetLayouts = SetLayouts;
+        PushConstantRange.size = sizeof(FMatrix4);
+
+        if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &IndirectPipelineLayout) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create indirect pipeline layout!");
+        }
+    }
 }
 
-void FVulkanDevice::CreateGraphicsPipeline()
+void FVulkanDevice::CreateGraphicsPipelines()
 {
-    VkPipelineShaderStageCreateInfo VertexShaderStageInfo{};
-    Utils::ZeroVulkanStruct(VertexShaderStageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
-    VertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    VkShaderModule vertexShaderModule = CreateShaderModule(Utils::ReadSPV("Triangle.vert.spv"));
-    VertexShaderStageInfo.module = vertexShaderModule;
-    VertexShaderStageInfo.pName = "VSMain";
-
-    VkPipelineShaderStageCreateInfo FragmentShaderStageInfo{};
-    Utils::ZeroVulkanStruct(FragmentShaderStageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
-    FragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    VkShaderModule fragmentShaderModule = CreateShaderModule(Utils::ReadSPV("Triangle.frag.spv"));
-    FragmentShaderStageInfo.module = fragmentShaderModule;
-    FragmentShaderStageInfo.pName = "PSMain";
+    if (ClusteredLighting)
+    {
+        GraphicsPipeline = CreateGraphicsPipeline({ { "Triangle.vert.spv", "VSMain", VK_SHADER_STAGE_VERTEX_BIT },
+            { "Triangle.lit.frag.spv", "PSClustered", VK_SHADER_STAGE_FRAGMENT_BIT } }, PipelineLayout, false, VK_FRONT_FACE_CLOCKWISE);
+    }
+    else
+    {
+        GraphicsPipeline = CreateGraphicsPipeline("Triangle.vert.spv", PipelineLayout, false);
+    }
+    DepthOnlyPipeline = CreateGraphicsPipeline("Triangle.depth.vert.spv", PipelineLayout, true);
+    if (GpuCulling)
+    {
+        IndirectPipeline = ClusteredLighting
+            ? CreateGraphicsPipeline({ { "TriangleIndirect.vert.spv", "VSMain", VK_SHADER_STAGE_VERTEX_BIT },
+                { "TriangleIndirect.lit.frag.spv", "PSClustered", VK_SHADER_STAGE_FRAGMENT_BIT } }, IndirectPipelineLayout, false, VK_FRONT_FACE_CLOCKWISE)
+            : CreateGraphicsPipeline("TriangleIndirect.vert.spv", IndirectPipelineLayout, false);
+        IndirectDepthOnlyPipeline = CreateGraphicsPipeline("TriangleIndirect.depth.vert.spv", IndirectPipelineLayout, true);
+    }
+    if (MeshletRenderer)
+    {
+        // 导入的网格为逆时针正面
+        const VkPipelineLayout MeshletLayout = MeshletRenderer->GetPipelineLayout();
+        // 纹理流送时颜色 Pass 按实例采样流送纹理，开启采样反馈时同时回写每个纹理需要的 mip
+        const FShaderStageDesc TexturedStage = TextureStreamer && TextureStreamer->IsSamplerFeedbackEnabled()
+            ? FShaderStageDesc{ "MeshletTexturedFeedback.frag.spv", "PSTexturedFeedback", VK_SHADER_STAGE_FRAGMENT_BIT }
+            : FShaderStageDesc{ "MeshletTextured.frag.spv", "PSTextured", VK_SHADER_STAGE_FRAGMENT_BIT };
+        if (MeshletRenderer->IsMeshShaderEnabled())
+        {
+            const FShaderStageDesc TaskStage{ "Meshlet.task.spv", "ASMain", VK_SHADER_STAGE_TASK_BIT_EXT };
+            const FShaderStageDesc MeshStage{ "Meshlet.mesh.spv", "MSMain", VK_SHADER_STAGE_MESH_BIT_EXT };
+            MeshletPipeline = TextureStreamer
+                ? CreateGraphicsPipeline({ TaskStage, MeshStage, TexturedStage }, MeshletLayout, false, VK_FRONT_FACE_COUNTER_CLOCKWISE)
+                : CreateGraphicsPipeline({ TaskStage, MeshStage }, MeshletLayout, false, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+            MeshletDepthOnlyPipeline = CreateGraphicsPipeline({ TaskStage, MeshStage }, MeshletLayout, true, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+        }
+        else
+        {
+            const FShaderStageDesc VertexStage{ "MeshletIndirect.vert.spv", "VSMain", VK_SHADER_STAGE_VERTEX_BIT };
+            MeshletPipeline = TextureStreamer
+                ? CreateGraphicsPipeline({ VertexStage, TexturedStage }, MeshletLayout, false, VK_FRONT_FACE_COUNTER_CLOCKWISE)
+                : CreateGraphicsPipeline({ VertexStage }, MeshletLayout, false, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+            MeshletDepthOnlyPipeline = CreateGraphicsPipeline({ { "MeshletIndirect.depth.vert.spv", "VSDepthOnly", VK_SHADER_STAGE_VERTEX_BIT } },
+                MeshletLayout, true, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+        }
+    }
+}
+
+void FVulkanDevice::DestroyGraphicsPipelines()
+{
+    for (VkPipeline* Pipeline : { &GraphicsPipeline, &DepthOnlyPipeline, &IndirectPipeline, &IndirectDepthOnlyPipeline,
+        &MeshletPipeline, &MeshletDepthOnlyPipeline })
+    {
+        if (*Pipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(LogicalDevice, *Pipeline, nullptr);
+            *Pipeline = VK_NULL_HANDLE;
+        }
+    }
+}
+
+VkPipeline FVulkanDevice::CreateGraphicsPipeline(const char* VertexShaderFile, VkPipelineLayout InLayout, bool bDepthOnly) const
+{
+    const FShaderStageDesc VertexStage{ VertexShaderFile, bDepthOnly ? "VSDepthOnly" : "VSMain", VK_SHADER_STAGE_VERTEX_BIT };
+    return CreateGraphicsPipeline({ VertexStage }, InLayout, bDepthOnly, VK_FRONT_FACE_CLOCKWISE);
+}
+
+VkPipeline FVulkanDevice::CreateGraphicsPipeline(std::initializer_list<FShaderStageDesc> Stages, VkPipelineLayout InLayout,
+    bool bDepthOnly, VkFrontFace FrontFace) const
+{
+    std::vector<VkPipelineShaderStageCreateInfo> ShaderStages;
+    bool bMeshPipeline = false;
+    bool bHasFragmentStage = false;
+    for (const FShaderStageDesc& Desc : Stages)
+    {
+        VkPipelineShaderStageCreateInfo& StageInfo = ShaderStages.emplace_back();
+        Utils::ZeroVulkanStruct(StageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
+        StageInfo.stage = Desc.Stage;
+        StageInfo.module = CreateShaderModule(Utils::ReadSPV(Desc.File));
+        StageInfo.pName = Desc.EntryPoint;
+        bMeshPipeline |= Desc.Stage == VK_SHADER_STAGE_MESH_BIT_EXT;
+        bHasFragmentStage |= Desc.Stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+
+    // 纯深度变体没有片元阶段，光栅化后只做深度测试与写入
+    if (!bDepthOnly && !bHasFragmentStage)
+    {
+        VkPipelineShaderStageCreateInfo& FragmentShaderStageInfo = ShaderStages.emplace_back();
+        Utils::ZeroVulkanStruct(FragmentShaderStageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
+        FragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        FragmentShaderStageInfo.module = CreateShaderModule(Utils::ReadSPV("Triangle.frag.spv"));
+        FragmentShaderStageInfo.pName = "PSMain";
+    }
 
     VkPipelineVertexInputStateCreateInfo VertexInputInfo{};
     Utils::ZeroVulkanStruct(VertexInputInfo, VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO);
@@ -431,7 +922,7 @@ void FVulkanDevice::CreateGraphicsPipeline()
     Rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     Rasterizer.lineWidth = 1.0f;
     Rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    Rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    Rasterizer.frontFace = FrontFace;
     Rasterizer.depthBiasEnable = VK_FALSE;
 
     VkPipelineMultisampleStateCreateInfo Multisampling{};
@@ -439,6 +930,7 @@ void FVulkanDevice::CreateGraphicsPipeline()
     Multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
     Multisampling.sampleShadingEnable = VK_FALSE;
 
+    // 深度写入与比较函数是动态状态：开启深度预渲染时颜色 Pass 改为只读 + LESS_OR_EQUAL
     VkPipelineDepthStencilStateCreateInfo DepthStencil{};
     Utils::ZeroVulkanStruct(DepthStencil, VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO);
     DepthStencil.depthTestEnable = VK_TRUE;
@@ -453,7 +945,8 @@ void FVulkanDevice::CreateGraphicsPipeline()
     ColorBlending.attachmentCount = 1;
     
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    // 纯深度变体与颜色 Pass 在同一个 Rendering 内，颜色附件保留但不写
+    colorBlendAttachment.colorWriteMask = bDepthOnly ? 0 : VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
     colorBlendAttachment.blendEnable = VK_FALSE;
     ColorBlending.pAttachments = &colorBlendAttachment;
 
@@ -461,14 +954,15 @@ void FVulkanDevice::CreateGraphicsPipeline()
     Utils::ZeroVulkanStruct(DynamicState, VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO);
     std::vector<VkDynamicState> dynamicStates = {
         VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR
+        VK_DYNAMIC_STATE_SCISSOR,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP
     };
     DynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
     DynamicState.pDynamicStates = dynamicStates.data();
-    VkPipelineShaderStageCreateInfo shaderStages[] = { VertexShaderStageInfo, FragmentShaderStageInfo };
 
     VkFormat colorAttachmentFormat = Swapchain->GetVkFormat();
-    VkFormat depthAttachmentFormat = VK_FORMAT_D32_SFLOAT;
+    VkFormat depthAttachmentFormat = DEPTH_FORMAT;
     VkPipelineRenderingCreateInfo pipelineRenderingInfo{};
     Utils::ZeroVulkanStruct(pipelineRenderingInfo, VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO);
     pipelineRenderingInfo.colorAttachmentCount = 1;
@@ -477,28 +971,35 @@ void FVulkanDevice::CreateGraphicsPipeline()
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     Utils::ZeroVulkanStruct(pipelineInfo, VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO);
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &VertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &InputAssembly;
+    pipelineInfo.stageCount = static_cast<uint32_t>(ShaderStages.size());
+    pipelineInfo.pStages = ShaderStages.data();
+    // Mesh Shader 管线没有顶点输入与图元装配
+    pipelineInfo.pVertexInputState = bMeshPipeline ? nullptr : &VertexInputInfo;
+    pipelineInfo.pInputAssemblyState = bMeshPipeline ? nullptr : &InputAssembly;
     pipelineInfo.pViewportState = &ViewportState;
     pipelineInfo.pRasterizationState = &Rasterizer;
     pipelineInfo.pMultisampleState = &Multisampling;
     pipelineInfo.pDepthStencilState = &DepthStencil;
     pipelineInfo.pColorBlendState = &ColorBlending;
     pipelineInfo.pDynamicState = &DynamicState;
-    pipelineInfo.layout = PipelineLayout;
+    pipelineInfo.layout = InLayout;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
     pipelineInfo.pNext = &pipelineRenderingInfo;
     
-    if (vkCreateGraphicsPipelines(LogicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &GraphicsPipeline) != VK_SUCCESS)
+    VkPipeline Pipeline = VK_NULL_HANDLE;
+    VkResult Result = vkCreateGraphicsPipelines(LogicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &Pipeline);
+
+    for (const VkPipelineShaderStageCreateInfo& StageInfo : ShaderStages)
     {
-        throw std::runtime_error("failed to create graphics pipeline!");
+        vkDestroyShaderModule(LogicalDevice, StageInfo.module, nullptr);
     }
 
-    vkDestroyShaderModule(LogicalDevice, vertexShaderModule, nullptr);
-    vkDestroyShaderModule(LogicalDevice, fragmentShaderModule, nullptr);
+    if (Result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create graphics pipeline!");
+    }
+    return Pipeline;
 }
 
 void FVulkanDevice::CreateCommandPool()
@@ -515,7 +1016,8 @@ void FVulkanDevice::CreateCommandPool()
 
 void FVulkanDevice::CreateCommandBuffers()
 {
-    CommandBuffers.resize(Swapchain->GetImages().size());
+    // 按飞行帧分配：复用前已通过 Timeline 等待，与交换链图片数量无关，重建时无需调整
+    CommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
     VkCommandBufferAllocateInfo AllocInfo{};
     Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO);
     AllocInfo.commandPool = CommandPool;
@@ -527,7 +1029,7 @@ void FVulkanDevice::CreateCommandBuffers()
     }
 }
 
-void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32_t InImageIndex)
+void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32_t InImageIndex, uint32_t InFrameIndex, const FFramePacket& Packet)
 {
     VkCommandBufferBeginInfo BeginInfo{};
     Utils::ZeroVulkanStruct(BeginInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO);
@@ -537,6 +1039,56 @@ void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32
         throw std::runtime_error("failed to begin recording command buffer!");
     }
 
+    uint32_t FrameScope = UINT32_MAX;
+    if (Profiler)
+    {
+        Profiler->BeginFrame(InCommandBuffer, InFrameIndex, CurrentCpuFrame + 1);
+        FrameScope = Profiler->BeginGpuScope(InCommandBuffer, "GPU Frame");
+    }
+
+    // 两阶段遮挡剔除：早阶段绘制 -> Hi-Z -> 晚阶段剔除与补画；否则剔除一次、绘制一次
+    const bool bTwoPhase = GpuCulling && GpuCulling->IsOcclusionCullingEnabled();
+    if (GpuCulling)
+    {
+        uint32_t CullingScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "GpuCulling") : UINT32_MAX;
+        GpuCulling->RecordEarlyCulling(InCommandBuffer, InFrameIndex, Packet.ViewProjection);
+        if (!bTwoPhase)
+        {
+            GpuCulling->RecordLateCulling(InCommandBuffer, InFrameIndex);
+        }
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, CullingScope);
+        }
+    }
+    if (MeshletRenderer)
+    {
+        uint32_t CullingScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "MeshletCulling") : UINT32_MAX;
+        MeshletRenderer->RecordCulling(InCommandBuffer, InFrameIndex, Packet);
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, CullingScope);
+        }
+    }
+    if (ClusteredLighting)
+    {
+        uint32_t LightingScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "LightClustering") : UINT32_MAX;
+        ClusteredLighting->RecordBuild(InCommandBuffer, InFrameIndex);
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, LightingScope);
+        }
+    }
+    if (TextureStreamer)
+    {
+        uint32_t StreamingScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "TextureStreaming") : UINT32_MAX;
+        TextureStreamer->RecordUploads(InCommandBuffer, InFrameIndex);
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, StreamingScope);
+        }
+    }
+
     VkImageMemoryBarrier2 Barrier{};
     Utils::ZeroVulkanStruct(Barrier, VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2);
     Barrier.srcStageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
@@ -554,10 +1106,25 @@ void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32
     Barrier.subresourceRange.baseArrayLayer = 0;
     Barrier.subresourceRange.layerCount = 1;
 
+    // 深度缓冲每帧清空，旧内容直接丢弃；上一帧的深度测试与 Hi-Z 读取必须先完成
+    VkImageMemoryBarrier2 DepthBarrier{};
+    Utils::ZeroVulkanStruct(DepthBarrier, VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2);
+    DepthBarrier.srcStageMask = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    DepthBarrier.srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    DepthBarrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    DepthBarrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    DepthBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    DepthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    DepthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    DepthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    DepthBarrier.image = DepthTarget->GetImage();
+    DepthBarrier.subresourceRange = { DepthTarget->GetAspectMask(), 0, 1, 0, 1 };
+
+    VkImageMemoryBarrier2 FrameBeginBarriers[] = { Barrier, DepthBarrier };
     VkDependencyInfo DependencyInfo{};
     Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
-    DependencyInfo.imageMemoryBarrierCount = 1;
-    DependencyInfo.pImageMemoryBarriers = &Barrier;
+    DependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(std::size(FrameBeginBarriers));
+    DependencyInfo.pImageMemoryBarriers = FrameBeginBarriers;
 
     vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
 
@@ -569,6 +1136,16 @@ void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32
     ColorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     VkClearValue ClearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
     ColorAttachment.clearValue = ClearColor;
+
+    // 两阶段时早阶段的深度要留给 Hi-Z 与晚阶段，否则帧末直接丢弃
+    VkRenderingAttachmentInfo DepthAttachment{};
+    Utils::ZeroVulkanStruct(DepthAttachment, VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO);
+    DepthAttachment.imageView = DepthTarget->GetView();
+    DepthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    DepthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    DepthAttachment.storeOp = bTwoPhase ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    DepthAttachment.clearValue.depthStencil = { 1.0f, 0 };
+
     VkRenderingInfo RenderingInfo{};
     Utils::ZeroVulkanStruct(RenderingInfo, VK_STRUCTURE_TYPE_RENDERING_INFO);
     RenderingInfo.renderArea.offset = { 0, 0 };
@@ -576,10 +1153,10 @@ void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32
     RenderingInfo.layerCount = 1;
     RenderingInfo.colorAttachmentCount = 1;
     RenderingInfo.pColorAttachments = &ColorAttachment;
+    RenderingInfo.pDepthAttachment = &DepthAttachment;
+    uint32_t MainPassScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "MainPass") : UINT32_MAX;
     vkCmdBeginRendering(InCommandBuffer, &RenderingInfo);
 
-    vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, GraphicsPipeline);
-
     VkViewport Viewport{};
     Viewport.x = 0.0f;
     Viewport.y = 0.0f;
@@ -593,10 +1170,155 @@ void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32
     Scissor.offset = { 0, 0 };
     Scissor.extent = Swapchain->GetVkExtent();
     vkCmdSetScissor(InCommandBuffer, 0, 1, &Scissor);
-    
-    vkCmdDraw(InCommandBuffer, 3, 1, 0, 0);
+
+    // 绘制数量由剔除结果决定，CPU 侧命令数与实例数无关
+    // 分簇光照只用于颜色变体，纯深度变体不绑定光照描述符集
+    const VkDescriptorSet LightingSet = ClusteredLighting ? ClusteredLighting->GetDescriptorSet(InFrameIndex) : VK_NULL_HANDLE;
+    auto RecordSceneDraws = [&](FVulkanGpuCulling::EPhase Phase, bool bDepthOnly)
+        {
+            if (GpuCulling)
+            {
+                vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bDepthOnly ? IndirectDepthOnlyPipeline : IndirectPipeline);
+                if (ClusteredLighting && !bDepthOnly)
+                {
+                    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, IndirectPipelineLayout, 1, 1, &LightingSet, 0, nullptr);
+                }
+                vkCmdPushConstants(InCommandBuffer, IndirectPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(FMatrix4), &Packet.ViewProjection);
+                GpuCulling->RecordDraws(InCommandBuffer, InFrameIndex, IndirectPipelineLayout, Phase);
+                return;
+            }
+            if (MeshletRenderer)
+            {
+                // 预渲染与颜色 Pass 剔除结果相同，只统计一次
+                vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bDepthOnly ? MeshletDepthOnlyPipeline : MeshletPipeline);
+                if (TextureStreamer && !bDepthOnly)
+                {
+                    const VkDescriptorSet TextureSet = TextureStreamer->GetDescriptorSet(InFrameIndex);
+                    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, MeshletRenderer->GetPipelineLayout(),
+                        1, 1, &TextureSet, 0, nullptr);
+                }
+                MeshletRenderer->RecordDraws(InCommandBuffer, InFrameIndex, !bDepthOnly);
+                return;
+            }
+
+            // 绘制列表已在 RenderPrep 阶段剔除并排好序，这里只负责录制
+            vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bDepthOnly ? DepthOnlyPipeline : GraphicsPipeline);
+            if (ClusteredLighting && !bDepthOnly)
+            {
+                vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayout, 0, 1, &LightingSet, 0, nullptr);
+            }
+            for (const FDrawConstants& Draw : Packet.Draws)
+            {
+                vkCmdPushConstants(InCommandBuffer, PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(FDrawConstants), &Draw);
+                vkCmdDraw(InCommandBuffer, 3, 1, 0, 0);
+            }
+        };
+
+    // 深度预渲染：先只写深度，颜色 Pass 不再写深度、只着色与深度缓冲相等的最近片元，消除片元过绘制
+    // 两个阶段在同一个 Rendering 内，深度无需额外的屏障
+    const bool bPrepass = bDepthPrepass;
+    auto RecordMainPassDraws = [&](FVulkanGpuCulling::EPhase Phase)
+        {
+            if (bPrepass)
+            {
+                uint32_t PrepassScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "DepthPrepass") : UINT32_MAX;
+                vkCmdSetDepthWriteEnable(InCommandBuffer, VK_TRUE);
+                vkCmdSetDepthCompareOp(InCommandBuffer, VK_COMPARE_OP_LESS);
+                RecordSceneDraws(Phase, true);
+                if (Profiler)
+                {
+                    Profiler->EndGpuScope(InCommandBuffer, PrepassScope);
+                }
+
+                vkCmdSetDepthWriteEnable(InCommandBuffer, VK_FALSE);
+                vkCmdSetDepthCompareOp(InCommandBuffer, VK_COMPARE_OP_LESS_OR_EQUAL);
+            }
+            else
+            {
+                vkCmdSetDepthWriteEnable(InCommandBuffer, VK_TRUE);
+                vkCmdSetDepthCompareOp(InCommandBuffer, VK_COMPARE_OP_LESS);
+            }
+            RecordSceneDraws(Phase, false);
+        };
+
+    RecordMainPassDraws(bTwoPhase ? FVulkanGpuCulling::EPhase::Early : FVulkanGpuCulling::EPhase::Late);
 
     vkCmdEndRendering(InCommandBuffer);
+    if (Profiler)
+    {
+        Profiler->EndGpuScope(InCommandBuffer, MainPassScope);
+    }
+    if (MeshletRenderer)
+    {
+        MeshletRenderer->RecordStatsBarrier(InCommandBuffer);
+    }
+    if (TextureStreamer)
+    {
+        TextureStreamer->RecordFeedbackBarrier(InCommandBuffer);
+    }
+
+    if (bTwoPhase)
+    {
+        // 1. 早阶段深度 -> Hi-Z 构建的只读输入
+        DepthBarrier.srcStageMask = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+        DepthBarrier.srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        DepthBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        DepthBarrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+        DepthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        DepthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        DependencyInfo.imageMemoryBarrierCount = 1;
+        DependencyInfo.pImageMemoryBarriers = &DepthBarrier;
+        vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+        uint32_t HiZScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "HiZBuild") : UINT32_MAX;
+        GpuCulling->RecordHiZBuild(InCommandBuffer);
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, HiZScope);
+        }
+
+        uint32_t OcclusionScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "OcclusionCulling") : UINT32_MAX;
+        GpuCulling->RecordLateCulling(InCommandBuffer, InFrameIndex);
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, OcclusionScope);
+        }
+
+        // 2. 深度回到附件布局，晚阶段在早阶段的结果上继续绘制
+        DepthBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        DepthBarrier.srcAccessMask = 0;
+        DepthBarrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+        DepthBarrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        DepthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        DepthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        // 晚阶段 LOAD 并继续写早阶段的颜色结果 (读后写、写后写)，布局不变
+        VkImageMemoryBarrier2 ColorBarrier = Barrier;
+        ColorBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ColorBarrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+        ColorBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ColorBarrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+        ColorBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        ColorBarrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkImageMemoryBarrier2 LatePassBarriers[] = { ColorBarrier, DepthBarrier };
+        DependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(std::size(LatePassBarriers));
+        DependencyInfo.pImageMemoryBarriers = LatePassBarriers;
+        vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+        ColorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        DepthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+        DepthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+        uint32_t LatePassScope = Profiler ? Profiler->BeginGpuScope(InCommandBuffer, "MainPassLate") : UINT32_MAX;
+        vkCmdBeginRendering(InCommandBuffer, &RenderingInfo);
+        RecordMainPassDraws(FVulkanGpuCulling::EPhase::Late);
+        vkCmdEndRendering(InCommandBuffer);
+        if (Profiler)
+        {
+            Profiler->EndGpuScope(InCommandBuffer, LatePassScope);
+        }
+    }
 
     VkImageMemoryBarrier2 PresentBarrier = Barrier;
     PresentBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -608,9 +1330,15 @@ void FVulkanDevice::RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32
     PresentBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     PresentBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
+    DependencyInfo.imageMemoryBarrierCount = 1;
     DependencyInfo.pImageMemoryBarriers = &PresentBarrier;
     vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
 
+    if (Profiler)
+    {
+        Profiler->EndGpuScope(InCommandBuffer, FrameScope);
+    }
+
     if (vkEndCommandBuffer(InCommandBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
     }
@@ -631,18 +1359,6 @@ void FVulkanDevice::CreateSyncObjects()
         }
     }
 
-    size_t ImageCount = Swapchain->GetImages().size();
-    PresentSemaphores.resize(ImageCount);
-
-    VkSemaphoreCreateInfo PresentSemaphoreInfo{};
-    Utils::ZeroVulkanStruct(PresentSemaphoreInfo, VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO);
-
-    for (size_t i = 0; i < ImageCount; i++) {
-        if (vkCreateSemaphore(LogicalDevice, &PresentSemaphoreInfo, nullptr, &PresentSemaphores[i]) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create present semaphore!");
-        }
-    }
-
     VkSemaphoreTypeCreateInfo TimelineCreateInfo{};
     Utils::ZeroVulkanStruct(TimelineCreateInfo, VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO);
     TimelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
@@ -657,11 +1373,15 @@ void FVulkanDevice::CreateSyncObjects()
     }
 }
 
-bool FVulkanDevice::RenderFrame()
+bool FVulkanDevice::RenderFrame(FFramePacket& Packet)
 {
+    FVulkanProfiler* FrameProfiler = Profiler.get();
+
+    // 低延迟模式下有效队列深度为 1，即等待上一帧 GPU 完成
+    uint64_t QueueDepth = FramePacer->GetQueueDepth();
     uint64_t WaitValue = 0;
-    if (CurrentCpuFrame >= MAX_FRAMES_IN_FLIGHT) {
-        WaitValue = CurrentCpuFrame + 1 - MAX_FRAMES_IN_FLIGHT; // 当前帧数减去最大帧数，得到需要等待的值
+    if (CurrentCpuFrame >= QueueDepth) {
+        WaitValue = CurrentCpuFrame + 1 - QueueDepth; // 当前帧数减去队列深度，得到需要等待的值
 
         VkSemaphoreWaitInfo WaitInfo{};
         Utils::ZeroVulkanStruct(WaitInfo, VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO);
@@ -669,14 +1389,32 @@ bool FVulkanDevice::RenderFrame()
         WaitInfo.pSemaphores = &GraphicsTimelineSemaphore;
         WaitInfo.pValues = &WaitValue;
 
+        FVulkanProfiler::FCpuScope WaitScope(FrameProfiler, "vkWaitSemaphores");
         vkWaitSemaphores(LogicalDevice, &WaitInfo, UINT64_MAX);
     }
 
+    // Hi-Z 与深度缓冲总是一起退休
+    if (Swapchain->GetRetiredCount() > 0 || DepthTarget->GetRetiredCount() > 0)
+    {
+        uint64_t CompletedValue = 0;
+        vkGetSemaphoreCounterValue(LogicalDevice, GraphicsTimelineSemaphore, &CompletedValue);
+        Swapchain->CollectRetired(CompletedValue, FramePacer->GetLastCompletedPresentId());
+        DepthTarget->CollectRetired(CompletedValue);
+        if (GpuCulling)
+        {
+            GpuCulling->CollectRetiredHiZ(CompletedValue);
+        }
+    }
+
     uint32_t FrameIndex = CurrentCpuFrame % MAX_FRAMES_IN_FLIGHT;
     uint32_t ImageIndex;
     
-    VkResult result = vkAcquireNextImageKHR(LogicalDevice, Swapchain->GetHandle(), UINT64_MAX,
-        ImageAvailableSemaphores[FrameIndex], VK_NULL_HANDLE, &ImageIndex);
+    VkResult result;
+    {
+        FVulkanProfiler::FCpuScope AcquireScope(FrameProfiler, "vkAcquireNextImageKHR");
+        result = vkAcquireNextImageKHR(LogicalDevice, Swapchain->GetHandle(), UINT64_MAX,
+            ImageAvailableSemaphores[FrameIndex], VK_NULL_HANDLE, &ImageIndex);
+    }
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
@@ -687,11 +1425,57 @@ bool FVulkanDevice::RenderFrame()
         throw std::runtime_error("failed to acquire swap chain image!");
         return false;
     }
+    else if (result == VK_SUBOPTIMAL_KHR && Swapchain->SupportsMaintenance1())
+    {
+        // 不再往即将被替换的交换链上画一整帧：归还图片，直接触发重建
+        Swapchain->ReleaseImage(ImageIndex);
+        SkipFrame(FrameIndex);
+        return false;
+    }
+
+    if (GpuCulling)
+    {
+        FVulkanProfiler::FCpuScope UploadScope(FrameProfiler, "UploadInstances");
+        const FGpuCullingStats CullingStats = GpuCulling->BeginFrame(FrameIndex, Packet);
+        Packet.CulledCount = CullingStats.FrustumCulled;
+        Packet.OcclusionCulledCount = CullingStats.OcclusionCulled;
+    }
+    if (MeshletRenderer)
+    {
+        // 剔除粒度是簇：统计来自该帧槽上一轮，视锥与背面剔除的簇合计；CPU 剔除时实例级剔除数由 RenderPrep 填好
+        FVulkanProfiler::FCpuScope UploadScope(FrameProfiler, "UploadInstances");
+        const FMeshletStats MeshletStats = MeshletRenderer->BeginFrame(FrameIndex, Packet);
+        if (!Packet.bCpuCulled)
+        {
+            Packet.CulledCount = 0;
+        }
+        Packet.ClusterCulledCount = MeshletStats.FrustumCulledClusters + MeshletStats.ConeCulledClusters;
+        Packet.ClusterCount = MeshletStats.VisibleClusters + Packet.ClusterCulledCount;
+        Packet.TriangleCount = MeshletStats.VisibleTriangles;
+    }
+    if (ClusteredLighting)
+    {
+        FVulkanProfiler::FCpuScope UploadScope(FrameProfiler, "UploadLights");
+        const FClusteredLightingStats LightingStats = ClusteredLighting->BeginFrame(FrameIndex, Packet);
+        Packet.LightIndexCount = LightingStats.LightIndexCount;
+        Packet.LightBuildGpuNs = LightingStats.BuildGpuNs;
+    }
+    if (TextureStreamer)
+    {
+        // 本帧提交后时间线到达 CurrentCpuFrame + 1，旧图像在这个值完成后释放
+        FVulkanProfiler::FCpuScope StreamingScope(FrameProfiler, "TextureStreaming");
+        uint64_t CompletedValue = 0;
+        vkGetSemaphoreCounterValue(LogicalDevice, GraphicsTimelineSemaphore, &CompletedValue);
+        TextureStreamer->BeginFrame(FrameIndex, Packet, CurrentCpuFrame + 1, CompletedValue);
+    }
 
-    vkResetCommandBuffer(CommandBuffers[ImageIndex], 0);
-    RecordCommandBuffers(CommandBuffers[ImageIndex], ImageIndex);
+    {
+        FVulkanProfiler::FCpuScope RecordScope(FrameProfiler, "RecordCommandBuffers");
+        vkResetCommandBuffer(CommandBuffers[FrameIndex], 0);
+        RecordCommandBuffers(CommandBuffers[FrameIndex], ImageIndex, FrameIndex, Packet);
+    }
 
-    if (CommandBuffers[ImageIndex] == VK_NULL_HANDLE) {
+    if (CommandBuffers[FrameIndex] == VK_NULL_HANDLE) {
         throw std::runtime_error("Command Buffer is NULL! Check CreateCommandBuffers.");
     }
 
@@ -709,13 +1493,14 @@ bool FVulkanDevice::RenderFrame()
     SignalInfos[0].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
 
     Utils::ZeroVulkanStruct(SignalInfos[1], VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
-    SignalInfos[1].semaphore = PresentSemaphores[ImageIndex]; // 当前图片的信号量
+    FPresentSync PresentSync = Swapchain->AcquirePresentSync(ImageIndex);
+    SignalInfos[1].semaphore = PresentSync.Semaphore; // 本次 Present 等待的信号量
     SignalInfos[1].value = 0;
     SignalInfos[1].stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
 
     VkCommandBufferSubmitInfo CommandBufferInfo{};
     Utils::ZeroVulkanStruct(CommandBufferInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO);
-    CommandBufferInfo.commandBuffer = CommandBuffers[ImageIndex];
+    CommandBufferInfo.commandBuffer = CommandBuffers[FrameIndex];
     
     VkSubmitInfo2 SubmitInfo{};
     Utils::ZeroVulkanStruct(SubmitInfo, VK_STRUCTURE_TYPE_SUBMIT_INFO_2);
@@ -726,22 +1511,67 @@ bool FVulkanDevice::RenderFrame()
     SubmitInfo.signalSemaphoreInfoCount = 2;
     SubmitInfo.pSignalSemaphoreInfos = SignalInfos;
 
-    if (vkQueueSubmit2(GraphicsQueue, 1, &SubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
     {
-        throw std::runtime_error("failed to submit draw command buffer!");
+        FVulkanProfiler::FCpuScope SubmitScope(FrameProfiler, "vkQueueSubmit2");
+        if (FrameProfiler)
+        {
+            FrameProfiler->MarkSubmit(FrameIndex, FVulkanProfiler::NowNs());
+        }
+
+        if (vkQueueSubmit2(GraphicsQueue, 1, &SubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to submit draw command buffer!");
+        }
     }
     
     VkPresentInfoKHR PresentInfo{};
     Utils::ZeroVulkanStruct(PresentInfo, VK_STRUCTURE_TYPE_PRESENT_INFO_KHR);
     PresentInfo.waitSemaphoreCount = 1;
-    PresentInfo.pWaitSemaphores = &PresentSemaphores[ImageIndex];
+    PresentInfo.pWaitSemaphores = &PresentSync.Semaphore;
     
     VkSwapchainKHR Swapchains[] = { Swapchain->GetHandle() };
     PresentInfo.swapchainCount = 1;
     PresentInfo.pSwapchains = Swapchains;
     PresentInfo.pImageIndices = &ImageIndex;
 
-    result = vkQueuePresentKHR(PresentQueue, &PresentInfo);
+    // pNext 链：Present ID -> Present Fence -> Present Mode
+    const void* PresentChain = nullptr;
+
+    VkPresentModeKHR PresentMode = Swapchain->GetVkPresentMode();
+    VkSwapchainPresentModeInfoEXT PresentModeInfo{};
+    Utils::ZeroVulkanStruct(PresentModeInfo, VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_MODE_INFO_EXT);
+    PresentModeInfo.swapchainCount = 1;
+    PresentModeInfo.pPresentModes = &PresentMode;
+
+    VkSwapchainPresentFenceInfoEXT PresentFenceInfo{};
+    Utils::ZeroVulkanStruct(PresentFenceInfo, VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT);
+    PresentFenceInfo.swapchainCount = 1;
+    PresentFenceInfo.pFences = &PresentSync.Fence;
+
+    if (PresentSync.Fence != VK_NULL_HANDLE)
+    {
+        PresentModeInfo.pNext = PresentChain;
+        PresentFenceInfo.pNext = &PresentModeInfo;
+        PresentChain = &PresentFenceInfo;
+    }
+
+    uint64_t PresentId = FramePacer->OnPresent(Swapchain->GetHandle(), CurrentCpuFrame, Packet.FrameStartNs);
+    VkPresentIdKHR PresentIdInfo{};
+    Utils::ZeroVulkanStruct(PresentIdInfo, VK_STRUCTURE_TYPE_PRESENT_ID_KHR);
+    PresentIdInfo.swapchainCount = 1;
+    PresentIdInfo.pPresentIds = &PresentId;
+    if (PresentId != 0)
+    {
+        PresentIdInfo.pNext = PresentChain;
+        PresentChain = &PresentIdInfo;
+    }
+    PresentInfo.pNext = PresentChain;
+
+    {
+        FVulkanProfiler::FCpuScope PresentScope(FrameProfiler, "vkQueuePresentKHR");
+        result = vkQueuePresentKHR(PresentQueue, &PresentInfo);
+    }
+    Swapchain->NotifyPresented(CurrentCpuFrame, PresentId, PresentSync);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
     {
@@ -757,6 +1587,36 @@ bool FVulkanDevice::RenderFrame()
 }
 
 
+void FVulkanDevice::SkipFrame(uint32_t FrameIndex)
+{
+    // Acquire 信号量已被发信号，提交一个空批次消费它，同时推进 Timeline，
+    // 这样该帧槽下一次复用时仍由正常的 Timeline 等待保护
+    CurrentCpuFrame++;
+
+    VkSemaphoreSubmitInfo WaitBinary{};
+    Utils::ZeroVulkanStruct(WaitBinary, VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
+    WaitBinary.semaphore = ImageAvailableSemaphores[FrameIndex];
+    WaitBinary.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkSemaphoreSubmitInfo SignalTimeline{};
+    Utils::ZeroVulkanStruct(SignalTimeline, VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
+    SignalTimeline.semaphore = GraphicsTimelineSemaphore;
+    SignalTimeline.value = CurrentCpuFrame;
+    SignalTimeline.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+    VkSubmitInfo2 SubmitInfo{};
+    Utils::ZeroVulkanStruct(SubmitInfo, VK_STRUCTURE_TYPE_SUBMIT_INFO_2);
+    SubmitInfo.waitSemaphoreInfoCount = 1;
+    SubmitInfo.pWaitSemaphoreInfos = &WaitBinary;
+    SubmitInfo.signalSemaphoreInfoCount = 1;
+    SubmitInfo.pSignalSemaphoreInfos = &SignalTimeline;
+
+    if (vkQueueSubmit2(GraphicsQueue, 1, &SubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit skipped frame!");
+    }
+}
+
 FSelectionResult FVulkanDevice::Select(VkInstance InInstance, VkSurfaceKHR InSurface)
 {
     uint32_t DeviceCount = 0;
@@ -906,8 +1766,7 @@ int FVulkanDevice::RateDeviceSuitability(VkPhysicalDevice InDevice, VkSurfaceKHR
     // 2. 最大纹理尺寸
     Score += DeviceProperties.limits.maxImageDimension2D;
 
-    std::cout << "Detected GPU: " << DeviceProperties.deviceName
-        << " | Score: " << Score << std::endl;
+    CA_LOG_INFO("Vulkan", "Detected GPU: {} | Score: {}", DeviceProperties.deviceName, Score);
 
     return Score;
 }
\ No newline at end of file
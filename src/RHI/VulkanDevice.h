@@ -2,8 +2,18 @@
 #include "Window.h"
 #include "vk_mem_alloc.h"
 #include "VulkanSwapchain.h"
+#include "VulkanProfiler.h"
+#include "VulkanFramePacer.h"
+#include "VulkanGpuCulling.h"
+#include "VulkanClusteredLighting.h"
+#include "VulkanDepthTarget.h"
+#include "VulkanMeshletRenderer.h"
+#include "VulkanStagingUploader.h"
+#include "VulkanTextureStreamer.h"
 #include "RHI/RHIDevice.h"
 
+struct FFramePacket;
+
 struct FQueueFamilyIndices
 {
     std::optional<uint32_t> GraphicsFamily;
@@ -30,6 +40,7 @@ public:
     FVulkanDevice(FWindow& WindowObj);
     ~FVulkanDevice();
 
+    VkInstance GetInstance() const { check(Instance != VK_NULL_HANDLE); return Instance; }
     VkPhysicalDevice GetPhysicalDevice() const { check(PhysicalDevice != VK_NULL_HANDLE); return PhysicalDevice; }
     VkDevice GetLogicalDevice() const { check(LogicalDevice != VK_NULL_HANDLE); return LogicalDevice; }
     
@@ -42,12 +53,56 @@ public:
     VkSurfaceKHR GetSurface() const { check(Surface != VK_NULL_HANDLE); return Surface; }
     FQueueFamilyIndices GetQueueFamilyIndices() const { return QueueIndices; }
     FVulkanSwapchain& GetSwapchain() const { check(Swapchain); return *Swapchain; }
+    FVulkanProfiler* GetProfiler() const { return Profiler.get(); }
+    FVulkanFramePacer& GetFramePacer() const { check(FramePacer); return *FramePacer; }
+    FVulkanStagingUploader& GetStagingUploader() const { check(StagingUploader); return *StagingUploader; }
+
+    bool IsDeviceExtensionEnabled(const char* Name) const { return EnabledDeviceExtensions.contains(Name); }
+    bool IsPresentWaitEnabled() const { return bPresentWaitEnabled; }
+    bool IsSwapchainMaintenance1Enabled() const { return bSwapchainMaintenance1Enabled; }
+    // GPU 剔除 + 间接绘制：需要 drawIndirectCount / multiDrawIndirect / drawIndirectFirstInstance
+    bool IsGpuCullingEnabled() const { return GpuCulling != nullptr; }
+    // 两阶段 Hi-Z 遮挡剔除 (建立在 GPU 剔除之上)
+    bool IsOcclusionCullingEnabled() const { return GpuCulling && GpuCulling->IsOcclusionCullingEnabled(); }
+    // 网格簇渲染：GPU 上逐簇剔除，代替实例级的 GPU 剔除
+    bool IsMeshletRenderingEnabled() const { return MeshletRenderer != nullptr; }
+    // 网格簇的 LOD 误差表 (见 FVulkanMeshletRenderer::GetLodErrors)，未启用网格簇渲染时为空
+    std::span<const float> GetMeshletLodErrors() const { return MeshletRenderer ? MeshletRenderer->GetLodErrors() : std::span<const float>(); }
+    // 纹理流送：建立在网格簇渲染之上，需要 shaderSampledImageArrayNonUniformIndexing
+    bool IsTextureStreamingEnabled() const { return TextureStreamer != nullptr; }
+    // 分簇前向光照：三角形绘制路径 (CPU 绘制列表与 GPU 驱动) 的颜色 Pass，网格簇渲染不使用
+    bool IsClusteredLightingEnabled() const { return ClusteredLighting != nullptr; }
 
     static FSelectionResult Select(VkInstance Instance, VkSurfaceKHR Surface);
 
     void Init();
     void RecreateSwapchain();
-    bool RenderFrame();
+    void SetPresentPolicy(const FPresentPolicy& InPolicy);
+    // Init 之前调用；设备不支持时 Init 会退回 CPU 剔除
+    void SetGpuCullingRequested(bool bRequested) { bGpuCullingRequested = bRequested; }
+    void SetOcclusionCullingRequested(bool bRequested) { bOcclusionCullingRequested = bRequested; }
+    // Init 之前调用；不支持 VK_EXT_mesh_shader 或未请求时走计算剔除 + 间接绘制
+    void SetMeshletRenderingRequested(bool bRequested) { bMeshletRenderingRequested = bRequested; }
+    void SetMeshShaderRequested(bool bRequested) { bMeshShaderRequested = bRequested; }
+    // Init 之前调用；为空时网格簇渲染使用内置的圆环
+    void SetMeshAssetPath(const std::filesystem::path& InPath) { MeshAssetPath = InPath; }
+    // Init 之前调用；目录下的 .ctex 按 mip 流送，为空时不启用
+    void SetTextureStreaming(const std::filesystem::path& InDirectory, const FTextureStreamingConfig& InConfig)
+    {
+        TextureDirectory = InDirectory;
+        TextureStreamingConfig = InConfig;
+    }
+    // Init 之前调用；网格簇渲染时忽略
+    void SetClusteredLightingRequested(bool bRequested) { bClusteredLightingRequested = bRequested; }
+    // 深度预渲染：Init 之前调用，只影响命令录制
+    void SetDepthPrepass(bool bEnabled) { bDepthPrepass = bEnabled; }
+    bool IsDepthPrepassEnabled() const { return bDepthPrepass; }
+    // RHI 阶段：按帧包录制、提交并呈现。返回 false 表示交换链需要重建，帧包未被消费
+    // GPU 剔除时把回读到的剔除数写回 Packet.CulledCount / Packet.OcclusionCulledCount，网格簇渲染时写回 Packet.ClusterCount / Packet.ClusterCulledCount
+    // 分簇光照时写回 Packet.LightIndexCount
+    bool RenderFrame(FFramePacket& Packet);
+
+    VkShaderModule CreateShaderModule(const std::vector<char>& InCode) const;
 
 private:
     static FQueueFamilyIndices FindQueueFamilies(VkPhysicalDevice Device, VkSurfaceKHR Surface);
@@ -63,16 +118,35 @@ private:
     void CreateAllocator();
     void TestVMA();
 
-    VkShaderModule CreateShaderModule(const std::vector<char>& InCode) const;
+    // 深度缓冲跟随交换链尺寸，同时作为 Hi-Z 的输入
+    void ResizeDepthTarget();
+    // 等待所有已提交的帧在 GPU 上完成 (重建它们共用的管线之前)
+    void WaitForSubmittedFrames();
+
     void CreatePipelineLayout();
 
-    void CreateGraphicsPipeline();
+    // CPU 绘制列表管线 + GPU 驱动管线 (启用时)，各带一个纯深度变体；交换链格式变化时整体重建
+    // 分簇光照时两者的颜色变体使用 Triangle.hlsl 的 PSClustered
+    void CreateGraphicsPipelines();
+    void DestroyGraphicsPipelines();
+    struct FShaderStageDesc
+    {
+        const char* File;
+        const char* EntryPoint;
+        VkShaderStageFlagBits Stage;
+    };
+    // bDepthOnly: 只有顶点阶段 (入口 VSDepthOnly)，不写颜色
+    VkPipeline CreateGraphicsPipeline(const char* VertexShaderFile, VkPipelineLayout InLayout, bool bDepthOnly) const;
+    // Stages: 顶点阶段，或任务 + 网格阶段；不含片元阶段时使用 Triangle.frag (bDepthOnly 时省略)
+    VkPipeline CreateGraphicsPipeline(std::initializer_list<FShaderStageDesc> Stages, VkPipelineLayout InLayout,
+        bool bDepthOnly, VkFrontFace FrontFace) const;
 
     void CreateCommandPool();
     void CreateCommandBuffers();
 
-    void RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32_t InImageIndex);
+    void RecordCommandBuffers(VkCommandBuffer InCommandBuffer, uint32_t InImageIndex, uint32_t InFrameIndex, const FFramePacket& Packet);
     void CreateSyncObjects();
+    void SkipFrame(uint32_t FrameIndex);
 
     FWindow& WindowRef;
 
@@ -81,6 +155,22 @@ private:
     VkSurfaceKHR Surface = VK_NULL_HANDLE;
     VkPhysicalDevice PhysicalDevice = VK_NULL_HANDLE;
     VkDevice LogicalDevice = VK_NULL_HANDLE;
+    std::set<std::string> EnabledDeviceExtensions;
+    bool bPresentWaitEnabled = false;
+    bool bSurfaceMaintenance1Enabled = false;
+    bool bSwapchainMaintenance1Enabled = false;
+    bool bGpuCullingRequested = true;
+    bool bGpuCullingSupported = false;
+    bool bOcclusionCullingRequested = true;
+    bool bMeshletRenderingRequested = false;
+    bool bMeshShaderRequested = true;
+    bool bMeshShaderSupported = false;
+    std::filesystem::path MeshAssetPath;
+    std::filesystem::path TextureDirectory;
+    FTextureStreamingConfig TextureStreamingConfig;
+    bool bTextureStreamingSupported = false;
+    bool bClusteredLightingRequested = false;
+    bool bDepthPrepass = false;
 
     FQueueFamilyIndices QueueIndices;
     VkQueue GraphicsQueue = VK_NULL_HANDLE;
@@ -88,17 +178,33 @@ private:
     VkQueue ComputeQueue = VK_NULL_HANDLE;
 
     VmaAllocator Allocator = VK_NULL_HANDLE;
+    std::unique_ptr<FVulkanStagingUploader> StagingUploader;
 
+    FPresentPolicy PresentPolicy;
     std::unique_ptr<class FVulkanSwapchain> Swapchain;
 
+    std::unique_ptr<FVulkanDepthTarget> DepthTarget;
+
     VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
     VkPipeline GraphicsPipeline = VK_NULL_HANDLE;
+    VkPipeline DepthOnlyPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout IndirectPipelineLayout = VK_NULL_HANDLE;
+    VkPipeline IndirectPipeline = VK_NULL_HANDLE;
+    VkPipeline IndirectDepthOnlyPipeline = VK_NULL_HANDLE;
+    VkPipeline MeshletPipeline = VK_NULL_HANDLE;
+    VkPipeline MeshletDepthOnlyPipeline = VK_NULL_HANDLE;
     VkCommandPool CommandPool = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> CommandBuffers;
 
     std::vector<VkSemaphore> ImageAvailableSemaphores;
-    std::vector<VkSemaphore> PresentSemaphores;
     VkSemaphore GraphicsTimelineSemaphore = VK_NULL_HANDLE;
     uint64_t CurrentCpuFrame = 0;
     uint64_t CurrentGpuFrame = 0;
+
+    std::unique_ptr<FVulkanProfiler> Profiler;
+    std::unique_ptr<FVulkanFramePacer> FramePacer;
+    std::unique_ptr<FVulkanGpuCulling> GpuCulling;
+    std::unique_ptr<FVulkanMeshletRenderer> MeshletRenderer;
+    std::unique_ptr<FVulkanTextureStreamer> TextureStreamer;
+    std::unique_ptr<FVulkanClusteredLighting> ClusteredLighting;
 };
\ No newline at end of file
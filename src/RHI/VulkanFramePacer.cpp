@@ -0,0 +1,229 @@
+﻿#include "VulkanFramePacer.h"
+#include "VulkanDevice.h"
+
+FVulkanFramePacer::FVulkanFramePacer(FVulkanDevice& InDevice, VkSemaphore InTimelineSemaphore)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), TimelineSemaphore(InTimelineSemaphore)
+{
+    if (DeviceRef.IsPresentWaitEnabled())
+    {
+        pfnWaitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(LogicalDevice, "vkWaitForPresentKHR");
+        bPresentWaitSupported = pfnWaitForPresent != nullptr;
+    }
+
+    CA_LOG_INFO("FramePacer", "{}", bPresentWaitSupported
+        ? "Present ID / Present Wait enabled."
+        : "Present Wait unavailable, latency measured to GPU completion.");
+
+    LatencySamples.reserve(MAX_LATENCY_SAMPLES);
+    WaiterThread = std::thread(&FVulkanFramePacer::WaiterThreadMain, this);
+}
+
+FVulkanFramePacer::~FVulkanFramePacer()
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bStopRequested = true;
+    }
+    QueueCV.notify_all();
+
+    if (WaiterThread.joinable())
+    {
+        WaiterThread.join();
+    }
+
+    PrintLatencyStats();
+}
+
+void FVulkanFramePacer::SetLowLatencyMode(bool bEnable)
+{
+    bLowLatencyMode = bEnable;
+    CA_LOG_INFO("FramePacer", "Low latency mode {}", bEnable ? "ON" : "OFF");
+}
+
+uint64_t FVulkanFramePacer::WaitForFrameStart()
+{
+    const uint64_t WaitPresentId = LastSubmittedPresentId.load(std::memory_order_acquire);
+    if (bLowLatencyMode && bPresentWaitSupported && WaitPresentId > 0)
+    {
+        std::unique_lock<std::mutex> Lock(Mutex);
+
+        // 1. 等上一帧真正上屏：CPU 最多领先显示一帧
+        CompletionCV.wait_for(Lock, std::chrono::nanoseconds(WAIT_TIMEOUT_NS), [this]()
+            {
+                return LastCompletedPresentId >= WaitPresentId || bStopRequested;
+            });
+
+        // 2. 推迟到 "下一次上屏 - 预计帧耗时 - 余量"，让输入采样尽量晚
+        if (LastCompletedPresentId >= WaitPresentId && RefreshIntervalNs > 0.0)
+        {
+            double SlackNs = RefreshIntervalNs - FrameCostNs - static_cast<double>(PACING_MARGIN_NS);
+            uint64_t WakeNs = LastPresentDoneNs + static_cast<uint64_t>(std::max(SlackNs, 0.0));
+            Lock.unlock();
+
+            uint64_t NowNs = Utils::GetTimeNs();
+            if (WakeNs > NowNs)
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(WakeNs - NowNs));
+            }
+        }
+    }
+
+    return Utils::GetTimeNs();
+}
+
+uint64_t FVulkanFramePacer::OnPresent(VkSwapchainKHR InSwapchain, uint64_t InTimelineValue, uint64_t InFrameStartNs)
+{
+    FPendingPresent Present;
+    Present.Swapchain = InSwapchain;
+    Present.PresentId = bPresentWaitSupported ? NextPresentId++ : 0;
+    Present.TimelineValue = InTimelineValue;
+    Present.FrameStartNs = InFrameStartNs != 0 ? InFrameStartNs : Utils::GetTimeNs();
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        PendingPresents.push_back(Present);
+    }
+    QueueCV.notify_one();
+
+    if (Present.PresentId != 0)
+    {
+        LastSubmittedPresentId.store(Present.PresentId, std::memory_order_release);
+    }
+    return Present.PresentId;
+}
+
+void FVulkanFramePacer::WaiterThreadMain()
+{
+    while (true)
+    {
+        FPendingPresent Present;
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            QueueCV.wait(Lock, [this]() { return !PendingPresents.empty() || bStopRequested; });
+            if (bStopRequested)
+            {
+                return;
+            }
+
+            Present = PendingPresents.front();
+            PendingPresents.pop_front();
+        }
+
+        // 1. GPU 完成该帧
+        VkSemaphoreWaitInfo WaitInfo{};
+        Utils::ZeroVulkanStruct(WaitInfo, VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO);
+        WaitInfo.semaphoreCount = 1;
+        WaitInfo.pSemaphores = &TimelineSemaphore;
+        WaitInfo.pValues = &Present.TimelineValue;
+
+        VkResult Result = VK_TIMEOUT;
+        while (Result == VK_TIMEOUT && !bStopRequested)
+        {
+            Result = vkWaitSemaphores(LogicalDevice, &WaitInfo, WAIT_TIMEOUT_NS);
+        }
+        uint64_t GpuDoneNs = Utils::GetTimeNs();
+
+        // 2. 真正上屏 (交换链过期/被替换时会返回 OUT_OF_DATE，直接丢弃该样本)
+        bool bPresented = false;
+        uint64_t PresentDoneNs = GpuDoneNs;
+        if (Result == VK_SUCCESS && Present.PresentId != 0)
+        {
+            Result = VK_TIMEOUT;
+            for (int Attempt = 0; Result == VK_TIMEOUT && Attempt < 10 && !bStopRequested; Attempt++)
+            {
+                Result = pfnWaitForPresent(LogicalDevice, Present.Swapchain, Present.PresentId, WAIT_TIMEOUT_NS);
+            }
+            bPresented = Result == VK_SUCCESS || Result == VK_SUBOPTIMAL_KHR;
+            PresentDoneNs = Utils::GetTimeNs();
+        }
+
+        bool bShouldReport = RecordCompletion(Present, GpuDoneNs, PresentDoneNs, bPresented);
+        CompletionCV.notify_all();
+
+        if (bShouldReport)
+        {
+            PrintLatencyStats();
+        }
+    }
+}
+
+bool FVulkanFramePacer::RecordCompletion(const FPendingPresent& Present, uint64_t GpuDoneNs, uint64_t PresentDoneNs, bool bPresented)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    constexpr double EmaAlpha = 0.1;
+    double Cost = static_cast<double>(GpuDoneNs - std::min(GpuDoneNs, Present.FrameStartNs));
+    FrameCostNs = FrameCostNs == 0.0 ? Cost : FrameCostNs + (Cost - FrameCostNs) * EmaAlpha;
+
+    if (Present.PresentId != 0)
+    {
+        if (bPresented && LastPresentDoneNs != 0 && Present.PresentId == LastCompletedPresentId + 1)
+        {
+            double Interval = static_cast<double>(PresentDoneNs - LastPresentDoneNs);
+            RefreshIntervalNs = RefreshIntervalNs == 0.0 ? Interval : RefreshIntervalNs + (Interval - RefreshIntervalNs) * EmaAlpha;
+        }
+        LastCompletedPresentId = Present.PresentId;
+        LastPresentDoneNs = PresentDoneNs;
+
+        if (!bPresented)
+        {
+            return false;
+        }
+    }
+
+    uint64_t EndNs = bPresentWaitSupported ? PresentDoneNs : GpuDoneNs;
+    uint64_t Latency = EndNs - std::min(EndNs, Present.FrameStartNs);
+    if (LatencySamples.size() < MAX_LATENCY_SAMPLES)
+    {
+        LatencySamples.push_back(Latency);
+    }
+    else
+    {
+        LatencySamples[LatencyHead] = Latency;
+        LatencyHead = (LatencyHead + 1) % MAX_LATENCY_SAMPLES;
+    }
+
+    return ++CompletedCount % REPORT_INTERVAL == 0;
+}
+
+FLatencyStats FVulkanFramePacer::GetLatencyStats() const
+{
+    std::vector<uint64_t> Samples;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Samples = LatencySamples;
+    }
+
+    FLatencyStats Stats;
+    Stats.SampleCount = Samples.size();
+    if (Samples.empty())
+    {
+        return Stats;
+    }
+
+    std::sort(Samples.begin(), Samples.end());
+    auto Percentile = [&Samples](double P)
+        {
+            size_t Index = static_cast<size_t>(P * (Samples.size() - 1) + 0.5);
+            return static_cast<double>(Samples[Index]) / 1'000'000.0;
+        };
+
+    Stats.P50Ms = Percentile(0.50);
+    Stats.P90Ms = Percentile(0.90);
+    Stats.P99Ms = Percentile(0.99);
+    Stats.MaxMs = static_cast<double>(Samples.back()) / 1'000'000.0;
+    return Stats;
+}
+
+void FVulkanFramePacer::PrintLatencyStats() const
+{
+    FLatencyStats Stats = GetLatencyStats();
+    if (Stats.SampleCount == 0)
+    {
+        return;
+    }
+
+    CA_LOG_INFO("FramePacer", "{} latency ({} samples, {}): p50 {} ms, p90 {} ms, p99 {} ms, max {} ms",
+        bPresentWaitSupported ? "Input->Present" : "Input->GPU Done", Stats.SampleCount,
+        bLowLatencyMode ? "low latency" : "default", Stats.P50Ms, Stats.P90Ms, Stats.P99Ms, Stats.MaxMs);
+}
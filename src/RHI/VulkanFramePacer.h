@@ -0,0 +1,108 @@
+﻿#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
+class FVulkanDevice;
+
+struct FLatencyStats
+{
+    uint64_t SampleCount = 0;
+    double P50Ms = 0.0;
+    double P90Ms = 0.0;
+    double P99Ms = 0.0;
+    double MaxMs = 0.0;
+};
+
+// 帧节奏控制 (VK_KHR_present_id + VK_KHR_present_wait)
+// - 每次 Present 带上单调递增的 Present ID，后台线程用 vkWaitForPresentKHR 等待其真正上屏
+// - 统计 "输入采样 -> 上屏" 延迟分位数
+// - 低延迟模式：有效队列深度降为 1，并把 CPU 帧开始推迟到下一次上屏前刚好来得及的时刻
+// 不支持 present_wait 时退化为 "输入采样 -> GPU 完成" 延迟，低延迟模式仅降低队列深度
+class FVulkanFramePacer
+{
+public:
+    // 延迟样本环形缓冲容量
+    static constexpr size_t MAX_LATENCY_SAMPLES = 1024;
+    // 每隔多少次上屏打印一次统计
+    static constexpr uint64_t REPORT_INTERVAL = 600;
+    // 推迟帧开始时预留的安全余量
+    static constexpr uint64_t PACING_MARGIN_NS = 1'000'000ull;
+    // 单次等待超时，防止窗口最小化/重建时卡死
+    static constexpr uint64_t WAIT_TIMEOUT_NS = 100'000'000ull;
+
+    FVulkanFramePacer(FVulkanDevice& InDevice, VkSemaphore InTimelineSemaphore);
+    ~FVulkanFramePacer();
+
+    FVulkanFramePacer(const FVulkanFramePacer&) = delete;
+    FVulkanFramePacer& operator=(const FVulkanFramePacer&) = delete;
+
+    // Update 阶段在采样输入之前调用，低延迟模式下会在这里阻塞；返回帧开始时刻 (随帧包传到 RHI 阶段)
+    uint64_t WaitForFrameStart();
+
+    // Present 之前调用 (渲染线程)，返回需要挂到 VkPresentIdKHR 上的 ID (不支持时返回 0)
+    uint64_t OnPresent(VkSwapchainKHR InSwapchain, uint64_t InTimelineValue, uint64_t InFrameStartNs);
+
+    // 后台线程已处理完的最大 Present ID，退休交换链据此判断最后一次 Present 是否完成
+    uint64_t GetLastCompletedPresentId() const
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return LastCompletedPresentId;
+    }
+
+    void SetLowLatencyMode(bool bEnable);
+    bool IsLowLatencyMode() const { return bLowLatencyMode; }
+    bool IsPresentWaitSupported() const { return bPresentWaitSupported; }
+
+    // 有效队列深度：RenderFrame 据此决定等待 Timeline 的哪一帧
+    uint32_t GetQueueDepth() const { return bLowLatencyMode ? 1u : static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT); }
+
+    FLatencyStats GetLatencyStats() const;
+    void PrintLatencyStats() const;
+
+private:
+    struct FPendingPresent
+    {
+        VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
+        uint64_t PresentId = 0;
+        uint64_t TimelineValue = 0;
+        uint64_t FrameStartNs = 0;
+    };
+
+    void WaiterThreadMain();
+    // 返回 true 表示达到打印间隔
+    bool RecordCompletion(const FPendingPresent& Present, uint64_t GpuDoneNs, uint64_t PresentDoneNs, bool bPresented);
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VkSemaphore TimelineSemaphore = VK_NULL_HANDLE;
+
+    bool bPresentWaitSupported = false;
+    PFN_vkWaitForPresentKHR pfnWaitForPresent = nullptr;
+
+    std::atomic<bool> bLowLatencyMode = false;
+
+    // 渲染线程写，Update 线程读
+    uint64_t NextPresentId = 1;
+    std::atomic<uint64_t> LastSubmittedPresentId = 0;
+
+    // 与后台线程共享
+    mutable std::mutex Mutex;
+    std::condition_variable QueueCV;
+    std::condition_variable CompletionCV;
+    std::deque<FPendingPresent> PendingPresents;
+    std::atomic<bool> bStopRequested = false;
+
+    uint64_t LastCompletedPresentId = 0;
+    uint64_t LastPresentDoneNs = 0;
+    double RefreshIntervalNs = 0.0;  // 相邻两次上屏间隔 (EMA)
+    double FrameCostNs = 0.0;        // 帧开始 -> GPU 完成 (EMA)
+
+    std::vector<uint64_t> LatencySamples;
+    size_t LatencyHead = 0;
+    uint64_t CompletedCount = 0;
+
+    std::thread WaiterThread;
+};
@@ -0,0 +1,574 @@
+﻿#include "VulkanGpuCulling.h"
+#include "VulkanDevice.h"
+#include "Renderer/FramePacket.h"
+
+namespace {
+    enum EBinding : uint32_t
+    {
+        BINDING_INSTANCES = 0,
+        BINDING_DRAW_RECORDS,
+        BINDING_INDIRECT_COMMANDS,
+        BINDING_COUNTERS,
+        BINDING_VISIBILITY,
+        BINDING_HIZ,
+        BINDING_CULL_DATA,
+        BINDING_COUNT,
+    };
+
+    // 计数器下标，与 GpuCulling.hlsl 一致
+    enum ECounter : uint32_t
+    {
+        COUNTER_EARLY_DRAWS = 0,
+        COUNTER_LATE_DRAWS,
+        COUNTER_FRUSTUM_CULLED,
+        COUNTER_OCCLUSION_CULLED,
+        COUNTER_COUNT,
+    };
+
+    // 布局与 GpuCulling.hlsl 中 FDrawRecord 一致
+    struct FDrawRecord
+    {
+        uint32_t IndexCount;
+        uint32_t FirstIndex;
+        int32_t VertexOffset;
+        uint32_t InstanceIndex;
+    };
+
+    // 布局与 GpuCulling.hlsl 中 FCullData 一致 (std140)
+    struct FCullData
+    {
+        FMatrix4 ViewProjection;
+        FVector4 FrustumPlanes[FFrustum::Count];
+        uint32_t InstanceCount;
+        uint32_t HiZMipCount;
+        uint32_t HiZWidth;
+        uint32_t HiZHeight;
+    };
+    static_assert(sizeof(FCullData) == 176, "FCullData layout must match GpuCulling.hlsl");
+
+    // 布局与 GpuCulling.hlsl 中 FCullConstants 一致
+    struct FCullConstants
+    {
+        uint32_t Phase;
+        uint32_t bOcclusion;
+        uint32_t CommandOffset;
+        uint32_t Padding;
+    };
+
+    // 实例直接按帧包中的内存布局上传，与着色器中 FGpuInstance 一致
+    static_assert(sizeof(FInstanceState) == 96, "FInstanceState layout must match FGpuInstance");
+    static_assert(offsetof(FInstanceState, Bounds) == 64 && offsetof(FInstanceState, Color) == 80,
+        "FInstanceState layout must match FGpuInstance");
+
+    constexpr uint16_t TRIANGLE_INDICES[] = { 0, 1, 2 };
+
+    uint32_t RoundUpPowerOfTwo(uint32_t Value)
+    {
+        uint32_t Result = 1;
+        while (Result < Value)
+        {
+            Result <<= 1;
+        }
+        return Result;
+    }
+}
+
+FVulkanGpuCulling::FVulkanGpuCulling(FVulkanDevice& InDevice, bool bInOcclusionCulling)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator()),
+    bOcclusionCulling(bInOcclusionCulling)
+{
+    HiZ = std::make_unique<FVulkanHiZBuffer>(InDevice);
+
+    CreateDescriptors();
+    CreateCullingPipeline();
+    CreateIndexBuffer();
+
+    GrowVisibility(MIN_INSTANCE_CAPACITY);
+    for (FFrameResources& Frame : Frames)
+    {
+        ResizeFrame(Frame, MIN_INSTANCE_CAPACITY);
+    }
+
+    CA_LOG_INFO("GpuCulling", "GPU-driven rendering enabled (compute frustum{} culling + vkCmdDrawIndexedIndirectCount).",
+        bOcclusionCulling ? " + two-phase Hi-Z occlusion" : "");
+}
+
+FVulkanGpuCulling::~FVulkanGpuCulling()
+{
+    for (FFrameResources& Frame : Frames)
+    {
+        DestroyFrame(Frame);
+    }
+    for (FRetiredBuffer& Retired : RetiredBuffers)
+    {
+        DestroyBuffer(Retired.Buffer);
+    }
+    DestroyBuffer(Visibility);
+    DestroyBuffer(IndexBuffer);
+    HiZ.reset();
+
+    if (CullPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(LogicalDevice, CullPipeline, nullptr);
+    }
+    if (CullPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, CullPipelineLayout, nullptr);
+    }
+    if (DescriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(LogicalDevice, DescriptorPool, nullptr);
+    }
+    if (DescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(LogicalDevice, DescriptorSetLayout, nullptr);
+    }
+}
+
+FVulkanGpuCulling::FBuffer FVulkanGpuCulling::CreateBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, VmaAllocationCreateFlags Flags) const
+{
+    VkBufferCreateInfo BufferInfo{};
+    Utils::ZeroVulkanStruct(BufferInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    BufferInfo.size = Size;
+    BufferInfo.usage = Usage;
+    BufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    AllocInfo.flags = Flags;
+
+    FBuffer Result;
+    VmaAllocationInfo AllocationInfo{};
+    if (vmaCreateBuffer(Allocator, &BufferInfo, &AllocInfo, &Result.Buffer, &Result.Allocation, &AllocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create GPU culling buffer!");
+    }
+    Result.Mapped = AllocationInfo.pMappedData;
+    return Result;
+}
+
+void FVulkanGpuCulling::DestroyBuffer(FBuffer& InBuffer) const
+{
+    if (InBuffer.Buffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator, InBuffer.Buffer, InBuffer.Allocation);
+    }
+    InBuffer = FBuffer();
+}
+
+void FVulkanGpuCulling::CreateDescriptors()
+{
+    VkDescriptorSetLayoutBinding Bindings[BINDING_COUNT]{};
+    for (uint32_t i = 0; i < BINDING_COUNT; i++)
+    {
+        Bindings[i].binding = i;
+        Bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        Bindings[i].descriptorCount = 1;
+        Bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    Bindings[BINDING_HIZ].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    Bindings[BINDING_CULL_DATA].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    // 顶点着色器按 SV_InstanceID (= firstInstance) 读取实例变换
+    Bindings[BINDING_INSTANCES].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo LayoutInfo{};
+    Utils::ZeroVulkanStruct(LayoutInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
+    LayoutInfo.bindingCount = BINDING_COUNT;
+    LayoutInfo.pBindings = Bindings;
+    if (vkCreateDescriptorSetLayout(LogicalDevice, &LayoutInfo, nullptr, &DescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create GPU culling descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize PoolSizes[3]{};
+    PoolSizes[0] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (BINDING_COUNT - 2) * MAX_FRAMES_IN_FLIGHT };
+    PoolSizes[1] = { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, MAX_FRAMES_IN_FLIGHT };
+    PoolSizes[2] = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT };
+
+    VkDescriptorPoolCreateInfo PoolInfo{};
+    Utils::ZeroVulkanStruct(PoolInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO);
+    PoolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    PoolInfo.poolSizeCount = static_cast<uint32_t>(std::size(PoolSizes));
+    PoolInfo.pPoolSizes = PoolSizes;
+    if (vkCreateDescriptorPool(LogicalDevice, &PoolInfo, nullptr, &DescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create GPU culling descriptor pool!");
+    }
+
+    // 描述符集常驻，扩容时只重写其中的缓冲
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> Layouts;
+    Layouts.fill(DescriptorSetLayout);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> Sets;
+
+    VkDescriptorSetAllocateInfo AllocInfo{};
+    Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO);
+    AllocInfo.descriptorPool = DescriptorPool;
+    AllocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    AllocInfo.pSetLayouts = Layouts.data();
+    if (vkAllocateDescriptorSets(LogicalDevice, &AllocInfo, Sets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate GPU culling descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        Frames[i].DescriptorSet = Sets[i];
+    }
+}
+
+void FVulkanGpuCulling::CreateCullingPipeline()
+{
+    VkPushConstantRange PushConstantRange{};
+    PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    PushConstantRange.offset = 0;
+    PushConstantRange.size = sizeof(FCullConstants);
+
+    VkPipelineLayoutCreateInfo PipelineLayoutInfo{};
+    Utils::ZeroVulkanStruct(PipelineLayoutInfo, VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO);
+    PipelineLayoutInfo.setLayoutCount = 1;
+    PipelineLayoutInfo.pSetLayouts = &DescriptorSetLayout;
+    PipelineLayoutInfo.pushConstantRangeCount = 1;
+    PipelineLayoutInfo.pPushConstantRanges = &PushConstantRange;
+    if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &CullPipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create GPU culling pipeline layout!");
+    }
+
+    VkPipelineShaderStageCreateInfo StageInfo{};
+    Utils::ZeroVulkanStruct(StageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
+    StageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    StageInfo.module = DeviceRef.CreateShaderModule(Utils::ReadSPV("GpuCulling.comp.spv"));
+    StageInfo.pName = "CSMain";
+
+    VkComputePipelineCreateInfo PipelineInfo{};
+    Utils::ZeroVulkanStruct(PipelineInfo, VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO);
+    PipelineInfo.stage = StageInfo;
+    PipelineInfo.layout = CullPipelineLayout;
+    PipelineInfo.basePipelineIndex = -1;
+
+    VkResult Result = vkCreateComputePipelines(LogicalDevice, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &CullPipeline);
+    vkDestroyShaderModule(LogicalDevice, StageInfo.module, nullptr);
+    if (Result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create GPU culling pipeline!");
+    }
+}
+
+void FVulkanGpuCulling::CreateIndexBuffer()
+{
+    IndexBuffer = CreateBuffer(sizeof(TRIANGLE_INDICES), VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    std::memcpy(IndexBuffer.Mapped, TRIANGLE_INDICES, sizeof(TRIANGLE_INDICES));
+    vmaFlushAllocation(Allocator, IndexBuffer.Allocation, 0, VK_WHOLE_SIZE);
+}
+
+void FVulkanGpuCulling::ResizeFrame(FFrameResources& Frame, uint32_t Capacity)
+{
+    DestroyFrame(Frame);
+
+    // 实例与绘制记录只由 Host 顺序写入；在支持 ReBAR 的设备上 VMA 会直接放进显存
+    constexpr VmaAllocationCreateFlags UploadFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    Frame.Instances = CreateBuffer(sizeof(FInstanceState) * Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, UploadFlags);
+    Frame.DrawRecords = CreateBuffer(sizeof(FDrawRecord) * Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, UploadFlags);
+    Frame.IndirectCommands = CreateBuffer(sizeof(VkDrawIndexedIndirectCommand) * Capacity * 2,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, 0);
+    Frame.Counters = CreateBuffer(sizeof(uint32_t) * COUNTER_COUNT,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    Frame.CullData = CreateBuffer(sizeof(FCullData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, UploadFlags);
+    Frame.Capacity = Capacity;
+
+    // 每个实例对应一条绘制记录；场景只有一个网格，记录内容与帧无关，创建时一次写好
+    FDrawRecord* Records = static_cast<FDrawRecord*>(Frame.DrawRecords.Mapped);
+    for (uint32_t i = 0; i < Capacity; i++)
+    {
+        Records[i] = { static_cast<uint32_t>(std::size(TRIANGLE_INDICES)), 0, 0, i };
+    }
+    vmaFlushAllocation(Allocator, Frame.DrawRecords.Allocation, 0, VK_WHOLE_SIZE);
+
+    constexpr uint32_t BufferBindings[] = { BINDING_INSTANCES, BINDING_DRAW_RECORDS, BINDING_INDIRECT_COMMANDS, BINDING_COUNTERS, BINDING_CULL_DATA };
+    const FBuffer* Buffers[] = { &Frame.Instances, &Frame.DrawRecords, &Frame.IndirectCommands, &Frame.Counters, &Frame.CullData };
+    constexpr uint32_t WriteCount = static_cast<uint32_t>(std::size(BufferBindings));
+    VkDescriptorBufferInfo BufferInfos[WriteCount];
+    VkWriteDescriptorSet Writes[WriteCount];
+    for (uint32_t i = 0; i < WriteCount; i++)
+    {
+        BufferInfos[i].buffer = Buffers[i]->Buffer;
+        BufferInfos[i].offset = 0;
+        BufferInfos[i].range = VK_WHOLE_SIZE;
+
+        Utils::ZeroVulkanStruct(Writes[i], VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        Writes[i].dstSet = Frame.DescriptorSet;
+        Writes[i].dstBinding = BufferBindings[i];
+        Writes[i].descriptorCount = 1;
+        Writes[i].descriptorType = BufferBindings[i] == BINDING_CULL_DATA ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        Writes[i].pBufferInfo = &BufferInfos[i];
+    }
+    vkUpdateDescriptorSets(LogicalDevice, WriteCount, Writes, 0, nullptr);
+
+    WriteVisibilityDescriptor(Frame);
+}
+
+void FVulkanGpuCulling::DestroyFrame(FFrameResources& Frame)
+{
+    DestroyBuffer(Frame.Instances);
+    DestroyBuffer(Frame.DrawRecords);
+    DestroyBuffer(Frame.IndirectCommands);
+    DestroyBuffer(Frame.Counters);
+    DestroyBuffer(Frame.CullData);
+    Frame.Capacity = 0;
+    Frame.InstanceCount = 0;
+    Frame.bSubmitted = false;
+}
+
+void FVulkanGpuCulling::GrowVisibility(uint32_t Capacity)
+{
+    PendingVisibilitySource = VK_NULL_HANDLE;
+    PendingVisibilityBytes = 0;
+    if (Visibility.Buffer != VK_NULL_HANDLE)
+    {
+        PendingVisibilitySource = Visibility.Buffer;
+        PendingVisibilityBytes = sizeof(uint32_t) * VisibilityCapacity;
+        RetiredBuffers.push_back({ Visibility, FrameCounter });
+    }
+
+    Visibility = CreateBuffer(sizeof(uint32_t) * Capacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0);
+    VisibilityCapacity = Capacity;
+    VisibilityGeneration++;
+    bVisibilityPendingInit = true;
+}
+
+void FVulkanGpuCulling::WriteVisibilityDescriptor(FFrameResources& Frame)
+{
+    VkDescriptorBufferInfo BufferInfo{ Visibility.Buffer, 0, VK_WHOLE_SIZE };
+
+    VkWriteDescriptorSet Write{};
+    Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+    Write.dstSet = Frame.DescriptorSet;
+    Write.dstBinding = BINDING_VISIBILITY;
+    Write.descriptorCount = 1;
+    Write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    Write.pBufferInfo = &BufferInfo;
+    vkUpdateDescriptorSets(LogicalDevice, 1, &Write, 0, nullptr);
+
+    Frame.VisibilityGeneration = VisibilityGeneration;
+}
+
+void FVulkanGpuCulling::CollectRetired()
+{
+    // BeginFrame 在帧槽的 Timeline 等待之后调用：再过 MAX_FRAMES_IN_FLIGHT 帧，退休时飞行中的帧 (含发起拷贝的那一帧) 都已完成
+    std::erase_if(RetiredBuffers, [this](FRetiredBuffer& Retired)
+        {
+            if (FrameCounter < Retired.RetireFrame + MAX_FRAMES_IN_FLIGHT)
+            {
+                return false;
+            }
+            DestroyBuffer(Retired.Buffer);
+            return true;
+        });
+}
+
+void FVulkanGpuCulling::SetDepthSource(VkImageView InDepthView, uint32_t Width, uint32_t Height, uint64_t RetireValue)
+{
+    // 其它帧槽的描述符集可能仍被飞行中的帧使用，不在这里改写
+    HiZ->Resize(InDepthView, Width, Height, RetireValue);
+    HiZGeneration++;
+}
+
+void FVulkanGpuCulling::WriteHiZDescriptor(FFrameResources& Frame)
+{
+    VkDescriptorImageInfo ImageInfo{ VK_NULL_HANDLE, HiZ->GetView(), VK_IMAGE_LAYOUT_GENERAL };
+
+    VkWriteDescriptorSet Write{};
+    Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+    Write.dstSet = Frame.DescriptorSet;
+    Write.dstBinding = BINDING_HIZ;
+    Write.descriptorCount = 1;
+    Write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    Write.pImageInfo = &ImageInfo;
+    vkUpdateDescriptorSets(LogicalDevice, 1, &Write, 0, nullptr);
+
+    Frame.HiZGeneration = HiZGeneration;
+}
+
+FGpuCullingStats FVulkanGpuCulling::BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet)
+{
+    FFrameResources& Frame = Frames[FrameSlot];
+
+    FGpuCullingStats Stats;
+    if (Frame.bSubmitted)
+    {
+        vmaInvalidateAllocation(Allocator, Frame.Counters.Allocation, 0, VK_WHOLE_SIZE);
+        const uint32_t* Values = static_cast<const uint32_t*>(Frame.Counters.Mapped);
+        Stats.FrustumCulled = std::min(Values[COUNTER_FRUSTUM_CULLED], Frame.InstanceCount);
+        Stats.OcclusionCulled = std::min(Values[COUNTER_OCCLUSION_CULLED], Frame.InstanceCount - Stats.FrustumCulled);
+    }
+
+    CollectRetired();
+
+    const uint32_t InstanceCount = static_cast<uint32_t>(Packet.Instances.size());
+    if (InstanceCount > Frame.Capacity)
+    {
+        const uint32_t NewCapacity = RoundUpPowerOfTwo(InstanceCount);
+        CA_LOG_INFO("GpuCulling", "Frame slot {} grows to {} instances.", FrameSlot, NewCapacity);
+        ResizeFrame(Frame, NewCapacity);
+    }
+    if (InstanceCount > VisibilityCapacity)
+    {
+        GrowVisibility(RoundUpPowerOfTwo(InstanceCount));
+    }
+    if (Frame.VisibilityGeneration != VisibilityGeneration)
+    {
+        WriteVisibilityDescriptor(Frame);
+    }
+    if (Frame.HiZGeneration != HiZGeneration)
+    {
+        WriteHiZDescriptor(Frame);
+    }
+
+    std::memcpy(Frame.Instances.Mapped, Packet.Instances.data(), sizeof(FInstanceState) * InstanceCount);
+    vmaFlushAllocation(Allocator, Frame.Instances.Allocation, 0, sizeof(FInstanceState) * InstanceCount);
+    Frame.InstanceCount = InstanceCount;
+    Frame.bSubmitted = true;
+    FrameCounter++;
+
+    return Stats;
+}
+
+void FVulkanGpuCulling::RecordDispatch(VkCommandBuffer InCommandBuffer, const FFrameResources& Frame, EPhase Phase)
+{
+    FCullConstants Constants{};
+    Constants.Phase = static_cast<uint32_t>(Phase);
+    Constants.bOcclusion = bOcclusionCulling ? 1 : 0;
+    Constants.CommandOffset = Phase == EPhase::Late ? Frame.Capacity : 0;
+
+    vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, CullPipeline);
+    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, CullPipelineLayout, 0, 1, &Frame.DescriptorSet, 0, nullptr);
+    vkCmdPushConstants(InCommandBuffer, CullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Constants), &Constants);
+    vkCmdDispatch(InCommandBuffer, (Frame.InstanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+}
+
+void FVulkanGpuCulling::RecordEarlyCulling(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, const FMatrix4& ViewProjection)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+
+    // 0. 本帧剔除参数：帧槽已等待，Host 直接写入
+    const FFrustum Frustum = FFrustum::FromViewProjection(ViewProjection);
+    FCullData* CullData = static_cast<FCullData*>(Frame.CullData.Mapped);
+    CullData->ViewProjection = ViewProjection;
+    for (uint32_t i = 0; i < FFrustum::Count; i++)
+    {
+        CullData->FrustumPlanes[i] = FVector4(Frustum.Planes[i].Normal, Frustum.Planes[i].D);
+    }
+    CullData->InstanceCount = Frame.InstanceCount;
+    CullData->HiZMipCount = HiZ->GetMipCount();
+    CullData->HiZWidth = HiZ->GetWidth();
+    CullData->HiZHeight = HiZ->GetHeight();
+    vmaFlushAllocation(Allocator, Frame.CullData.Allocation, 0, VK_WHOLE_SIZE);
+
+    // 1. 上一帧晚阶段写完可见性之后才能读取或拷贝它
+    VkMemoryBarrier2 VisibilityBarrier{};
+    Utils::ZeroVulkanStruct(VisibilityBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    VisibilityBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    VisibilityBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    VisibilityBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT;
+    VisibilityBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_READ_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &VisibilityBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    // 扩容后的可见性缓冲：保留旧内容，新增部分清零 (视为上一帧不可见，交给晚阶段测试)
+    if (bVisibilityPendingInit)
+    {
+        if (PendingVisibilityBytes > 0)
+        {
+            VkBufferCopy Region{ 0, 0, PendingVisibilityBytes };
+            vkCmdCopyBuffer(InCommandBuffer, PendingVisibilitySource, Visibility.Buffer, 1, &Region);
+        }
+        vkCmdFillBuffer(InCommandBuffer, Visibility.Buffer, PendingVisibilityBytes, VK_WHOLE_SIZE, 0);
+        PendingVisibilitySource = VK_NULL_HANDLE;
+        PendingVisibilityBytes = 0;
+        bVisibilityPendingInit = false;
+    }
+
+    // 2. 清零计数
+    vkCmdFillBuffer(InCommandBuffer, Frame.Counters.Buffer, 0, VK_WHOLE_SIZE, 0);
+
+    VkMemoryBarrier2 ClearBarrier{};
+    Utils::ZeroVulkanStruct(ClearBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    ClearBarrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT | VK_PIPELINE_STAGE_2_COPY_BIT;
+    ClearBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    ClearBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ClearBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    DependencyInfo.pMemoryBarriers = &ClearBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    // 3. 早阶段：上一帧可见且在视锥内的实例写入间接参数并原子递增计数
+    if (bOcclusionCulling && Frame.InstanceCount > 0)
+    {
+        RecordDispatch(InCommandBuffer, Frame, EPhase::Early);
+    }
+
+    // 4. 早阶段的间接参数与计数对 DrawIndirect 可见
+    VkMemoryBarrier2 CullBarrier{};
+    Utils::ZeroVulkanStruct(CullBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    CullBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    CullBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    CullBarrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+    CullBarrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+    DependencyInfo.pMemoryBarriers = &CullBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
+
+void FVulkanGpuCulling::RecordLateCulling(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+
+    // 不做遮挡测试时金字塔从不构建，但描述符仍要求它处于 GENERAL
+    if (!bOcclusionCulling)
+    {
+        HiZ->RecordLayoutInit(InCommandBuffer);
+    }
+
+    // 1. 所有实例做视锥 (+ Hi-Z) 测试，更新可见性，新变为可见的写入晚阶段的间接参数
+    if (Frame.InstanceCount > 0)
+    {
+        RecordDispatch(InCommandBuffer, Frame, EPhase::Late);
+    }
+
+    // 2. 间接参数与计数对 DrawIndirect 可见；计数同时供帧槽复用时 Host 回读
+    VkMemoryBarrier2 CullBarrier{};
+    Utils::ZeroVulkanStruct(CullBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    CullBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    CullBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    CullBarrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_HOST_BIT;
+    CullBarrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_HOST_READ_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &CullBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
+
+void FVulkanGpuCulling::RecordDraws(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, VkPipelineLayout InGraphicsLayout, EPhase Phase)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+    if (Frame.InstanceCount == 0)
+    {
+        return;
+    }
+
+    const bool bLate = Phase == EPhase::Late;
+    const VkDeviceSize CommandOffset = bLate ? sizeof(VkDrawIndexedIndirectCommand) * Frame.Capacity : 0;
+    const VkDeviceSize CountOffset = sizeof(uint32_t) * (bLate ? COUNTER_LATE_DRAWS : COUNTER_EARLY_DRAWS);
+
+    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, InGraphicsLayout, 0, 1, &Frame.DescriptorSet, 0, nullptr);
+    vkCmdBindIndexBuffer(InCommandBuffer, IndexBuffer.Buffer, 0, VK_INDEX_TYPE_UINT16);
+    vkCmdDrawIndexedIndirectCount(InCommandBuffer, Frame.IndirectCommands.Buffer, CommandOffset, Frame.Counters.Buffer, CountOffset,
+        Frame.InstanceCount, sizeof(VkDrawIndexedIndirectCommand));
+}
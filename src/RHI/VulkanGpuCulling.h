@@ -0,0 +1,138 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+#include "VulkanHiZBuffer.h"
+
+class FVulkanDevice;
+struct FFramePacket;
+struct FMatrix4;
+
+// 剔除统计 (来自该帧槽上一轮的回读)
+struct FGpuCullingStats
+{
+    uint32_t FrustumCulled = 0;
+    uint32_t OcclusionCulled = 0;
+};
+
+// GPU 驱动渲染：实例数据与绘制记录放在存储缓冲中，计算着色器做视锥剔除并把可见绘制压缩进间接参数缓冲，
+// 图形阶段用 vkCmdDrawIndexedIndirectCount 消费 —— CPU 录制的命令数与场景规模无关
+// - 每个飞行帧一组缓冲与描述符集，实例数超出容量时按 2 的幂扩容 (只在该帧槽的 Timeline 等待之后)
+// - 实例缓冲为 Host 可写的持久映射内存，RHI 阶段直接从帧包拷贝，没有额外的 Staging 拷贝
+// - 计数留在 Host 可读的缓冲中，帧槽复用时回读作为统计 (比当前帧晚 MAX_FRAMES_IN_FLIGHT 帧)
+// 两阶段遮挡剔除 (启用时)：
+// - 早阶段绘制上一帧可见的实例 -> 由深度构建 Hi-Z -> 晚阶段测试所有实例并补画新变为可见的实例
+// - 每实例的可见性缓冲跨帧保留，所有帧槽共用一份 (队列内按提交顺序读写)
+class FVulkanGpuCulling
+{
+public:
+    // 与 GpuCulling.hlsl 中 numthreads 一致
+    static constexpr uint32_t CULL_GROUP_SIZE = 64;
+    static constexpr uint32_t MIN_INSTANCE_CAPACITY = 1024;
+
+    enum class EPhase : uint32_t
+    {
+        Early,  // 上一帧可见的实例
+        Late,   // Hi-Z 测试后新变为可见的实例 (关闭遮挡剔除时为全部可见实例)
+    };
+
+    FVulkanGpuCulling(FVulkanDevice& InDevice, bool bInOcclusionCulling);
+    ~FVulkanGpuCulling();
+
+    FVulkanGpuCulling(const FVulkanGpuCulling&) = delete;
+    FVulkanGpuCulling& operator=(const FVulkanGpuCulling&) = delete;
+
+    // set 0: 实例 / 绘制记录 / 间接参数 / 计数 / 可见性 / Hi-Z / 剔除参数，间接绘制的图形管线布局也使用它
+    VkDescriptorSetLayout GetDescriptorSetLayout() const { return DescriptorSetLayout; }
+    bool IsOcclusionCullingEnabled() const { return bOcclusionCulling; }
+
+    // 深度缓冲 (重新) 创建后调用：旧金字塔退休到 RetireValue 完成，各帧槽的描述符在其 BeginFrame 中改写
+    void SetDepthSource(VkImageView InDepthView, uint32_t Width, uint32_t Height, uint64_t RetireValue);
+    void CollectRetiredHiZ(uint64_t CompletedValue) { HiZ->CollectRetired(CompletedValue); }
+
+    // 帧槽的 Timeline 值已被等待之后调用：回读该槽上一轮的剔除数，上传本帧实例
+    FGpuCullingStats BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet);
+
+    // 渲染 Pass 之外录制：清零计数 -> 早阶段剔除 (启用遮挡剔除时) -> 屏障
+    void RecordEarlyCulling(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, const FMatrix4& ViewProjection);
+    // 深度处于只读布局时录制 (仅遮挡剔除)
+    void RecordHiZBuild(VkCommandBuffer InCommandBuffer) { HiZ->RecordBuild(InCommandBuffer); }
+    // 渲染 Pass 之外录制：晚阶段剔除 -> 屏障；遮挡剔除时要求本帧的 Hi-Z 已构建
+    void RecordLateCulling(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot);
+    // 渲染 Pass 之内录制：间接绘制管线与其 Push Constant 已由调用方设置
+    void RecordDraws(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, VkPipelineLayout InGraphicsLayout, EPhase Phase);
+
+private:
+    struct FBuffer
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VmaAllocation Allocation = VK_NULL_HANDLE;
+        void* Mapped = nullptr;
+    };
+
+    struct FFrameResources
+    {
+        FBuffer Instances;        // FInstanceState[]，Host 每帧写入
+        FBuffer DrawRecords;      // 每个实例一条绘制记录，创建时写入
+        FBuffer IndirectCommands; // VkDrawIndexedIndirectCommand[]，早/晚阶段各占 Capacity 条，计算着色器写入
+        FBuffer Counters;         // 早/晚阶段绘制数与剔除数，计算着色器原子累加，Host 回读
+        FBuffer CullData;         // 本帧剔除参数 (Uniform)
+        VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+        uint32_t Capacity = 0;
+        uint32_t InstanceCount = 0;  // 本轮提交的实例数
+        uint32_t VisibilityGeneration = 0; // 描述符中可见性缓冲的版本
+        uint32_t HiZGeneration = 0;        // 描述符中 Hi-Z 金字塔的版本
+        bool bSubmitted = false;
+    };
+
+    // 扩容后被替换的可见性缓冲：其它帧槽可能仍在使用，延迟到它们都完成后销毁
+    struct FRetiredBuffer
+    {
+        FBuffer Buffer;
+        uint64_t RetireFrame = 0;
+    };
+
+    FBuffer CreateBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, VmaAllocationCreateFlags Flags) const;
+    void DestroyBuffer(FBuffer& InBuffer) const;
+
+    void CreateDescriptors();
+    void CreateCullingPipeline();
+    void CreateIndexBuffer();
+    // 销毁并按新容量重建该帧槽的缓冲，重写描述符
+    void ResizeFrame(FFrameResources& Frame, uint32_t Capacity);
+    void DestroyFrame(FFrameResources& Frame);
+    // 按新容量替换可见性缓冲，旧内容在下一次录制时拷贝过去
+    void GrowVisibility(uint32_t Capacity);
+    void WriteVisibilityDescriptor(FFrameResources& Frame);
+    void WriteHiZDescriptor(FFrameResources& Frame);
+    void CollectRetired();
+    void RecordDispatch(VkCommandBuffer InCommandBuffer, const FFrameResources& Frame, EPhase Phase);
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+    const bool bOcclusionCulling;
+
+    VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout CullPipelineLayout = VK_NULL_HANDLE;
+    VkPipeline CullPipeline = VK_NULL_HANDLE;
+
+    // 演示场景只有一个网格 (Triangle.hlsl 中硬编码的三角形)，索引即 SV_VertexID
+    FBuffer IndexBuffer;
+
+    std::array<FFrameResources, MAX_FRAMES_IN_FLIGHT> Frames;
+
+    // 每实例一个 uint，所有帧槽共用
+    FBuffer Visibility;
+    uint32_t VisibilityCapacity = 0;
+    uint32_t VisibilityGeneration = 0;
+    // 扩容后待拷贝的旧可见性缓冲 (字节数为 0 表示没有)
+    VkBuffer PendingVisibilitySource = VK_NULL_HANDLE;
+    VkDeviceSize PendingVisibilityBytes = 0;
+    bool bVisibilityPendingInit = false;
+    std::vector<FRetiredBuffer> RetiredBuffers;
+    uint64_t FrameCounter = 0;
+
+    // 遮挡剔除关闭时也创建：描述符集始终引用它
+    std::unique_ptr<FVulkanHiZBuffer> HiZ;
+    uint32_t HiZGeneration = 0;
+};
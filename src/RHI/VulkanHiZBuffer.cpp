@@ -0,0 +1,396 @@
+﻿#include "VulkanHiZBuffer.h"
+#include "VulkanDevice.h"
+
+namespace {
+    enum EBinding : uint32_t
+    {
+        BINDING_DEPTH = 0,
+        BINDING_MIPS,
+        BINDING_COUNTER,
+        BINDING_COUNT,
+    };
+
+    // 布局与 HiZBuild.hlsl 中 FReduceConstants 一致
+    struct FReduceConstants
+    {
+        uint32_t DepthWidth;
+        uint32_t DepthHeight;
+        uint32_t HiZWidth;
+        uint32_t HiZHeight;
+        uint32_t MipCount;
+        uint32_t GroupCount;
+    };
+
+    uint32_t RoundDownPowerOfTwo(uint32_t Value)
+    {
+        uint32_t Result = 1;
+        while (Result * 2 <= Value)
+        {
+            Result <<= 1;
+        }
+        return Result;
+    }
+}
+
+FVulkanHiZBuffer::FVulkanHiZBuffer(FVulkanDevice& InDevice)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator())
+{
+    CreateDescriptorSetLayout();
+    CreateReducePipeline();
+    CreateCounterBuffer();
+}
+
+FVulkanHiZBuffer::~FVulkanHiZBuffer()
+{
+    // 调用方已等待设备空闲
+    Retire(0);
+    CollectRetired(UINT64_MAX);
+
+    if (CounterBuffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator, CounterBuffer, CounterAllocation);
+    }
+    if (ReducePipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(LogicalDevice, ReducePipeline, nullptr);
+    }
+    if (ReducePipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, ReducePipelineLayout, nullptr);
+    }
+    if (DescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(LogicalDevice, DescriptorSetLayout, nullptr);
+    }
+}
+
+void FVulkanHiZBuffer::CreateDescriptorSetLayout()
+{
+    VkDescriptorSetLayoutBinding Bindings[BINDING_COUNT]{};
+    Bindings[BINDING_DEPTH].binding = BINDING_DEPTH;
+    Bindings[BINDING_DEPTH].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    Bindings[BINDING_DEPTH].descriptorCount = 1;
+    Bindings[BINDING_DEPTH].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    Bindings[BINDING_MIPS].binding = BINDING_MIPS;
+    Bindings[BINDING_MIPS].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    Bindings[BINDING_MIPS].descriptorCount = MAX_MIP_COUNT;
+    Bindings[BINDING_MIPS].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    Bindings[BINDING_COUNTER].binding = BINDING_COUNTER;
+    Bindings[BINDING_COUNTER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    Bindings[BINDING_COUNTER].descriptorCount = 1;
+    Bindings[BINDING_COUNTER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo LayoutInfo{};
+    Utils::ZeroVulkanStruct(LayoutInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
+    LayoutInfo.bindingCount = BINDING_COUNT;
+    LayoutInfo.pBindings = Bindings;
+    if (vkCreateDescriptorSetLayout(LogicalDevice, &LayoutInfo, nullptr, &DescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z descriptor set layout!");
+    }
+}
+
+void FVulkanHiZBuffer::AllocateDescriptorSet()
+{
+    VkDescriptorPoolSize PoolSizes[BINDING_COUNT]{};
+    PoolSizes[0] = { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1 };
+    PoolSizes[1] = { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_MIP_COUNT };
+    PoolSizes[2] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 };
+
+    VkDescriptorPoolCreateInfo PoolInfo{};
+    Utils::ZeroVulkanStruct(PoolInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO);
+    PoolInfo.maxSets = 1;
+    PoolInfo.poolSizeCount = BINDING_COUNT;
+    PoolInfo.pPoolSizes = PoolSizes;
+    if (vkCreateDescriptorPool(LogicalDevice, &PoolInfo, nullptr, &DescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z descriptor pool!");
+    }
+
+    // 当前这一份金字塔由所有帧共用
+    VkDescriptorSetAllocateInfo AllocInfo{};
+    Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO);
+    AllocInfo.descriptorPool = DescriptorPool;
+    AllocInfo.descriptorSetCount = 1;
+    AllocInfo.pSetLayouts = &DescriptorSetLayout;
+    if (vkAllocateDescriptorSets(LogicalDevice, &AllocInfo, &DescriptorSet) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate Hi-Z descriptor set!");
+    }
+}
+
+void FVulkanHiZBuffer::CreateReducePipeline()
+{
+    VkPushConstantRange PushConstantRange{};
+    PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    PushConstantRange.offset = 0;
+    PushConstantRange.size = sizeof(FReduceConstants);
+
+    VkPipelineLayoutCreateInfo PipelineLayoutInfo{};
+    Utils::ZeroVulkanStruct(PipelineLayoutInfo, VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO);
+    PipelineLayoutInfo.setLayoutCount = 1;
+    PipelineLayoutInfo.pSetLayouts = &DescriptorSetLayout;
+    PipelineLayoutInfo.pushConstantRangeCount = 1;
+    PipelineLayoutInfo.pPushConstantRanges = &PushConstantRange;
+    if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &ReducePipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z pipeline layout!");
+    }
+
+    VkPipelineShaderStageCreateInfo StageInfo{};
+    Utils::ZeroVulkanStruct(StageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
+    StageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    StageInfo.module = DeviceRef.CreateShaderModule(Utils::ReadSPV("HiZBuild.comp.spv"));
+    StageInfo.pName = "CSMain";
+
+    VkComputePipelineCreateInfo PipelineInfo{};
+    Utils::ZeroVulkanStruct(PipelineInfo, VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO);
+    PipelineInfo.stage = StageInfo;
+    PipelineInfo.layout = ReducePipelineLayout;
+    PipelineInfo.basePipelineIndex = -1;
+
+    VkResult Result = vkCreateComputePipelines(LogicalDevice, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &ReducePipeline);
+    vkDestroyShaderModule(LogicalDevice, StageInfo.module, nullptr);
+    if (Result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z pipeline!");
+    }
+}
+
+void FVulkanHiZBuffer::CreateCounterBuffer()
+{
+    VkBufferCreateInfo BufferInfo{};
+    Utils::ZeroVulkanStruct(BufferInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    BufferInfo.size = sizeof(uint32_t);
+    BufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    BufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // 只在创建时由 Host 写入初值 0，之后由着色器自行复位
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    AllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo AllocationInfo{};
+    if (vmaCreateBuffer(Allocator, &BufferInfo, &AllocInfo, &CounterBuffer, &CounterAllocation, &AllocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z counter buffer!");
+    }
+    std::memset(AllocationInfo.pMappedData, 0, sizeof(uint32_t));
+    vmaFlushAllocation(Allocator, CounterAllocation, 0, VK_WHOLE_SIZE);
+}
+
+void FVulkanHiZBuffer::Retire(uint64_t RetireValue)
+{
+    if (Image == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    RetiredImages.push_back({ Image, ImageAllocation, View, MipViews, DescriptorPool, RetireValue });
+    Image = VK_NULL_HANDLE;
+    ImageAllocation = VK_NULL_HANDLE;
+    View = VK_NULL_HANDLE;
+    MipViews.fill(VK_NULL_HANDLE);
+    DescriptorPool = VK_NULL_HANDLE;
+    DescriptorSet = VK_NULL_HANDLE;
+}
+
+void FVulkanHiZBuffer::CollectRetired(uint64_t CompletedValue)
+{
+    std::erase_if(RetiredImages, [&](FRetiredImage& Retired)
+        {
+            if (CompletedValue < Retired.RetireValue)
+            {
+                return false;
+            }
+            DestroyRetired(Retired);
+            return true;
+        });
+}
+
+void FVulkanHiZBuffer::DestroyRetired(FRetiredImage& Retired)
+{
+    for (VkImageView MipView : Retired.MipViews)
+    {
+        if (MipView != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(LogicalDevice, MipView, nullptr);
+        }
+    }
+    if (Retired.View != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(LogicalDevice, Retired.View, nullptr);
+    }
+    if (Retired.DescriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(LogicalDevice, Retired.DescriptorPool, nullptr);
+    }
+    vmaDestroyImage(Allocator, Retired.Image, Retired.ImageAllocation);
+    Retired = FRetiredImage();
+}
+
+void FVulkanHiZBuffer::Resize(VkImageView InDepthView, uint32_t InDepthWidth, uint32_t InDepthHeight, uint64_t RetireValue)
+{
+    Retire(RetireValue);
+
+    DepthWidth = InDepthWidth;
+    DepthHeight = InDepthHeight;
+    Width = std::min(RoundDownPowerOfTwo(DepthWidth), MAX_SIZE);
+    Height = std::min(RoundDownPowerOfTwo(DepthHeight), MAX_SIZE);
+    MipCount = 1;
+    while ((std::max(Width, Height) >> MipCount) > 0)
+    {
+        MipCount++;
+    }
+    bLayoutInitialized = false;
+
+    VkImageCreateInfo ImageInfo{};
+    Utils::ZeroVulkanStruct(ImageInfo, VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO);
+    ImageInfo.imageType = VK_IMAGE_TYPE_2D;
+    ImageInfo.format = VK_FORMAT_R32_SFLOAT;
+    ImageInfo.extent = { Width, Height, 1 };
+    ImageInfo.mipLevels = MipCount;
+    ImageInfo.arrayLayers = 1;
+    ImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    ImageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    ImageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    ImageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    ImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    if (vmaCreateImage(Allocator, &ImageInfo, &AllocInfo, &Image, &ImageAllocation, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z image!");
+    }
+
+    VkImageViewCreateInfo ViewInfo{};
+    Utils::ZeroVulkanStruct(ViewInfo, VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO);
+    ViewInfo.image = Image;
+    ViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    ViewInfo.format = VK_FORMAT_R32_SFLOAT;
+    ViewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, MipCount, 0, 1 };
+    if (vkCreateImageView(LogicalDevice, &ViewInfo, nullptr, &View) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create Hi-Z image view!");
+    }
+
+    for (uint32_t Mip = 0; Mip < MipCount; Mip++)
+    {
+        ViewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, Mip, 1, 0, 1 };
+        if (vkCreateImageView(LogicalDevice, &ViewInfo, nullptr, &MipViews[Mip]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create Hi-Z mip view!");
+        }
+    }
+
+    AllocateDescriptorSet();
+
+    // 描述符数组必须全部有效：超出 MipCount 的槽位指向最后一级 (着色器按 MipCount 跳过它们)
+    VkDescriptorImageInfo DepthInfo{ VK_NULL_HANDLE, InDepthView, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL };
+    std::array<VkDescriptorImageInfo, MAX_MIP_COUNT> MipInfos;
+    for (uint32_t Mip = 0; Mip < MAX_MIP_COUNT; Mip++)
+    {
+        MipInfos[Mip] = { VK_NULL_HANDLE, MipViews[std::min(Mip, MipCount - 1)], VK_IMAGE_LAYOUT_GENERAL };
+    }
+    VkDescriptorBufferInfo CounterInfo{ CounterBuffer, 0, VK_WHOLE_SIZE };
+
+    VkWriteDescriptorSet Writes[BINDING_COUNT];
+    for (uint32_t i = 0; i < BINDING_COUNT; i++)
+    {
+        Utils::ZeroVulkanStruct(Writes[i], VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        Writes[i].dstSet = DescriptorSet;
+        Writes[i].dstBinding = i;
+        Writes[i].descriptorCount = 1;
+    }
+    Writes[BINDING_DEPTH].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    Writes[BINDING_DEPTH].pImageInfo = &DepthInfo;
+    Writes[BINDING_MIPS].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    Writes[BINDING_MIPS].descriptorCount = MAX_MIP_COUNT;
+    Writes[BINDING_MIPS].pImageInfo = MipInfos.data();
+    Writes[BINDING_COUNTER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    Writes[BINDING_COUNTER].pBufferInfo = &CounterInfo;
+    vkUpdateDescriptorSets(LogicalDevice, BINDING_COUNT, Writes, 0, nullptr);
+
+    CA_LOG_INFO("HiZ", "Hi-Z pyramid {}x{} ({} mips) for {}x{} depth.", Width, Height, MipCount, DepthWidth, DepthHeight);
+}
+
+void FVulkanHiZBuffer::RecordLayoutInit(VkCommandBuffer InCommandBuffer)
+{
+    if (bLayoutInitialized)
+    {
+        return;
+    }
+
+    VkImageMemoryBarrier2 Barrier{};
+    Utils::ZeroVulkanStruct(Barrier, VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2);
+    Barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+    Barrier.srcAccessMask = 0;
+    Barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    Barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    Barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    Barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.image = Image;
+    Barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, MipCount, 0, 1 };
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.imageMemoryBarrierCount = 1;
+    DependencyInfo.pImageMemoryBarriers = &Barrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    bLayoutInitialized = true;
+}
+
+void FVulkanHiZBuffer::RecordBuild(VkCommandBuffer InCommandBuffer)
+{
+    RecordLayoutInit(InCommandBuffer);
+
+    // 1. 上一帧的剔除读取 (WAR) 与计数复位 (WAW) 完成后才能改写金字塔
+    VkMemoryBarrier2 CounterBarrier{};
+    Utils::ZeroVulkanStruct(CounterBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    CounterBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    CounterBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    CounterBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    CounterBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &CounterBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    // 2. 单 Pass 归约
+    const uint32_t GroupsX = (Width + REDUCE_TILE_SIZE - 1) / REDUCE_TILE_SIZE;
+    const uint32_t GroupsY = (Height + REDUCE_TILE_SIZE - 1) / REDUCE_TILE_SIZE;
+    FReduceConstants Constants{ DepthWidth, DepthHeight, Width, Height, MipCount, GroupsX * GroupsY };
+
+    vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ReducePipeline);
+    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ReducePipelineLayout, 0, 1, &DescriptorSet, 0, nullptr);
+    vkCmdPushConstants(InCommandBuffer, ReducePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(Constants), &Constants);
+    vkCmdDispatch(InCommandBuffer, GroupsX, GroupsY, 1);
+
+    // 3. 金字塔对剔除着色器的采样读取可见
+    VkImageMemoryBarrier2 ReadBarrier{};
+    Utils::ZeroVulkanStruct(ReadBarrier, VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2);
+    ReadBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ReadBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    ReadBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ReadBarrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+    ReadBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ReadBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    ReadBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    ReadBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    ReadBarrier.image = Image;
+    ReadBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, MipCount, 0, 1 };
+
+    DependencyInfo.memoryBarrierCount = 0;
+    DependencyInfo.pMemoryBarriers = nullptr;
+    DependencyInfo.imageMemoryBarrierCount = 1;
+    DependencyInfo.pImageMemoryBarriers = &ReadBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
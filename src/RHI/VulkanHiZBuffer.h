@@ -0,0 +1,89 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+
+class FVulkanDevice;
+
+// 层级深度 (Hi-Z) 金字塔：遮挡剔除的输入
+// - mip0 为不超过深度缓冲尺寸的 2 的幂 (上限 2048)，每个纹素保守地覆盖它在深度缓冲中的全部足迹
+// - 每个纹素存该区域的最远深度 (深度比较为 LESS、近 0 远 1)：包围体最近深度比它还远即被完全遮挡
+// - 单次 Dispatch 构建：每个线程组在共享内存中归约 32x32 的 mip0 块得到 mip0-5，
+//   最后完成的线程组 (全局原子计数判定) 接着把 mip5 归约为剩余的 mip6-11
+// - 尺寸变化时不等待飞行帧：旧图像与其描述符池带上 Timeline 值退休，由 CollectRetired 回收
+class FVulkanHiZBuffer
+{
+public:
+    // 与 HiZBuild.hlsl 中 numthreads 一致：16x16 线程，每线程 2x2 个 mip0 纹素
+    static constexpr uint32_t REDUCE_GROUP_SIZE = 16;
+    static constexpr uint32_t REDUCE_TILE_SIZE = REDUCE_GROUP_SIZE * 2;
+    static constexpr uint32_t MAX_MIP_COUNT = 12;
+    static constexpr uint32_t MAX_SIZE = 1u << (MAX_MIP_COUNT - 1);
+
+    explicit FVulkanHiZBuffer(FVulkanDevice& InDevice);
+    ~FVulkanHiZBuffer();
+
+    FVulkanHiZBuffer(const FVulkanHiZBuffer&) = delete;
+    FVulkanHiZBuffer& operator=(const FVulkanHiZBuffer&) = delete;
+
+    // 深度缓冲重建后调用；RetireValue 为已提交帧中最后一帧的 Timeline 值，旧金字塔在它完成之前保留
+    void Resize(VkImageView InDepthView, uint32_t DepthWidth, uint32_t DepthHeight, uint64_t RetireValue);
+    void CollectRetired(uint64_t CompletedValue);
+
+    // 深度缓冲处于 DEPTH_STENCIL_READ_ONLY_OPTIMAL 时录制；结束后金字塔对计算着色器可读
+    void RecordBuild(VkCommandBuffer InCommandBuffer);
+    // 不构建金字塔的帧 (关闭遮挡剔除) 也要让描述符引用的图像处于 GENERAL
+    void RecordLayoutInit(VkCommandBuffer InCommandBuffer);
+
+    // 全部 mip 的视图，以 Sampled Image (GENERAL) 供剔除着色器读取
+    VkImageView GetView() const { return View; }
+    uint32_t GetWidth() const { return Width; }
+    uint32_t GetHeight() const { return Height; }
+    uint32_t GetMipCount() const { return MipCount; }
+
+private:
+    // 被替换下来的金字塔：描述符集随所属的池一起销毁
+    struct FRetiredImage
+    {
+        VkImage Image = VK_NULL_HANDLE;
+        VmaAllocation ImageAllocation = VK_NULL_HANDLE;
+        VkImageView View = VK_NULL_HANDLE;
+        std::array<VkImageView, MAX_MIP_COUNT> MipViews{};
+        VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+        uint64_t RetireValue = 0;
+    };
+
+    void CreateDescriptorSetLayout();
+    // 每次 Resize 一个新池与描述符集：飞行中的帧仍绑定着旧的，不能原地改写
+    void AllocateDescriptorSet();
+    void CreateReducePipeline();
+    void CreateCounterBuffer();
+    void Retire(uint64_t RetireValue);
+    void DestroyRetired(FRetiredImage& Retired);
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+
+    VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+    VkPipelineLayout ReducePipelineLayout = VK_NULL_HANDLE;
+    VkPipeline ReducePipeline = VK_NULL_HANDLE;
+
+    // 线程组完成计数，最后一组读到 GroupCount - 1 后把它复位为 0
+    VkBuffer CounterBuffer = VK_NULL_HANDLE;
+    VmaAllocation CounterAllocation = VK_NULL_HANDLE;
+
+    VkImage Image = VK_NULL_HANDLE;
+    VmaAllocation ImageAllocation = VK_NULL_HANDLE;
+    VkImageView View = VK_NULL_HANDLE;
+    std::array<VkImageView, MAX_MIP_COUNT> MipViews{};
+
+    uint32_t DepthWidth = 0;
+    uint32_t DepthHeight = 0;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t MipCount = 0;
+    bool bLayoutInitialized = false;
+
+    std::vector<FRetiredImage> RetiredImages;
+};
@@ -0,0 +1,570 @@
+﻿#include "VulkanMeshletRenderer.h"
+#include "VulkanDevice.h"
+#include "Renderer/FramePacket.h"
+
+namespace {
+    enum EBinding : uint32_t
+    {
+        BINDING_MESHLETS = 0,
+        BINDING_MESHLET_VERTICES,
+        BINDING_MESHLET_TRIANGLES,
+        BINDING_VERTICES,
+        BINDING_INSTANCES,
+        BINDING_VISIBLE_CLUSTERS,
+        BINDING_DRAW_ARGS,
+        BINDING_COUNTERS,
+        BINDING_CULL_DATA,
+        BINDING_LODS,
+        BINDING_INSTANCE_LODS,
+        BINDING_COUNT,
+    };
+
+    // 计数器下标，与 MeshletCommon.hlsli 一致
+    enum ECounter : uint32_t
+    {
+        COUNTER_VISIBLE = 0,
+        COUNTER_FRUSTUM_CULLED,
+        COUNTER_CONE_CULLED,
+        COUNTER_TRIANGLES,
+        COUNTER_OVERFLOW_CLUSTERS,
+        COUNTER_COUNT,
+    };
+
+    // 布局与 MeshletCommon.hlsli 中 FMeshletCullData 一致 (std140)
+    struct FMeshletCullData
+    {
+        FMatrix4 ViewProjection;
+        FVector4 FrustumPlanes[FFrustum::Count];
+        FVector4 CameraPosition;
+        FMeshQuantization Quantization;
+        uint32_t InstanceCount;
+        uint32_t LodCount;
+        uint32_t TextureCount;
+        uint32_t VisibleClusterCapacity;
+    };
+    static_assert(sizeof(FMeshletCullData) == 224, "FMeshletCullData layout must match MeshletCommon.hlsli");
+
+    // 与 MeshletCommon.hlsli 中 FMeshletDrawConstants 一致
+    struct FMeshletDrawConstants
+    {
+        uint32_t bCountStats;
+        uint32_t InstanceOffset;
+    };
+
+    // 回退路径 DrawArgs 的布局：开头是命令数，间接命令从这个偏移开始，与 MeshletCommon.hlsli 中 MESHLET_DRAW_COMMAND_OFFSET 一致
+    constexpr VkDeviceSize DRAW_COMMAND_OFFSET = 16;
+
+    uint32_t RoundUpPowerOfTwo(uint32_t Value)
+    {
+        uint32_t Result = 1;
+        while (Result < Value)
+        {
+            Result <<= 1;
+        }
+        return Result;
+    }
+
+    // 视图矩阵只含旋转与平移 (LookAt)：相机位置 = -R^T * t
+    FVector3 GetCameraPosition(const FMatrix4& View)
+    {
+        const FVector3 T = View.Columns[3].XYZ();
+        return -(View.GetRow(0).XYZ() * T.X + View.GetRow(1).XYZ() * T.Y + View.GetRow(2).XYZ() * T.Z);
+    }
+}
+
+FVulkanMeshletRenderer::FVulkanMeshletRenderer(FVulkanDevice& InDevice, const FMeshletGeometry& InGeometry, bool bInMeshShader,
+    VkDescriptorSetLayout InTextureSetLayout, uint32_t InTextureCount)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator()), bMeshShader(bInMeshShader),
+    ShaderStages(bInMeshShader ? VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT : VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT),
+    MeshletCount(InGeometry.GetMeshletCount()), LodCount(InGeometry.GetLodCount()), TextureCount(InTextureCount), Quantization(InGeometry.Quantization)
+{
+    check(MeshletCount > 0 && InGeometry.Bounds.Radius > 0.0f);
+    check(LodCount > 0 && LodCount <= FMeshLod::MAX_COUNT);
+
+    for (const FMeshLod& Lod : InGeometry.Lods)
+    {
+        DispatchMeshletCount = std::max(DispatchMeshletCount, Lod.MeshletCount);
+        LodErrors.push_back(Lod.Error / InGeometry.Bounds.Radius);
+    }
+
+    // 网格包围球 -> 原点处半径 MESH_INSTANCE_RADIUS 的球
+    const float Scale = MESH_INSTANCE_RADIUS / InGeometry.Bounds.Radius;
+    MeshToInstance = FMatrix4::TranslationRotationZScale(-InGeometry.Bounds.Center * Scale, 0.0f, Scale);
+
+    if (bMeshShader)
+    {
+        pfnDrawMeshTasks = (PFN_vkCmdDrawMeshTasksEXT)vkGetDeviceProcAddr(LogicalDevice, "vkCmdDrawMeshTasksEXT");
+        check(pfnDrawMeshTasks);
+
+        // 任务线程组总数有单独的上限 (保证下限 2^22)，实例多、簇多时一次绘制会超出，按实例区间拆成多次
+        VkPhysicalDeviceMeshShaderPropertiesEXT MeshShaderProperties{};
+        Utils::ZeroVulkanStruct(MeshShaderProperties, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT);
+        VkPhysicalDeviceProperties2 Properties{};
+        Utils::ZeroVulkanStruct(Properties, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2);
+        Properties.pNext = &MeshShaderProperties;
+        vkGetPhysicalDeviceProperties2(DeviceRef.GetPhysicalDevice(), &Properties);
+
+        const uint32_t GroupCountX = (DispatchMeshletCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+        check(GroupCountX <= MeshShaderProperties.maxTaskWorkGroupCount[0] && GroupCountX <= MeshShaderProperties.maxTaskWorkGroupTotalCount);
+        MaxInstancesPerDraw = std::min({ MAX_INSTANCES, MeshShaderProperties.maxTaskWorkGroupCount[1],
+            MeshShaderProperties.maxTaskWorkGroupTotalCount / GroupCountX });
+    }
+
+    Meshlets = CreateStaticBuffer(std::as_bytes(InGeometry.Meshlets));
+    MeshletVertices = CreateStaticBuffer(std::as_bytes(InGeometry.MeshletVertices));
+    MeshletTriangles = CreateStaticBuffer(std::as_bytes(InGeometry.MeshletTriangles));
+    Vertices = CreateStaticBuffer(std::as_bytes(InGeometry.Vertices));
+    Lods = CreateStaticBuffer(std::as_bytes(InGeometry.Lods));
+
+    // 回退路径：打包的三角形展开为簇内局部索引，绘制时由命令的 vertexOffset 选中可见簇
+    std::vector<uint16_t> LocalIndices;
+    if (!bMeshShader)
+    {
+        LocalIndices.reserve(InGeometry.MeshletTriangles.size() * 3);
+        for (const uint32_t Packed : InGeometry.MeshletTriangles)
+        {
+            LocalIndices.push_back(static_cast<uint16_t>(Packed & 0xFF));
+            LocalIndices.push_back(static_cast<uint16_t>((Packed >> 8) & 0xFF));
+            LocalIndices.push_back(static_cast<uint16_t>((Packed >> 16) & 0xFF));
+        }
+        MeshletIndices = CreateStaticBuffer(std::as_bytes(std::span<const uint16_t>(LocalIndices)), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    }
+    DeviceRef.GetStagingUploader().Flush();
+
+    CreateDescriptors();
+    CreatePipelineLayout(InTextureSetLayout);
+    if (!bMeshShader)
+    {
+        CreateCullingPipeline();
+    }
+    WriteStaticDescriptors();
+
+    for (FFrameResources& Frame : Frames)
+    {
+        ResizeFrame(Frame, MIN_INSTANCE_CAPACITY);
+    }
+
+    CA_LOG_INFO("Meshlet", "Meshlet rendering enabled ({}): {} triangles, {} meshlets in {} LODs (coarsest {} triangles).",
+        bMeshShader ? "task/mesh shaders" : "compute cluster culling + vkCmdDrawIndexedIndirectCount", InGeometry.TriangleCount, MeshletCount,
+        LodCount, InGeometry.Lods.back().TriangleCount);
+}
+
+FVulkanMeshletRenderer::~FVulkanMeshletRenderer()
+{
+    for (FFrameResources& Frame : Frames)
+    {
+        DestroyFrame(Frame);
+    }
+    DestroyBuffer(Meshlets);
+    DestroyBuffer(MeshletVertices);
+    DestroyBuffer(MeshletTriangles);
+    DestroyBuffer(Vertices);
+    DestroyBuffer(Lods);
+    DestroyBuffer(MeshletIndices);
+
+    if (CullPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(LogicalDevice, CullPipeline, nullptr);
+    }
+    if (PipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(LogicalDevice, PipelineLayout, nullptr);
+    }
+    if (DescriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(LogicalDevice, DescriptorPool, nullptr);
+    }
+    if (DescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(LogicalDevice, DescriptorSetLayout, nullptr);
+    }
+}
+
+FVulkanMeshletRenderer::FBuffer FVulkanMeshletRenderer::CreateBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, VmaAllocationCreateFlags Flags) const
+{
+    VkBufferCreateInfo BufferInfo{};
+    Utils::ZeroVulkanStruct(BufferInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    BufferInfo.size = Size;
+    BufferInfo.usage = Usage;
+    BufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    AllocInfo.flags = Flags;
+
+    FBuffer Result;
+    VmaAllocationInfo AllocationInfo{};
+    if (vmaCreateBuffer(Allocator, &BufferInfo, &AllocInfo, &Result.Buffer, &Result.Allocation, &AllocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create meshlet buffer!");
+    }
+    Result.Mapped = AllocationInfo.pMappedData;
+    return Result;
+}
+
+FVulkanMeshletRenderer::FBuffer FVulkanMeshletRenderer::CreateStaticBuffer(std::span<const std::byte> Data, VkBufferUsageFlags Usage) const
+{
+    // 资源数据可达 GB 级，不占用有限的 ReBAR 窗口：放进纯显存，由暂存上传器分块拷贝
+    FBuffer Result = CreateBuffer(Data.size(), Usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0);
+    DeviceRef.GetStagingUploader().UploadBuffer(Result.Buffer, 0, Data);
+    return Result;
+}
+
+void FVulkanMeshletRenderer::DestroyBuffer(FBuffer& InBuffer) const
+{
+    if (InBuffer.Buffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator, InBuffer.Buffer, InBuffer.Allocation);
+    }
+    InBuffer = FBuffer();
+}
+
+void FVulkanMeshletRenderer::CreateDescriptors()
+{
+    VkDescriptorSetLayoutBinding Bindings[BINDING_COUNT]{};
+    for (uint32_t i = 0; i < BINDING_COUNT; i++)
+    {
+        Bindings[i].binding = i;
+        Bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        Bindings[i].descriptorCount = 1;
+        Bindings[i].stageFlags = ShaderStages;
+    }
+    Bindings[BINDING_CULL_DATA].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+    VkDescriptorSetLayoutCreateInfo LayoutInfo{};
+    Utils::ZeroVulkanStruct(LayoutInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
+    LayoutInfo.bindingCount = BINDING_COUNT;
+    LayoutInfo.pBindings = Bindings;
+    if (vkCreateDescriptorSetLayout(LogicalDevice, &LayoutInfo, nullptr, &DescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create meshlet descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize PoolSizes[2]{};
+    PoolSizes[0] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (BINDING_COUNT - 1) * MAX_FRAMES_IN_FLIGHT };
+    PoolSizes[1] = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT };
+
+    VkDescriptorPoolCreateInfo PoolInfo{};
+    Utils::ZeroVulkanStruct(PoolInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO);
+    PoolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    PoolInfo.poolSizeCount = static_cast<uint32_t>(std::size(PoolSizes));
+    PoolInfo.pPoolSizes = PoolSizes;
+    if (vkCreateDescriptorPool(LogicalDevice, &PoolInfo, nullptr, &DescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create meshlet descriptor pool!");
+    }
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> Layouts;
+    Layouts.fill(DescriptorSetLayout);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> Sets;
+
+    VkDescriptorSetAllocateInfo AllocInfo{};
+    Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO);
+    AllocInfo.descriptorPool = DescriptorPool;
+    AllocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    AllocInfo.pSetLayouts = Layouts.data();
+    if (vkAllocateDescriptorSets(LogicalDevice, &AllocInfo, Sets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate meshlet descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        Frames[i].DescriptorSet = Sets[i];
+    }
+}
+
+void FVulkanMeshletRenderer::CreatePipelineLayout(VkDescriptorSetLayout TextureSetLayout)
+{
+    VkPushConstantRange PushConstantRange{};
+    PushConstantRange.stageFlags = ShaderStages;
+    PushConstantRange.offset = 0;
+    PushConstantRange.size = sizeof(FMeshletDrawConstants);
+
+    // 纹理集只在片元阶段使用，剔除管线与纯深度管线共用同一布局时不绑定它也合法
+    const VkDescriptorSetLayout SetLayouts[] = { DescriptorSetLayout, TextureSetLayout };
+
+    VkPipelineLayoutCreateInfo PipelineLayoutInfo{};
+    Utils::ZeroVulkanStruct(PipelineLayoutInfo, VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO);
+    PipelineLayoutInfo.setLayoutCount = TextureSetLayout != VK_NULL_HANDLE ? 2 : 1;
+    PipelineLayoutInfo.pSetLayouts = SetLayouts;
+    PipelineLayoutInfo.pushConstantRangeCount = 1;
+    PipelineLayoutInfo.pPushConstantRanges = &PushConstantRange;
+    if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &PipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create meshlet pipeline layout!");
+    }
+}
+
+void FVulkanMeshletRenderer::CreateCullingPipeline()
+{
+    VkPipelineShaderStageCreateInfo StageInfo{};
+    Utils::ZeroVulkanStruct(StageInfo, VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO);
+    StageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    StageInfo.module = DeviceRef.CreateShaderModule(Utils::ReadSPV("MeshletCulling.comp.spv"));
+    StageInfo.pName = "CSMain";
+
+    VkComputePipelineCreateInfo PipelineInfo{};
+    Utils::ZeroVulkanStruct(PipelineInfo, VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO);
+    PipelineInfo.stage = StageInfo;
+    PipelineInfo.layout = PipelineLayout;
+    PipelineInfo.basePipelineIndex = -1;
+
+    VkResult Result = vkCreateComputePipelines(LogicalDevice, VK_NULL_HANDLE, 1, &PipelineInfo, nullptr, &CullPipeline);
+    vkDestroyShaderModule(LogicalDevice, StageInfo.module, nullptr);
+    if (Result != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create meshlet culling pipeline!");
+    }
+}
+
+void FVulkanMeshletRenderer::WriteStaticDescriptors()
+{
+    constexpr uint32_t StaticBindings[] = { BINDING_MESHLETS, BINDING_MESHLET_VERTICES, BINDING_MESHLET_TRIANGLES, BINDING_VERTICES, BINDING_LODS };
+    const FBuffer* Buffers[] = { &Meshlets, &MeshletVertices, &MeshletTriangles, &Vertices, &Lods };
+    constexpr uint32_t BindingCount = static_cast<uint32_t>(std::size(StaticBindings));
+
+    VkDescriptorBufferInfo BufferInfos[BindingCount];
+    std::vector<VkWriteDescriptorSet> Writes;
+    for (uint32_t i = 0; i < BindingCount; i++)
+    {
+        BufferInfos[i] = { Buffers[i]->Buffer, 0, VK_WHOLE_SIZE };
+    }
+    for (const FFrameResources& Frame : Frames)
+    {
+        for (uint32_t i = 0; i < BindingCount; i++)
+        {
+            VkWriteDescriptorSet& Write = Writes.emplace_back();
+            Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+            Write.dstSet = Frame.DescriptorSet;
+            Write.dstBinding = StaticBindings[i];
+            Write.descriptorCount = 1;
+            Write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            Write.pBufferInfo = &BufferInfos[i];
+        }
+    }
+    vkUpdateDescriptorSets(LogicalDevice, static_cast<uint32_t>(Writes.size()), Writes.data(), 0, nullptr);
+}
+
+void FVulkanMeshletRenderer::ResizeFrame(FFrameResources& Frame, uint32_t Capacity)
+{
+    DestroyFrame(Frame);
+
+    constexpr VmaAllocationCreateFlags UploadFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    Frame.Instances = CreateBuffer(sizeof(FInstanceState) * Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, UploadFlags);
+    Frame.InstanceLods = CreateBuffer(sizeof(uint32_t) * Capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, UploadFlags);
+    // 任务着色器路径不需要可见簇列表与间接参数，仍各留一个元素使描述符有效
+    const VkDeviceSize ClusterCapacity = bMeshShader ? 1 : MAX_VISIBLE_CLUSTERS;
+    Frame.VisibleClusters = CreateBuffer(sizeof(uint32_t) * 2 * ClusterCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0);
+    Frame.DrawArgs = CreateBuffer(DRAW_COMMAND_OFFSET + sizeof(VkDrawIndexedIndirectCommand) * ClusterCapacity,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, 0);
+    Frame.Counters = CreateBuffer(sizeof(uint32_t) * COUNTER_COUNT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    Frame.CullData = CreateBuffer(sizeof(FMeshletCullData), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, UploadFlags);
+    Frame.Capacity = Capacity;
+
+    constexpr uint32_t FrameBindings[] = { BINDING_INSTANCES, BINDING_VISIBLE_CLUSTERS, BINDING_DRAW_ARGS, BINDING_COUNTERS, BINDING_CULL_DATA,
+        BINDING_INSTANCE_LODS };
+    const FBuffer* Buffers[] = { &Frame.Instances, &Frame.VisibleClusters, &Frame.DrawArgs, &Frame.Counters, &Frame.CullData,
+        &Frame.InstanceLods };
+    constexpr uint32_t WriteCount = static_cast<uint32_t>(std::size(FrameBindings));
+    VkDescriptorBufferInfo BufferInfos[WriteCount];
+    VkWriteDescriptorSet Writes[WriteCount];
+    for (uint32_t i = 0; i < WriteCount; i++)
+    {
+        BufferInfos[i] = { Buffers[i]->Buffer, 0, VK_WHOLE_SIZE };
+
+        Utils::ZeroVulkanStruct(Writes[i], VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        Writes[i].dstSet = Frame.DescriptorSet;
+        Writes[i].dstBinding = FrameBindings[i];
+        Writes[i].descriptorCount = 1;
+        Writes[i].descriptorType = FrameBindings[i] == BINDING_CULL_DATA ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        Writes[i].pBufferInfo = &BufferInfos[i];
+    }
+    vkUpdateDescriptorSets(LogicalDevice, WriteCount, Writes, 0, nullptr);
+}
+
+void FVulkanMeshletRenderer::DestroyFrame(FFrameResources& Frame)
+{
+    DestroyBuffer(Frame.Instances);
+    DestroyBuffer(Frame.InstanceLods);
+    DestroyBuffer(Frame.VisibleClusters);
+    DestroyBuffer(Frame.DrawArgs);
+    DestroyBuffer(Frame.Counters);
+    DestroyBuffer(Frame.CullData);
+    Frame.Capacity = 0;
+    Frame.InstanceCount = 0;
+    Frame.bSubmitted = false;
+}
+
+FMeshletStats FVulkanMeshletRenderer::BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet)
+{
+    FFrameResources& Frame = Frames[FrameSlot];
+
+    FMeshletStats Stats;
+    if (Frame.bSubmitted)
+    {
+        vmaInvalidateAllocation(Allocator, Frame.Counters.Allocation, 0, VK_WHOLE_SIZE);
+        const uint32_t* Values = static_cast<const uint32_t*>(Frame.Counters.Mapped);
+        Stats.VisibleClusters = Values[COUNTER_VISIBLE];
+        Stats.FrustumCulledClusters = Values[COUNTER_FRUSTUM_CULLED];
+        Stats.ConeCulledClusters = Values[COUNTER_CONE_CULLED];
+        Stats.VisibleTriangles = Values[COUNTER_TRIANGLES];
+        Stats.OverflowClusters = Values[COUNTER_OVERFLOW_CLUSTERS];
+        if (Stats.OverflowClusters > 0 && !bOverflowReported)
+        {
+            CA_LOG_WARN("Meshlet", "Visible cluster list overflow: {} clusters dropped (budget {}).", Stats.OverflowClusters, MAX_VISIBLE_CLUSTERS);
+            bOverflowReported = true;
+        }
+    }
+
+    uint32_t InstanceCount = static_cast<uint32_t>(Packet.bCpuCulled ? Packet.SortKeys.size() : Packet.Instances.size());
+    if (InstanceCount > MAX_INSTANCES)
+    {
+        if (!bTruncationReported)
+        {
+            CA_LOG_WARN("Meshlet", "{} instances exceed the meshlet path limit, drawing the first {}.", InstanceCount, MAX_INSTANCES);
+            bTruncationReported = true;
+        }
+        InstanceCount = MAX_INSTANCES;
+    }
+    if (InstanceCount > Frame.Capacity)
+    {
+        const uint32_t NewCapacity = RoundUpPowerOfTwo(InstanceCount);
+        CA_LOG_INFO("Meshlet", "Frame slot {} grows to {} instances.", FrameSlot, NewCapacity);
+        ResizeFrame(Frame, NewCapacity);
+    }
+
+    // 逐实例拼上网格归一化矩阵：着色器中的簇包围球、法线锥直接按 World 变换
+    // 场景实例序号随 LOD 一起上传，纹理按它选取，与是否经过 CPU 剔除无关
+    FInstanceState* Dst = static_cast<FInstanceState*>(Frame.Instances.Mapped);
+    uint32_t* DstLods = static_cast<uint32_t*>(Frame.InstanceLods.Mapped);
+    const bool bHasLods = !Packet.InstanceLods.empty();
+    for (uint32_t i = 0; i < InstanceCount; i++)
+    {
+        const uint32_t Source = Packet.bCpuCulled ? static_cast<uint32_t>(Packet.SortKeys[i]) : i;
+        Dst[i] = Packet.Instances[Source];
+        Dst[i].World = Packet.Instances[Source].World * MeshToInstance;
+        DstLods[i] = (bHasLods ? std::min<uint32_t>(Packet.InstanceLods[Source], LodCount - 1) : 0) | Source << 8;
+    }
+    vmaFlushAllocation(Allocator, Frame.Instances.Allocation, 0, sizeof(FInstanceState) * InstanceCount);
+    vmaFlushAllocation(Allocator, Frame.InstanceLods.Allocation, 0, sizeof(uint32_t) * InstanceCount);
+    Frame.InstanceCount = InstanceCount;
+    Frame.bSubmitted = true;
+
+    return Stats;
+}
+
+void FVulkanMeshletRenderer::RecordCulling(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, const FFramePacket& Packet)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+
+    // 0. 本帧剔除参数：帧槽已等待，Host 直接写入
+    const FFrustum Frustum = FFrustum::FromViewProjection(Packet.ViewProjection);
+    FMeshletCullData* CullData = static_cast<FMeshletCullData*>(Frame.CullData.Mapped);
+    CullData->ViewProjection = Packet.ViewProjection;
+    for (uint32_t i = 0; i < FFrustum::Count; i++)
+    {
+        CullData->FrustumPlanes[i] = FVector4(Frustum.Planes[i].Normal, Frustum.Planes[i].D);
+    }
+    CullData->CameraPosition = FVector4(GetCameraPosition(Packet.View), 1.0f);
+    CullData->Quantization = Quantization;
+    CullData->InstanceCount = Frame.InstanceCount;
+    CullData->LodCount = LodCount;
+    CullData->TextureCount = TextureCount;
+    CullData->VisibleClusterCapacity = MAX_VISIBLE_CLUSTERS;
+    vmaFlushAllocation(Allocator, Frame.CullData.Allocation, 0, VK_WHOLE_SIZE);
+
+    // 1. 清零计数；回退路径清零命令数 (由剔除累加，命令本身逐条写入)
+    vkCmdFillBuffer(InCommandBuffer, Frame.Counters.Buffer, 0, VK_WHOLE_SIZE, 0);
+    if (!bMeshShader)
+    {
+        vkCmdFillBuffer(InCommandBuffer, Frame.DrawArgs.Buffer, 0, sizeof(uint32_t), 0);
+    }
+
+    VkMemoryBarrier2 ClearBarrier{};
+    Utils::ZeroVulkanStruct(ClearBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    ClearBarrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    ClearBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    ClearBarrier.dstStageMask = bMeshShader ? VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    ClearBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &ClearBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    if (bMeshShader)
+    {
+        return; // 剔除在任务着色器中随绘制进行
+    }
+
+    // 2. 逐 (实例, 簇) 剔除，可见簇压缩写入列表
+    if (Frame.InstanceCount > 0)
+    {
+        const FMeshletDrawConstants Constants{ 1, 0 };
+        vkCmdBindPipeline(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, CullPipeline);
+        vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, PipelineLayout, 0, 1, &Frame.DescriptorSet, 0, nullptr);
+        vkCmdPushConstants(InCommandBuffer, PipelineLayout, ShaderStages, 0, sizeof(Constants), &Constants);
+        vkCmdDispatch(InCommandBuffer, (DispatchMeshletCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, Frame.InstanceCount, 1);
+    }
+
+    // 3. 间接命令与可见簇对绘制可见；计数同时供帧槽复用时 Host 回读
+    VkMemoryBarrier2 CullBarrier{};
+    Utils::ZeroVulkanStruct(CullBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    CullBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    CullBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    CullBarrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_HOST_BIT;
+    CullBarrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_HOST_READ_BIT;
+    DependencyInfo.pMemoryBarriers = &CullBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
+
+void FVulkanMeshletRenderer::RecordDraws(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, bool bCountStats)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+    if (Frame.InstanceCount == 0)
+    {
+        return;
+    }
+
+    vkCmdBindDescriptorSets(InCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayout, 0, 1, &Frame.DescriptorSet, 0, nullptr);
+    if (bMeshShader)
+    {
+        const uint32_t GroupCountX = (DispatchMeshletCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+        for (uint32_t InstanceOffset = 0; InstanceOffset < Frame.InstanceCount; InstanceOffset += MaxInstancesPerDraw)
+        {
+            const FMeshletDrawConstants Constants{ bCountStats ? 1u : 0u, InstanceOffset };
+            vkCmdPushConstants(InCommandBuffer, PipelineLayout, ShaderStages, 0, sizeof(Constants), &Constants);
+            pfnDrawMeshTasks(InCommandBuffer, GroupCountX, std::min(MaxInstancesPerDraw, Frame.InstanceCount - InstanceOffset), 1);
+        }
+    }
+    else
+    {
+        vkCmdBindIndexBuffer(InCommandBuffer, MeshletIndices.Buffer, 0, VK_INDEX_TYPE_UINT16);
+        vkCmdDrawIndexedIndirectCount(InCommandBuffer, Frame.DrawArgs.Buffer, DRAW_COMMAND_OFFSET, Frame.DrawArgs.Buffer, 0,
+            MAX_VISIBLE_CLUSTERS, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+void FVulkanMeshletRenderer::RecordStatsBarrier(VkCommandBuffer InCommandBuffer)
+{
+    if (!bMeshShader)
+    {
+        return;
+    }
+
+    VkMemoryBarrier2 StatsBarrier{};
+    Utils::ZeroVulkanStruct(StatsBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    StatsBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT;
+    StatsBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    StatsBarrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+    StatsBarrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &StatsBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
@@ -0,0 +1,129 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+#include "Renderer/Meshlet.h"
+
+class FVulkanDevice;
+struct FFramePacket;
+
+// 簇剔除统计 (来自该帧槽上一轮的回读)
+struct FMeshletStats
+{
+    uint32_t VisibleClusters = 0;
+    uint32_t FrustumCulledClusters = 0;
+    uint32_t ConeCulledClusters = 0;
+    uint32_t VisibleTriangles = 0;
+    uint32_t OverflowClusters = 0; // 回退路径：可见簇列表写满后被丢弃的簇
+};
+
+// 网格簇渲染：场景中每个实例都画同一个簇化网格，剔除粒度从实例细化到簇 (视锥 + 法线锥背面剔除)
+// - 支持 VK_EXT_mesh_shader 时：任务着色器逐簇剔除，网格着色器直接输出可见簇，一条 vkCmdDrawMeshTasksEXT
+// - 否则回退：计算着色器逐簇剔除，可见簇压缩进列表并各写一条按实际三角形数取簇内索引的间接命令，一条 vkCmdDrawIndexedIndirectCount 画出
+// 网格与簇数据只读、所有帧共用；实例、可见簇列表、计数与剔除参数每个飞行帧一份
+// 网格按包围球归一化到实例包围球之内，任意尺度的资源都不破坏场景的实例级剔除
+// 离散 LOD：各级的簇连续存放，每个实例只处理 RenderPrep 为它选中那一级的簇 (Dispatch 宽度按最多簇的一级)
+// CPU 剔除时只上传可见实例 (按 RenderPrep 排好的由近到远顺序)，否则上传全部实例由 GPU 逐簇剔除
+class FVulkanMeshletRenderer
+{
+public:
+    // 与 MeshletCommon.hlsli 中 MESHLET_CULL_GROUP_SIZE 一致
+    static constexpr uint32_t CULL_GROUP_SIZE = 32;
+    static constexpr uint32_t MIN_INSTANCE_CAPACITY = 1024;
+    // 实例序号放在 Dispatch 的 Y 维，受 maxComputeWorkGroupCount[1] / maxTaskWorkGroupCount[1] 的保证下限约束
+    static constexpr uint32_t MAX_INSTANCES = 65535;
+    // 回退路径每帧可见簇列表与间接命令的固定预算 (约 7 MB / 帧槽)，超出的簇丢弃并计数
+    static constexpr uint32_t MAX_VISIBLE_CLUSTERS = 1u << 18;
+    // 归一化后的网格包围球半径，小于 FScene::INSTANCE_BOUNDING_RADIUS
+    static constexpr float MESH_INSTANCE_RADIUS = 0.65f;
+
+    // 几何数据经暂存上传器拷进显存，构造返回后 InGeometry 引用的内存 (可以是映射的资源文件) 即可释放
+    // InTextureSetLayout 非空时管线布局带上纹理集 (set 1)，场景实例 i 采样纹理 i % InTextureCount
+    FVulkanMeshletRenderer(FVulkanDevice& InDevice, const FMeshletGeometry& InGeometry, bool bInMeshShader,
+        VkDescriptorSetLayout InTextureSetLayout = VK_NULL_HANDLE, uint32_t InTextureCount = 0);
+    ~FVulkanMeshletRenderer();
+
+    FVulkanMeshletRenderer(const FVulkanMeshletRenderer&) = delete;
+    FVulkanMeshletRenderer& operator=(const FVulkanMeshletRenderer&) = delete;
+
+    bool IsMeshShaderEnabled() const { return bMeshShader; }
+    uint32_t GetMeshletCount() const { return MeshletCount; }
+    // 各级 LOD 的几何误差除以网格包围球半径 (即相对实例包围球的误差，偏保守)，交给 FLodSelector
+    std::span<const float> GetLodErrors() const { return LodErrors; }
+    // 图形管线与剔除管线共用：set 0 + 片元之前各阶段可见的 FMeshletDrawConstants (+ 纹理集 set 1)
+    VkPipelineLayout GetPipelineLayout() const { return PipelineLayout; }
+
+    // 帧槽的 Timeline 值已被等待之后调用：回读该槽上一轮的统计，上传本帧实例
+    FMeshletStats BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet);
+    // 渲染 Pass 之外录制：写剔除参数、清零计数；回退路径在这里完成剔除
+    void RecordCulling(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, const FFramePacket& Packet);
+    // 渲染 Pass 之内录制：图形管线已由调用方绑定；bCountStats 为 false 的一次不计入统计
+    void RecordDraws(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, bool bCountStats);
+    // 渲染 Pass 之后录制：任务着色器写入的计数对 Host 可见 (回退路径已在 RecordCulling 中处理)
+    void RecordStatsBarrier(VkCommandBuffer InCommandBuffer);
+
+private:
+    struct FBuffer
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VmaAllocation Allocation = VK_NULL_HANDLE;
+        void* Mapped = nullptr;
+    };
+
+    struct FFrameResources
+    {
+        FBuffer Instances;       // FInstanceState[]，Host 每帧写入
+        FBuffer InstanceLods;    // uint32_t[]：LOD 级别 | 场景实例序号 << 8，与 Instances 一一对应
+        FBuffer VisibleClusters; // 回退路径：(实例, 簇) 对，MAX_VISIBLE_CLUSTERS 个
+        FBuffer DrawArgs;        // 回退路径：命令数 + 每个可见簇一条 VkDrawIndexedIndirectCommand
+        FBuffer Counters;        // 可见 / 视锥剔除 / 背面剔除的簇数，Host 回读
+        FBuffer CullData;        // 本帧剔除参数 (Uniform)
+        VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+        uint32_t Capacity = 0;
+        uint32_t InstanceCount = 0;
+        bool bSubmitted = false;
+    };
+
+    FBuffer CreateBuffer(VkDeviceSize Size, VkBufferUsageFlags Usage, VmaAllocationCreateFlags Flags) const;
+    FBuffer CreateStaticBuffer(std::span<const std::byte> Data, VkBufferUsageFlags Usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) const;
+    void DestroyBuffer(FBuffer& InBuffer) const;
+
+    void CreateDescriptors();
+    void CreatePipelineLayout(VkDescriptorSetLayout TextureSetLayout);
+    void CreateCullingPipeline();
+    void WriteStaticDescriptors();
+    void ResizeFrame(FFrameResources& Frame, uint32_t Capacity);
+    void DestroyFrame(FFrameResources& Frame);
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+    const bool bMeshShader;
+    const VkShaderStageFlags ShaderStages;
+    PFN_vkCmdDrawMeshTasksEXT pfnDrawMeshTasks = nullptr;
+    // 任务着色器路径单次 vkCmdDrawMeshTasksEXT 最多覆盖的实例数 (maxTaskWorkGroupCount[1] / maxTaskWorkGroupTotalCount)
+    uint32_t MaxInstancesPerDraw = MAX_INSTANCES;
+
+    VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
+    VkPipeline CullPipeline = VK_NULL_HANDLE; // 仅回退路径
+
+    // 只读的网格与簇数据，创建时一次上传到显存
+    FBuffer Meshlets;
+    FBuffer MeshletVertices;
+    FBuffer MeshletTriangles;
+    FBuffer Vertices;
+    FBuffer Lods;
+    FBuffer MeshletIndices; // 回退路径：簇内局部顶点序号 (16 位)，与 MeshletTriangles 逐三角形对应
+    uint32_t MeshletCount = 0;
+    uint32_t LodCount = 0;
+    uint32_t DispatchMeshletCount = 0; // 簇最多的一级 (第 0 级) 的簇数
+    std::vector<float> LodErrors;
+    uint32_t TextureCount = 0;
+    FMeshQuantization Quantization;
+    FMatrix4 MeshToInstance = FMatrix4::Identity();
+
+    std::array<FFrameResources, MAX_FRAMES_IN_FLIGHT> Frames;
+    // 超出 MAX_INSTANCES 时每帧都会截断，只在第一次报告
+    bool bTruncationReported = false;
+    bool bOverflowReported = false;
+};
@@ -0,0 +1,358 @@
+﻿#include "VulkanProfiler.h"
+#include "VulkanDevice.h"
+#include <fstream>
+#include <iomanip>
+
+namespace {
+#if defined(_WIN32)
+    // steady_clock 在 MSVC 上基于 QueryPerformanceCounter
+    constexpr VkTimeDomainEXT HOST_TIME_DOMAIN = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+    // libstdc++ / libc++ 的 steady_clock 基于 CLOCK_MONOTONIC
+    constexpr VkTimeDomainEXT HOST_TIME_DOMAIN = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+
+    constexpr uint32_t QUERIES_PER_SLOT = FVulkanProfiler::MAX_GPU_SCOPES_PER_FRAME * 2;
+
+    uint32_t GetGraphicsTimestampValidBits(FVulkanDevice& InDevice)
+    {
+        uint32_t QueueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(InDevice.GetPhysicalDevice(), &QueueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(InDevice.GetPhysicalDevice(), &QueueFamilyCount, QueueFamilies.data());
+        return QueueFamilies[InDevice.GetQueueFamilyIndices().GraphicsFamily.value()].timestampValidBits;
+    }
+}
+
+bool FVulkanProfiler::IsSupported(FVulkanDevice& InDevice)
+{
+    return GetGraphicsTimestampValidBits(InDevice) > 0;
+}
+
+FVulkanProfiler::FVulkanProfiler(FVulkanDevice& InDevice)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice())
+{
+    VkPhysicalDeviceProperties Props;
+    vkGetPhysicalDeviceProperties(DeviceRef.GetPhysicalDevice(), &Props);
+    TimestampPeriod = Props.limits.timestampPeriod;
+
+    uint32_t ValidBits = GetGraphicsTimestampValidBits(DeviceRef);
+    check(ValidBits > 0);
+    TimestampMask = ValidBits >= 64 ? ~0ull : ((1ull << ValidBits) - 1);
+
+    VkQueryPoolCreateInfo QueryPoolInfo{};
+    Utils::ZeroVulkanStruct(QueryPoolInfo, VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO);
+    QueryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    QueryPoolInfo.queryCount = QUERIES_PER_SLOT * MAX_FRAMES_IN_FLIGHT;
+
+    if (vkCreateQueryPool(LogicalDevice, &QueryPoolInfo, nullptr, &QueryPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create timestamp query pool!");
+    }
+
+    // 校准扩展：需要 Device 与 Host 两个时间域同时可校准
+    if (DeviceRef.IsDeviceExtensionEnabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+    {
+        auto pfnGetTimeDomains = (PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT)
+            vkGetInstanceProcAddr(DeviceRef.GetInstance(), "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT");
+        pfnGetCalibratedTimestamps = (PFN_vkGetCalibratedTimestampsEXT)
+            vkGetDeviceProcAddr(LogicalDevice, "vkGetCalibratedTimestampsEXT");
+
+        if (pfnGetTimeDomains && pfnGetCalibratedTimestamps)
+        {
+            uint32_t DomainCount = 0;
+            pfnGetTimeDomains(DeviceRef.GetPhysicalDevice(), &DomainCount, nullptr);
+            std::vector<VkTimeDomainEXT> Domains(DomainCount);
+            pfnGetTimeDomains(DeviceRef.GetPhysicalDevice(), &DomainCount, Domains.data());
+
+            bool bHasDevice = std::find(Domains.begin(), Domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) != Domains.end();
+            bool bHasHost = std::find(Domains.begin(), Domains.end(), HOST_TIME_DOMAIN) != Domains.end();
+            bCalibrationSupported = bHasDevice && bHasHost;
+            HostTimeDomain = HOST_TIME_DOMAIN;
+        }
+    }
+
+    if (bCalibrationSupported)
+    {
+        Calibrate();
+        CA_LOG_INFO("Profiler", "Calibrated timestamps enabled (max deviation {} ns).", CalibMaxDeviationNs);
+    }
+    else
+    {
+        CA_LOG_WARN("Profiler", "Calibrated timestamps unavailable, GPU events anchored to submit time.");
+    }
+
+    Events.reserve(MAX_TIMELINE_EVENTS);
+}
+
+FVulkanProfiler::~FVulkanProfiler()
+{
+    if (QueryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(LogicalDevice, QueryPool, nullptr);
+    }
+}
+
+void FVulkanProfiler::Calibrate()
+{
+    VkCalibratedTimestampInfoEXT TimestampInfos[2];
+    Utils::ZeroVulkanStruct(TimestampInfos[0], VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT);
+    TimestampInfos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    Utils::ZeroVulkanStruct(TimestampInfos[1], VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT);
+    TimestampInfos[1].timeDomain = HostTimeDomain;
+
+    uint64_t Timestamps[2] = {};
+    uint64_t MaxDeviation = 0;
+    if (pfnGetCalibratedTimestamps(LogicalDevice, 2, TimestampInfos, Timestamps, &MaxDeviation) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    CalibGpuTicks = Timestamps[0] & TimestampMask;
+    CalibHostNs = HostDomainTicksToNs(Timestamps[1]);
+    CalibMaxDeviationNs = MaxDeviation;
+    LastCalibrationNs = NowNs();
+}
+
+uint64_t FVulkanProfiler::HostDomainTicksToNs(uint64_t Ticks)
+{
+#if defined(_WIN32)
+    // 与 MSVC steady_clock 相同的换算方式，避免大数乘法溢出
+    static const uint64_t Frequency = []()
+        {
+            LARGE_INTEGER Freq;
+            QueryPerformanceFrequency(&Freq);
+            return static_cast<uint64_t>(Freq.QuadPart);
+        }();
+    return (Ticks / Frequency) * 1'000'000'000ull + (Ticks % Frequency) * 1'000'000'000ull / Frequency;
+#else
+    return Ticks;
+#endif
+}
+
+uint64_t FVulkanProfiler::GpuTicksToHostNs(uint64_t GpuTicks) const
+{
+    // 计数器只有 timestampValidBits 位有效，按该位宽做带符号差值
+    uint64_t Delta = (GpuTicks - CalibGpuTicks) & TimestampMask;
+    int64_t SignedDelta = static_cast<int64_t>(Delta);
+    if (TimestampMask != ~0ull && Delta > (TimestampMask >> 1))
+    {
+        SignedDelta -= static_cast<int64_t>(TimestampMask) + 1;
+    }
+    return CalibHostNs + static_cast<int64_t>(static_cast<double>(SignedDelta) * TimestampPeriod);
+}
+
+void FVulkanProfiler::ResolveFrameSlot(uint32_t FrameSlot)
+{
+    FFrameSlot& Slot = Slots[FrameSlot];
+    if (!Slot.bPending)
+    {
+        return;
+    }
+    Slot.bPending = false;
+
+    if (Slot.ScopeCount == 0)
+    {
+        return;
+    }
+
+    std::array<uint64_t, QUERIES_PER_SLOT> Results{};
+    VkResult Result = vkGetQueryPoolResults(LogicalDevice, QueryPool, FrameSlot * QUERIES_PER_SLOT, Slot.ScopeCount * 2,
+        sizeof(uint64_t) * Slot.ScopeCount * 2, Results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+    if (Result != VK_SUCCESS)
+    {
+        return;
+    }
+
+    // 未校准时，把本帧第一个时间戳对齐到提交时刻 (只能保证相对顺序)
+    uint64_t AnchorTicks = Results[0] & TimestampMask;
+
+    for (uint32_t i = 0; i < Slot.ScopeCount; i++)
+    {
+        uint64_t BeginTicks = Results[i * 2] & TimestampMask;
+        uint64_t EndTicks = Results[i * 2 + 1] & TimestampMask;
+
+        FTimelineEvent Event;
+        Event.Name = Slot.Scopes[i].Name;
+        Event.Track = ETimelineTrack::Gpu;
+        Event.FrameNumber = Slot.FrameNumber;
+
+        if (bCalibrationSupported)
+        {
+            Event.BeginNs = GpuTicksToHostNs(BeginTicks);
+            Event.EndNs = GpuTicksToHostNs(EndTicks);
+        }
+        else
+        {
+            Event.BeginNs = Slot.SubmitNs + static_cast<uint64_t>(((BeginTicks - AnchorTicks) & TimestampMask) * TimestampPeriod);
+            Event.EndNs = Slot.SubmitNs + static_cast<uint64_t>(((EndTicks - AnchorTicks) & TimestampMask) * TimestampPeriod);
+        }
+
+        PushEvent(Event);
+    }
+}
+
+void FVulkanProfiler::ResolveAll()
+{
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        ResolveFrameSlot(i);
+    }
+}
+
+void FVulkanProfiler::BeginFrame(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, uint64_t FrameNumber)
+{
+    // 调用前该槽的 Timeline 值已被等待，上一轮的结果可以无阻塞回读
+    ResolveFrameSlot(FrameSlot);
+
+    if (bCalibrationSupported && NowNs() - LastCalibrationNs >= CALIBRATION_INTERVAL_NS)
+    {
+        Calibrate();
+    }
+
+    vkCmdResetQueryPool(InCommandBuffer, QueryPool, FrameSlot * QUERIES_PER_SLOT, QUERIES_PER_SLOT);
+
+    FFrameSlot& Slot = Slots[FrameSlot];
+    Slot.FrameNumber = FrameNumber;
+    Slot.SubmitNs = 0;
+    Slot.ScopeCount = 0;
+    Slot.bPending = true;
+    CurrentSlot = FrameSlot;
+}
+
+void FVulkanProfiler::MarkSubmit(uint32_t FrameSlot, uint64_t SubmitNs)
+{
+    Slots[FrameSlot].SubmitNs = SubmitNs;
+}
+
+uint32_t FVulkanProfiler::BeginGpuScope(VkCommandBuffer InCommandBuffer, const char* Name)
+{
+    FFrameSlot& Slot = Slots[CurrentSlot];
+    if (Slot.ScopeCount >= MAX_GPU_SCOPES_PER_FRAME)
+    {
+        return UINT32_MAX;
+    }
+
+    uint32_t ScopeIndex = Slot.ScopeCount++;
+    Slot.Scopes[ScopeIndex].Name = Name;
+    vkCmdWriteTimestamp2(InCommandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, QueryPool,
+        CurrentSlot * QUERIES_PER_SLOT + ScopeIndex * 2);
+    return ScopeIndex;
+}
+
+void FVulkanProfiler::EndGpuScope(VkCommandBuffer InCommandBuffer, uint32_t ScopeIndex)
+{
+    if (ScopeIndex == UINT32_MAX)
+    {
+        return;
+    }
+
+    vkCmdWriteTimestamp2(InCommandBuffer, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, QueryPool,
+        CurrentSlot * QUERIES_PER_SLOT + ScopeIndex * 2 + 1);
+}
+
+void FVulkanProfiler::AddCpuEvent(const char* Name, uint64_t BeginNs, uint64_t EndNs, ETimelineTrack Track, uint64_t FrameNumber)
+{
+    FTimelineEvent Event;
+    Event.Name = Name;
+    Event.Track = Track;
+    Event.FrameNumber = FrameNumber != 0 ? FrameNumber : Slots[CurrentSlot].FrameNumber;
+    Event.BeginNs = BeginNs;
+    Event.EndNs = EndNs;
+    PushEvent(Event);
+}
+
+void FVulkanProfiler::PushEvent(const FTimelineEvent& Event)
+{
+    std::lock_guard<std::mutex> Lock(EventsMutex);
+    if (Events.size() < MAX_TIMELINE_EVENTS)
+    {
+        Events.push_back(Event);
+    }
+    else
+    {
+        Events[EventHead] = Event;
+        EventHead = (EventHead + 1) % MAX_TIMELINE_EVENTS;
+    }
+}
+
+bool FVulkanProfiler::ExportChromeTrace(const std::string& Path) const
+{
+    std::lock_guard<std::mutex> Lock(EventsMutex);
+    if (Events.empty())
+    {
+        return false;
+    }
+
+    std::ofstream File(Path, std::ios::trunc);
+    if (!File.is_open())
+    {
+        CA_LOG_ERROR("Profiler", "Failed to open {}", Path);
+        return false;
+    }
+
+    uint64_t BaseNs = UINT64_MAX;
+    for (const FTimelineEvent& Event : Events)
+    {
+        BaseNs = std::min(BaseNs, Event.BeginNs);
+    }
+
+    // Chrome Trace 使用微秒
+    auto ToUs = [BaseNs](uint64_t Ns) { return static_cast<double>(Ns - BaseNs) / 1000.0; };
+
+    File << std::fixed << std::setprecision(3);
+    File << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    File << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU (RHI)\"}},\n";
+    File << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\""
+         << (bCalibrationSupported ? "GPU (Calibrated)" : "GPU (Submit-Anchored)") << "\"}},\n";
+    File << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"CPU (Update)\"}},\n";
+    File << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":4,\"args\":{\"name\":\"CPU (RenderPrep)\"}}";
+
+    // 环形缓冲按时间顺序从 EventHead 开始
+    std::vector<FTimelineEvent> GpuEvents;
+    for (size_t i = 0; i < Events.size(); i++)
+    {
+        const FTimelineEvent& Event = Events[(EventHead + i) % Events.size()];
+        File << ",\n{\"name\":\"" << Event.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+             << static_cast<uint32_t>(Event.Track) + 1
+             << ",\"ts\":" << ToUs(Event.BeginNs)
+             << ",\"dur\":" << ToUs(Event.EndNs) - ToUs(Event.BeginNs)
+             << ",\"args\":{\"frame\":" << Event.FrameNumber << "}}";
+
+        if (Event.Track == ETimelineTrack::Gpu)
+        {
+            GpuEvents.push_back(Event);
+        }
+    }
+    File << "\n]}\n";
+
+    // 合并 GPU 区间，统计空闲气泡
+    if (!GpuEvents.empty())
+    {
+        std::sort(GpuEvents.begin(), GpuEvents.end(),
+            [](const FTimelineEvent& A, const FTimelineEvent& B) { return A.BeginNs < B.BeginNs; });
+
+        uint64_t BusyNs = 0;
+        uint64_t IdleNs = 0;
+        uint64_t SpanBegin = GpuEvents[0].BeginNs;
+        uint64_t SpanEnd = GpuEvents[0].EndNs;
+        for (const FTimelineEvent& Event : GpuEvents)
+        {
+            if (Event.BeginNs > SpanEnd)
+            {
+                BusyNs += SpanEnd - SpanBegin;
+                IdleNs += Event.BeginNs - SpanEnd;
+                SpanBegin = Event.BeginNs;
+            }
+            SpanEnd = std::max(SpanEnd, Event.EndNs);
+        }
+        BusyNs += SpanEnd - SpanBegin;
+
+        CA_LOG_INFO("Profiler", "GPU busy {} ms, idle {} ms ({}% bubbles)", BusyNs / 1000000.0, IdleNs / 1000000.0,
+            100.0 * IdleNs / std::max<uint64_t>(BusyNs + IdleNs, 1));
+    }
+
+    CA_LOG_INFO("Profiler", "Timeline exported to {}", Path);
+    return true;
+}
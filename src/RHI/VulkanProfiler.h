@@ -0,0 +1,140 @@
+﻿#pragma once
+#include <mutex>
+
+class FVulkanDevice;
+
+// 时间线上的轨道：CPU 侧 API 调用与 GPU Pass 合并在同一份导出中
+// 导出时 tid = 枚举值 + 1
+enum class ETimelineTrack : uint8_t
+{
+    Cpu,         // 渲染线程 (RHI 阶段)
+    Gpu,
+    Update,      // 帧流水线 Update 阶段
+    RenderPrep,  // 帧流水线 RenderPrep 阶段
+};
+
+struct FTimelineEvent
+{
+    const char* Name = nullptr;   // 必须是静态字符串 (字面量)
+    ETimelineTrack Track = ETimelineTrack::Cpu;
+    uint64_t FrameNumber = 0;
+    uint64_t BeginNs = 0;         // Host 单调时钟 (steady_clock) 纳秒
+    uint64_t EndNs = 0;
+};
+
+// CPU/GPU 统一时间线分析器
+// - GPU: 每个 Frame Slot 一段 Timestamp Query，在该槽的 Timeline 值被等待之后回读
+// - 校准: 周期性调用 vkGetCalibratedTimestampsEXT，把 GPU Tick 线性映射到 Host 单调时钟
+// - 导出: Chrome Trace JSON (chrome://tracing / Perfetto 直接打开)
+class FVulkanProfiler
+{
+public:
+    // 单帧最多的 GPU Scope 数量 (每个 Scope 占用 Begin/End 两个 Query)
+    static constexpr uint32_t MAX_GPU_SCOPES_PER_FRAME = 32;
+    // 环形缓冲容量，超出后覆盖最旧的事件
+    static constexpr size_t MAX_TIMELINE_EVENTS = 1 << 16;
+    // 重新校准间隔：GPU 与 CPU 时钟存在漂移，需要周期性修正
+    static constexpr uint64_t CALIBRATION_INTERVAL_NS = 1'000'000'000ull;
+
+    // 调用方先用 IsSupported 检查：图形队列不支持时间戳时不创建 Profiler
+    FVulkanProfiler(FVulkanDevice& InDevice);
+    ~FVulkanProfiler();
+
+    static bool IsSupported(FVulkanDevice& InDevice);
+
+    FVulkanProfiler(const FVulkanProfiler&) = delete;
+    FVulkanProfiler& operator=(const FVulkanProfiler&) = delete;
+
+    static uint64_t NowNs() { return Utils::GetTimeNs(); }
+
+    // 回读 FrameSlot 上一轮的 GPU 时间戳。调用方必须保证该槽已通过 Timeline 等待完成
+    void ResolveFrameSlot(uint32_t FrameSlot);
+    // 设备销毁前回读所有槽 (调用方须已 vkDeviceWaitIdle)
+    void ResolveAll();
+
+    // 在命令缓冲开头调用：重置该槽的 Query 区间，必要时重新校准时钟
+    void BeginFrame(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot, uint64_t FrameNumber);
+    // 提交时刻，用于未校准时的退化对齐
+    void MarkSubmit(uint32_t FrameSlot, uint64_t SubmitNs);
+
+    uint32_t BeginGpuScope(VkCommandBuffer InCommandBuffer, const char* Name);
+    void EndGpuScope(VkCommandBuffer InCommandBuffer, uint32_t ScopeIndex);
+
+    // 可在任意线程调用；FrameNumber 为 0 时取渲染线程当前帧
+    void AddCpuEvent(const char* Name, uint64_t BeginNs, uint64_t EndNs, ETimelineTrack Track = ETimelineTrack::Cpu, uint64_t FrameNumber = 0);
+
+    bool IsCalibrated() const { return bCalibrationSupported; }
+
+    bool ExportChromeTrace(const std::string& Path) const;
+
+    // RAII CPU 标记
+    class FCpuScope
+    {
+    public:
+        FCpuScope(FVulkanProfiler* InProfiler, const char* InName)
+            : Profiler(InProfiler), Name(InName), BeginNs(InProfiler ? NowNs() : 0)
+        {
+        }
+
+        ~FCpuScope()
+        {
+            if (Profiler)
+            {
+                Profiler->AddCpuEvent(Name, BeginNs, NowNs());
+            }
+        }
+
+        FCpuScope(const FCpuScope&) = delete;
+        FCpuScope& operator=(const FCpuScope&) = delete;
+
+    private:
+        FVulkanProfiler* Profiler;
+        const char* Name;
+        uint64_t BeginNs;
+    };
+
+private:
+    struct FGpuScope
+    {
+        const char* Name = nullptr;
+    };
+
+    struct FFrameSlot
+    {
+        uint64_t FrameNumber = 0;
+        uint64_t SubmitNs = 0;
+        uint32_t ScopeCount = 0;
+        bool bPending = false;
+        std::array<FGpuScope, MAX_GPU_SCOPES_PER_FRAME> Scopes;
+    };
+
+    void Calibrate();
+    uint64_t GpuTicksToHostNs(uint64_t GpuTicks) const;
+    static uint64_t HostDomainTicksToNs(uint64_t Ticks);
+    void PushEvent(const FTimelineEvent& Event);
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VkQueryPool QueryPool = VK_NULL_HANDLE;
+
+    float TimestampPeriod = 1.0f;  // 每个 GPU Tick 对应的纳秒数
+    uint64_t TimestampMask = ~0ull;
+
+    bool bCalibrationSupported = false;
+    VkTimeDomainEXT HostTimeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    PFN_vkGetCalibratedTimestampsEXT pfnGetCalibratedTimestamps = nullptr;
+
+    // 最近一次校准点：GpuNs = CalibHostNs + (GpuTicks - CalibGpuTicks) * TimestampPeriod
+    uint64_t CalibGpuTicks = 0;
+    uint64_t CalibHostNs = 0;
+    uint64_t CalibMaxDeviationNs = 0;
+    uint64_t LastCalibrationNs = 0;
+
+    uint32_t CurrentSlot = 0;
+    std::array<FFrameSlot, MAX_FRAMES_IN_FLIGHT> Slots;
+
+    // 帧流水线各阶段线程都会写入
+    mutable std::mutex EventsMutex;
+    std::vector<FTimelineEvent> Events;
+    size_t EventHead = 0;
+};
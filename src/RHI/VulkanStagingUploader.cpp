@@ -0,0 +1,270 @@
+﻿#include "VulkanStagingUploader.h"
+#include "VulkanDevice.h"
+
+FVulkanStagingUploader::FVulkanStagingUploader(FVulkanDevice& InDevice)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator()), Queue(InDevice.GetGraphicsQueue())
+{
+    VkCommandPoolCreateInfo PoolInfo{};
+    Utils::ZeroVulkanStruct(PoolInfo, VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO);
+    PoolInfo.queueFamilyIndex = InDevice.GetQueueFamilyIndices().GraphicsFamily.value();
+    PoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    if (vkCreateCommandPool(LogicalDevice, &PoolInfo, nullptr, &CommandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create staging command pool!");
+    }
+
+    std::array<VkCommandBuffer, BLOCK_COUNT> CommandBuffers;
+    VkCommandBufferAllocateInfo AllocInfo{};
+    Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO);
+    AllocInfo.commandPool = CommandPool;
+    AllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    AllocInfo.commandBufferCount = BLOCK_COUNT;
+    if (vkAllocateCommandBuffers(LogicalDevice, &AllocInfo, CommandBuffers.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate staging command buffers!");
+    }
+
+    VkFenceCreateInfo FenceInfo{};
+    Utils::ZeroVulkanStruct(FenceInfo, VK_STRUCTURE_TYPE_FENCE_CREATE_INFO);
+    for (uint32_t i = 0; i < BLOCK_COUNT; i++)
+    {
+        Blocks[i].CommandBuffer = CommandBuffers[i];
+        if (vkCreateFence(LogicalDevice, &FenceInfo, nullptr, &Blocks[i].Fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create staging fence!");
+        }
+    }
+
+    // 暂存环放在系统内存：CPU 顺序写入，GPU 经 PCIe 读取一次
+    VkBufferCreateInfo BufferInfo{};
+    Utils::ZeroVulkanStruct(BufferInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    BufferInfo.size = BLOCK_SIZE * BLOCK_COUNT;
+    BufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    BufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo AllocCreateInfo{};
+    AllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    AllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo AllocationInfo{};
+    if (vmaCreateBuffer(Allocator, &BufferInfo, &AllocCreateInfo, &StagingBuffer, &StagingAllocation, &AllocationInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create staging buffer!");
+    }
+    StagingMapped = static_cast<std::byte*>(AllocationInfo.pMappedData);
+}
+
+FVulkanStagingUploader::~FVulkanStagingUploader()
+{
+    Flush();
+
+    for (FBlock& Block : Blocks)
+    {
+        if (Block.Fence != VK_NULL_HANDLE)
+        {
+            vkDestroyFence(LogicalDevice, Block.Fence, nullptr);
+        }
+    }
+    if (StagingBuffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(Allocator, StagingBuffer, StagingAllocation);
+    }
+    if (CommandPool != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(LogicalDevice, CommandPool, nullptr);
+    }
+}
+
+FVulkanStagingUploader::FBlock& FVulkanStagingUploader::AcquireBlock()
+{
+    FBlock& Block = Blocks[CurrentBlock];
+    if (Block.bRecording)
+    {
+        return Block;
+    }
+
+    if (Block.bSubmitted)
+    {
+        vkWaitForFences(LogicalDevice, 1, &Block.Fence, VK_TRUE, UINT64_MAX);
+        Block.bSubmitted = false;
+    }
+    vkResetFences(LogicalDevice, 1, &Block.Fence);
+    vkResetCommandBuffer(Block.CommandBuffer, 0);
+
+    VkCommandBufferBeginInfo BeginInfo{};
+    Utils::ZeroVulkanStruct(BeginInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO);
+    BeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(Block.CommandBuffer, &BeginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin staging command buffer!");
+    }
+
+    Block.Used = 0;
+    Block.bRecording = true;
+    return Block;
+}
+
+void FVulkanStagingUploader::SubmitBlock(FBlock& Block)
+{
+    const uint32_t BlockIndex = static_cast<uint32_t>(&Block - Blocks.data());
+    vmaFlushAllocation(Allocator, StagingAllocation, BlockIndex * BLOCK_SIZE, Block.Used);
+
+    // 拷贝结果对之后提交的任何阶段可见 (同一队列上的提交顺序保证执行依赖)
+    VkMemoryBarrier2 Barrier{};
+    Utils::ZeroVulkanStruct(Barrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    Barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    Barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    Barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    Barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &Barrier;
+    vkCmdPipelineBarrier2(Block.CommandBuffer, &DependencyInfo);
+
+    if (vkEndCommandBuffer(Block.CommandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record staging command buffer!");
+    }
+
+    VkCommandBufferSubmitInfo CommandBufferInfo{};
+    Utils::ZeroVulkanStruct(CommandBufferInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO);
+    CommandBufferInfo.commandBuffer = Block.CommandBuffer;
+
+    VkSubmitInfo2 SubmitInfo{};
+    Utils::ZeroVulkanStruct(SubmitInfo, VK_STRUCTURE_TYPE_SUBMIT_INFO_2);
+    SubmitInfo.commandBufferInfoCount = 1;
+    SubmitInfo.pCommandBufferInfos = &CommandBufferInfo;
+    if (vkQueueSubmit2(Queue, 1, &SubmitInfo, Block.Fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit staging copies!");
+    }
+
+    Block.bRecording = false;
+    Block.bSubmitted = true;
+    CurrentBlock = (CurrentBlock + 1) % BLOCK_COUNT;
+}
+
+void FVulkanStagingUploader::UploadBuffer(VkBuffer DstBuffer, VkDeviceSize DstOffset, std::span<const std::byte> Source)
+{
+    while (!Source.empty())
+    {
+        FBlock& Block = AcquireBlock();
+        const uint32_t BlockIndex = static_cast<uint32_t>(&Block - Blocks.data());
+        const VkDeviceSize ChunkSize = std::min<VkDeviceSize>(Source.size(), BLOCK_SIZE - Block.Used);
+        const VkDeviceSize StagingOffset = BlockIndex * BLOCK_SIZE + Block.Used;
+
+        std::memcpy(StagingMapped + StagingOffset, Source.data(), ChunkSize);
+
+        VkBufferCopy Region{};
+        Region.srcOffset = StagingOffset;
+        Region.dstOffset = DstOffset;
+        Region.size = ChunkSize;
+        vkCmdCopyBuffer(Block.CommandBuffer, StagingBuffer, DstBuffer, 1, &Region);
+
+        // 后续块的偏移保持 16 字节对齐，memcpy 与 DMA 都走对齐路径
+        Block.Used = std::min(BLOCK_SIZE, (Block.Used + ChunkSize + 15) & ~VkDeviceSize(15));
+        DstOffset += ChunkSize;
+        Source = Source.subspan(ChunkSize);
+        UploadedBytes += ChunkSize;
+
+        if (Block.Used == BLOCK_SIZE)
+        {
+            SubmitBlock(Block);
+        }
+    }
+}
+
+void FVulkanStagingUploader::RecordImageLayout(VkCommandBuffer InCommandBuffer, VkImage Image, VkImageLayout OldLayout, VkImageLayout NewLayout) const
+{
+    const bool bToTransfer = NewLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+    VkImageMemoryBarrier2 Barrier{};
+    Utils::ZeroVulkanStruct(Barrier, VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2);
+    Barrier.srcStageMask = bToTransfer ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_COPY_BIT;
+    Barrier.srcAccessMask = bToTransfer ? VK_ACCESS_2_NONE : VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    Barrier.dstStageMask = bToTransfer ? VK_PIPELINE_STAGE_2_COPY_BIT : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    Barrier.dstAccessMask = bToTransfer ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_MEMORY_READ_BIT;
+    Barrier.oldLayout = OldLayout;
+    Barrier.newLayout = NewLayout;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.image = Image;
+    Barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.imageMemoryBarrierCount = 1;
+    DependencyInfo.pImageMemoryBarriers = &Barrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
+
+void FVulkanStagingUploader::UploadImageMip(VkImage DstImage, uint32_t Level, uint32_t Width, uint32_t Height, uint32_t BytesPerTexel,
+    std::span<const std::byte> Source, bool bFirstMip, bool bLastMip, VkImageLayout FinalLayout)
+{
+    const VkDeviceSize RowPitch = static_cast<VkDeviceSize>(Width) * BytesPerTexel;
+    check(Source.size() == RowPitch * Height && RowPitch <= BLOCK_SIZE);
+
+    if (bFirstMip)
+    {
+        RecordImageLayout(AcquireBlock().CommandBuffer, DstImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    }
+
+    // 同一队列上的提交按顺序执行，布局转换与各块的拷贝可以落在不同的块中
+    uint32_t Row = 0;
+    while (Row < Height)
+    {
+        FBlock& Block = AcquireBlock();
+        const uint32_t BlockIndex = static_cast<uint32_t>(&Block - Blocks.data());
+        const uint32_t RowCount = static_cast<uint32_t>(std::min<VkDeviceSize>(Height - Row, (BLOCK_SIZE - Block.Used) / RowPitch));
+        if (RowCount == 0)
+        {
+            SubmitBlock(Block);
+            continue;
+        }
+
+        const VkDeviceSize ChunkSize = RowPitch * RowCount;
+        const VkDeviceSize StagingOffset = BlockIndex * BLOCK_SIZE + Block.Used;
+        std::memcpy(StagingMapped + StagingOffset, Source.data() + RowPitch * Row, ChunkSize);
+
+        VkBufferImageCopy Region{};
+        Region.bufferOffset = StagingOffset;
+        Region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Level, 0, 1 };
+        Region.imageOffset = { 0, static_cast<int32_t>(Row), 0 };
+        Region.imageExtent = { Width, RowCount, 1 };
+        vkCmdCopyBufferToImage(Block.CommandBuffer, StagingBuffer, DstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Region);
+
+        Block.Used = std::min(BLOCK_SIZE, (Block.Used + ChunkSize + 15) & ~VkDeviceSize(15));
+        Row += RowCount;
+        UploadedBytes += ChunkSize;
+
+        if (Block.Used == BLOCK_SIZE)
+        {
+            SubmitBlock(Block);
+        }
+    }
+
+    if (bLastMip)
+    {
+        RecordImageLayout(AcquireBlock().CommandBuffer, DstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, FinalLayout);
+    }
+}
+
+void FVulkanStagingUploader::Flush()
+{
+    FBlock& Current = Blocks[CurrentBlock];
+    if (Current.bRecording)
+    {
+        SubmitBlock(Current);
+    }
+
+    for (FBlock& Block : Blocks)
+    {
+        if (Block.bSubmitted)
+        {
+            vkWaitForFences(LogicalDevice, 1, &Block.Fence, VK_TRUE, UINT64_MAX);
+            Block.bSubmitted = false;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+
+class FVulkanDevice;
+
+// 暂存上传器：把 CPU 数据 (通常直接是映射的资源文件) 拷进显存缓冲或图像
+// - 一块 Host 可见的暂存环，分成 BLOCK_COUNT 个块，每块各有命令缓冲与 Fence
+// - 一个块写满即提交，CPU 接着填下一个块：磁盘读取 / memcpy 与 GPU 拷贝相互重叠
+// - 源数据只经过一次 memcpy (映射内存 -> 暂存)，不做中间缓冲与解析
+// 在图形队列上提交，调用方保证此时没有其它线程使用该队列 (Init 期间)
+class FVulkanStagingUploader
+{
+public:
+    static constexpr VkDeviceSize BLOCK_SIZE = 16 * 1024 * 1024;
+    static constexpr uint32_t BLOCK_COUNT = 4;
+
+    explicit FVulkanStagingUploader(FVulkanDevice& InDevice);
+    ~FVulkanStagingUploader();
+
+    FVulkanStagingUploader(const FVulkanStagingUploader&) = delete;
+    FVulkanStagingUploader& operator=(const FVulkanStagingUploader&) = delete;
+
+    // 任意大小的数据自动分块；返回时数据已全部进入暂存环，拷贝可能仍在 GPU 上进行
+    void UploadBuffer(VkBuffer DstBuffer, VkDeviceSize DstOffset, std::span<const std::byte> Source);
+    // 上传图像的一级 mip (行紧密排列)，大于块的 mip 按行分块
+    // bFirstMip: 先把整个图像从 UNDEFINED 转为 TRANSFER_DST；bLastMip: 拷贝后把整个图像转为 FinalLayout
+    // 同一图像的各级 mip 依次调用，布局只在首尾各转换一次
+    void UploadImageMip(VkImage DstImage, uint32_t Level, uint32_t Width, uint32_t Height, uint32_t BytesPerTexel,
+        std::span<const std::byte> Source, bool bFirstMip, bool bLastMip, VkImageLayout FinalLayout);
+    // 提交剩余的拷贝并等待全部完成；之后目标缓冲对所有后续提交可见
+    void Flush();
+
+    uint64_t GetUploadedBytes() const { return UploadedBytes; }
+
+private:
+    struct FBlock
+    {
+        VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+        VkFence Fence = VK_NULL_HANDLE;
+        VkDeviceSize Used = 0;
+        bool bRecording = false;
+        bool bSubmitted = false;
+    };
+
+    // 当前块可写：等待它上一次的拷贝完成后重新开始录制
+    FBlock& AcquireBlock();
+    void SubmitBlock(FBlock& Block);
+    void RecordImageLayout(VkCommandBuffer InCommandBuffer, VkImage Image, VkImageLayout OldLayout, VkImageLayout NewLayout) const;
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+    VkQueue Queue = VK_NULL_HANDLE;
+
+    VkCommandPool CommandPool = VK_NULL_HANDLE;
+    VkBuffer StagingBuffer = VK_NULL_HANDLE;
+    VmaAllocation StagingAllocation = VK_NULL_HANDLE;
+    std::byte* StagingMapped = nullptr;
+
+    std::array<FBlock, BLOCK_COUNT> Blocks;
+    uint32_t CurrentBlock = 0;
+    uint64_t UploadedBytes = 0;
+};
@@ -2,8 +2,19 @@
 #include "VulkanDevice.h"
 #include "Application/Window.h"
 
-FVulkanSwapchain::FVulkanSwapchain(const uint32_t& InWidth, const uint32_t& InHeight, FVulkanDevice& InDevice, FWindow& InWindow): DeviceRef(InDevice), WindowRef(InWindow)
+FVulkanSwapchain::FVulkanSwapchain(const uint32_t& InWidth, const uint32_t& InHeight, FVulkanDevice& InDevice, FWindow& InWindow, const FPresentPolicy& InPolicy)
+    : DeviceRef(InDevice), WindowRef(InWindow), Policy(InPolicy)
 {
+    LogicalDevice = DeviceRef.GetLogicalDevice();
+    PhysicalDevice = DeviceRef.GetPhysicalDevice();
+    Surface = DeviceRef.GetSurface();
+
+    bMaintenance1 = DeviceRef.IsSwapchainMaintenance1Enabled();
+    if (bMaintenance1)
+    {
+        pfnReleaseSwapchainImages = (PFN_vkReleaseSwapchainImagesEXT)vkGetDeviceProcAddr(LogicalDevice, "vkReleaseSwapchainImagesEXT");
+    }
+
     Create(InWidth, InHeight);
 }
 
@@ -34,8 +45,9 @@ bool FVulkanSwapchain::Present(uint32_t ImageIndex, void* InWaitSemaphore)
 void FVulkanSwapchain::Create(const uint32_t& Width, const uint32_t& Height)
 {
     FSwapchainSupportDetails SupportDetails = QuerySwapChainSupport(DeviceRef.GetPhysicalDevice(), DeviceRef.GetSurface());
-    VkSurfaceFormatKHR SurfaceFormat = ChooseSwapSurfaceFormat(SupportDetails.Formats);
-    VkPresentModeKHR PresentMode = ChooseSwapPresentMode(SupportDetails.PresentModes);
+    VkSurfaceFormatKHR SurfaceFormat = ChooseSwapSurfaceFormat(SupportDetails.Formats, Policy);
+    VkPresentModeKHR SelectedPresentMode = ChooseSwapPresentMode(SupportDetails.PresentModes, Policy);
+    SupportedPresentModes = SupportDetails.PresentModes;
     VkExtent2D SwapchainExtent = ChooseSwapExtent(SupportDetails.Capabilities, WindowRef, Width, Height);
 
     uint32_t ImageCount = SupportDetails.Capabilities.minImageCount + 1;
@@ -78,11 +90,22 @@ void FVulkanSwapchain::Create(const uint32_t& Width, const uint32_t& Height)
 
     CreateInfo.preTransform = SupportDetails.Capabilities.currentTransform; // 不做旋转 (移动端可能需要处理)
     CreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR; // 不透明，忽略窗口系统的 Alpha 通道
-    CreateInfo.presentMode = PresentMode;
+    CreateInfo.presentMode = SelectedPresentMode;
     CreateInfo.clipped = VK_TRUE; // 被其他窗口挡住的像素不予计算 (Clip)
 
-    // Resize
-    VkSwapchainKHR OldSwapchain = Swapchain;
+    // maintenance1: 声明所有可免重建切换的呈现模式
+    VkSwapchainPresentModesCreateInfoEXT PresentModesInfo{};
+    Utils::ZeroVulkanStruct(PresentModesInfo, VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_MODES_CREATE_INFO_EXT);
+    CompatiblePresentModes.clear();
+    if (bMaintenance1)
+    {
+        QueryCompatiblePresentModes(SelectedPresentMode, SupportDetails.PresentModes);
+        PresentModesInfo.presentModeCount = static_cast<uint32_t>(CompatiblePresentModes.size());
+        PresentModesInfo.pPresentModes = CompatiblePresentModes.data();
+        CreateInfo.pNext = &PresentModesInfo;
+    }
+
+    // Resize: 旧交换链通过 oldSwapchain 移交，仍在飞行中的帧继续向它 Present
     VkSwapchainKHR NewSwapchain = VK_NULL_HANDLE;
     if (Swapchain != VK_NULL_HANDLE)
     {
@@ -93,23 +116,35 @@ void FVulkanSwapchain::Create(const uint32_t& Width, const uint32_t& Height)
     {
         throw std::runtime_error("failed to create swap chain!");
     }
-    Swapchain = NewSwapchain;
-    if (OldSwapchain != VK_NULL_HANDLE)
+
+    // 旧交换链连同其 ImageView / Present 信号量一起退休，等最后一次 Present 完成后再销毁
+    if (Swapchain != VK_NULL_HANDLE)
     {
-        vkDestroySwapchainKHR(DeviceRef.GetLogicalDevice(), OldSwapchain, nullptr);
+        FRetiredSwapchain Retired;
+        Retired.Swapchain = Swapchain;
+        Retired.ImageViews = std::move(ImageViews);
+        Retired.PresentSemaphores = std::move(PresentSemaphores);
+        Retired.InFlightPresentSyncs = std::move(InFlightPresentSyncs);
+        Retired.LastTimelineValue = LastTimelineValue;
+        Retired.LastPresentId = LastPresentId;
+        RetiredSwapchains.push_back(std::move(Retired));
+
+        ImageViews.clear();
+        PresentSemaphores.clear();
+        InFlightPresentSyncs.clear();
     }
+    Swapchain = NewSwapchain;
     
     ImageFormat = SurfaceFormat.format;
     Extent = SwapchainExtent;
+    PresentMode = SelectedPresentMode;
 
     vkGetSwapchainImagesKHR(DeviceRef.GetLogicalDevice(), Swapchain, &ImageCount, nullptr);
     Images.resize(ImageCount);
     vkGetSwapchainImagesKHR(DeviceRef.GetLogicalDevice(), Swapchain, &ImageCount, Images.data());
 
-    std::cout << "Swapchain created successfully!" << std::endl;
-    std::cout << "  - Format: " << ImageFormat << std::endl;
-    std::cout << "  - Extent: " << Extent.width << "x" << Extent.height << std::endl;
-    std::cout << "  - Image Count: " << Images.size() << std::endl;
+    CA_LOG_INFO("Swapchain", "Swapchain created successfully! Format: {}, Extent: {}x{}, Image Count: {}",
+        ImageFormat, Extent.width, Extent.height, Images.size());
 
     VkImageViewCreateInfo ImageViewCreateInfo{};
     Utils::ZeroVulkanStruct(ImageViewCreateInfo, VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO);
@@ -132,8 +167,6 @@ void FVulkanSwapchain::Create(const uint32_t& Width, const uint32_t& Height)
             vkDestroyImageView(InDevice, InImageView, pAllocator);
         };
 
-    ImageViews.clear();
-
     for (size_t i = 0; i < Images.size(); i++)
     {
         ImageViewCreateInfo.image = Images[i];
@@ -144,11 +177,235 @@ void FVulkanSwapchain::Create(const uint32_t& Width, const uint32_t& Height)
         }
         ImageViews.emplace_back(DeviceRef.GetLogicalDevice(), imageViewHandle, ImageViewDeleter);
     }
+
+    // 逐图像的 Present 信号量随图片数量重建 (maintenance1 下改用 Present Fence 池，不再按图片分配)
+    if (bMaintenance1)
+    {
+        return;
+    }
+
+    VkSemaphoreCreateInfo PresentSemaphoreInfo{};
+    Utils::ZeroVulkanStruct(PresentSemaphoreInfo, VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO);
+
+    PresentSemaphores.resize(Images.size());
+    for (size_t i = 0; i < Images.size(); i++)
+    {
+        if (vkCreateSemaphore(DeviceRef.GetLogicalDevice(), &PresentSemaphoreInfo, nullptr, &PresentSemaphores[i]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create present semaphore!");
+        }
+    }
+}
+
+void FVulkanSwapchain::QueryCompatiblePresentModes(VkPresentModeKHR InPresentMode, std::span<const VkPresentModeKHR> AvailablePresentModes)
+{
+    auto pfnGetSurfaceCapabilities2 = (PFN_vkGetPhysicalDeviceSurfaceCapabilities2KHR)
+        vkGetInstanceProcAddr(DeviceRef.GetInstance(), "vkGetPhysicalDeviceSurfaceCapabilities2KHR");
+
+    CompatiblePresentModes = { InPresentMode };
+    if (!pfnGetSurfaceCapabilities2)
+    {
+        return;
+    }
+
+    VkSurfacePresentModeEXT SurfacePresentMode{};
+    Utils::ZeroVulkanStruct(SurfacePresentMode, VK_STRUCTURE_TYPE_SURFACE_PRESENT_MODE_EXT);
+    SurfacePresentMode.presentMode = InPresentMode;
+
+    VkPhysicalDeviceSurfaceInfo2KHR SurfaceInfo{};
+    Utils::ZeroVulkanStruct(SurfaceInfo, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SURFACE_INFO_2_KHR);
+    SurfaceInfo.surface = Surface;
+    SurfaceInfo.pNext = &SurfacePresentMode;
+
+    std::array<VkPresentModeKHR, 8> Modes{};
+    VkSurfacePresentModeCompatibilityEXT Compatibility{};
+    Utils::ZeroVulkanStruct(Compatibility, VK_STRUCTURE_TYPE_SURFACE_PRESENT_MODE_COMPATIBILITY_EXT);
+    Compatibility.presentModeCount = static_cast<uint32_t>(Modes.size());
+    Compatibility.pPresentModes = Modes.data();
+
+    VkSurfaceCapabilities2KHR Capabilities2{};
+    Utils::ZeroVulkanStruct(Capabilities2, VK_STRUCTURE_TYPE_SURFACE_CAPABILITIES_2_KHR);
+    Capabilities2.pNext = &Compatibility;
+
+    if (pfnGetSurfaceCapabilities2(PhysicalDevice, &SurfaceInfo, &Capabilities2) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < Compatibility.presentModeCount; i++)
+    {
+        VkPresentModeKHR Mode = Modes[i];
+        bool bAvailable = std::find(AvailablePresentModes.begin(), AvailablePresentModes.end(), Mode) != AvailablePresentModes.end();
+        if (Mode != InPresentMode && bAvailable)
+        {
+            CompatiblePresentModes.push_back(Mode);
+        }
+    }
+}
+
+bool FVulkanSwapchain::TrySwitchPresentMode(const FPresentPolicy& InPolicy)
+{
+    if (!bMaintenance1 || InPolicy.bPreferSRGB != Policy.bPreferSRGB)
+    {
+        return false;
+    }
+
+    // 按 Surface 支持的全部模式选择：选中的模式不在兼容集合内时交给调用方重建，而不是退而求其次
+    VkPresentModeKHR DesiredMode = ChooseSwapPresentMode(SupportedPresentModes, InPolicy);
+    if (std::find(CompatiblePresentModes.begin(), CompatiblePresentModes.end(), DesiredMode) == CompatiblePresentModes.end())
+    {
+        return false;
+    }
+
+    Policy = InPolicy;
+    PresentMode = DesiredMode;
+    return true;
+}
+
+FPresentSync FVulkanSwapchain::AcquirePresentSync(uint32_t ImageIndex)
+{
+    if (!bMaintenance1)
+    {
+        return { PresentSemaphores[ImageIndex], VK_NULL_HANDLE };
+    }
+
+    RecyclePresentSyncs(InFlightPresentSyncs);
+
+    if (!FreePresentSyncs.empty())
+    {
+        FPresentSync Sync = FreePresentSyncs.back();
+        FreePresentSyncs.pop_back();
+        vkResetFences(LogicalDevice, 1, &Sync.Fence);
+        return Sync;
+    }
+
+    FPresentSync Sync;
+    VkSemaphoreCreateInfo SemaphoreInfo{};
+    Utils::ZeroVulkanStruct(SemaphoreInfo, VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO);
+    VkFenceCreateInfo FenceInfo{};
+    Utils::ZeroVulkanStruct(FenceInfo, VK_STRUCTURE_TYPE_FENCE_CREATE_INFO);
+
+    if (vkCreateSemaphore(LogicalDevice, &SemaphoreInfo, nullptr, &Sync.Semaphore) != VK_SUCCESS ||
+        vkCreateFence(LogicalDevice, &FenceInfo, nullptr, &Sync.Fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create present sync objects!");
+    }
+    return Sync;
+}
+
+void FVulkanSwapchain::NotifyPresented(uint64_t InTimelineValue, uint64_t InPresentId, const FPresentSync& InSync)
+{
+    LastTimelineValue = InTimelineValue;
+    LastPresentId = InPresentId;
+
+    if (InSync.Fence != VK_NULL_HANDLE)
+    {
+        InFlightPresentSyncs.push_back(InSync);
+    }
+}
+
+void FVulkanSwapchain::RecyclePresentSyncs(std::vector<FPresentSync>& InOutInFlight)
+{
+    std::erase_if(InOutInFlight, [this](const FPresentSync& Sync)
+        {
+            if (vkGetFenceStatus(LogicalDevice, Sync.Fence) != VK_SUCCESS)
+            {
+                return false;
+            }
+            FreePresentSyncs.push_back(Sync);
+            return true;
+        });
+}
+
+void FVulkanSwapchain::ReleaseImage(uint32_t ImageIndex)
+{
+    check(bMaintenance1 && pfnReleaseSwapchainImages);
+
+    VkReleaseSwapchainImagesInfoEXT ReleaseInfo{};
+    Utils::ZeroVulkanStruct(ReleaseInfo, VK_STRUCTURE_TYPE_RELEASE_SWAPCHAIN_IMAGES_INFO_EXT);
+    ReleaseInfo.swapchain = Swapchain;
+    ReleaseInfo.imageIndexCount = 1;
+    ReleaseInfo.pImageIndices = &ImageIndex;
+    VK_CHECK(pfnReleaseSwapchainImages(LogicalDevice, &ReleaseInfo));
+}
+
+void FVulkanSwapchain::CollectRetired(uint64_t CompletedTimelineValue, uint64_t CompletedPresentId)
+{
+    if (bMaintenance1)
+    {
+        RecyclePresentSyncs(InFlightPresentSyncs);
+    }
+
+    std::erase_if(RetiredSwapchains, [&](FRetiredSwapchain& Retired)
+        {
+            if (bMaintenance1)
+            {
+                RecyclePresentSyncs(Retired.InFlightPresentSyncs);
+                if (!Retired.InFlightPresentSyncs.empty())
+                {
+                    return false;
+                }
+                DestroyRetired(Retired);
+                return true;
+            }
+
+            bool bPresentDone = Retired.LastPresentId != 0
+                ? CompletedPresentId >= Retired.LastPresentId
+                : CompletedTimelineValue >= Retired.LastTimelineValue + MAX_FRAMES_IN_FLIGHT;
+
+            if (CompletedTimelineValue < Retired.LastTimelineValue || !bPresentDone)
+            {
+                return false;
+            }
+
+            DestroyRetired(Retired);
+            return true;
+        });
+}
+
+void FVulkanSwapchain::DestroyRetired(FRetiredSwapchain& Retired)
+{
+    Retired.ImageViews.clear();
+
+    for (VkSemaphore Semaphore : Retired.PresentSemaphores)
+    {
+        vkDestroySemaphore(DeviceRef.GetLogicalDevice(), Semaphore, nullptr);
+    }
+    Retired.PresentSemaphores.clear();
+
+    vkDestroySwapchainKHR(DeviceRef.GetLogicalDevice(), Retired.Swapchain, nullptr);
+    Retired.Swapchain = VK_NULL_HANDLE;
 }
 
 void FVulkanSwapchain::Cleanup()
 {
+    // 调用方已 vkDeviceWaitIdle，退休的交换链可以直接销毁
+    for (FRetiredSwapchain& Retired : RetiredSwapchains)
+    {
+        FreePresentSyncs.insert(FreePresentSyncs.end(), Retired.InFlightPresentSyncs.begin(), Retired.InFlightPresentSyncs.end());
+        Retired.InFlightPresentSyncs.clear();
+        DestroyRetired(Retired);
+    }
+    RetiredSwapchains.clear();
+
+    // Present Fence 在设备空闲后也可能尚未发信号 (呈现引擎仍持有)，这里等待一个有限时间
+    FreePresentSyncs.insert(FreePresentSyncs.end(), InFlightPresentSyncs.begin(), InFlightPresentSyncs.end());
+    InFlightPresentSyncs.clear();
+    for (const FPresentSync& Sync : FreePresentSyncs)
+    {
+        vkWaitForFences(LogicalDevice, 1, &Sync.Fence, VK_TRUE, 1'000'000'000ull);
+        vkDestroyFence(LogicalDevice, Sync.Fence, nullptr);
+        vkDestroySemaphore(LogicalDevice, Sync.Semaphore, nullptr);
+    }
+    FreePresentSyncs.clear();
+
     ImageViews.clear();
+
+    for (VkSemaphore Semaphore : PresentSemaphores)
+    {
+        vkDestroySemaphore(DeviceRef.GetLogicalDevice(), Semaphore, nullptr);
+    }
+    PresentSemaphores.clear();
     
     if (Swapchain != VK_NULL_HANDLE)
     {
@@ -187,42 +444,65 @@ FSwapchainSupportDetails FVulkanSwapchain::QuerySwapChainSupport(VkPhysicalDevic
     return Details;
 }
 
-VkSurfaceFormatKHR FVulkanSwapchain::ChooseSwapSurfaceFormat(std::span<const VkSurfaceFormatKHR> AvailableFormats)
+VkSurfaceFormatKHR FVulkanSwapchain::ChooseSwapSurfaceFormat(std::span<const VkSurfaceFormatKHR> AvailableFormats, const FPresentPolicy& InPolicy)
 {
-    // 优先寻找：B8G8R8A8_SRGB + SRGB_NONLINEAR
+    // 默认优先：B8G8R8A8_SRGB + SRGB_NONLINEAR
     // SRGB 格式能让 GPU 自动进行线性空间到 SRGB 的 Gamma 校正，这是 PBR 渲染的基础。
-    for (const auto& AvailableFormat : AvailableFormats)
+    // 策略要求 UNORM 时 (着色器自行校正) 则交换顺序。
+    const VkFormat PreferredFormats[2] =
+    {
+        InPolicy.bPreferSRGB ? VK_FORMAT_B8G8R8A8_SRGB : VK_FORMAT_B8G8R8A8_UNORM,
+        InPolicy.bPreferSRGB ? VK_FORMAT_B8G8R8A8_UNORM : VK_FORMAT_B8G8R8A8_SRGB,
+    };
+
+    for (VkFormat PreferredFormat : PreferredFormats)
     {
-        if (AvailableFormat.format == VK_FORMAT_B8G8R8A8_SRGB &&
-            AvailableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+        for (const auto& AvailableFormat : AvailableFormats)
         {
-            std::cout << "Swapchain Format: VK_FORMAT_B8G8R8A8_SRGB (Best)" << std::endl;
-            return AvailableFormat;
+            if (AvailableFormat.format == PreferredFormat &&
+                AvailableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+            {
+                CA_LOG_INFO("Swapchain", "Swapchain Format: {}", PreferredFormat == VK_FORMAT_B8G8R8A8_SRGB
+                    ? "VK_FORMAT_B8G8R8A8_SRGB" : "VK_FORMAT_B8G8R8A8_UNORM");
+                return AvailableFormat;
+            }
         }
     }
 
     // 如果没找到，退而求其次，返回列表里的第一个
-    // (实际项目中可能还可以找 UNORM 格式手动校正，但通常 SRGB 都是支持的)
-    std::cout << "Swapchain Format: Fallback (First Available)" << std::endl;
+    CA_LOG_WARN("Swapchain", "Swapchain Format: Fallback (First Available)");
     return AvailableFormats[0];
 }
 
-VkPresentModeKHR FVulkanSwapchain::ChooseSwapPresentMode(std::span<const VkPresentModeKHR> AvailablePresentModes)
+VkPresentModeKHR FVulkanSwapchain::ToVkPresentMode(RHIPresentMode Mode)
+{
+    switch (Mode)
+    {
+    case RHIPresentMode::Immediate:   return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    case RHIPresentMode::Mailbox:     return VK_PRESENT_MODE_MAILBOX_KHR;
+    case RHIPresentMode::Fifo:        return VK_PRESENT_MODE_FIFO_KHR;
+    case RHIPresentMode::FifoRelaxed: return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    }
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+VkPresentModeKHR FVulkanSwapchain::ChooseSwapPresentMode(std::span<const VkPresentModeKHR> AvailablePresentModes, const FPresentPolicy& InPolicy)
 {
-    // [Senior Strategy]
-    // 1. Mailbox (三缓冲): 显卡一直画，把最新的一帧给屏幕。延迟低，无撕裂。
-    for (const auto& AvailablePresentMode : AvailablePresentModes)
+    // 按策略给出的顺序依次尝试
+    // 默认策略: Mailbox (三缓冲，延迟低无撕裂) -> FIFO
+    for (RHIPresentMode Mode : InPolicy.PresentModes)
     {
-        if (AvailablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+        VkPresentModeKHR VkMode = ToVkPresentMode(Mode);
+        if (std::find(AvailablePresentModes.begin(), AvailablePresentModes.end(), VkMode) != AvailablePresentModes.end())
         {
-            std::cout << "Present Mode: Mailbox (Best)" << std::endl;
-            return AvailablePresentMode;
+            CA_LOG_INFO("Swapchain", "Present Mode: {}", FPresentPolicy::ToString(Mode));
+            return VkMode;
         }
     }
 
-    // 2. FIFO (垂直同步): 队列满了就等。省电，无撕裂，但有延迟。
+    // FIFO (垂直同步): 队列满了就等。省电，无撕裂，但有延迟。
     // Vulkan 规范保证 FIFO 一定被支持，所以它是完美的保底方案。
-    std::cout << "Present Mode: FIFO (V-Sync)" << std::endl;
+    CA_LOG_INFO("Swapchain", "Present Mode: FIFO (V-Sync, Fallback)");
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -12,19 +12,61 @@ struct FSwapchainSupportDetails
     std::vector<VkPresentModeKHR> PresentModes; // 支持的呈现模式（FIFO, Mailbox...）
 };
 
+// Present 等待的信号量 + Present Fence (VK_EXT_swapchain_maintenance1)
+// Fence 发信号后信号量的等待已完成，二者一起回收复用
+struct FPresentSync
+{
+    VkSemaphore Semaphore = VK_NULL_HANDLE;
+    VkFence Fence = VK_NULL_HANDLE;   // 不支持 maintenance1 时为空
+};
+
+// 被 oldSwapchain 替换下来的交换链及其逐图像资源
+// 在最后一次 Present 完成之前不能销毁，由 CollectRetired 延迟回收
+struct FRetiredSwapchain
+{
+    VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
+    std::vector<TVulkanHandle<VkImageView>> ImageViews;
+    std::vector<VkSemaphore> PresentSemaphores;
+    std::vector<FPresentSync> InFlightPresentSyncs; // maintenance1: 全部 Fence 发信号即可销毁
+    uint64_t LastTimelineValue = 0; // 最后一次 Present 对应帧的 Timeline 值
+    uint64_t LastPresentId = 0;     // 最后一次 Present 的 ID (0 表示不支持 Present Wait)
+};
+
 class FVulkanSwapchain: public FRHISwapchain
 {
 public:
-    FVulkanSwapchain(const uint32_t& InWidth, const uint32_t& InHeight, FVulkanDevice& InDeviceRef, FWindow& InWindowRef);
+    FVulkanSwapchain(const uint32_t& InWidth, const uint32_t& InHeight, FVulkanDevice& InDeviceRef, FWindow& InWindowRef,
+        const FPresentPolicy& InPolicy = FPresentPolicy());
     virtual ~FVulkanSwapchain();
 
     virtual void Resize(const uint32_t& Width, const uint32_t& Height) override;
     virtual bool GetNextImage(uint32_t& OutImageIndex, void* InSignalSemaphore) override;
     virtual bool Present(uint32_t ImageIndex, void* InWaitSemaphore) override;
+    virtual void SetPresentPolicy(const FPresentPolicy& InPolicy) override { Policy = InPolicy; }
 
     void Create(const uint32_t& Width, const uint32_t& Height);
     void Cleanup();
 
+    // 获取本次 Present 使用的信号量 (及 Present Fence)
+    // maintenance1: 从池中取出已完成的信号量；否则使用逐图像信号量
+    FPresentSync AcquirePresentSync(uint32_t ImageIndex);
+
+    // 每次 Present 之后记录，交换链退休时据此判断何时可以安全销毁
+    void NotifyPresented(uint64_t InTimelineValue, uint64_t InPresentId, const FPresentSync& InSync);
+
+    // 销毁最后一次 Present 已完成的退休交换链，并回收已完成的 Present 信号量
+    // maintenance1: 以 Present Fence 为准，精确回收
+    // 否则有 Present ID 时以上屏完成为准；都没有时额外等待 MAX_FRAMES_IN_FLIGHT 帧的 GPU 完成作为保守估计
+    void CollectRetired(uint64_t CompletedTimelineValue, uint64_t CompletedPresentId);
+
+    // maintenance1: 归还已 Acquire 但不再使用的图片 (例如 Acquire 返回 SUBOPTIMAL 需要重建时)
+    void ReleaseImage(uint32_t ImageIndex);
+
+    // maintenance1: 若策略选出的模式与当前交换链兼容，直接在 Present 时切换，无需重建
+    bool TrySwitchPresentMode(const FPresentPolicy& InPolicy);
+    bool SupportsMaintenance1() const { return bMaintenance1; }
+    size_t GetRetiredCount() const { return RetiredSwapchains.size(); }
+
     virtual RHIFormat GetFormat() const override
     {
         return RHIFormat::R8G8B8A8_UNORM; // TODO: RHIFormat 需匹配 SwapchainImageFormat
@@ -38,13 +80,16 @@ public:
     VkSwapchainKHR GetHandle() const { check(Swapchain != VK_NULL_HANDLE); return Swapchain; }
     VkFormat GetVkFormat() const { return ImageFormat; }
     VkExtent2D GetVkExtent() const { return Extent; }
+    VkPresentModeKHR GetVkPresentMode() const { return PresentMode; }
+    const FPresentPolicy& GetPresentPolicy() const { return Policy; }
 
     const std::vector<VkImage>& GetImages() const { return Images; }
     const std::vector<TVulkanHandle<VkImageView>>& GetImageViews() const { return ImageViews; }
 
     static FSwapchainSupportDetails QuerySwapChainSupport(VkPhysicalDevice PhysicalDevice, VkSurfaceKHR Surface);
-    static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(std::span<const VkSurfaceFormatKHR> AvailableFormats);
-    static VkPresentModeKHR ChooseSwapPresentMode(std::span<const VkPresentModeKHR> AvailablePresentModes);
+    static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(std::span<const VkSurfaceFormatKHR> AvailableFormats, const FPresentPolicy& InPolicy);
+    static VkPresentModeKHR ChooseSwapPresentMode(std::span<const VkPresentModeKHR> AvailablePresentModes, const FPresentPolicy& InPolicy);
+    static VkPresentModeKHR ToVkPresentMode(RHIPresentMode Mode);
     static VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& Capabilities, FWindow& Window, const int& Width, const int& Height);
 
 private:
@@ -55,9 +100,29 @@ private:
     VkPhysicalDevice PhysicalDevice;
     VkSurfaceKHR Surface;
 
+    FPresentPolicy Policy;
+
     VkFormat ImageFormat;
     VkExtent2D Extent;
+    VkPresentModeKHR PresentMode = VK_PRESENT_MODE_FIFO_KHR;
     VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
     std::vector<VkImage> Images;
     std::vector<TVulkanHandle<VkImageView>> ImageViews;
+    std::vector<VkSemaphore> PresentSemaphores; // 每张图片一个，Submit 发信号，Present 等待
+
+    uint64_t LastTimelineValue = 0;
+    uint64_t LastPresentId = 0;
+    std::vector<FRetiredSwapchain> RetiredSwapchains;
+
+    // VK_EXT_swapchain_maintenance1
+    bool bMaintenance1 = false;
+    std::vector<VkPresentModeKHR> CompatiblePresentModes; // 无需重建即可切换的模式
+    std::vector<VkPresentModeKHR> SupportedPresentModes;  // Surface 支持的全部模式 (最近一次 Create 时查询)
+    std::vector<FPresentSync> FreePresentSyncs;
+    std::vector<FPresentSync> InFlightPresentSyncs;
+    PFN_vkReleaseSwapchainImagesEXT pfnReleaseSwapchainImages = nullptr;
+
+    void QueryCompatiblePresentModes(VkPresentModeKHR InPresentMode, std::span<const VkPresentModeKHR> AvailablePresentModes);
+    void RecyclePresentSyncs(std::vector<FPresentSync>& InOutInFlight);
+    void DestroyRetired(FRetiredSwapchain& Retired);
 };
\ No newline at end of file
@@ -0,0 +1,799 @@
+﻿#include "VulkanTextureStreamer.h"
+#include "VulkanDevice.h"
+#include "Renderer/FramePacket.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+    constexpr float MAX_ANISOTROPY = 8.0f;
+    // 显存预算中留给纹理之外用途的余量 (预算的 1/10)
+    constexpr uint64_t MEMORY_BUDGET_HEADROOM_DIVISOR = 10;
+    // 纹理 (UV 0..1) 包裹整个物体：一个 UV 周期大约覆盖物体屏幕直径的两倍 (绕物体一周)
+    constexpr float TEXTURE_SCREEN_COVERAGE = 2.0f;
+
+    constexpr uint32_t BINDING_TEXTURES = 0;
+    constexpr uint32_t BINDING_SAMPLER = 1;
+    constexpr uint32_t BINDING_FEEDBACK = 2;
+    constexpr uint32_t FEEDBACK_CLEAR_VALUE = UINT32_MAX;
+
+    constexpr VkDeviceSize AlignUp(VkDeviceSize Value, VkDeviceSize Alignment)
+    {
+        return (Value + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    // 第一个不超过 MIP_TAIL_SIZE 的 mip；整张纹理都不超过时为 0
+    uint32_t FindTailMip(const FTextureAsset& Asset)
+    {
+        uint32_t Mip = 0;
+        while (Mip + 1 < Asset.GetMipCount())
+        {
+            const FTextureAssetMip& Desc = Asset.GetMipDesc(Mip);
+            if (std::max(Desc.Width, Desc.Height) <= FVulkanTextureStreamer::MIP_TAIL_SIZE)
+            {
+                break;
+            }
+            Mip++;
+        }
+        return Mip;
+    }
+
+    VkImageMemoryBarrier2 MakeImageBarrier(VkImage Image, VkPipelineStageFlags2 SrcStage, VkAccessFlags2 SrcAccess,
+        VkPipelineStageFlags2 DstStage, VkAccessFlags2 DstAccess, VkImageLayout OldLayout, VkImageLayout NewLayout)
+    {
+        VkImageMemoryBarrier2 Barrier{};
+        Utils::ZeroVulkanStruct(Barrier, VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2);
+        Barrier.srcStageMask = SrcStage;
+        Barrier.srcAccessMask = SrcAccess;
+        Barrier.dstStageMask = DstStage;
+        Barrier.dstAccessMask = DstAccess;
+        Barrier.oldLayout = OldLayout;
+        Barrier.newLayout = NewLayout;
+        Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        Barrier.image = Image;
+        Barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, 1 };
+        return Barrier;
+    }
+}
+
+FVulkanTextureStreamer::FVulkanTextureStreamer(FVulkanDevice& InDevice, const std::filesystem::path& Directory, const FTextureStreamingConfig& InConfig)
+    : DeviceRef(InDevice), LogicalDevice(InDevice.GetLogicalDevice()), Allocator(InDevice.GetAllocator()), Config(InConfig)
+{
+    std::vector<std::filesystem::path> Paths;
+    std::error_code Error;
+    for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator(Directory, Error))
+    {
+        if (Entry.is_regular_file() && Entry.path().extension() == ".ctex")
+        {
+            Paths.push_back(Entry.path());
+        }
+    }
+    if (Paths.empty())
+    {
+        throw std::runtime_error("failed to find texture assets (.ctex) in: " + Directory.string());
+    }
+    std::sort(Paths.begin(), Paths.end());
+    if (Paths.size() > MAX_TEXTURES)
+    {
+        CA_LOG_WARN("TextureStreaming", "{} textures in {}, streaming the first {}.", Paths.size(), Directory.string(), MAX_TEXTURES);
+        Paths.resize(MAX_TEXTURES);
+    }
+
+    Textures.reserve(Paths.size());
+    for (const std::filesystem::path& Path : Paths)
+    {
+        FTexture& Texture = Textures.emplace_back(Path);
+        std::array<uint64_t, TEXTURE_ASSET_MAX_MIPS> MipBytes{};
+        for (uint32_t Mip = 0; Mip < Texture.Asset.GetMipCount(); Mip++)
+        {
+            MipBytes[Mip] = Texture.Asset.GetMipDesc(Mip).Size;
+        }
+        Residency.AddTexture(std::span(MipBytes.data(), Texture.Asset.GetMipCount()), FindTailMip(Texture.Asset));
+    }
+
+    CreateSampler();
+    CreateDescriptors();
+    CreateFrameResources();
+    UploadMipTails();
+
+    uint64_t TotalBytes = 0;
+    for (const FTexture& Texture : Textures)
+    {
+        TotalBytes += Texture.Asset.GetHeader().FileSize;
+    }
+    CA_LOG_INFO("TextureStreaming", "{} textures ({} MB of mips on disk), mip tails {} KB resident, pool {} MB, upload budget {} KB/frame, mip requests from {}.",
+        Textures.size(), TotalBytes / (1024 * 1024), Residency.GetTailBytes() / 1024, Config.PoolBytes / (1024 * 1024),
+        Config.UploadBytesPerFrame / 1024, Config.bSamplerFeedback ? "sampler feedback" : "CPU estimate");
+}
+
+FVulkanTextureStreamer::~FVulkanTextureStreamer()
+{
+    for (std::pair<uint64_t, FImage>& Retired : RetiredImages)
+    {
+        DestroyImage(Retired.second);
+    }
+    for (FTexture& Texture : Textures)
+    {
+        DestroyImage(Texture.Current);
+        DestroyImage(Texture.Pending);
+    }
+    for (FFrameResources& Frame : Frames)
+    {
+        if (Frame.Staging != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(Allocator, Frame.Staging, Frame.StagingAllocation);
+        }
+        if (Frame.Feedback != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(Allocator, Frame.Feedback, Frame.FeedbackAllocation);
+        }
+    }
+    if (DescriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(LogicalDevice, DescriptorPool, nullptr);
+    }
+    if (DescriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(LogicalDevice, DescriptorSetLayout, nullptr);
+    }
+    if (Sampler != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(LogicalDevice, Sampler, nullptr);
+    }
+}
+
+FVulkanTextureStreamer::FImage FVulkanTextureStreamer::CreateImage(const FTextureAsset& Asset, uint32_t TopMip) const
+{
+    const FTextureAssetMip& Top = Asset.GetMipDesc(TopMip);
+
+    VkImageCreateInfo ImageInfo{};
+    Utils::ZeroVulkanStruct(ImageInfo, VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO);
+    ImageInfo.imageType = VK_IMAGE_TYPE_2D;
+    ImageInfo.format = TEXTURE_FORMAT;
+    ImageInfo.extent = { Top.Width, Top.Height, 1 };
+    ImageInfo.mipLevels = Asset.GetMipCount() - TopMip;
+    ImageInfo.arrayLayers = 1;
+    ImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    ImageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // TRANSFER_SRC：下一次调整时保留的 mip 从这里拷出
+    ImageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    ImageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    ImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VmaAllocationCreateInfo AllocInfo{};
+    AllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    FImage Result;
+    Result.TopMip = TopMip;
+    if (vmaCreateImage(Allocator, &ImageInfo, &AllocInfo, &Result.Image, &Result.Allocation, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create streamed texture image!");
+    }
+
+    VkImageViewCreateInfo ViewInfo{};
+    Utils::ZeroVulkanStruct(ViewInfo, VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO);
+    ViewInfo.image = Result.Image;
+    ViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    ViewInfo.format = TEXTURE_FORMAT;
+    ViewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, ImageInfo.mipLevels, 0, 1 };
+    if (vkCreateImageView(LogicalDevice, &ViewInfo, nullptr, &Result.View) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create streamed texture image view!");
+    }
+    return Result;
+}
+
+void FVulkanTextureStreamer::DestroyImage(FImage& InImage) const
+{
+    if (InImage.View != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(LogicalDevice, InImage.View, nullptr);
+    }
+    if (InImage.Image != VK_NULL_HANDLE)
+    {
+        vmaDestroyImage(Allocator, InImage.Image, InImage.Allocation);
+    }
+    InImage = FImage{};
+}
+
+void FVulkanTextureStreamer::CreateSampler()
+{
+    VkPhysicalDeviceProperties Properties{};
+    vkGetPhysicalDeviceProperties(DeviceRef.GetPhysicalDevice(), &Properties);
+
+    // 三线性 + 各向异性；maxLod 不设上限，图像只含驻留的 mip，采样自然落在已驻留的最精细一级
+    VkSamplerCreateInfo SamplerInfo{};
+    Utils::ZeroVulkanStruct(SamplerInfo, VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO);
+    SamplerInfo.magFilter = VK_FILTER_LINEAR;
+    SamplerInfo.minFilter = VK_FILTER_LINEAR;
+    SamplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    SamplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    SamplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    SamplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    SamplerInfo.anisotropyEnable = VK_TRUE;
+    SamplerInfo.maxAnisotropy = std::min(MAX_ANISOTROPY, Properties.limits.maxSamplerAnisotropy);
+    SamplerInfo.minLod = 0.0f;
+    SamplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(LogicalDevice, &SamplerInfo, nullptr, &Sampler) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create texture sampler!");
+    }
+}
+
+void FVulkanTextureStreamer::CreateDescriptors()
+{
+    VkDescriptorSetLayoutBinding Bindings[3]{};
+    Bindings[BINDING_TEXTURES].binding = BINDING_TEXTURES;
+    Bindings[BINDING_TEXTURES].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    Bindings[BINDING_TEXTURES].descriptorCount = MAX_TEXTURES;
+    Bindings[BINDING_TEXTURES].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    Bindings[BINDING_SAMPLER].binding = BINDING_SAMPLER;
+    Bindings[BINDING_SAMPLER].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    Bindings[BINDING_SAMPLER].descriptorCount = 1;
+    Bindings[BINDING_SAMPLER].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    Bindings[BINDING_SAMPLER].pImmutableSamplers = &Sampler;
+    Bindings[BINDING_FEEDBACK].binding = BINDING_FEEDBACK;
+    Bindings[BINDING_FEEDBACK].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    Bindings[BINDING_FEEDBACK].descriptorCount = 1;
+    Bindings[BINDING_FEEDBACK].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo LayoutInfo{};
+    Utils::ZeroVulkanStruct(LayoutInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
+    LayoutInfo.bindingCount = static_cast<uint32_t>(std::size(Bindings));
+    LayoutInfo.pBindings = Bindings;
+    if (vkCreateDescriptorSetLayout(LogicalDevice, &LayoutInfo, nullptr, &DescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create texture descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize PoolSizes[3]{};
+    PoolSizes[0] = { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, MAX_TEXTURES * MAX_FRAMES_IN_FLIGHT };
+    PoolSizes[1] = { VK_DESCRIPTOR_TYPE_SAMPLER, MAX_FRAMES_IN_FLIGHT };
+    PoolSizes[2] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_FRAMES_IN_FLIGHT };
+
+    VkDescriptorPoolCreateInfo PoolInfo{};
+    Utils::ZeroVulkanStruct(PoolInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO);
+    PoolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    PoolInfo.poolSizeCount = static_cast<uint32_t>(std::size(PoolSizes));
+    PoolInfo.pPoolSizes = PoolSizes;
+    if (vkCreateDescriptorPool(LogicalDevice, &PoolInfo, nullptr, &DescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create texture descriptor pool!");
+    }
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> Layouts;
+    Layouts.fill(DescriptorSetLayout);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> Sets;
+
+    VkDescriptorSetAllocateInfo AllocInfo{};
+    Utils::ZeroVulkanStruct(AllocInfo, VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO);
+    AllocInfo.descriptorPool = DescriptorPool;
+    AllocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+    AllocInfo.pSetLayouts = Layouts.data();
+    if (vkAllocateDescriptorSets(LogicalDevice, &AllocInfo, Sets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to allocate texture descriptor sets!");
+    }
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        Frames[i].DescriptorSet = Sets[i];
+    }
+}
+
+void FVulkanTextureStreamer::CreateFrameResources()
+{
+    // 暂存放在系统内存：CPU 顺序写入，GPU 经 PCIe 读取一次
+    VkBufferCreateInfo BufferInfo{};
+    Utils::ZeroVulkanStruct(BufferInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    BufferInfo.size = Config.UploadBytesPerFrame;
+    BufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    BufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo AllocCreateInfo{};
+    AllocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    AllocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    // 反馈缓冲只有每纹理一个 uint：GPU 直接原子写入主机内存，回读不需要额外拷贝
+    VkBufferCreateInfo FeedbackInfo{};
+    Utils::ZeroVulkanStruct(FeedbackInfo, VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO);
+    FeedbackInfo.size = sizeof(uint32_t) * MAX_TEXTURES;
+    FeedbackInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    FeedbackInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo FeedbackAllocInfo{};
+    FeedbackAllocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+    FeedbackAllocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    for (FFrameResources& Frame : Frames)
+    {
+        VmaAllocationInfo AllocationInfo{};
+        if (vmaCreateBuffer(Allocator, &BufferInfo, &AllocCreateInfo, &Frame.Staging, &Frame.StagingAllocation, &AllocationInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture staging buffer!");
+        }
+        Frame.StagingMapped = static_cast<std::byte*>(AllocationInfo.pMappedData);
+        Frame.DirtyDescriptors.assign(Textures.size(), false);
+        Frame.BoundTopMips.assign(Textures.size(), 0);
+
+        if (vmaCreateBuffer(Allocator, &FeedbackInfo, &FeedbackAllocInfo, &Frame.Feedback, &Frame.FeedbackAllocation, &AllocationInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create texture feedback buffer!");
+        }
+        Frame.FeedbackMapped = static_cast<const uint32_t*>(AllocationInfo.pMappedData);
+
+        const VkDescriptorBufferInfo FeedbackBufferInfo{ Frame.Feedback, 0, VK_WHOLE_SIZE };
+        VkWriteDescriptorSet Write{};
+        Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        Write.dstSet = Frame.DescriptorSet;
+        Write.dstBinding = BINDING_FEEDBACK;
+        Write.descriptorCount = 1;
+        Write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        Write.pBufferInfo = &FeedbackBufferInfo;
+        vkUpdateDescriptorSets(LogicalDevice, 1, &Write, 0, nullptr);
+    }
+}
+
+void FVulkanTextureStreamer::UploadMipTails()
+{
+    FVulkanStagingUploader& Uploader = DeviceRef.GetStagingUploader();
+    for (uint32_t i = 0; i < Textures.size(); i++)
+    {
+        FTexture& Texture = Textures[i];
+        const uint32_t TailMip = Residency.GetResidentMip(i);
+        const uint32_t MipCount = Texture.Asset.GetMipCount();
+        Texture.Asset.PrefetchMips(TailMip, MipCount);
+        Texture.Current = CreateImage(Texture.Asset, TailMip);
+        for (FFrameResources& Frame : Frames)
+        {
+            Frame.BoundTopMips[i] = TailMip;
+        }
+
+        for (uint32_t Mip = TailMip; Mip < MipCount; Mip++)
+        {
+            const FTextureAssetMip& Desc = Texture.Asset.GetMipDesc(Mip);
+            Uploader.UploadImageMip(Texture.Current.Image, Mip - TailMip, Desc.Width, Desc.Height, FTextureAsset::BYTES_PER_TEXEL,
+                Texture.Asset.GetMip(Mip), Mip == TailMip, Mip + 1 == MipCount, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+    }
+    Uploader.Flush();
+
+    // 纹理所在的显存堆：预算按这个堆的用量计算
+    VmaAllocationInfo AllocationInfo{};
+    vmaGetAllocationInfo(Allocator, Textures[0].Current.Allocation, &AllocationInfo);
+    const VkPhysicalDeviceMemoryProperties* MemoryProperties = nullptr;
+    vmaGetMemoryProperties(Allocator, &MemoryProperties);
+    MemoryHeapIndex = MemoryProperties->memoryTypes[AllocationInfo.memoryType].heapIndex;
+
+    // 描述符数组必须全部有效：超出纹理数的槽位指向纹理 0 (着色器按纹理数取模，不会访问它们)
+    std::vector<VkDescriptorImageInfo> ImageInfos(MAX_TEXTURES);
+    for (uint32_t i = 0; i < MAX_TEXTURES; i++)
+    {
+        const FTexture& Texture = Textures[i < Textures.size() ? i : 0];
+        ImageInfos[i] = { VK_NULL_HANDLE, Texture.Current.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    }
+    for (FFrameResources& Frame : Frames)
+    {
+        VkWriteDescriptorSet Write{};
+        Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        Write.dstSet = Frame.DescriptorSet;
+        Write.dstBinding = BINDING_TEXTURES;
+        Write.descriptorCount = MAX_TEXTURES;
+        Write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        Write.pImageInfo = ImageInfos.data();
+        vkUpdateDescriptorSets(LogicalDevice, 1, &Write, 0, nullptr);
+    }
+}
+
+uint64_t FVulkanTextureStreamer::ComputeBudget() const
+{
+    // VMA 报告整个堆的预算与用量 (启用 VK_EXT_memory_budget 时来自驱动，含其它进程)；纹理之外的用量加余量之后剩下的才给纹理
+    VmaBudget Budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(Allocator, Budgets);
+    const VmaBudget& Heap = Budgets[MemoryHeapIndex];
+
+    const int64_t Slack = static_cast<int64_t>(Heap.budget - Heap.budget / MEMORY_BUDGET_HEADROOM_DIVISOR) - static_cast<int64_t>(Heap.usage);
+    const int64_t HeapLimit = std::max(static_cast<int64_t>(Residency.GetCommittedBytes()) + Slack, static_cast<int64_t>(Residency.GetTailBytes()));
+    return std::min(Config.PoolBytes, static_cast<uint64_t>(HeapLimit));
+}
+
+void FVulkanTextureStreamer::CollectRetired(uint64_t CompletedValue, uint64_t NowNs)
+{
+    std::erase_if(RetiredImages, [this, CompletedValue](std::pair<uint64_t, FImage>& Retired)
+        {
+            if (Retired.first > CompletedValue)
+            {
+                return false;
+            }
+            DestroyImage(Retired.second);
+            return true;
+        });
+
+    std::erase_if(PendingLatencies, [this, CompletedValue, NowNs](const std::pair<uint64_t, uint64_t>& Latency)
+        {
+            if (Latency.first > CompletedValue)
+            {
+                return false;
+            }
+            const uint64_t LatencyNs = NowNs - Latency.second;
+            StatsLatencyCount++;
+            StatsLatencySumNs += LatencyNs;
+            StatsLatencyMaxNs = std::max(StatsLatencyMaxNs, LatencyNs);
+            return true;
+        });
+}
+
+void FVulkanTextureStreamer::RequestVisibleMips(const FFramePacket& Packet)
+{
+    // 深度 1 处一个世界单位的像素数 (投影矩阵 [1][1] 为 -cot(FovY / 2)，Y 已翻转)
+    const float PixelsPerUnit = std::abs(Packet.Projection.Columns[1].Y) * 0.5f * static_cast<float>(Packet.ViewportHeight);
+    const FFrustum Frustum = FFrustum::FromViewProjection(Packet.ViewProjection);
+    const uint32_t TextureCount = GetTextureCount();
+
+    // 与 MeshletCommon.hlsli 一致：实例 i 使用纹理 i % 纹理数
+    for (uint32_t i = 0; i < Packet.Instances.size(); i++)
+    {
+        const FSphere& Bounds = Packet.Instances[i].Bounds;
+        if (!Frustum.Intersects(Bounds))
+        {
+            continue;
+        }
+
+        const uint32_t Texture = i % TextureCount;
+        const float Depth = -Packet.View.TransformPoint(Bounds.Center).Z;
+        if (Depth <= Bounds.Radius)
+        {
+            Residency.Request(Texture, 0);
+            continue;
+        }
+
+        // 一个 UV 周期在屏幕上覆盖的像素数 vs. 纹理宽度：每像素超过 2^m 个纹素时需要第 m 级
+        const float ScreenPixels = 2.0f * Bounds.Radius * PixelsPerUnit / Depth * TEXTURE_SCREEN_COVERAGE;
+        const FTextureAssetMip& Top = Textures[Texture].Asset.GetMipDesc(0);
+        const float TexelsPerPixel = static_cast<float>(std::max(Top.Width, Top.Height)) / std::max(ScreenPixels, 1.0f);
+        const uint32_t Mip = TexelsPerPixel > 1.0f ? static_cast<uint32_t>(std::floor(std::log2(TexelsPerPixel))) : 0;
+        Residency.Request(Texture, Mip);
+    }
+}
+
+void FVulkanTextureStreamer::RequestFeedbackMips(FFrameResources& Frame)
+{
+    // 本槽上一轮的帧已在 GPU 上完成 (调用方等待过它的 Timeline 值)，反馈是 MAX_FRAMES_IN_FLIGHT 帧之前采样的结果
+    if (!Frame.bFeedbackSubmitted)
+    {
+        return;
+    }
+
+    vmaInvalidateAllocation(Allocator, Frame.FeedbackAllocation, 0, VK_WHOLE_SIZE);
+    for (uint32_t i = 0; i < Textures.size(); i++)
+    {
+        const uint32_t Value = Frame.FeedbackMapped[i];
+        if (Value == FEEDBACK_CLEAR_VALUE)
+        {
+            continue;
+        }
+
+        // 反馈相对于当时绑定的图像：加回它的 TopMip，放大 (级数为负) 时需要比驻留更精细的 mip
+        const int32_t Mip = static_cast<int32_t>(Value) - static_cast<int32_t>(FEEDBACK_MIP_BIAS) + static_cast<int32_t>(Frame.BoundTopMips[i]);
+        Residency.Request(i, static_cast<uint32_t>(std::max(Mip, 0)));
+    }
+}
+
+void FVulkanTextureStreamer::StartChange(FFrameResources& Frame, const FTextureResidencyChange& Change, uint64_t SignalValue)
+{
+    FTexture& Texture = Textures[Change.Texture];
+    const uint32_t CurrentTopMip = Texture.Current.TopMip;
+
+    Texture.Pending = CreateImage(Texture.Asset, Change.TopMip);
+    Texture.UploadMip = Change.TopMip;
+    Texture.UploadEndMip = std::max(Change.TopMip, CurrentTopMip);
+    Texture.UploadRow = 0;
+    Texture.ChangeStartValue = SignalValue;
+    Frame.NewImages.push_back(Texture.Pending.Image);
+    PendingTextures.push_back(Change.Texture);
+
+    if (Change.TopMip < CurrentTopMip)
+    {
+        // 调入：新增的 mip 下一帧起才开始上传，预读先把它们从磁盘换入页缓存
+        Texture.Asset.PrefetchMips(Change.TopMip, CurrentTopMip);
+        StatsStreamedIn++;
+    }
+    else
+    {
+        StatsEvicted++;
+    }
+}
+
+void FVulkanTextureStreamer::UploadPending(FFrameResources& Frame, uint64_t SignalValue)
+{
+    for (uint32_t TextureIndex : PendingTextures)
+    {
+        FTexture& Texture = Textures[TextureIndex];
+        if (Texture.ChangeStartValue == SignalValue)
+        {
+            continue;
+        }
+
+        while (Texture.UploadMip < Texture.UploadEndMip)
+        {
+            const FTextureAssetMip& Desc = Texture.Asset.GetMipDesc(Texture.UploadMip);
+            const VkDeviceSize RowPitch = static_cast<VkDeviceSize>(Desc.Width) * FTextureAsset::BYTES_PER_TEXEL;
+            const uint32_t RowCount = static_cast<uint32_t>(std::min<VkDeviceSize>(Desc.Height - Texture.UploadRow,
+                (Config.UploadBytesPerFrame - Frame.StagingUsed) / RowPitch));
+            if (RowCount == 0)
+            {
+                // 本帧的上传预算用完
+                return;
+            }
+
+            const VkDeviceSize ChunkSize = RowPitch * RowCount;
+            std::memcpy(Frame.StagingMapped + Frame.StagingUsed, Texture.Asset.GetMip(Texture.UploadMip).data() + RowPitch * Texture.UploadRow, ChunkSize);
+
+            FImageUpload Upload{};
+            Upload.Image = Texture.Pending.Image;
+            Upload.Region.bufferOffset = Frame.StagingUsed;
+            Upload.Region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Texture.UploadMip - Texture.Pending.TopMip, 0, 1 };
+            Upload.Region.imageOffset = { 0, static_cast<int32_t>(Texture.UploadRow), 0 };
+            Upload.Region.imageExtent = { Desc.Width, RowCount, 1 };
+            Frame.Uploads.push_back(Upload);
+
+            // 下一块的偏移保持 16 字节对齐
+            Frame.StagingUsed = std::min(Config.UploadBytesPerFrame, AlignUp(Frame.StagingUsed + ChunkSize, 16));
+            StatsUploadedBytes += ChunkSize;
+
+            Texture.UploadRow += RowCount;
+            if (Texture.UploadRow == Desc.Height)
+            {
+                Texture.UploadMip++;
+                Texture.UploadRow = 0;
+            }
+        }
+    }
+}
+
+void FVulkanTextureStreamer::CompletePending(FFrameResources& Frame, uint64_t SignalValue)
+{
+    std::erase_if(PendingTextures, [this, &Frame, SignalValue](uint32_t TextureIndex)
+        {
+            FTexture& Texture = Textures[TextureIndex];
+            if (Texture.UploadMip < Texture.UploadEndMip)
+            {
+                return false;
+            }
+
+            // 保留的 mip 与布局转换在本帧录制；旧图像可能仍被飞行中的帧采样，等本帧在 GPU 上完成后回收
+            Frame.Completions.push_back({ Texture.Current, Texture.Pending, &Texture.Asset });
+            RetiredImages.emplace_back(SignalValue, Texture.Current);
+            Texture.Current = Texture.Pending;
+            Texture.Pending = FImage{};
+            for (FFrameResources& Slot : Frames)
+            {
+                Slot.DirtyDescriptors[TextureIndex] = true;
+            }
+
+            if (const uint64_t WaitingSinceNs = Residency.CompleteChange(TextureIndex))
+            {
+                PendingLatencies.emplace_back(SignalValue, WaitingSinceNs);
+            }
+            return true;
+        });
+}
+
+void FVulkanTextureStreamer::WriteDirtyDescriptors(FFrameResources& Frame)
+{
+    std::vector<VkDescriptorImageInfo> ImageInfos;
+    std::vector<VkWriteDescriptorSet> Writes;
+    ImageInfos.reserve(Textures.size());
+    for (uint32_t i = 0; i < Textures.size(); i++)
+    {
+        if (!Frame.DirtyDescriptors[i])
+        {
+            continue;
+        }
+        Frame.DirtyDescriptors[i] = false;
+        Frame.BoundTopMips[i] = Textures[i].Current.TopMip;
+        ImageInfos.push_back({ VK_NULL_HANDLE, Textures[i].Current.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL });
+
+        VkWriteDescriptorSet& Write = Writes.emplace_back();
+        Utils::ZeroVulkanStruct(Write, VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET);
+        Write.dstSet = Frame.DescriptorSet;
+        Write.dstBinding = BINDING_TEXTURES;
+        Write.dstArrayElement = i;
+        Write.descriptorCount = 1;
+        Write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        Write.pImageInfo = &ImageInfos.back();
+    }
+    if (!Writes.empty())
+    {
+        vkUpdateDescriptorSets(LogicalDevice, static_cast<uint32_t>(Writes.size()), Writes.data(), 0, nullptr);
+    }
+}
+
+void FVulkanTextureStreamer::BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet, uint64_t SignalValue, uint64_t CompletedValue)
+{
+    FFrameResources& Frame = Frames[FrameSlot];
+    Frame.StagingUsed = 0;
+    Frame.NewImages.clear();
+    Frame.Uploads.clear();
+    Frame.Completions.clear();
+    const uint64_t NowNs = Utils::GetTimeNs();
+
+    // 1. 回收 GPU 不再引用的旧图像；用上新图像的帧已完成的调整计入延迟
+    CollectRetired(CompletedValue, NowNs);
+
+    // 2. 先推进已在进行的调入，再按本帧的需求调度：新发起的调入留一帧给预读
+    UploadPending(Frame, SignalValue);
+
+    if (Config.bSamplerFeedback)
+    {
+        RequestFeedbackMips(Frame);
+        Frame.bFeedbackSubmitted = true;
+    }
+    else
+    {
+        RequestVisibleMips(Packet);
+    }
+    Changes.clear();
+    const uint32_t MaxStarts = MAX_PENDING_CHANGES - std::min(MAX_PENDING_CHANGES, static_cast<uint32_t>(PendingTextures.size()));
+    Residency.Update(NowNs, ComputeBudget(), MaxStarts, Changes);
+    for (const FTextureResidencyChange& Change : Changes)
+    {
+        StartChange(Frame, Change, SignalValue);
+    }
+
+    // 3. 上传完毕的调入与本帧发起的降级 (没有要上传的 mip) 在本帧切换
+    CompletePending(Frame, SignalValue);
+    if (Frame.StagingUsed > 0)
+    {
+        vmaFlushAllocation(Allocator, Frame.StagingAllocation, 0, Frame.StagingUsed);
+    }
+
+    // 4. 本槽上一轮的帧已完成，它的描述符可以改写
+    WriteDirtyDescriptors(Frame);
+
+    AccumulateStats(NowNs);
+}
+
+void FVulkanTextureStreamer::RecordUploads(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot)
+{
+    const FFrameResources& Frame = Frames[FrameSlot];
+    if (Config.bSamplerFeedback)
+    {
+        // 上一轮的反馈已在 BeginFrame 中回读
+        vkCmdFillBuffer(InCommandBuffer, Frame.Feedback, 0, VK_WHOLE_SIZE, FEEDBACK_CLEAR_VALUE);
+
+        VkMemoryBarrier2 ClearBarrier{};
+        Utils::ZeroVulkanStruct(ClearBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+        ClearBarrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+        ClearBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        ClearBarrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        ClearBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+        VkDependencyInfo ClearDependency{};
+        Utils::ZeroVulkanStruct(ClearDependency, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+        ClearDependency.memoryBarrierCount = 1;
+        ClearDependency.pMemoryBarriers = &ClearBarrier;
+        vkCmdPipelineBarrier2(InCommandBuffer, &ClearDependency);
+    }
+
+    if (Frame.NewImages.empty() && Frame.Uploads.empty() && Frame.Completions.empty())
+    {
+        return;
+    }
+
+    // 1. 新图像进入 TRANSFER_DST，本帧完成调整的旧图像转为拷贝源；之前帧对进行中图像的拷贝先于本帧的拷贝
+    std::vector<VkImageMemoryBarrier2> ImageBarriers;
+    for (VkImage Image : Frame.NewImages)
+    {
+        ImageBarriers.push_back(MakeImageBarrier(Image, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL));
+    }
+    for (const FCompletedChange& Completion : Frame.Completions)
+    {
+        ImageBarriers.push_back(MakeImageBarrier(Completion.Old.Image, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_NONE,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL));
+    }
+
+    VkMemoryBarrier2 CopyBarrier{};
+    Utils::ZeroVulkanStruct(CopyBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    CopyBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    CopyBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    CopyBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    CopyBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &CopyBarrier;
+    DependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(ImageBarriers.size());
+    DependencyInfo.pImageMemoryBarriers = ImageBarriers.data();
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+
+    // 2. 暂存 -> 进行中的新图像
+    for (const FImageUpload& Upload : Frame.Uploads)
+    {
+        vkCmdCopyBufferToImage(InCommandBuffer, Frame.Staging, Upload.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Upload.Region);
+    }
+
+    if (Frame.Completions.empty())
+    {
+        return;
+    }
+
+    // 3. 完成的调整：两个图像都有的 mip 在 GPU 上拷贝，新图像转为着色器只读
+    ImageBarriers.clear();
+    for (const FCompletedChange& Completion : Frame.Completions)
+    {
+        std::array<VkImageCopy, TEXTURE_ASSET_MAX_MIPS> Regions{};
+        uint32_t RegionCount = 0;
+        for (uint32_t Mip = std::max(Completion.Old.TopMip, Completion.New.TopMip); Mip < Completion.Asset->GetMipCount(); Mip++)
+        {
+            const FTextureAssetMip& Desc = Completion.Asset->GetMipDesc(Mip);
+            VkImageCopy& Region = Regions[RegionCount++];
+            Region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Mip - Completion.Old.TopMip, 0, 1 };
+            Region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Mip - Completion.New.TopMip, 0, 1 };
+            Region.extent = { Desc.Width, Desc.Height, 1 };
+        }
+        vkCmdCopyImage(InCommandBuffer, Completion.Old.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            Completion.New.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, RegionCount, Regions.data());
+
+        ImageBarriers.push_back(MakeImageBarrier(Completion.New.Image, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+    }
+
+    DependencyInfo.memoryBarrierCount = 0;
+    DependencyInfo.pMemoryBarriers = nullptr;
+    DependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(ImageBarriers.size());
+    DependencyInfo.pImageMemoryBarriers = ImageBarriers.data();
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
+
+void FVulkanTextureStreamer::RecordFeedbackBarrier(VkCommandBuffer InCommandBuffer)
+{
+    if (!Config.bSamplerFeedback)
+    {
+        return;
+    }
+
+    VkMemoryBarrier2 FeedbackBarrier{};
+    Utils::ZeroVulkanStruct(FeedbackBarrier, VK_STRUCTURE_TYPE_MEMORY_BARRIER_2);
+    FeedbackBarrier.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+    FeedbackBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+    FeedbackBarrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+    FeedbackBarrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+    VkDependencyInfo DependencyInfo{};
+    Utils::ZeroVulkanStruct(DependencyInfo, VK_STRUCTURE_TYPE_DEPENDENCY_INFO);
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &FeedbackBarrier;
+    vkCmdPipelineBarrier2(InCommandBuffer, &DependencyInfo);
+}
+
+void FVulkanTextureStreamer::AccumulateStats(uint64_t NowNs)
+{
+    if (StatsFrameCount++ == 0)
+    {
+        StatsBeginNs = NowNs;
+        return;
+    }
+    if (StatsFrameCount < STATS_INTERVAL)
+    {
+        return;
+    }
+
+    const double Seconds = (NowNs - StatsBeginNs) / 1e9;
+    CA_LOG_INFO("TextureStreaming", "Resident {} MB / budget {} MB, {} pending, {} streamed in, {} evicted, upload {} MB/s, request-to-visible latency avg {} ms, max {} ms ({} samples).",
+        Residency.GetCommittedBytes() / (1024 * 1024), ComputeBudget() / (1024 * 1024), PendingTextures.size(), StatsStreamedIn, StatsEvicted,
+        Seconds > 0.0 ? StatsUploadedBytes / (1024.0 * 1024.0) / Seconds : 0.0,
+        StatsLatencyCount > 0 ? StatsLatencySumNs / 1e6 / StatsLatencyCount : 0.0, StatsLatencyMaxNs / 1e6, StatsLatencyCount);
+
+    StatsFrameCount = 0;
+    StatsUploadedBytes = 0;
+    StatsStreamedIn = 0;
+    StatsEvicted = 0;
+    StatsLatencyCount = 0;
+    StatsLatencySumNs = 0;
+    StatsLatencyMaxNs = 0;
+}
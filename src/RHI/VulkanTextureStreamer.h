@@ -0,0 +1,161 @@
+﻿#pragma once
+#include "vk_mem_alloc.h"
+#include "Renderer/TextureAsset.h"
+#include "Renderer/TextureResidency.h"
+
+class FVulkanDevice;
+struct FFramePacket;
+
+struct FTextureStreamingConfig
+{
+    uint64_t PoolBytes = 256ull * 1024 * 1024;          // 纹理驻留上限，实际预算还受 VMA 报告的显存预算约束
+    uint64_t UploadBytesPerFrame = 8ull * 1024 * 1024;  // 每帧暂存上传的字节上限
+    bool bSamplerFeedback = true;  // 片元着色器回写每个纹理实际采样的 mip；关闭或设备不支持时按实例包围球在 CPU 上估计
+};
+
+// 纹理流送：目录下全部 .ctex 资源映射进内存，显存中只驻留需要的 mip
+// - 不超过 MIP_TAIL_SIZE 的低分辨率 mip 尾部启动时一次上传，永远常驻，任何纹理随时都可采样
+// - 需要的 mip 来自采样反馈：片元着色器按纹理序号对反馈缓冲做原子 min，该帧槽下一轮 (GPU 已完成) 时回读；
+//   关闭反馈时按可见实例的屏幕空间尺寸在 CPU 上估计。请求交给 FTextureResidency 汇总、排优先级、按 LRU 逐出
+// - 调整驻留范围 = 换一个 mip 数不同的新图像：新增的 mip 经每帧一份的暂存缓冲按行分块上传 (受每帧字节预算约束)，
+//   保留的 mip 在 GPU 上从旧图像拷贝；完成后描述符切到新图像，旧图像待引用它的帧在 GPU 上完成后按 Timeline 值回收
+// - 绑定式描述符 (set 1)：纹理数组 + 不可变采样器 + 反馈缓冲，每个飞行帧一份，只在该帧槽被等待之后改写
+// - 延迟：从需求出现到用上新图像的帧在 GPU 上完成，周期性地与驻留量、上传带宽一起输出
+class FVulkanTextureStreamer
+{
+public:
+    // 与 MeshletTextured.hlsl 中 MAX_STREAMED_TEXTURES 一致
+    static constexpr uint32_t MAX_TEXTURES = 1024;
+    static constexpr uint32_t MIP_TAIL_SIZE = 64;
+    // 同时进行的驻留调整上限 (每个占一个新图像)
+    static constexpr uint32_t MAX_PENDING_CHANGES = 16;
+    static constexpr uint32_t STATS_INTERVAL = 300;
+    // 与 MeshletTextured.hlsl 一致：反馈值 = 相对图像 mip 0 的级数 + 偏移 (图像只含驻留的 mip，放大时级数为负)，UINT32_MAX 表示未被采样
+    static constexpr uint32_t FEEDBACK_MIP_BIAS = TEXTURE_ASSET_MAX_MIPS;
+
+    // 目录中没有可用的 .ctex 或资源损坏时抛出 std::runtime_error
+    FVulkanTextureStreamer(FVulkanDevice& InDevice, const std::filesystem::path& Directory, const FTextureStreamingConfig& InConfig);
+    ~FVulkanTextureStreamer();
+
+    FVulkanTextureStreamer(const FVulkanTextureStreamer&) = delete;
+    FVulkanTextureStreamer& operator=(const FVulkanTextureStreamer&) = delete;
+
+    uint32_t GetTextureCount() const { return static_cast<uint32_t>(Textures.size()); }
+    VkDescriptorSetLayout GetDescriptorSetLayout() const { return DescriptorSetLayout; }
+    VkDescriptorSet GetDescriptorSet(uint32_t FrameSlot) const { return Frames[FrameSlot].DescriptorSet; }
+    FTextureResidency& GetResidency() { return Residency; }
+    bool IsSamplerFeedbackEnabled() const { return Config.bSamplerFeedback; }
+
+    // 帧槽的 Timeline 值已被等待之后调用：回收旧图像、估计需求、调度、填充本帧的暂存上传并更新本槽描述符
+    // SignalValue: 本帧提交后 Timeline 的信号值；CompletedValue: GPU 当前已完成的值
+    void BeginFrame(uint32_t FrameSlot, const FFramePacket& Packet, uint64_t SignalValue, uint64_t CompletedValue);
+    // 渲染 Pass 之外、绘制之前录制：清空反馈缓冲、暂存 -> 图像、保留 mip 的图像间拷贝与布局转换
+    void RecordUploads(VkCommandBuffer InCommandBuffer, uint32_t FrameSlot);
+    // 渲染 Pass 之后录制：反馈缓冲的写入对 CPU 回读可见
+    void RecordFeedbackBarrier(VkCommandBuffer InCommandBuffer);
+
+private:
+    struct FImage
+    {
+        VkImage Image = VK_NULL_HANDLE;
+        VmaAllocation Allocation = VK_NULL_HANDLE;
+        VkImageView View = VK_NULL_HANDLE;
+        uint32_t TopMip = 0; // 图像的 mip 0 对应资源的第 TopMip 级
+    };
+
+    struct FTexture
+    {
+        FTextureAsset Asset;
+        FImage Current; // 描述符引用的图像
+        FImage Pending; // 进行中调整的新图像
+        // 进行中调整待上传的 mip 范围 [UploadMip, UploadEndMip)，当前 mip 已上传到 UploadRow 行
+        uint32_t UploadMip = 0;
+        uint32_t UploadEndMip = 0;
+        uint32_t UploadRow = 0;
+        uint64_t ChangeStartValue = 0; // 发起调整的帧的 Timeline 值
+
+        explicit FTexture(const std::filesystem::path& Path) : Asset(Path) {}
+    };
+
+    struct FImageUpload
+    {
+        VkImage Image;
+        VkBufferImageCopy Region;
+    };
+
+    struct FCompletedChange
+    {
+        FImage Old;
+        FImage New;
+        const FTextureAsset* Asset;
+    };
+
+    struct FFrameResources
+    {
+        VkBuffer Staging = VK_NULL_HANDLE;
+        VmaAllocation StagingAllocation = VK_NULL_HANDLE;
+        std::byte* StagingMapped = nullptr;
+        VkDeviceSize StagingUsed = 0;
+        VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+        std::vector<bool> DirtyDescriptors; // 按纹理：当前图像变化后本槽尚未改写
+        std::vector<uint32_t> BoundTopMips; // 按纹理：本槽描述符引用的图像的 TopMip，把反馈值换算为资源的 mip
+
+        // 采样反馈：主机可见，GPU 原子写入，本槽下一轮 BeginFrame 回读
+        VkBuffer Feedback = VK_NULL_HANDLE;
+        VmaAllocation FeedbackAllocation = VK_NULL_HANDLE;
+        const uint32_t* FeedbackMapped = nullptr;
+        bool bFeedbackSubmitted = false;
+
+        // 本帧要录制的命令
+        std::vector<VkImage> NewImages;
+        std::vector<FImageUpload> Uploads;
+        std::vector<FCompletedChange> Completions;
+    };
+
+    FImage CreateImage(const FTextureAsset& Asset, uint32_t TopMip) const;
+    void DestroyImage(FImage& InImage) const;
+
+    void CreateSampler();
+    void CreateDescriptors();
+    void CreateFrameResources();
+    void UploadMipTails();
+
+    uint64_t ComputeBudget() const;
+    void CollectRetired(uint64_t CompletedValue, uint64_t NowNs);
+    void RequestVisibleMips(const FFramePacket& Packet);
+    void RequestFeedbackMips(FFrameResources& Frame);
+    void StartChange(FFrameResources& Frame, const FTextureResidencyChange& Change, uint64_t SignalValue);
+    void UploadPending(FFrameResources& Frame, uint64_t SignalValue);
+    void CompletePending(FFrameResources& Frame, uint64_t SignalValue);
+    void WriteDirtyDescriptors(FFrameResources& Frame);
+    void AccumulateStats(uint64_t NowNs);
+
+    FVulkanDevice& DeviceRef;
+    VkDevice LogicalDevice = VK_NULL_HANDLE;
+    VmaAllocator Allocator = VK_NULL_HANDLE;
+    const FTextureStreamingConfig Config;
+
+    VkSampler Sampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool DescriptorPool = VK_NULL_HANDLE;
+    uint32_t MemoryHeapIndex = 0;
+
+    std::vector<FTexture> Textures;
+    FTextureResidency Residency;
+    std::vector<FTextureResidencyChange> Changes;
+    std::vector<uint32_t> PendingTextures; // 按发起顺序，先发起的先上传
+    std::array<FFrameResources, MAX_FRAMES_IN_FLIGHT> Frames;
+
+    // 待回收的旧图像与待确认的延迟样本，都以 Timeline 值为界 (SkipFrame 的空提交也推进 Timeline)
+    std::vector<std::pair<uint64_t, FImage>> RetiredImages;
+    std::vector<std::pair<uint64_t, uint64_t>> PendingLatencies; // (用上新图像的帧的 Timeline 值, 需求开始时刻)
+
+    uint32_t StatsFrameCount = 0;
+    uint64_t StatsBeginNs = 0;
+    uint64_t StatsUploadedBytes = 0;
+    uint32_t StatsStreamedIn = 0;
+    uint32_t StatsEvicted = 0;
+    uint32_t StatsLatencyCount = 0;
+    uint64_t StatsLatencySumNs = 0;
+    uint64_t StatsLatencyMaxNs = 0;
+};
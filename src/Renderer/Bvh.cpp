@@ -0,0 +1,807 @@
+﻿#include "Bvh.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <cfloat>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CA_BVH_SSE 1
+#include <immintrin.h>
+#else
+#define CA_BVH_SSE 0
+#endif
+
+namespace {
+    // 图元数不少于此值的节点把左子树交给其它 Worker 构建
+    constexpr uint32_t PARALLEL_BUILD_THRESHOLD = 4096;
+    // 图元数不少于此值的节点分块并行分箱
+    constexpr uint32_t PARALLEL_BINNING_THRESHOLD = 64 * 1024;
+    constexpr uint32_t BINNING_BLOCK_SIZE = 16 * 1024;
+    // 超过此深度改用中位数切分，保证树深 (以及遍历栈) 有界
+    constexpr uint32_t MEDIAN_SPLIT_DEPTH = 48;
+    constexpr uint32_t TRAVERSAL_STACK_SIZE = 256;
+    // 遍历栈中标记"整棵子树都在视锥内"
+    constexpr uint32_t INSIDE_FLAG = 0x80000000u;
+
+    constexpr FAabb EMPTY_AABB = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+    float GetAxis(const FVector3& V, uint32_t Axis)
+    {
+        return Axis == 0 ? V.X : Axis == 1 ? V.Y : V.Z;
+    }
+
+    void Grow(FAabb& Box, const FAabb& Other)
+    {
+        Box.Min = { std::min(Box.Min.X, Other.Min.X), std::min(Box.Min.Y, Other.Min.Y), std::min(Box.Min.Z, Other.Min.Z) };
+        Box.Max = { std::max(Box.Max.X, Other.Max.X), std::max(Box.Max.Y, Other.Max.Y), std::max(Box.Max.Z, Other.Max.Z) };
+    }
+
+    void Grow(FAabb& Box, const FVector3& Point)
+    {
+        Grow(Box, FAabb{ Point, Point });
+    }
+
+    // 表面积的一半，SAH 只比较相对大小
+    float HalfArea(const FAabb& Box)
+    {
+        const FVector3 Size = Box.Max - Box.Min;
+        return Size.X < 0.0f ? 0.0f : Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X;
+    }
+
+    bool Overlaps(const FAabb& A, const FAabb& B)
+    {
+        return A.Min.X <= B.Max.X && A.Max.X >= B.Min.X && A.Min.Y <= B.Max.Y && A.Max.Y >= B.Min.Y && A.Min.Z <= B.Max.Z && A.Max.Z >= B.Min.Z;
+    }
+
+    // 射线的倒数方向：分量为 0 时取很大的有限值，避免 0 * inf 产生 NaN
+    FVector3 MakeInverseDirection(const FVector3& Direction)
+    {
+        auto Inverse = [](float V) { return V != 0.0f ? 1.0f / V : std::copysign(1e30f, V); };
+        return { Inverse(Direction.X), Inverse(Direction.Y), Inverse(Direction.Z) };
+    }
+
+    // Slab 法：进入距离 (未命中时为 FLT_MAX)
+    float IntersectRay(const FAabb& Box, const FVector3& Origin, const FVector3& InverseDirection, float MaxDistance)
+    {
+        const float X0 = (Box.Min.X - Origin.X) * InverseDirection.X, X1 = (Box.Max.X - Origin.X) * InverseDirection.X;
+        const float Y0 = (Box.Min.Y - Origin.Y) * InverseDirection.Y, Y1 = (Box.Max.Y - Origin.Y) * InverseDirection.Y;
+        const float Z0 = (Box.Min.Z - Origin.Z) * InverseDirection.Z, Z1 = (Box.Max.Z - Origin.Z) * InverseDirection.Z;
+        const float Near = std::max({ std::min(X0, X1), std::min(Y0, Y1), std::min(Z0, Z1), 0.0f });
+        const float Far = std::min({ std::max(X0, X1), std::max(Y0, Y1), std::max(Z0, Z1), MaxDistance });
+        return Near <= Far ? Near : FLT_MAX;
+    }
+
+    void SetLane(FBvhNode& Node, uint32_t Lane, const FAabb& Box)
+    {
+        Node.MinX[Lane] = Box.Min.X;
+        Node.MinY[Lane] = Box.Min.Y;
+        Node.MinZ[Lane] = Box.Min.Z;
+        Node.MaxX[Lane] = Box.Max.X;
+        Node.MaxY[Lane] = Box.Max.Y;
+        Node.MaxZ[Lane] = Box.Max.Z;
+    }
+
+    FAabb GetLane(const FBvhNode& Node, uint32_t Lane)
+    {
+        return { { Node.MinX[Lane], Node.MinY[Lane], Node.MinZ[Lane] }, { Node.MaxX[Lane], Node.MaxY[Lane], Node.MaxZ[Lane] } };
+    }
+
+    // ---------------------------------------------------------------------
+    // 4 个槽一次测试 (返回 4 位掩码)
+    // ---------------------------------------------------------------------
+    // 正顶点 (沿法线最远的角) 在平面外侧即整个盒子在外侧；负顶点在内侧即整个盒子在内侧
+    uint32_t TestFrustumLanes(const FBvhNode& Node, const FFrustum& Frustum, uint32_t& OutInsideMask)
+    {
+#if CA_BVH_SSE
+        __m128 Visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 Inside = Visible;
+        const __m128 Zero = _mm_setzero_ps();
+        for (const FPlane& Plane : Frustum.Planes)
+        {
+            const bool bPositiveX = Plane.Normal.X >= 0.0f, bPositiveY = Plane.Normal.Y >= 0.0f, bPositiveZ = Plane.Normal.Z >= 0.0f;
+            const __m128 NX = _mm_set1_ps(Plane.Normal.X), NY = _mm_set1_ps(Plane.Normal.Y), NZ = _mm_set1_ps(Plane.Normal.Z), D = _mm_set1_ps(Plane.D);
+            const __m128 Far = _mm_add_ps(_mm_add_ps(_mm_mul_ps(NX, _mm_load_ps(bPositiveX ? Node.MaxX : Node.MinX)), _mm_mul_ps(NY, _mm_load_ps(bPositiveY ? Node.MaxY : Node.MinY))),
+                _mm_add_ps(_mm_mul_ps(NZ, _mm_load_ps(bPositiveZ ? Node.MaxZ : Node.MinZ)), D));
+            const __m128 Near = _mm_add_ps(_mm_add_ps(_mm_mul_ps(NX, _mm_load_ps(bPositiveX ? Node.MinX : Node.MaxX)), _mm_mul_ps(NY, _mm_load_ps(bPositiveY ? Node.MinY : Node.MaxY))),
+                _mm_add_ps(_mm_mul_ps(NZ, _mm_load_ps(bPositiveZ ? Node.MinZ : Node.MaxZ)), D));
+            Visible = _mm_and_ps(Visible, _mm_cmpge_ps(Far, Zero));
+            Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Near, Zero));
+        }
+        const uint32_t VisibleMask = static_cast<uint32_t>(_mm_movemask_ps(Visible));
+        OutInsideMask = VisibleMask & static_cast<uint32_t>(_mm_movemask_ps(Inside));
+        return VisibleMask;
+#else
+        uint32_t VisibleMask = 0;
+        OutInsideMask = 0;
+        for (uint32_t Lane = 0; Lane < 4; Lane++)
+        {
+            bool bVisible = true;
+            bool bInside = true;
+            for (const FPlane& Plane : Frustum.Planes)
+            {
+                const bool bPositiveX = Plane.Normal.X >= 0.0f, bPositiveY = Plane.Normal.Y >= 0.0f, bPositiveZ = Plane.Normal.Z >= 0.0f;
+                const FVector3 FarCorner = { bPositiveX ? Node.MaxX[Lane] : Node.MinX[Lane], bPositiveY ? Node.MaxY[Lane] : Node.MinY[Lane], bPositiveZ ? Node.MaxZ[Lane] : Node.MinZ[Lane] };
+                const FVector3 NearCorner = { bPositiveX ? Node.MinX[Lane] : Node.MaxX[Lane], bPositiveY ? Node.MinY[Lane] : Node.MaxY[Lane], bPositiveZ ? Node.MinZ[Lane] : Node.MaxZ[Lane] };
+                bVisible = bVisible && Plane.GetSignedDistance(FarCorner) >= 0.0f;
+                bInside = bInside && Plane.GetSignedDistance(NearCorner) >= 0.0f;
+            }
+            VisibleMask |= bVisible ? 1u << Lane : 0u;
+            OutInsideMask |= bVisible && bInside ? 1u << Lane : 0u;
+        }
+        return VisibleMask;
+#endif
+    }
+
+    uint32_t TestAabbLanes(const FBvhNode& Node, const FAabb& Box)
+    {
+#if CA_BVH_SSE
+        __m128 Overlap = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(Node.MinX), _mm_set1_ps(Box.Max.X)), _mm_cmpge_ps(_mm_load_ps(Node.MaxX), _mm_set1_ps(Box.Min.X)));
+        Overlap = _mm_and_ps(Overlap, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(Node.MinY), _mm_set1_ps(Box.Max.Y)), _mm_cmpge_ps(_mm_load_ps(Node.MaxY), _mm_set1_ps(Box.Min.Y))));
+        Overlap = _mm_and_ps(Overlap, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(Node.MinZ), _mm_set1_ps(Box.Max.Z)), _mm_cmpge_ps(_mm_load_ps(Node.MaxZ), _mm_set1_ps(Box.Min.Z))));
+        return static_cast<uint32_t>(_mm_movemask_ps(Overlap));
+#else
+        uint32_t Mask = 0;
+        for (uint32_t Lane = 0; Lane < 4; Lane++)
+        {
+            Mask |= Overlaps(GetLane(Node, Lane), Box) ? 1u << Lane : 0u;
+        }
+        return Mask;
+#endif
+    }
+
+    // 方向为正的轴进入面是 Min，为负的是 Max，按符号选数组即可免去逐槽的 min / max
+    uint32_t TestRayLanes(const FBvhNode& Node, const FVector3& Origin, const FVector3& InverseDirection, float MaxDistance, float (&OutNear)[4])
+    {
+#if CA_BVH_SSE
+        const bool bPositiveX = InverseDirection.X >= 0.0f, bPositiveY = InverseDirection.Y >= 0.0f, bPositiveZ = InverseDirection.Z >= 0.0f;
+        const __m128 OX = _mm_set1_ps(Origin.X), OY = _mm_set1_ps(Origin.Y), OZ = _mm_set1_ps(Origin.Z);
+        const __m128 IX = _mm_set1_ps(InverseDirection.X), IY = _mm_set1_ps(InverseDirection.Y), IZ = _mm_set1_ps(InverseDirection.Z);
+        const __m128 NearX = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bPositiveX ? Node.MinX : Node.MaxX), OX), IX);
+        const __m128 NearY = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bPositiveY ? Node.MinY : Node.MaxY), OY), IY);
+        const __m128 NearZ = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bPositiveZ ? Node.MinZ : Node.MaxZ), OZ), IZ);
+        const __m128 FarX = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bPositiveX ? Node.MaxX : Node.MinX), OX), IX);
+        const __m128 FarY = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bPositiveY ? Node.MaxY : Node.MinY), OY), IY);
+        const __m128 FarZ = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(bPositiveZ ? Node.MaxZ : Node.MinZ), OZ), IZ);
+        const __m128 Near = _mm_max_ps(_mm_max_ps(NearX, NearY), _mm_max_ps(NearZ, _mm_setzero_ps()));
+        const __m128 Far = _mm_min_ps(_mm_min_ps(FarX, FarY), _mm_min_ps(FarZ, _mm_set1_ps(MaxDistance)));
+        _mm_storeu_ps(OutNear, Near);
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(Near, Far)));
+#else
+        uint32_t Mask = 0;
+        for (uint32_t Lane = 0; Lane < 4; Lane++)
+        {
+            OutNear[Lane] = IntersectRay(GetLane(Node, Lane), Origin, InverseDirection, MaxDistance);
+            Mask |= OutNear[Lane] != FLT_MAX ? 1u << Lane : 0u;
+        }
+        return Mask;
+#endif
+    }
+
+    // ---------------------------------------------------------------------
+    // 二叉 SAH 构建
+    // ---------------------------------------------------------------------
+    // 构建时按节点区间原地划分的图元记录：连续读写，不经序号间接访问
+    struct FBuildPrimitive
+    {
+        FAabb Bounds;
+        uint32_t Index;
+    };
+
+    struct FBuildNode
+    {
+        FAabb Bounds;
+        uint32_t Left = FBvh::INVALID_INDEX;   // 右子节点紧随其后；叶子为 INVALID_INDEX
+        uint32_t First = 0;
+        uint32_t Count = 0;
+    };
+
+    struct FBin
+    {
+        FAabb Bounds = EMPTY_AABB;
+        FAabb CentroidBounds = EMPTY_AABB;
+        uint32_t Count = 0;
+    };
+
+    struct FBinning
+    {
+        FBin Bins[FBvh::BIN_COUNT];
+
+        void Merge(const FBinning& Other)
+        {
+            for (uint32_t i = 0; i < FBvh::BIN_COUNT; i++)
+            {
+                Grow(Bins[i].Bounds, Other.Bins[i].Bounds);
+                Grow(Bins[i].CentroidBounds, Other.Bins[i].CentroidBounds);
+                Bins[i].Count += Other.Bins[i].Count;
+            }
+        }
+    };
+
+    // 分箱与划分必须用同一个表达式，保证图元落在同一侧
+    uint32_t ComputeBin(float Centroid, float Min, float Scale)
+    {
+        return std::min(static_cast<uint32_t>((Centroid - Min) * Scale), FBvh::BIN_COUNT - 1);
+    }
+
+    struct FSplit
+    {
+        uint32_t Axis = 0;
+        uint32_t Bin = 0;   // 箱 [0, Bin] 在左侧
+        FAabb LeftBounds = EMPTY_AABB, RightBounds = EMPTY_AABB;
+        FAabb LeftCentroids = EMPTY_AABB, RightCentroids = EMPTY_AABB;
+    };
+}
+
+struct FBvhBuildContext
+{
+    std::vector<FBuildPrimitive> Primitives;
+    std::vector<FBuildNode> Nodes;
+    std::atomic<uint32_t> NodeCount = 1;
+    FJobSystem& Jobs;
+
+    explicit FBvhBuildContext(FJobSystem& InJobs)
+        : Jobs(InJobs)
+    {
+    }
+
+    void BinRange(uint32_t Begin, uint32_t End, uint32_t Axis, float Min, float Scale, FBinning& OutBinning) const
+    {
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            const FBuildPrimitive& Primitive = Primitives[i];
+            const FVector3 Centroid = Primitive.Bounds.GetCenter();
+            FBin& Bin = OutBinning.Bins[ComputeBin(GetAxis(Centroid, Axis), Min, Scale)];
+            Grow(Bin.Bounds, Primitive.Bounds);
+            Grow(Bin.CentroidBounds, Centroid);
+            Bin.Count++;
+        }
+    }
+
+    // 只在质心范围最大的轴上分箱 (Wald 2007)，扫描箱边界取 SAH 代价最小的切分；质心全部重合时失败
+    bool FindSahSplit(uint32_t Begin, uint32_t End, const FAabb& CentroidBounds, FSplit& OutSplit, uint32_t& OutMid)
+    {
+        const FVector3 Extent = CentroidBounds.Max - CentroidBounds.Min;
+        const uint32_t Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : Extent.Y >= Extent.Z ? 1 : 2;
+        const float AxisExtent = GetAxis(Extent, Axis);
+        if (!(AxisExtent > 0.0f))
+        {
+            return false;
+        }
+        const float Min = GetAxis(CentroidBounds.Min, Axis);
+        const float Scale = static_cast<float>(FBvh::BIN_COUNT) / AxisExtent;
+
+        FBinning Binning;
+        const uint32_t Count = End - Begin;
+        if (Count >= PARALLEL_BINNING_THRESHOLD)
+        {
+            const uint32_t BlockCount = (Count + BINNING_BLOCK_SIZE - 1) / BINNING_BLOCK_SIZE;
+            std::vector<FBinning> Blocks(BlockCount);
+            Jobs.ParallelFor(BlockCount, [this, &Blocks, Begin, End, Axis, Min, Scale](uint32_t BlockBegin, uint32_t BlockEnd)
+                {
+                    for (uint32_t Block = BlockBegin; Block < BlockEnd; Block++)
+                    {
+                        const uint32_t First = Begin + Block * BINNING_BLOCK_SIZE;
+                        BinRange(First, std::min(First + BINNING_BLOCK_SIZE, End), Axis, Min, Scale, Blocks[Block]);
+                    }
+                });
+            for (const FBinning& Block : Blocks)
+            {
+                Binning.Merge(Block);
+            }
+        }
+        else
+        {
+            BinRange(Begin, End, Axis, Min, Scale, Binning);
+        }
+
+        // 从右向左累积右侧的面积 x 图元数，再从左向右找代价最小的边界
+        const FBin (&Bins)[FBvh::BIN_COUNT] = Binning.Bins;
+        float RightCosts[FBvh::BIN_COUNT] = {};
+        FAabb RightBounds = EMPTY_AABB;
+        uint32_t RightCount = 0;
+        for (uint32_t i = FBvh::BIN_COUNT - 1; i > 0; i--)
+        {
+            Grow(RightBounds, Bins[i].Bounds);
+            RightCount += Bins[i].Count;
+            RightCosts[i] = HalfArea(RightBounds) * static_cast<float>(RightCount);
+        }
+
+        float BestCost = FLT_MAX;
+        FAabb LeftBounds = EMPTY_AABB;
+        uint32_t LeftCount = 0;
+        for (uint32_t i = 0; i + 1 < FBvh::BIN_COUNT; i++)
+        {
+            Grow(LeftBounds, Bins[i].Bounds);
+            LeftCount += Bins[i].Count;
+            if (LeftCount == 0 || LeftCount == Count)
+            {
+                continue;
+            }
+
+            const float Cost = HalfArea(LeftBounds) * static_cast<float>(LeftCount) + RightCosts[i + 1];
+            if (Cost < BestCost)
+            {
+                BestCost = Cost;
+                OutSplit.Bin = i;
+            }
+        }
+        if (BestCost == FLT_MAX)
+        {
+            return false;
+        }
+
+        OutSplit.Axis = Axis;
+        for (uint32_t i = 0; i < FBvh::BIN_COUNT; i++)
+        {
+            Grow(i <= OutSplit.Bin ? OutSplit.LeftBounds : OutSplit.RightBounds, Bins[i].Bounds);
+            Grow(i <= OutSplit.Bin ? OutSplit.LeftCentroids : OutSplit.RightCentroids, Bins[i].CentroidBounds);
+        }
+
+        const uint32_t SplitBin = OutSplit.Bin;
+        const auto MidIt = std::partition(Primitives.begin() + Begin, Primitives.begin() + End, [Axis, Min, Scale, SplitBin](const FBuildPrimitive& Primitive)
+            {
+                return ComputeBin(GetAxis(Primitive.Bounds.GetCenter(), Axis), Min, Scale) <= SplitBin;
+            });
+        OutMid = static_cast<uint32_t>(MidIt - Primitives.begin());
+        return true;
+    }
+
+    // 沿质心范围最大的轴取中位数
+    uint32_t MedianSplit(uint32_t Begin, uint32_t End, const FAabb& CentroidBounds, FSplit& OutSplit)
+    {
+        const FVector3 Extent = CentroidBounds.Max - CentroidBounds.Min;
+        const uint32_t Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : Extent.Y >= Extent.Z ? 1 : 2;
+        const uint32_t Mid = (Begin + End) / 2;
+        std::nth_element(Primitives.begin() + Begin, Primitives.begin() + Mid, Primitives.begin() + End, [Axis](const FBuildPrimitive& A, const FBuildPrimitive& B)
+            {
+                return GetAxis(A.Bounds.GetCenter(), Axis) < GetAxis(B.Bounds.GetCenter(), Axis);
+            });
+
+        for (uint32_t i = Begin; i < End; i++)
+        {
+            Grow(i < Mid ? OutSplit.LeftBounds : OutSplit.RightBounds, Primitives[i].Bounds);
+            Grow(i < Mid ? OutSplit.LeftCentroids : OutSplit.RightCentroids, Primitives[i].Bounds.GetCenter());
+        }
+        return Mid;
+    }
+
+    // Nodes[NodeIndex].Bounds 已由调用方填好
+    void BuildNode(uint32_t NodeIndex, uint32_t Begin, uint32_t End, FAabb CentroidBounds, uint32_t NodeDepth)
+    {
+        const uint32_t Count = End - Begin;
+        if (Count <= FBvh::MAX_LEAF_SIZE)
+        {
+            Nodes[NodeIndex].First = Begin;
+            Nodes[NodeIndex].Count = Count;
+            return;
+        }
+
+        FSplit Split;
+        uint32_t Mid = 0;
+        if (NodeDepth >= MEDIAN_SPLIT_DEPTH || !FindSahSplit(Begin, End, CentroidBounds, Split, Mid))
+        {
+            Split = FSplit();
+            Mid = MedianSplit(Begin, End, CentroidBounds, Split);
+        }
+
+        const uint32_t Left = NodeCount.fetch_add(2, std::memory_order_relaxed);
+        Nodes[NodeIndex].Left = Left;
+        Nodes[Left].Bounds = Split.LeftBounds;
+        Nodes[Left + 1].Bounds = Split.RightBounds;
+
+        if (Count >= PARALLEL_BUILD_THRESHOLD)
+        {
+            FJobCounter Counter;
+            const FAabb LeftCentroids = Split.LeftCentroids;
+            Jobs.Schedule([this, Left, Begin, Mid, &LeftCentroids, NodeDepth]()
+                {
+                    BuildNode(Left, Begin, Mid, LeftCentroids, NodeDepth + 1);
+                }, &Counter);
+            BuildNode(Left + 1, Mid, End, Split.RightCentroids, NodeDepth + 1);
+            Jobs.Wait(Counter);
+        }
+        else
+        {
+            BuildNode(Left, Begin, Mid, Split.LeftCentroids, NodeDepth + 1);
+            BuildNode(Left + 1, Mid, End, Split.RightCentroids, NodeDepth + 1);
+        }
+    }
+};
+
+void FBvh::Build(std::span<const FAabb> Bounds, FJobSystem& Jobs)
+{
+    const uint32_t Count = static_cast<uint32_t>(Bounds.size());
+    Nodes.clear();
+    NodeParents.clear();
+    NodeParentLanes.clear();
+    PrimitiveBounds.resize(Count);
+    PrimitiveIndices.resize(Count);
+    PrimitiveSlots.resize(Count);
+    PrimitiveLeafNodes.assign(Count, INVALID_INDEX);
+    PrimitiveLeafLanes.assign(Count, 0);
+    Depth = 0;
+    if (Count == 0)
+    {
+        return;
+    }
+
+    // 1. 图元记录与根的包围盒
+    FBvhBuildContext Context(Jobs);
+    Context.Primitives.resize(Count);
+    Context.Nodes.resize(2 * Count - 1);
+    FAabb RootBounds = EMPTY_AABB;
+    FAabb RootCentroids = EMPTY_AABB;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        Context.Primitives[i] = { Bounds[i], i };
+        Grow(RootBounds, Bounds[i]);
+        Grow(RootCentroids, Bounds[i].GetCenter());
+    }
+
+    // 2. 二叉 SAH 树，之后图元记录已按叶子排好
+    Context.Nodes[0].Bounds = RootBounds;
+    Context.BuildNode(0, 0, Count, RootCentroids, 0);
+    for (uint32_t Slot = 0; Slot < Count; Slot++)
+    {
+        const FBuildPrimitive& Primitive = Context.Primitives[Slot];
+        PrimitiveIndices[Slot] = Primitive.Index;
+        PrimitiveBounds[Slot] = Primitive.Bounds;
+        PrimitiveSlots[Primitive.Index] = Slot;
+    }
+
+    // 3. 压成 4 叉树
+    Nodes.reserve(Context.NodeCount / 2 + 1);
+    CollapseNode(Context, 0, 1);
+    NodeParents.assign(Nodes.size(), INVALID_INDEX);
+    NodeParentLanes.assign(Nodes.size(), 0);
+    for (uint32_t Node = 0; Node < Nodes.size(); Node++)
+    {
+        for (uint32_t Lane = 0; Lane < 4; Lane++)
+        {
+            const uint32_t Child = Nodes[Node].Children[Lane];
+            if (Nodes[Node].Counts[Lane] > 0)
+            {
+                for (uint32_t i = 0; i < Nodes[Node].Counts[Lane]; i++)
+                {
+                    PrimitiveLeafNodes[PrimitiveIndices[Child + i]] = Node;
+                    PrimitiveLeafLanes[PrimitiveIndices[Child + i]] = static_cast<uint8_t>(Lane);
+                }
+            }
+            else if (Child != INVALID_INDEX)
+            {
+                NodeParents[Child] = Node;
+                NodeParentLanes[Child] = static_cast<uint8_t>(Lane);
+            }
+        }
+    }
+    RefitMarks.assign(Nodes.size(), 0);
+}
+
+uint32_t FBvh::CollapseNode(const FBvhBuildContext& Context, uint32_t BinaryNode, uint32_t NodeDepth)
+{
+    // 从二叉节点的两个子节点开始，反复展开表面积最大的内部子节点，直到凑满 4 个
+    uint32_t Lanes[4] = { BinaryNode, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX };
+    uint32_t LaneCount = 1;
+    if (Context.Nodes[BinaryNode].Left != INVALID_INDEX)
+    {
+        Lanes[0] = Context.Nodes[BinaryNode].Left;
+        Lanes[1] = Lanes[0] + 1;
+        LaneCount = 2;
+    }
+    while (LaneCount < 4)
+    {
+        uint32_t Largest = INVALID_INDEX;
+        float LargestArea = -1.0f;
+        for (uint32_t i = 0; i < LaneCount; i++)
+        {
+            const FBuildNode& Candidate = Context.Nodes[Lanes[i]];
+            if (Candidate.Left != INVALID_INDEX && HalfArea(Candidate.Bounds) > LargestArea)
+            {
+                Largest = i;
+                LargestArea = HalfArea(Candidate.Bounds);
+            }
+        }
+        if (Largest == INVALID_INDEX)
+        {
+            break;
+        }
+
+        const uint32_t Left = Context.Nodes[Lanes[Largest]].Left;
+        Lanes[Largest] = Left;
+        Lanes[LaneCount++] = Left + 1;
+    }
+
+    // 先占住序号再递归：先序编号，父节点序号小于子节点
+    const uint32_t NodeIndex = static_cast<uint32_t>(Nodes.size());
+    Nodes.emplace_back();
+    Depth = std::max(Depth, NodeDepth);
+    for (uint32_t Lane = 0; Lane < 4; Lane++)
+    {
+        FBvhNode& Node = Nodes[NodeIndex];
+        if (Lane >= LaneCount)
+        {
+            SetLane(Node, Lane, EMPTY_AABB);
+            Node.Children[Lane] = INVALID_INDEX;
+            Node.Counts[Lane] = 0;
+            continue;
+        }
+
+        const FBuildNode& Child = Context.Nodes[Lanes[Lane]];
+        SetLane(Node, Lane, Child.Bounds);
+        if (Child.Left == INVALID_INDEX)
+        {
+            Node.Children[Lane] = Child.First;
+            Node.Counts[Lane] = Child.Count;
+        }
+        else
+        {
+            Node.Counts[Lane] = 0;
+            const uint32_t ChildIndex = CollapseNode(Context, Lanes[Lane], NodeDepth + 1);
+            Nodes[NodeIndex].Children[Lane] = ChildIndex;
+        }
+    }
+    return NodeIndex;
+}
+
+void FBvh::RefitLane(uint32_t Node, uint32_t Lane)
+{
+    FBvhNode& Target = Nodes[Node];
+    FAabb Box = EMPTY_AABB;
+    for (uint32_t i = 0; i < Target.Counts[Lane]; i++)
+    {
+        Grow(Box, PrimitiveBounds[Target.Children[Lane] + i]);
+    }
+    SetLane(Target, Lane, Box);
+}
+
+bool FBvh::PropagateToParent(uint32_t Node)
+{
+    const uint32_t Parent = NodeParents[Node];
+    if (Parent == INVALID_INDEX)
+    {
+        return false;
+    }
+
+    FAabb Box = EMPTY_AABB;
+    for (uint32_t Lane = 0; Lane < 4; Lane++)
+    {
+        Grow(Box, GetLane(Nodes[Node], Lane));
+    }
+
+    const uint32_t ParentLane = NodeParentLanes[Node];
+    const FAabb Previous = GetLane(Nodes[Parent], ParentLane);
+    if (Previous.Min.X == Box.Min.X && Previous.Min.Y == Box.Min.Y && Previous.Min.Z == Box.Min.Z &&
+        Previous.Max.X == Box.Max.X && Previous.Max.Y == Box.Max.Y && Previous.Max.Z == Box.Max.Z)
+    {
+        return false;
+    }
+    SetLane(Nodes[Parent], ParentLane, Box);
+    return true;
+}
+
+void FBvh::Refit(std::span<const FAabb> Bounds)
+{
+    check(Bounds.size() == PrimitiveBounds.size());
+    for (uint32_t Slot = 0; Slot < GetPrimitiveCount(); Slot++)
+    {
+        PrimitiveBounds[Slot] = Bounds[PrimitiveIndices[Slot]];
+    }
+
+    // 子节点序号总比父节点大，倒序遍历即自底向上
+    for (uint32_t Node = GetNodeCount(); Node-- > 0;)
+    {
+        for (uint32_t Lane = 0; Lane < 4; Lane++)
+        {
+            if (Nodes[Node].Counts[Lane] > 0)
+            {
+                RefitLane(Node, Lane);
+            }
+        }
+        PropagateToParent(Node);
+    }
+}
+
+void FBvh::Refit(std::span<const FAabb> Bounds, std::span<const uint32_t> Moved)
+{
+    check(Bounds.size() == PrimitiveBounds.size());
+    for (uint32_t Primitive : Moved)
+    {
+        PrimitiveBounds[PrimitiveSlots[Primitive]] = Bounds[Primitive];
+    }
+
+    // 1. 重算移动图元所在的叶子槽，叶子所在节点入堆
+    RefitHeap.clear();
+    for (uint32_t Primitive : Moved)
+    {
+        const uint32_t Node = PrimitiveLeafNodes[Primitive];
+        RefitLane(Node, PrimitiveLeafLanes[Primitive]);
+        if (!RefitMarks[Node])
+        {
+            RefitMarks[Node] = 1;
+            RefitHeap.push_back(Node);
+        }
+    }
+
+    // 2. 按节点序号从大到小 (自底向上) 处理：子节点都处理完才轮到父节点，父节点的槽没变就不再向上
+    std::make_heap(RefitHeap.begin(), RefitHeap.end());
+    while (!RefitHeap.empty())
+    {
+        std::pop_heap(RefitHeap.begin(), RefitHeap.end());
+        const uint32_t Node = RefitHeap.back();
+        RefitHeap.pop_back();
+        RefitMarks[Node] = 0;
+
+        if (PropagateToParent(Node))
+        {
+            const uint32_t Parent = NodeParents[Node];
+            if (!RefitMarks[Parent])
+            {
+                RefitMarks[Parent] = 1;
+                RefitHeap.push_back(Parent);
+                std::push_heap(RefitHeap.begin(), RefitHeap.end());
+            }
+        }
+    }
+}
+
+void FBvh::QueryFrustum(const FFrustum& Frustum, std::vector<uint32_t>& OutPrimitives) const
+{
+    if (Nodes.empty())
+    {
+        return;
+    }
+
+    uint32_t Stack[TRAVERSAL_STACK_SIZE];
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = 0;
+    while (StackSize > 0)
+    {
+        const uint32_t Entry = Stack[--StackSize];
+        const FBvhNode& Node = Nodes[Entry & ~INSIDE_FLAG];
+
+        uint32_t InsideMask = 0;
+        const uint32_t VisibleMask = (Entry & INSIDE_FLAG) ? 0xF : TestFrustumLanes(Node, Frustum, InsideMask);
+        InsideMask = (Entry & INSIDE_FLAG) ? 0xF : InsideMask;
+        for (uint32_t Mask = VisibleMask; Mask != 0; Mask &= Mask - 1)
+        {
+            const uint32_t Lane = static_cast<uint32_t>(std::countr_zero(Mask));
+            const bool bInside = (InsideMask >> Lane) & 1;
+            if (Node.Counts[Lane] == 0)
+            {
+                if (Node.Children[Lane] != INVALID_INDEX)
+                {
+                    check(StackSize < TRAVERSAL_STACK_SIZE);
+                    Stack[StackSize++] = Node.Children[Lane] | (bInside ? INSIDE_FLAG : 0);
+                }
+                continue;
+            }
+
+            for (uint32_t i = 0; i < Node.Counts[Lane]; i++)
+            {
+                const uint32_t Slot = Node.Children[Lane] + i;
+                if (bInside || Frustum.Intersects(PrimitiveBounds[Slot]))
+                {
+                    OutPrimitives.push_back(PrimitiveIndices[Slot]);
+                }
+            }
+        }
+    }
+}
+
+void FBvh::QueryAabb(const FAabb& Box, std::vector<uint32_t>& OutPrimitives) const
+{
+    if (Nodes.empty())
+    {
+        return;
+    }
+
+    uint32_t Stack[TRAVERSAL_STACK_SIZE];
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = 0;
+    while (StackSize > 0)
+    {
+        const FBvhNode& Node = Nodes[Stack[--StackSize]];
+        for (uint32_t Mask = TestAabbLanes(Node, Box); Mask != 0; Mask &= Mask - 1)
+        {
+            const uint32_t Lane = static_cast<uint32_t>(std::countr_zero(Mask));
+            if (Node.Counts[Lane] == 0)
+            {
+                check(StackSize < TRAVERSAL_STACK_SIZE);
+                Stack[StackSize++] = Node.Children[Lane];
+                continue;
+            }
+
+            for (uint32_t i = 0; i < Node.Counts[Lane]; i++)
+            {
+                const uint32_t Slot = Node.Children[Lane] + i;
+                if (Overlaps(PrimitiveBounds[Slot], Box))
+                {
+                    OutPrimitives.push_back(PrimitiveIndices[Slot]);
+                }
+            }
+        }
+    }
+}
+
+uint32_t FBvh::RayCast(const FVector3& Origin, const FVector3& Direction, float& InOutDistance) const
+{
+    if (Nodes.empty())
+    {
+        return INVALID_INDEX;
+    }
+
+    struct FStackEntry
+    {
+        uint32_t Node;
+        float Distance;
+    };
+    FStackEntry Stack[TRAVERSAL_STACK_SIZE];
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = { 0, 0.0f };
+
+    const FVector3 InverseDirection = MakeInverseDirection(Direction);
+    uint32_t BestPrimitive = INVALID_INDEX;
+    float BestDistance = InOutDistance;
+    while (StackSize > 0)
+    {
+        const FStackEntry Entry = Stack[--StackSize];
+        if (Entry.Distance > BestDistance)
+        {
+            continue;
+        }
+
+        // 命中的槽按进入距离由近到远处理：叶子立即求交，内部节点逆序入栈使最近的先出栈
+        const FBvhNode& Node = Nodes[Entry.Node];
+        float Near[4];
+        uint32_t Order[4];
+        uint32_t HitCount = 0;
+        for (uint32_t Mask = TestRayLanes(Node, Origin, InverseDirection, BestDistance, Near); Mask != 0; Mask &= Mask - 1)
+        {
+            const uint32_t Lane = static_cast<uint32_t>(std::countr_zero(Mask));
+            uint32_t Slot = HitCount++;
+            for (; Slot > 0 && Near[Order[Slot - 1]] > Near[Lane]; Slot--)
+            {
+                Order[Slot] = Order[Slot - 1];
+            }
+            Order[Slot] = Lane;
+        }
+
+        uint32_t Internal[4];
+        uint32_t InternalCount = 0;
+        for (uint32_t i = 0; i < HitCount; i++)
+        {
+            const uint32_t Lane = Order[i];
+            if (Near[Lane] > BestDistance)
+            {
+                break;
+            }
+            if (Node.Counts[Lane] == 0)
+            {
+                Internal[InternalCount++] = Lane;
+                continue;
+            }
+
+            for (uint32_t j = 0; j < Node.Counts[Lane]; j++)
+            {
+                const uint32_t Slot = Node.Children[Lane] + j;
+                const float Distance = IntersectRay(PrimitiveBounds[Slot], Origin, InverseDirection, BestDistance);
+                if (Distance != FLT_MAX && (Distance < BestDistance || BestPrimitive == INVALID_INDEX))
+                {
+                    BestDistance = Distance;
+                    BestPrimitive = PrimitiveIndices[Slot];
+                }
+            }
+        }
+        for (uint32_t i = InternalCount; i-- > 0;)
+        {
+            check(StackSize < TRAVERSAL_STACK_SIZE);
+            Stack[StackSize++] = { Node.Children[Internal[i]], Near[Internal[i]] };
+        }
+    }
+
+    if (BestPrimitive != INVALID_INDEX)
+    {
+        InOutDistance = BestDistance;
+    }
+    return BestPrimitive;
+}
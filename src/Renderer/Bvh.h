@@ -0,0 +1,74 @@
+﻿#pragma once
+#include "MathTypes.h"
+
+class FJobSystem;
+struct FBvhBuildContext;
+
+// 4 叉 BVH 节点：4 个子节点的包围盒按分量 SoA 排列，一次 SSE 运算测试全部 4 个 (128 字节，两条缓存行)
+struct alignas(16) FBvhNode
+{
+    float MinX[4];
+    float MinY[4];
+    float MinZ[4];
+    float MaxX[4];
+    float MaxY[4];
+    float MaxZ[4];
+    // Counts 为 0 时 Children 是子节点序号 (空槽为 INVALID_INDEX，包围盒为反向的空盒)；
+    // 否则该槽是叶子，Children 是首个图元在图元序号表中的位置
+    uint32_t Children[4];
+    uint32_t Counts[4];
+};
+static_assert(sizeof(FBvhNode) == 128);
+
+// 场景实例的包围体层级 (拾取、光源分配、粗粒度遮挡等空间查询的加速结构)
+// - 构建：二叉 SAH 分箱 (沿质心范围最大的轴分 BIN_COUNT 个箱)，大节点的分箱与左右子树都经 Job 系统并行，
+//   深度过深或质心重合时退化为中位数切分；之后按表面积逐个展开，压成 4 叉节点，节点按先序编号 (父节点序号小于子节点)
+// - Refit：拓扑不变，只重算包围盒；增量版本只沿移动过的图元所在叶子到根的路径向上，盒子不变时提前停止。
+//   物体移动很多之后树的质量下降，应重新 Build
+// - 查询结果都是调用方传入的图元序号；求交对象是图元的包围盒
+// Build / Refit 与查询不能同时进行；查询之间可以并发
+class FBvh
+{
+public:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    static constexpr uint32_t BIN_COUNT = 16;
+    static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+    void Build(std::span<const FAabb> Bounds, FJobSystem& Jobs);
+
+    // 全部图元的包围盒都可能改变
+    void Refit(std::span<const FAabb> Bounds);
+    // 只有 Moved 中的图元改变 (Bounds 仍按图元序号索引，长度与 Build 时一致)
+    void Refit(std::span<const FAabb> Bounds, std::span<const uint32_t> Moved);
+
+    // 追加包围盒与视锥相交的图元；完全在视锥内的子树不再逐个测试
+    void QueryFrustum(const FFrustum& Frustum, std::vector<uint32_t>& OutPrimitives) const;
+    // 追加包围盒与 Box 重叠的图元
+    void QueryAabb(const FAabb& Box, std::vector<uint32_t>& OutPrimitives) const;
+    // 射线 Origin + t * Direction (t 属于 [0, InOutDistance]) 最近命中的图元，InOutDistance 返回命中距离；未命中返回 INVALID_INDEX
+    uint32_t RayCast(const FVector3& Origin, const FVector3& Direction, float& InOutDistance) const;
+
+    uint32_t GetPrimitiveCount() const { return static_cast<uint32_t>(PrimitiveBounds.size()); }
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(Nodes.size()); }
+    uint32_t GetDepth() const { return Depth; }
+
+private:
+    uint32_t CollapseNode(const FBvhBuildContext& Context, uint32_t BinaryNode, uint32_t NodeDepth);
+    void RefitLane(uint32_t Node, uint32_t Lane);
+    // 节点 4 个槽的并集写入父节点对应的槽，返回父节点的槽是否改变
+    bool PropagateToParent(uint32_t Node);
+
+    std::vector<FBvhNode> Nodes;
+    std::vector<uint32_t> NodeParents;      // 根为 INVALID_INDEX
+    std::vector<uint8_t> NodeParentLanes;
+    // 以下两个按叶子顺序 (槽位)：每个叶子引用其中一段连续区间，遍历时顺序读取
+    std::vector<uint32_t> PrimitiveIndices;
+    std::vector<FAabb> PrimitiveBounds;
+    // 以下按图元序号
+    std::vector<uint32_t> PrimitiveSlots;
+    std::vector<uint32_t> PrimitiveLeafNodes;
+    std::vector<uint8_t> PrimitiveLeafLanes;
+    std::vector<uint8_t> RefitMarks;        // 增量 Refit 的暂存：节点是否已在待处理堆中
+    std::vector<uint32_t> RefitHeap;
+    uint32_t Depth = 0;
+};
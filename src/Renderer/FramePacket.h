@@ -0,0 +1,92 @@
+﻿#pragma once
+#include "MathTypes.h"
+#include "FrameArena.h"
+
+// 单次绘制的 Push Constant，布局与 Triangle.hlsl 中 FDrawConstants 一致
+struct FDrawConstants
+{
+    FMatrix4 WorldViewProjection;
+    FVector4 Color;
+};
+static_assert(sizeof(FDrawConstants) <= 128, "Push constants must fit the guaranteed 128 bytes");
+
+// Update 阶段写入的实例快照
+struct FInstanceState
+{
+    FMatrix4 World;
+    FSphere Bounds;
+    FVector4 Color;
+};
+
+// Update 阶段写入的点光源 (世界空间)；RHI 阶段变换到观察空间后按同一布局上传，与 ClusteredLighting.hlsli 中 FGpuLight 一致
+struct FPointLight
+{
+    FVector3 Position;
+    float Radius = 0.0f;    // 影响半径，衰减在这里降到 0
+    FVector3 Color;
+    float Intensity = 0.0f;
+};
+
+// 帧包：一帧数据依次流经 Update -> RenderPrep -> RHI 三个阶段，同一时刻只属于一个阶段
+// 包在帧流水线中循环复用；帧内临时数据全部分配自包自带的帧内存池，帧槽回收时整体丢弃，不经过 malloc
+struct FFramePacket
+{
+    // 必须最先声明：下面的容器构造时引用它
+    FFrameArena Arena;
+
+    uint64_t FrameNumber = 0;
+    uint64_t FrameStartNs = 0;      // Update 开始 (输入采样) 时刻，延迟统计的起点
+    float DeltaSeconds = 0.0f;
+    uint32_t ViewportWidth = 0;
+    uint32_t ViewportHeight = 0;
+
+    // Update 阶段产物
+    FMatrix4 View;
+    TFrameVector<FInstanceState> Instances{ Arena.GetResource() };
+    // 包围球的 SoA 副本，与 Instances 一一对应：CPU 视锥剔除按 8 个一组连续读取
+    TFrameVector<float> BoundsX{ Arena.GetResource() };
+    TFrameVector<float> BoundsY{ Arena.GetResource() };
+    TFrameVector<float> BoundsZ{ Arena.GetResource() };
+    TFrameVector<float> BoundsRadius{ Arena.GetResource() };
+    // 遮挡体的世界空间三角形 (每 3 个顶点一个)，CPU 软件遮挡剔除的输入
+    TFrameVector<FVector3> OccluderVertices{ Arena.GetResource() };
+    TFrameVector<FPointLight> Lights{ Arena.GetResource() };
+
+    // RenderPrep 阶段产物：剔除后按深度由近到远排序
+    FMatrix4 Projection;
+    FMatrix4 ViewProjection;
+    TFrameVector<uint32_t> VisibleInstances{ Arena.GetResource() }; // 视锥剔除后的实例序号 (升序)
+    TFrameVector<uint64_t> SortKeys{ Arena.GetResource() }; // 每个可见实例一个：高 32 位深度，低 32 位实例序号
+    TFrameVector<FDrawConstants> Draws{ Arena.GetResource() };
+    // 每个实例选中的 LOD 级别 (按实例序号，网格没有 LOD 链时为空)：GPU 剔除时全部实例都选，CPU 剔除时只选可见的
+    TFrameVector<uint8_t> InstanceLods{ Arena.GetResource() };
+    bool bCpuCulled = false;            // VisibleInstances / SortKeys 有效，RHI 阶段只需处理可见实例
+    uint32_t CulledCount = 0;           // 视锥剔除
+    uint32_t OcclusionCulledCount = 0;  // 遮挡剔除 (GPU 剔除为 Hi-Z，CPU 剔除为软件光栅化)
+    uint32_t ClusterCount = 0;          // 参与剔除的簇 (仅网格簇渲染)
+    uint32_t ClusterCulledCount = 0;    // 视锥 + 法线锥剔除的簇
+    uint32_t TriangleCount = 0;         // 可见簇的三角形数 (仅网格簇渲染，随所选 LOD 变化)
+    uint32_t LightIndexCount = 0;       // 所有光源簇的光源列表总长 (仅分簇光照，GPU 回读)
+    uint64_t LightBuildGpuNs = 0;       // 分簇构建的 GPU 耗时 (仅分簇光照，时间戳回读)
+
+    // 各阶段 CPU 耗时
+    uint64_t UpdateNs = 0;
+    uint64_t PrepNs = 0;
+
+    // Update 阶段重新占用该帧槽时调用：先让容器放弃旧内存，再整体归零内存池
+    void ResetTransient()
+    {
+        Instances = TFrameVector<FInstanceState>(Arena.GetResource());
+        BoundsX = TFrameVector<float>(Arena.GetResource());
+        BoundsY = TFrameVector<float>(Arena.GetResource());
+        BoundsZ = TFrameVector<float>(Arena.GetResource());
+        BoundsRadius = TFrameVector<float>(Arena.GetResource());
+        OccluderVertices = TFrameVector<FVector3>(Arena.GetResource());
+        Lights = TFrameVector<FPointLight>(Arena.GetResource());
+        VisibleInstances = TFrameVector<uint32_t>(Arena.GetResource());
+        SortKeys = TFrameVector<uint64_t>(Arena.GetResource());
+        Draws = TFrameVector<FDrawConstants>(Arena.GetResource());
+        InstanceLods = TFrameVector<uint8_t>(Arena.GetResource());
+        Arena.Reset();
+    }
+};
@@ -0,0 +1,316 @@
+﻿#include "FramePipeline.h"
+#include "Scene.h"
+#include "InstanceCulling.h"
+#include "LightClustering.h"
+#include "JobSystem.h"
+#include "VulkanFramePacer.h"
+#include "VulkanProfiler.h"
+#include <cstring>
+
+namespace {
+    constexpr uint32_t PREP_JOB_GRAIN = 256;
+    constexpr float CAMERA_FOV_Y = PI / 3.0f;
+    constexpr float CAMERA_NEAR_Z = 0.1f;
+    constexpr float CAMERA_FAR_Z = 1000.0f;
+}
+
+FFramePipeline::FFramePipeline(FScene& InScene, FJobSystem& InJobs, FVulkanFramePacer& InPacer, FVulkanProfiler* InProfiler, bool bUseHugePages)
+    : SceneRef(InScene), JobsRef(InJobs), PacerRef(InPacer), Profiler(InProfiler)
+{
+    for (FFramePacket& Packet : Packets)
+    {
+        Packet.Arena.Initialize(FRAME_ARENA_CAPACITY, bUseHugePages);
+    }
+
+    CA_LOG_INFO("FramePipeline", "{} frame arenas x {} MB ({}).", PACKET_COUNT, FRAME_ARENA_CAPACITY / (1024 * 1024),
+        Packets[0].Arena.IsHugePageBacked() ? "huge pages" : bUseHugePages ? "huge pages unavailable, regular pages" : "regular pages");
+}
+
+FFramePipeline::~FFramePipeline()
+{
+    Stop();
+}
+
+void FFramePipeline::Start()
+{
+    check(!UpdateThread.joinable());
+    bStopRequested = false;
+    LastUpdateStartNs = Utils::GetTimeNs();
+    StatsBeginNs = LastUpdateStartNs;
+
+    UpdateThread = std::thread(&FFramePipeline::UpdateThreadMain, this);
+    PrepThread = std::thread(&FFramePipeline::PrepThreadMain, this);
+}
+
+void FFramePipeline::Stop()
+{
+    if (!UpdateThread.joinable())
+    {
+        return;
+    }
+
+    // atomic wait 只在值变化时返回，改动纪元/计数唤醒两个阶段线程，它们醒来后先检查 bStopRequested
+    bStopRequested = true;
+    ReleaseEpoch.fetch_add(1, std::memory_order_release);
+    ReleaseEpoch.notify_all();
+    PrepPendingCount.fetch_add(1, std::memory_order_release);
+    PrepPendingCount.notify_all();
+
+    UpdateThread.join();
+    PrepThread.join();
+}
+
+void FFramePipeline::SetViewportExtent(uint32_t Width, uint32_t Height)
+{
+    ViewportWidth = Width;
+    ViewportHeight = Height;
+}
+
+void FFramePipeline::SetLodErrors(std::span<const float> RelativeErrors, float ErrorPixels)
+{
+    check(!PrepThread.joinable());
+    LodSelector.SetLodErrors(RelativeErrors);
+    LodSelector.SetErrorThreshold(ErrorPixels);
+}
+
+void FFramePipeline::UpdateThreadMain()
+{
+    while (true)
+    {
+        // 1. 有界流水线：飞行中的帧包达到上限时等待 RHI 阶段归还
+        // 先读纪元再检查：检查之后发生的归还/停止都会改变纪元，wait 不会错过唤醒
+        const uint32_t Epoch = ReleaseEpoch.load(std::memory_order_acquire);
+        if (bStopRequested)
+        {
+            break;
+        }
+
+        // 比队列深度多一个帧包：RHI 阶段在 RenderFrame 中等待 GPU 时，Update 与 RenderPrep 仍各有一帧可做
+        // 低延迟模式 (深度 1) 保持单个帧包，输入采样紧贴提交
+        const uint32_t QueueDepth = PacerRef.GetQueueDepth();
+        const uint32_t MaxInFlight = bPipelined && QueueDepth > 1 ? std::min(QueueDepth + 1, PACKET_COUNT) : 1u;
+        if (InFlightCount.load(std::memory_order_acquire) >= MaxInFlight)
+        {
+            ReleaseEpoch.wait(Epoch, std::memory_order_acquire);
+            continue;
+        }
+
+        // 2. 帧节奏控制：低延迟模式下推迟输入采样
+        const uint64_t FrameStartNs = PacerRef.WaitForFrameStart();
+        if (bStopRequested)
+        {
+            break;
+        }
+
+        // 按帧号轮转：飞行中的帧包数不超过 PACKET_COUNT 且各阶段先进先出，这个槽一定已被归还
+        FFramePacket& Packet = Packets[NextFrameNumber % PACKET_COUNT];
+        Packet.ResetTransient();
+        Packet.FrameNumber = NextFrameNumber++;
+        Packet.FrameStartNs = FrameStartNs;
+        Packet.DeltaSeconds = std::min(static_cast<float>(FrameStartNs - LastUpdateStartNs) / 1e9f, MAX_DELTA_SECONDS);
+        Packet.ViewportWidth = ViewportWidth;
+        Packet.ViewportHeight = ViewportHeight;
+        LastUpdateStartNs = FrameStartNs;
+
+        SceneRef.Update(Packet.DeltaSeconds, JobsRef);
+        SceneRef.Snapshot(Packet, JobsRef);
+
+        const uint64_t EndNs = Utils::GetTimeNs();
+        Packet.UpdateNs = EndNs - FrameStartNs;
+        if (Profiler)
+        {
+            Profiler->AddCpuEvent("Update", FrameStartNs, EndNs, ETimelineTrack::Update, Packet.FrameNumber);
+        }
+
+        InFlightCount.fetch_add(1, std::memory_order_acq_rel);
+        verify(PrepQueue.TryPush(&Packet));
+        PrepPendingCount.fetch_add(1, std::memory_order_release);
+        PrepPendingCount.notify_one();
+    }
+}
+
+void FFramePipeline::PrepThreadMain()
+{
+    while (true)
+    {
+        PrepPendingCount.wait(0, std::memory_order_acquire);
+        if (bStopRequested)
+        {
+            break;
+        }
+
+        FFramePacket* Packet = nullptr;
+        if (!PrepQueue.TryPop(Packet))
+        {
+            continue;
+        }
+        PrepPendingCount.fetch_sub(1, std::memory_order_acq_rel);
+
+        const uint64_t BeginNs = Utils::GetTimeNs();
+        PrepareFrame(*Packet);
+        const uint64_t EndNs = Utils::GetTimeNs();
+        Packet->PrepNs = EndNs - BeginNs;
+        if (Profiler)
+        {
+            Profiler->AddCpuEvent("RenderPrep", BeginNs, EndNs, ETimelineTrack::RenderPrep, Packet->FrameNumber);
+        }
+
+        verify(RhiQueue.TryPush(Packet));
+        if (PacketReadyCallback)
+        {
+            PacketReadyCallback();
+        }
+    }
+}
+
+void FFramePipeline::PrepareFrame(FFramePacket& Packet)
+{
+    const float AspectRatio = Packet.ViewportHeight > 0
+        ? static_cast<float>(Packet.ViewportWidth) / static_cast<float>(Packet.ViewportHeight) : 1.0f;
+    Packet.Projection = FMatrix4::Perspective(CAMERA_FOV_Y, AspectRatio, CAMERA_NEAR_Z, CAMERA_FAR_Z);
+    Packet.ViewProjection = Packet.Projection * Packet.View;
+
+    const uint32_t InstanceCount = static_cast<uint32_t>(Packet.Instances.size());
+    const FSphereArrays Spheres = { Packet.BoundsX.data(), Packet.BoundsY.data(), Packet.BoundsZ.data(), Packet.BoundsRadius.data(), InstanceCount };
+    const bool bSelectLods = LodSelector.GetLodCount() > 1;
+    if (bSelectLods)
+    {
+        LodSelector.BeginFrame(Packet.View, CAMERA_FOV_Y, Packet.ViewportHeight, CAMERA_NEAR_Z);
+        Packet.InstanceLods.resize(InstanceCount);
+    }
+
+    // GPU 剔除：可见性与绘制参数在 GPU 上生成，剔除数由 RHI 阶段回读填入；LOD 不知道谁可见，全部实例都选
+    Packet.OcclusionCulledCount = 0;
+    Packet.ClusterCount = 0;
+    Packet.ClusterCulledCount = 0;
+    Packet.TriangleCount = 0;
+    Packet.LightIndexCount = 0;
+    Packet.LightBuildGpuNs = 0;
+    Packet.bCpuCulled = !bGpuCulling;
+    if (bGpuCulling)
+    {
+        Packet.CulledCount = 0;
+        if (bSelectLods)
+        {
+            LodSelector.Select(Spheres, nullptr, InstanceCount, JobsRef, Packet.InstanceLods.data());
+        }
+        return;
+    }
+
+    const FFrustum Frustum = FFrustum::FromViewProjection(Packet.ViewProjection);
+
+    // 1. 视锥剔除：SoA 包围球并行分块测试，得到连续的可见实例列表
+    Packet.CulledCount = InstanceCount - InstanceCulling::CullSpheres(Frustum, Spheres, JobsRef, Packet.Arena, Packet.VisibleInstances);
+
+    // 2. 软件遮挡剔除：遮挡体光栅化到低分辨率深度缓冲，视锥内的实例在生成任何绘制之前与之比较
+    const uint32_t OccluderTriangleCount = static_cast<uint32_t>(Packet.OccluderVertices.size() / 3);
+    if (bOcclusionCulling && OccluderTriangleCount > 0)
+    {
+        OcclusionRasterizer.BeginFrame(Packet.ViewProjection, Packet.ViewportWidth, Packet.ViewportHeight);
+        OcclusionRasterizer.RenderTriangles(Packet.OccluderVertices.data(), OccluderTriangleCount, JobsRef, Packet.Arena);
+        Packet.OcclusionCulledCount = OcclusionRasterizer.RemoveOccluded(Spheres, JobsRef, Packet.Arena, Packet.VisibleInstances);
+    }
+    const uint32_t VisibleCount = static_cast<uint32_t>(Packet.VisibleInstances.size());
+    if (bSelectLods)
+    {
+        LodSelector.Select(Spheres, Packet.VisibleInstances.data(), VisibleCount, JobsRef, Packet.InstanceLods.data());
+    }
+
+    // 3. 只为可见实例生成排序键 (视空间深度)，由近到远排序
+    Packet.SortKeys.resize(VisibleCount);
+    JobsRef.ParallelFor(VisibleCount, [&Packet](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                const uint32_t Index = Packet.VisibleInstances[i];
+                const FVector3 Center = { Packet.BoundsX[Index], Packet.BoundsY[Index], Packet.BoundsZ[Index] };
+
+                // 正的浮点数按位比较与数值比较一致
+                const float ViewDepth = std::max(-Packet.View.TransformPoint(Center).Z, 0.0f);
+                uint32_t DepthBits = 0;
+                std::memcpy(&DepthBits, &ViewDepth, sizeof(DepthBits));
+                Packet.SortKeys[i] = (static_cast<uint64_t>(DepthBits) << 32) | Index;
+            }
+        }, PREP_JOB_GRAIN);
+    std::sort(Packet.SortKeys.begin(), Packet.SortKeys.end());
+
+    // 4. 构建每个绘制的常量
+    Packet.Draws.resize(VisibleCount);
+    JobsRef.ParallelFor(VisibleCount, [&Packet](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                const FInstanceState& Instance = Packet.Instances[static_cast<uint32_t>(Packet.SortKeys[i])];
+                FDrawConstants& Draw = Packet.Draws[i];
+                Draw.WorldViewProjection = Packet.ViewProjection * Instance.World;
+                Draw.Color = Instance.Color;
+            }
+        }, PREP_JOB_GRAIN);
+}
+
+FFramePacket* FFramePipeline::TryAcquirePreparedPacket()
+{
+    FFramePacket* Packet = nullptr;
+    return RhiQueue.TryPop(Packet) ? Packet : nullptr;
+}
+
+void FFramePipeline::ReleasePacket(FFramePacket* Packet, uint64_t RhiNs)
+{
+    AccumulateStats(*Packet, RhiNs);
+
+    InFlightCount.fetch_sub(1, std::memory_order_acq_rel);
+    ReleaseEpoch.fetch_add(1, std::memory_order_release);
+    ReleaseEpoch.notify_one();
+}
+
+void FFramePipeline::AccumulateStats(const FFramePacket& Packet, uint64_t RhiNs)
+{
+    StatsFrameCount++;
+    StatsUpdateNs += Packet.UpdateNs;
+    StatsPrepNs += Packet.PrepNs;
+    StatsRhiNs += RhiNs;
+    StatsCulled += Packet.CulledCount;
+    StatsOcclusionCulled += Packet.OcclusionCulledCount;
+    StatsClusters += Packet.ClusterCount;
+    StatsClustersCulled += Packet.ClusterCulledCount;
+    StatsTriangles += Packet.TriangleCount;
+    StatsLightIndices += Packet.LightIndexCount;
+    StatsLightBuildNs += Packet.LightBuildGpuNs;
+    // 此时三个阶段都已结束，池的用量即为整帧的用量
+    StatsArenaPeakBytes = std::max(StatsArenaPeakBytes, Packet.Arena.GetUsedBytes());
+    StatsArenaOverflowBytes = std::max(StatsArenaOverflowBytes, Packet.Arena.GetOverflowBytes());
+
+    if (StatsFrameCount < STATS_INTERVAL)
+    {
+        return;
+    }
+
+    const uint64_t NowNs = Utils::GetTimeNs();
+    const double Frames = static_cast<double>(StatsFrameCount);
+    const double UpdateMs = StatsUpdateNs / Frames / 1e6;
+    const double PrepMs = StatsPrepNs / Frames / 1e6;
+    const double RhiMs = StatsRhiNs / Frames / 1e6;
+    const double FrameMs = (NowNs - StatsBeginNs) / Frames / 1e6;
+
+    CA_LOG_INFO("FramePipeline", "{}: update {} ms, prep {} ms, rhi {} ms (sum {} ms), frame interval {} ms, culled {}/{} (occlusion {}), clusters culled {}/{}, triangles {}, lights per cluster {}, light build {} ms, arena peak {} KB (overflow {} KB)",
+        bPipelined ? "pipelined" : "serial", UpdateMs, PrepMs, RhiMs, UpdateMs + PrepMs + RhiMs, FrameMs,
+        static_cast<uint64_t>((StatsCulled + StatsOcclusionCulled) / Frames), Packet.Instances.size(),
+        static_cast<uint64_t>(StatsOcclusionCulled / Frames),
+        static_cast<uint64_t>(StatsClustersCulled / Frames), static_cast<uint64_t>(StatsClusters / Frames),
+        static_cast<uint64_t>(StatsTriangles / Frames), StatsLightIndices / Frames / FLightClusterGrid::CLUSTER_COUNT, StatsLightBuildNs / Frames / 1e6, StatsArenaPeakBytes / 1024, StatsArenaOverflowBytes / 1024);
+
+    StatsFrameCount = 0;
+    StatsUpdateNs = 0;
+    StatsPrepNs = 0;
+    StatsRhiNs = 0;
+    StatsCulled = 0;
+    StatsOcclusionCulled = 0;
+    StatsClusters = 0;
+    StatsClustersCulled = 0;
+    StatsTriangles = 0;
+    StatsLightIndices = 0;
+    StatsLightBuildNs = 0;
+    StatsArenaPeakBytes = 0;
+    StatsArenaOverflowBytes = 0;
+    StatsBeginNs = NowNs;
+}
@@ -0,0 +1,121 @@
+﻿#pragma once
+#include <thread>
+#include <atomic>
+#include "SpscQueue.h"
+#include "FramePacket.h"
+#include "OcclusionRasterizer.h"
+#include "LodSelector.h"
+
+class FScene;
+class FJobSystem;
+class FVulkanFramePacer;
+class FVulkanProfiler;
+
+// 帧流水线：Update -> RenderPrep -> RHI 三个阶段在相邻帧上并行
+// - Update (模拟) 与 RenderPrep (剔除/排序/常量构建) 各占一个线程，内部再用 Job System 并行
+// - RHI 阶段 (录制/提交/呈现) 由渲染线程调用 TryAcquirePreparedPacket / ReleasePacket 驱动
+// - 阶段之间用 SPSC 队列交接帧包；三个阶段各持一个帧包才能完全重叠，常规模式下飞行中的帧包数为
+//   帧节奏控制器的队列深度 + 1 (GPU 侧的排队仍由 RenderFrame 按队列深度等待 Timeline 约束)，
+//   低延迟模式为 1，从而约束输入到提交的 CPU 侧延迟
+// 稳态下 CPU 帧间隔约等于最慢阶段的耗时，而不是三个阶段之和
+class FFramePipeline
+{
+public:
+    // Update / RenderPrep / RHI 各一个，另外 RHI 阶段受 GPU 队列深度约束时还可以多排队 MAX_FRAMES_IN_FLIGHT - 1 个
+    static constexpr uint32_t PACKET_COUNT = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) + 1;
+    static constexpr size_t QUEUE_CAPACITY = 8;
+    static_assert(PACKET_COUNT <= QUEUE_CAPACITY, "Stage queues must hold every packet");
+    // 每隔多少帧打印一次阶段统计
+    static constexpr uint64_t STATS_INTERVAL = 600;
+    // Update 的单帧时长上限，防止断点/最小化之后模拟一次跳太远
+    static constexpr float MAX_DELTA_SECONDS = 0.1f;
+
+    FFramePipeline(FScene& InScene, FJobSystem& InJobs, FVulkanFramePacer& InPacer, FVulkanProfiler* InProfiler, bool bUseHugePages = false);
+    ~FFramePipeline();
+
+    FFramePipeline(const FFramePipeline&) = delete;
+    FFramePipeline& operator=(const FFramePipeline&) = delete;
+
+    void Start();
+    void Stop();
+
+    // false 时每次只允许一个帧包在流水线中，三个阶段串行执行 (对比测量用)
+    void SetPipelined(bool bEnable) { bPipelined = bEnable; }
+    bool IsPipelined() const { return bPipelined; }
+
+    // true 时剔除与绘制列表交给 GPU (RHI 阶段上传实例并录制计算剔除 + 间接绘制)，RenderPrep 只计算相机矩阵
+    void SetGpuCulling(bool bEnable) { bGpuCulling = bEnable; }
+    // CPU 剔除时是否在视锥剔除之后再做软件遮挡剔除
+    void SetOcclusionCulling(bool bEnable) { bOcclusionCulling = bEnable; }
+    // 网格的 LOD 误差表 (按包围球半径归一化，见 FLodSelector) 与允许的屏幕误差；Start 之前调用
+    // 表中多于一级时 RenderPrep 为每个实例选择 LOD，结果写入 FFramePacket::InstanceLods
+    void SetLodErrors(std::span<const float> RelativeErrors, float ErrorPixels);
+
+    // 渲染线程在交换链 (重) 建后调用，后续帧的投影按新尺寸计算
+    void SetViewportExtent(uint32_t Width, uint32_t Height);
+
+    // 有新帧包可供 RHI 阶段消费时调用 (RenderPrep 线程上执行)
+    void SetPacketReadyCallback(std::function<void()> InCallback) { PacketReadyCallback = std::move(InCallback); }
+
+    // 以下仅渲染线程调用
+    FFramePacket* TryAcquirePreparedPacket();
+    void ReleasePacket(FFramePacket* Packet, uint64_t RhiNs);
+
+private:
+    void UpdateThreadMain();
+    void PrepThreadMain();
+    void PrepareFrame(FFramePacket& Packet);
+    void AccumulateStats(const FFramePacket& Packet, uint64_t RhiNs);
+
+    FScene& SceneRef;
+    FJobSystem& JobsRef;
+    FVulkanFramePacer& PacerRef;
+    FVulkanProfiler* Profiler = nullptr;
+
+    std::array<FFramePacket, PACKET_COUNT> Packets;
+
+    // Update -> RenderPrep -> RHI
+    TSpscQueue<FFramePacket*, QUEUE_CAPACITY> PrepQueue;
+    TSpscQueue<FFramePacket*, QUEUE_CAPACITY> RhiQueue;
+    // 已入队未取出的帧包数，RenderPrep 线程在其上 wait
+    std::atomic<uint32_t> PrepPendingCount = 0;
+    // 已开始 Update 但还未被 RHI 阶段归还的帧包数
+    std::atomic<uint32_t> InFlightCount = 0;
+    // 每次归还帧包或请求停止时递增，Update 线程在其上 wait (计数本身会回到旧值，不能直接 wait)
+    std::atomic<uint32_t> ReleaseEpoch = 0;
+
+    std::atomic<bool> bPipelined = true;
+    std::atomic<bool> bGpuCulling = false;
+    std::atomic<bool> bOcclusionCulling = true;
+    std::atomic<bool> bStopRequested = false;
+    std::atomic<uint32_t> ViewportWidth = WINDOW_DEFAULT_WIDTH;
+    std::atomic<uint32_t> ViewportHeight = WINDOW_DEFAULT_HEIGHT;
+    std::function<void()> PacketReadyCallback;
+
+    std::thread UpdateThread;
+    std::thread PrepThread;
+
+    // 仅 RenderPrep 线程
+    FOcclusionRasterizer OcclusionRasterizer;
+    FLodSelector LodSelector;
+
+    // 仅 Update 线程
+    uint64_t NextFrameNumber = 1;
+    uint64_t LastUpdateStartNs = 0;
+
+    // 仅渲染线程
+    uint64_t StatsFrameCount = 0;
+    uint64_t StatsUpdateNs = 0;
+    uint64_t StatsPrepNs = 0;
+    uint64_t StatsRhiNs = 0;
+    uint64_t StatsCulled = 0;
+    uint64_t StatsOcclusionCulled = 0;
+    uint64_t StatsClusters = 0;
+    uint64_t StatsClustersCulled = 0;
+    uint64_t StatsTriangles = 0;
+    uint64_t StatsLightIndices = 0;
+    uint64_t StatsLightBuildNs = 0;
+    uint64_t StatsBeginNs = 0;
+    size_t StatsArenaPeakBytes = 0;
+    size_t StatsArenaOverflowBytes = 0;
+};
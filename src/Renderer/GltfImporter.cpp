@@ -0,0 +1,554 @@
+﻿#include "GltfImporter.h"
+#include "Json.h"
+#include <cstring>
+
+namespace {
+    constexpr uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+    constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+    constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+
+    constexpr uint32_t COMPONENT_BYTE = 5120;
+    constexpr uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+    constexpr uint32_t COMPONENT_SHORT = 5122;
+    constexpr uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+    constexpr uint32_t COMPONENT_UNSIGNED_INT = 5125;
+    constexpr uint32_t COMPONENT_FLOAT = 5126;
+
+    constexpr uint32_t MODE_TRIANGLES = 4;
+
+    std::vector<std::byte> ReadWholeFile(const std::filesystem::path& Path)
+    {
+        std::ifstream Stream(Path, std::ios::ate | std::ios::binary);
+        if (!Stream.is_open())
+        {
+            throw std::runtime_error("failed to open glTF file: " + Path.string());
+        }
+        std::vector<std::byte> Bytes(static_cast<size_t>(Stream.tellg()));
+        Stream.seekg(0);
+        Stream.read(reinterpret_cast<char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size()));
+        return Bytes;
+    }
+
+    uint32_t ReadU32(const std::byte* Data)
+    {
+        uint32_t Value = 0;
+        std::memcpy(&Value, Data, sizeof(Value));
+        return Value;
+    }
+
+    std::vector<std::byte> DecodeBase64(std::string_view Text)
+    {
+        auto Decode = [](char C) -> int
+            {
+                if (C >= 'A' && C <= 'Z') return C - 'A';
+                if (C >= 'a' && C <= 'z') return C - 'a' + 26;
+                if (C >= '0' && C <= '9') return C - '0' + 52;
+                if (C == '+' || C == '-') return 62;
+                if (C == '/' || C == '_') return 63;
+                return -1;
+            };
+
+        std::vector<std::byte> Result;
+        Result.reserve(Text.size() * 3 / 4);
+        uint32_t Accumulator = 0;
+        int Bits = 0;
+        for (char C : Text)
+        {
+            if (C == '=')
+            {
+                break;
+            }
+            const int Value = Decode(C);
+            if (Value < 0)
+            {
+                throw std::runtime_error("failed to decode glTF data URI, invalid base64");
+            }
+            Accumulator = (Accumulator << 6) | static_cast<uint32_t>(Value);
+            Bits += 6;
+            if (Bits >= 8)
+            {
+                Bits -= 8;
+                Result.push_back(static_cast<std::byte>((Accumulator >> Bits) & 0xFF));
+            }
+        }
+        return Result;
+    }
+
+    // URI 中的 %XX 转义 (文件名里的空格等)
+    std::string DecodeUri(std::string_view Uri)
+    {
+        std::string Result;
+        for (size_t i = 0; i < Uri.size(); i++)
+        {
+            if (Uri[i] == '%' && i + 2 < Uri.size())
+            {
+                Result.push_back(static_cast<char>(std::stoi(std::string(Uri.substr(i + 1, 2)), nullptr, 16)));
+                i += 2;
+            }
+            else
+            {
+                Result.push_back(Uri[i]);
+            }
+        }
+        return Result;
+    }
+
+    FVector3 ReadVector3(const FJsonValue* Value, const FVector3& Default)
+    {
+        if (!Value || !Value->IsArray() || Value->Size() != 3)
+        {
+            return Default;
+        }
+        return { static_cast<float>((*Value)[0].AsNumber()), static_cast<float>((*Value)[1].AsNumber()), static_cast<float>((*Value)[2].AsNumber()) };
+    }
+
+    // 节点局部变换：matrix，或 T * R * S
+    FMatrix4 GetLocalTransform(const FJsonValue& Node)
+    {
+        if (const FJsonValue* Matrix = Node.Find("matrix"); Matrix && Matrix->IsArray() && Matrix->Size() == 16)
+        {
+            FMatrix4 Result;
+            for (int Column = 0; Column < 4; Column++)
+            {
+                Result.Columns[Column] = {
+                    static_cast<float>((*Matrix)[Column * 4 + 0].AsNumber()), static_cast<float>((*Matrix)[Column * 4 + 1].AsNumber()),
+                    static_cast<float>((*Matrix)[Column * 4 + 2].AsNumber()), static_cast<float>((*Matrix)[Column * 4 + 3].AsNumber()) };
+            }
+            return Result;
+        }
+
+        const FVector3 T = ReadVector3(Node.Find("translation"), { 0.0f, 0.0f, 0.0f });
+        const FVector3 S = ReadVector3(Node.Find("scale"), { 1.0f, 1.0f, 1.0f });
+        float X = 0.0f, Y = 0.0f, Z = 0.0f, W = 1.0f;
+        if (const FJsonValue* Rotation = Node.Find("rotation"); Rotation && Rotation->IsArray() && Rotation->Size() == 4)
+        {
+            X = static_cast<float>((*Rotation)[0].AsNumber());
+            Y = static_cast<float>((*Rotation)[1].AsNumber());
+            Z = static_cast<float>((*Rotation)[2].AsNumber());
+            W = static_cast<float>((*Rotation)[3].AsNumber());
+        }
+
+        FMatrix4 Result;
+        Result.Columns[0] = FVector4(1.0f - 2.0f * (Y * Y + Z * Z), 2.0f * (X * Y + Z * W), 2.0f * (X * Z - Y * W), 0.0f) * S.X;
+        Result.Columns[1] = FVector4(2.0f * (X * Y - Z * W), 1.0f - 2.0f * (X * X + Z * Z), 2.0f * (Y * Z + X * W), 0.0f) * S.Y;
+        Result.Columns[2] = FVector4(2.0f * (X * Z + Y * W), 2.0f * (Y * Z - X * W), 1.0f - 2.0f * (X * X + Y * Y), 0.0f) * S.Z;
+        Result.Columns[3] = FVector4(T, 1.0f);
+        return Result;
+    }
+
+    class FGltfDocument
+    {
+    public:
+        explicit FGltfDocument(const std::filesystem::path& Path)
+        {
+            std::vector<std::byte> FileBytes = ReadWholeFile(Path);
+            std::string_view JsonText;
+            std::vector<std::byte> GlbBinary;
+
+            if (FileBytes.size() >= 12 && ReadU32(FileBytes.data()) == GLB_MAGIC)
+            {
+                // GLB: 12 字节文件头 + JSON 块 + 可选的 BIN 块
+                if (ReadU32(FileBytes.data() + 4) != 2)
+                {
+                    throw std::runtime_error("failed to import glTF, only version 2 GLB is supported: " + Path.string());
+                }
+                size_t Offset = 12;
+                while (Offset + 8 <= FileBytes.size())
+                {
+                    const uint32_t ChunkLength = ReadU32(FileBytes.data() + Offset);
+                    const uint32_t ChunkType = ReadU32(FileBytes.data() + Offset + 4);
+                    Offset += 8;
+                    if (ChunkLength > FileBytes.size() - Offset)
+                    {
+                        throw std::runtime_error("failed to import glTF, truncated GLB chunk: " + Path.string());
+                    }
+                    if (ChunkType == GLB_CHUNK_JSON)
+                    {
+                        JsonText = std::string_view(reinterpret_cast<const char*>(FileBytes.data() + Offset), ChunkLength);
+                    }
+                    else if (ChunkType == GLB_CHUNK_BIN && GlbBinary.empty())
+                    {
+                        GlbBinary.assign(FileBytes.begin() + Offset, FileBytes.begin() + Offset + ChunkLength);
+                    }
+                    Offset += (ChunkLength + 3) & ~3u;
+                }
+            }
+            else
+            {
+                JsonText = std::string_view(reinterpret_cast<const char*>(FileBytes.data()), FileBytes.size());
+            }
+
+            Root = FJsonValue::Parse(JsonText);
+            if (const FJsonValue* Extensions = Root.Find("extensionsRequired"))
+            {
+                for (const FJsonValue& Extension : Extensions->GetElements())
+                {
+                    throw std::runtime_error("failed to import glTF, required extension " + Extension.AsString() + " is not supported: " + Path.string());
+                }
+            }
+
+            if (const FJsonValue* BufferArray = Root.Find("buffers"))
+            {
+                for (const FJsonValue& Buffer : BufferArray->GetElements())
+                {
+                    const FJsonValue* Uri = Buffer.Find("uri");
+                    if (!Uri)
+                    {
+                        Buffers.push_back(std::move(GlbBinary));
+                        GlbBinary.clear();
+                        continue;
+                    }
+
+                    const std::string& UriText = Uri->AsString();
+                    if (UriText.starts_with("data:"))
+                    {
+                        const size_t Comma = UriText.find(',');
+                        if (Comma == std::string::npos || UriText.substr(0, Comma).find(";base64") == std::string::npos)
+                        {
+                            throw std::runtime_error("failed to import glTF, unsupported data URI: " + Path.string());
+                        }
+                        Buffers.push_back(DecodeBase64(std::string_view(UriText).substr(Comma + 1)));
+                    }
+                    else
+                    {
+                        // URI 为 UTF-8
+                        const std::string RelativePath = DecodeUri(UriText);
+                        Buffers.push_back(ReadWholeFile(Path.parent_path() / std::u8string(RelativePath.begin(), RelativePath.end())));
+                    }
+                }
+            }
+        }
+
+        const FJsonValue& GetRoot() const { return Root; }
+
+        const FJsonValue& GetElement(const char* ArrayName, uint32_t Index) const
+        {
+            const FJsonValue* Array = Root.Find(ArrayName);
+            if (!Array || Index >= Array->Size())
+            {
+                throw std::runtime_error(std::string("failed to import glTF, ") + ArrayName + " index out of range");
+            }
+            return (*Array)[Index];
+        }
+
+        // 访问器 -> 每元素 ComponentCount 个 float (整数按 normalized 规则归一化)
+        std::vector<float> ReadFloats(uint32_t AccessorIndex, uint32_t ComponentCount) const
+        {
+            FAccessorView View = GetAccessorView(AccessorIndex, ComponentCount);
+            std::vector<float> Result(static_cast<size_t>(View.Count) * ComponentCount, 0.0f);
+            for (uint32_t i = 0; i < View.Count && View.Data; i++)
+            {
+                const std::byte* Element = View.Data + static_cast<size_t>(i) * View.Stride;
+                for (uint32_t c = 0; c < ComponentCount; c++)
+                {
+                    Result[static_cast<size_t>(i) * ComponentCount + c] = ReadComponent(Element, c, View.ComponentType, View.bNormalized);
+                }
+            }
+            return Result;
+        }
+
+        std::vector<uint32_t> ReadIndices(uint32_t AccessorIndex) const
+        {
+            FAccessorView View = GetAccessorView(AccessorIndex, 1);
+            std::vector<uint32_t> Result(View.Count, 0);
+            for (uint32_t i = 0; i < View.Count && View.Data; i++)
+            {
+                const std::byte* Element = View.Data + static_cast<size_t>(i) * View.Stride;
+                switch (View.ComponentType)
+                {
+                case COMPONENT_UNSIGNED_BYTE: Result[i] = static_cast<uint32_t>(Element[0]); break;
+                case COMPONENT_UNSIGNED_SHORT: { uint16_t V; std::memcpy(&V, Element, sizeof(V)); Result[i] = V; break; }
+                case COMPONENT_UNSIGNED_INT: std::memcpy(&Result[i], Element, sizeof(uint32_t)); break;
+                default: throw std::runtime_error("failed to import glTF, invalid index component type");
+                }
+            }
+            return Result;
+        }
+
+        uint32_t GetAccessorCount(uint32_t AccessorIndex) const
+        {
+            return GetElement("accessors", AccessorIndex).Find("count") ? GetElement("accessors", AccessorIndex).Find("count")->AsUInt() : 0;
+        }
+
+    private:
+        struct FAccessorView
+        {
+            const std::byte* Data = nullptr; // 没有 bufferView 的访问器全为 0
+            uint32_t Count = 0;
+            uint32_t Stride = 0;
+            uint32_t ComponentType = 0;
+            bool bNormalized = false;
+        };
+
+        static uint32_t GetComponentSize(uint32_t ComponentType)
+        {
+            switch (ComponentType)
+            {
+            case COMPONENT_BYTE:
+            case COMPONENT_UNSIGNED_BYTE: return 1;
+            case COMPONENT_SHORT:
+            case COMPONENT_UNSIGNED_SHORT: return 2;
+            case COMPONENT_UNSIGNED_INT:
+            case COMPONENT_FLOAT: return 4;
+            default: throw std::runtime_error("failed to import glTF, invalid accessor component type");
+            }
+        }
+
+        static float ReadComponent(const std::byte* Element, uint32_t Index, uint32_t ComponentType, bool bNormalized)
+        {
+            switch (ComponentType)
+            {
+            case COMPONENT_FLOAT: { float V; std::memcpy(&V, Element + Index * 4, sizeof(V)); return V; }
+            case COMPONENT_UNSIGNED_BYTE: { const float V = static_cast<float>(static_cast<uint8_t>(Element[Index])); return bNormalized ? V / 255.0f : V; }
+            case COMPONENT_BYTE: { const float V = static_cast<float>(static_cast<int8_t>(Element[Index])); return bNormalized ? std::max(V / 127.0f, -1.0f) : V; }
+            case COMPONENT_UNSIGNED_SHORT: { uint16_t V; std::memcpy(&V, Element + Index * 2, sizeof(V)); return bNormalized ? V / 65535.0f : V; }
+            case COMPONENT_SHORT: { int16_t V; std::memcpy(&V, Element + Index * 2, sizeof(V)); return bNormalized ? std::max(V / 32767.0f, -1.0f) : V; }
+            case COMPONENT_UNSIGNED_INT: { uint32_t V; std::memcpy(&V, Element + Index * 4, sizeof(V)); return static_cast<float>(V); }
+            default: throw std::runtime_error("failed to import glTF, invalid accessor component type");
+            }
+        }
+
+        FAccessorView GetAccessorView(uint32_t AccessorIndex, uint32_t ComponentCount) const
+        {
+            const FJsonValue& Accessor = GetElement("accessors", AccessorIndex);
+            if (Accessor.Find("sparse"))
+            {
+                throw std::runtime_error("failed to import glTF, sparse accessors are not supported");
+            }
+
+            FAccessorView View;
+            View.Count = Accessor.Find("count") ? Accessor.Find("count")->AsUInt() : 0;
+            View.ComponentType = Accessor.Find("componentType") ? Accessor.Find("componentType")->AsUInt() : 0;
+            View.bNormalized = Accessor.Find("normalized") && Accessor.Find("normalized")->AsBool();
+            const uint32_t ElementSize = GetComponentSize(View.ComponentType) * ComponentCount;
+            View.Stride = ElementSize;
+
+            const FJsonValue* BufferViewIndex = Accessor.Find("bufferView");
+            if (!BufferViewIndex || View.Count == 0)
+            {
+                return View;
+            }
+
+            const FJsonValue& BufferView = GetElement("bufferViews", BufferViewIndex->AsUInt());
+            const uint32_t BufferIndex = BufferView.Find("buffer") ? BufferView.Find("buffer")->AsUInt() : 0;
+            if (BufferIndex >= Buffers.size())
+            {
+                throw std::runtime_error("failed to import glTF, buffer index out of range");
+            }
+            if (const FJsonValue* ByteStride = BufferView.Find("byteStride"))
+            {
+                View.Stride = std::max(ByteStride->AsUInt(), ElementSize);
+            }
+
+            const uint64_t ViewOffset = BufferView.Find("byteOffset") ? BufferView.Find("byteOffset")->AsUInt() : 0;
+            const uint64_t ViewLength = BufferView.Find("byteLength") ? BufferView.Find("byteLength")->AsUInt() : 0;
+            const uint64_t AccessorOffset = Accessor.Find("byteOffset") ? Accessor.Find("byteOffset")->AsUInt() : 0;
+            const uint64_t Required = AccessorOffset + static_cast<uint64_t>(View.Count - 1) * View.Stride + ElementSize;
+            const std::vector<std::byte>& Buffer = Buffers[BufferIndex];
+            if (Required > ViewLength || ViewOffset + ViewLength > Buffer.size())
+            {
+                throw std::runtime_error("failed to import glTF, accessor exceeds its buffer");
+            }
+
+            View.Data = Buffer.data() + ViewOffset + AccessorOffset;
+            return View;
+        }
+
+        FJsonValue Root;
+        std::vector<std::vector<std::byte>> Buffers;
+    };
+
+    struct FImportStats
+    {
+        uint32_t Primitives = 0;
+        uint32_t SkippedPrimitives = 0;
+        uint32_t GeneratedNormals = 0;
+    };
+
+    void GenerateNormals(FMeshData& Mesh, uint32_t FirstVertex, size_t FirstIndex)
+    {
+        for (size_t i = FirstVertex; i < Mesh.Vertices.size(); i++)
+        {
+            Mesh.Vertices[i].Normal = { 0.0f, 0.0f, 0.0f };
+        }
+        // 叉积的长度为三角形面积的两倍，直接累加即为面积加权
+        for (size_t i = FirstIndex; i + 2 < Mesh.Indices.size(); i += 3)
+        {
+            FMeshVertex& A = Mesh.Vertices[Mesh.Indices[i]];
+            FMeshVertex& B = Mesh.Vertices[Mesh.Indices[i + 1]];
+            FMeshVertex& C = Mesh.Vertices[Mesh.Indices[i + 2]];
+            const FVector3 FaceNormal = FVector3::Cross(B.Position - A.Position, C.Position - A.Position);
+            A.Normal = A.Normal + FaceNormal;
+            B.Normal = B.Normal + FaceNormal;
+            C.Normal = C.Normal + FaceNormal;
+        }
+        for (size_t i = FirstVertex; i < Mesh.Vertices.size(); i++)
+        {
+            const float Length = Mesh.Vertices[i].Normal.Length();
+            Mesh.Vertices[i].Normal = Length > 0.0f ? Mesh.Vertices[i].Normal * (1.0f / Length) : FVector3(0.0f, 0.0f, 1.0f);
+        }
+    }
+
+    void AppendPrimitive(const FGltfDocument& Document, const FJsonValue& Primitive, const FMatrix4& World, FMeshData& Mesh, FImportStats& Stats)
+    {
+        const FJsonValue* Mode = Primitive.Find("mode");
+        const FJsonValue* Attributes = Primitive.Find("attributes");
+        const FJsonValue* Position = Attributes ? Attributes->Find("POSITION") : nullptr;
+        if ((Mode && Mode->AsUInt() != MODE_TRIANGLES) || !Position)
+        {
+            Stats.SkippedPrimitives++;
+            return;
+        }
+
+        const uint32_t FirstVertex = static_cast<uint32_t>(Mesh.Vertices.size());
+        const size_t FirstIndex = Mesh.Indices.size();
+        const uint32_t VertexCount = Document.GetAccessorCount(Position->AsUInt());
+        if (static_cast<uint64_t>(FirstVertex) + VertexCount > UINT32_MAX)
+        {
+            throw std::runtime_error("failed to import glTF, merged mesh exceeds 32-bit indices");
+        }
+
+        // 法线变换用上 3x3 的余子式矩阵 (逆转置乘以行列式)，镜像变换 (行列式为负) 同时翻转绕序
+        const FVector3 C0 = World.Columns[0].XYZ();
+        const FVector3 C1 = World.Columns[1].XYZ();
+        const FVector3 C2 = World.Columns[2].XYZ();
+        const float Determinant = FVector3::Dot(C0, FVector3::Cross(C1, C2));
+        const float NormalSign = Determinant < 0.0f ? -1.0f : 1.0f;
+        const FVector3 N0 = FVector3::Cross(C1, C2) * NormalSign;
+        const FVector3 N1 = FVector3::Cross(C2, C0) * NormalSign;
+        const FVector3 N2 = FVector3::Cross(C0, C1) * NormalSign;
+
+        const std::vector<float> Positions = Document.ReadFloats(Position->AsUInt(), 3);
+        const FJsonValue* NormalAccessor = Attributes->Find("NORMAL");
+        const std::vector<float> Normals = NormalAccessor ? Document.ReadFloats(NormalAccessor->AsUInt(), 3) : std::vector<float>();
+        const FJsonValue* UVAccessor = Attributes->Find("TEXCOORD_0");
+        const std::vector<float> UVs = UVAccessor ? Document.ReadFloats(UVAccessor->AsUInt(), 2) : std::vector<float>();
+
+        Mesh.Vertices.resize(FirstVertex + VertexCount);
+        for (uint32_t i = 0; i < VertexCount; i++)
+        {
+            FMeshVertex& Vertex = Mesh.Vertices[FirstVertex + i];
+            Vertex.Position = World.TransformPoint({ Positions[i * 3], Positions[i * 3 + 1], Positions[i * 3 + 2] });
+            if (Normals.size() >= static_cast<size_t>(VertexCount) * 3)
+            {
+                // 余子式矩阵的行是 N0/N1/N2：n' = N0 * n.x + N1 * n.y + N2 * n.z
+                const FVector3 Normal = N0 * Normals[i * 3] + N1 * Normals[i * 3 + 1] + N2 * Normals[i * 3 + 2];
+                const float Length = Normal.Length();
+                Vertex.Normal = Length > 0.0f ? Normal * (1.0f / Length) : FVector3(0.0f, 0.0f, 1.0f);
+            }
+            if (UVs.size() >= static_cast<size_t>(VertexCount) * 2)
+            {
+                Vertex.U = UVs[i * 2];
+                Vertex.V = UVs[i * 2 + 1];
+            }
+        }
+
+        if (const FJsonValue* IndexAccessor = Primitive.Find("indices"))
+        {
+            const std::vector<uint32_t> Indices = Document.ReadIndices(IndexAccessor->AsUInt());
+            for (size_t i = 0; i + 2 < Indices.size(); i += 3)
+            {
+                if (Indices[i] >= VertexCount || Indices[i + 1] >= VertexCount || Indices[i + 2] >= VertexCount)
+                {
+                    throw std::runtime_error("failed to import glTF, index out of range");
+                }
+                Mesh.Indices.push_back(FirstVertex + Indices[i]);
+                Mesh.Indices.push_back(FirstVertex + (Determinant < 0.0f ? Indices[i + 2] : Indices[i + 1]));
+                Mesh.Indices.push_back(FirstVertex + (Determinant < 0.0f ? Indices[i + 1] : Indices[i + 2]));
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i + 2 < VertexCount; i += 3)
+            {
+                Mesh.Indices.push_back(FirstVertex + i);
+                Mesh.Indices.push_back(FirstVertex + (Determinant < 0.0f ? i + 2 : i + 1));
+                Mesh.Indices.push_back(FirstVertex + (Determinant < 0.0f ? i + 1 : i + 2));
+            }
+        }
+
+        if (Normals.size() < static_cast<size_t>(VertexCount) * 3)
+        {
+            GenerateNormals(Mesh, FirstVertex, FirstIndex);
+            Stats.GeneratedNormals++;
+        }
+        Stats.Primitives++;
+    }
+
+    void AppendNode(const FGltfDocument& Document, uint32_t NodeIndex, const FMatrix4& ParentWorld, uint32_t Depth, FMeshData& Mesh, FImportStats& Stats)
+    {
+        // glTF 要求节点层级无环，深度上限只防御损坏的文件
+        if (Depth > 1024)
+        {
+            throw std::runtime_error("failed to import glTF, node hierarchy too deep");
+        }
+
+        const FJsonValue& Node = Document.GetElement("nodes", NodeIndex);
+        const FMatrix4 World = ParentWorld * GetLocalTransform(Node);
+
+        if (const FJsonValue* MeshIndex = Node.Find("mesh"))
+        {
+            const FJsonValue& GltfMesh = Document.GetElement("meshes", MeshIndex->AsUInt());
+            if (const FJsonValue* Primitives = GltfMesh.Find("primitives"))
+            {
+                for (const FJsonValue& Primitive : Primitives->GetElements())
+                {
+                    AppendPrimitive(Document, Primitive, World, Mesh, Stats);
+                }
+            }
+        }
+
+        if (const FJsonValue* Children = Node.Find("children"))
+        {
+            for (const FJsonValue& Child : Children->GetElements())
+            {
+                AppendNode(Document, Child.AsUInt(), World, Depth + 1, Mesh, Stats);
+            }
+        }
+    }
+}
+
+FMeshData GltfImporter::Import(const std::filesystem::path& Path)
+{
+    const FGltfDocument Document(Path);
+    const FJsonValue& Root = Document.GetRoot();
+
+    FMeshData Mesh;
+    FImportStats Stats;
+    const FJsonValue* Scenes = Root.Find("scenes");
+    if (Scenes && Scenes->Size() > 0)
+    {
+        const uint32_t SceneIndex = Root.Find("scene") ? Root.Find("scene")->AsUInt() : 0;
+        if (const FJsonValue* Nodes = Document.GetElement("scenes", SceneIndex).Find("nodes"))
+        {
+            for (const FJsonValue& Node : Nodes->GetElements())
+            {
+                AppendNode(Document, Node.AsUInt(), FMatrix4::Identity(), 0, Mesh, Stats);
+            }
+        }
+    }
+    else if (const FJsonValue* Meshes = Root.Find("meshes"))
+    {
+        // 没有场景的文件 (库文件)：所有网格按单位变换导入
+        for (const FJsonValue& GltfMesh : Meshes->GetElements())
+        {
+            if (const FJsonValue* Primitives = GltfMesh.Find("primitives"))
+            {
+                for (const FJsonValue& Primitive : Primitives->GetElements())
+                {
+                    AppendPrimitive(Document, Primitive, FMatrix4::Identity(), Mesh, Stats);
+                }
+            }
+        }
+    }
+
+    if (Mesh.Indices.empty())
+    {
+        throw std::runtime_error("failed to import glTF, no triangle geometry: " + Path.string());
+    }
+
+    Mesh.Bounds = MeshUtils::ComputeBounds(Mesh.Vertices);
+    CA_LOG_INFO("Gltf", "Imported {}: {} primitives ({} skipped, {} with generated normals), {} vertices, {} triangles.",
+        Path.string(), Stats.Primitives, Stats.SkippedPrimitives, Stats.GeneratedNormals, Mesh.Vertices.size(), Mesh.GetTriangleCount());
+    return Mesh;
+}
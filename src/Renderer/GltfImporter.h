@@ -0,0 +1,13 @@
+﻿#pragma once
+#include "Mesh.h"
+
+// glTF 2.0 网格导入 (离线阶段使用)
+// - 支持 .gltf (外部 .bin 或 data: URI 内嵌的 base64 缓冲) 与 .glb
+// - 遍历默认场景的节点层级，把所有三角形图元按世界变换合并成一个网格
+// - 读取 POSITION / NORMAL / TEXCOORD_0 与索引；缺少法线时按面积加权生成，缺少索引时按顶点顺序
+// - 不支持稀疏访问器与压缩扩展 (Draco / meshopt)，遇到时报错；非三角形图元跳过
+namespace GltfImporter
+{
+    // 失败时抛出 std::runtime_error
+    FMeshData Import(const std::filesystem::path& Path);
+}
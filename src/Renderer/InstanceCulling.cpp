@@ -0,0 +1,54 @@
+﻿#include "InstanceCulling.h"
+#include "MathSimd.h"
+#include "JobSystem.h"
+#include <cstring>
+
+namespace InstanceCulling
+{
+    uint32_t CullSpheres(const FFrustum& Frustum, const FSphereArrays& Spheres, FJobSystem& Jobs, FFrameArena& Scratch,
+        TFrameVector<uint32_t>& OutVisible)
+    {
+        OutVisible.clear();
+        if (Spheres.Count == 0)
+        {
+            return 0;
+        }
+
+        const uint32_t BlockCount = (Spheres.Count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        uint32_t* BlockIndices = Scratch.AllocateArray<uint32_t>(Spheres.Count);
+        uint32_t* BlockOffsets = Scratch.AllocateArray<uint32_t>(BlockCount + 1);
+
+        // 1. 各块独立剔除：可见序号写到块自己的区间 [Block * BLOCK_SIZE, ...)，可见数先存在 BlockOffsets[Block + 1]
+        Jobs.ParallelFor(BlockCount, [&Frustum, &Spheres, BlockIndices, BlockOffsets](uint32_t Begin, uint32_t End)
+            {
+                for (uint32_t Block = Begin; Block < End; Block++)
+                {
+                    const uint32_t First = Block * BLOCK_SIZE;
+                    const uint32_t Last = std::min(First + BLOCK_SIZE, Spheres.Count);
+                    BlockOffsets[Block + 1] = MathSimd::CullSpheres(Frustum, Spheres.X, Spheres.Y, Spheres.Z, Spheres.Radius,
+                        First, Last, BlockIndices + First);
+                }
+            });
+
+        // 2. 前缀和得到各块在可见列表中的起点 (块数很少，串行即可)
+        BlockOffsets[0] = 0;
+        for (uint32_t Block = 0; Block < BlockCount; Block++)
+        {
+            BlockOffsets[Block + 1] += BlockOffsets[Block];
+        }
+        const uint32_t VisibleCount = BlockOffsets[BlockCount];
+
+        // 3. 并行拼接
+        OutVisible.resize(VisibleCount);
+        uint32_t* Visible = OutVisible.data();
+        Jobs.ParallelFor(BlockCount, [BlockIndices, BlockOffsets, Visible](uint32_t Begin, uint32_t End)
+            {
+                for (uint32_t Block = Begin; Block < End; Block++)
+                {
+                    std::memcpy(Visible + BlockOffsets[Block], BlockIndices + Block * BLOCK_SIZE,
+                        sizeof(uint32_t) * (BlockOffsets[Block + 1] - BlockOffsets[Block]));
+                }
+            });
+        return VisibleCount;
+    }
+}
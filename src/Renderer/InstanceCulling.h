@@ -0,0 +1,28 @@
+﻿#pragma once
+#include "MathTypes.h"
+#include "FrameArena.h"
+
+class FJobSystem;
+
+// 一组包围球的 SoA 视图 (X / Y / Z / 半径各一个连续数组)
+struct FSphereArrays
+{
+    const float* X = nullptr;
+    const float* Y = nullptr;
+    const float* Z = nullptr;
+    const float* Radius = nullptr;
+    uint32_t Count = 0;
+};
+
+// CPU 视锥剔除 (GPU 剔除关闭时由 RenderPrep 使用)
+// - 实例按 BLOCK_SIZE 切块分给 Job 系统，每块用 MathSimd::CullSpheres (AVX2 每次 8 个球) 把可见序号压缩到块自己的暂存区间
+// - 各块可见数做前缀和后，再并行把暂存拼接成连续的可见列表，结果与串行剔除完全一致 (升序)
+namespace InstanceCulling
+{
+    // 每块 16K 个实例 (SoA 输入 256 KB)：百万实例约 64 块，足够各 Worker 均分，块内又足够长，调度开销可忽略
+    constexpr uint32_t BLOCK_SIZE = 16 * 1024;
+
+    // 返回可见数；OutVisible 被重设为可见实例序号列表，暂存分配自 Scratch (调用方所在线程独占)
+    uint32_t CullSpheres(const FFrustum& Frustum, const FSphereArrays& Spheres, FJobSystem& Jobs, FFrameArena& Scratch,
+        TFrameVector<uint32_t>& OutVisible);
+}
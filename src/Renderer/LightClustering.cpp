@@ -0,0 +1,138 @@
+﻿#include "LightClustering.h"
+#include "FramePacket.h"
+#include "JobSystem.h"
+#include <cfloat>
+
+namespace {
+    // 球心到盒子的最近距离不超过半径即相交
+    bool SphereIntersectsAabb(const FVector3& Center, float Radius, const FAabb& Box)
+    {
+        const float DX = std::max({ Box.Min.X - Center.X, 0.0f, Center.X - Box.Max.X });
+        const float DY = std::max({ Box.Min.Y - Center.Y, 0.0f, Center.Y - Box.Max.Y });
+        const float DZ = std::max({ Box.Min.Z - Center.Z, 0.0f, Center.Z - Box.Max.Z });
+        return DX * DX + DY * DY + DZ * DZ <= Radius * Radius;
+    }
+}
+
+FLightClusterGrid FLightClusterGrid::FromProjection(const FMatrix4& Projection, uint32_t ViewportWidth, uint32_t ViewportHeight)
+{
+    // Perspective: Columns[2].Z = F / (N - F), Columns[3].Z = N * F / (N - F)
+    const float A = Projection.Columns[2].Z;
+    const float B = Projection.Columns[3].Z;
+
+    FLightClusterGrid Grid;
+    Grid.ViewportWidth = static_cast<float>(std::max(ViewportWidth, 1u));
+    Grid.ViewportHeight = static_cast<float>(std::max(ViewportHeight, 1u));
+    Grid.ProjectionScaleX = Projection.Columns[0].X;
+    Grid.ProjectionScaleY = -Projection.Columns[1].Y;
+    Grid.NearZ = B / A;
+    Grid.FarZ = B / (A + 1.0f);
+    Grid.SliceScale = SLICE_COUNT / std::log(Grid.FarZ / Grid.NearZ);
+    Grid.SliceBias = -std::log(Grid.NearZ) * Grid.SliceScale;
+    return Grid;
+}
+
+float FLightClusterGrid::GetSliceDepth(uint32_t Slice) const
+{
+    return NearZ * std::pow(FarZ / NearZ, static_cast<float>(Slice) / SLICE_COUNT);
+}
+
+FAabb FLightClusterGrid::GetClusterBounds(uint32_t Cluster) const
+{
+    const uint32_t Slice = Cluster / TILES_PER_SLICE;
+    const uint32_t TileX = Cluster % TILE_COUNT_X;
+    const uint32_t TileY = Cluster % TILES_PER_SLICE / TILE_COUNT_X;
+
+    // 图块在 NDC 中的范围与视口尺寸无关；观察空间 X = NDC X * 深度 / ScaleX，Y = -NDC Y * 深度 / ScaleY
+    const float NdcMinX = static_cast<float>(TileX) / TILE_COUNT_X * 2.0f - 1.0f;
+    const float NdcMaxX = static_cast<float>(TileX + 1) / TILE_COUNT_X * 2.0f - 1.0f;
+    const float NdcMinY = static_cast<float>(TileY) / TILE_COUNT_Y * 2.0f - 1.0f;
+    const float NdcMaxY = static_cast<float>(TileY + 1) / TILE_COUNT_Y * 2.0f - 1.0f;
+    const float Depths[2] = { GetSliceDepth(Slice), GetSliceDepth(Slice + 1) };
+
+    FAabb Bounds = { { FLT_MAX, FLT_MAX, -Depths[1] }, { -FLT_MAX, -FLT_MAX, -Depths[0] } };
+    for (float Depth : Depths)
+    {
+        const float X0 = NdcMinX * Depth / ProjectionScaleX;
+        const float X1 = NdcMaxX * Depth / ProjectionScaleX;
+        const float Y0 = -NdcMaxY * Depth / ProjectionScaleY;
+        const float Y1 = -NdcMinY * Depth / ProjectionScaleY;
+        Bounds.Min.X = std::min(Bounds.Min.X, X0);
+        Bounds.Max.X = std::max(Bounds.Max.X, X1);
+        Bounds.Min.Y = std::min(Bounds.Min.Y, Y0);
+        Bounds.Max.Y = std::max(Bounds.Max.Y, Y1);
+    }
+    return Bounds;
+}
+
+uint32_t FLightClusterGrid::GetClusterIndex(float PixelX, float PixelY, float ViewDepth) const
+{
+    const uint32_t TileX = std::min(static_cast<uint32_t>(std::max(PixelX / ViewportWidth * TILE_COUNT_X, 0.0f)), TILE_COUNT_X - 1);
+    const uint32_t TileY = std::min(static_cast<uint32_t>(std::max(PixelY / ViewportHeight * TILE_COUNT_Y, 0.0f)), TILE_COUNT_Y - 1);
+    const float SliceValue = std::log(std::max(ViewDepth, NearZ)) * SliceScale + SliceBias;
+    const uint32_t Slice = std::min(static_cast<uint32_t>(std::max(SliceValue, 0.0f)), SLICE_COUNT - 1);
+    return Slice * TILES_PER_SLICE + TileY * TILE_COUNT_X + TileX;
+}
+
+FLightClusterBuilder::FLightClusterBuilder()
+{
+    Clusters.resize(FLightClusterGrid::CLUSTER_COUNT);
+}
+
+void FLightClusterBuilder::Build(const FLightClusterGrid& Grid, std::span<const FPointLight> ViewLights, FJobSystem& Jobs)
+{
+    const uint32_t LightCount = static_cast<uint32_t>(ViewLights.size());
+
+    // 1. 各切片独立：深度筛选 -> 切片内逐簇测试，计数写入 Clusters，序号写入切片暂存
+    Jobs.ParallelFor(FLightClusterGrid::SLICE_COUNT, [&](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t Slice = Begin; Slice < End; Slice++)
+            {
+                const float SliceNear = Grid.GetSliceDepth(Slice);
+                const float SliceFar = Grid.GetSliceDepth(Slice + 1);
+                std::vector<uint32_t>& Candidates = SliceCandidates[Slice];
+                Candidates.clear();
+                for (uint32_t i = 0; i < LightCount; i++)
+                {
+                    const float Depth = -ViewLights[i].Position.Z;
+                    if (Depth + ViewLights[i].Radius >= SliceNear && Depth - ViewLights[i].Radius <= SliceFar)
+                    {
+                        Candidates.push_back(i);
+                    }
+                }
+
+                std::vector<uint32_t>& Indices = SliceIndices[Slice];
+                Indices.clear();
+                const uint32_t FirstCluster = Slice * FLightClusterGrid::TILES_PER_SLICE;
+                for (uint32_t Cluster = FirstCluster; Cluster < FirstCluster + FLightClusterGrid::TILES_PER_SLICE; Cluster++)
+                {
+                    const FAabb Bounds = Grid.GetClusterBounds(Cluster);
+                    uint32_t Count = 0;
+                    for (uint32_t i : Candidates)
+                    {
+                        if (Count < FLightClusterGrid::MAX_LIGHTS_PER_CLUSTER
+                            && SphereIntersectsAabb(ViewLights[i].Position, ViewLights[i].Radius, Bounds))
+                        {
+                            Indices.push_back(i);
+                            Count++;
+                        }
+                    }
+                    Clusters[Cluster].Count = Count;
+                }
+            }
+        }, 1);
+
+    // 2. 按簇序号前缀和，切片暂存本身就按簇序号排列，整段拷贝
+    uint32_t Offset = 0;
+    for (FLightCluster& Cluster : Clusters)
+    {
+        Cluster.Offset = Offset;
+        Offset += Cluster.Count;
+    }
+    LightIndices.resize(Offset);
+    for (uint32_t Slice = 0; Slice < FLightClusterGrid::SLICE_COUNT; Slice++)
+    {
+        const std::vector<uint32_t>& Indices = SliceIndices[Slice];
+        std::copy(Indices.begin(), Indices.end(), LightIndices.begin() + Clusters[Slice * FLightClusterGrid::TILES_PER_SLICE].Offset);
+    }
+}
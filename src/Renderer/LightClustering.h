@@ -0,0 +1,71 @@
+﻿#pragma once
+#include "MathTypes.h"
+
+class FJobSystem;
+struct FPointLight;
+
+// 分簇光照的视锥网格 (Froxel)：屏幕均分为 TILE_COUNT_X x TILE_COUNT_Y 个图块，观察空间深度按指数切片
+// - 切片 k 覆盖深度 [Near * (Far / Near)^(k / SLICE_COUNT), Near * (Far / Near)^((k + 1) / SLICE_COUNT))，
+//   各切片的厚度与到相机的距离成正比，远近的簇形状相近
+// - 片元由像素坐标与线性深度直接算出所在的簇：Slice = log(Depth) * SliceScale + SliceBias
+// - 成员按 ClusteredLighting.hlsli 中 FClusterData 的前 8 个字段排列，常量与着色器一致
+struct FLightClusterGrid
+{
+    static constexpr uint32_t TILE_COUNT_X = 16;
+    static constexpr uint32_t TILE_COUNT_Y = 9;
+    static constexpr uint32_t SLICE_COUNT = 24;
+    static constexpr uint32_t TILES_PER_SLICE = TILE_COUNT_X * TILE_COUNT_Y;
+    static constexpr uint32_t CLUSTER_COUNT = TILES_PER_SLICE * SLICE_COUNT;
+    // 单个簇的光源上限，超出的光源 (按光源序号靠后的) 被丢弃
+    static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 256;
+
+    float ViewportWidth = 1.0f;
+    float ViewportHeight = 1.0f;
+    float ProjectionScaleX = 1.0f; // 观察空间 X / 深度 -> NDC X
+    float ProjectionScaleY = 1.0f; // 观察空间 Y / 深度 -> -NDC Y (投影已翻转 Y)
+    float NearZ = 0.1f;
+    float FarZ = 1000.0f;
+    float SliceScale = 1.0f;
+    float SliceBias = 0.0f;
+
+    // 视场与近远平面从 FMatrix4::Perspective 生成的矩阵反推
+    static FLightClusterGrid FromProjection(const FMatrix4& Projection, uint32_t ViewportWidth, uint32_t ViewportHeight);
+
+    // 切片近端的观察空间深度 (Slice == SLICE_COUNT 时为远平面)
+    float GetSliceDepth(uint32_t Slice) const;
+    // 簇在观察空间 (相机看向 -Z) 中的包围盒
+    FAabb GetClusterBounds(uint32_t Cluster) const;
+    // 像素坐标 (帧缓冲左上为原点) 与线性深度所在的簇
+    uint32_t GetClusterIndex(float PixelX, float PixelY, float ViewDepth) const;
+};
+
+// 簇的光源列表在压缩索引表中的区间
+struct FLightCluster
+{
+    uint32_t Offset = 0;
+    uint32_t Count = 0;
+};
+
+// 光源分簇的 CPU 实现 (基准测试与 GPU 结果对照)，结果与 LightClustering.hlsl 一致：
+// 每个簇的光源按序号升序，超过 MAX_LIGHTS_PER_CLUSTER 的截断
+// - 各切片并行：先筛出深度范围与切片相交的光源，再在切片的图块间逐簇测试包围球与簇包围盒
+// - 切片内的结果先写入切片自己的暂存表，最后按簇序号做前缀和，拼成一张连续的索引表
+class FLightClusterBuilder
+{
+public:
+    FLightClusterBuilder();
+
+    // ViewLights 为观察空间光源
+    void Build(const FLightClusterGrid& Grid, std::span<const FPointLight> ViewLights, FJobSystem& Jobs);
+
+    std::span<const FLightCluster> GetClusters() const { return Clusters; }
+    std::span<const uint32_t> GetLightIndices() const { return LightIndices; }
+    float GetAverageLightsPerCluster() const { return static_cast<float>(LightIndices.size()) / FLightClusterGrid::CLUSTER_COUNT; }
+
+private:
+    std::vector<FLightCluster> Clusters;
+    std::vector<uint32_t> LightIndices;
+    // 每个切片的暂存：候选光源与切片内各簇的光源序号
+    std::array<std::vector<uint32_t>, FLightClusterGrid::SLICE_COUNT> SliceCandidates;
+    std::array<std::vector<uint32_t>, FLightClusterGrid::SLICE_COUNT> SliceIndices;
+};
@@ -0,0 +1,71 @@
+﻿#include "LodSelector.h"
+#include "JobSystem.h"
+#include <cmath>
+
+void FLodSelector::SetLodErrors(std::span<const float> RelativeErrors)
+{
+    check(RelativeErrors.size() <= FMeshLod::MAX_COUNT);
+    LodCount = std::max<uint32_t>(static_cast<uint32_t>(RelativeErrors.size()), 1);
+    Errors.fill(0.0f);
+    std::copy(RelativeErrors.begin(), RelativeErrors.end(), Errors.begin());
+    PreviousLods.clear();
+}
+
+void FLodSelector::BeginFrame(const FMatrix4& View, float FovY, uint32_t ViewportHeight, float InNearZ)
+{
+    const FVector3 T = View.Columns[3].XYZ();
+    Eye = -(View.GetRow(0).XYZ() * T.X + View.GetRow(1).XYZ() * T.Y + View.GetRow(2).XYZ() * T.Z);
+    ProjectionScale = static_cast<float>(ViewportHeight) / (2.0f * std::tan(FovY * 0.5f));
+    NearZ = InNearZ;
+}
+
+uint8_t FLodSelector::SelectOne(float X, float Y, float Z, float Radius, uint8_t Previous) const
+{
+    const FVector3 Offset = FVector3(X, Y, Z) - Eye;
+    const float Distance = std::max(Offset.Length() - Radius, NearZ);
+    // 相对误差 -> 像素：Errors[i] * PixelsPerError
+    const float PixelsPerError = Radius * ProjectionScale / Distance;
+
+    auto Coarsest = [this, PixelsPerError](float Threshold)
+        {
+            uint32_t Lod = 0;
+            while (Lod + 1 < LodCount && Errors[Lod + 1] * PixelsPerError <= Threshold)
+            {
+                Lod++;
+            }
+            return Lod;
+        };
+
+    const uint32_t Candidate = Coarsest(ErrorThreshold);
+    if (Candidate <= Previous)
+    {
+        return static_cast<uint8_t>(Candidate);
+    }
+    // 变粗：只走到收紧后的阈值允许的级别，且不比上一帧更细
+    return static_cast<uint8_t>(std::max<uint32_t>(Previous, Coarsest(ErrorThreshold * (1.0f - HYSTERESIS))));
+}
+
+void FLodSelector::Select(const FSphereArrays& Spheres, const uint32_t* Indices, uint32_t Count, FJobSystem& Jobs, uint8_t* OutLods)
+{
+    PreviousLods.resize(Spheres.Count, 0);
+    if (LodCount <= 1 || ErrorThreshold <= 0.0f)
+    {
+        for (uint32_t i = 0; i < Count; i++)
+        {
+            const uint32_t Index = Indices ? Indices[i] : i;
+            OutLods[Index] = PreviousLods[Index] = 0;
+        }
+        return;
+    }
+
+    // 每个实例只写自己的槽，分块之间不需要同步
+    Jobs.ParallelFor(Count, [this, &Spheres, Indices, OutLods](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                const uint32_t Index = Indices ? Indices[i] : i;
+                const uint8_t Lod = SelectOne(Spheres.X[Index], Spheres.Y[Index], Spheres.Z[Index], Spheres.Radius[Index], PreviousLods[Index]);
+                OutLods[Index] = PreviousLods[Index] = Lod;
+            }
+        }, JOB_GRAIN);
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+#include "MathTypes.h"
+#include "Meshlet.h"
+#include "InstanceCulling.h"
+
+class FJobSystem;
+
+// 运行时离散 LOD 选择 (RenderPrep 线程)
+// - 各级几何误差按网格包围球半径归一化，乘以实例包围球半径即世界空间误差，缩放过的实例同样适用
+// - 按包围球上离相机最近的点投影到屏幕 (偏保守)：
+//   像素误差 = 世界误差 * ViewportHeight / (2 tan(FovY / 2)) / max(距离 - 半径, 近平面)
+// - 选像素误差不超过阈值的最粗一级；滞回：变粗要求误差低于阈值的 (1 - HYSTERESIS)，变细立即生效，
+//   相机停在切换距离附近时不会逐帧来回跳
+// - 每个实例上一帧的级别保存在选择器里 (实例序号跨帧稳定)
+class FLodSelector
+{
+public:
+    static constexpr float HYSTERESIS = 0.25f;
+    static constexpr float DEFAULT_ERROR_PIXELS = 1.0f;
+    static constexpr uint32_t JOB_GRAIN = 4096;
+
+    // 由精到粗的相对误差表 (第 0 级为 0，单调不减)；只有一级时 Select 全部输出 0
+    void SetLodErrors(std::span<const float> RelativeErrors);
+    // 允许的屏幕误差 (像素)；<= 0 时总是选第 0 级
+    void SetErrorThreshold(float Pixels) { ErrorThreshold = Pixels; }
+    uint32_t GetLodCount() const { return LodCount; }
+
+    void BeginFrame(const FMatrix4& View, float FovY, uint32_t ViewportHeight, float NearZ);
+
+    // Indices 为 nullptr 时处理全部 Spheres.Count 个实例，否则只处理列出的 Count 个；结果按实例序号写入 OutLods
+    void Select(const FSphereArrays& Spheres, const uint32_t* Indices, uint32_t Count, FJobSystem& Jobs, uint8_t* OutLods);
+
+private:
+    uint8_t SelectOne(float X, float Y, float Z, float Radius, uint8_t Previous) const;
+
+    std::array<float, FMeshLod::MAX_COUNT> Errors{};
+    uint32_t LodCount = 1;
+    float ErrorThreshold = DEFAULT_ERROR_PIXELS;
+
+    // 本帧的相机参数
+    FVector3 Eye;
+    float ProjectionScale = 1.0f; // 距离 1 处每单位世界长度的像素数
+    float NearZ = 0.1f;
+
+    std::vector<uint8_t> PreviousLods; // 按实例序号
+};
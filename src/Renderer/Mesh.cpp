@@ -0,0 +1,221 @@
+﻿#include "Mesh.h"
+#include <bit>
+
+namespace {
+    constexpr float POSITION_QUANTIZATION_MAX = 65535.0f;
+    constexpr float NORMAL_QUANTIZATION_MAX = 32767.0f;
+
+    // 半精度：就近舍入 (平局取偶)，超出范围饱和为无穷大
+    uint16_t FloatToHalf(float Value)
+    {
+        uint32_t Bits = std::bit_cast<uint32_t>(Value);
+        const uint32_t Sign = (Bits >> 16) & 0x8000;
+        Bits &= 0x7FFFFFFF;
+
+        if (Bits >= 0x7F800000) // Inf / NaN
+        {
+            return static_cast<uint16_t>(Sign | 0x7C00 | (Bits > 0x7F800000 ? 0x200 : 0));
+        }
+        if (Bits >= 0x477FF000) // >= 65520，舍入后超出最大值 65504
+        {
+            return static_cast<uint16_t>(Sign | 0x7C00);
+        }
+        if (Bits < 0x38800000) // < 2^-14，非规格化数 (按 2^-24 为单位取整)
+        {
+            return static_cast<uint16_t>(Sign | static_cast<uint32_t>(std::nearbyint(std::bit_cast<float>(Bits) * 16777216.0f)));
+        }
+
+        // 指数偏移 127 -> 15，尾数 23 -> 10 位；进位会自然地进到指数
+        const uint32_t Rounded = Bits + 0xFFF + ((Bits >> 13) & 1);
+        return static_cast<uint16_t>(Sign | ((Rounded - 0x38000000) >> 13));
+    }
+
+    float HalfToFloat(uint16_t Value)
+    {
+        const uint32_t Sign = static_cast<uint32_t>(Value & 0x8000) << 16;
+        const uint32_t Exponent = (Value >> 10) & 0x1F;
+        const uint32_t Mantissa = Value & 0x3FF;
+
+        if (Exponent == 0)
+        {
+            const float Magnitude = static_cast<float>(Mantissa) / 16777216.0f;
+            return Sign ? -Magnitude : Magnitude;
+        }
+        if (Exponent == 0x1F)
+        {
+            return std::bit_cast<float>(Sign | 0x7F800000 | (Mantissa << 13));
+        }
+        return std::bit_cast<float>(Sign | ((Exponent + 112) << 23) | (Mantissa << 13));
+    }
+
+    int16_t QuantizeSnorm16(float Value)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(Value, -1.0f, 1.0f) * NORMAL_QUANTIZATION_MAX));
+    }
+
+    // 八面体映射：单位球投影到 |x| + |y| + |z| = 1，下半球沿对角线折到正方形的四个角
+    void EncodeOctahedral(const FVector3& Normal, int16_t Out[2])
+    {
+        const float L1 = std::abs(Normal.X) + std::abs(Normal.Y) + std::abs(Normal.Z);
+        if (L1 <= 0.0f)
+        {
+            Out[0] = 0;
+            Out[1] = 0;
+            return; // 解码为 +Z
+        }
+
+        float X = Normal.X / L1;
+        float Y = Normal.Y / L1;
+        if (Normal.Z < 0.0f)
+        {
+            const float FoldedX = (1.0f - std::abs(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+            const float FoldedY = (1.0f - std::abs(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+            X = FoldedX;
+            Y = FoldedY;
+        }
+        Out[0] = QuantizeSnorm16(X);
+        Out[1] = QuantizeSnorm16(Y);
+    }
+
+    FVector3 DecodeOctahedral(const int16_t In[2])
+    {
+        FVector3 Normal(std::max(In[0] / NORMAL_QUANTIZATION_MAX, -1.0f), std::max(In[1] / NORMAL_QUANTIZATION_MAX, -1.0f), 0.0f);
+        Normal.Z = 1.0f - std::abs(Normal.X) - std::abs(Normal.Y);
+        const float T = std::max(-Normal.Z, 0.0f);
+        Normal.X += Normal.X >= 0.0f ? -T : T;
+        Normal.Y += Normal.Y >= 0.0f ? -T : T;
+        return Normal.GetNormalized();
+    }
+}
+
+FSphere MeshUtils::ComputeBounds(const std::vector<FMeshVertex>& Vertices)
+{
+    if (Vertices.empty())
+    {
+        return {};
+    }
+
+    FVector3 Min = Vertices[0].Position;
+    FVector3 Max = Vertices[0].Position;
+    for (const FMeshVertex& Vertex : Vertices)
+    {
+        Min = { std::min(Min.X, Vertex.Position.X), std::min(Min.Y, Vertex.Position.Y), std::min(Min.Z, Vertex.Position.Z) };
+        Max = { std::max(Max.X, Vertex.Position.X), std::max(Max.Y, Vertex.Position.Y), std::max(Max.Z, Vertex.Position.Z) };
+    }
+
+    FSphere Result;
+    Result.Center = (Min + Max) * 0.5f;
+    for (const FMeshVertex& Vertex : Vertices)
+    {
+        Result.Radius = std::max(Result.Radius, (Vertex.Position - Result.Center).Length());
+    }
+    return Result;
+}
+
+FMeshData MeshUtils::CreateTorus(float MajorRadius, float MinorRadius, uint32_t MajorSegments, uint32_t MinorSegments)
+{
+    check(MajorSegments >= 3 && MinorSegments >= 3);
+
+    FMeshData Mesh;
+    // 接缝处顶点重复一份，UV 才能连续；角度按取模后的分段计算，重复顶点的位置与法线逐位相同 (简化时据此焊接)
+    Mesh.Vertices.reserve((MajorSegments + 1) * (MinorSegments + 1));
+    for (uint32_t i = 0; i <= MajorSegments; i++)
+    {
+        const float U = static_cast<float>(i) / static_cast<float>(MajorSegments);
+        const float Theta = static_cast<float>(i % MajorSegments) / static_cast<float>(MajorSegments) * 2.0f * PI;
+        const FVector3 Radial = { std::cos(Theta), std::sin(Theta), 0.0f };
+
+        for (uint32_t j = 0; j <= MinorSegments; j++)
+        {
+            const float V = static_cast<float>(j) / static_cast<float>(MinorSegments);
+            const float Phi = static_cast<float>(j % MinorSegments) / static_cast<float>(MinorSegments) * 2.0f * PI;
+            const FVector3 Normal = Radial * std::cos(Phi) + FVector3(0.0f, 0.0f, std::sin(Phi));
+
+            FMeshVertex Vertex;
+            Vertex.Position = Radial * MajorRadius + Normal * MinorRadius;
+            Vertex.Normal = Normal;
+            Vertex.U = U;
+            Vertex.V = V;
+            Mesh.Vertices.push_back(Vertex);
+        }
+    }
+
+    const uint32_t Stride = MinorSegments + 1;
+    Mesh.Indices.reserve(MajorSegments * MinorSegments * 6);
+    for (uint32_t i = 0; i < MajorSegments; i++)
+    {
+        for (uint32_t j = 0; j < MinorSegments; j++)
+        {
+            const uint32_t A = i * Stride + j;
+            const uint32_t B = (i + 1) * Stride + j;
+            const uint32_t C = (i + 1) * Stride + j + 1;
+            const uint32_t D = i * Stride + j + 1;
+            Mesh.Indices.insert(Mesh.Indices.end(), { A, B, C, A, C, D });
+        }
+    }
+
+    Mesh.Bounds = ComputeBounds(Mesh.Vertices);
+    return Mesh;
+}
+
+FPackedMeshData MeshUtils::Quantize(const std::vector<FMeshVertex>& Vertices)
+{
+    FPackedMeshData Result;
+    if (Vertices.empty())
+    {
+        return Result;
+    }
+
+    FVector3 Min = Vertices[0].Position;
+    FVector3 Max = Vertices[0].Position;
+    for (const FMeshVertex& Vertex : Vertices)
+    {
+        Min = { std::min(Min.X, Vertex.Position.X), std::min(Min.Y, Vertex.Position.Y), std::min(Min.Z, Vertex.Position.Z) };
+        Max = { std::max(Max.X, Vertex.Position.X), std::max(Max.Y, Vertex.Position.Y), std::max(Max.Z, Vertex.Position.Z) };
+    }
+
+    // 每个轴独立缩放；退化的轴 (平面网格) 编码为 0
+    const FVector3 Extent = Max - Min;
+    const FVector3 Scale = Extent * (1.0f / POSITION_QUANTIZATION_MAX);
+    const FVector3 InvScale(
+        Extent.X > 0.0f ? POSITION_QUANTIZATION_MAX / Extent.X : 0.0f,
+        Extent.Y > 0.0f ? POSITION_QUANTIZATION_MAX / Extent.Y : 0.0f,
+        Extent.Z > 0.0f ? POSITION_QUANTIZATION_MAX / Extent.Z : 0.0f);
+    Result.Quantization.PositionOffset = FVector4(Min, 0.0f);
+    Result.Quantization.PositionScale = FVector4(Scale, 0.0f);
+
+    auto QuantizeUnorm16 = [](float Value)
+        {
+            return static_cast<uint16_t>(std::lround(std::clamp(Value, 0.0f, POSITION_QUANTIZATION_MAX)));
+        };
+
+    Result.Vertices.resize(Vertices.size());
+    for (size_t i = 0; i < Vertices.size(); i++)
+    {
+        const FMeshVertex& Source = Vertices[i];
+        FPackedMeshVertex& Packed = Result.Vertices[i];
+
+        const FVector3 Relative = Source.Position - Min;
+        Packed.Position[0] = QuantizeUnorm16(Relative.X * InvScale.X);
+        Packed.Position[1] = QuantizeUnorm16(Relative.Y * InvScale.Y);
+        Packed.Position[2] = QuantizeUnorm16(Relative.Z * InvScale.Z);
+        Packed.Padding = 0;
+        EncodeOctahedral(Source.Normal, Packed.Normal);
+        Packed.UV[0] = FloatToHalf(Source.U);
+        Packed.UV[1] = FloatToHalf(Source.V);
+    }
+    return Result;
+}
+
+FMeshVertex MeshUtils::Dequantize(const FPackedMeshVertex& Vertex, const FMeshQuantization& Quantization)
+{
+    const FVector3 Offset = Quantization.PositionOffset.XYZ();
+    const FVector3 Scale = Quantization.PositionScale.XYZ();
+
+    FMeshVertex Result;
+    Result.Position = Offset + FVector3(Vertex.Position[0] * Scale.X, Vertex.Position[1] * Scale.Y, Vertex.Position[2] * Scale.Z);
+    Result.Normal = DecodeOctahedral(Vertex.Normal);
+    Result.U = HalfToFloat(Vertex.UV[0]);
+    Result.V = HalfToFloat(Vertex.UV[1]);
+    return Result;
+}
@@ -0,0 +1,63 @@
+﻿#pragma once
+#include "MathTypes.h"
+
+// 网格顶点 (导入与离线处理用的全精度格式，两个 float4，UV 拆放在 w 分量)
+struct FMeshVertex
+{
+    FVector3 Position;
+    float U = 0.0f;
+    FVector3 Normal;
+    float V = 0.0f;
+};
+static_assert(sizeof(FMeshVertex) == 32, "FMeshVertex is stored as two float4");
+
+// 量化顶点，GPU 使用的格式，布局与着色器中 FPackedMeshVertex 一致 (16 字节，FMeshVertex 的一半)
+// - 位置：相对网格 AABB 的 16 位无符号定点数，解码为 PositionOffset + q * PositionScale
+// - 法线：八面体映射到正方形后两个 16 位有符号归一化数
+// - UV：两个半精度浮点数
+struct FPackedMeshVertex
+{
+    uint16_t Position[3];
+    uint16_t Padding;
+    int16_t Normal[2];
+    uint16_t UV[2];
+};
+static_assert(sizeof(FPackedMeshVertex) == 16, "FPackedMeshVertex layout must match the shaders");
+
+// 位置解码参数 (w 未用)，整个网格共用一份
+struct FMeshQuantization
+{
+    FVector4 PositionOffset;
+    FVector4 PositionScale;
+};
+
+struct FPackedMeshData
+{
+    std::vector<FPackedMeshVertex> Vertices;
+    FMeshQuantization Quantization;
+};
+
+// 三角形列表网格 (索引 32 位，逆时针为正面)
+struct FMeshData
+{
+    std::vector<FMeshVertex> Vertices;
+    std::vector<uint32_t> Indices;
+    FSphere Bounds;
+
+    uint32_t GetTriangleCount() const { return static_cast<uint32_t>(Indices.size() / 3); }
+};
+
+namespace MeshUtils
+{
+    // 顶点的包围球 (中心取 AABB 中心)
+    FSphere ComputeBounds(const std::vector<FMeshVertex>& Vertices);
+
+    // XY 平面上的圆环 (Z 轴为对称轴)，外径 MajorRadius + MinorRadius
+    // 演示用的高面数网格：分段数越高三角形越多
+    FMeshData CreateTorus(float MajorRadius, float MinorRadius, uint32_t MajorSegments, uint32_t MinorSegments);
+
+    // 有损压缩：位置误差不超过 AABB 边长的 1/131070，法线误差约 0.01 度，UV 为半精度
+    FPackedMeshData Quantize(const std::vector<FMeshVertex>& Vertices);
+    // 与着色器中的解码一致，供 CPU 侧校验或读取
+    FMeshVertex Dequantize(const FPackedMeshVertex& Vertex, const FMeshQuantization& Quantization);
+}
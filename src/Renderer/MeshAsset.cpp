@@ -0,0 +1,195 @@
+﻿#include "MeshAsset.h"
+#include "GltfImporter.h"
+#include "MeshOptimizer.h"
+#include <bit>
+
+static_assert(std::endian::native == std::endian::little, "Mesh assets are stored little-endian and mapped without conversion");
+
+namespace {
+    constexpr uint32_t SECTION_COUNT = static_cast<uint32_t>(EMeshSection::Count);
+
+    constexpr uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+    {
+        return (Value + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    // 各段的元素大小，校验与写出共用
+    constexpr uint32_t SECTION_STRIDES[SECTION_COUNT] =
+    {
+        sizeof(FPackedMeshVertex),
+        sizeof(uint32_t),
+        sizeof(FMeshlet),
+        sizeof(uint32_t),
+        sizeof(uint32_t),
+        sizeof(FMeshLod),
+    };
+}
+
+FMeshAsset::FMeshAsset(const std::filesystem::path& Path)
+{
+    if (!File.Open(Path))
+    {
+        throw std::runtime_error("failed to open mesh asset: " + Path.string());
+    }
+    if (File.GetSize() < sizeof(FMeshAssetHeader))
+    {
+        throw std::runtime_error("failed to load mesh asset, file is truncated: " + Path.string());
+    }
+
+    Header = reinterpret_cast<const FMeshAssetHeader*>(File.GetData());
+    if (Header->Magic != MESH_ASSET_MAGIC)
+    {
+        throw std::runtime_error("failed to load mesh asset, not a .cmesh file: " + Path.string());
+    }
+    if (Header->Version != MESH_ASSET_VERSION)
+    {
+        throw std::runtime_error("failed to load mesh asset, version " + std::to_string(Header->Version) + " (expected "
+            + std::to_string(MESH_ASSET_VERSION) + "), re-import the source: " + Path.string());
+    }
+    if (Header->HeaderSize != sizeof(FMeshAssetHeader) || Header->SectionCount != SECTION_COUNT || Header->FileSize != File.GetSize())
+    {
+        throw std::runtime_error("failed to load mesh asset, header does not match the file: " + Path.string());
+    }
+
+    for (uint32_t i = 0; i < SECTION_COUNT; i++)
+    {
+        const FMeshAssetSection& Section = Header->Sections[i];
+        const bool bValid = Section.Offset % MESH_ASSET_SECTION_ALIGNMENT == 0 &&
+            Section.Stride == SECTION_STRIDES[i] &&
+            Section.Size == static_cast<uint64_t>(Section.Count) * Section.Stride &&
+            Section.Offset <= File.GetSize() && Section.Size <= File.GetSize() - Section.Offset;
+        if (!bValid)
+        {
+            throw std::runtime_error("failed to load mesh asset, section " + std::to_string(i) + " is corrupt: " + Path.string());
+        }
+    }
+
+    // 着色器按 LOD 表直接索引簇，越界的表不能交给 GPU
+    const std::span<const FMeshLod> Lods = GetSection<FMeshLod>(EMeshSection::Lods);
+    const uint32_t MeshletCount = Header->Sections[static_cast<uint32_t>(EMeshSection::Meshlets)].Count;
+    const bool bLodsValid = !Lods.empty() && Lods.size() <= FMeshLod::MAX_COUNT &&
+        std::all_of(Lods.begin(), Lods.end(), [MeshletCount](const FMeshLod& Lod)
+            {
+                return Lod.MeshletOffset <= MeshletCount && Lod.MeshletCount <= MeshletCount - Lod.MeshletOffset;
+            });
+    if (!bLodsValid)
+    {
+        throw std::runtime_error("failed to load mesh asset, LOD table is corrupt: " + Path.string());
+    }
+
+    // 各段随后被上传器从头到尾读一遍：提示内核整文件预读，避免逐页缺页
+    File.PrefetchAll();
+}
+
+FMeshletGeometry FMeshAsset::GetMeshletGeometry() const
+{
+    FMeshletGeometry Geometry;
+    Geometry.Vertices = GetSection<FPackedMeshVertex>(EMeshSection::Vertices);
+    Geometry.Quantization = Header->Quantization;
+    Geometry.Meshlets = GetSection<FMeshlet>(EMeshSection::Meshlets);
+    Geometry.MeshletVertices = GetSection<uint32_t>(EMeshSection::MeshletVertices);
+    Geometry.MeshletTriangles = GetSection<uint32_t>(EMeshSection::MeshletTriangles);
+    Geometry.Lods = GetSection<FMeshLod>(EMeshSection::Lods);
+    Geometry.Bounds = Header->Bounds;
+    Geometry.TriangleCount = Header->TriangleCount;
+    return Geometry;
+}
+
+void MeshAsset::Write(const std::filesystem::path& Path, const FMeshData& Mesh, const FPackedMeshData& PackedVertices, const FMeshletData& Meshlets)
+{
+    check(PackedVertices.Vertices.size() == Mesh.Vertices.size());
+
+    const std::span<const std::byte> Payloads[SECTION_COUNT] =
+    {
+        std::as_bytes(std::span(PackedVertices.Vertices)),
+        std::as_bytes(std::span(Mesh.Indices)),
+        std::as_bytes(std::span(Meshlets.Meshlets)),
+        std::as_bytes(std::span(Meshlets.Vertices)),
+        std::as_bytes(std::span(Meshlets.Triangles)),
+        std::as_bytes(std::span(Meshlets.Lods)),
+    };
+
+    FMeshAssetHeader Header{};
+    Header.Magic = MESH_ASSET_MAGIC;
+    Header.Version = MESH_ASSET_VERSION;
+    Header.HeaderSize = sizeof(FMeshAssetHeader);
+    Header.SectionCount = SECTION_COUNT;
+    Header.Bounds = Mesh.Bounds;
+    Header.TriangleCount = Mesh.GetTriangleCount();
+    Header.Quantization = PackedVertices.Quantization;
+
+    uint64_t Offset = sizeof(FMeshAssetHeader);
+    for (uint32_t i = 0; i < SECTION_COUNT; i++)
+    {
+        Offset = AlignUp(Offset, MESH_ASSET_SECTION_ALIGNMENT);
+        Header.Sections[i].Offset = Offset;
+        Header.Sections[i].Size = Payloads[i].size();
+        Header.Sections[i].Count = static_cast<uint32_t>(Payloads[i].size() / SECTION_STRIDES[i]);
+        Header.Sections[i].Stride = SECTION_STRIDES[i];
+        Offset += Payloads[i].size();
+    }
+    Header.FileSize = Offset;
+
+    std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+    if (!Stream.is_open())
+    {
+        throw std::runtime_error("failed to create mesh asset: " + Path.string());
+    }
+
+    const char Padding[MESH_ASSET_SECTION_ALIGNMENT] = {};
+    Stream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    uint64_t Written = sizeof(Header);
+    for (uint32_t i = 0; i < SECTION_COUNT; i++)
+    {
+        Stream.write(Padding, static_cast<std::streamsize>(Header.Sections[i].Offset - Written));
+        Stream.write(reinterpret_cast<const char*>(Payloads[i].data()), static_cast<std::streamsize>(Payloads[i].size()));
+        Written = Header.Sections[i].Offset + Payloads[i].size();
+    }
+
+    if (!Stream.good())
+    {
+        throw std::runtime_error("failed to write mesh asset: " + Path.string());
+    }
+}
+
+void MeshAsset::Cook(const std::filesystem::path& Source, const std::filesystem::path& Destination)
+{
+    const uint64_t BeginNs = Utils::GetTimeNs();
+    FMeshData Mesh = GltfImporter::Import(Source);
+    const uint64_t ImportNs = Utils::GetTimeNs();
+
+    const uint32_t SourceVertexCount = static_cast<uint32_t>(Mesh.Vertices.size());
+    const MeshOptimizer::FVertexCacheStats SourceStats = MeshOptimizer::AnalyzeVertexCache(Mesh.Indices, SourceVertexCount);
+    MeshOptimizer::Optimize(Mesh);
+    const MeshOptimizer::FVertexCacheStats OptimizedStats =
+        MeshOptimizer::AnalyzeVertexCache(Mesh.Indices, static_cast<uint32_t>(Mesh.Vertices.size()));
+    const uint64_t OptimizeNs = Utils::GetTimeNs();
+
+    const FMeshletData Meshlets = MeshletBuilder::BuildLods(Mesh);
+    const FPackedMeshData PackedVertices = MeshUtils::Quantize(Mesh.Vertices);
+    const uint64_t BuildNs = Utils::GetTimeNs();
+    Write(Destination, Mesh, PackedVertices, Meshlets);
+    const uint64_t EndNs = Utils::GetTimeNs();
+
+    CA_LOG_INFO("MeshAsset", "Cooked {} -> {}: {} vertices, {} triangles, {} meshlets in {} LODs, {} KB (import {} ms, optimize {} ms, LODs + meshlets {} ms, write {} ms).",
+        Source.string(), Destination.string(), Mesh.Vertices.size(), Mesh.GetTriangleCount(), Meshlets.GetMeshletCount(), Meshlets.Lods.size(),
+        std::filesystem::file_size(Destination) / 1024,
+        (ImportNs - BeginNs) / 1e6, (OptimizeNs - ImportNs) / 1e6, (BuildNs - OptimizeNs) / 1e6, (EndNs - BuildNs) / 1e6);
+    for (size_t i = 0; i < Meshlets.Lods.size(); i++)
+    {
+        const FMeshLod& Lod = Meshlets.Lods[i];
+        CA_LOG_INFO("MeshAsset", "LOD {}: {} triangles, {} meshlets, error {} ({}% of bounds radius).",
+            i, Lod.TriangleCount, Lod.MeshletCount, Lod.Error, Mesh.Bounds.Radius > 0.0f ? 100.0f * Lod.Error / Mesh.Bounds.Radius : 0.0f);
+    }
+
+    // 网格着色器每个簇的每个顶点变换一次：第 0 级簇顶点引用数 / 三角形数即每三角形的顶点着色次数
+    uint32_t Lod0VertexReferences = 0;
+    for (uint32_t i = 0; i < Meshlets.Lods[0].MeshletCount; i++)
+    {
+        Lod0VertexReferences += Meshlets.Meshlets[i].VertexCount;
+    }
+    CA_LOG_INFO("MeshAsset", "Vertex cache ACMR {} -> {}, ATVR {} -> {}; {} -> {} bytes per vertex ({} unused dropped); {} vertex transforms per triangle.",
+        SourceStats.ACMR, OptimizedStats.ACMR, SourceStats.ATVR, OptimizedStats.ATVR,
+        sizeof(FMeshVertex), sizeof(FPackedMeshVertex), SourceVertexCount - Mesh.Vertices.size(),
+        Mesh.GetTriangleCount() > 0 ? static_cast<float>(Lod0VertexReferences) / Mesh.GetTriangleCount() : 0.0f);
+}
@@ -0,0 +1,83 @@
+﻿#pragma once
+#include "Meshlet.h"
+#include "MappedFile.h"
+
+// 网格资源容器 (.cmesh)：导入阶段离线生成，运行时整个文件映射进内存，各段数据不经解析直接交给上传器
+// 文件布局 (小端)：
+//   [FMeshAssetHeader][填充][段 0][填充][段 1]...
+// - 每段起始按 MESH_ASSET_SECTION_ALIGNMENT (4 KB) 对齐：段首落在页边界上，映射后的指针满足任何元素类型与拷贝的对齐要求
+// - 段的元素布局与运行时结构体 (FPackedMeshVertex / FMeshlet / FMeshLod / uint32_t) 逐字节一致，加载只做 O(1) 的头部校验
+// - 导入时已完成缓存 / 过度绘制 / 读取顺序优化、LOD 简化与顶点量化，运行时不再处理
+// - 布局或元素格式变化时递增 MESH_ASSET_VERSION，旧文件被拒绝并提示重新导入
+enum class EMeshSection : uint32_t
+{
+    Vertices = 0,     // FPackedMeshVertex[]，解码参数见 FMeshAssetHeader::Quantization
+    Indices,          // uint32_t[]，三角形列表 (逆时针为正面)
+    Meshlets,         // FMeshlet[]
+    MeshletVertices,  // uint32_t[]，簇内局部顶点 -> 顶点序号
+    MeshletTriangles, // uint32_t[]，打包的簇内三角形
+    Lods,             // FMeshLod[]，由精到粗；各级的簇在 Meshlets 段中连续存放，Indices 段只含第 0 级
+    Count,
+};
+
+constexpr uint32_t MESH_ASSET_MAGIC = 0x48534D43; // "CMSH"
+constexpr uint32_t MESH_ASSET_VERSION = 3; // 2: 量化顶点，3: 离散 LOD
+constexpr uint64_t MESH_ASSET_SECTION_ALIGNMENT = 4096;
+
+struct FMeshAssetSection
+{
+    uint64_t Offset; // 相对文件开头
+    uint64_t Size;   // 字节数 (不含填充)
+    uint32_t Count;  // 元素个数
+    uint32_t Stride; // 元素字节数
+};
+
+struct FMeshAssetHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t HeaderSize;
+    uint32_t SectionCount;
+    uint64_t FileSize;
+    FSphere Bounds;
+    uint32_t TriangleCount;
+    uint32_t Reserved;
+    FMeshQuantization Quantization;
+    FMeshAssetSection Sections[static_cast<uint32_t>(EMeshSection::Count)];
+};
+static_assert(std::is_trivially_copyable_v<FMeshAssetHeader>, "FMeshAssetHeader is written to disk as raw bytes");
+static_assert(sizeof(FMeshAssetSection) == 24 && sizeof(FMeshAssetHeader) == 224, "FMeshAssetHeader layout is part of the file format");
+
+// 映射的网格资源：段数据直接指向映射内存，对象存活期间有效
+class FMeshAsset
+{
+public:
+    // 文件缺失、版本不符或头部与文件大小矛盾时抛出 std::runtime_error
+    explicit FMeshAsset(const std::filesystem::path& Path);
+
+    const FMeshAssetHeader& GetHeader() const { return *Header; }
+    size_t GetFileSize() const { return File.GetSize(); }
+
+    template<typename T>
+    std::span<const T> GetSection(EMeshSection Section) const
+    {
+        const FMeshAssetSection& Desc = Header->Sections[static_cast<uint32_t>(Section)];
+        check(Desc.Stride == sizeof(T));
+        return { reinterpret_cast<const T*>(File.GetData() + Desc.Offset), Desc.Count };
+    }
+
+    // 网格簇渲染的数据全部来自映射，不拷贝
+    FMeshletGeometry GetMeshletGeometry() const;
+
+private:
+    FMappedFile File;
+    const FMeshAssetHeader* Header = nullptr;
+};
+
+namespace MeshAsset
+{
+    void Write(const std::filesystem::path& Path, const FMeshData& Mesh, const FPackedMeshData& PackedVertices, const FMeshletData& Meshlets);
+
+    // 离线导入：glTF 2.0 (.gltf / .glb) -> 合并为一个网格 -> 重排优化 -> 简化出 LOD 链并构建簇 -> 量化 -> 写出 .cmesh
+    void Cook(const std::filesystem::path& Source, const std::filesystem::path& Destination);
+}
@@ -0,0 +1,395 @@
+﻿#include "MeshOptimizer.h"
+
+namespace {
+    constexpr uint32_t INVALID_INDEX = ~0u;
+
+    // Forsyth 算法参数 (原文推荐值)
+    constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+    constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+    constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+    constexpr uint32_t FORSYTH_VALENCE_TABLE_SIZE = 32;
+
+    // 过度绘制重排时模拟的缓存大小 (与常见硬件的后变换缓存相当)
+    constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+    // 顶点 -> 使用它的三角形 (CSR 存储)；Live 个之前的是尚未输出的三角形
+    struct FVertexTriangles
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Triangles;
+        std::vector<uint32_t> Live;
+    };
+
+    FVertexTriangles BuildVertexTriangles(std::span<const uint32_t> Indices, uint32_t VertexCount)
+    {
+        FVertexTriangles Result;
+        Result.Offsets.assign(VertexCount + 1, 0);
+        Result.Live.assign(VertexCount, 0);
+        for (uint32_t Index : Indices)
+        {
+            Result.Live[Index]++;
+        }
+        for (uint32_t i = 0; i < VertexCount; i++)
+        {
+            Result.Offsets[i + 1] = Result.Offsets[i] + Result.Live[i];
+        }
+
+        std::vector<uint32_t> Cursor(Result.Offsets.begin(), Result.Offsets.end() - 1);
+        Result.Triangles.resize(Indices.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(Indices.size()); i++)
+        {
+            Result.Triangles[Cursor[Indices[i]]++] = i / 3;
+        }
+        return Result;
+    }
+
+    // FIFO 缓存模拟：时间戳相差不超过缓存大小即命中；时间戳整体前移即清空缓存
+    class FFifoCache
+    {
+    public:
+        FFifoCache(uint32_t VertexCount, uint32_t InCacheSize)
+            : Timestamps(VertexCount, 0), CacheSize(InCacheSize), Time(InCacheSize + 1) {}
+
+        // 返回三角形的未命中数
+        uint32_t AddTriangle(const uint32_t* Corners)
+        {
+            uint32_t Misses = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                if (Time - Timestamps[Corners[k]] > CacheSize)
+                {
+                    Timestamps[Corners[k]] = Time++;
+                    Misses++;
+                }
+            }
+            return Misses;
+        }
+
+        void Clear() { Time += CacheSize + 1; }
+
+    private:
+        std::vector<uint32_t> Timestamps;
+        const uint32_t CacheSize;
+        uint32_t Time;
+    };
+
+    struct FForsythScores
+    {
+        std::array<float, FORSYTH_CACHE_SIZE> Cache;
+        std::array<float, FORSYTH_VALENCE_TABLE_SIZE> Valence;
+
+        FForsythScores()
+        {
+            for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++)
+            {
+                // 刚用过的三个顶点固定分数，避免总是沿着同一条边生成狭长的三角形带
+                Cache[i] = i < 3 ? FORSYTH_LAST_TRIANGLE_SCORE
+                    : std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+            }
+            for (uint32_t i = 0; i < FORSYTH_VALENCE_TABLE_SIZE; i++)
+            {
+                Valence[i] = ValenceScore(i);
+            }
+        }
+
+        // 剩余三角形越少分数越高：优先收尾快用完的顶点，避免它们滞留到缓存之外
+        static float ValenceScore(uint32_t LiveTriangles)
+        {
+            return LiveTriangles == 0 ? 0.0f
+                : FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(LiveTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+        }
+
+        float Get(uint32_t CachePosition, uint32_t LiveTriangles) const
+        {
+            if (LiveTriangles == 0)
+            {
+                return -1.0f;
+            }
+            const float CacheScore = CachePosition < FORSYTH_CACHE_SIZE ? Cache[CachePosition] : 0.0f;
+            return CacheScore + (LiveTriangles < FORSYTH_VALENCE_TABLE_SIZE ? Valence[LiveTriangles] : ValenceScore(LiveTriangles));
+        }
+    };
+}
+
+MeshOptimizer::FVertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> Indices, uint32_t VertexCount, uint32_t CacheSize)
+{
+    FVertexCacheStats Stats;
+    if (Indices.empty() || VertexCount == 0)
+    {
+        return Stats;
+    }
+
+    FFifoCache Cache(VertexCount, CacheSize);
+    uint64_t Misses = 0;
+    for (size_t i = 0; i + 2 < Indices.size(); i += 3)
+    {
+        Misses += Cache.AddTriangle(&Indices[i]);
+    }
+
+    Stats.ACMR = static_cast<float>(Misses) / static_cast<float>(Indices.size() / 3);
+    Stats.ATVR = static_cast<float>(Misses) / static_cast<float>(VertexCount);
+    return Stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& Indices, uint32_t VertexCount)
+{
+    const uint32_t TriangleCount = static_cast<uint32_t>(Indices.size() / 3);
+    if (TriangleCount == 0)
+    {
+        return;
+    }
+
+    static const FForsythScores Scores;
+    FVertexTriangles Adjacency = BuildVertexTriangles(Indices, VertexCount);
+
+    std::vector<uint32_t> CachePositions(VertexCount, INVALID_INDEX);
+    std::vector<float> VertexScores(VertexCount);
+    for (uint32_t v = 0; v < VertexCount; v++)
+    {
+        VertexScores[v] = Scores.Get(INVALID_INDEX, Adjacency.Live[v]);
+    }
+
+    std::vector<float> TriangleScores(TriangleCount);
+    for (uint32_t t = 0; t < TriangleCount; t++)
+    {
+        TriangleScores[t] = VertexScores[Indices[t * 3]] + VertexScores[Indices[t * 3 + 1]] + VertexScores[Indices[t * 3 + 2]];
+    }
+
+    std::vector<bool> Emitted(TriangleCount, false);
+    std::vector<uint32_t> Output;
+    Output.reserve(Indices.size());
+
+    // 缓存多留 3 个位置给新三角形挤出的顶点，它们的分数也要更新
+    std::array<uint32_t, FORSYTH_CACHE_SIZE + 3> Cache;
+    std::array<uint32_t, FORSYTH_CACHE_SIZE + 3> NextCache;
+    uint32_t CacheCount = 0;
+
+    uint32_t Best = static_cast<uint32_t>(std::max_element(TriangleScores.begin(), TriangleScores.end()) - TriangleScores.begin());
+    uint32_t SeedCursor = 0;
+    for (uint32_t Emit = 0; Emit < TriangleCount; Emit++)
+    {
+        // 缓存中的顶点都没有剩余三角形时 (孤立部件用完)，按原顺序取下一个未输出的三角形
+        if (Best == INVALID_INDEX)
+        {
+            while (Emitted[SeedCursor])
+            {
+                SeedCursor++;
+            }
+            Best = SeedCursor;
+        }
+
+        const uint32_t* Corners = &Indices[Best * 3];
+        Output.insert(Output.end(), Corners, Corners + 3);
+        Emitted[Best] = true;
+
+        // 1. 从三个顶点的剩余列表中移除该三角形
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            const uint32_t Vertex = Corners[k];
+            uint32_t* Begin = &Adjacency.Triangles[Adjacency.Offsets[Vertex]];
+            uint32_t* End = Begin + Adjacency.Live[Vertex];
+            uint32_t* Found = std::find(Begin, End, Best);
+            check(Found != End);
+            std::swap(*Found, *(End - 1));
+            Adjacency.Live[Vertex]--;
+        }
+
+        // 2. LRU：新三角形的顶点移到最前，其余依次后移
+        uint32_t NextCount = 0;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            NextCache[NextCount++] = Corners[k];
+        }
+        for (uint32_t i = 0; i < CacheCount; i++)
+        {
+            const uint32_t Vertex = Cache[i];
+            if (Vertex != Corners[0] && Vertex != Corners[1] && Vertex != Corners[2])
+            {
+                NextCache[NextCount++] = Vertex;
+            }
+        }
+
+        // 3. 更新缓存内 (以及刚被挤出) 顶点的分数，再把分数变化传给它们的剩余三角形
+        for (uint32_t i = 0; i < NextCount; i++)
+        {
+            const uint32_t Vertex = NextCache[i];
+            CachePositions[Vertex] = i < FORSYTH_CACHE_SIZE ? i : INVALID_INDEX;
+            const float NewScore = Scores.Get(CachePositions[Vertex], Adjacency.Live[Vertex]);
+            const float Delta = NewScore - VertexScores[Vertex];
+            VertexScores[Vertex] = NewScore;
+
+            for (uint32_t a = 0; a < Adjacency.Live[Vertex]; a++)
+            {
+                TriangleScores[Adjacency.Triangles[Adjacency.Offsets[Vertex] + a]] += Delta;
+            }
+        }
+
+        // 4. 下一个三角形只在缓存内顶点的剩余三角形中挑选
+        Best = INVALID_INDEX;
+        float BestScore = -1.0f;
+        CacheCount = std::min(NextCount, FORSYTH_CACHE_SIZE);
+        for (uint32_t i = 0; i < CacheCount; i++)
+        {
+            const uint32_t Vertex = NextCache[i];
+            Cache[i] = Vertex;
+            for (uint32_t a = 0; a < Adjacency.Live[Vertex]; a++)
+            {
+                const uint32_t Triangle = Adjacency.Triangles[Adjacency.Offsets[Vertex] + a];
+                if (TriangleScores[Triangle] > BestScore)
+                {
+                    Best = Triangle;
+                    BestScore = TriangleScores[Triangle];
+                }
+            }
+        }
+    }
+
+    Indices.swap(Output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& Indices, const std::vector<FMeshVertex>& Vertices, float Threshold)
+{
+    const uint32_t TriangleCount = static_cast<uint32_t>(Indices.size() / 3);
+    const uint32_t VertexCount = static_cast<uint32_t>(Vertices.size());
+    if (TriangleCount == 0)
+    {
+        return;
+    }
+
+    FFifoCache Cache(VertexCount, OVERDRAW_CACHE_SIZE);
+
+    // 1. 硬边界：三个顶点全部未命中处，缓存优化的序列在这里本来就断开了，切开不损失缓存效率
+    std::vector<uint32_t> HardBoundaries;
+    for (uint32_t t = 0; t < TriangleCount; t++)
+    {
+        if (Cache.AddTriangle(&Indices[t * 3]) == 3 || t == 0)
+        {
+            HardBoundaries.push_back(t);
+        }
+    }
+    HardBoundaries.push_back(TriangleCount);
+
+    // 2. 软边界：在硬簇内部，前缀的 ACMR 不超过整簇的 Threshold 倍时继续切分 (簇越小，排序越接近逐三角形的理想顺序)
+    std::vector<uint32_t> Boundaries;
+    for (size_t c = 0; c + 1 < HardBoundaries.size(); c++)
+    {
+        const uint32_t Begin = HardBoundaries[c];
+        const uint32_t End = HardBoundaries[c + 1];
+
+        Cache.Clear();
+        uint32_t ClusterMisses = 0;
+        for (uint32_t t = Begin; t < End; t++)
+        {
+            ClusterMisses += Cache.AddTriangle(&Indices[t * 3]);
+        }
+        const float ClusterACMR = static_cast<float>(ClusterMisses) / static_cast<float>(End - Begin);
+
+        Cache.Clear();
+        uint32_t Start = Begin;
+        uint32_t Misses = 0;
+        Boundaries.push_back(Begin);
+        for (uint32_t t = Begin; t < End; t++)
+        {
+            Misses += Cache.AddTriangle(&Indices[t * 3]);
+            if (t + 1 < End && static_cast<float>(Misses) <= Threshold * ClusterACMR * static_cast<float>(t + 1 - Start))
+            {
+                Start = t + 1;
+                Misses = 0;
+                Cache.Clear();
+                Boundaries.push_back(Start);
+            }
+        }
+    }
+    Boundaries.push_back(TriangleCount);
+
+    // 3. 每个簇的面积加权质心与平均法线；排序键 = 簇质心相对网格质心沿簇法线的距离，越大越朝外
+    struct FCluster
+    {
+        uint32_t Begin;
+        uint32_t End;
+        float SortKey;
+    };
+    std::vector<FCluster> Clusters(Boundaries.size() - 1);
+    std::vector<FVector3> Centroids(Clusters.size());
+    std::vector<FVector3> Normals(Clusters.size());
+
+    FVector3 MeshCentroid;
+    float MeshArea = 0.0f;
+    for (size_t c = 0; c < Clusters.size(); c++)
+    {
+        Clusters[c].Begin = Boundaries[c];
+        Clusters[c].End = Boundaries[c + 1];
+
+        FVector3 WeightedCentroid;
+        FVector3 NormalSum;
+        float Area = 0.0f;
+        for (uint32_t t = Clusters[c].Begin; t < Clusters[c].End; t++)
+        {
+            const FVector3& P0 = Vertices[Indices[t * 3]].Position;
+            const FVector3& P1 = Vertices[Indices[t * 3 + 1]].Position;
+            const FVector3& P2 = Vertices[Indices[t * 3 + 2]].Position;
+
+            const FVector3 Normal = FVector3::Cross(P1 - P0, P2 - P0); // 长度为面积的两倍
+            const float TriangleArea = Normal.Length();
+            WeightedCentroid = WeightedCentroid + (P0 + P1 + P2) * (TriangleArea / 3.0f);
+            NormalSum = NormalSum + Normal;
+            Area += TriangleArea;
+        }
+
+        Centroids[c] = Area > 0.0f ? WeightedCentroid * (1.0f / Area) : Vertices[Indices[Clusters[c].Begin * 3]].Position;
+        Normals[c] = NormalSum.GetNormalized();
+        MeshCentroid = MeshCentroid + WeightedCentroid;
+        MeshArea += Area;
+    }
+    MeshCentroid = MeshArea > 0.0f ? MeshCentroid * (1.0f / MeshArea) : FVector3();
+
+    for (size_t c = 0; c < Clusters.size(); c++)
+    {
+        Clusters[c].SortKey = FVector3::Dot(Centroids[c] - MeshCentroid, Normals[c]);
+    }
+
+    // 4. 朝外的簇先画；稳定排序让键相同的簇保持缓存优化后的相对顺序
+    std::stable_sort(Clusters.begin(), Clusters.end(), [](const FCluster& A, const FCluster& B) { return A.SortKey > B.SortKey; });
+
+    std::vector<uint32_t> Output;
+    Output.reserve(Indices.size());
+    for (const FCluster& Cluster : Clusters)
+    {
+        Output.insert(Output.end(), Indices.begin() + Cluster.Begin * 3, Indices.begin() + Cluster.End * 3);
+    }
+    Indices.swap(Output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(FMeshData& Mesh)
+{
+    std::vector<uint32_t> Remap(Mesh.Vertices.size(), INVALID_INDEX);
+    std::vector<FMeshVertex> Vertices;
+    Vertices.reserve(Mesh.Vertices.size());
+
+    for (uint32_t& Index : Mesh.Indices)
+    {
+        if (Remap[Index] == INVALID_INDEX)
+        {
+            Remap[Index] = static_cast<uint32_t>(Vertices.size());
+            Vertices.push_back(Mesh.Vertices[Index]);
+        }
+        Index = Remap[Index];
+    }
+
+    // 丢弃了未引用的顶点，包围球可能变小
+    const bool bDroppedVertices = Vertices.size() != Mesh.Vertices.size();
+    Mesh.Vertices.swap(Vertices);
+    if (bDroppedVertices)
+    {
+        Mesh.Bounds = MeshUtils::ComputeBounds(Mesh.Vertices);
+    }
+}
+
+void MeshOptimizer::Optimize(FMeshData& Mesh)
+{
+    OptimizeVertexCache(Mesh.Indices, static_cast<uint32_t>(Mesh.Vertices.size()));
+    OptimizeOverdraw(Mesh.Indices, Mesh.Vertices);
+    OptimizeVertexFetch(Mesh);
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+#include "Mesh.h"
+
+// 导入阶段的网格优化，只改变三角形与顶点的顺序，不改变几何
+// 推荐顺序：顶点缓存 -> 过度绘制 -> 顶点读取 (后一步以前一步的结果为输入，尽量保留其收益)
+namespace MeshOptimizer
+{
+    // 按 FIFO 顶点缓存模拟：ACMR 为平均每三角形的未命中数 (下限约 0.5)，ATVR 为平均每顶点的变换次数 (下限 1)
+    struct FVertexCacheStats
+    {
+        float ACMR = 0.0f;
+        float ATVR = 0.0f;
+    };
+
+    FVertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> Indices, uint32_t VertexCount, uint32_t CacheSize = 16);
+
+    // 1. 顶点缓存局部性 (Forsyth 线性算法)：每步输出打分最高的三角形，分数来自顶点在模拟 LRU 缓存中的位置与剩余三角形数
+    void OptimizeVertexCache(std::vector<uint32_t>& Indices, uint32_t VertexCount);
+
+    // 2. 过度绘制 (Sander 等人的快速重排)：把缓存优化后的序列切成簇，簇的 ACMR 不超过整段的 Threshold 倍，
+    //    再按簇朝外的程度排序，先画的簇更可能遮挡后画的簇
+    void OptimizeOverdraw(std::vector<uint32_t>& Indices, const std::vector<FMeshVertex>& Vertices, float Threshold = 1.05f);
+
+    // 3. 顶点读取局部性：顶点按首次被引用的顺序重排，未被引用的顶点丢弃
+    void OptimizeVertexFetch(FMeshData& Mesh);
+
+    // 依次执行以上三步
+    void Optimize(FMeshData& Mesh);
+}
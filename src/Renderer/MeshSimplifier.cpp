@@ -0,0 +1,474 @@
+﻿#include "MeshSimplifier.h"
+
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+namespace {
+    constexpr uint32_t INVALID_VERTEX = ~0u;
+    // 边界与接缝约束平面的权重：垂直于表面移动轮廓的代价是普通平面的这么多倍
+    constexpr double CONSTRAINT_WEIGHT = 4.0;
+    // 折叠后相邻三角形法线与原法线夹角的余弦不能低于该值，否则视为翻转
+    constexpr float FLIP_THRESHOLD = 0.0f;
+    // 出堆时代价比入堆时变大超过该比例即视为过期，按新代价重新入堆
+    constexpr double STALE_TOLERANCE = 1e-6;
+
+    // Q(p) = p^T A p + 2 B·p + C，A 对称只存上三角；双精度避免大量平面累加后抵消误差
+    struct FQuadric
+    {
+        double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+        double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+        double C = 0.0;
+
+        // 平面 dot(N, p) + D = 0 (N 为单位向量) 的距离平方
+        void AddPlane(const FVector3& N, float D, double Weight)
+        {
+            const double X = N.X, Y = N.Y, Z = N.Z;
+            A00 += Weight * X * X; A01 += Weight * X * Y; A02 += Weight * X * Z;
+            A11 += Weight * Y * Y; A12 += Weight * Y * Z; A22 += Weight * Z * Z;
+            B0 += Weight * X * D; B1 += Weight * Y * D; B2 += Weight * Z * D;
+            C += Weight * D * D;
+        }
+
+        void Add(const FQuadric& Other)
+        {
+            A00 += Other.A00; A01 += Other.A01; A02 += Other.A02;
+            A11 += Other.A11; A12 += Other.A12; A22 += Other.A22;
+            B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+            C += Other.C;
+        }
+
+        double Evaluate(const FVector3& P) const
+        {
+            const double X = P.X, Y = P.Y, Z = P.Z;
+            const double Result = A00 * X * X + A11 * Y * Y + A22 * Z * Z
+                + 2.0 * (A01 * X * Y + A02 * X * Z + A12 * Y * Z)
+                + 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+            return std::max(Result, 0.0); // 舍入可能得到很小的负数
+        }
+    };
+
+    // 候选折叠 From -> To；小顶堆，出堆时用当前二次误差复核
+    struct FCollapse
+    {
+        double Cost;
+        uint32_t From;
+        uint32_t To;
+
+        bool operator>(const FCollapse& Other) const { return Cost > Other.Cost; }
+    };
+
+    // 折叠时 From 的每个属性副本 (物理顶点) 改指向的 To 的副本
+    struct FCopyRemap
+    {
+        uint32_t From;
+        uint32_t To;
+    };
+
+    class FSimplifier
+    {
+    public:
+        FSimplifier(const std::vector<FMeshVertex>& InVertices, std::span<const uint32_t> Indices)
+            : Vertices(InVertices)
+        {
+            WeldPositions();
+
+            // 丢弃位置重合的退化三角形，其余的登记到焊接后的顶点上
+            Corners.reserve(Indices.size());
+            for (size_t i = 0; i + 2 < Indices.size(); i += 3)
+            {
+                const uint32_t A = Canonical[Indices[i]], B = Canonical[Indices[i + 1]], C = Canonical[Indices[i + 2]];
+                if (A != B && B != C && C != A)
+                {
+                    Corners.insert(Corners.end(), { Indices[i], Indices[i + 1], Indices[i + 2] });
+                }
+            }
+            const uint32_t TriangleCount = static_cast<uint32_t>(Corners.size() / 3);
+            LiveTriangleCount = TriangleCount;
+            TriangleAlive.assign(TriangleCount, true);
+            VertexTriangles.resize(Vertices.size());
+            for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+            {
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    VertexTriangles[GetCorner(Triangle, k)].push_back(Triangle);
+                }
+            }
+
+            BuildQuadrics();
+        }
+
+        std::vector<uint32_t> Run(uint32_t TargetTriangleCount, float MaxError, float& OutError)
+        {
+            const double MaxCost = static_cast<double>(MaxError) * MaxError;
+            double AppliedCost = 0.0;
+
+            while (LiveTriangleCount > TargetTriangleCount && !Heap.empty())
+            {
+                const FCollapse Candidate = Heap.top();
+                Heap.pop();
+                if (!VertexAlive[Candidate.From] || !VertexAlive[Candidate.To])
+                {
+                    continue;
+                }
+
+                // 入堆后两端的二次误差可能已经累加了别的折叠，代价变大时重新排队
+                const double Cost = ComputeCost(Candidate.From, Candidate.To);
+                if (Cost > Candidate.Cost * (1.0 + STALE_TOLERANCE))
+                {
+                    Heap.push({ Cost, Candidate.From, Candidate.To });
+                    continue;
+                }
+                if (Cost > MaxCost)
+                {
+                    break;
+                }
+                if (!TryCollapse(Candidate.From, Candidate.To))
+                {
+                    continue;
+                }
+                AppliedCost = std::max(AppliedCost, Cost);
+            }
+
+            OutError = static_cast<float>(std::sqrt(AppliedCost));
+
+            std::vector<uint32_t> Result;
+            Result.reserve(static_cast<size_t>(LiveTriangleCount) * 3);
+            for (uint32_t Triangle = 0; Triangle < static_cast<uint32_t>(TriangleAlive.size()); Triangle++)
+            {
+                if (TriangleAlive[Triangle])
+                {
+                    Result.insert(Result.end(), Corners.begin() + Triangle * 3, Corners.begin() + Triangle * 3 + 3);
+                }
+            }
+            return Result;
+        }
+
+    private:
+        // 位置完全相同的顶点焊接为一个 (取序号最小的为代表)，简化只在代表上进行
+        void WeldPositions()
+        {
+            const uint32_t VertexCount = static_cast<uint32_t>(Vertices.size());
+            std::vector<uint32_t> Order(VertexCount);
+            std::iota(Order.begin(), Order.end(), 0u);
+            auto Key = [this](uint32_t Index)
+                {
+                    const FVector3& P = Vertices[Index].Position;
+                    return std::make_tuple(P.X, P.Y, P.Z, Index);
+                };
+            std::sort(Order.begin(), Order.end(), [&Key](uint32_t A, uint32_t B) { return Key(A) < Key(B); });
+
+            Canonical.resize(VertexCount);
+            for (uint32_t i = 0; i < VertexCount; i++)
+            {
+                const FVector3& P = Vertices[Order[i]].Position;
+                const bool bSame = i > 0 && P.X == Vertices[Order[i - 1]].Position.X &&
+                    P.Y == Vertices[Order[i - 1]].Position.Y && P.Z == Vertices[Order[i - 1]].Position.Z;
+                Canonical[Order[i]] = bSame ? Canonical[Order[i - 1]] : Order[i];
+            }
+            VertexAlive.assign(VertexCount, true);
+        }
+
+        void BuildQuadrics()
+        {
+            const uint32_t TriangleCount = static_cast<uint32_t>(TriangleAlive.size());
+            Quadrics.assign(Vertices.size(), FQuadric{});
+
+            // 1. 每个三角形所在平面累加到三个顶点
+            std::vector<FVector3> FaceNormals(TriangleCount);
+            for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+            {
+                const FVector3& P0 = GetPosition(GetCorner(Triangle, 0));
+                const FVector3 Normal = FVector3::Cross(GetPosition(GetCorner(Triangle, 1)) - P0, GetPosition(GetCorner(Triangle, 2)) - P0);
+                if (Normal.Length() <= 0.0f)
+                {
+                    continue; // 共线三角形没有确定的平面
+                }
+                FaceNormals[Triangle] = Normal.GetNormalized();
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    Quadrics[GetCorner(Triangle, k)].AddPlane(FaceNormals[Triangle], -FVector3::Dot(FaceNormals[Triangle], P0), 1.0);
+                }
+            }
+
+            // 2. 按焊接后的无向边分组：只属于一个三角形的是开放边界，两侧物理顶点不同的是属性接缝
+            //    两者都在边上加一个垂直于表面的约束平面，阻止轮廓向内外收缩
+            struct FEdgeUse
+            {
+                uint64_t Key;
+                uint32_t Triangle;
+                uint32_t Corner;
+            };
+            std::vector<FEdgeUse> Edges;
+            Edges.reserve(static_cast<size_t>(TriangleCount) * 3);
+            for (uint32_t Triangle = 0; Triangle < TriangleCount; Triangle++)
+            {
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    const uint32_t A = GetCorner(Triangle, k);
+                    const uint32_t B = GetCorner(Triangle, (k + 1) % 3);
+                    Edges.push_back({ static_cast<uint64_t>(std::min(A, B)) << 32 | std::max(A, B), Triangle, k });
+                }
+            }
+            std::sort(Edges.begin(), Edges.end(), [](const FEdgeUse& L, const FEdgeUse& R) { return L.Key < R.Key; });
+
+            auto PhysicalPair = [this](const FEdgeUse& Use)
+                {
+                    const uint32_t A = Corners[Use.Triangle * 3 + Use.Corner];
+                    const uint32_t B = Corners[Use.Triangle * 3 + (Use.Corner + 1) % 3];
+                    return Canonical[A] < Canonical[B] ? std::make_pair(A, B) : std::make_pair(B, A);
+                };
+            auto AddConstraint = [&](const FEdgeUse& Use)
+                {
+                    const uint32_t A = GetCorner(Use.Triangle, Use.Corner);
+                    const uint32_t B = GetCorner(Use.Triangle, (Use.Corner + 1) % 3);
+                    const FVector3 Normal = FVector3::Cross(GetPosition(B) - GetPosition(A), FaceNormals[Use.Triangle]);
+                    if (Normal.Length() <= 0.0f)
+                    {
+                        return;
+                    }
+                    const FVector3 N = Normal.GetNormalized();
+                    const float D = -FVector3::Dot(N, GetPosition(A));
+                    Quadrics[A].AddPlane(N, D, CONSTRAINT_WEIGHT);
+                    Quadrics[B].AddPlane(N, D, CONSTRAINT_WEIGHT);
+                };
+
+            for (size_t Begin = 0; Begin < Edges.size();)
+            {
+                size_t End = Begin + 1;
+                while (End < Edges.size() && Edges[End].Key == Edges[Begin].Key)
+                {
+                    End++;
+                }
+                if (End - Begin == 1 || (End - Begin == 2 && PhysicalPair(Edges[Begin]) != PhysicalPair(Edges[Begin + 1])))
+                {
+                    for (size_t i = Begin; i < End; i++)
+                    {
+                        AddConstraint(Edges[i]);
+                    }
+                }
+                Begin = End;
+            }
+
+            // 3. 每条边两个方向都作为候选；同一条边的两个使用者只入堆一次
+            std::vector<FCollapse> Initial;
+            Initial.reserve(Edges.size());
+            for (size_t i = 0; i < Edges.size(); i++)
+            {
+                if (i > 0 && Edges[i].Key == Edges[i - 1].Key)
+                {
+                    continue;
+                }
+                const uint32_t A = static_cast<uint32_t>(Edges[i].Key >> 32);
+                const uint32_t B = static_cast<uint32_t>(Edges[i].Key);
+                Initial.push_back({ ComputeCost(A, B), A, B });
+                Initial.push_back({ ComputeCost(B, A), B, A });
+            }
+            Heap = decltype(Heap)(std::greater<FCollapse>(), std::move(Initial));
+        }
+
+        uint32_t GetCorner(uint32_t Triangle, uint32_t k) const { return Canonical[Corners[Triangle * 3 + k]]; }
+        const FVector3& GetPosition(uint32_t Vertex) const { return Vertices[Vertex].Position; }
+
+        double ComputeCost(uint32_t From, uint32_t To) const
+        {
+            FQuadric Sum = Quadrics[From];
+            Sum.Add(Quadrics[To]);
+            return Sum.Evaluate(GetPosition(To));
+        }
+
+        // 只保留存活三角形，顺带收集相邻顶点 (可能重复)
+        void GatherNeighbors(uint32_t Vertex, std::vector<uint32_t>& OutNeighbors)
+        {
+            std::vector<uint32_t>& Triangles = VertexTriangles[Vertex];
+            std::erase_if(Triangles, [this](uint32_t Triangle) { return !TriangleAlive[Triangle]; });
+            OutNeighbors.clear();
+            for (uint32_t Triangle : Triangles)
+            {
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    if (GetCorner(Triangle, k) != Vertex)
+                    {
+                        OutNeighbors.push_back(GetCorner(Triangle, k));
+                    }
+                }
+            }
+            std::sort(OutNeighbors.begin(), OutNeighbors.end());
+        }
+
+        bool TryCollapse(uint32_t From, uint32_t To)
+        {
+            GatherNeighbors(From, FromNeighbors);
+            GatherNeighbors(To, ToNeighbors);
+
+            // 1. 拓扑：边必须存在且至多属于两个三角形；From 在开放边界上时只能沿边界边折叠 (轮廓不缩进)
+            const auto SharedCount = std::count(FromNeighbors.begin(), FromNeighbors.end(), To);
+            if (SharedCount == 0 || SharedCount > 2)
+            {
+                return false;
+            }
+            bool bFromOnBorder = false;
+            for (size_t i = 0; i < FromNeighbors.size();)
+            {
+                size_t End = i + 1;
+                while (End < FromNeighbors.size() && FromNeighbors[End] == FromNeighbors[i])
+                {
+                    End++;
+                }
+                bFromOnBorder |= End - i == 1;
+                i = End;
+            }
+            if (bFromOnBorder && SharedCount != 1)
+            {
+                return false;
+            }
+
+            // 连接条件：两端共同的邻居只能是边两侧三角形的第三个顶点，否则折叠后出现非流形的重复边
+            uint32_t CommonCount = 0;
+            for (size_t i = 0, j = 0; i < FromNeighbors.size() && j < ToNeighbors.size();)
+            {
+                if (FromNeighbors[i] < ToNeighbors[j]) { i++; }
+                else if (FromNeighbors[i] > ToNeighbors[j]) { j++; }
+                else
+                {
+                    const uint32_t Shared = FromNeighbors[i];
+                    CommonCount += Shared != From && Shared != To ? 1 : 0;
+                    while (i < FromNeighbors.size() && FromNeighbors[i] == Shared) { i++; }
+                    while (j < ToNeighbors.size() && ToNeighbors[j] == Shared) { j++; }
+                }
+            }
+            if (CommonCount != SharedCount)
+            {
+                return false;
+            }
+
+            // 2. 属性：From 的每个副本都要在被删除的三角形里找到对应的 To 副本，
+            //    找不到 (接缝交汇处、或沿非接缝边折叠接缝顶点) 就会撕开接缝，拒绝
+            Remaps.clear();
+            for (uint32_t Triangle : VertexTriangles[From])
+            {
+                uint32_t FromCopy = INVALID_VERTEX;
+                uint32_t ToCopy = INVALID_VERTEX;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    const uint32_t Corner = Triangle * 3 + k;
+                    FromCopy = Canonical[Corners[Corner]] == From ? Corners[Corner] : FromCopy;
+                    ToCopy = Canonical[Corners[Corner]] == To ? Corners[Corner] : ToCopy;
+                }
+                if (ToCopy == INVALID_VERTEX)
+                {
+                    continue;
+                }
+                const auto Existing = std::find_if(Remaps.begin(), Remaps.end(), [FromCopy](const FCopyRemap& Remap) { return Remap.From == FromCopy; });
+                if (Existing == Remaps.end())
+                {
+                    Remaps.push_back({ FromCopy, ToCopy });
+                }
+                else if (Existing->To != ToCopy)
+                {
+                    return false;
+                }
+            }
+
+            // 3. 几何：保留下来的三角形 From 角移到 To 后不能翻面或退化
+            for (uint32_t Triangle : VertexTriangles[From])
+            {
+                bool bHasTo = false;
+                uint32_t FromSlot = 0;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    bHasTo |= GetCorner(Triangle, k) == To;
+                    FromSlot = GetCorner(Triangle, k) == From ? k : FromSlot;
+                }
+                if (bHasTo)
+                {
+                    continue;
+                }
+
+                const uint32_t FromCopy = Corners[Triangle * 3 + FromSlot];
+                if (std::none_of(Remaps.begin(), Remaps.end(), [FromCopy](const FCopyRemap& Remap) { return Remap.From == FromCopy; }))
+                {
+                    return false;
+                }
+
+                const FVector3& P1 = GetPosition(GetCorner(Triangle, (FromSlot + 1) % 3));
+                const FVector3& P2 = GetPosition(GetCorner(Triangle, (FromSlot + 2) % 3));
+                const FVector3 OldNormal = FVector3::Cross(P1 - GetPosition(From), P2 - GetPosition(From));
+                const FVector3 NewNormal = FVector3::Cross(P1 - GetPosition(To), P2 - GetPosition(To));
+                if (FVector3::Dot(OldNormal, NewNormal) <= FLIP_THRESHOLD * OldNormal.Length() * NewNormal.Length() ||
+                    NewNormal.Length() <= 0.0f)
+                {
+                    return false;
+                }
+            }
+
+            // 4. 执行：含这条边的三角形删除，其余的 From 角改指 To 的对应副本
+            for (uint32_t Triangle : VertexTriangles[From])
+            {
+                bool bHasTo = false;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    bHasTo |= GetCorner(Triangle, k) == To;
+                }
+                if (bHasTo)
+                {
+                    TriangleAlive[Triangle] = false;
+                    LiveTriangleCount--;
+                    continue;
+                }
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    uint32_t& Corner = Corners[Triangle * 3 + k];
+                    if (Canonical[Corner] == From)
+                    {
+                        Corner = std::find_if(Remaps.begin(), Remaps.end(), [Corner](const FCopyRemap& Remap) { return Remap.From == Corner; })->To;
+                    }
+                }
+                VertexTriangles[To].push_back(Triangle);
+            }
+            VertexTriangles[From].clear();
+            VertexTriangles[From].shrink_to_fit();
+            VertexAlive[From] = false;
+            Quadrics[To].Add(Quadrics[From]);
+
+            // 5. To 周围的边代价都变了，两个方向重新入堆 (旧条目出堆时按过期处理)
+            GatherNeighbors(To, ToNeighbors);
+            ToNeighbors.erase(std::unique(ToNeighbors.begin(), ToNeighbors.end()), ToNeighbors.end());
+            for (uint32_t Neighbor : ToNeighbors)
+            {
+                Heap.push({ ComputeCost(Neighbor, To), Neighbor, To });
+                Heap.push({ ComputeCost(To, Neighbor), To, Neighbor });
+            }
+            return true;
+        }
+
+        const std::vector<FMeshVertex>& Vertices;
+        std::vector<uint32_t> Canonical;   // 物理顶点 -> 焊接后的代表顶点
+        std::vector<bool> VertexAlive;     // 按代表顶点
+        std::vector<FQuadric> Quadrics;    // 按代表顶点
+        std::vector<std::vector<uint32_t>> VertexTriangles; // 代表顶点 -> 三角形 (可能含已删除的，用时过滤)
+        std::vector<uint32_t> Corners;     // 三角形的物理顶点，折叠时就地改写
+        std::vector<bool> TriangleAlive;
+        uint32_t LiveTriangleCount = 0;
+        std::priority_queue<FCollapse, std::vector<FCollapse>, std::greater<FCollapse>> Heap;
+
+        // TryCollapse 的临时存储，避免每次分配
+        std::vector<uint32_t> FromNeighbors;
+        std::vector<uint32_t> ToNeighbors;
+        std::vector<FCopyRemap> Remaps;
+    };
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<FMeshVertex>& Vertices, std::span<const uint32_t> Indices,
+    uint32_t TargetTriangleCount, float MaxError, float& OutError)
+{
+    check(Indices.size() % 3 == 0);
+
+    FSimplifier Simplifier(Vertices, Indices);
+    std::vector<uint32_t> Result = Simplifier.Run(TargetTriangleCount, MaxError, OutError);
+
+    CA_LOG_VERBOSE("MeshSimplifier", "{} -> {} triangles (target {}), error {}.",
+        Indices.size() / 3, Result.size() / 3, TargetTriangleCount, OutError);
+    return Result;
+}
@@ -0,0 +1,15 @@
+﻿#pragma once
+#include "Mesh.h"
+
+// 导入阶段的网格简化：Garland-Heckbert 二次误差度量 (QEM) + 半边折叠，生成离散 LOD 用
+// - 折叠把一个顶点并到相邻的已有顶点上，只改索引、不新增顶点：各级 LOD 共用同一份顶点缓冲
+// - 位置相同、属性不同的顶点 (UV / 法线接缝) 作为一个整体移动；开放边界与接缝只能沿自身折叠，
+//   并额外加垂直于表面的约束平面，轮廓与纹理接缝不易变形；接缝交汇处的顶点不动
+// - 折叠使相邻三角形法线翻转 (或严重扭转) 时拒绝
+namespace MeshSimplifier
+{
+    // 简化到不超过 TargetTriangleCount 个三角形；折叠用尽或下一次折叠的误差超过 MaxError 时提前停止
+    // 返回新的索引列表；OutError 为这次简化引入的几何误差估计 (网格空间距离，偏保守)
+    std::vector<uint32_t> Simplify(const std::vector<FMeshVertex>& Vertices, std::span<const uint32_t> Indices,
+        uint32_t TargetTriangleCount, float MaxError, float& OutError);
+}
@@ -0,0 +1,305 @@
+﻿#include "Meshlet.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+#include <cfloat>
+
+namespace {
+    constexpr uint32_t INVALID_SLOT = ~0u;
+    // LOD 链：每级目标为上一级三角形数的一半；上一级已少于下限，或这一级没能减少到上一级的 3/4 时停止
+    constexpr float LOD_TRIANGLE_RATIO = 0.5f;
+    constexpr uint32_t MIN_LOD_TRIANGLES = 128;
+    constexpr float MIN_LOD_REDUCTION = 0.75f;
+    // 法线分布超过半球 (最小夹角余弦低于该值) 时锥体失去意义，整簇永不做背面剔除
+    constexpr float CONE_DEGENERATE_THRESHOLD = 0.1f;
+
+    // 顶点 -> 使用它的三角形 (CSR 存储)
+    struct FTriangleAdjacency
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Triangles;
+        std::vector<uint32_t> LiveCounts; // 尚未放入任何簇的三角形数
+    };
+
+    FTriangleAdjacency BuildAdjacency(const FMeshData& Mesh)
+    {
+        const uint32_t VertexCount = static_cast<uint32_t>(Mesh.Vertices.size());
+
+        FTriangleAdjacency Adjacency;
+        Adjacency.Offsets.assign(VertexCount + 1, 0);
+        Adjacency.LiveCounts.assign(VertexCount, 0);
+        for (uint32_t Index : Mesh.Indices)
+        {
+            Adjacency.LiveCounts[Index]++;
+        }
+        for (uint32_t i = 0; i < VertexCount; i++)
+        {
+            Adjacency.Offsets[i + 1] = Adjacency.Offsets[i] + Adjacency.LiveCounts[i];
+        }
+
+        std::vector<uint32_t> Cursor(Adjacency.Offsets.begin(), Adjacency.Offsets.end() - 1);
+        Adjacency.Triangles.resize(Mesh.Indices.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(Mesh.Indices.size()); i++)
+        {
+            Adjacency.Triangles[Cursor[Mesh.Indices[i]]++] = i / 3;
+        }
+        return Adjacency;
+    }
+
+    void ComputeMeshletBounds(const FMeshData& Mesh, const FMeshletData& Data, FMeshlet& Meshlet)
+    {
+        // 1. 包围球：AABB 中心 + 最远顶点距离
+        FVector3 Min = Mesh.Vertices[Data.Vertices[Meshlet.VertexOffset]].Position;
+        FVector3 Max = Min;
+        for (uint32_t i = 0; i < Meshlet.VertexCount; i++)
+        {
+            const FVector3& P = Mesh.Vertices[Data.Vertices[Meshlet.VertexOffset + i]].Position;
+            Min = { std::min(Min.X, P.X), std::min(Min.Y, P.Y), std::min(Min.Z, P.Z) };
+            Max = { std::max(Max.X, P.X), std::max(Max.Y, P.Y), std::max(Max.Z, P.Z) };
+        }
+        const FVector3 Center = (Min + Max) * 0.5f;
+        float Radius = 0.0f;
+        for (uint32_t i = 0; i < Meshlet.VertexCount; i++)
+        {
+            Radius = std::max(Radius, (Mesh.Vertices[Data.Vertices[Meshlet.VertexOffset + i]].Position - Center).Length());
+        }
+        Meshlet.BoundingSphere = FVector4(Center, Radius);
+
+        // 2. 法线锥：轴为面法线之和的方向，cutoff 由与轴夹角最大的面法线决定
+        struct FFace
+        {
+            FVector3 P0;
+            FVector3 Normal;
+        };
+        std::array<FFace, FMeshlet::MAX_TRIANGLES> Faces;
+        uint32_t FaceCount = 0;
+        FVector3 AxisSum;
+        for (uint32_t i = 0; i < Meshlet.TriangleCount; i++)
+        {
+            const uint32_t Packed = Data.Triangles[Meshlet.TriangleOffset + i];
+            const FVector3& P0 = Mesh.Vertices[Data.Vertices[Meshlet.VertexOffset + (Packed & 0xFF)]].Position;
+            const FVector3& P1 = Mesh.Vertices[Data.Vertices[Meshlet.VertexOffset + ((Packed >> 8) & 0xFF)]].Position;
+            const FVector3& P2 = Mesh.Vertices[Data.Vertices[Meshlet.VertexOffset + ((Packed >> 16) & 0xFF)]].Position;
+
+            const FVector3 Normal = FVector3::Cross(P1 - P0, P2 - P0);
+            if (Normal.Length() <= 0.0f)
+            {
+                continue; // 退化三角形不参与
+            }
+            Faces[FaceCount++] = { P0, Normal.GetNormalized() };
+            AxisSum = AxisSum + Normal;
+        }
+
+        const FVector3 Axis = AxisSum.GetNormalized();
+        float MinDot = 1.0f;
+        for (uint32_t i = 0; i < FaceCount; i++)
+        {
+            MinDot = std::min(MinDot, FVector3::Dot(Faces[i].Normal, Axis));
+        }
+
+        if (FaceCount == 0 || MinDot <= CONE_DEGENERATE_THRESHOLD)
+        {
+            Meshlet.ConeApex = FVector4(Center, 0.0f);
+            Meshlet.Cone = FVector4(0.0f, 0.0f, 1.0f, 2.0f); // cutoff > 1：测试永远不成立
+            return;
+        }
+
+        // 锥顶沿轴后退到所有三角形平面之后：相机位于锥内 (与轴同向) 时看到的都是背面
+        float MaxT = 0.0f;
+        for (uint32_t i = 0; i < FaceCount; i++)
+        {
+            const float T = FVector3::Dot(Center - Faces[i].P0, Faces[i].Normal) / FVector3::Dot(Axis, Faces[i].Normal);
+            MaxT = std::max(MaxT, T);
+        }
+
+        Meshlet.ConeApex = FVector4(Center - Axis * MaxT, 0.0f);
+        Meshlet.Cone = FVector4(Axis, std::sqrt(1.0f - MinDot * MinDot));
+    }
+}
+
+FMeshletData MeshletBuilder::Build(const FMeshData& Mesh, uint32_t MaxVertices, uint32_t MaxTriangles)
+{
+    check(MaxVertices >= 3 && MaxVertices <= 256 && MaxTriangles >= 1 && MaxTriangles <= FMeshlet::MAX_TRIANGLES);
+
+    const uint32_t TriangleCount = Mesh.GetTriangleCount();
+    FTriangleAdjacency Adjacency = BuildAdjacency(Mesh);
+
+    FMeshletData Data;
+    Data.Meshlets.reserve(TriangleCount / MaxTriangles + 1);
+    Data.Vertices.reserve(Mesh.Indices.size() / 2);
+    Data.Triangles.reserve(TriangleCount);
+
+    std::vector<bool> Emitted(TriangleCount, false);
+    std::vector<uint32_t> LocalSlots(Mesh.Vertices.size(), INVALID_SLOT);
+    std::vector<uint32_t> LocalVertices;
+    LocalVertices.reserve(MaxVertices);
+
+    FMeshlet Current{};
+    auto Flush = [&]()
+        {
+            if (Current.TriangleCount == 0)
+            {
+                return;
+            }
+            Current.VertexOffset = static_cast<uint32_t>(Data.Vertices.size());
+            Current.VertexCount = static_cast<uint32_t>(LocalVertices.size());
+            Data.Vertices.insert(Data.Vertices.end(), LocalVertices.begin(), LocalVertices.end());
+            ComputeMeshletBounds(Mesh, Data, Current);
+            Data.Meshlets.push_back(Current);
+
+            for (uint32_t Vertex : LocalVertices)
+            {
+                LocalSlots[Vertex] = INVALID_SLOT;
+            }
+            LocalVertices.clear();
+            Current = FMeshlet{};
+            Current.TriangleOffset = static_cast<uint32_t>(Data.Triangles.size());
+        };
+
+    auto CountNewVertices = [&](uint32_t Triangle)
+        {
+            uint32_t Count = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                Count += LocalSlots[Mesh.Indices[Triangle * 3 + k]] == INVALID_SLOT ? 1 : 0;
+            }
+            return Count;
+        };
+
+    auto Append = [&](uint32_t Triangle)
+        {
+            uint32_t Packed = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t Vertex = Mesh.Indices[Triangle * 3 + k];
+                if (LocalSlots[Vertex] == INVALID_SLOT)
+                {
+                    LocalSlots[Vertex] = static_cast<uint32_t>(LocalVertices.size());
+                    LocalVertices.push_back(Vertex);
+                }
+                Packed |= LocalSlots[Vertex] << (k * 8);
+                Adjacency.LiveCounts[Vertex]--;
+            }
+            Data.Triangles.push_back(Packed);
+            Current.TriangleCount++;
+            Emitted[Triangle] = true;
+        };
+
+    uint32_t SeedCursor = 0;
+    for (uint32_t Emit = 0; Emit < TriangleCount; Emit++)
+    {
+        // 1. 在与当前簇共享顶点的三角形中选新增顶点最少的；并列时选剩余邻接最少的 (先收尾快用完的顶点，减少跨簇重复)
+        uint32_t Best = INVALID_SLOT;
+        uint32_t BestNew = 4;
+        uint32_t BestLive = UINT32_MAX;
+        for (uint32_t Vertex : LocalVertices)
+        {
+            for (uint32_t a = Adjacency.Offsets[Vertex]; a < Adjacency.Offsets[Vertex + 1]; a++)
+            {
+                const uint32_t Triangle = Adjacency.Triangles[a];
+                if (Emitted[Triangle])
+                {
+                    continue;
+                }
+
+                const uint32_t NewVertices = CountNewVertices(Triangle);
+                uint32_t Live = 0;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    Live += Adjacency.LiveCounts[Mesh.Indices[Triangle * 3 + k]];
+                }
+                if (NewVertices < BestNew || (NewVertices == BestNew && Live < BestLive))
+                {
+                    Best = Triangle;
+                    BestNew = NewVertices;
+                    BestLive = Live;
+                }
+            }
+        }
+
+        // 2. 没有相邻三角形 (或簇已满) 时另起一簇，种子按原索引顺序取第一个未用的三角形
+        const bool bFull = Best != INVALID_SLOT &&
+            (LocalVertices.size() + BestNew > MaxVertices || Current.TriangleCount + 1 > MaxTriangles);
+        if (Best == INVALID_SLOT || bFull)
+        {
+            Flush();
+            while (Emitted[SeedCursor])
+            {
+                SeedCursor++;
+            }
+            Best = SeedCursor;
+        }
+
+        Append(Best);
+    }
+    Flush();
+    Data.Lods.push_back({ 0, Data.GetMeshletCount(), TriangleCount, 0.0f });
+
+    CA_LOG_VERBOSE("Meshlet", "{} triangles -> {} meshlets ({} vertex references for {} vertices).",
+        TriangleCount, Data.Meshlets.size(), Data.Vertices.size(), Mesh.Vertices.size());
+    return Data;
+}
+
+FMeshletData MeshletBuilder::BuildLods(const FMeshData& Mesh, uint32_t MaxLodCount)
+{
+    check(MaxLodCount >= 1 && MaxLodCount <= FMeshLod::MAX_COUNT);
+
+    FMeshletData Data = Build(Mesh);
+
+    // 各级共用顶点，只换索引；每级都从上一级简化，误差按三角不等式累加
+    FMeshData LodMesh;
+    LodMesh.Vertices = Mesh.Vertices;
+    std::span<const uint32_t> Previous = Mesh.Indices;
+    float Error = 0.0f;
+    while (Data.Lods.size() < MaxLodCount && Previous.size() / 3 >= MIN_LOD_TRIANGLES)
+    {
+        const uint32_t PreviousCount = static_cast<uint32_t>(Previous.size() / 3);
+        float StepError = 0.0f;
+        std::vector<uint32_t> Indices = MeshSimplifier::Simplify(Mesh.Vertices, Previous,
+            static_cast<uint32_t>(static_cast<float>(PreviousCount) * LOD_TRIANGLE_RATIO), FLT_MAX, StepError);
+        if (static_cast<float>(Indices.size() / 3) > static_cast<float>(PreviousCount) * MIN_LOD_REDUCTION)
+        {
+            break;
+        }
+        MeshOptimizer::OptimizeVertexCache(Indices, static_cast<uint32_t>(Mesh.Vertices.size()));
+        LodMesh.Indices = std::move(Indices);
+        Error += StepError;
+
+        // 新一级的簇追加在后面，簇内偏移平移到拼接后的位置
+        FMeshletData Level = Build(LodMesh);
+        const uint32_t MeshletOffset = Data.GetMeshletCount();
+        const uint32_t VertexOffset = static_cast<uint32_t>(Data.Vertices.size());
+        const uint32_t TriangleOffset = static_cast<uint32_t>(Data.Triangles.size());
+        for (FMeshlet& Meshlet : Level.Meshlets)
+        {
+            Meshlet.VertexOffset += VertexOffset;
+            Meshlet.TriangleOffset += TriangleOffset;
+        }
+        Data.Meshlets.insert(Data.Meshlets.end(), Level.Meshlets.begin(), Level.Meshlets.end());
+        Data.Vertices.insert(Data.Vertices.end(), Level.Vertices.begin(), Level.Vertices.end());
+        Data.Triangles.insert(Data.Triangles.end(), Level.Triangles.begin(), Level.Triangles.end());
+        Data.Lods.push_back({ MeshletOffset, Level.GetMeshletCount(), LodMesh.GetTriangleCount(), Error });
+
+        Previous = LodMesh.Indices;
+    }
+
+    CA_LOG_VERBOSE("Meshlet", "{} LODs: {} -> {} triangles, error {}.",
+        Data.Lods.size(), Data.Lods.front().TriangleCount, Data.Lods.back().TriangleCount, Data.Lods.back().Error);
+    return Data;
+}
+
+FMeshletGeometry MeshletBuilder::MakeGeometry(const FMeshData& Mesh, const FPackedMeshData& PackedVertices, const FMeshletData& Meshlets)
+{
+    check(PackedVertices.Vertices.size() == Mesh.Vertices.size());
+
+    FMeshletGeometry Geometry;
+    Geometry.Vertices = PackedVertices.Vertices;
+    Geometry.Quantization = PackedVertices.Quantization;
+    Geometry.Meshlets = Meshlets.Meshlets;
+    Geometry.MeshletVertices = Meshlets.Vertices;
+    Geometry.MeshletTriangles = Meshlets.Triangles;
+    Geometry.Lods = Meshlets.Lods;
+    Geometry.Bounds = Mesh.Bounds;
+    Geometry.TriangleCount = Mesh.GetTriangleCount();
+    return Geometry;
+}
@@ -0,0 +1,74 @@
+﻿#pragma once
+#include "Mesh.h"
+
+// 网格簇 (Meshlet)：不超过 MAX_VERTICES 个顶点、MAX_TRIANGLES 个三角形的一小块连续表面
+// 每个簇带包围球与法线锥，GPU 上逐簇做视锥与背面剔除
+// 布局与着色器中 FMeshlet 一致
+struct FMeshlet
+{
+    static constexpr uint32_t MAX_VERTICES = 64;
+    static constexpr uint32_t MAX_TRIANGLES = 124;
+
+    FVector4 BoundingSphere; // xyz: 网格空间球心, w: 半径
+    FVector4 ConeApex;       // xyz: 法线锥顶点, w 未用
+    FVector4 Cone;           // xyz: 法线锥轴, w: cutoff；dot(normalize(Apex - Eye), Axis) >= cutoff 时整簇背向相机
+    uint32_t VertexOffset;   // FMeshletData::Vertices 中的起始位置
+    uint32_t TriangleOffset; // FMeshletData::Triangles 中的起始位置
+    uint32_t VertexCount;
+    uint32_t TriangleCount;
+};
+static_assert(sizeof(FMeshlet) == 64, "FMeshlet layout must match the shaders");
+
+// 离散 LOD 的一级：同一份顶点上简化出的三角形，构建成一段连续的簇
+// 布局与着色器中 FMeshLod 一致
+struct FMeshLod
+{
+    static constexpr uint32_t MAX_COUNT = 8;
+
+    uint32_t MeshletOffset; // FMeshletData::Meshlets 中的起始位置
+    uint32_t MeshletCount;
+    uint32_t TriangleCount;
+    float Error;            // 相对第 0 级的几何误差上界 (网格空间距离)，逐级单调不减，第 0 级为 0
+};
+static_assert(sizeof(FMeshLod) == 16, "FMeshLod layout must match the shaders");
+
+struct FMeshletData
+{
+    std::vector<FMeshlet> Meshlets;
+    std::vector<uint32_t> Vertices;  // 簇内局部顶点 -> 网格顶点序号
+    std::vector<uint32_t> Triangles; // 每个三角形 3 个 8 位局部顶点序号 (a | b << 8 | c << 16)
+    std::vector<FMeshLod> Lods;      // 由精到粗，至少一级
+
+    uint32_t GetMeshletCount() const { return static_cast<uint32_t>(Meshlets.size()); }
+};
+
+// 网格簇渲染所需数据的只读视图：可以指向内存中的 FMeshData / FMeshletData，也可以直接指向映射的网格资源文件
+struct FMeshletGeometry
+{
+    std::span<const FPackedMeshVertex> Vertices;
+    std::span<const FMeshlet> Meshlets;
+    std::span<const uint32_t> MeshletVertices;
+    std::span<const uint32_t> MeshletTriangles;
+    std::span<const FMeshLod> Lods;
+    FMeshQuantization Quantization;
+    FSphere Bounds;
+    uint32_t TriangleCount = 0; // 第 0 级
+
+    uint32_t GetMeshletCount() const { return static_cast<uint32_t>(Meshlets.size()); }
+    uint32_t GetLodCount() const { return static_cast<uint32_t>(Lods.size()); }
+};
+
+namespace MeshletBuilder
+{
+    // 离线构建：贪心地从种子三角形出发，优先吸收新增顶点最少的相邻三角形，直到顶点或三角形数达到上限
+    // 结果只取决于输入，可以在导入阶段生成后随网格一起存盘
+    // 结果只有一级 LOD
+    FMeshletData Build(const FMeshData& Mesh, uint32_t MaxVertices = FMeshlet::MAX_VERTICES, uint32_t MaxTriangles = FMeshlet::MAX_TRIANGLES);
+
+    // 离散 LOD 链：每级从上一级简化到一半的三角形 (MeshSimplifier，共用顶点，索引重排顶点缓存)，逐级构建簇后依次拼接
+    // 三角形数低于下限、简化不动或达到 MaxLodCount 级时停止；Error 为各步误差之和
+    FMeshletData BuildLods(const FMeshData& Mesh, uint32_t MaxLodCount = FMeshLod::MAX_COUNT);
+
+    // 视图引用 PackedVertices 与 Meshlets 的存储，使用期间两者必须存活；Mesh 只提供包围球与三角形数
+    FMeshletGeometry MakeGeometry(const FMeshData& Mesh, const FPackedMeshData& PackedVertices, const FMeshletData& Meshlets);
+}
@@ -0,0 +1,445 @@
+﻿#include "OcclusionRasterizer.h"
+#include "JobSystem.h"
+#include <cfloat>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CA_OCCLUSION_SSE 1
+#include <immintrin.h>
+#else
+#define CA_OCCLUSION_SSE 0
+#endif
+
+namespace {
+    constexpr uint32_t FULL_MASK = 0xFFFFFFFFu;
+    // 退化 (屏幕上面积近似为 0) 的三角形直接丢弃
+    constexpr float MIN_DOUBLE_AREA = 1e-6f;
+    constexpr uint32_t TEST_JOB_GRAIN = 256;
+
+    struct FScreenVertex
+    {
+        float X;
+        float Y;
+        float Z;
+    };
+}
+
+// 三角形设置：像素包围盒、三条边函数与深度平面
+// 边函数 E(x, y) = A * x + B * y + C，三角形内部 E >= 0；深度 Z(x, y) = DepthA * x + DepthB * y + DepthC
+struct FOcclusionRasterizer::FTriangleSetup
+{
+    float EdgeA[3];
+    float EdgeB[3];
+    float EdgeC[3];
+    float DepthA;
+    float DepthB;
+    float DepthC;
+    float MaxDepth;
+    // 像素包围盒 (闭区间)，MinX > MaxX 表示无效
+    int32_t MinX;
+    int32_t MinY;
+    int32_t MaxX;
+    int32_t MaxY;
+};
+
+namespace {
+    using FTriangleSetup = FOcclusionRasterizer::FTriangleSetup;
+
+    bool SetupTriangle(const FScreenVertex& V0, const FScreenVertex& V1, const FScreenVertex& V2, uint32_t Width, uint32_t Height, FTriangleSetup& Out)
+    {
+        Out.MinX = 1;
+        Out.MaxX = 0;
+
+        const float MinX = std::min({ V0.X, V1.X, V2.X });
+        const float MaxX = std::max({ V0.X, V1.X, V2.X });
+        const float MinY = std::min({ V0.Y, V1.Y, V2.Y });
+        const float MaxY = std::max({ V0.Y, V1.Y, V2.Y });
+        if (MaxX < 0.0f || MaxY < 0.0f || MinX >= static_cast<float>(Width) || MinY >= static_cast<float>(Height))
+        {
+            return false;
+        }
+
+        const float DoubleArea = (V1.X - V0.X) * (V2.Y - V0.Y) - (V2.X - V0.X) * (V1.Y - V0.Y);
+        if (std::abs(DoubleArea) < MIN_DOUBLE_AREA)
+        {
+            return false;
+        }
+
+        // 遮挡体双面可见：按绕序翻转边函数的符号，使内部恒为正
+        const float Sign = DoubleArea > 0.0f ? 1.0f : -1.0f;
+        const FScreenVertex* Vertices[3] = { &V0, &V1, &V2 };
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            const FScreenVertex& A = *Vertices[i];
+            const FScreenVertex& B = *Vertices[(i + 1) % 3];
+            Out.EdgeA[i] = (A.Y - B.Y) * Sign;
+            Out.EdgeB[i] = (B.X - A.X) * Sign;
+            Out.EdgeC[i] = (A.X * B.Y - B.X * A.Y) * Sign;
+        }
+
+        // NDC 深度 (z / w) 在屏幕空间线性，三个顶点解出平面
+        const float InvArea = 1.0f / DoubleArea;
+        Out.DepthA = ((V1.Z - V0.Z) * (V2.Y - V0.Y) - (V2.Z - V0.Z) * (V1.Y - V0.Y)) * InvArea;
+        Out.DepthB = ((V2.Z - V0.Z) * (V1.X - V0.X) - (V1.Z - V0.Z) * (V2.X - V0.X)) * InvArea;
+        Out.DepthC = V0.Z - Out.DepthA * V0.X - Out.DepthB * V0.Y;
+        Out.MaxDepth = std::max({ V0.Z, V1.Z, V2.Z });
+
+        // 采样点在像素中心；先在浮点下钳制，避免近平面附近的巨大坐标转整数溢出
+        Out.MinX = static_cast<int32_t>(std::max(MinX, 0.0f));
+        Out.MinY = static_cast<int32_t>(std::max(MinY, 0.0f));
+        Out.MaxX = static_cast<int32_t>(std::min(MaxX, static_cast<float>(Width - 1)));
+        Out.MaxY = static_cast<int32_t>(std::min(MaxY, static_cast<float>(Height - 1)));
+        return true;
+    }
+
+    FScreenVertex ToScreen(const FVector4& Clip, float ScaleX, float ScaleY)
+    {
+        const float InvW = 1.0f / Clip.W;
+        return { (Clip.X * InvW + 1.0f) * ScaleX, (Clip.Y * InvW + 1.0f) * ScaleY, Clip.Z * InvW };
+    }
+
+    // 子块 (左上像素 PixelX, PixelY) 内 32 个像素中心的覆盖掩码，第 Row * 8 + Column 位对应一个像素
+    uint32_t ComputeCoverage(const FTriangleSetup& Triangle, float PixelX, float PixelY)
+    {
+        constexpr float SPAN_X = static_cast<float>(FOcclusionRasterizer::SUBTILE_WIDTH - 1);
+        constexpr float SPAN_Y = static_cast<float>(FOcclusionRasterizer::SUBTILE_HEIGHT - 1);
+
+        // 每条边在子块像素中心上的最小/最大值：任一边全负则全空，三条边都全正则全满
+        float Base[3];
+        bool bFull = true;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            const float A = Triangle.EdgeA[i];
+            const float B = Triangle.EdgeB[i];
+            Base[i] = A * (PixelX + 0.5f) + B * (PixelY + 0.5f) + Triangle.EdgeC[i];
+            const float MaxValue = Base[i] + std::max(A * SPAN_X, 0.0f) + std::max(B * SPAN_Y, 0.0f);
+            const float MinValue = Base[i] + std::min(A * SPAN_X, 0.0f) + std::min(B * SPAN_Y, 0.0f);
+            if (MaxValue < 0.0f)
+            {
+                return 0;
+            }
+            bFull = bFull && MinValue >= 0.0f;
+        }
+        if (bFull)
+        {
+            return FULL_MASK;
+        }
+
+        uint32_t Mask = 0;
+#if CA_OCCLUSION_SSE
+        // 每行左右两半各一个寄存器，逐行加 B
+        const __m128 ColumnOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        __m128 Left[3];
+        __m128 Right[3];
+        __m128 StepY[3];
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            const __m128 A = _mm_set1_ps(Triangle.EdgeA[i]);
+            Left[i] = _mm_add_ps(_mm_set1_ps(Base[i]), _mm_mul_ps(A, ColumnOffsets));
+            Right[i] = _mm_add_ps(Left[i], _mm_mul_ps(A, _mm_set1_ps(4.0f)));
+            StepY[i] = _mm_set1_ps(Triangle.EdgeB[i]);
+        }
+
+        const __m128 Zero = _mm_setzero_ps();
+        for (uint32_t Row = 0; Row < FOcclusionRasterizer::SUBTILE_HEIGHT; Row++)
+        {
+            const __m128 InsideLeft = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(Left[0], Zero), _mm_cmpge_ps(Left[1], Zero)), _mm_cmpge_ps(Left[2], Zero));
+            const __m128 InsideRight = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(Right[0], Zero), _mm_cmpge_ps(Right[1], Zero)), _mm_cmpge_ps(Right[2], Zero));
+            const uint32_t RowMask = static_cast<uint32_t>(_mm_movemask_ps(InsideLeft)) | (static_cast<uint32_t>(_mm_movemask_ps(InsideRight)) << 4);
+            Mask |= RowMask << (Row * FOcclusionRasterizer::SUBTILE_WIDTH);
+
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                Left[i] = _mm_add_ps(Left[i], StepY[i]);
+                Right[i] = _mm_add_ps(Right[i], StepY[i]);
+            }
+        }
+#else
+        for (uint32_t Row = 0; Row < FOcclusionRasterizer::SUBTILE_HEIGHT; Row++)
+        {
+            for (uint32_t Column = 0; Column < FOcclusionRasterizer::SUBTILE_WIDTH; Column++)
+            {
+                bool bInside = true;
+                for (uint32_t i = 0; i < 3; i++)
+                {
+                    bInside = bInside && Base[i] + Triangle.EdgeA[i] * static_cast<float>(Column) + Triangle.EdgeB[i] * static_cast<float>(Row) >= 0.0f;
+                }
+                Mask |= (bInside ? 1u : 0u) << (Row * FOcclusionRasterizer::SUBTILE_WIDTH + Column);
+            }
+        }
+#endif
+        return Mask;
+    }
+}
+
+void FOcclusionRasterizer::BeginFrame(const FMatrix4& InViewProjection, uint32_t ViewportWidth, uint32_t ViewportHeight)
+{
+    ViewProjection = InViewProjection;
+
+    const float AspectRatio = ViewportWidth > 0 && ViewportHeight > 0 ? static_cast<float>(ViewportHeight) / static_cast<float>(ViewportWidth) : 1.0f;
+    const uint32_t DesiredHeight = static_cast<uint32_t>(std::lround(BUFFER_WIDTH * AspectRatio));
+    Width = BUFFER_WIDTH;
+    Height = std::clamp((DesiredHeight + SUBTILE_HEIGHT - 1) / SUBTILE_HEIGHT * SUBTILE_HEIGHT, SUBTILE_HEIGHT, MAX_BUFFER_HEIGHT);
+    SubtileColumns = Width / SUBTILE_WIDTH;
+    SubtileRows = Height / SUBTILE_HEIGHT;
+
+    // assign 只在容量不足 (尺寸变大) 时重新分配
+    const size_t SubtileCount = static_cast<size_t>(SubtileColumns) * SubtileRows;
+    Masks.assign(SubtileCount, 0);
+    Z0.assign(SubtileCount, 1.0f);
+    Z1.assign(SubtileCount, 0.0f);
+}
+
+void FOcclusionRasterizer::RenderTriangles(const FVector3* Vertices, uint32_t TriangleCount, FJobSystem& Jobs, FFrameArena& Scratch)
+{
+    if (TriangleCount == 0)
+    {
+        return;
+    }
+
+    // 1. 变换、近平面裁剪与三角形设置：裁剪后至多是四边形，每个输入三角形预留两个槽位
+    FTriangleSetup* Triangles = Scratch.AllocateArray<FTriangleSetup>(TriangleCount * 2);
+    const float ScaleX = static_cast<float>(Width) * 0.5f;
+    const float ScaleY = static_cast<float>(Height) * 0.5f;
+    Jobs.ParallelFor(TriangleCount, [this, Vertices, Triangles, ScaleX, ScaleY](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t Triangle = Begin; Triangle < End; Triangle++)
+            {
+                FVector4 Clip[3];
+                for (uint32_t i = 0; i < 3; i++)
+                {
+                    Clip[i] = ViewProjection * FVector4(Vertices[Triangle * 3 + i], 1.0f);
+                }
+
+                // Sutherland-Hodgman，只裁近平面 (z >= 0，此时 w >= 近平面距离 > 0)；其余平面交给像素包围盒钳制
+                FVector4 Polygon[4];
+                uint32_t PolygonCount = 0;
+                for (uint32_t i = 0; i < 3; i++)
+                {
+                    const FVector4& A = Clip[i];
+                    const FVector4& B = Clip[(i + 1) % 3];
+                    if (A.Z >= 0.0f)
+                    {
+                        Polygon[PolygonCount++] = A;
+                    }
+                    if ((A.Z >= 0.0f) != (B.Z >= 0.0f))
+                    {
+                        const float T = A.Z / (A.Z - B.Z);
+                        Polygon[PolygonCount++] = A + (B - A) * T;
+                    }
+                }
+
+                FTriangleSetup* Setups = Triangles + Triangle * 2;
+                Setups[0].MinX = Setups[1].MinX = 1;
+                Setups[0].MaxX = Setups[1].MaxX = 0;
+                for (uint32_t i = 0; i + 2 < PolygonCount; i++)
+                {
+                    SetupTriangle(ToScreen(Polygon[0], ScaleX, ScaleY), ToScreen(Polygon[i + 1], ScaleX, ScaleY),
+                        ToScreen(Polygon[i + 2], ScaleX, ScaleY), Width, Height, Setups[i]);
+                }
+            }
+        });
+
+    // 2. 按条带并行光栅化
+    const uint32_t SetupCount = TriangleCount * 2;
+    const uint32_t BandCount = (SubtileRows + BAND_SUBTILE_ROWS - 1) / BAND_SUBTILE_ROWS;
+    Jobs.ParallelFor(BandCount, [this, Triangles, SetupCount](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t Band = Begin; Band < End; Band++)
+            {
+                RasterizeBand(Triangles, SetupCount, Band * BAND_SUBTILE_ROWS, std::min((Band + 1) * BAND_SUBTILE_ROWS, SubtileRows));
+            }
+        }, 1);
+}
+
+void FOcclusionRasterizer::RasterizeBand(const FTriangleSetup* Triangles, uint32_t TriangleCount, uint32_t RowBegin, uint32_t RowEnd)
+{
+    for (uint32_t TriangleIndex = 0; TriangleIndex < TriangleCount; TriangleIndex++)
+    {
+        const FTriangleSetup& Triangle = Triangles[TriangleIndex];
+        if (Triangle.MinX > Triangle.MaxX)
+        {
+            continue;
+        }
+
+        const uint32_t FirstRow = std::max(static_cast<uint32_t>(Triangle.MinY) / SUBTILE_HEIGHT, RowBegin);
+        const uint32_t LastRow = std::min(static_cast<uint32_t>(Triangle.MaxY) / SUBTILE_HEIGHT + 1, RowEnd);
+        const uint32_t FirstColumn = static_cast<uint32_t>(Triangle.MinX) / SUBTILE_WIDTH;
+        const uint32_t LastColumn = static_cast<uint32_t>(Triangle.MaxX) / SUBTILE_WIDTH + 1;
+        for (uint32_t Row = FirstRow; Row < LastRow; Row++)
+        {
+            const float PixelY = static_cast<float>(Row * SUBTILE_HEIGHT);
+            for (uint32_t Column = FirstColumn; Column < LastColumn; Column++)
+            {
+                const float PixelX = static_cast<float>(Column * SUBTILE_WIDTH);
+                const uint32_t CoverageMask = ComputeCoverage(Triangle, PixelX, PixelY);
+                if (CoverageMask == 0)
+                {
+                    continue;
+                }
+
+                // 子块范围内深度平面的最大值 (取像素边界而不是中心，保守)，不超过三个顶点的最大深度
+                const float CornerX = PixelX + (Triangle.DepthA > 0.0f ? static_cast<float>(SUBTILE_WIDTH) : 0.0f);
+                const float CornerY = PixelY + (Triangle.DepthB > 0.0f ? static_cast<float>(SUBTILE_HEIGHT) : 0.0f);
+                const float Depth = std::min(Triangle.DepthA * CornerX + Triangle.DepthB * CornerY + Triangle.DepthC, Triangle.MaxDepth);
+                UpdateSubtile(Row * SubtileColumns + Column, CoverageMask, Depth);
+            }
+        }
+    }
+}
+
+void FOcclusionRasterizer::UpdateSubtile(uint32_t Index, uint32_t CoverageMask, float TriangleDepth)
+{
+    // 覆盖像素的最远深度同时受已有的 Z0 约束
+    const float Depth = std::min(TriangleDepth, Z0[Index]);
+
+    // 新三角形比工作层近得多 (差距超过工作层相对 Z0 的收益)：丢弃工作层，避免远处的旧覆盖拖累合并后的深度
+    if (Z1[Index] - Depth > Z0[Index] - Z1[Index])
+    {
+        Z1[Index] = 0.0f;
+        Masks[Index] = 0;
+    }
+
+    Z1[Index] = std::max(Z1[Index], Depth);
+    Masks[Index] |= CoverageMask;
+    if (Masks[Index] == FULL_MASK)
+    {
+        Z0[Index] = Z1[Index];
+        Z1[Index] = 0.0f;
+        Masks[Index] = 0;
+    }
+}
+
+bool FOcclusionRasterizer::IsOccluded(const FSphere& Sphere) const
+{
+    // 外接立方体的 8 个角：裁剪坐标 = 球心的裁剪坐标 ± 半径 * 矩阵前三列
+    const FVector4 Center = ViewProjection * FVector4(Sphere.Center, 1.0f);
+    const FVector4 AxisX = ViewProjection.Columns[0] * Sphere.Radius;
+    const FVector4 AxisY = ViewProjection.Columns[1] * Sphere.Radius;
+    const FVector4 AxisZ = ViewProjection.Columns[2] * Sphere.Radius;
+
+    float MinX = FLT_MAX, MinY = FLT_MAX, MaxX = -FLT_MAX, MaxY = -FLT_MAX;
+    float MinDepth = FLT_MAX;
+#if CA_OCCLUSION_SSE
+    // 8 个角分两组，每个分量一个寄存器：低 4 个角 z 取负，高 4 个取正
+    const __m128 SignX = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+    const __m128 SignY = _mm_setr_ps(-1.0f, -1.0f, 1.0f, 1.0f);
+    auto CornerComponents = [&SignX, &SignY](float Center, float X, float Y, float Z, __m128& OutLow, __m128& OutHigh)
+        {
+            const __m128 Base = _mm_add_ps(_mm_set1_ps(Center), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(X), SignX), _mm_mul_ps(_mm_set1_ps(Y), SignY)));
+            OutLow = _mm_sub_ps(Base, _mm_set1_ps(Z));
+            OutHigh = _mm_add_ps(Base, _mm_set1_ps(Z));
+        };
+    auto ReduceMin = [](__m128 V)
+        {
+            V = _mm_min_ps(V, _mm_shuffle_ps(V, V, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_cvtss_f32(_mm_min_ps(V, _mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 3, 0, 1))));
+        };
+    auto ReduceMax = [](__m128 V)
+        {
+            V = _mm_max_ps(V, _mm_shuffle_ps(V, V, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_cvtss_f32(_mm_max_ps(V, _mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 3, 0, 1))));
+        };
+
+    __m128 XLow, XHigh, YLow, YHigh, ZLow, ZHigh, WLow, WHigh;
+    CornerComponents(Center.X, AxisX.X, AxisY.X, AxisZ.X, XLow, XHigh);
+    CornerComponents(Center.Y, AxisX.Y, AxisY.Y, AxisZ.Y, YLow, YHigh);
+    CornerComponents(Center.Z, AxisX.Z, AxisY.Z, AxisZ.Z, ZLow, ZHigh);
+    CornerComponents(Center.W, AxisX.W, AxisY.W, AxisZ.W, WLow, WHigh);
+
+    // 跨过近平面时投影不可靠，保守地视为可见
+    const __m128 Zero = _mm_setzero_ps();
+    const __m128 Behind = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(ZLow, Zero), _mm_cmplt_ps(ZHigh, Zero)),
+        _mm_or_ps(_mm_cmple_ps(WLow, Zero), _mm_cmple_ps(WHigh, Zero)));
+    if (_mm_movemask_ps(Behind) != 0)
+    {
+        return false;
+    }
+
+    const __m128 InvWLow = _mm_div_ps(_mm_set1_ps(1.0f), WLow);
+    const __m128 InvWHigh = _mm_div_ps(_mm_set1_ps(1.0f), WHigh);
+    XLow = _mm_mul_ps(XLow, InvWLow);
+    XHigh = _mm_mul_ps(XHigh, InvWHigh);
+    YLow = _mm_mul_ps(YLow, InvWLow);
+    YHigh = _mm_mul_ps(YHigh, InvWHigh);
+    MinX = ReduceMin(_mm_min_ps(XLow, XHigh));
+    MaxX = ReduceMax(_mm_max_ps(XLow, XHigh));
+    MinY = ReduceMin(_mm_min_ps(YLow, YHigh));
+    MaxY = ReduceMax(_mm_max_ps(YLow, YHigh));
+    MinDepth = ReduceMin(_mm_min_ps(_mm_mul_ps(ZLow, InvWLow), _mm_mul_ps(ZHigh, InvWHigh)));
+#else
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        const FVector4 Clip = Center + ((i & 1) ? AxisX : AxisX * -1.0f) + ((i & 2) ? AxisY : AxisY * -1.0f) + ((i & 4) ? AxisZ : AxisZ * -1.0f);
+        // 跨过近平面时投影不可靠，保守地视为可见
+        if (Clip.Z < 0.0f || Clip.W <= 0.0f)
+        {
+            return false;
+        }
+
+        const float InvW = 1.0f / Clip.W;
+        MinX = std::min(MinX, Clip.X * InvW);
+        MaxX = std::max(MaxX, Clip.X * InvW);
+        MinY = std::min(MinY, Clip.Y * InvW);
+        MaxY = std::max(MaxY, Clip.Y * InvW);
+        MinDepth = std::min(MinDepth, Clip.Z * InvW);
+    }
+#endif
+
+    // 矩形向外取整到子块；完全在屏幕外的交给视锥剔除，这里视为可见
+    const float ScaleX = static_cast<float>(Width) * 0.5f;
+    const float ScaleY = static_cast<float>(Height) * 0.5f;
+    const float PixelMinX = (MinX + 1.0f) * ScaleX, PixelMaxX = (MaxX + 1.0f) * ScaleX;
+    const float PixelMinY = (MinY + 1.0f) * ScaleY, PixelMaxY = (MaxY + 1.0f) * ScaleY;
+    if (PixelMaxX < 0.0f || PixelMaxY < 0.0f || PixelMinX >= static_cast<float>(Width) || PixelMinY >= static_cast<float>(Height))
+    {
+        return false;
+    }
+
+    const uint32_t FirstColumn = static_cast<uint32_t>(std::max(PixelMinX, 0.0f)) / SUBTILE_WIDTH;
+    const uint32_t LastColumn = static_cast<uint32_t>(std::min(PixelMaxX, static_cast<float>(Width - 1))) / SUBTILE_WIDTH;
+    const uint32_t FirstRow = static_cast<uint32_t>(std::max(PixelMinY, 0.0f)) / SUBTILE_HEIGHT;
+    const uint32_t LastRow = static_cast<uint32_t>(std::min(PixelMaxY, static_cast<float>(Height - 1))) / SUBTILE_HEIGHT;
+    for (uint32_t Row = FirstRow; Row <= LastRow; Row++)
+    {
+        const float* RowDepths = Z0.data() + Row * SubtileColumns;
+        for (uint32_t Column = FirstColumn; Column <= LastColumn; Column++)
+        {
+            if (RowDepths[Column] >= MinDepth)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint32_t FOcclusionRasterizer::RemoveOccluded(const FSphereArrays& Spheres, FJobSystem& Jobs, FFrameArena& Scratch, TFrameVector<uint32_t>& InOutVisible) const
+{
+    const uint32_t Count = static_cast<uint32_t>(InOutVisible.size());
+    if (Count == 0)
+    {
+        return 0;
+    }
+
+    // 并行测试写标记，再串行压缩 (保持升序)
+    uint8_t* Occluded = Scratch.AllocateArray<uint8_t>(Count);
+    const uint32_t* Visible = InOutVisible.data();
+    Jobs.ParallelFor(Count, [this, &Spheres, Visible, Occluded](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                const uint32_t Index = Visible[i];
+                Occluded[i] = IsOccluded({ { Spheres.X[Index], Spheres.Y[Index], Spheres.Z[Index] }, Spheres.Radius[Index] }) ? 1 : 0;
+            }
+        }, TEST_JOB_GRAIN);
+
+    uint32_t KeptCount = 0;
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        InOutVisible[KeptCount] = InOutVisible[i];
+        KeptCount += Occluded[i] ? 0u : 1u;
+    }
+    InOutVisible.resize(KeptCount);
+    return Count - KeptCount;
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#include "MathTypes.h"
+#include "FrameArena.h"
+#include "InstanceCulling.h"
+
+class FJobSystem;
+
+// CPU 软件遮挡剔除 (masked occlusion 风格，GPU 剔除关闭时由 RenderPrep 使用)
+// - 只光栅化场景指定的少量遮挡体三角形，目标是低分辨率深度缓冲；缓冲按 8x4 像素的子块组织，
+//   每个子块只存一个 32 位覆盖掩码和两层最远深度：Z0 对整块成立，Z1 只对掩码覆盖的像素成立，
+//   掩码填满时 Z1 并入 Z0 (Andersson 2015 的双层合并)，不保存逐像素深度
+// - 覆盖掩码由三条边函数求出，SSE 每次算 4 个像素；整块在三角形内/外时直接得到全满/全空掩码
+// - 屏幕按子块行切成条带分给 Job 系统，每个条带独立光栅化全部三角形，子块只属于一个条带，不需要同步
+// - 测试：包围球的外接立方体投影为屏幕矩形与最近深度，矩形覆盖的每个子块 Z0 都比它近才判为被遮挡 (保守)
+class FOcclusionRasterizer
+{
+public:
+    static constexpr uint32_t SUBTILE_WIDTH = 8;
+    static constexpr uint32_t SUBTILE_HEIGHT = 4;
+    // 缓冲宽度固定，高度按视口宽高比取整到子块
+    static constexpr uint32_t BUFFER_WIDTH = 512;
+    static constexpr uint32_t MAX_BUFFER_HEIGHT = 512;
+    // 每个条带的子块行数 (16 像素高)
+    static constexpr uint32_t BAND_SUBTILE_ROWS = 4;
+
+    // 清空缓冲；之后的 RenderTriangles / IsOccluded 都按这个 ViewProjection 投影
+    void BeginFrame(const FMatrix4& InViewProjection, uint32_t ViewportWidth, uint32_t ViewportHeight);
+
+    // 世界空间三角形列表 (每 3 个顶点一个，不剔除背面)，跨过近平面的部分被裁掉；三角形设置的暂存分配自 Scratch
+    void RenderTriangles(const FVector3* Vertices, uint32_t TriangleCount, FJobSystem& Jobs, FFrameArena& Scratch);
+
+    // 球被已画的遮挡体完全挡住时返回 true；只读，可在多个线程上并发调用
+    bool IsOccluded(const FSphere& Sphere) const;
+
+    // 从 InOutVisible (实例序号) 中去掉被遮挡的，保持原有顺序，返回去掉的个数
+    uint32_t RemoveOccluded(const FSphereArrays& Spheres, FJobSystem& Jobs, FFrameArena& Scratch, TFrameVector<uint32_t>& InOutVisible) const;
+
+    uint32_t GetWidth() const { return Width; }
+    uint32_t GetHeight() const { return Height; }
+
+    // 三角形设置 (定义见 .cpp)
+    struct FTriangleSetup;
+
+private:
+    void RasterizeBand(const FTriangleSetup* Triangles, uint32_t TriangleCount, uint32_t RowBegin, uint32_t RowEnd);
+    void UpdateSubtile(uint32_t Index, uint32_t CoverageMask, float TriangleDepth);
+
+    FMatrix4 ViewProjection;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t SubtileColumns = 0;
+    uint32_t SubtileRows = 0;
+
+    // 按子块行优先存放
+    std::vector<uint32_t> Masks;
+    std::vector<float> Z0;
+    std::vector<float> Z1;
+};
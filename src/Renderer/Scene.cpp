@@ -0,0 +1,148 @@
+﻿#include "Scene.h"
+#include "FramePacket.h"
+#include "JobSystem.h"
+
+namespace {
+    // 每个 Job 处理的实例数下限，避免调度开销盖过计算本身
+    constexpr uint32_t SCENE_JOB_GRAIN = 256;
+    constexpr float LIGHT_INTENSITY = 2.0f;
+
+    FVector4 MakeInstanceColor(uint32_t Index)
+    {
+        // 整数哈希出一个稳定的颜色，方便肉眼区分相邻实例
+        uint32_t Hash = Index * 2654435761u;
+        Hash ^= Hash >> 15;
+        const float R = 0.4f + 0.6f * static_cast<float>(Hash & 0xFF) / 255.0f;
+        const float G = 0.4f + 0.6f * static_cast<float>((Hash >> 8) & 0xFF) / 255.0f;
+        const float B = 0.4f + 0.6f * static_cast<float>((Hash >> 16) & 0xFF) / 255.0f;
+        return { R, G, B, 1.0f };
+    }
+
+    // [0, 1) 的稳定伪随机数，Seed 区分同一光源的不同属性
+    float HashUnit(uint32_t Index, uint32_t Seed)
+    {
+        uint32_t Hash = (Index * 2654435761u) ^ (Seed * 2246822519u);
+        Hash ^= Hash >> 13;
+        Hash *= 3266489917u;
+        Hash ^= Hash >> 16;
+        return static_cast<float>(Hash >> 8) / static_cast<float>(1u << 24);
+    }
+}
+
+FScene::FScene(uint32_t InstanceCount, uint32_t LightCount)
+{
+    const uint32_t GridSize = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(InstanceCount)))));
+    GridExtent = GridSize * INSTANCE_SPACING;
+
+    PositionsX.resize(InstanceCount);
+    PositionsY.resize(InstanceCount);
+    PositionsZ.resize(InstanceCount, 0.0f);
+    Angles.resize(InstanceCount);
+    AngularSpeeds.resize(InstanceCount);
+    Scales.resize(InstanceCount, 1.0f);
+    Colors.resize(InstanceCount);
+    for (uint32_t i = 0; i < InstanceCount; i++)
+    {
+        const float Column = static_cast<float>(i % GridSize);
+        const float Row = static_cast<float>(i / GridSize);
+
+        PositionsX[i] = (Column + 0.5f) * INSTANCE_SPACING - GridExtent * 0.5f;
+        PositionsY[i] = (Row + 0.5f) * INSTANCE_SPACING - GridExtent * 0.5f;
+        Angles[i] = static_cast<float>(i) * 0.37f;
+        AngularSpeeds[i] = 0.5f + static_cast<float>(i % 7) * 0.25f;
+        Colors[i] = MakeInstanceColor(i);
+
+        const uint32_t OccluderOffset = OCCLUDER_STRIDE / 2;
+        if (i % GridSize % OCCLUDER_STRIDE == OccluderOffset && i / GridSize % OCCLUDER_STRIDE == OccluderOffset)
+        {
+            PositionsZ[i] = OCCLUDER_HEIGHT;
+            Scales[i] = OCCLUDER_SCALE;
+            Occluders.push_back(i);
+        }
+    }
+
+    // 光源圆心均匀散布在整个阵列上，光源数与阵列规模无关
+    Lights.resize(LightCount);
+    for (uint32_t i = 0; i < LightCount; i++)
+    {
+        FLightOrbit& Light = Lights[i];
+        Light.Center = { (HashUnit(i, 0) - 0.5f) * GridExtent, (HashUnit(i, 1) - 0.5f) * GridExtent, LIGHT_HEIGHT };
+        Light.OrbitRadius = (0.5f + 1.5f * HashUnit(i, 2)) * INSTANCE_SPACING;
+        Light.Phase = HashUnit(i, 3) * 2.0f * PI;
+        Light.AngularSpeed = (HashUnit(i, 4) < 0.5f ? -1.0f : 1.0f) * (0.3f + 0.7f * HashUnit(i, 5));
+        Light.Radius = LIGHT_MIN_RADIUS + (LIGHT_MAX_RADIUS - LIGHT_MIN_RADIUS) * HashUnit(i, 6);
+        Light.Color = MakeInstanceColor(i + InstanceCount).XYZ();
+    }
+
+    CA_LOG_INFO("Scene", "{} instances in a {}x{} grid, {} occluders, {} lights.", InstanceCount, GridSize, GridSize, Occluders.size(), LightCount);
+}
+
+void FScene::Update(float DeltaSeconds, FJobSystem& Jobs)
+{
+    TimeSeconds += DeltaSeconds;
+
+    Jobs.ParallelFor(GetInstanceCount(), [this, DeltaSeconds](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                Angles[i] = std::fmod(Angles[i] + AngularSpeeds[i] * DeltaSeconds, 2.0f * PI);
+            }
+        }, SCENE_JOB_GRAIN);
+}
+
+void FScene::Snapshot(FFramePacket& OutPacket, FJobSystem& Jobs) const
+{
+    // 相机正对阵列中心，距离只覆盖阵列的一部分，左右平移时边缘实例会被剔除
+    const float Distance = std::max(GridExtent * 0.6f, 3.0f);
+    const FVector3 Eye = { std::sin(TimeSeconds * 0.2f) * GridExtent * 0.25f, std::cos(TimeSeconds * 0.15f) * GridExtent * 0.1f, Distance };
+    const FVector3 Target = { Eye.X * 0.5f, Eye.Y * 0.5f, 0.0f };
+    OutPacket.View = FMatrix4::LookAt(Eye, Target, { 0.0f, 1.0f, 0.0f });
+
+    const uint32_t InstanceCount = GetInstanceCount();
+    OutPacket.Instances.resize(InstanceCount);
+    OutPacket.BoundsX.resize(InstanceCount);
+    OutPacket.BoundsY.resize(InstanceCount);
+    OutPacket.BoundsZ.resize(InstanceCount);
+    OutPacket.BoundsRadius.resize(InstanceCount);
+    Jobs.ParallelFor(InstanceCount, [this, &OutPacket](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t i = Begin; i < End; i++)
+            {
+                const FVector3 Position = { PositionsX[i], PositionsY[i], PositionsZ[i] };
+                const float Radius = INSTANCE_BOUNDING_RADIUS * Scales[i];
+                FInstanceState& State = OutPacket.Instances[i];
+                State.World = FMatrix4::TranslationRotationZScale(Position, Angles[i], Scales[i]);
+                State.Bounds = { Position, Radius };
+                State.Color = Colors[i];
+
+                OutPacket.BoundsX[i] = Position.X;
+                OutPacket.BoundsY[i] = Position.Y;
+                OutPacket.BoundsZ[i] = Position.Z;
+                OutPacket.BoundsRadius[i] = Radius;
+            }
+        }, SCENE_JOB_GRAIN);
+
+    // 遮挡体数量很少，串行展开为世界空间三角形
+    OutPacket.OccluderVertices.resize(Occluders.size() * 3);
+    for (size_t i = 0; i < Occluders.size(); i++)
+    {
+        const FMatrix4& World = OutPacket.Instances[Occluders[i]].World;
+        for (uint32_t Vertex = 0; Vertex < 3; Vertex++)
+        {
+            OutPacket.OccluderVertices[i * 3 + Vertex] = World.TransformPoint(TRIANGLE_VERTICES[Vertex]);
+        }
+    }
+
+    // 光源只有几百个，串行按时间算出公转位置
+    OutPacket.Lights.resize(Lights.size());
+    for (size_t i = 0; i < Lights.size(); i++)
+    {
+        const FLightOrbit& Light = Lights[i];
+        const float Angle = Light.Phase + Light.AngularSpeed * TimeSeconds;
+        FPointLight& Out = OutPacket.Lights[i];
+        Out.Position = { Light.Center.X + std::cos(Angle) * Light.OrbitRadius, Light.Center.Y + std::sin(Angle) * Light.OrbitRadius, Light.Center.Z };
+        Out.Radius = Light.Radius;
+        Out.Color = Light.Color;
+        Out.Intensity = LIGHT_INTENSITY;
+    }
+}
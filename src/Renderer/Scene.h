@@ -0,0 +1,60 @@
+﻿#pragma once
+#include "MathTypes.h"
+
+class FJobSystem;
+struct FFramePacket;
+
+// 演示场景：XY 平面上的三角形网格阵列，各自绕 Z 轴自转，相机在阵列前方缓慢平移
+// 只由 Update 阶段访问，渲染侧只看到 Snapshot 拷贝出去的帧包
+// 实例状态按 SoA 存放：Update 只遍历角度两列，Snapshot 按列拷出剔除用的包围球
+// 阵列中每隔 OCCLUDER_STRIDE 行列有一个放大并抬向相机的实例，作为 CPU 软件遮挡剔除的遮挡体
+// 点光源散布在阵列上方，各自绕一个圆心公转，分簇光照每帧重新分配
+class FScene
+{
+public:
+    // 三角形外接球半径 (顶点位于 [-0.5, 0.5])
+    static constexpr float INSTANCE_BOUNDING_RADIUS = 0.71f;
+    static constexpr float INSTANCE_SPACING = 1.5f;
+    // 物体空间的三角形顶点，与 Triangle.hlsl 一致 (着色器中 Y 向下给出，这里已翻转)
+    static constexpr FVector3 TRIANGLE_VERTICES[3] = { { 0.0f, 0.5f, 0.0f }, { 0.5f, -0.5f, 0.0f }, { -0.5f, -0.5f, 0.0f } };
+    static constexpr uint32_t OCCLUDER_STRIDE = 8;
+    static constexpr float OCCLUDER_SCALE = 16.0f;
+    static constexpr float OCCLUDER_HEIGHT = 3.0f;
+    // 光源高度在三角形 (Z = 0) 与遮挡体之间，影响半径覆盖周围几个实例
+    static constexpr float LIGHT_HEIGHT = 1.0f;
+    static constexpr float LIGHT_MIN_RADIUS = 3.0f;
+    static constexpr float LIGHT_MAX_RADIUS = 6.0f;
+
+    explicit FScene(uint32_t InstanceCount, uint32_t LightCount = 0);
+
+    void Update(float DeltaSeconds, FJobSystem& Jobs);
+    // 把当前状态写入帧包，之后的 Update 不再影响这一帧
+    void Snapshot(FFramePacket& OutPacket, FJobSystem& Jobs) const;
+
+    uint32_t GetInstanceCount() const { return static_cast<uint32_t>(Angles.size()); }
+    uint32_t GetOccluderCount() const { return static_cast<uint32_t>(Occluders.size()); }
+    uint32_t GetLightCount() const { return static_cast<uint32_t>(Lights.size()); }
+
+private:
+    struct FLightOrbit
+    {
+        FVector3 Center;
+        float OrbitRadius = 0.0f;
+        float Phase = 0.0f;
+        float AngularSpeed = 0.0f;
+        float Radius = 0.0f;
+        FVector3 Color;
+    };
+
+    std::vector<float> PositionsX;
+    std::vector<float> PositionsY;
+    std::vector<float> PositionsZ;
+    std::vector<float> Angles;
+    std::vector<float> AngularSpeeds;
+    std::vector<float> Scales;
+    std::vector<FVector4> Colors;
+    std::vector<uint32_t> Occluders; // 遮挡体的实例序号
+    std::vector<FLightOrbit> Lights;
+    float GridExtent = 0.0f;
+    float TimeSeconds = 0.0f;
+};
@@ -0,0 +1,219 @@
+﻿#include "TextureAsset.h"
+#include <bit>
+#include <cmath>
+
+static_assert(std::endian::native == std::endian::little, "Texture assets are stored little-endian and mapped without conversion");
+
+namespace {
+    // 小于一页的 mip 不做页对齐，只保证拷贝源偏移满足 vkCmdCopyBufferToImage 的纹素对齐
+    constexpr uint64_t SMALL_MIP_ALIGNMENT = 16;
+
+    constexpr uint64_t AlignUp(uint64_t Value, uint64_t Alignment)
+    {
+        return (Value + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    uint64_t GetMipAlignment(uint64_t Size)
+    {
+        return Size >= TEXTURE_ASSET_MIP_ALIGNMENT ? TEXTURE_ASSET_MIP_ALIGNMENT : SMALL_MIP_ALIGNMENT;
+    }
+
+    uint32_t GetFullMipCount(uint32_t Width, uint32_t Height)
+    {
+        return std::bit_width(std::max(Width, Height));
+    }
+
+    float SrgbToLinear(float Value)
+    {
+        return Value <= 0.04045f ? Value / 12.92f : std::pow((Value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t LinearToSrgb8(float Value)
+    {
+        Value = std::clamp(Value, 0.0f, 1.0f);
+        const float Encoded = Value <= 0.0031308f ? Value * 12.92f : 1.055f * std::pow(Value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(Encoded * 255.0f + 0.5f);
+    }
+
+    // 上一级 mip (RGBA8 sRGB) -> 下一级：颜色在线性空间平均，alpha 直接平均
+    // 下一级尺寸向下取整 (与 Vulkan 的 mip 尺寸规则一致)，奇数尺寸时最后一行 / 列被舍弃
+    std::vector<uint8_t> Downsample(const std::vector<uint8_t>& Source, uint32_t Width, uint32_t Height, const std::array<float, 256>& ToLinear)
+    {
+        const uint32_t DstWidth = std::max(Width / 2, 1u);
+        const uint32_t DstHeight = std::max(Height / 2, 1u);
+        std::vector<uint8_t> Result(static_cast<size_t>(DstWidth) * DstHeight * 4);
+
+        for (uint32_t Y = 0; Y < DstHeight; Y++)
+        {
+            const uint32_t Y0 = std::min(Y * 2, Height - 1);
+            const uint32_t Y1 = std::min(Y * 2 + 1, Height - 1);
+            for (uint32_t X = 0; X < DstWidth; X++)
+            {
+                const uint32_t X0 = std::min(X * 2, Width - 1);
+                const uint32_t X1 = std::min(X * 2 + 1, Width - 1);
+                const uint8_t* Texels[4] =
+                {
+                    &Source[(static_cast<size_t>(Y0) * Width + X0) * 4],
+                    &Source[(static_cast<size_t>(Y0) * Width + X1) * 4],
+                    &Source[(static_cast<size_t>(Y1) * Width + X0) * 4],
+                    &Source[(static_cast<size_t>(Y1) * Width + X1) * 4],
+                };
+
+                uint8_t* Destination = &Result[(static_cast<size_t>(Y) * DstWidth + X) * 4];
+                for (uint32_t Channel = 0; Channel < 3; Channel++)
+                {
+                    float Sum = 0.0f;
+                    for (const uint8_t* Texel : Texels)
+                    {
+                        Sum += ToLinear[Texel[Channel]];
+                    }
+                    Destination[Channel] = LinearToSrgb8(Sum * 0.25f);
+                }
+                const uint32_t AlphaSum = Texels[0][3] + Texels[1][3] + Texels[2][3] + Texels[3][3];
+                Destination[3] = static_cast<uint8_t>((AlphaSum + 2) / 4);
+            }
+        }
+        return Result;
+    }
+}
+
+FTextureAsset::FTextureAsset(const std::filesystem::path& Path)
+{
+    if (!File.Open(Path))
+    {
+        throw std::runtime_error("failed to open texture asset: " + Path.string());
+    }
+    if (File.GetSize() < sizeof(FTextureAssetHeader))
+    {
+        throw std::runtime_error("failed to load texture asset, file is truncated: " + Path.string());
+    }
+
+    Header = reinterpret_cast<const FTextureAssetHeader*>(File.GetData());
+    if (Header->Magic != TEXTURE_ASSET_MAGIC)
+    {
+        throw std::runtime_error("failed to load texture asset, not a .ctex file: " + Path.string());
+    }
+    if (Header->Version != TEXTURE_ASSET_VERSION)
+    {
+        throw std::runtime_error("failed to load texture asset, version " + std::to_string(Header->Version) + " (expected "
+            + std::to_string(TEXTURE_ASSET_VERSION) + "), re-import the source: " + Path.string());
+    }
+    if (Header->HeaderSize != sizeof(FTextureAssetHeader) || Header->FileSize != File.GetSize() ||
+        Header->Format != ETextureAssetFormat::RGBA8_SRGB || Header->Width == 0 || Header->Height == 0 ||
+        Header->MipCount != GetFullMipCount(Header->Width, Header->Height) || Header->MipCount > TEXTURE_ASSET_MAX_MIPS)
+    {
+        throw std::runtime_error("failed to load texture asset, header does not match the file: " + Path.string());
+    }
+
+    for (uint32_t i = 0; i < Header->MipCount; i++)
+    {
+        const FTextureAssetMip& Mip = Header->Mips[i];
+        const bool bValid = Mip.Width == std::max(Header->Width >> i, 1u) && Mip.Height == std::max(Header->Height >> i, 1u) &&
+            Mip.Size == static_cast<uint64_t>(Mip.Width) * Mip.Height * BYTES_PER_TEXEL &&
+            Mip.Offset % GetMipAlignment(Mip.Size) == 0 &&
+            Mip.Offset <= File.GetSize() && Mip.Size <= File.GetSize() - Mip.Offset;
+        if (!bValid)
+        {
+            throw std::runtime_error("failed to load texture asset, mip " + std::to_string(i) + " is corrupt: " + Path.string());
+        }
+    }
+    // 与网格资源不同，这里不整文件预读：高分辨率 mip 只在流送需要时才换入
+}
+
+std::span<const std::byte> FTextureAsset::GetMip(uint32_t Mip) const
+{
+    const FTextureAssetMip& Desc = GetMipDesc(Mip);
+    return { File.GetData() + Desc.Offset, static_cast<size_t>(Desc.Size) };
+}
+
+void FTextureAsset::PrefetchMips(uint32_t FirstMip, uint32_t EndMip) const
+{
+    check(FirstMip <= EndMip && EndMip <= Header->MipCount);
+    if (FirstMip == EndMip)
+    {
+        return;
+    }
+    // 各级 mip 在文件中按精细到粗糙连续排列
+    const uint64_t Begin = Header->Mips[FirstMip].Offset;
+    const uint64_t End = Header->Mips[EndMip - 1].Offset + Header->Mips[EndMip - 1].Size;
+    File.Prefetch(static_cast<size_t>(Begin), static_cast<size_t>(End - Begin));
+}
+
+void TextureAsset::Write(const std::filesystem::path& Path, const FTextureData& Texture)
+{
+    check(Texture.Width > 0 && Texture.Height > 0 && Texture.Pixels.size() == static_cast<size_t>(Texture.Width) * Texture.Height * 4);
+
+    const uint32_t MipCount = GetFullMipCount(Texture.Width, Texture.Height);
+    if (MipCount > TEXTURE_ASSET_MAX_MIPS)
+    {
+        throw std::runtime_error("failed to write texture asset, image is larger than 32768 pixels: " + Path.string());
+    }
+
+    std::array<float, 256> ToLinear;
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        ToLinear[i] = SrgbToLinear(i / 255.0f);
+    }
+
+    std::vector<std::vector<uint8_t>> Mips(MipCount);
+    Mips[0] = Texture.Pixels;
+    for (uint32_t i = 1; i < MipCount; i++)
+    {
+        Mips[i] = Downsample(Mips[i - 1], std::max(Texture.Width >> (i - 1), 1u), std::max(Texture.Height >> (i - 1), 1u), ToLinear);
+    }
+
+    FTextureAssetHeader Header{};
+    Header.Magic = TEXTURE_ASSET_MAGIC;
+    Header.Version = TEXTURE_ASSET_VERSION;
+    Header.HeaderSize = sizeof(FTextureAssetHeader);
+    Header.Format = ETextureAssetFormat::RGBA8_SRGB;
+    Header.Width = Texture.Width;
+    Header.Height = Texture.Height;
+    Header.MipCount = MipCount;
+
+    uint64_t Offset = sizeof(FTextureAssetHeader);
+    for (uint32_t i = 0; i < MipCount; i++)
+    {
+        FTextureAssetMip& Mip = Header.Mips[i];
+        Mip.Width = std::max(Texture.Width >> i, 1u);
+        Mip.Height = std::max(Texture.Height >> i, 1u);
+        Mip.Size = Mips[i].size();
+        Mip.Offset = AlignUp(Offset, GetMipAlignment(Mip.Size));
+        Offset = Mip.Offset + Mip.Size;
+    }
+    Header.FileSize = Offset;
+
+    std::ofstream Stream(Path, std::ios::binary | std::ios::trunc);
+    if (!Stream.is_open())
+    {
+        throw std::runtime_error("failed to create texture asset: " + Path.string());
+    }
+
+    const char Padding[TEXTURE_ASSET_MIP_ALIGNMENT] = {};
+    Stream.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+    uint64_t Written = sizeof(Header);
+    for (uint32_t i = 0; i < MipCount; i++)
+    {
+        Stream.write(Padding, static_cast<std::streamsize>(Header.Mips[i].Offset - Written));
+        Stream.write(reinterpret_cast<const char*>(Mips[i].data()), static_cast<std::streamsize>(Mips[i].size()));
+        Written = Header.Mips[i].Offset + Mips[i].size();
+    }
+
+    if (!Stream.good())
+    {
+        throw std::runtime_error("failed to write texture asset: " + Path.string());
+    }
+}
+
+void TextureAsset::Cook(const std::filesystem::path& Source, const std::filesystem::path& Destination)
+{
+    const uint64_t BeginNs = Utils::GetTimeNs();
+    const FTextureData Texture = TextureImporter::Import(Source);
+    const uint64_t ImportNs = Utils::GetTimeNs();
+    Write(Destination, Texture);
+    const uint64_t EndNs = Utils::GetTimeNs();
+
+    CA_LOG_INFO("TextureAsset", "Cooked {} -> {}: {}x{}, {} mips, {} KB (import {} ms, mips + write {} ms).",
+        Source.string(), Destination.string(), Texture.Width, Texture.Height, GetFullMipCount(Texture.Width, Texture.Height),
+        std::filesystem::file_size(Destination) / 1024, (ImportNs - BeginNs) / 1e6, (EndNs - ImportNs) / 1e6);
+}
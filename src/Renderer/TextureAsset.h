@@ -0,0 +1,75 @@
+﻿#pragma once
+#include "TextureImporter.h"
+#include "MappedFile.h"
+
+// 纹理资源容器 (.ctex)：导入阶段离线生成完整 mip 链，运行时整个文件映射进内存，按需取出单个 mip 的某些行
+// 文件布局 (小端)：
+//   [FTextureAssetHeader][填充][mip 0][填充][mip 1]...
+// - 最精细的 mip 在前；每级 mip 的行紧密排列 (Width * 4 字节)，可直接作为 vkCmdCopyBufferToImage 的源
+// - 不小于一页的 mip 起始按 TEXTURE_ASSET_MIP_ALIGNMENT (4 KB) 对齐，流送时只换入用到的页；更小的 mip 只按 16 字节对齐，尾部紧凑
+// - 布局或像素格式变化时递增 TEXTURE_ASSET_VERSION，旧文件被拒绝并提示重新导入
+enum class ETextureAssetFormat : uint32_t
+{
+    RGBA8_SRGB = 0,
+};
+
+constexpr uint32_t TEXTURE_ASSET_MAGIC = 0x58455443; // "CTEX"
+constexpr uint32_t TEXTURE_ASSET_VERSION = 1;
+constexpr uint64_t TEXTURE_ASSET_MIP_ALIGNMENT = 4096;
+// 最大 32768 x 32768
+constexpr uint32_t TEXTURE_ASSET_MAX_MIPS = 16;
+
+struct FTextureAssetMip
+{
+    uint64_t Offset; // 相对文件开头
+    uint64_t Size;   // 字节数 (Width * Height * 4)
+    uint32_t Width;
+    uint32_t Height;
+};
+
+struct FTextureAssetHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t HeaderSize;
+    ETextureAssetFormat Format;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t MipCount;
+    uint32_t Reserved;
+    uint64_t FileSize;
+    FTextureAssetMip Mips[TEXTURE_ASSET_MAX_MIPS];
+};
+static_assert(std::is_trivially_copyable_v<FTextureAssetHeader>, "FTextureAssetHeader is written to disk as raw bytes");
+static_assert(sizeof(FTextureAssetMip) == 24 && sizeof(FTextureAssetHeader) == 424, "FTextureAssetHeader layout is part of the file format");
+
+// 映射的纹理资源：mip 数据直接指向映射内存，对象存活期间有效
+class FTextureAsset
+{
+public:
+    static constexpr uint32_t BYTES_PER_TEXEL = 4;
+
+    // 文件缺失、版本不符或头部与文件大小矛盾时抛出 std::runtime_error
+    explicit FTextureAsset(const std::filesystem::path& Path);
+
+    const FTextureAssetHeader& GetHeader() const { return *Header; }
+    uint32_t GetMipCount() const { return Header->MipCount; }
+    const FTextureAssetMip& GetMipDesc(uint32_t Mip) const { check(Mip < Header->MipCount); return Header->Mips[Mip]; }
+    std::span<const std::byte> GetMip(uint32_t Mip) const;
+
+    // 提示内核在后台换入 [FirstMip, EndMip) 的数据：流送决定之后立即调用，真正读取时不再缺页等待
+    void PrefetchMips(uint32_t FirstMip, uint32_t EndMip) const;
+
+private:
+    FMappedFile File;
+    const FTextureAssetHeader* Header = nullptr;
+};
+
+namespace TextureAsset
+{
+    // 按伽马正确的 2x2 盒式滤波 (线性空间平均，sRGB 存储) 生成完整 mip 链后写出
+    void Write(const std::filesystem::path& Path, const FTextureData& Texture);
+
+    // 离线导入：TGA -> RGBA8 sRGB + mip 链 -> 写出 .ctex
+    void Cook(const std::filesystem::path& Source, const std::filesystem::path& Destination);
+}
@@ -0,0 +1,154 @@
+﻿#include "TextureImporter.h"
+#include <cstring>
+
+namespace {
+    constexpr size_t TGA_HEADER_SIZE = 18;
+
+    constexpr uint8_t TGA_TYPE_TRUE_COLOR = 2;
+    constexpr uint8_t TGA_TYPE_GRAYSCALE = 3;
+    constexpr uint8_t TGA_TYPE_RLE_TRUE_COLOR = 10;
+    constexpr uint8_t TGA_TYPE_RLE_GRAYSCALE = 11;
+
+    // 图像描述字节的第 5 位：原点在左上 (否则左下)
+    constexpr uint8_t TGA_DESCRIPTOR_TOP_LEFT = 0x20;
+
+    std::vector<uint8_t> ReadWholeFile(const std::filesystem::path& Path)
+    {
+        std::ifstream Stream(Path, std::ios::ate | std::ios::binary);
+        if (!Stream.is_open())
+        {
+            throw std::runtime_error("failed to open TGA file: " + Path.string());
+        }
+        std::vector<uint8_t> Bytes(static_cast<size_t>(Stream.tellg()));
+        Stream.seekg(0);
+        Stream.read(reinterpret_cast<char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size()));
+        return Bytes;
+    }
+
+    uint16_t ReadU16(const uint8_t* Data)
+    {
+        return static_cast<uint16_t>(Data[0] | (Data[1] << 8));
+    }
+
+    // 源像素 (BGR / BGRA / 灰度) -> RGBA8
+    void DecodePixel(const uint8_t* Source, uint32_t BytesPerPixel, uint8_t* Destination)
+    {
+        if (BytesPerPixel == 1)
+        {
+            Destination[0] = Destination[1] = Destination[2] = Source[0];
+            Destination[3] = 255;
+            return;
+        }
+        Destination[0] = Source[2];
+        Destination[1] = Source[1];
+        Destination[2] = Source[0];
+        Destination[3] = BytesPerPixel == 4 ? Source[3] : 255;
+    }
+}
+
+FTextureData TextureImporter::Import(const std::filesystem::path& Path)
+{
+    const std::vector<uint8_t> Bytes = ReadWholeFile(Path);
+    if (Bytes.size() < TGA_HEADER_SIZE)
+    {
+        throw std::runtime_error("failed to import TGA, file is truncated: " + Path.string());
+    }
+
+    const uint8_t IdLength = Bytes[0];
+    const uint8_t ColorMapType = Bytes[1];
+    const uint8_t ImageType = Bytes[2];
+    const uint16_t ColorMapLength = ReadU16(&Bytes[5]);
+    const uint8_t ColorMapEntryBits = Bytes[7];
+    const uint32_t Width = ReadU16(&Bytes[12]);
+    const uint32_t Height = ReadU16(&Bytes[14]);
+    const uint32_t BitsPerPixel = Bytes[16];
+    const bool bTopLeft = (Bytes[17] & TGA_DESCRIPTOR_TOP_LEFT) != 0;
+
+    const bool bGrayscale = ImageType == TGA_TYPE_GRAYSCALE || ImageType == TGA_TYPE_RLE_GRAYSCALE;
+    const bool bRle = ImageType == TGA_TYPE_RLE_TRUE_COLOR || ImageType == TGA_TYPE_RLE_GRAYSCALE;
+    if (!bGrayscale && ImageType != TGA_TYPE_TRUE_COLOR && ImageType != TGA_TYPE_RLE_TRUE_COLOR)
+    {
+        throw std::runtime_error("failed to import TGA, unsupported image type " + std::to_string(ImageType) + ": " + Path.string());
+    }
+    if ((bGrayscale && BitsPerPixel != 8) || (!bGrayscale && BitsPerPixel != 24 && BitsPerPixel != 32))
+    {
+        throw std::runtime_error("failed to import TGA, unsupported pixel depth " + std::to_string(BitsPerPixel) + ": " + Path.string());
+    }
+    if (Width == 0 || Height == 0)
+    {
+        throw std::runtime_error("failed to import TGA, image is empty: " + Path.string());
+    }
+
+    // 真彩色图像也可能带一个 (未使用的) 颜色表，跳过
+    const size_t ColorMapBytes = ColorMapType != 0 ? static_cast<size_t>(ColorMapLength) * ((ColorMapEntryBits + 7) / 8) : 0;
+    size_t Offset = TGA_HEADER_SIZE + IdLength + ColorMapBytes;
+    const uint32_t BytesPerPixel = BitsPerPixel / 8;
+    const size_t PixelCount = static_cast<size_t>(Width) * Height;
+
+    // 按文件顺序解码，行序在最后统一调整
+    std::vector<uint8_t> Decoded(PixelCount * 4);
+    auto RequireBytes = [&](size_t Count)
+        {
+            if (Offset + Count > Bytes.size())
+            {
+                throw std::runtime_error("failed to import TGA, pixel data is truncated: " + Path.string());
+            }
+        };
+
+    if (!bRle)
+    {
+        RequireBytes(PixelCount * BytesPerPixel);
+        for (size_t i = 0; i < PixelCount; i++)
+        {
+            DecodePixel(&Bytes[Offset + i * BytesPerPixel], BytesPerPixel, &Decoded[i * 4]);
+        }
+    }
+    else
+    {
+        // 每个包以一个字节开头：最高位为 1 时后跟一个像素重复 N 次，否则后跟 N 个原始像素 (N = 低 7 位 + 1)
+        size_t Pixel = 0;
+        while (Pixel < PixelCount)
+        {
+            RequireBytes(1);
+            const uint8_t PacketHeader = Bytes[Offset++];
+            const size_t Count = std::min<size_t>((PacketHeader & 0x7F) + 1, PixelCount - Pixel);
+            if (PacketHeader & 0x80)
+            {
+                RequireBytes(BytesPerPixel);
+                for (size_t i = 0; i < Count; i++)
+                {
+                    DecodePixel(&Bytes[Offset], BytesPerPixel, &Decoded[(Pixel + i) * 4]);
+                }
+                Offset += BytesPerPixel;
+            }
+            else
+            {
+                RequireBytes(Count * BytesPerPixel);
+                for (size_t i = 0; i < Count; i++)
+                {
+                    DecodePixel(&Bytes[Offset + i * BytesPerPixel], BytesPerPixel, &Decoded[(Pixel + i) * 4]);
+                }
+                Offset += Count * BytesPerPixel;
+            }
+            Pixel += Count;
+        }
+    }
+
+    FTextureData Texture;
+    Texture.Width = Width;
+    Texture.Height = Height;
+    if (bTopLeft)
+    {
+        Texture.Pixels = std::move(Decoded);
+        return Texture;
+    }
+
+    // 左下原点：翻转为自上而下
+    const size_t RowBytes = static_cast<size_t>(Width) * 4;
+    Texture.Pixels.resize(Decoded.size());
+    for (uint32_t Row = 0; Row < Height; Row++)
+    {
+        std::memcpy(&Texture.Pixels[Row * RowBytes], &Decoded[(Height - 1 - Row) * RowBytes], RowBytes);
+    }
+    return Texture;
+}
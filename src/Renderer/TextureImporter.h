@@ -0,0 +1,18 @@
+﻿#pragma once
+
+// 导入后的纹理：RGBA8，按 sRGB 编码存储，行自上而下紧密排列
+struct FTextureData
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    std::vector<uint8_t> Pixels;
+};
+
+// TGA 纹理导入 (离线阶段使用)
+// - 支持未压缩与 RLE 压缩的真彩色 (24 / 32 位) 与灰度 (8 位) 图像，左下或左上原点
+// - 不支持调色板图像，遇到时报错；没有 alpha 通道时 alpha 补 255
+namespace TextureImporter
+{
+    // 失败时抛出 std::runtime_error
+    FTextureData Import(const std::filesystem::path& Path);
+}
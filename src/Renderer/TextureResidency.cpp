@@ -0,0 +1,194 @@
+﻿#include "TextureResidency.h"
+
+uint32_t FTextureResidency::AddTexture(std::span<const uint64_t> MipBytes, uint32_t TailMip)
+{
+    check(!MipBytes.empty() && TailMip < MipBytes.size());
+
+    FTextureState& State = Textures.emplace_back();
+    State.BytesFrom.resize(MipBytes.size() + 1, 0);
+    for (size_t i = MipBytes.size(); i-- > 0;)
+    {
+        State.BytesFrom[i] = State.BytesFrom[i + 1] + MipBytes[i];
+    }
+    State.TailMip = TailMip;
+    State.ResidentMip = TailMip;
+    State.TargetMip = TailMip;
+    State.WantedMip = TailMip;
+
+    CommittedBytes += State.BytesFrom[TailMip];
+    TailBytes += State.BytesFrom[TailMip];
+    return static_cast<uint32_t>(Textures.size() - 1);
+}
+
+void FTextureResidency::Request(uint32_t Texture, uint32_t Mip)
+{
+    FTextureState& State = Textures[Texture];
+    State.RequestedMip = std::min(State.RequestedMip, std::min(Mip, State.TailMip));
+}
+
+void FTextureResidency::StartChange(uint32_t Texture, uint32_t TopMip, std::vector<FTextureResidencyChange>& OutChanges)
+{
+    FTextureState& State = Textures[Texture];
+    check(!State.IsPending() && TopMip != State.ResidentMip && TopMip <= State.TailMip);
+
+    CommittedBytes = CommittedBytes - State.BytesFrom[State.TargetMip] + State.BytesFrom[TopMip];
+    State.TargetMip = TopMip;
+    PendingCount++;
+    OutChanges.push_back({ Texture, TopMip });
+}
+
+uint64_t FTextureResidency::Evict(uint64_t BytesNeeded, uint32_t ExcludedTexture, std::vector<FTextureResidencyChange>& OutChanges)
+{
+    SortScratch.clear();
+    for (uint32_t i = 0; i < Textures.size(); i++)
+    {
+        const FTextureState& State = Textures[i];
+        if (i != ExcludedTexture && !State.IsPending() && State.ResidentMip < State.TailMip)
+        {
+            SortScratch.push_back(i);
+        }
+    }
+    std::sort(SortScratch.begin(), SortScratch.end(), [this](uint32_t A, uint32_t B)
+        {
+            return Textures[A].LastRequestFrame != Textures[B].LastRequestFrame
+                ? Textures[A].LastRequestFrame < Textures[B].LastRequestFrame : A < B;
+        });
+
+    uint64_t FreedBytes = 0;
+    // 1. 需求已变粗糙的纹理：只降掉多出来的 mip
+    for (uint32_t Texture : SortScratch)
+    {
+        if (FreedBytes >= BytesNeeded)
+        {
+            return FreedBytes;
+        }
+        const FTextureState& State = Textures[Texture];
+        if (State.WantedMip > State.ResidentMip)
+        {
+            FreedBytes += State.BytesFrom[State.ResidentMip] - State.BytesFrom[State.WantedMip];
+            StartChange(Texture, State.WantedMip, OutChanges);
+        }
+    }
+
+    // 2. 本帧没有用到的纹理整段降到尾部
+    for (uint32_t Texture : SortScratch)
+    {
+        if (FreedBytes >= BytesNeeded)
+        {
+            break;
+        }
+        const FTextureState& State = Textures[Texture];
+        if (!State.IsPending() && State.LastRequestFrame < FrameCounter)
+        {
+            FreedBytes += State.BytesFrom[State.ResidentMip] - State.BytesFrom[State.TailMip];
+            StartChange(Texture, State.TailMip, OutChanges);
+        }
+    }
+    return FreedBytes;
+}
+
+void FTextureResidency::Update(uint64_t NowNs, uint64_t BudgetBytes, uint32_t MaxStarts, std::vector<FTextureResidencyChange>& OutChanges)
+{
+    // 1. 刷新需求
+    for (FTextureState& State : Textures)
+    {
+        if (State.RequestedMip != UINT32_MAX)
+        {
+            State.WantedMip = State.RequestedMip;
+            State.LastRequestFrame = FrameCounter;
+        }
+        else if (FrameCounter - State.LastRequestFrame > REQUEST_LIFETIME_FRAMES)
+        {
+            State.WantedMip = State.TailMip;
+        }
+        State.RequestedMip = UINT32_MAX;
+
+        if (State.WantedMip < State.ResidentMip)
+        {
+            State.WaitingSinceNs = State.WaitingSinceNs != 0 ? State.WaitingSinceNs : NowNs;
+        }
+        else if (!State.IsPending())
+        {
+            State.WaitingSinceNs = 0;
+        }
+    }
+
+    // 2. 预算收缩 (显存被其它用途占用) 时先回到预算之内
+    if (CommittedBytes > BudgetBytes)
+    {
+        Evict(CommittedBytes - BudgetBytes, UINT32_MAX, OutChanges);
+    }
+
+    // 3. 调入：缺得越多越优先，其次是最近使用的
+    std::vector<uint32_t> Candidates;
+    for (uint32_t i = 0; i < Textures.size(); i++)
+    {
+        if (!Textures[i].IsPending() && Textures[i].WantedMip < Textures[i].ResidentMip)
+        {
+            Candidates.push_back(i);
+        }
+    }
+    std::sort(Candidates.begin(), Candidates.end(), [this](uint32_t A, uint32_t B)
+        {
+            const FTextureState& StateA = Textures[A];
+            const FTextureState& StateB = Textures[B];
+            const uint32_t MissingA = StateA.ResidentMip - StateA.WantedMip;
+            const uint32_t MissingB = StateB.ResidentMip - StateB.WantedMip;
+            if (MissingA != MissingB)
+            {
+                return MissingA > MissingB;
+            }
+            return StateA.LastRequestFrame != StateB.LastRequestFrame ? StateA.LastRequestFrame > StateB.LastRequestFrame : A < B;
+        });
+
+    uint32_t Starts = 0;
+    for (uint32_t Texture : Candidates)
+    {
+        if (Starts >= MaxStarts)
+        {
+            break;
+        }
+        // 候选可能已在为更靠前的候选腾空间时被降级
+        const FTextureState& State = Textures[Texture];
+        if (State.IsPending())
+        {
+            continue;
+        }
+
+        const uint64_t NeededBytes = State.BytesFrom[State.WantedMip] - State.BytesFrom[State.ResidentMip];
+        if (CommittedBytes + NeededBytes > BudgetBytes)
+        {
+            Evict(CommittedBytes + NeededBytes - BudgetBytes, Texture, OutChanges);
+        }
+
+        // 腾不出足够空间时退而调入放得下的最精细的一级
+        uint32_t TopMip = State.WantedMip;
+        while (TopMip < State.ResidentMip && CommittedBytes + State.BytesFrom[TopMip] - State.BytesFrom[State.ResidentMip] > BudgetBytes)
+        {
+            TopMip++;
+        }
+        if (TopMip < State.ResidentMip)
+        {
+            StartChange(Texture, TopMip, OutChanges);
+            Starts++;
+        }
+    }
+
+    FrameCounter++;
+}
+
+uint64_t FTextureResidency::CompleteChange(uint32_t Texture)
+{
+    FTextureState& State = Textures[Texture];
+    check(State.IsPending() && PendingCount > 0);
+    State.ResidentMip = State.TargetMip;
+    PendingCount--;
+
+    if (State.WaitingSinceNs != 0 && State.ResidentMip <= State.WantedMip)
+    {
+        const uint64_t WaitingSinceNs = State.WaitingSinceNs;
+        State.WaitingSinceNs = 0;
+        return WaitingSinceNs;
+    }
+    return 0;
+}
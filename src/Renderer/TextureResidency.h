@@ -0,0 +1,68 @@
+﻿#pragma once
+
+// 一次驻留调整：把纹理的驻留范围改为 [TopMip, MipCount)
+struct FTextureResidencyChange
+{
+    uint32_t Texture;
+    uint32_t TopMip;
+};
+
+// 纹理 mip 驻留调度 (与图形 API 无关，由 RHI 线程独占使用)
+// - 每张纹理驻留一段连续的 mip [ResidentMip, MipCount)；TailMip 及更粗糙的尾部在注册时即已驻留，永不逐出
+// - 需求：每帧由各来源 (屏幕空间尺寸估计、采样反馈) 请求需要的最精细 mip，取最小值；
+//   连续 REQUEST_LIFETIME_FRAMES 帧没有请求的纹理需求回落到尾部
+// - 调入：需求比驻留更精细的纹理按缺少的级数、最近使用排序，每帧至多发起 MaxStarts 个
+// - 逐出：驻留量超出预算时按最久未使用的顺序，先降掉已不需要的 mip，仍不够再把本帧未使用的纹理降到尾部
+// - 每张纹理同时至多一个进行中的调整；驻留量在发起时即按新范围计入，执行方完成后调用 CompleteChange
+class FTextureResidency
+{
+public:
+    static constexpr uint64_t REQUEST_LIFETIME_FRAMES = 30;
+
+    // MipBytes[i]: 第 i 级 mip 的显存字节数；返回纹理序号
+    uint32_t AddTexture(std::span<const uint64_t> MipBytes, uint32_t TailMip);
+
+    // 本帧需要 Texture 至少驻留到 Mip (比尾部粗糙的请求按尾部计)
+    void Request(uint32_t Texture, uint32_t Mip);
+
+    // 每帧在本帧的请求之后调用一次：刷新需求，在 BudgetBytes 之内生成调整，追加到 OutChanges
+    void Update(uint64_t NowNs, uint64_t BudgetBytes, uint32_t MaxStarts, std::vector<FTextureResidencyChange>& OutChanges);
+
+    // 进行中的调整已生效；若它满足了此前未满足的需求，返回需求开始的时刻 (延迟统计的起点)，否则返回 0
+    uint64_t CompleteChange(uint32_t Texture);
+
+    uint32_t GetTextureCount() const { return static_cast<uint32_t>(Textures.size()); }
+    uint32_t GetResidentMip(uint32_t Texture) const { return Textures[Texture].ResidentMip; }
+    uint32_t GetWantedMip(uint32_t Texture) const { return Textures[Texture].WantedMip; }
+    // 按调整后的范围计 (含进行中的调入)
+    uint64_t GetCommittedBytes() const { return CommittedBytes; }
+    uint64_t GetTailBytes() const { return TailBytes; }
+    uint32_t GetPendingCount() const { return PendingCount; }
+
+private:
+    struct FTextureState
+    {
+        std::vector<uint64_t> BytesFrom; // BytesFrom[m]: [m, MipCount) 的总字节数
+        uint32_t TailMip = 0;
+        uint32_t ResidentMip = 0;  // 已生效的驻留范围
+        uint32_t TargetMip = 0;    // 进行中调整的目标，等于 ResidentMip 时没有进行中的调整
+        uint32_t WantedMip = 0;
+        uint32_t RequestedMip = UINT32_MAX; // 本帧请求的最小值
+        uint64_t LastRequestFrame = 0;
+        uint64_t WaitingSinceNs = 0; // 需求开始比驻留更精细的时刻，0 表示需求已满足
+
+        bool IsPending() const { return TargetMip != ResidentMip; }
+    };
+
+    void StartChange(uint32_t Texture, uint32_t TopMip, std::vector<FTextureResidencyChange>& OutChanges);
+    // 按 LRU 逐出至少 BytesNeeded (尽力而为)，返回实际释放的字节数；ExcludedTexture 不参与
+    uint64_t Evict(uint64_t BytesNeeded, uint32_t ExcludedTexture, std::vector<FTextureResidencyChange>& OutChanges);
+
+    std::vector<FTextureState> Textures;
+    std::vector<uint32_t> SortScratch;
+    // 从 1 开始：LastRequestFrame 为 0 表示从未被请求
+    uint64_t FrameCounter = 1;
+    uint64_t CommittedBytes = 0;
+    uint64_t TailBytes = 0;
+    uint32_t PendingCount = 0;
+};
@@ -0,0 +1,235 @@
+﻿#include "TransformHierarchy.h"
+#include "JobSystem.h"
+#include "MathSimd.h"
+
+namespace {
+    // 每个 Job 处理的节点数下限，避免调度开销盖过矩阵乘法本身
+    constexpr uint32_t HIERARCHY_JOB_GRAIN = 256;
+}
+
+uint32_t FTransformHierarchy::AddNode(uint32_t Parent, const FMatrix4& Local)
+{
+    check(Parent == INVALID_NODE || Parent < NodeToSlot.size());
+
+    // 先追加在末尾 (此时槽位不再按深度有序)，下一次 Update 重排
+    const uint32_t Slot = GetNodeCount();
+    const uint32_t Node = static_cast<uint32_t>(NodeToSlot.size());
+    Parents.push_back(Parent == INVALID_NODE ? INVALID_NODE : NodeToSlot[Parent]);
+    Depths.push_back(Parent == INVALID_NODE ? 0 : Depths[NodeToSlot[Parent]] + 1);
+    ChildBegins.push_back(0);
+    ChildEnds.push_back(0);
+    Locals.push_back(Local);
+    Worlds.push_back(Local);
+    SlotToNode.push_back(Node);
+    NodeToSlot.push_back(Slot);
+
+    bLayoutDirty = true;
+    return Node;
+}
+
+void FTransformHierarchy::SetLocal(uint32_t Node, const FMatrix4& Local)
+{
+    const uint32_t Slot = NodeToSlot[Node];
+    Locals[Slot] = Local;
+
+    // 结构变化后下一次 Update 整体重算，不必记录
+    if (!bLayoutDirty)
+    {
+        DirtyRanges[Depths[Slot]].push_back({ Slot, Slot + 1 });
+    }
+}
+
+void FTransformHierarchy::RebuildLayout()
+{
+    const uint32_t Count = GetNodeCount();
+
+    // 1. 按旧槽位建立子节点表 (CSR)，子节点保持加入顺序
+    std::vector<uint32_t> ChildOffsets(Count + 1, 0);
+    for (uint32_t Slot = 0; Slot < Count; Slot++)
+    {
+        if (Parents[Slot] != INVALID_NODE)
+        {
+            ChildOffsets[Parents[Slot] + 1]++;
+        }
+    }
+    for (uint32_t Slot = 0; Slot < Count; Slot++)
+    {
+        ChildOffsets[Slot + 1] += ChildOffsets[Slot];
+    }
+    std::vector<uint32_t> Children(ChildOffsets[Count]);
+    std::vector<uint32_t> Cursor(ChildOffsets.begin(), ChildOffsets.end() - 1);
+    for (uint32_t Slot = 0; Slot < Count; Slot++)
+    {
+        if (Parents[Slot] != INVALID_NODE)
+        {
+            Children[Cursor[Parents[Slot]]++] = Slot;
+        }
+    }
+
+    // 2. 广度优先展开：先所有根，再依次追加每个节点的子节点，得到按深度分层、同层按父节点排序的新顺序
+    std::vector<uint32_t> NewToOld;
+    NewToOld.reserve(Count);
+    for (uint32_t Slot = 0; Slot < Count; Slot++)
+    {
+        if (Parents[Slot] == INVALID_NODE)
+        {
+            NewToOld.push_back(Slot);
+        }
+    }
+
+    const uint32_t RootCount = static_cast<uint32_t>(NewToOld.size());
+    std::vector<uint32_t> NewChildBegins(Count), NewChildEnds(Count);
+    LevelCount = RootCount > 0 ? 1 : 0;
+    uint32_t LevelEnd = RootCount;
+    for (uint32_t NewSlot = 0; NewSlot < NewToOld.size(); NewSlot++)
+    {
+        if (NewSlot == LevelEnd)
+        {
+            LevelEnd = static_cast<uint32_t>(NewToOld.size());
+            LevelCount++;
+        }
+
+        const uint32_t OldSlot = NewToOld[NewSlot];
+        NewChildBegins[NewSlot] = static_cast<uint32_t>(NewToOld.size());
+        NewToOld.insert(NewToOld.end(), Children.begin() + ChildOffsets[OldSlot], Children.begin() + ChildOffsets[OldSlot + 1]);
+        NewChildEnds[NewSlot] = static_cast<uint32_t>(NewToOld.size());
+    }
+    check(NewToOld.size() == Count);
+
+    // 3. 按新顺序重排各数组
+    std::vector<uint32_t> OldToNew(Count);
+    for (uint32_t NewSlot = 0; NewSlot < Count; NewSlot++)
+    {
+        OldToNew[NewToOld[NewSlot]] = NewSlot;
+    }
+
+    std::vector<uint32_t> NewParents(Count), NewDepths(Count), NewSlotToNode(Count);
+    std::vector<FMatrix4> NewLocals(Count);
+    for (uint32_t NewSlot = 0; NewSlot < Count; NewSlot++)
+    {
+        const uint32_t OldSlot = NewToOld[NewSlot];
+        NewParents[NewSlot] = Parents[OldSlot] == INVALID_NODE ? INVALID_NODE : OldToNew[Parents[OldSlot]];
+        NewDepths[NewSlot] = Depths[OldSlot];
+        NewLocals[NewSlot] = Locals[OldSlot];
+        NewSlotToNode[NewSlot] = SlotToNode[OldSlot];
+        NodeToSlot[SlotToNode[OldSlot]] = NewSlot;
+    }
+    Parents = std::move(NewParents);
+    Depths = std::move(NewDepths);
+    Locals = std::move(NewLocals);
+    SlotToNode = std::move(NewSlotToNode);
+    ChildBegins = std::move(NewChildBegins);
+    ChildEnds = std::move(NewChildEnds);
+    Worlds.resize(Count);
+
+    // 4. 旧的脏区间失效，改为从所有根开始整体重算
+    DirtyRanges.resize(LevelCount);
+    for (std::vector<FSlotRange>& Ranges : DirtyRanges)
+    {
+        Ranges.clear();
+    }
+    if (LevelCount > 0)
+    {
+        DirtyRanges[0].push_back({ 0, RootCount });
+    }
+    bLayoutDirty = false;
+}
+
+void FTransformHierarchy::Update(FJobSystem& Jobs)
+{
+    if (bLayoutDirty)
+    {
+        RebuildLayout();
+    }
+
+    UpdatedCount = 0;
+    for (uint32_t Level = 0; Level < LevelCount; Level++)
+    {
+        std::vector<FSlotRange>& Ranges = DirtyRanges[Level];
+        if (Ranges.empty())
+        {
+            continue;
+        }
+
+        // 合并重叠与相邻的区间：被父节点带动的子树和直接修改的节点可能重复
+        std::sort(Ranges.begin(), Ranges.end(), [](const FSlotRange& A, const FSlotRange& B) { return A.Begin < B.Begin; });
+        uint32_t MergedCount = 0;
+        for (const FSlotRange& Range : Ranges)
+        {
+            if (MergedCount > 0 && Range.Begin <= Ranges[MergedCount - 1].End)
+            {
+                Ranges[MergedCount - 1].End = std::max(Ranges[MergedCount - 1].End, Range.End);
+            }
+            else
+            {
+                Ranges[MergedCount++] = Range;
+            }
+        }
+        Ranges.resize(MergedCount);
+
+        UpdateLevel(Ranges, Jobs);
+
+        // 一个区间的子节点在下一层是连续的：[首个节点的子区间起点, 末个节点的子区间终点)
+        if (Level + 1 < LevelCount)
+        {
+            for (const FSlotRange& Range : Ranges)
+            {
+                const FSlotRange ChildRange = { ChildBegins[Range.Begin], ChildEnds[Range.End - 1] };
+                if (ChildRange.Begin < ChildRange.End)
+                {
+                    DirtyRanges[Level + 1].push_back(ChildRange);
+                }
+            }
+        }
+        Ranges.clear();
+    }
+}
+
+void FTransformHierarchy::UpdateLevel(std::vector<FSlotRange>& Ranges, FJobSystem& Jobs)
+{
+    // 把本层的各区间首尾相接成一段连续的工作，按工作序号并行切分
+    RangeOffsets.resize(Ranges.size() + 1);
+    RangeOffsets[0] = 0;
+    for (size_t i = 0; i < Ranges.size(); i++)
+    {
+        RangeOffsets[i + 1] = RangeOffsets[i] + (Ranges[i].End - Ranges[i].Begin);
+    }
+    const uint32_t WorkCount = RangeOffsets.back();
+    UpdatedCount += WorkCount;
+
+    Jobs.ParallelFor(WorkCount, [this, &Ranges](uint32_t Begin, uint32_t End)
+        {
+            size_t RangeIndex = std::upper_bound(RangeOffsets.begin(), RangeOffsets.end(), Begin) - RangeOffsets.begin() - 1;
+            uint32_t Work = Begin;
+            while (Work < End)
+            {
+                const FSlotRange& Range = Ranges[RangeIndex];
+                const uint32_t First = Range.Begin + (Work - RangeOffsets[RangeIndex]);
+                const uint32_t Last = Range.Begin + (std::min(End, RangeOffsets[RangeIndex + 1]) - RangeOffsets[RangeIndex]);
+
+                // 同一父节点的兄弟相邻，成批乘上父节点的世界矩阵
+                for (uint32_t Slot = First; Slot < Last;)
+                {
+                    const uint32_t Parent = Parents[Slot];
+                    uint32_t RunEnd = Slot + 1;
+                    while (RunEnd < Last && Parents[RunEnd] == Parent)
+                    {
+                        RunEnd++;
+                    }
+
+                    if (Parent == INVALID_NODE)
+                    {
+                        std::copy(Locals.begin() + Slot, Locals.begin() + RunEnd, Worlds.begin() + Slot);
+                    }
+                    else
+                    {
+                        MathSimd::MultiplyMatrices(Worlds[Parent], &Locals[Slot], &Worlds[Slot], RunEnd - Slot);
+                    }
+                    Slot = RunEnd;
+                }
+
+                Work += Last - First;
+                RangeIndex++;
+            }
+        }, HIERARCHY_JOB_GRAIN);
+}
@@ -0,0 +1,60 @@
+﻿#pragma once
+#include "MathTypes.h"
+
+class FJobSystem;
+
+// 变换层级：节点按深度展平存放，代替指针相连的场景图
+// - 槽位 (Slot) 按深度分层连续排列，同层内按父节点的槽位排序，兄弟节点相邻；
+//   父序号 / 局部矩阵 / 世界矩阵各是一个平铺数组，逐层更新时顺序读写
+// - 节点句柄 (AddNode 的返回值) 稳定不变，槽位只在层级结构变化后的下一次 Update 中重排
+// - 脏传播：SetLocal 把节点记为所在层的一个脏区间；Update 逐层合并区间并重算，
+//   一个区间的全部子节点在下一层仍是一个连续区间，于是开销只与变化的子树大小成正比，与节点总数无关
+// - 同一层内的节点互不依赖，经 Job 系统并行；同一父节点的兄弟成批交给 MathSimd::MultiplyMatrices
+// 由单个线程 (Update 阶段) 独占使用
+class FTransformHierarchy
+{
+public:
+    static constexpr uint32_t INVALID_NODE = UINT32_MAX;
+
+    // 返回节点句柄；Parent 为 INVALID_NODE 时是根节点。新节点的世界矩阵在下一次 Update 之后有效
+    uint32_t AddNode(uint32_t Parent, const FMatrix4& Local);
+
+    void SetLocal(uint32_t Node, const FMatrix4& Local);
+    const FMatrix4& GetLocal(uint32_t Node) const { return Locals[NodeToSlot[Node]]; }
+    const FMatrix4& GetWorld(uint32_t Node) const { return Worlds[NodeToSlot[Node]]; }
+
+    // 重算所有脏子树的世界矩阵；结构有变化时先重排槽位并整体重算
+    void Update(FJobSystem& Jobs);
+
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(Locals.size()); }
+    uint32_t GetLevelCount() const { return LevelCount; }
+    // 上一次 Update 重算的节点数
+    uint32_t GetUpdatedCount() const { return UpdatedCount; }
+
+private:
+    // 某一层中的槽位区间 [Begin, End)
+    struct FSlotRange
+    {
+        uint32_t Begin;
+        uint32_t End;
+    };
+
+    void RebuildLayout();
+    void UpdateLevel(std::vector<FSlotRange>& Ranges, FJobSystem& Jobs);
+
+    // 以下按槽位索引
+    std::vector<uint32_t> Parents;      // 父节点的槽位，根为 INVALID_NODE
+    std::vector<uint32_t> Depths;
+    std::vector<uint32_t> ChildBegins;  // 子节点在下一层的槽位区间；叶子为空区间，起点仍保持单调
+    std::vector<uint32_t> ChildEnds;
+    std::vector<FMatrix4> Locals;
+    std::vector<FMatrix4> Worlds;
+    std::vector<uint32_t> SlotToNode;
+
+    std::vector<uint32_t> NodeToSlot;
+    std::vector<std::vector<FSlotRange>> DirtyRanges; // 每层一个待更新区间列表
+    std::vector<uint32_t> RangeOffsets;               // UpdateLevel 的暂存：合并后各区间在本层工作中的起点
+    uint32_t LevelCount = 0;
+    uint32_t UpdatedCount = 0;
+    bool bLayoutDirty = false;
+};
@@ -1,23 +1,55 @@
 ﻿#include "Application.h"
 #include "Core/Macro.h"
+#include "Benchmark/Benchmark.h"
+#include "Renderer/MeshAsset.h"
+#include "Renderer/TextureAsset.h"
 
 int main(int argc, char* argv[])
 {
+    if (LOG_FILE_PATH[0] != '\0')
+    {
+        FLogger::Get().AddSink(std::make_unique<FFileLogSink>(LOG_FILE_PATH));
+    }
+
     try {
-        FApplication App;
+        FLaunchOptions Options = FLaunchOptions::Parse(argc, argv);
+        if (!Options.Benchmark.empty())
+        {
+            return RunBenchmark(Options.Benchmark);
+        }
+        if (!Options.ImportSource.empty())
+        {
+            // 按扩展名区分：TGA 烘焙为 .ctex 纹理，其余按 glTF 烘焙为 .cmesh 网格
+            std::filesystem::path Destination = Options.ImportSource;
+            if (Options.ImportSource.extension() == ".tga")
+            {
+                TextureAsset::Cook(Options.ImportSource, Destination.replace_extension(".ctex"));
+            }
+            else
+            {
+                MeshAsset::Cook(Options.ImportSource, Destination.replace_extension(".cmesh"));
+            }
+            FLogger::Get().Shutdown();
+            return 0;
+        }
+
+        FApplication App(Options);
         try {
             App.Init();
         }
         catch (const std::exception& e) {
-            std::cerr << "Initialization Error: " << e.what() << std::endl;
+            CA_LOG_ERROR("App", "Initialization Error: {}", e.what());
+            FLogger::Get().Shutdown();
             return -1;
         }
         App.Run();
     }
     catch (const std::exception& e) {
-        std::cerr << "Critical Error: " << e.what() << std::endl;
+        CA_LOG_ERROR("App", "Critical Error: {}", e.what());
+        FLogger::Get().Shutdown();
         return -1;
     }
 
+    FLogger::Get().Shutdown();
     return 0;
 }
\ No newline at end of file